@@ -30,6 +30,8 @@
 // ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "UE5Coro/AggregateAwaiters.h"
+#include "TimerThread.h"
+#include "Async/Async.h"
 
 using namespace UE5Coro;
 using namespace UE5Coro::Private;
@@ -45,14 +47,72 @@ template<typename T>
 FAggregateAwaiter::FAggregateAwaiter(T All, const TArray<TCoroutine<>>& Coroutines)
 	: Data(std::make_shared<FData>(All.value ? Coroutines.Num() : !!Coroutines.Num()))
 {
-	for (int i = 0; i < Coroutines.Num(); ++i)
-		Consume(Data, i, Coroutines[i]);
+	// Nothing reads this before the constructor returns
+	Data->Coroutines = Coroutines;
+	for (int i = 0; i < Data->Coroutines.Num(); ++i)
+		Data->Coroutines[i].ContinueWith([Data = Data, i] { Finish(Data, i); });
 }
 template UE5CORO_API FAggregateAwaiter::FAggregateAwaiter(
 	std::false_type, const TArray<TCoroutine<>>&);
 template UE5CORO_API FAggregateAwaiter::FAggregateAwaiter(
 	std::true_type, const TArray<TCoroutine<>>&);
 
+FAggregateAwaiter::~FAggregateAwaiter()
+{
+	if (!Data)
+		return;
+	FPromise* Awaiting;
+	bool bPending;
+	{
+		std::scoped_lock _(Data->Lock);
+		Awaiting = Data->Promise;
+		bPending = Awaiting && Data->Count > 0;
+		if (bPending) // The awaiting coroutine is being destroyed early
+			Data->Promise = nullptr;
+	}
+	if (Awaiting)
+		Awaiting->RemoveCancellationHook(*Data);
+	if (bPending)
+		CancelChildren(*Data, false);
+}
+
+void FAggregateAwaiter::Finish(const std::shared_ptr<FData>& Data, int Index)
+{
+	std::unique_lock _(Data->Lock);
+	if (--Data->Count != 0)
+		return;
+	Data->Index = Index; // Mark that this index was the one reaching 0
+	auto* Promise = Data->Promise;
+	bool bHasHelpers = Data->Helpers.Num() > 0;
+	_.unlock();
+
+	// Nobody will read the results of the other helpers' awaitables
+	if (bHasHelpers)
+		CancelChildren(*Data, true);
+
+	// Not co_awaited yet if this is nullptr, await_ready deals with this
+	if (Promise != nullptr)
+		Promise->Resume();
+}
+
+void FAggregateAwaiter::OnCanceled(FCancellationHook& Hook)
+{
+	CancelChildren(static_cast<FData&>(Hook), false);
+}
+
+void FAggregateAwaiter::CancelChildren(FData& Data, bool bHelpersOnly)
+{
+	TArray<TCoroutine<>> Children;
+	{
+		std::scoped_lock _(Data.Lock);
+		Children = Data.Helpers;
+		if (!bHelpersOnly)
+			Children.Append(Data.Coroutines);
+	}
+	for (auto& Child : Children)
+		Child.Cancel();
+}
+
 bool FAggregateAwaiter::await_ready()
 {
 	checkf(Data, TEXT("Attempting to await moved-from aggregate awaiter"));
@@ -72,8 +132,22 @@ void FAggregateAwaiter::Suspend(FPromise& Promise)
 	checkf(!Data->Lock.try_lock(), TEXT("Internal error: lock was not taken"));
 	checkf(!Data->Promise, TEXT("Attempting to reuse aggregate awaiter"));
 
-	Data->Promise = &Promise;
-	Data->Lock.unlock();
+	// Cancellation takes Data->Lock while holding the promise's lock, so the
+	// hook can't be added with Data->Lock held. Nothing resumes the promise
+	// before Data->Promise is set, which keeps the awaiter alive until then.
+	auto Local = Data;
+	Local->Lock.unlock();
+	bool bHooked = Promise.AddCancellationHook(*Local);
+	Local->Lock.lock();
+	Local->Promise = &Promise;
+	bool bFinished = Local->Count <= 0;
+	Local->Lock.unlock();
+
+	if (UNLIKELY(!bHooked))
+		CancelChildren(*Local, false);
+	// If Finish ran in between, it had no promise to resume
+	if (bFinished)
+		Promise.Resume();
 }
 
 #if UE5CORO_CPP20
@@ -114,26 +188,63 @@ FRaceAwaiter::FRaceAwaiter(TArray<TCoroutine<>>&& Array)
 
 		Coro->ContinueWith([Data2 = Data, i]
 		{
-			std::unique_lock _(Data2->Lock);
-
-			// Nothing to do if this wasn't the first one
-			if (Data2->Index != -1)
-				return;
-			Data2->Index = i;
+			TArray<TCoroutine<>> Others;
+			FPromise* Promise;
+			{
+				std::scoped_lock _(Data2->Lock);
 
-			for (int j = 0; j < Data2->Handles.Num(); ++j)
-				if (j != i) // Cancel the others
-					Data2->Handles[j].Cancel();
+				// Nothing to do if this wasn't the first one
+				if (Data2->Index != -1)
+					return;
+				Data2->Index = i;
+				Others = Data2->Handles;
+				Others.RemoveAt(i);
+				Promise = Data2->Promise;
+			}
 
-			if (auto* Promise = Data2->Promise)
-			{
-				_.unlock();
+			// Canceling takes the other coroutines' locks, which must not
+			// nest inside Data2->Lock
+			for (auto& Handle : Others)
+				Handle.Cancel();
+			if (Promise)
 				Promise->Resume();
-			}
 		});
 	}
 }
 
+FRaceAwaiter::~FRaceAwaiter()
+{
+	if (!Data)
+		return;
+	FPromise* Awaiting;
+	bool bPending;
+	{
+		std::scoped_lock _(Data->Lock);
+		Awaiting = Data->Promise;
+		bPending = Awaiting && Data->Index == -1;
+		if (bPending) // The awaiting coroutine is being destroyed early
+			Data->Promise = nullptr;
+	}
+	if (Awaiting)
+		Awaiting->RemoveCancellationHook(*Data);
+	if (bPending)
+		OnCanceled(*Data);
+}
+
+void FRaceAwaiter::OnCanceled(FCancellationHook& Hook)
+{
+	auto& Data = static_cast<FData&>(Hook);
+	TArray<TCoroutine<>> Handles;
+	{
+		std::scoped_lock _(Data.Lock);
+		Handles = Data.Handles;
+	}
+	// Same lock order as completion, the coroutines' locks are taken after
+	// Data.Lock is released
+	for (auto& Handle : Handles)
+		Handle.Cancel();
+}
+
 bool FRaceAwaiter::await_ready()
 {
 	Data->Lock.lock();
@@ -151,8 +262,20 @@ void FRaceAwaiter::Suspend(FPromise& Promise)
 	// Expecting a lock from await_ready
 	checkf(!Data->Lock.try_lock(), TEXT("Internal error: lock not held"));
 	checkf(!Data->Promise, TEXT("Unexpected double race await"));
-	Data->Promise = &Promise;
-	Data->Lock.unlock();
+	// Same lock order as FAggregateAwaiter::Suspend
+	auto Local = Data;
+	Local->Lock.unlock();
+	bool bHooked = Promise.AddCancellationHook(*Local);
+	Local->Lock.lock();
+	Local->Promise = &Promise;
+	bool bFinished = Local->Index != -1;
+	Local->Lock.unlock();
+
+	if (UNLIKELY(!bHooked))
+		OnCanceled(*Local);
+	// If a coroutine won in between, it had no promise to resume
+	if (bFinished)
+		Promise.Resume();
 }
 
 int FRaceAwaiter::await_resume() noexcept
@@ -163,3 +286,125 @@ int FRaceAwaiter::await_resume() noexcept
 	       TEXT("Internal error: resuming with unknown result"));
 	return Data->Index;
 }
+
+struct FTimeoutAwaiter::FState : FCancellationHook
+{
+	enum EOutcome
+	{
+		Pending,
+		Completed,
+		TimedOut, // Also used if the awaiting coroutine is destroyed early
+	};
+
+	TCoroutine<> Antecedent;
+	const double Deadline;
+	FAsyncTimeAwaiter Timer;
+	/** Keeps this object alive while the timer thread might call OnTimer. */
+	std::shared_ptr<FState> TimerSelf;
+	std::atomic<EOutcome> Outcome = Pending;
+	FPromise* Promise = nullptr;
+	ENamedThreads::Type Thread = ENamedThreads::AnyThread;
+
+	explicit FState(TCoroutine<> Antecedent, double Deadline)
+		: FCancellationHook(&OnCanceled), Antecedent(std::move(Antecedent))
+		, Deadline(Deadline), Timer(Deadline, true) { }
+
+	/** @return true if this call decided the outcome. */
+	bool TryFinish(EOutcome NewOutcome)
+	{
+		auto Expected = Pending;
+		return Outcome.compare_exchange_strong(Expected, NewOutcome);
+	}
+
+	void Disarm()
+	{
+		// If this fails, OnTimer is on its way, and it will drop TimerSelf
+		if (FTimerThread::Get().TryUnregister(&Timer))
+			TimerSelf = nullptr;
+	}
+
+	static void OnCanceled(FCancellationHook& Hook)
+	{
+		// The antecedent's completion will resume the awaiting coroutine
+		static_cast<FState&>(Hook).Antecedent.Cancel();
+	}
+
+	static void OnCompleted(const std::shared_ptr<FState>& This)
+	{
+		if (!This->TryFinish(Completed))
+			return;
+		This->Disarm();
+		// Resume where the antecedent completed, like co_await TCoroutine
+		This->Promise->Resume();
+	}
+
+	static void OnTimer(void* Context)
+	{
+		auto Self = std::move(static_cast<FState*>(Context)->TimerSelf);
+		if (!Self->TryFinish(TimedOut))
+			return;
+		// Cancellation hooks shouldn't run on the timer thread, leave that to
+		// the thread where the awaiting coroutine will resume
+		auto Thread = Self->Thread;
+		AsyncTask(Thread, [Self = std::move(Self)]
+		{
+			Self->Antecedent.Cancel();
+			Self->Promise->Resume();
+		});
+	}
+};
+
+FTimeoutAwaiter::FTimeoutAwaiter(TCoroutine<> Antecedent, double Seconds)
+	: State(std::make_shared<FState>(std::move(Antecedent),
+	                                 FPlatformTime::Seconds() + Seconds))
+{
+}
+
+FTimeoutAwaiter::~FTimeoutAwaiter()
+{
+	if (!State->Promise)
+		return;
+	State->Promise->RemoveCancellationHook(*State);
+	// The awaiting coroutine is being destroyed while suspended
+	if (UNLIKELY(State->TryFinish(FState::TimedOut)))
+	{
+		State->Disarm();
+		State->Antecedent.Cancel();
+	}
+}
+
+bool FTimeoutAwaiter::await_ready()
+{
+	if (State->Antecedent.IsDone())
+	{
+		State->TryFinish(FState::Completed);
+		return true;
+	}
+	if (FPlatformTime::Seconds() < State->Deadline)
+		return false;
+	State->TryFinish(FState::TimedOut);
+	State->Antecedent.Cancel();
+	return true;
+}
+
+void FTimeoutAwaiter::Suspend(FPromise& Promise)
+{
+	// Once the timer is armed, this object might be gone at any moment
+	auto Local = State;
+	Local->Promise = &Promise;
+	Local->Thread = Promise.WithTaskPriority(
+		FTaskGraphInterface::Get().GetCurrentThreadIfKnown());
+	if (UNLIKELY(!Promise.AddCancellationHook(*Local)))
+		Local->Antecedent.Cancel();
+
+	Local->TimerSelf = Local;
+	FTimerThread::Get().RegisterCallback(&Local->Timer, &FState::OnTimer,
+	                                     Local.get());
+	// This might resume Promise synchronously if the antecedent is done
+	Local->Antecedent.ContinueWith([Local] { FState::OnCompleted(Local); });
+}
+
+bool FTimeoutAwaiter::await_resume()
+{
+	return State->Outcome.load() == FState::Completed;
+}
@@ -78,33 +78,69 @@ FAnimAwaiterPayload Anim::PlayMontageNotifyEnd(UAnimInstance* Instance,
 	return {std::true_type(), Instance, Montage, NotifyName};
 }
 
+FAnimCurveAwaiter Anim::CurveRisesAbove(UAnimInstance* Instance,
+                                        FName CurveName, float Threshold)
+{
+	return {Instance, CurveName, Threshold, true};
+}
+
+FAnimCurveAwaiter Anim::CurveFallsBelow(UAnimInstance* Instance,
+                                        FName CurveName, float Threshold)
+{
+	return {Instance, CurveName, Threshold, false};
+}
+
 FAnimAwaiter::FAnimAwaiter(UAnimInstance* Instance, UAnimMontage*)
 {
 	checkf(IsInGameThread(),
 	       TEXT("Animation awaiters may only be used on the game thread"));
 	checkf(Instance, TEXT("Attempting to wait on a null anim instance"));
 	// A null montage is valid, meaning "any montage"
-
-	auto* Obj = NewObject<UUE5CoroAnimCallbackTarget>();
-	Target = TStrongObjectPtr(Obj);
 }
 
 FAnimAwaiter::~FAnimAwaiter()
 {
 	checkf(IsInGameThread(),
 	       TEXT("Unexpected anim awaiter destruction off the game thread"));
-	if (UNLIKELY(bSuspended))
-		Target->CancelResume();
+	if (Listener)
+		Listener->Unlink(*this);
+	if (UNLIKELY(DispatchSlot)) // Destroyed by another awaiter's resumption
+		*DispatchSlot = nullptr;
+}
+
+// Copies are independent: they wait for the same event, or carry its result
+FAnimAwaiter::FAnimAwaiter(const FAnimAwaiter& Other)
+	: Key(Other.Key), Result(Other.Result)
+{
+	checkf(IsInGameThread(),
+	       TEXT("Animation awaiters may only be used on the game thread"));
+	if (Other.Listener)
+		Other.Listener->Link(*this);
 }
 
-// These cannot be defaulted in the .h, they use UUE5CoroAnimCallbackTarget
-FAnimAwaiter::FAnimAwaiter(const FAnimAwaiter&) = default;
-FAnimAwaiter& FAnimAwaiter::operator=(const FAnimAwaiter&) = default;
+FAnimAwaiter& FAnimAwaiter::operator=(const FAnimAwaiter& Other)
+{
+	checkf(IsInGameThread(),
+	       TEXT("Animation awaiters may only be used on the game thread"));
+	checkf(!Promise, TEXT("Attempting to overwrite a suspended awaiter"));
+	if (this != &Other)
+	{
+		if (Listener)
+			Listener->Unlink(*this);
+		Key = Other.Key;
+		Result = Other.Result;
+		if (Other.Listener)
+			Other.Listener->Link(*this);
+	}
+	return *this;
+}
 
-void FAnimAwaiter::Suspend(FPromise& Promise)
+void FAnimAwaiter::Suspend(FPromise& InPromise)
 {
-	bSuspended = true;
-	Target->RequestResume(Promise);
+	checkf(!Promise, TEXT("Attempted second concurrent co_await"));
+	// await_ready should've prevented suspension if there's already a result
+	checkf(Listener, TEXT("Internal error: suspending without a listener"));
+	Promise = &InPromise;
 }
 
 template<typename T>
@@ -113,12 +149,17 @@ TAnimAwaiter<T>::TAnimAwaiter(TEnd, UAnimInstance* Instance,
                               UAnimMontage* Montage)
 	: FAnimAwaiter(Instance, Montage)
 {
+	// Without a listener, this awaiter will report the instance as destroyed
+	auto* Target = UUE5CoroAnimCallbackTarget::ForInstance(Instance);
+	if (!Target)
+		return;
+
 	if constexpr (Type == Bool)
-		Target->ListenForMontageEvent(Instance, Montage, TEnd::value);
+		Target->ListenForMontageEvent(*this, Montage, TEnd::value);
 	else
 	{
 		static_assert(Type == NameAndPayload);
-		Target->ListenForPlayMontageNotify(Instance, Montage, {}, TEnd::value);
+		Target->ListenForPlayMontageNotify(*this, Montage, {}, TEnd::value);
 	}
 }
 
@@ -128,15 +169,19 @@ TAnimAwaiter<T>::TAnimAwaiter(TEnd, UAnimInstance* Instance,
                               UAnimMontage* Montage, FName NotifyName)
 	: FAnimAwaiter(Instance, Montage)
 {
+	auto* Target = UUE5CoroAnimCallbackTarget::ForInstance(Instance);
+	if (!Target)
+		return;
+
 	if constexpr (Type == Void)
 	{
 		static_assert(std::is_same_v<TEnd, std::monostate>);
-		Target->ListenForNotify(Instance, Montage, NotifyName);
+		Target->ListenForNotify(*this, NotifyName);
 	}
 	else
 	{
 		static_assert(Type == Payload);
-		Target->ListenForPlayMontageNotify(Instance, Montage, NotifyName,
+		Target->ListenForPlayMontageNotify(*this, Montage, NotifyName,
 		                                   TEnd::value);
 	}
 }
@@ -149,26 +194,24 @@ bool TAnimAwaiter<T>::await_ready()
 {
 	checkf(IsInGameThread(),
 	       TEXT("Animation awaiters may only be used on the game thread"));
-	auto* Obj = Target.Get();
-	if (!std::holds_alternative<std::monostate>(Obj->Result))
-	{
-		// If Result is or contains a payload pointer, that has expired by now
-		if constexpr (Type == Payload)
-			std::get<FPayloadPtr>(Obj->Result) = nullptr;
-		else if constexpr (Type == NameAndPayload)
-			std::get<FPayloadTuple>(Obj->Result).Value = nullptr;
-		return true;
-	}
-	return false;
+	if (Listener) // Still waiting?
+		return false;
+
+	// Either there's a result, or the anim instance is gone.
+	// If Result is or contains a payload pointer, that has expired by now.
+	if (auto* Ptr = std::get_if<FPayloadPtr>(&Result))
+		*Ptr = nullptr;
+	else if (auto* Tuple = std::get_if<FPayloadTuple>(&Result))
+		Tuple->Value = nullptr;
+	return true;
 }
 
 template<typename T>
 auto TAnimAwaiter<T>::await_resume()
 	-> std::conditional_t<Type == Void, void, T>
 {
-	// bSuspended can be false
-	checkf(Target, TEXT("Internal error: resuming without a callback target"));
-	bSuspended = false;
+	checkf(!Listener && !Promise,
+	       TEXT("Internal error: resuming an awaiter that's still waiting"));
 
 	// The only reason we get here without a result is that the anim instance
 	// was destroyed early.
@@ -179,7 +222,6 @@ auto TAnimAwaiter<T>::await_resume()
 	// if this happened, but this is expected to be a very rare situation.
 	// Usually, the caller is also getting destroyed and the stack will be
 	// unwound (by coroutine_handle::destroy()) instead of resuming.
-	auto& Result = Target->Result;
 	bool bDestroyed = std::holds_alternative<std::monostate>(Result);
 
 	if constexpr (Type == Bool)
@@ -191,6 +233,32 @@ auto TAnimAwaiter<T>::await_resume()
 		                  : std::get<FPayloadTuple>(Result);
 }
 
+FAnimCurveAwaiter::FAnimCurveAwaiter(UAnimInstance* Instance, FName CurveName,
+                                     float Threshold, bool bRising)
+	: FAnimAwaiter(Instance, nullptr), Threshold(Threshold), bRising(bRising)
+{
+	// Without a listener, this awaiter will report the instance as destroyed
+	if (auto* Target = UUE5CoroAnimCallbackTarget::ForInstance(Instance))
+		Target->ListenForCurve(*this, CurveName);
+}
+
+FAnimCurveAwaiter::~FAnimCurveAwaiter() = default;
+
+bool FAnimCurveAwaiter::await_ready()
+{
+	checkf(IsInGameThread(),
+	       TEXT("Animation awaiters may only be used on the game thread"));
+	return !Listener; // Either there's a result, or the anim instance is gone
+}
+
+float FAnimCurveAwaiter::await_resume()
+{
+	checkf(!Listener && !Promise,
+	       TEXT("Internal error: resuming an awaiter that's still waiting"));
+	auto* Value = std::get_if<float>(&Result);
+	return Value ? *Value : 0; // See TAnimAwaiter::await_resume
+}
+
 namespace UE5Coro::Private
 {
 template class TAnimAwaiter<std::monostate>;
@@ -0,0 +1,86 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "UE5Coro/AssetAwaiters.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "UE5Coro/AsyncAwaiters.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Private;
+
+namespace
+{
+TCoroutine<> QueryChunks(TAsyncGeneratorSink<TArray<FAssetData>> Sink,
+                         IAssetRegistry* Registry, FARFilter Filter,
+                         int32 ChunkSize)
+{
+	co_await Async::MoveToThread(ENamedThreads::AnyBackgroundThreadNormalTask);
+
+	// GetAssets is thread safe for on-disk assets only
+	Filter.bIncludeOnlyOnDiskAssets = true;
+	TArray<FAssetData> Assets;
+	Registry->GetAssets(Filter, Assets);
+
+	for (int32 Start = 0; Start < Assets.Num(); Start += ChunkSize)
+	{
+		int32 Num = FMath::Min(ChunkSize, Assets.Num() - Start);
+		TArray<FAssetData> Chunk;
+		Chunk.Reserve(Num);
+		for (int32 i = Start; i < Start + Num; ++i)
+			Chunk.Add(std::move(Assets[i]));
+		co_await Sink.Yield(std::move(Chunk));
+	}
+}
+}
+
+TCoroutine<> Assets::WaitForRegistry()
+{
+	checkf(IsInGameThread(),
+	       TEXT("The asset registry may only be awaited on the game thread"));
+	auto& Registry = IAssetRegistry::GetChecked();
+	if (Registry.IsLoadingAssets())
+		co_await Registry.OnFilesLoaded();
+}
+
+TAsyncGenerator<TArray<FAssetData>> Assets::QueryAsync(FARFilter Filter,
+                                                       int32 ChunkSize)
+{
+	checkf(ChunkSize > 0, TEXT("Chunk size must be positive"));
+	auto* Registry = IAssetRegistry::Get();
+	checkf(Registry, TEXT("The asset registry is not available"));
+	return TAsyncGenerator<TArray<FAssetData>>(
+		[&](TAsyncGeneratorSink<TArray<FAssetData>> Sink)
+		{
+			return QueryChunks(std::move(Sink), Registry, std::move(Filter),
+			                   ChunkSize);
+		});
+}
@@ -30,12 +30,28 @@
 // ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "UE5Coro/AsyncAwaiters.h"
+#include "GameThreadInbox.h"
+#include "ReadyQueue.h"
+#include "UE5Coro/Scheduler.h"
 #include "TimerThread.h"
+#include "Async/Async.h"
+#include "HAL/IConsoleManager.h"
 
+using namespace UE5Coro;
 using namespace UE5Coro::Private;
 
 namespace
 {
+TAutoConsoleVariable<int32> CVarYieldQuota(
+	TEXT("UE5Coro.YieldQuota"), 16,
+	TEXT("Maximum number of coroutines that co_awaited Async::Yield on a ")
+	TEXT("thread that are resumed back-to-back on that same thread, before the ")
+	TEXT("rest are handed back to the task graph. 0 always uses the task graph."));
+
+thread_local FReadyQueueScope* GReadyQueue = nullptr;
+
+void DispatchResume(ENamedThreads::Type Thread, FPromise& Promise);
+
 class FResumeTask
 {
 	ENamedThreads::Type Thread;
@@ -45,7 +61,11 @@ public:
 	explicit FResumeTask(ENamedThreads::Type Thread, FPromise& Promise)
 		: Thread(Thread), Promise(Promise) { }
 
-	void DoTask(ENamedThreads::Type, FGraphEvent*) { Promise.Resume(); }
+	void DoTask(ENamedThreads::Type, FGraphEvent*)
+	{
+		FReadyQueueScope _;
+		Promise.Resume();
+	}
 
 	ENamedThreads::Type GetDesiredThread() const { return Thread; }
 
@@ -60,6 +80,71 @@ public:
 		return ESubsequentsMode::FireAndForget;
 	}
 };
+
+void DispatchResume(ENamedThreads::Type Thread, FPromise& Promise)
+{
+	Thread = Promise.WithTaskPriority(Thread);
+	if (FGameThreadInbox::TryPush(Thread, Promise))
+		return;
+	TGraphTask<FResumeTask>::CreateTask().ConstructAndDispatchWhenReady(Thread,
+	                                                                    Promise);
+}
+}
+
+FAsyncCoroutine WaitOnLongTaskPool(FPromise& Promise,
+                                   ENamedThreads::Type Thread,
+                                   const void* Future,
+                                   void (*Wait)(const void*))
+{
+	co_await Async::MoveToLongTaskPool();
+	Wait(Future);
+	DispatchResume(Thread, Promise);
+}
+}
+
+void FSharedFutureAwaiterBase::WaitAndResume(FPromise& Promise,
+                                             const void* Future,
+                                             void (*Wait)(const void*))
+{
+	// The awaiting coroutine stays suspended, keeping Future alive
+	auto Thread = FTaskGraphInterface::Get().GetCurrentThreadIfKnown();
+	WaitOnLongTaskPool(Promise, Thread, Future, Wait);
+}
+
+FReadyQueueScope::FReadyQueueScope()
+	: Quota(CVarYieldQuota.GetValueOnAnyThread())
+{
+	// Nested task processing keeps using the outer queue
+	if (!GReadyQueue && Quota > 0)
+		GReadyQueue = this;
+}
+
+FReadyQueueScope::~FReadyQueueScope()
+{
+	if (GReadyQueue != this)
+		return;
+
+	// Coroutines yielding again during this are queued behind the others
+	int32 Head = 0;
+	for (int32 i = 0; i < Quota && Head < Promises.Num(); ++i)
+		Promises[Head++]->Resume();
+	GReadyQueue = nullptr;
+
+	// Let everything else on this thread run before the leftovers
+	if (Head < Promises.Num())
+	{
+		auto ThisThread = FTaskGraphInterface::Get().GetCurrentThreadIfKnown();
+		for (int32 i = Head; i < Promises.Num(); ++i)
+			DispatchResume(ThisThread, *Promises[i]);
+	}
+}
+
+bool FReadyQueueScope::TryAdd(FPromise& Promise)
+{
+	if (!GReadyQueue)
+		return false;
+	GReadyQueue->Promises.Add(&Promise);
+	return true;
 }
 
 bool FAsyncAwaiter::await_ready()
@@ -71,21 +156,42 @@ bool FAsyncAwaiter::await_ready()
 
 void FAsyncAwaiter::Suspend(FPromise& Promise)
 {
-	TGraphTask<FResumeTask>::CreateTask().ConstructAndDispatchWhenReady(Thread,
-	                                                                    Promise);
+	Promise.MarkAwaitReady(); // Everything from here on is scheduling
+	// Later resumes on other threads keep this priority
+	Promise.InheritTaskPriority(Thread);
+	DispatchResume(Thread, Promise);
 }
 
 FAsyncTimeAwaiter::FAsyncTimeAwaiter(const FAsyncTimeAwaiter& Other)
-	: TargetTime(Other.TargetTime), U(Other.U)
+	: FCancellationHook(&OnCanceled), TargetTime(Other.TargetTime)
+	, bPrecise(Other.bPrecise), U(Other.U)
 {
 }
 
 FAsyncTimeAwaiter::~FAsyncTimeAwaiter()
 {
+	// The hook goes first, it could be racing the unregistration otherwise
+	Unhook();
 	if (UNLIKELY(Promise))
 		FTimerThread::Get().TryUnregister(this);
 }
 
+void FAsyncTimeAwaiter::OnCanceled(FCancellationHook& Hook)
+{
+	// NotifyCanceled already unlinked the hook, and this runs in the promise's
+	// lock before the resume is dispatched. Unhook is a no-op after this.
+	auto* This = static_cast<FAsyncTimeAwaiter*>(&Hook);
+	This->Hooked = nullptr;
+	// Hand the coroutine back early instead of waiting for its target time
+	FTimerThread::Get().Cancel(This);
+}
+
+void FAsyncTimeAwaiter::Unhook()
+{
+	if (auto* Awaiting = std::exchange(Hooked, nullptr))
+		Awaiting->RemoveCancellationHook(*this);
+}
+
 bool FAsyncTimeAwaiter::await_ready()
 {
 	return FPlatformTime::Seconds() >= TargetTime;
@@ -98,18 +204,120 @@ void FAsyncTimeAwaiter::Suspend(FPromise& InPromise)
 		U.Thread = ENamedThreads::AnyThread;
 	else
 		U.Thread = FTaskGraphInterface::Get().GetCurrentThreadIfKnown();
+	// The timer thread dispatches U.Thread as-is
+	U.Thread = InPromise.WithTaskPriority(U.Thread);
 	Promise = &InPromise;
+	// Nothing else can see this before the hook is added
+	bCanceled = false;
+	// The hook might run right away and set bCanceled in the timer thread's lock
+	if (LIKELY(InPromise.AddCancellationHook(*this)))
+		Hooked = &InPromise;
+	else
+		bCanceled = true;
 	FTimerThread::Get().Register(this);
 }
 
-void FAsyncTimeAwaiter::Resume()
+void FAsyncTimeAwaiter::await_resume()
+{
+	// Allow this awaiter to be reused
+	Unhook();
+}
+
+Async::FPeriodicTimer::FPeriodicTimer(double Period, EMissedTicks Policy,
+                                      bool bAnyThread)
+	: Period(Period), Policy(Policy), bAnyThread(bAnyThread)
+	, NextTime(FPlatformTime::Seconds() + Period)
+{
+	checkf(Period > 0, TEXT("Periodic timers need a positive period"));
+}
+
+void Async::FPeriodicTimer::Reset()
+{
+	checkf(!Timer, TEXT("Cannot reset a periodic timer while it's awaited"));
+	NextTime = FPlatformTime::Seconds() + Period;
+}
+
+FPeriodicTimerAwaiter::~FPeriodicTimerAwaiter()
+{
+	// The coroutine was canceled or destroyed while suspended, await_resume
+	// didn't run. Free the timer up for the next co_await while the promise
+	// that the hook points to is still alive.
+	Timer.Timer.Reset();
+}
+
+bool FPeriodicTimerAwaiter::await_ready()
+{
+	checkf(!Timer.Timer,
+	       TEXT("Periodic timers may only be awaited by one coroutine"));
+	// The same storage is reused by every tick, there's no allocation
+	Timer.Timer.Emplace(Timer.NextTime, Timer.bAnyThread);
+	return Timer.Timer->await_ready();
+}
+
+int FPeriodicTimerAwaiter::await_resume()
+{
+	Timer.Timer->await_resume();
+	Timer.Timer.Reset();
+
+	// Deadlines that have also passed since the one that resumed this
+	double Late = FPlatformTime::Seconds() - Timer.NextTime;
+	int Missed = Late > 0 ? FMath::FloorToInt(Late / Timer.Period) : 0;
+	if (Timer.Policy == Async::EMissedTicks::Burst)
+		Missed = 0; // They'll be ready immediately, one at a time
+	// Advancing from the previous deadline instead of now prevents drift
+	Timer.NextTime += Timer.Period * (1 + Missed);
+	return Timer.Policy == Async::EMissedTicks::Coalesce ? 1 + Missed : 1;
+}
+
+FAsyncYieldAwaiter::FAsyncYieldAwaiter(int64 Microseconds)
+{
+	double Seconds = FMath::Max<int64>(1, Microseconds) * 1e-6;
+	BudgetCycles = static_cast<uint64>(Seconds /
+	                                   FPlatformTime::GetSecondsPerCycle64());
+	BudgetCycles = FMath::Max<uint64>(1, BudgetCycles);
+}
+
+bool FAsyncYieldAwaiter::await_ready()
 {
-	checkf(Promise, TEXT("Internal error: spurious resume without suspension"));
-	AsyncTask(U.Thread, [this] { Promise.exchange(nullptr)->Resume(); });
+	return BudgetCycles &&
+	       FPlatformTime::Cycles64() - GResumeCycles < BudgetCycles;
 }
 
 void FAsyncYieldAwaiter::Suspend(FPromise& Promise)
 {
-	TGraphTask<FResumeTask>::CreateTask().ConstructAndDispatchWhenReady(
-		FTaskGraphInterface::Get().GetCurrentThreadIfKnown(), Promise);
+	Promise.MarkAwaitReady();
+	if (FScheduler::TryYield(Promise))
+		return;
+	// This thread is already resuming a batch, resume there once it's done
+	if (FReadyQueueScope::TryAdd(Promise))
+		return;
+	DispatchResume(FTaskGraphInterface::Get().GetCurrentThreadIfKnown(),
+	               Promise);
+}
+
+void FParallelForAwaiter::Suspend(FPromise& InPromise)
+{
+	Promise = &InPromise;
+	Thread = FTaskGraphInterface::Get().GetCurrentThreadIfKnown();
+
+	auto& TaskGraph = FTaskGraphInterface::Get();
+	int32 NumBatches = FMath::DivideAndRoundUp(Num, MinBatchSize);
+	int32 NumTasks = FMath::Min(FMath::Max(1, TaskGraph.GetNumWorkerThreads()),
+	                            NumBatches);
+	// A few batches per task lets the faster workers pick up the slack
+	BatchSize = FMath::Max(MinBatchSize,
+	                       FMath::DivideAndRoundUp(Num, NumTasks * 4));
+	NumWorking = NumTasks;
+	for (int32 i = 0; i < NumTasks; ++i)
+		AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask,
+		          [this] { Work(); });
+}
+
+void FParallelForAwaiter::Work()
+{
+	for (int32 Begin; (Begin = NextIndex.fetch_add(BatchSize)) < Num;)
+		Run(*this, Begin, FMath::Min(Begin + BatchSize, Num));
+	// The last task to finish resumes the coroutine, which might destroy this
+	if (NumWorking.fetch_sub(1) == 1)
+		DispatchResume(Thread, *Promise);
 }
@@ -30,6 +30,7 @@
 // ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "UE5Coro/AsyncAwaiters.h"
+#include "LongTaskPool.h"
 #include "UE5CoroDelegateCallbackTarget.h"
 
 using namespace UE5Coro;
@@ -89,11 +90,21 @@ FAsyncAwaiter Async::MoveToSimilarThread()
 	return FAsyncAwaiter(FTaskGraphInterface::Get().GetCurrentThreadIfKnown());
 }
 
+void Async::SetTaskPriority(ENamedThreads::Type Priority)
+{
+	FPromise::Current().SetTaskPriority(Priority);
+}
+
 FAsyncYieldAwaiter Async::Yield()
 {
 	return {};
 }
 
+FAsyncYieldAwaiter Async::YieldIfBudgetExceeded(int64 Microseconds)
+{
+	return FAsyncYieldAwaiter(Microseconds);
+}
+
 FNewThreadAwaiter Async::MoveToNewThread(EThreadPriority Priority,
                                          uint64 Affinity,
                                          EThreadCreateFlags Flags)
@@ -101,6 +112,12 @@ FNewThreadAwaiter Async::MoveToNewThread(EThreadPriority Priority,
 	return FNewThreadAwaiter(Priority, Affinity, Flags);
 }
 
+FLongTaskAwaiter Async::MoveToLongTaskPool(EThreadPriority Priority,
+                                           uint64 Affinity)
+{
+	return FLongTaskAwaiter(Priority, Affinity);
+}
+
 FAsyncTimeAwaiter Async::PlatformSeconds(double Seconds)
 {
 	return FAsyncTimeAwaiter(FPlatformTime::Seconds() + Seconds, false);
@@ -111,6 +128,11 @@ FAsyncTimeAwaiter Async::PlatformSecondsAnyThread(double Seconds)
 	return FAsyncTimeAwaiter(FPlatformTime::Seconds() + Seconds, true);
 }
 
+FAsyncTimeAwaiter Async::PlatformSecondsPrecise(double Seconds)
+{
+	return FAsyncTimeAwaiter(FPlatformTime::Seconds() + Seconds, false, true);
+}
+
 FAsyncTimeAwaiter Async::UntilPlatformTime(double Time)
 {
 	return FAsyncTimeAwaiter(Time, false);
@@ -121,14 +143,25 @@ FAsyncTimeAwaiter Async::UntilPlatformTimeAnyThread(double Time)
 	return FAsyncTimeAwaiter(Time, true);
 }
 
+FAsyncTimeAwaiter Async::UntilPlatformTimePrecise(double Time)
+{
+	return FAsyncTimeAwaiter(Time, false, true);
+}
+
 void FNewThreadAwaiter::Suspend(FPromise& Promise)
 {
 	new FAutoStartResumeRunnable(Promise, Priority, Affinity, Flags);
 }
 
+void FLongTaskAwaiter::Suspend(FPromise& Promise)
+{
+	FLongTaskPool::Get().Schedule(Promise, Priority, Affinity);
+}
+
 FDelegateAwaiter::~FDelegateAwaiter()
 {
-	Cleanup();
+	checkf(Cleanup, TEXT("Internal error: delegate awaiter was never set up"));
+	Cleanup(*this);
 }
 
 void FDelegateAwaiter::Suspend(FPromise& InPromise)
@@ -143,18 +176,20 @@ void FDelegateAwaiter::TryResumeOnce()
 		std::exchange(Promise, nullptr)->Resume();
 }
 
-UObject* FDelegateAwaiter::SetupCallbackTarget(std::function<void(void*)> Fn)
+UObject* FDelegateAwaiter::SetupCallbackTarget(TInlineFunction<void(void*)> Fn,
+                                               void* Delegate,
+                                               void (*InUnbind)(void*,
+                                                                UObject*))
 {
-	FGCScopeGuard _;
-	auto* Target = NewObject<UUE5CoroDelegateCallbackTarget>();
-	Target->SetInternalFlags(EInternalObjectFlags::Async);
-	Target->Init(std::move(Fn));
+	auto* Target = UUE5CoroDelegateCallbackTarget::Create(std::move(Fn));
 	checkf(!Cleanup, TEXT("Internal error: double setup"));
-	Cleanup = [Target]
+	CleanupTarget = Target;
+	CleanupDelegate = Delegate;
+	Unbind = InUnbind;
+	Cleanup = [](FDelegateAwaiter& This)
 	{
-		FGCScopeGuard _;
-		Target->ClearInternalFlags(EInternalObjectFlags::Async);
-		Target->MarkAsGarbage();
+		static_cast<UUE5CoroDelegateCallbackTarget*>(This.CleanupTarget)
+			->Release(This.CleanupDelegate, This.Unbind);
 	};
 	return Target;
 }
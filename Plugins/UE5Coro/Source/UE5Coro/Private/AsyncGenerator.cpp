@@ -0,0 +1,145 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "UE5Coro/AsyncGenerator.h"
+#include "GameThreadInbox.h"
+#include "Async/Async.h"
+#include "UE5Coro/AsyncAwaiters.h"
+
+using namespace UE5Coro::Private;
+
+FAsyncGeneratorState::FAsyncGeneratorState(int32 Capacity)
+	: Capacity(FMath::Max(1, Capacity))
+{
+}
+
+void FAsyncGeneratorState::ResumeConsumer(std::unique_lock<FMutex>& L)
+{
+	checkf(L.owns_lock(), TEXT("Internal error: lock not held"));
+	auto* Promise = std::exchange(Consumer, nullptr);
+	L.unlock();
+	if (Promise)
+		Resume(Promise, ConsumerThread);
+}
+
+void FAsyncGeneratorState::ResumeProducer(std::unique_lock<FMutex>& L)
+{
+	checkf(L.owns_lock(), TEXT("Internal error: lock not held"));
+	auto* Promise = std::exchange(Producer, nullptr);
+	L.unlock();
+	if (Promise)
+		Resume(Promise, ProducerThread);
+}
+
+void FAsyncGeneratorState::Resume(FPromise* Promise,
+                                  ENamedThreads::Type Thread)
+{
+	FGameThreadInbox::ResumeOn(Thread, *Promise);
+}
+
+void FAsyncGeneratorState::Finish()
+{
+	std::unique_lock L(Lock);
+	bFinished = true;
+	ResumeConsumer(L);
+}
+
+void FAsyncGeneratorState::Close()
+{
+	std::unique_lock L(Lock);
+	bClosed = true;
+	ResumeProducer(L);
+}
+
+bool FAsyncGeneratorState::IsClosed()
+{
+	std::scoped_lock _(Lock);
+	return bClosed;
+}
+
+bool FAsyncGeneratorState::TryReadyConsumer()
+{
+	std::unique_lock L(Lock);
+	if (Num > 0 || bFinished)
+		return true;
+	checkf(!Consumer, TEXT("Attempted second concurrent co_await on Next()"));
+	L.release(); // Carry the lock into SuspendConsumer()
+	return false;
+}
+
+void FAsyncGeneratorState::SuspendConsumer(FPromise& Promise)
+{
+	// This should be locked from TryReadyConsumer
+	checkf(!Lock.try_lock(), TEXT("Internal error: lock wasn't taken"));
+	Consumer = &Promise;
+	ConsumerThread = FTaskGraphInterface::Get().GetCurrentThreadIfKnown();
+	Lock.unlock();
+}
+
+bool FAsyncGeneratorState::TryReadyProducer(TFunctionRef<void()> Push)
+{
+	std::unique_lock L(Lock);
+	if (!bClosed && Num < Capacity)
+	{
+		Push();
+		ResumeConsumer(L);
+		return true;
+	}
+	checkf(!Producer, TEXT("Attempted second concurrent co_await on Yield()"));
+	L.release(); // Carry the lock into SuspendProducer()
+	return false;
+}
+
+void FAsyncGeneratorState::SuspendProducer(FPromise& Promise)
+{
+	// This should be locked from TryReadyProducer
+	checkf(!Lock.try_lock(), TEXT("Internal error: lock wasn't taken"));
+	if (bClosed)
+	{
+		// Nothing will ever consume this, resume to process the cancellation
+		Lock.unlock();
+		Promise.Resume();
+		return;
+	}
+	Producer = &Promise;
+	ProducerThread = FTaskGraphInterface::Get().GetCurrentThreadIfKnown();
+	Lock.unlock();
+}
+
+void FAsyncGeneratorState::ResumedProducer(TFunctionRef<void()> Push)
+{
+	std::unique_lock L(Lock);
+	// Values yielded after the generator is gone are dropped
+	if (bClosed)
+		return;
+	Push();
+	ResumeConsumer(L);
+}
@@ -37,3 +37,31 @@ bool FAsyncPromise::IsEarlyDestroy() const
 {
 	return ShouldCancel();
 }
+
+#if UE5CORO_PRIVATE_SYMMETRIC_TRANSFER
+stdcoro::coroutine_handle<> FAsyncFinalSuspend::await_suspend(
+	stdcoro::coroutine_handle<> Handle) noexcept
+{
+	// ~FPromise will put the awaiting coroutine here instead of resuming it
+	FPromise* Next = nullptr;
+	GSymmetricTransfer = &Next;
+	Handle.destroy();
+	GSymmetricTransfer = nullptr;
+
+	if (!Next)
+		return stdcoro::noop_coroutine();
+	// Let Resume deal with this rare case, it's allowed to nest
+	if (UNLIKELY(Next->ShouldCancel()))
+	{
+		Next->Resume();
+		return stdcoro::noop_coroutine();
+	}
+	// Continue in the awaiting coroutine without growing the stack.
+	// Resume() is bypassed, so do its bookkeeping here.
+	GCurrentPromise = Next;
+	GResumeCycles = FPlatformTime::Cycles64();
+	Next->EndAwait(GResumeCycles);
+	Next->TraceTransferredResume();
+	return Next->TakeResumeHandle();
+}
+#endif
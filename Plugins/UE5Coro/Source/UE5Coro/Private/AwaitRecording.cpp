@@ -0,0 +1,408 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "AwaitStats.h"
+#include "Algo/Sort.h"
+#include "HAL/FileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/DateTime.h"
+#include "Misc/Paths.h"
+
+using namespace UE5Coro::Private;
+
+namespace
+{
+constexpr uint32 FileMagic = 0x52433545; // E5CR
+constexpr int32 FileVersion = 1;
+constexpr uint16 UnknownType = 0xFFFF;
+
+struct FRecordedEvent
+{
+	uint64 Cycles;
+	int32 CoroutineID;
+	uint32 ThreadID;
+	uint16 Type; // Index into the awaiter type names
+	EAwaitEvent Kind;
+
+	friend FArchive& operator<<(FArchive& Ar, FRecordedEvent& Event)
+	{
+		auto Kind = static_cast<uint8>(Event.Kind);
+		Ar << Event.Cycles << Event.CoroutineID << Event.ThreadID << Event.Type
+		   << Kind;
+		Event.Kind = static_cast<EAwaitEvent>(Kind);
+		return Ar;
+	}
+};
+
+// Everything that Analyze needs from a recording
+struct FRecording
+{
+	double SecondsPerCycle = 0;
+	TArray<FString> Types;
+	TArray<FRecordedEvent> Events;
+
+	friend FArchive& operator<<(FArchive& Ar, FRecording& Recording)
+	{
+		return Ar << Recording.SecondsPerCycle << Recording.Types
+		          << Recording.Events;
+	}
+
+	double Ms(uint64 Cycles) const { return Cycles * SecondsPerCycle * 1000; }
+
+	const TCHAR* TypeName(uint16 Type) const
+	{
+		return Types.IsValidIndex(Type) ? *Types[Type] : TEXT("?");
+	}
+};
+
+#if UE5CORO_DEBUG
+struct FRingBuffer
+{
+	TArray<FRecordedEvent> Events;
+	std::atomic<uint64> Next = 0;
+
+	explicit FRingBuffer(int32 Capacity)
+	{
+		Events.SetNumUninitialized(Capacity);
+	}
+};
+
+// This is only ever replaced while not recording, and old buffers are leaked
+// in case a late writer is still using them
+std::atomic<FRingBuffer*> GRing = nullptr;
+
+FString DefaultPath()
+{
+	return FPaths::ProfilingDir() /
+	       FString::Printf(TEXT("UE5Coro-%s.ue5cororec"),
+	                       *FDateTime::Now().ToString());
+}
+
+FAutoConsoleCommandWithWorldArgsAndOutputDevice CmdRecordStart(
+	TEXT("UE5Coro.Record.Start"),
+	TEXT("Starts recording every coroutine suspension, readiness and resume ")
+	TEXT("into a ring buffer. The optional argument is its capacity in ")
+	TEXT("events, 1M by default."),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateLambda(
+	[](const TArray<FString>& Args, UWorld*, FOutputDevice& Ar)
+	{
+		if (GAwaitRecordEnabled)
+		{
+			Ar.Logf(TEXT("Already recording"));
+			return;
+		}
+		int32 Capacity = 1 << 20;
+		if (Args.Num() > 0)
+			LexFromString(Capacity, *Args[0]);
+		Capacity = FMath::Max(Capacity, 1024);
+		auto* Ring = GRing.load();
+		if (!Ring || Ring->Events.Num() != Capacity)
+			GRing = Ring = new FRingBuffer(Capacity);
+		Ring->Next = 0;
+		GAwaitRecordEnabled = true;
+		Ar.Logf(TEXT("Recording up to %d coroutine events"), Capacity);
+	}));
+
+FAutoConsoleCommandWithOutputDevice CmdRecordStop(
+	TEXT("UE5Coro.Record.Stop"),
+	TEXT("Stops recording coroutine events, keeping what was recorded."),
+	FConsoleCommandWithOutputDeviceDelegate::CreateLambda([](FOutputDevice& Ar)
+	{
+		GAwaitRecordEnabled = false;
+		if (auto* Ring = GRing.load())
+			Ar.Logf(TEXT("Recorded %llu coroutine events"),
+			        FMath::Min<uint64>(Ring->Next, Ring->Events.Num()));
+	}));
+
+FAutoConsoleCommandWithWorldArgsAndOutputDevice CmdRecordSave(
+	TEXT("UE5Coro.Record.Save"),
+	TEXT("Stops recording and saves the recorded coroutine events to the ")
+	TEXT("given file, or Saved/Profiling by default. Analyze it with ")
+	TEXT("UE5Coro.Record.Analyze or -run=UE5CoroReplay."),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateLambda(
+	[](const TArray<FString>& Args, UWorld*, FOutputDevice& Ar)
+	{
+		GAwaitRecordEnabled = false;
+		auto* Ring = GRing.load();
+		if (!Ring)
+		{
+			Ar.Logf(TEXT("Nothing was recorded"));
+			return;
+		}
+		// Give writers that saw the flag a moment to finish
+		FPlatformProcess::Sleep(0.01f);
+
+		FRecording Recording;
+		Recording.SecondsPerCycle = FPlatformTime::GetSecondsPerCycle64();
+		Recording.Types = AwaitTypeNames();
+		uint64 Capacity = Ring->Events.Num();
+		uint64 End = Ring->Next;
+		uint64 Start = End > Capacity ? End - Capacity : 0;
+		Recording.Events.Reserve(End - Start);
+		for (uint64 i = Start; i < End; ++i)
+			Recording.Events.Add(Ring->Events[i % Capacity]);
+
+		FString Path = Args.Num() > 0 ? Args[0] : DefaultPath();
+		TUniquePtr<FArchive> File(IFileManager::Get().CreateFileWriter(*Path));
+		if (!File)
+		{
+			Ar.Logf(TEXT("Could not write %s"), *Path);
+			return;
+		}
+		uint32 Magic = FileMagic;
+		int32 Version = FileVersion;
+		*File << Magic << Version << Recording;
+		Ar.Logf(TEXT("Saved %d coroutine events to %s"),
+		        Recording.Events.Num(), *Path);
+	}));
+#endif
+
+FAutoConsoleCommandWithWorldArgsAndOutputDevice CmdRecordAnalyze(
+	TEXT("UE5Coro.Record.Analyze"),
+	TEXT("Prints the longest stalls, scheduling delay per awaiter type, and ")
+	TEXT("the critical path of a file saved by UE5Coro.Record.Save."),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateLambda(
+	[](const TArray<FString>& Args, UWorld*, FOutputDevice& Ar)
+	{
+		if (Args.Num() == 0)
+			Ar.Logf(TEXT("Usage: UE5Coro.Record.Analyze <file>"));
+		else
+			AnalyzeAwaitRecording(Args[0], Ar);
+	}));
+
+// One suspension, from co_await to resume
+struct FStall
+{
+	int32 CoroutineID;
+	uint16 Type;
+	uint64 Start;
+	uint64 Suspended;
+	uint64 Delay;
+};
+
+struct FTypeStats
+{
+	int32 Resumes = 0;
+	uint64 Suspended = 0;
+	uint64 Delay = 0;
+	uint64 MaxSuspended = 0;
+	uint64 MaxDelay = 0;
+};
+
+struct FCoroutineStats
+{
+	uint64 First = 0;
+	uint64 Last = 0;
+	uint64 Running = 0;
+	// Set while suspended
+	uint64 SuspendCycles = 0;
+	uint64 ReadyCycles = 0;
+	uint16 Type = UnknownType;
+	// Resumed, but not suspended again yet
+	uint64 ResumeCycles = 0;
+	TMap<uint16, FTypeStats> PerType;
+};
+
+void Add(FTypeStats& Stats, const FStall& Stall)
+{
+	++Stats.Resumes;
+	Stats.Suspended += Stall.Suspended;
+	Stats.Delay += Stall.Delay;
+	Stats.MaxSuspended = FMath::Max(Stats.MaxSuspended, Stall.Suspended);
+	Stats.MaxDelay = FMath::Max(Stats.MaxDelay, Stall.Delay);
+}
+
+void PrintTypes(const FRecording& Recording, TMap<uint16, FTypeStats>& Types,
+                FOutputDevice& Ar)
+{
+	Types.ValueSort([](const FTypeStats& A, const FTypeStats& B)
+	{
+		return A.Delay + A.Suspended > B.Delay + B.Suspended;
+	});
+	Ar.Logf(TEXT("%8s %12s %10s %12s %10s  %s"), TEXT("Resumes"),
+	        TEXT("Waiting ms"), TEXT("Max ms"), TEXT("Delay ms"),
+	        TEXT("Max ms"), TEXT("Awaiter type"));
+	for (auto& [Type, Stats] : Types)
+		Ar.Logf(TEXT("%8d %12.3f %10.3f %12.3f %10.3f  %s"), Stats.Resumes,
+		        Recording.Ms(Stats.Suspended - Stats.Delay),
+		        Recording.Ms(Stats.MaxSuspended), Recording.Ms(Stats.Delay),
+		        Recording.Ms(Stats.MaxDelay), Recording.TypeName(Type));
+}
+}
+
+#if UE5CORO_DEBUG
+void UE5Coro::Private::RecordAwaitEvent(const FPromiseExtras& Extras,
+                                        EAwaitEvent Event, uint64 Cycles)
+{
+	// Pairs with the store in UE5Coro.Record.Start, Events must be visible
+	auto* Ring = GRing.load(std::memory_order_acquire);
+	if (UNLIKELY(!Ring))
+		return;
+	int32 Type = Extras.DebugAwaiterType
+		? AwaitTypeIndex(Extras.DebugAwaiterType) : INDEX_NONE;
+	uint64 Index = Ring->Next.fetch_add(1, std::memory_order_relaxed);
+	Ring->Events[Index % Ring->Events.Num()] = {
+		Cycles, Extras.DebugID, FPlatformTLS::GetCurrentThreadId(),
+		Type == INDEX_NONE ? UnknownType : static_cast<uint16>(Type), Event};
+}
+#endif
+
+bool UE5Coro::Private::AnalyzeAwaitRecording(const FString& Path,
+                                             FOutputDevice& Ar)
+{
+	TUniquePtr<FArchive> File(IFileManager::Get().CreateFileReader(*Path));
+	if (!File)
+	{
+		Ar.Logf(TEXT("Could not read %s"), *Path);
+		return false;
+	}
+	uint32 Magic = 0;
+	int32 Version = 0;
+	*File << Magic << Version;
+	if (Magic != FileMagic || Version != FileVersion)
+	{
+		Ar.Logf(TEXT("%s is not a UE5Coro recording"), *Path);
+		return false;
+	}
+	FRecording Recording;
+	*File << Recording;
+	if (File->IsError())
+	{
+		Ar.Logf(TEXT("%s is corrupt"), *Path);
+		return false;
+	}
+	auto& Events = Recording.Events;
+	if (Events.Num() == 0)
+	{
+		Ar.Logf(TEXT("%s has no events"), *Path);
+		return true;
+	}
+
+	// Threads record in the order they got a slot, not in timestamp order
+	Algo::StableSortBy(Events, &FRecordedEvent::Cycles);
+	uint64 Origin = Events[0].Cycles;
+
+	// Replay the recording
+	TMap<int32, FCoroutineStats> Coroutines;
+	TMap<uint16, FTypeStats> Types;
+	TArray<FStall> Stalls;
+	TMap<uint64, int32> ResumesPerMs;
+	auto CyclesPerMs = static_cast<uint64>(
+		FMath::Max(1.0, 0.001 / Recording.SecondsPerCycle));
+	for (auto& Event : Events)
+	{
+		auto& Coro = Coroutines.FindOrAdd(Event.CoroutineID);
+		if (!Coro.First)
+			Coro.First = Event.Cycles;
+		Coro.Last = Event.Cycles;
+		switch (Event.Kind)
+		{
+			case EAwaitEvent::Suspend:
+				// A co_await that didn't suspend is followed by another one
+				if (Coro.ResumeCycles)
+					Coro.Running += Event.Cycles - Coro.ResumeCycles;
+				Coro.ResumeCycles = 0;
+				Coro.SuspendCycles = Event.Cycles;
+				Coro.ReadyCycles = 0;
+				Coro.Type = Event.Type;
+				break;
+
+			case EAwaitEvent::Ready:
+				if (Coro.SuspendCycles && !Coro.ReadyCycles)
+					Coro.ReadyCycles = Event.Cycles;
+				break;
+
+			case EAwaitEvent::Resume:
+			{
+				if (!Coro.SuspendCycles) // Suspended before the recording
+				{
+					Coro.ResumeCycles = Event.Cycles;
+					break;
+				}
+				FStall Stall{Event.CoroutineID, Coro.Type, Coro.SuspendCycles,
+				             Event.Cycles - Coro.SuspendCycles,
+				             Coro.ReadyCycles ? Event.Cycles - Coro.ReadyCycles
+				                              : 0};
+				Add(Types.FindOrAdd(Coro.Type), Stall);
+				Add(Coro.PerType.FindOrAdd(Coro.Type), Stall);
+				Stalls.Add(Stall);
+				++ResumesPerMs.FindOrAdd((Event.Cycles - Origin) / CyclesPerMs);
+				Coro.SuspendCycles = 0;
+				Coro.ResumeCycles = Event.Cycles;
+				break;
+			}
+		}
+	}
+
+	Ar.Logf(TEXT("%d events, %d coroutines, %d resumes over %.3f ms"),
+	        Events.Num(), Coroutines.Num(), Stalls.Num(),
+	        Recording.Ms(Events.Last().Cycles - Origin));
+
+	Ar.Logf(TEXT("Time spent suspended per awaiter type, split into waiting ")
+	        TEXT("and scheduling delay after becoming ready:"));
+	PrintTypes(Recording, Types, Ar);
+
+	Ar.Logf(TEXT("Longest stalls:"));
+	Algo::SortBy(Stalls, &FStall::Suspended, TGreater<>());
+	for (int32 i = 0; i < FMath::Min(10, Stalls.Num()); ++i)
+	{
+		auto& Stall = Stalls[i];
+		Ar.Logf(TEXT("  Coroutine %d at %.3f ms: %.3f ms ")
+		        TEXT("(%.3f ms delay) on %s"),
+		        Stall.CoroutineID, Recording.Ms(Stall.Start - Origin),
+		        Recording.Ms(Stall.Suspended), Recording.Ms(Stall.Delay),
+		        Recording.TypeName(Stall.Type));
+	}
+
+	Ar.Logf(TEXT("Busiest milliseconds:"));
+	ResumesPerMs.ValueSort(TGreater<>());
+	int32 NumPrinted = 0;
+	for (auto& [Ms, Resumes] : ResumesPerMs)
+	{
+		if (NumPrinted++ == 5)
+			break;
+		Ar.Logf(TEXT("  %llu ms: %d resumes"), Ms, Resumes);
+	}
+
+	// Without awaiter-awaited links, the longest-lived coroutine bounds the
+	// critical path of everything that it waited on
+	auto* Longest = &*Coroutines.CreateIterator();
+	for (auto& Pair : Coroutines)
+		if (Pair.Value.Last - Pair.Value.First >
+		    Longest->Value.Last - Longest->Value.First)
+			Longest = &Pair;
+	auto& Critical = Longest->Value;
+	Ar.Logf(TEXT("Critical path: coroutine %d, %.3f ms, %.3f ms running"),
+	        Longest->Key, Recording.Ms(Critical.Last - Critical.First),
+	        Recording.Ms(Critical.Running));
+	PrintTypes(Recording, Critical.PerType, Ar);
+	return true;
+}
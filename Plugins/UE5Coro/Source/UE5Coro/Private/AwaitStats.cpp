@@ -0,0 +1,365 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "AwaitStats.h"
+#include "Containers/Ticker.h"
+#include "HAL/IConsoleManager.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "Stats/Stats.h"
+
+#if UE5CORO_DEBUG
+using namespace UE5Coro::Private;
+
+CSV_DEFINE_CATEGORY(UE5Coro, true);
+
+DECLARE_STATS_GROUP(TEXT("UE5Coro"), STATGROUP_UE5Coro, STATCAT_Advanced);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Resumes measured"), STAT_UE5Coro_Resumes,
+                           STATGROUP_UE5Coro);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Suspended avg (ms)"),
+                           STAT_UE5Coro_SuspendedAvg, STATGROUP_UE5Coro);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Suspended p99 (ms)"),
+                           STAT_UE5Coro_SuspendedP99, STATGROUP_UE5Coro);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Scheduling delay avg (ms)"),
+                           STAT_UE5Coro_DelayAvg, STATGROUP_UE5Coro);
+DECLARE_FLOAT_COUNTER_STAT(TEXT("Scheduling delay p99 (ms)"),
+                           STAT_UE5Coro_DelayP99, STATGROUP_UE5Coro);
+
+bool UE5Coro::Private::GAwaitStatsEnabled = false;
+bool UE5Coro::Private::GAwaitRecordEnabled = false;
+
+namespace
+{
+constexpr int32 MaxTypes = 256;
+// Bucket 0 is <1us, bucket N is [2^(N-1), 2^N) us, the last one is open
+constexpr int32 NumBuckets = 32;
+
+int32 BucketOf(uint64 Cycles)
+{
+	auto Micros = static_cast<uint64>(FPlatformTime::ToSeconds64(Cycles) * 1e6);
+	if (Micros == 0)
+		return 0;
+	return FMath::Min<int32>(FMath::FloorLog2_64(Micros) + 1, NumBuckets - 1);
+}
+
+double BucketMs(int32 Bucket)
+{
+	return static_cast<double>(uint64(1) << Bucket) / 1000.0;
+}
+
+// Only written by the thread that owns it, read by anyone
+struct FHistogram
+{
+	std::atomic<uint32> Buckets[NumBuckets] = {};
+	std::atomic<uint64> TotalCycles = 0;
+
+	void Add(uint64 Cycles)
+	{
+		auto& Bucket = Buckets[BucketOf(Cycles)];
+		Bucket.store(Bucket.load(std::memory_order_relaxed) + 1,
+		             std::memory_order_relaxed);
+		TotalCycles.store(TotalCycles.load(std::memory_order_relaxed) + Cycles,
+		                  std::memory_order_relaxed);
+	}
+};
+
+struct FRow
+{
+	FHistogram Suspended;
+	FHistogram Delay;
+};
+
+struct FThreadStats
+{
+	// Allocated on demand by the owning thread, never freed
+	std::atomic<FRow*> Rows[MaxTypes] = {};
+	// Only used by the owning thread, keyed by the type names' addresses
+	TMap<const void*, int32> TypeCache;
+};
+
+// Plain sums of every thread's histograms
+struct FSnapshot
+{
+	uint64 Buckets[2][NumBuckets] = {};
+	uint64 TotalCycles[2] = {};
+
+	uint64 Count(int32 Kind) const
+	{
+		uint64 Sum = 0;
+		for (auto N : Buckets[Kind])
+			Sum += N;
+		return Sum;
+	}
+
+	double AverageMs(int32 Kind) const
+	{
+		uint64 N = Count(Kind);
+		return N ? FPlatformTime::ToMilliseconds64(TotalCycles[Kind]) / N : 0;
+	}
+
+	/** Upper bound of the bucket containing the given percentile. */
+	double PercentileMs(int32 Kind, double Percentile) const
+	{
+		uint64 Target = static_cast<uint64>(Count(Kind) * Percentile);
+		uint64 Sum = 0;
+		for (int32 i = 0; i < NumBuckets; ++i)
+			if ((Sum += Buckets[Kind][i]) > Target)
+				return BucketMs(i);
+		return 0;
+	}
+
+	void Add(const FSnapshot& Other)
+	{
+		for (int32 Kind = 0; Kind < 2; ++Kind)
+		{
+			for (int32 i = 0; i < NumBuckets; ++i)
+				Buckets[Kind][i] += Other.Buckets[Kind][i];
+			TotalCycles[Kind] += Other.TotalCycles[Kind];
+		}
+	}
+
+	/** Other must be an earlier snapshot of the same histograms. */
+	void Subtract(const FSnapshot& Other)
+	{
+		for (int32 Kind = 0; Kind < 2; ++Kind)
+		{
+			for (int32 i = 0; i < NumBuckets; ++i)
+				Buckets[Kind][i] -= Other.Buckets[Kind][i];
+			TotalCycles[Kind] -= Other.TotalCycles[Kind];
+		}
+	}
+};
+
+class FRegistry
+{
+	FMutex Lock;
+	TArray<FThreadStats*> Threads; // Never freed, samples outlive threads
+	TMap<FString, int32> TypeIndices;
+	TArray<FString> TypeNames;
+	// Game thread only
+	TArray<FSnapshot> Previous;
+	FTSTicker::FDelegateHandle Ticker;
+
+public:
+	static FRegistry& Get()
+	{
+		static FRegistry Instance;
+		return Instance;
+	}
+
+	FThreadStats* NewThread()
+	{
+		auto* Stats = new FThreadStats;
+		std::scoped_lock _(Lock);
+		Threads.Add(Stats);
+		return Stats;
+	}
+
+	/** Type names are compared by value, every module has its own copy. */
+	int32 IndexOf(const TCHAR* Type)
+	{
+		std::scoped_lock _(Lock);
+		if (auto* Index = TypeIndices.Find(Type))
+			return *Index;
+		if (TypeNames.Num() >= MaxTypes)
+			return INDEX_NONE;
+		int32 Index = TypeNames.Add(Type);
+		TypeIndices.Add(Type, Index);
+		return Index;
+	}
+
+	TArray<FString> GetTypeNames()
+	{
+		std::scoped_lock _(Lock);
+		return TypeNames;
+	}
+
+	TArray<FSnapshot> Snapshot(TArray<FString>& OutNames)
+	{
+		std::scoped_lock _(Lock);
+		OutNames = TypeNames;
+		TArray<FSnapshot> Result;
+		Result.SetNum(TypeNames.Num());
+		for (auto* Thread : Threads)
+			for (int32 i = 0; i < Result.Num(); ++i)
+				if (auto* Row = Thread->Rows[i].load(std::memory_order_acquire))
+				{
+					FHistogram* Histograms[] = {&Row->Suspended, &Row->Delay};
+					for (int32 Kind = 0; Kind < 2; ++Kind)
+					{
+						for (int32 j = 0; j < NumBuckets; ++j)
+							Result[i].Buckets[Kind][j] +=
+								Histograms[Kind]->Buckets[j].load(
+									std::memory_order_relaxed);
+						Result[i].TotalCycles[Kind] +=
+							Histograms[Kind]->TotalCycles.load(
+								std::memory_order_relaxed);
+					}
+				}
+		return Result;
+	}
+
+	void SetPublishing(bool bEnable)
+	{
+		check(IsInGameThread());
+		if (bEnable && !Ticker.IsValid())
+			Ticker = FTSTicker::GetCoreTicker().AddTicker(
+				FTickerDelegate::CreateLambda([this](float)
+				{
+					Publish();
+					return true;
+				}));
+		else if (!bEnable && Ticker.IsValid())
+		{
+			FTSTicker::GetCoreTicker().RemoveTicker(Ticker);
+			Ticker.Reset();
+		}
+	}
+
+	/** Reports what happened since the last call. */
+	void Publish()
+	{
+		TArray<FString> Names;
+		auto Current = Snapshot(Names);
+		FSnapshot Sum;
+		for (int32 i = 0; i < Current.Num(); ++i)
+		{
+			FSnapshot Delta = Current[i];
+			if (i < Previous.Num())
+				Delta.Subtract(Previous[i]);
+			Sum.Add(Delta);
+#if CSV_PROFILER
+			if (Delta.Count(0) == 0)
+				continue;
+			auto Record = [&](const TCHAR* Stat, double Value)
+			{
+				FCsvProfiler::RecordCustomStat(
+					FName(*FString::Printf(TEXT("%s/%s"), *Names[i], Stat)),
+					CSV_CATEGORY_INDEX(UE5Coro), static_cast<float>(Value),
+					ECsvCustomStatOp::Set);
+			};
+			Record(TEXT("Resumes"), Delta.Count(0));
+			Record(TEXT("SuspendedAvgMs"), Delta.AverageMs(0));
+			Record(TEXT("SuspendedP99Ms"), Delta.PercentileMs(0, 0.99));
+			if (Delta.Count(1))
+				Record(TEXT("DelayP99Ms"), Delta.PercentileMs(1, 0.99));
+#endif
+		}
+		Previous = MoveTemp(Current);
+
+		SET_DWORD_STAT(STAT_UE5Coro_Resumes, Sum.Count(0));
+		SET_FLOAT_STAT(STAT_UE5Coro_SuspendedAvg, Sum.AverageMs(0));
+		SET_FLOAT_STAT(STAT_UE5Coro_SuspendedP99, Sum.PercentileMs(0, 0.99));
+		SET_FLOAT_STAT(STAT_UE5Coro_DelayAvg, Sum.AverageMs(1));
+		SET_FLOAT_STAT(STAT_UE5Coro_DelayP99, Sum.PercentileMs(1, 0.99));
+	}
+};
+
+thread_local FThreadStats* GThreadStats = nullptr;
+
+FAutoConsoleVariableRef CVarAwaitStats(
+	TEXT("UE5Coro.AwaitStats"), GAwaitStatsEnabled,
+	TEXT("Measure how long coroutines spend suspended on each awaiter type, ")
+	TEXT("and the delay between awaiters becoming ready and coroutines ")
+	TEXT("resuming. Reported in stat UE5Coro, CSV profiles, and by ")
+	TEXT("UE5Coro.AwaitStats.Dump."),
+	FConsoleVariableDelegate::CreateLambda([](IConsoleVariable*)
+	{
+		FRegistry::Get().SetPublishing(GAwaitStatsEnabled);
+	}));
+
+FAutoConsoleCommandWithOutputDevice CmdDumpAwaitStats(
+	TEXT("UE5Coro.AwaitStats.Dump"),
+	TEXT("Prints every awaiter type's suspension and scheduling delay ")
+	TEXT("histograms since UE5Coro.AwaitStats was first enabled."),
+	FConsoleCommandWithOutputDeviceDelegate::CreateLambda([](FOutputDevice& Ar)
+	{
+		TArray<FString> Names;
+		auto Snapshots = FRegistry::Get().Snapshot(Names);
+		Ar.Logf(TEXT("%10s %10s %10s %10s %10s  %s"), TEXT("Resumes"),
+		        TEXT("Avg ms"), TEXT("p50 ms"), TEXT("p99 ms"),
+		        TEXT("Delay p99"), TEXT("Awaiter type"));
+		for (int32 i = 0; i < Snapshots.Num(); ++i)
+		{
+			auto& Snapshot = Snapshots[i];
+			Ar.Logf(TEXT("%10llu %10.3f %10.3f %10.3f %10.3f  %s"),
+			        Snapshot.Count(0), Snapshot.AverageMs(0),
+			        Snapshot.PercentileMs(0, 0.5),
+			        Snapshot.PercentileMs(0, 0.99),
+			        Snapshot.PercentileMs(1, 0.99), *Names[i]);
+		}
+		if (!GAwaitStatsEnabled)
+			Ar.Logf(TEXT("UE5Coro.AwaitStats is off, nothing new is recorded"));
+	}));
+}
+
+int32 UE5Coro::Private::AwaitTypeIndex(const TCHAR* AwaiterType)
+{
+	auto* Stats = GThreadStats;
+	if (UNLIKELY(!Stats))
+		Stats = GThreadStats = FRegistry::Get().NewThread();
+	if (auto* Cached = Stats->TypeCache.Find(AwaiterType))
+		return *Cached;
+	int32 Index = FRegistry::Get().IndexOf(AwaiterType);
+	Stats->TypeCache.Add(AwaiterType, Index);
+	return Index;
+}
+
+TArray<FString> UE5Coro::Private::AwaitTypeNames()
+{
+	return FRegistry::Get().GetTypeNames();
+}
+
+void UE5Coro::Private::RecordAwaitStats(FPromiseExtras& Extras,
+                                        uint64 ResumeCycles)
+{
+	uint64 Suspend = std::exchange(Extras.AwaitSuspendCycles, 0);
+	uint64 Ready = std::exchange(Extras.AwaitReadyCycles, 0);
+	if (GAwaitRecordEnabled)
+		RecordAwaitEvent(Extras, EAwaitEvent::Resume, ResumeCycles);
+	if (!GAwaitStatsEnabled || !Extras.DebugAwaiterType)
+		return;
+
+	int32 Index = AwaitTypeIndex(Extras.DebugAwaiterType);
+	if (Index == INDEX_NONE)
+		return;
+
+	auto* Stats = GThreadStats; // AwaitTypeIndex created this
+	auto* Row = Stats->Rows[Index].load(std::memory_order_relaxed);
+	if (UNLIKELY(!Row))
+	{
+		Row = new FRow;
+		Stats->Rows[Index].store(Row, std::memory_order_release);
+	}
+	Row->Suspended.Add(ResumeCycles - FMath::Min(Suspend, ResumeCycles));
+	if (Ready)
+		Row->Delay.Add(ResumeCycles - FMath::Min(Ready, ResumeCycles));
+}
+#endif
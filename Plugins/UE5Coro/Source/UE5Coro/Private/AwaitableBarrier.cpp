@@ -0,0 +1,108 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "UE5Coro/Threading.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Private;
+
+FAwaitableBarrier::FAwaitableBarrier(int Participants,
+                                     TFunction<void()> OnCompletion)
+	: OnCompletion(std::move(OnCompletion)), Participants(Participants),
+	  Remaining(Participants)
+{
+	checkf(Participants > 0, TEXT("Barriers need at least one participant"));
+}
+
+#if UE5CORO_DEBUG
+FAwaitableBarrier::~FAwaitableBarrier()
+{
+	ensureMsgf(!Waiters.load(),
+	           TEXT("Awaitable barrier destroyed with active awaiters"));
+}
+#endif
+
+FBarrierAwaiter FAwaitableBarrier::ArriveAndWait()
+{
+	return FBarrierAwaiter(*this);
+}
+
+void FAwaitableBarrier::ArriveAndDrop()
+{
+	int Old = Participants.fetch_sub(1, std::memory_order_relaxed);
+	checkf(Old > 0, TEXT("Dropped more participants than the barrier had"));
+	Arrive(nullptr);
+}
+
+void FAwaitableBarrier::Enqueue(FAwaitingPromise& Node)
+{
+	auto* Old = Waiters.load(std::memory_order_relaxed);
+	do
+		Node.Next = Old;
+	while (!Waiters.compare_exchange_weak(Old, &Node,
+	                                      std::memory_order_release,
+	                                      std::memory_order_relaxed));
+}
+
+bool FAwaitableBarrier::Arrive(FAwaitingPromise* Self)
+{
+	if (Remaining.fetch_sub(1, std::memory_order_acq_rel) != 1)
+		return false;
+
+	// Everyone else is suspended on this phase, nobody can arrive at the next
+	// one until they're resumed below
+	auto* Node = Waiters.exchange(nullptr, std::memory_order_acquire);
+	Remaining.store(Participants.load(std::memory_order_relaxed),
+	                std::memory_order_relaxed);
+	if (OnCompletion)
+		OnCompletion();
+
+	// Resume the others first, so that the last participant to arrive doesn't
+	// hold them up by running ahead into the next phase
+	while (Node)
+	{
+		// The node is gone as soon as its coroutine resumes
+		auto* Next = Node->Next;
+		if (Node != Self)
+			Node->Promise->Resume();
+		Node = Next;
+	}
+	return Self != nullptr;
+}
+
+void FBarrierAwaiter::Suspend(FPromise& Promise)
+{
+	Node.Promise = &Promise;
+	// The node has to be visible before the last participant is counted
+	Barrier.Enqueue(Node);
+	if (Barrier.Arrive(&Node))
+		Promise.Resume(); // This was the last one
+}
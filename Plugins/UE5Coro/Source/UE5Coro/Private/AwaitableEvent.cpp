@@ -30,12 +30,24 @@
 // ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "UE5Coro/Threading.h"
+#include "GameThreadInbox.h"
+#include "UE5Coro/AsyncAwaiters.h"
+#include "Algo/StableSort.h"
+#include "Async/Async.h"
 
 using namespace UE5Coro;
 using namespace UE5Coro::Private;
 
+namespace
+{
+FAwaitingPromise* AsNode(UPTRINT State)
+{
+	return reinterpret_cast<FAwaitingPromise*>(State);
+}
+}
+
 FAwaitableEvent::FAwaitableEvent(EEventMode Mode, bool bInitialState)
-	: Mode(Mode), bActive(bInitialState)
+	: Mode(Mode), State(bInitialState ? Signaled : 0)
 {
 	checkf(Mode == EEventMode::AutoReset || Mode == EEventMode::ManualReset,
 	       TEXT("Invalid event mode"));
@@ -44,85 +56,216 @@ FAwaitableEvent::FAwaitableEvent(EEventMode Mode, bool bInitialState)
 #if UE5CORO_DEBUG
 FAwaitableEvent::~FAwaitableEvent()
 {
-	ensureMsgf(!Awaiters, TEXT("Awaitable event destroyed with active awaiters"));
+	ensureMsgf(State.load() <= Signaled,
+	           TEXT("Awaitable event destroyed with active awaiters"));
 }
 #endif
 
 void FAwaitableEvent::Trigger()
 {
-	Lock.lock();
+	ResumeAll(Take());
+}
+
+void FAwaitableEvent::TriggerAsync(int32 BatchSize)
+{
+	Dispatch(Take(), BatchSize, false);
+}
+
+void FAwaitableEvent::TriggerParallel(int32 BatchSize)
+{
+	Dispatch(Take(), BatchSize, true);
+}
+
+void FAwaitableEvent::ResumeAll(FAwaitingPromise* Node)
+{
+	while (Node)
+	{
+		// The node is gone as soon as its coroutine resumes
+		auto* Promise = Node->Promise;
+		auto& WaitNode = static_cast<FWaitNode&>(*Node);
+		auto Thread = WaitNode.Thread;
+		bool bStayOnThread = WaitNode.bStayOnThread;
+		Node = Node->Next;
+		if (bStayOnThread)
+			FGameThreadInbox::ResumeOn(Thread, *Promise);
+		else
+			Promise->Resume();
+	}
+}
+
+FAwaitingPromise* FAwaitableEvent::Take()
+{
 	if (Mode == EEventMode::ManualReset)
 	{
-		bActive = true;
-		TryResumeAll();
+		// Take everything that's active at this point, even if the event is
+		// reset before they're all resumed
+		auto Old = State.exchange(Signaled, std::memory_order_acq_rel);
+		return Old != Signaled ? AsNode(Old) : nullptr;
+	}
+
+	auto Old = State.load(std::memory_order_acquire);
+	for (;;)
+	{
+		if (Old == Signaled)
+			return nullptr;
+		if (Old == 0)
+		{
+			if (State.compare_exchange_weak(Old, Signaled,
+			                                std::memory_order_release,
+			                                std::memory_order_acquire))
+				return nullptr;
+			continue;
+		}
+
+		// Take the entire stack, this avoids ABA issues with popping one node
+		if (State.compare_exchange_weak(Old, 0, std::memory_order_acquire))
+		{
+			auto* Node = AsNode(Old);
+			if (auto* Rest = std::exchange(Node->Next, nullptr))
+				Requeue(Rest);
+			return Node;
+		}
+	}
+}
+
+void FAwaitableEvent::Dispatch(FAwaitingPromise* Node, int32 BatchSize,
+                               bool bRunLocal)
+{
+	checkf(BatchSize > 0, TEXT("Invalid batch size"));
+	auto ThisThread = FTaskGraphInterface::Get().GetCurrentThreadIfKnown() &
+	                  ThreadTypeMask;
+	TArray<FPromise*> Local;
+	TArray<TPair<ENamedThreads::Type, FPromise*>> Batch;
+	while (Node)
+	{
+		// Nodes live in the awaiters, this one might be resumed and destroyed
+		// on the game thread as soon as it's pushed to its inbox
+		auto* Promise = Node->Promise;
+		auto Thread = static_cast<FWaitNode*>(Node)->Thread & ThreadTypeMask;
+		Node = Node->Next;
+		if (bRunLocal && Thread == ThisThread && Local.Num() < BatchSize)
+			Local.Add(Promise);
+		else
+		{
+			Thread = Promise->WithTaskPriority(Thread);
+			if (!FGameThreadInbox::TryPush(Thread, *Promise))
+				Batch.Emplace(Thread, Promise);
+		}
 	}
-	else if (Awaiters)
-		ResumeOne(); // AutoReset: don't set bActive
-	else
+
+	// Group by thread, keeping the resumption order within each group
+	Algo::StableSortBy(Batch, [](auto& Pair) { return Pair.Key; });
+	for (int32 Start = 0; Start < Batch.Num();)
 	{
-		bActive = true;
-		Lock.unlock();
+		auto Thread = Batch[Start].Key;
+		// Named threads run their tasks one at a time anyway
+		bool bSplit = (Thread & ThreadTypeMask) == ENamedThreads::AnyThread;
+		TArray<FPromise*> Promises;
+		for (; Start < Batch.Num() && Batch[Start].Key == Thread &&
+		       (!bSplit || Promises.Num() < BatchSize); ++Start)
+			Promises.Add(Batch[Start].Value);
+		AsyncTask(Thread, [Promises = std::move(Promises)]
+		{
+			for (auto* Promise : Promises)
+				Promise->Resume();
+		});
 	}
+
+	for (auto* Promise : Local)
+		Promise->Resume();
 }
 
 void FAwaitableEvent::Reset()
 {
-	std::scoped_lock _(Lock);
-	bActive = false;
+	UPTRINT Expected = Signaled;
+	State.compare_exchange_strong(Expected, 0, std::memory_order_relaxed);
 }
 
-bool FAwaitableEvent::IsManualReset() const
+FEventAwaiter FAwaitableEvent::WaitOnThisThread()
 {
-	return Mode == EEventMode::ManualReset;
+	return FEventAwaiter(*this, true);
 }
 
-bool FAwaitableEvent::await_ready() noexcept
+bool FAwaitableEvent::IsManualReset() const
 {
-	Lock.lock();
-	bool bValue = bActive;
-	if (Mode == EEventMode::AutoReset)
-		bActive = false;
-	if (bValue)
-	{
-		Lock.unlock();
-		return true;
-	}
-	else // Leave it locked
-		return false;
+	return Mode == EEventMode::ManualReset;
 }
 
-void FAwaitableEvent::Suspend(FPromise& Promise)
+bool FAwaitableEvent::TryConsume()
 {
-	checkf(!Lock.try_lock(), TEXT("Internal error: suspension without lock"));
-	checkf(!bActive, TEXT("Internal error: suspending with active event"));
-	Awaiters = new FAwaitingPromise{&Promise, Awaiters};
-	Lock.unlock();
+	if (Mode == EEventMode::ManualReset)
+		return State.load(std::memory_order_acquire) == Signaled;
+	UPTRINT Expected = Signaled;
+	return State.compare_exchange_strong(Expected, 0,
+	                                     std::memory_order_acquire,
+	                                     std::memory_order_relaxed);
 }
 
-void FAwaitableEvent::ResumeOne()
+bool FAwaitableEvent::TryEnqueue(FAwaitingPromise& Node)
 {
-	checkf(!Lock.try_lock(), TEXT("Internal error: resuming without lock"));
-	checkf(Awaiters, TEXT("Internal error: attempting to resume nothing"));
-	auto* Node = std::exchange(Awaiters, Awaiters->Next);
-	Lock.unlock(); // The coroutine might want the lock
+	auto Old = State.load(std::memory_order_relaxed);
+	for (;;)
+	{
+		// Check again, the event might have been triggered since await_ready
+		if (Old == Signaled)
+		{
+			if (Mode == EEventMode::ManualReset)
+				return false;
+			if (State.compare_exchange_weak(Old, 0, std::memory_order_acquire,
+			                                std::memory_order_relaxed))
+				return false;
+			continue;
+		}
 
-	auto* Promise = Node->Promise;
-	delete Node; // Do this first to help tail calls
-	Promise->Resume();
+		Node.Next = AsNode(Old);
+		if (State.compare_exchange_weak(Old, reinterpret_cast<UPTRINT>(&Node),
+		                                std::memory_order_release,
+		                                std::memory_order_relaxed))
+			return true;
+	}
 }
 
-void FAwaitableEvent::TryResumeAll()
+void FAwaitableEvent::Requeue(FAwaitingPromise* List)
 {
-	checkf(!Lock.try_lock(), TEXT("Internal error: resuming without lock"));
+	// List is exclusively owned by this thread until it's pushed back
+	FAwaitingPromise* ToResume = nullptr;
+	auto* Tail = List;
+	while (Tail->Next)
+		Tail = Tail->Next;
 
-	// Start a new awaiter list to make sure everything active at this point
-	// gets resumed eventually, even if the event is reset
-	auto* Node = std::exchange(Awaiters, nullptr);
-	Lock.unlock();
-
-	while (Node)
+	auto Old = State.load(std::memory_order_relaxed);
+	while (List)
 	{
-		Node->Promise->Resume();
-		delete std::exchange(Node, Node->Next);
+		if (Old == Signaled)
+		{
+			// Triggered while these were out, let one of them have this
+			if (!State.compare_exchange_weak(Old, 0, std::memory_order_acquire,
+			                                 std::memory_order_relaxed))
+				continue;
+			auto* Node = std::exchange(List, List->Next);
+			Node->Next = ToResume;
+			ToResume = Node;
+			continue;
+		}
+
+		Tail->Next = AsNode(Old);
+		if (State.compare_exchange_weak(Old, reinterpret_cast<UPTRINT>(List),
+		                                std::memory_order_release,
+		                                std::memory_order_relaxed))
+			break;
 	}
+	ResumeAll(ToResume);
+}
+
+bool FEventAwaiter::await_ready()
+{
+	return Event.TryConsume();
+}
+
+void FEventAwaiter::Suspend(FPromise& Promise)
+{
+	Node.Promise = &Promise;
+	Node.Thread = FTaskGraphInterface::Get().GetCurrentThreadIfKnown();
+	if (!Event.TryEnqueue(Node))
+		Promise.Resume(); // Triggered in the meantime
 }
@@ -0,0 +1,115 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "UE5Coro/Threading.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Private;
+
+namespace
+{
+FAwaitingPromise* AsNode(UPTRINT State)
+{
+	return reinterpret_cast<FAwaitingPromise*>(State);
+}
+}
+
+FAwaitableLatch::FAwaitableLatch(int Count)
+	: Count(Count), State(Count == 0 ? Released : 0)
+{
+	checkf(Count >= 0, TEXT("Latch count cannot be negative"));
+}
+
+#if UE5CORO_DEBUG
+FAwaitableLatch::~FAwaitableLatch()
+{
+	ensureMsgf(State.load() <= Released,
+	           TEXT("Awaitable latch destroyed with active awaiters"));
+}
+#endif
+
+void FAwaitableLatch::CountDown(int Num)
+{
+	checkf(Num >= 0, TEXT("Cannot count down by a negative amount"));
+	if (Num == 0)
+		return;
+	int Before = Count.fetch_sub(Num, std::memory_order_acq_rel);
+	checkf(Before >= Num, TEXT("Latch counted down below zero"));
+	if (Before != Num)
+		return;
+
+	// Everyone on the stack is released at once, later awaiters won't suspend
+	auto Old = State.exchange(Released, std::memory_order_acq_rel);
+	for (auto* Node = AsNode(Old); Node;)
+	{
+		// The node is gone as soon as its coroutine resumes
+		auto* Promise = Node->Promise;
+		Node = Node->Next;
+		Promise->Resume();
+	}
+}
+
+bool FAwaitableLatch::IsReleased() const
+{
+	return State.load(std::memory_order_acquire) == Released;
+}
+
+bool FAwaitableLatch::TryEnqueue(FAwaitingPromise& Node)
+{
+	auto Old = State.load(std::memory_order_relaxed);
+	for (;;)
+	{
+		// Check again, the latch might have been released since await_ready
+		if (Old == Released)
+		{
+			std::atomic_thread_fence(std::memory_order_acquire);
+			return false;
+		}
+
+		Node.Next = AsNode(Old);
+		if (State.compare_exchange_weak(Old, reinterpret_cast<UPTRINT>(&Node),
+		                                std::memory_order_release,
+		                                std::memory_order_relaxed))
+			return true;
+	}
+}
+
+bool FLatchAwaiter::await_ready()
+{
+	return Latch.IsReleased();
+}
+
+void FLatchAwaiter::Suspend(FPromise& Promise)
+{
+	Node.Promise = &Promise;
+	if (!Latch.TryEnqueue(Node))
+		Promise.Resume(); // Released in the meantime
+}
@@ -0,0 +1,144 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "UE5Coro/Threading.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Private;
+
+namespace
+{
+FAwaitingPromise* AsNode(UPTRINT State)
+{
+	return reinterpret_cast<FAwaitingPromise*>(State);
+}
+}
+
+#if UE5CORO_DEBUG
+FAwaitableMutex::~FAwaitableMutex()
+{
+	ensureMsgf(State.load() == Unlocked,
+	           TEXT("Awaitable mutex destroyed while locked"));
+}
+#endif
+
+FMutexAwaiter FAwaitableMutex::Lock()
+{
+	return FMutexAwaiter(*this);
+}
+
+bool FAwaitableMutex::TryLock()
+{
+	UPTRINT Expected = Unlocked;
+	return State.compare_exchange_strong(Expected, 0,
+	                                     std::memory_order_acquire,
+	                                     std::memory_order_relaxed);
+}
+
+void FAwaitableMutex::Unlock()
+{
+	if (!Waiters)
+	{
+		UPTRINT Old = 0;
+		if (State.compare_exchange_strong(Old, Unlocked,
+		                                  std::memory_order_release,
+		                                  std::memory_order_relaxed))
+			return;
+		checkf(Old != Unlocked, TEXT("Unlocking a mutex that's not locked"));
+
+		// Take every new waiter and put them in FIFO order
+		auto* Node = AsNode(State.exchange(0, std::memory_order_acquire));
+		while (Node)
+		{
+			auto* Next = std::exchange(Node->Next, Waiters);
+			Waiters = std::exchange(Node, Next);
+		}
+	}
+
+	// Ownership is handed off, the mutex stays locked
+	auto* Node = std::exchange(Waiters, Waiters->Next);
+	Node->Promise->Resume();
+}
+
+FAwaitableMutex::FScopedLock::FScopedLock(FScopedLock&& Other)
+	: Mutex(std::exchange(Other.Mutex, nullptr))
+{
+}
+
+FAwaitableMutex::FScopedLock::~FScopedLock()
+{
+	if (Mutex)
+		Mutex->Unlock();
+}
+
+void FAwaitableMutex::FScopedLock::Unlock()
+{
+	checkf(Mutex, TEXT("Mutex is already unlocked"));
+	std::exchange(Mutex, nullptr)->Unlock();
+}
+
+bool FMutexAwaiter::await_ready()
+{
+	return Mutex.TryLock();
+}
+
+void FMutexAwaiter::Suspend(FPromise& Promise)
+{
+	Node.Promise = &Promise;
+	auto Old = Mutex.State.load(std::memory_order_relaxed);
+	for (;;)
+	{
+		// The mutex might have been unlocked since await_ready
+		if (Old == FAwaitableMutex::Unlocked)
+		{
+			if (Mutex.State.compare_exchange_weak(Old, 0,
+			                                      std::memory_order_acquire,
+			                                      std::memory_order_relaxed))
+			{
+				Promise.Resume();
+				return;
+			}
+			continue;
+		}
+
+		Node.Next = AsNode(Old);
+		if (Mutex.State.compare_exchange_weak(Old,
+		                                      reinterpret_cast<UPTRINT>(&Node),
+		                                      std::memory_order_release,
+		                                      std::memory_order_relaxed))
+			return;
+	}
+}
+
+FAwaitableMutex::FScopedLock FMutexAwaiter::await_resume()
+{
+	return FAwaitableMutex::FScopedLock(Mutex);
+}
@@ -0,0 +1,208 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "UE5Coro/Threading.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Private;
+
+#if UE5CORO_DEBUG
+FAwaitableRWLock::~FAwaitableRWLock()
+{
+	ensureMsgf(NumReaders == 0 && !bWriter && !Head,
+	           TEXT("Awaitable RW lock destroyed while locked"));
+}
+#endif
+
+FReadLockAwaiter FAwaitableRWLock::ReadLock()
+{
+	return FReadLockAwaiter(*this);
+}
+
+FWriteLockAwaiter FAwaitableRWLock::WriteLock()
+{
+	return FWriteLockAwaiter(*this);
+}
+
+bool FAwaitableRWLock::TryReadLock()
+{
+	std::scoped_lock _(Lock);
+	return TryLockUnsafe(false);
+}
+
+bool FAwaitableRWLock::TryWriteLock()
+{
+	std::scoped_lock _(Lock);
+	return TryLockUnsafe(true);
+}
+
+void FAwaitableRWLock::ReadUnlock()
+{
+	FWaitNode* ToResume;
+	{
+		std::scoped_lock _(Lock);
+		checkf(NumReaders > 0, TEXT("Read unlocking a lock that's not read locked"));
+		if (--NumReaders > 0)
+			return;
+		ToResume = TakeNextUnsafe();
+	}
+	ResumeAll(ToResume);
+}
+
+void FAwaitableRWLock::WriteUnlock()
+{
+	FWaitNode* ToResume;
+	{
+		std::scoped_lock _(Lock);
+		checkf(bWriter, TEXT("Write unlocking a lock that's not write locked"));
+		bWriter = false;
+		ToResume = TakeNextUnsafe();
+	}
+	ResumeAll(ToResume);
+}
+
+bool FAwaitableRWLock::TryLockUnsafe(bool bExclusive)
+{
+	// Anyone waiting goes first
+	if (bWriter || Head)
+		return false;
+	if (bExclusive)
+	{
+		if (NumReaders > 0)
+			return false;
+		bWriter = true;
+	}
+	else
+		++NumReaders;
+	return true;
+}
+
+FAwaitableRWLock::FWaitNode* FAwaitableRWLock::TakeNextUnsafe()
+{
+	checkf(!bWriter && NumReaders == 0,
+	       TEXT("Internal error: taking waiters while locked"));
+	if (!Head)
+		return nullptr;
+
+	auto* First = Head;
+	if (Head->bExclusive)
+	{
+		bWriter = true;
+		Head = static_cast<FWaitNode*>(Head->Next);
+		First->Next = nullptr;
+	}
+	else
+	{
+		// Every reader in front of the next writer
+		FWaitNode* Last = nullptr;
+		for (; Head && !Head->bExclusive;
+		     Head = static_cast<FWaitNode*>(Head->Next))
+		{
+			++NumReaders;
+			Last = Head;
+		}
+		Last->Next = nullptr;
+	}
+	if (!Head)
+		Tail = nullptr;
+	return First;
+}
+
+void FAwaitableRWLock::ResumeAll(FWaitNode* Node)
+{
+	while (Node)
+	{
+		// The node is gone as soon as its coroutine resumes
+		auto* Promise = Node->Promise;
+		Node = static_cast<FWaitNode*>(Node->Next);
+		Promise->Resume();
+	}
+}
+
+FAwaitableRWLock::FScopedReadLock::FScopedReadLock(FScopedReadLock&& Other)
+	: RWLock(std::exchange(Other.RWLock, nullptr))
+{
+}
+
+FAwaitableRWLock::FScopedReadLock::~FScopedReadLock()
+{
+	if (RWLock)
+		RWLock->ReadUnlock();
+}
+
+void FAwaitableRWLock::FScopedReadLock::Unlock()
+{
+	checkf(RWLock, TEXT("Lock is already released"));
+	std::exchange(RWLock, nullptr)->ReadUnlock();
+}
+
+FAwaitableRWLock::FScopedWriteLock::FScopedWriteLock(FScopedWriteLock&& Other)
+	: RWLock(std::exchange(Other.RWLock, nullptr))
+{
+}
+
+FAwaitableRWLock::FScopedWriteLock::~FScopedWriteLock()
+{
+	if (RWLock)
+		RWLock->WriteUnlock();
+}
+
+void FAwaitableRWLock::FScopedWriteLock::Unlock()
+{
+	checkf(RWLock, TEXT("Lock is already released"));
+	std::exchange(RWLock, nullptr)->WriteUnlock();
+}
+
+bool FRWLockAwaiter::await_ready()
+{
+	std::scoped_lock _(RWLock.Lock);
+	return RWLock.TryLockUnsafe(Node.bExclusive);
+}
+
+void FRWLockAwaiter::Suspend(FPromise& Promise)
+{
+	{
+		std::scoped_lock _(RWLock.Lock);
+		// The lock might have become available since await_ready
+		if (!RWLock.TryLockUnsafe(Node.bExclusive))
+		{
+			Node.Promise = &Promise;
+			Node.Next = nullptr;
+			if (RWLock.Tail)
+				RWLock.Tail->Next = &Node;
+			else
+				RWLock.Head = &Node;
+			RWLock.Tail = &Node;
+			return;
+		}
+	}
+	Promise.Resume();
+}
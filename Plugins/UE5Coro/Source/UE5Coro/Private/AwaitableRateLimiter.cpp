@@ -0,0 +1,171 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "UE5Coro/Threading.h"
+#include "GameThreadInbox.h"
+#include "TimerThread.h"
+#include <mutex>
+#include "Async/Async.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Private;
+
+FAwaitableRateLimiter::FAwaitableRateLimiter(double Rate, double Burst)
+	: Rate(Rate), Burst(Burst), Tokens(Burst),
+	  LastRefill(FPlatformTime::Seconds())
+{
+	checkf(Rate > 0 && Burst >= 1, TEXT("Rate limiter values out of range"));
+}
+
+FAwaitableRateLimiter::~FAwaitableRateLimiter()
+{
+	std::scoped_lock _(Lock);
+	ensureMsgf(!Head, TEXT("Awaitable rate limiter destroyed with awaiters"));
+	// Don't leave a dangling callback behind in shipping builds either
+	if (bArmed)
+		FTimerThread::Get().TryUnregister(&*Timer);
+}
+
+FRateLimiterAwaiter FAwaitableRateLimiter::Acquire(int32 Num)
+{
+	checkf(Num > 0 && Num <= Burst,
+	       TEXT("Attempting to acquire an invalid number of tokens"));
+	return FRateLimiterAwaiter(*this, Num);
+}
+
+bool FAwaitableRateLimiter::TryAcquire(int32 Num)
+{
+	checkf(Num > 0 && Num <= Burst,
+	       TEXT("Attempting to acquire an invalid number of tokens"));
+	std::scoped_lock _(Lock);
+	Refill();
+	// Don't cut in line
+	if (Head || Tokens < Num)
+		return false;
+	Tokens -= Num;
+	return true;
+}
+
+double FAwaitableRateLimiter::GetTokens()
+{
+	std::scoped_lock _(Lock);
+	Refill();
+	return Tokens;
+}
+
+void FAwaitableRateLimiter::Refill()
+{
+	auto Now = FPlatformTime::Seconds();
+	Tokens = FMath::Min(Burst, Tokens + (Now - LastRefill) * Rate);
+	LastRefill = Now;
+}
+
+bool FAwaitableRateLimiter::TryEnqueue(FWaitNode& Node)
+{
+	std::scoped_lock _(Lock);
+	// Check again, tokens might have been added since await_ready
+	Refill();
+	if (!Head && Tokens >= Node.Num)
+	{
+		Tokens -= Node.Num;
+		return false;
+	}
+
+	Node.Next = nullptr;
+	if (Tail)
+		Tail->Next = &Node;
+	else
+		Head = &Node;
+	Tail = &Node;
+	if (!bArmed)
+		Arm();
+	return true;
+}
+
+void FAwaitableRateLimiter::Arm()
+{
+	// Only the first waiter matters, the others are behind it in the queue
+	auto TargetTime = LastRefill + (Head->Num - Tokens) / Rate;
+	Timer.Emplace(TargetTime, true);
+	bArmed = true;
+	FTimerThread::Get().RegisterCallback(&*Timer, &OnTimer, this);
+}
+
+void FAwaitableRateLimiter::OnTimer(void* Context)
+{
+	auto* This = static_cast<FAwaitableRateLimiter*>(Context);
+	FWaitNode* Ready = nullptr;
+	{
+		std::scoped_lock _(This->Lock);
+		This->bArmed = false;
+		This->Refill();
+		FWaitNode** ReadyTail = &Ready;
+		// Tolerate rounding errors, the timer targeted exactly enough tokens
+		while (This->Head && This->Tokens + 1e-9 >= This->Head->Num)
+		{
+			auto* Node = This->Head;
+			This->Tokens = FMath::Max(0.0, This->Tokens - Node->Num);
+			This->Head = Node->Next;
+			Node->Next = nullptr;
+			*ReadyTail = Node;
+			ReadyTail = &Node->Next;
+		}
+		if (This->Head)
+			This->Arm();
+		else
+			This->Tail = nullptr;
+	}
+
+	// This might be the last use of the limiter, don't touch This from here on
+	while (Ready)
+	{
+		// The node is gone as soon as its coroutine resumes
+		auto* Promise = Ready->Promise;
+		auto Thread = Promise->WithTaskPriority(Ready->Thread & ThreadTypeMask);
+		Ready = Ready->Next;
+		if (!FGameThreadInbox::TryPush(Thread, *Promise))
+			AsyncTask(Thread, [Promise] { Promise->Resume(); });
+	}
+}
+
+bool FRateLimiterAwaiter::await_ready()
+{
+	return Limiter.TryAcquire(Node.Num);
+}
+
+void FRateLimiterAwaiter::Suspend(FPromise& Promise)
+{
+	Node.Promise = &Promise;
+	Node.Thread = FTaskGraphInterface::Get().GetCurrentThreadIfKnown();
+	if (!Limiter.TryEnqueue(Node))
+		Promise.Resume(); // Tokens became available in the meantime
+}
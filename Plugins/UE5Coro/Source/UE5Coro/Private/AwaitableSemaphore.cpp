@@ -30,65 +30,251 @@
 // ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "UE5Coro/Threading.h"
+#include "GameThreadInbox.h"
+#include <mutex>
+#include "UE5Coro/AsyncAwaiters.h"
+#include "Algo/StableSort.h"
+#include "Async/Async.h"
 
 using namespace UE5Coro;
 using namespace UE5Coro::Private;
 
-FAwaitableSemaphore::FAwaitableSemaphore(int Capacity, int InitialCount)
-	: Capacity(Capacity), Count(InitialCount)
+FAwaitableSemaphore::FAwaitableSemaphore(int Capacity, int InitialCount,
+                                         ESemaphoreOrder Order)
+	: Capacity(Capacity), Order(Order), Count(InitialCount)
 {
 	checkf(Capacity > 0 && InitialCount >= 0 && InitialCount <= Capacity,
 	       TEXT("Initial semaphore values out of range"));
+	checkf(Order == ESemaphoreOrder::Unordered || Order == ESemaphoreOrder::FIFO,
+	       TEXT("Invalid semaphore order"));
 }
 
 #if UE5CORO_DEBUG
 FAwaitableSemaphore::~FAwaitableSemaphore()
 {
-	ensureMsgf(!Awaiters,
+	ensureMsgf(!Awaiters && !OrderedAwaiters && Count >= 0,
 	           TEXT("Awaitable semaphore destroyed with active awaiters"));
 }
 #endif
 
+bool FAwaitableSemaphore::TryLock()
+{
+	int Old = Count.load(std::memory_order_relaxed);
+	while (Old > 0)
+		if (Count.compare_exchange_weak(Old, Old - 1, std::memory_order_acquire,
+		                                std::memory_order_relaxed))
+			return true;
+	return false;
+}
+
 void FAwaitableSemaphore::Unlock(int InCount)
 {
-	checkf(InCount > 0, TEXT("Invalid count"));
-	Lock.lock();
-	verifyf((Count += InCount) <= Capacity,
-	        TEXT("Semaphore unlocked above maximum"));
-	TryResumeAll();
+	auto* Node = Take(Release(InCount));
+	while (Node)
+	{
+		// The node is gone as soon as its coroutine resumes
+		auto* Promise = Node->Promise;
+		auto Thread = Node->Thread;
+		bool bStayOnThread = Node->bStayOnThread;
+		Node = static_cast<FWaitNode*>(Node->Next);
+		if (bStayOnThread)
+			FGameThreadInbox::ResumeOn(Thread, *Promise);
+		else
+			Promise->Resume();
+	}
 }
 
-bool FAwaitableSemaphore::await_ready()
+void FAwaitableSemaphore::UnlockBatch(int InCount)
 {
-	Lock.lock();
-	if (Count > 0)
+	TArray<TPair<ENamedThreads::Type, FPromise*>> Batch;
+	for (auto* Node = Take(Release(InCount)); Node;
+	     Node = static_cast<FWaitNode*>(Node->Next))
 	{
-		verifyf(--Count >= 0, TEXT("Internal error: semaphore went negative"));
-		Lock.unlock();
-		return true;
+		auto* Promise = Node->Promise;
+		auto Thread = Promise->WithTaskPriority(Node->Thread & ThreadTypeMask);
+		if (!FGameThreadInbox::TryPush(Thread, *Promise))
+			Batch.Emplace(Thread, Promise);
+	}
+	if (Batch.Num() == 0)
+		return;
+
+	// Group by thread, keeping the resumption order within each group
+	Algo::StableSortBy(Batch, [](auto& Pair) { return Pair.Key; });
+	for (int32 Start = 0; Start < Batch.Num();)
+	{
+		auto Thread = Batch[Start].Key;
+		TArray<FPromise*> Promises;
+		for (; Start < Batch.Num() && Batch[Start].Key == Thread; ++Start)
+			Promises.Add(Batch[Start].Value);
+		AsyncTask(Thread, [Promises = std::move(Promises)]
+		{
+			for (auto* Promise : Promises)
+				Promise->Resume();
+		});
 	}
-	else // Leave it locked
-		return false;
 }
 
-void FAwaitableSemaphore::Suspend(FPromise& Promise)
+FSemaphoreAwaiter FAwaitableSemaphore::LockOnThisThread()
 {
-	checkf(!Lock.try_lock(), TEXT("Internal error: suspension without lock"));
-	Awaiters = new FAwaitingPromise{&Promise, Awaiters};
-	Lock.unlock();
+	return FSemaphoreAwaiter(*this, true);
 }
 
-void FAwaitableSemaphore::TryResumeAll()
+auto FAwaitableSemaphore::GetStats() const -> FStats
 {
-	checkf(!Lock.try_lock(), TEXT("Internal error: resuming without lock held"));
-	while (Awaiters && Count > 0)
+	uint64 Histogram[NumStatBuckets];
+	FStats Stats;
+	for (int i = 0; i < NumStatBuckets; ++i)
+		Stats.NumWaits += Histogram[i] =
+			WaitHistogram[i].load(std::memory_order_relaxed);
+	Stats.MaxSeconds = MaxWait.load(std::memory_order_relaxed);
+
+	auto Percentile = [&](uint64 Rank)
+	{
+		for (int i = 0; i < NumStatBuckets; ++i)
+		{
+			if (Rank < Histogram[i])
+				return static_cast<double>(1ull << i) / 1e6;
+			Rank -= Histogram[i];
+		}
+		return Stats.MaxSeconds;
+	};
+	if (Stats.NumWaits > 0)
 	{
-		auto* Node = std::exchange(Awaiters, Awaiters->Next);
-		verifyf(--Count >= 0, TEXT("Internal error: semaphore went negative"));
-		Lock.unlock();
-		Node->Promise->Resume();
-		delete Node;
-		Lock.lock();
+		Stats.P50Seconds = Percentile(Stats.NumWaits / 2);
+		Stats.P99Seconds = Percentile(Stats.NumWaits * 99 / 100);
 	}
-	Lock.unlock();
+	return Stats;
+}
+
+int FAwaitableSemaphore::Release(int InCount)
+{
+	checkf(InCount > 0, TEXT("Invalid count"));
+	int Old = Count.fetch_add(InCount, std::memory_order_acq_rel);
+	verifyf(Old + InCount <= Capacity, TEXT("Semaphore unlocked above maximum"));
+	// Negative counts are waiters that are owed a resumption
+	return Old < 0 ? FMath::Min(InCount, -Old) : 0;
+}
+
+void FAwaitableSemaphore::Push(FWaitNode& Node)
+{
+	auto* Old = Awaiters.load(std::memory_order_relaxed);
+	do
+		Node.Next = Old;
+	while (!Awaiters.compare_exchange_weak(Old, &Node,
+	                                       std::memory_order_release,
+	                                       std::memory_order_relaxed));
+}
+
+FAwaitableSemaphore::FWaitNode* FAwaitableSemaphore::Take(int Num)
+{
+	if (Num == 0)
+		return nullptr;
+	auto* Nodes = Order == ESemaphoreOrder::FIFO ? TakeFIFO(Num)
+	                                             : TakeUnordered(Num);
+	double Now = FPlatformTime::Seconds();
+	for (auto* Node = Nodes; Node; Node = static_cast<FWaitNode*>(Node->Next))
+		RecordWait(Now - Node->StartTime);
+	return Nodes;
+}
+
+FAwaitableSemaphore::FWaitNode* FAwaitableSemaphore::TakeUnordered(int Num)
+{
+	FWaitNode* Taken = nullptr;
+	while (Num > 0)
+	{
+		// Taking the entire stack avoids ABA issues with popping single nodes
+		auto* List = Awaiters.exchange(nullptr, std::memory_order_acquire);
+		if (!List)
+		{
+			// A waiter has taken a count but it's not pushed yet, this is short
+			FPlatformProcess::YieldThread();
+			continue;
+		}
+
+		for (; List && Num > 0; --Num)
+		{
+			auto* Node = std::exchange(List, static_cast<FWaitNode*>(List->Next));
+			Node->Next = Taken;
+			Taken = Node;
+		}
+
+		// Put the rest back
+		if (List)
+		{
+			auto* Tail = List;
+			while (Tail->Next)
+				Tail = static_cast<FWaitNode*>(Tail->Next);
+			auto* Old = Awaiters.load(std::memory_order_relaxed);
+			do
+				Tail->Next = Old;
+			while (!Awaiters.compare_exchange_weak(Old, List,
+			                                       std::memory_order_release,
+			                                       std::memory_order_relaxed));
+		}
+	}
+	return Taken;
+}
+
+FAwaitableSemaphore::FWaitNode* FAwaitableSemaphore::TakeFIFO(int Num)
+{
+	// Pushing stays lock-free, only resumers are serialized.
+	// Everything in OrderedAwaiters is older than anything in Awaiters.
+	FAwaitingPromise* Taken = nullptr;
+	FAwaitingPromise** TakenTail = &Taken;
+	std::scoped_lock _(PopLock);
+	while (Num > 0)
+	{
+		if (!OrderedAwaiters)
+		{
+			auto* List = Awaiters.exchange(nullptr, std::memory_order_acquire);
+			if (!List)
+			{
+				// A waiter has taken a count but it's not pushed yet
+				FPlatformProcess::YieldThread();
+				continue;
+			}
+			// Reverse the stack to get oldest first
+			while (List)
+			{
+				auto* Node = std::exchange(List,
+				                           static_cast<FWaitNode*>(List->Next));
+				Node->Next = OrderedAwaiters;
+				OrderedAwaiters = Node;
+			}
+		}
+
+		auto* Node = std::exchange(OrderedAwaiters,
+		                           static_cast<FWaitNode*>(OrderedAwaiters->Next));
+		Node->Next = nullptr;
+		*TakenTail = Node;
+		TakenTail = &Node->Next;
+		--Num;
+	}
+	return static_cast<FWaitNode*>(Taken);
+}
+
+void FAwaitableSemaphore::RecordWait(double Seconds)
+{
+	auto Micros = static_cast<uint64>(FMath::Max(0.0, Seconds) * 1e6);
+	int Bucket = Micros == 0
+		? 0 : static_cast<int>(FMath::FloorLog2_64(Micros)) + 1;
+	Bucket = FMath::Min(Bucket, NumStatBuckets - 1);
+	WaitHistogram[Bucket].fetch_add(1, std::memory_order_relaxed);
+	for (double Max = MaxWait.load(std::memory_order_relaxed);
+	     Seconds > Max && !MaxWait.compare_exchange_weak(Max, Seconds);)
+		;
+}
+
+bool FSemaphoreAwaiter::await_ready()
+{
+	// Failing to take a count commits this awaiter to suspending
+	return Semaphore.Count.fetch_sub(1, std::memory_order_acq_rel) > 0;
+}
+
+void FSemaphoreAwaiter::Suspend(FPromise& Promise)
+{
+	Node.Promise = &Promise;
+	Node.Thread = FTaskGraphInterface::Get().GetCurrentThreadIfKnown();
+	Node.StartTime = FPlatformTime::Seconds();
+	Semaphore.Push(Node);
 }
@@ -0,0 +1,301 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "Census.h"
+#include "Containers/Ticker.h"
+#include "HAL/IConsoleManager.h"
+
+using namespace UE5Coro::Private;
+
+bool UE5Coro::Private::GCensusEnabled = false;
+thread_local size_t UE5Coro::Private::GLastFrameSize = 0;
+
+namespace
+{
+DEFINE_LOG_CATEGORY_STATIC(LogUE5CoroCensus, Log, All);
+
+FAutoConsoleVariableRef CVarCensus(
+	TEXT("UE5Coro.Census"), GCensusEnabled,
+	TEXT("Keep a registry of live coroutines for UE5Coro.List and ")
+	TEXT("UE5Coro.Stats. Only coroutines that start while this is set are ")
+	TEXT("tracked. This has no cost while it's off."));
+
+struct FEntry
+{
+	const TCHAR* PromiseType;
+	double CreationTime;
+	size_t FrameSize;
+};
+
+struct FRegistry
+{
+	FMutex Lock;
+	// Kept out of FPromise so that promises don't pay for it with the census
+	// off, which is the common case
+	TMap<FPromise*, FEntry> Promises;
+	FCoroutineCensus::FCounts Counts;
+
+	static FRegistry& Get()
+	{
+		static FRegistry Instance;
+		return Instance;
+	}
+};
+
+FTSTicker::FDelegateHandle StatsHandle;
+
+FAutoConsoleCommandWithOutputDevice CmdList(
+	TEXT("UE5Coro.List"),
+	TEXT("Prints the live coroutines that were started with UE5Coro.Census ")
+	TEXT("on, grouped by promise type, debug name, and what they await."),
+	FConsoleCommandWithOutputDeviceDelegate::CreateStatic(
+		&FCoroutineCensus::List));
+
+FAutoConsoleCommandWithOutputDevice CmdDumpStacks(
+	TEXT("UE5Coro.DumpStacks"),
+	TEXT("Prints the logical call stacks of live coroutines that were ")
+	TEXT("started with UE5Coro.Census on: every coroutine that's not ")
+	TEXT("co_awaiting another one, followed by the ones co_awaiting it."),
+	FConsoleCommandWithOutputDeviceDelegate::CreateStatic(
+		&FCoroutineCensus::DumpStacks));
+
+FAutoConsoleCommandWithOutputDevice CmdMemReport(
+	TEXT("UE5Coro.MemReport"),
+	TEXT("Prints coroutine frame memory, broken down by coroutine if ")
+	TEXT("UE5Coro.Census is on. This is included in memreports."),
+	FConsoleCommandWithOutputDeviceDelegate::CreateLambda([](FOutputDevice& Ar)
+	{
+		auto Stats = FFrameAllocator::GetStats();
+		Ar.Logf(TEXT("Frame pool: %lld bytes reserved, %lld peak, ")
+		        TEXT("%llu allocations, %.1f%% from free lists"),
+		        Stats.BytesReserved, Stats.PeakBytesReserved,
+		        Stats.Allocations, Stats.HitRate() * 100);
+		if (GCensusEnabled)
+			FCoroutineCensus::List(Ar);
+		else
+			Ar.Logf(TEXT("Set UE5Coro.Census 1 for frame sizes per coroutine"));
+	}));
+
+FAutoConsoleCommandWithOutputDevice CmdStats(
+	TEXT("UE5Coro.Stats"),
+	TEXT("Toggles logging coroutine creation and destruction rates every ")
+	TEXT("second. Requires UE5Coro.Census."),
+	FConsoleCommandWithOutputDeviceDelegate::CreateLambda([](FOutputDevice& Ar)
+	{
+		if (StatsHandle.IsValid())
+		{
+			FTSTicker::GetCoreTicker().RemoveTicker(StatsHandle);
+			StatsHandle.Reset();
+			Ar.Logf(TEXT("UE5Coro.Stats stopped"));
+			return;
+		}
+		if (!GCensusEnabled)
+			Ar.Logf(TEXT("UE5Coro.Census is off, nothing will be counted"));
+
+		auto Last = FCoroutineCensus::GetCounts();
+		double LastTime = FPlatformTime::Seconds();
+		StatsHandle = FTSTicker::GetCoreTicker().AddTicker(
+			FTickerDelegate::CreateLambda([=](float) mutable
+			{
+				auto Counts = FCoroutineCensus::GetCounts();
+				double Now = FPlatformTime::Seconds();
+				double Elapsed = FMath::Max(Now - LastTime, 1e-6);
+				UE_LOG(LogUE5CoroCensus, Display,
+				       TEXT("%lld live coroutines, %.1f created/s, ")
+				       TEXT("%.1f destroyed/s"), Counts.Live,
+				       (Counts.Created - Last.Created) / Elapsed,
+				       (Counts.Destroyed - Last.Destroyed) / Elapsed);
+				Last = Counts;
+				LastTime = Now;
+				return true;
+			}), 1);
+	}));
+}
+
+void FCoroutineCensus::Add(FPromise& Promise, const TCHAR* PromiseType)
+{
+	FEntry Entry{PromiseType, FPlatformTime::Seconds(),
+	             std::exchange(GLastFrameSize, 0)};
+
+	auto& Registry = FRegistry::Get();
+	std::scoped_lock _(Registry.Lock);
+	Registry.Promises.Add(&Promise, Entry);
+	Promise.bInCensus = true;
+	++Registry.Counts.Live;
+	++Registry.Counts.Created;
+}
+
+void FCoroutineCensus::Remove(FPromise& Promise)
+{
+	auto& Registry = FRegistry::Get();
+	std::scoped_lock _(Registry.Lock);
+	verifyf(Registry.Promises.Remove(&Promise) == 1,
+	        TEXT("Internal error: removing unregistered promise"));
+	Promise.bInCensus = false;
+	--Registry.Counts.Live;
+	++Registry.Counts.Destroyed;
+}
+
+void FCoroutineCensus::List(FOutputDevice& Ar)
+{
+	struct FGroup
+	{
+		int32 Count = 0;
+		size_t FrameBytes = 0;
+		double MaxAge = 0;
+	};
+	TMap<FString, FGroup> Groups;
+	int32 Total = 0;
+	double Now = FPlatformTime::Seconds();
+
+	{
+		auto& Registry = FRegistry::Get();
+		std::scoped_lock _(Registry.Lock);
+		for (auto& [Promise, Entry] : Registry.Promises)
+		{
+#if UE5CORO_DEBUG
+			// These might change concurrently, but they're static strings
+			const TCHAR* Name = Promise->Extras->DebugName;
+			const TCHAR* Awaiter = Promise->Extras->DebugAwaiterType;
+			auto Key = FString::Printf(TEXT("%-8s %-32s %s"), Entry.PromiseType,
+			                           Name ? Name : TEXT("-"),
+			                           Awaiter ? Awaiter : TEXT("-"));
+#else
+			FString Key = Entry.PromiseType;
+#endif
+			auto& Group = Groups.FindOrAdd(MoveTemp(Key));
+			++Group.Count;
+			Group.FrameBytes += Entry.FrameSize;
+			Group.MaxAge = FMath::Max(Group.MaxAge, Now - Entry.CreationTime);
+			++Total;
+		}
+	}
+
+	Groups.ValueSort([](const FGroup& A, const FGroup& B)
+	{
+		return A.Count > B.Count;
+	});
+	Ar.Logf(TEXT("%8s %12s %10s  %-8s %-32s %s"), TEXT("Count"),
+	        TEXT("Frame bytes"), TEXT("Oldest s"), TEXT("Type"),
+	        TEXT("Debug name"), TEXT("Awaiting"));
+	for (auto& [Key, Group] : Groups)
+		Ar.Logf(TEXT("%8d %12llu %10.1f  %s"), Group.Count,
+		        static_cast<uint64>(Group.FrameBytes), Group.MaxAge, *Key);
+	Ar.Logf(TEXT("%d live coroutines in %d groups"), Total, Groups.Num());
+}
+
+void FCoroutineCensus::DumpStacks(FOutputDevice& Ar)
+{
+	// Cycles are not possible, but the chain might be changing concurrently
+	constexpr int MaxDepth = 64;
+	TMap<FString, int32> Stacks;
+	int32 Total = 0;
+
+	{
+		auto& Registry = FRegistry::Get();
+		std::scoped_lock _(Registry.Lock);
+		TSet<FPromise*> Callers;
+		for (auto& [Promise, Entry] : Registry.Promises)
+			if (auto* Caller = Promise->Extras->AwaitedBy.load(
+				    std::memory_order_acquire))
+				Callers.Add(Caller);
+
+		for (auto& [Promise, Entry] : Registry.Promises)
+		{
+			if (Callers.Contains(Promise))
+				continue;
+			FString Stack;
+			int Depth = 0;
+			for (auto* Frame = Promise; Frame && Depth < MaxDepth;
+			     Frame = Frame->Extras->AwaitedBy.load(
+				     std::memory_order_acquire), ++Depth)
+			{
+				// Unregistered callers might be destroyed concurrently
+				auto* FrameEntry = Registry.Promises.Find(Frame);
+				if (!FrameEntry)
+				{
+					Stack += TEXT("\n    (not in the census)");
+					break;
+				}
+#if UE5CORO_DEBUG
+				// These might change concurrently, but they're static strings
+				const TCHAR* Name = Frame->Extras->DebugName;
+				const TCHAR* Awaiter = Frame->Extras->DebugAwaiterType;
+				Stack += FString::Printf(TEXT("\n    %-8s %-32s %s"),
+				                         FrameEntry->PromiseType,
+				                         Name ? Name : TEXT("-"),
+				                         Awaiter ? Awaiter : TEXT("-"));
+#else
+				Stack += TEXT("\n    ");
+				Stack += FrameEntry->PromiseType;
+#endif
+			}
+			++Stacks.FindOrAdd(MoveTemp(Stack));
+			++Total;
+		}
+	}
+
+	Stacks.ValueSort([](int32 A, int32 B) { return A > B; });
+	for (auto& [Stack, Count] : Stacks)
+		Ar.Logf(TEXT("%d coroutine(s):%s"), Count, *Stack);
+	Ar.Logf(TEXT("%d logical stacks in %d groups"), Total, Stacks.Num());
+}
+
+FCoroutineCensus::FCallers FCoroutineCensus::GetCallers(
+	const FPromiseExtras& Extras)
+{
+	FCallers Callers;
+	// Most coroutines are not awaited, this doesn't need the lock
+	auto* Caller = Extras.AwaitedBy.load(std::memory_order_acquire);
+	if (!Caller)
+		return Callers;
+
+	auto& Registry = FRegistry::Get();
+	std::scoped_lock _(Registry.Lock);
+	// Registered promises cannot finish destruction while this is locked.
+	// The chain might be changing concurrently, cycles are not possible.
+	for (int i = 0; i < 64 && Caller && Registry.Promises.Contains(Caller);
+	     ++i)
+	{
+		Callers.Root = Caller->Extras;
+		if (!Callers.Caller)
+			Callers.Caller = Callers.Root;
+		Caller = Callers.Root->AwaitedBy.load(std::memory_order_acquire);
+	}
+	return Callers;
+}
+
+FCoroutineCensus::FCounts FCoroutineCensus::GetCounts()
+{
+	auto& Registry = FRegistry::Get();
+	std::scoped_lock _(Registry.Lock);
+	return Registry.Counts;
+}
@@ -0,0 +1,79 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UE5Coro/Definitions.h"
+#include "UE5Coro/AsyncCoroutine.h"
+
+namespace UE5Coro::Private
+{
+/** Set by UE5Coro.Census. Promises are only registered while this is on. */
+extern bool GCensusEnabled;
+
+/** Size of the most recent frame allocated on this thread, consumed by the
+ *  promise that's constructed in it. */
+extern thread_local size_t GLastFrameSize;
+
+/** Registry of live promises for the UE5Coro.List and UE5Coro.Stats
+ *  commands. */
+class FCoroutineCensus
+{
+public:
+	struct FCounts
+	{
+		int64 Live = 0;
+		uint64 Created = 0;
+		uint64 Destroyed = 0;
+	};
+
+	static void Add(FPromise& Promise, const TCHAR* PromiseType);
+	static void Remove(FPromise& Promise);
+	/** Prints live coroutines grouped by type, name, and what they await. */
+	static void List(FOutputDevice& Ar);
+	/** Prints the chains of coroutines awaiting each other, innermost first,
+	 *  grouped by identical chains. */
+	static void DumpStacks(FOutputDevice& Ar);
+	struct FCallers
+	{
+		std::shared_ptr<FPromiseExtras> Caller; // Awaiting Extras' coroutine
+		std::shared_ptr<FPromiseExtras> Root; // Outermost in the chain
+	};
+
+	/** Follows the coroutines co_awaiting Extras' coroutine.<br>
+	 *  Only promises in the census are dereferenced, and only while they're
+	 *  kept alive by its lock: the chain stops at the first one that's not
+	 *  registered. Both are null if there are none. */
+	static FCallers GetCallers(const FPromiseExtras& Extras);
+	static FCounts GetCounts();
+};
+}
@@ -0,0 +1,93 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "UE5Coro/CompressionAwaiters.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Private;
+
+namespace
+{
+bool Process(bool bCompress, FName Format, Async::FCompressionChunk& Chunk,
+             ECompressionFlags Flags)
+{
+	if (bCompress)
+	{
+		int32 Size = Chunk.Output.Num();
+		Chunk.bSucceeded = FCompression::CompressMemory(
+			Format, Chunk.Output.GetData(), Size, Chunk.Input.GetData(),
+			Chunk.Input.Num(), Flags);
+		Chunk.OutputSize = Chunk.bSucceeded ? Size : 0;
+	}
+	else
+	{
+		Chunk.bSucceeded = FCompression::UncompressMemory(
+			Format, Chunk.Output.GetData(), Chunk.Output.Num(),
+			Chunk.Input.GetData(), Chunk.Input.Num(), Flags);
+		Chunk.OutputSize = Chunk.bSucceeded ? Chunk.Output.Num() : 0;
+	}
+	return Chunk.bSucceeded;
+}
+}
+
+FCompressionAwaiter Async::DecompressChunks(
+	FName Format, TArrayView<FCompressionChunk> Chunks, ECompressionFlags Flags)
+{
+	return FCompressionAwaiter(false, Format, Chunks, Flags);
+}
+
+FCompressionAwaiter Async::CompressChunks(
+	FName Format, TArrayView<FCompressionChunk> Chunks, ECompressionFlags Flags)
+{
+	return FCompressionAwaiter(true, Format, Chunks, Flags);
+}
+
+FCompressionAwaiter::FCompressionAwaiter(
+	bool bCompress, FName Format, TArrayView<Async::FCompressionChunk> Chunks,
+	ECompressionFlags Flags)
+	: FParallelForAwaiter(Chunks.Num(), 1, &RunBatch), bCompress(bCompress)
+	, Format(Format), Chunks(Chunks), Flags(Flags)
+{
+}
+
+void FCompressionAwaiter::RunBatch(FParallelForAwaiter& Base, int32 Begin,
+                                   int32 End)
+{
+	auto& This = static_cast<FCompressionAwaiter&>(Base);
+	for (int32 i = Begin; i < End; ++i)
+		if (!Process(This.bCompress, This.Format, This.Chunks[i], This.Flags))
+			This.bAllSucceeded = false;
+}
+
+bool FCompressionAwaiter::await_resume()
+{
+	return bAllSucceeded;
+}
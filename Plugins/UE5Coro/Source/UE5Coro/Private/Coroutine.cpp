@@ -30,6 +30,7 @@
 // ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "UE5Coro/Coroutine.h"
+#include "Async/TaskGraphInterfaces.h"
 
 using namespace UE5Coro;
 using namespace UE5Coro::Private;
@@ -44,13 +45,28 @@ void TCoroutine<void>::Cancel()
 	std::scoped_lock _(Extras->Lock);
 	// Holding the lock guarantees that Promise is active in the union
 	if (Extras->Promise)
+	{
 		Extras->Promise->Cancel();
+		Extras->Promise->NotifyCanceled();
+	}
 }
 
 bool TCoroutine<>::Wait(uint32 WaitTimeMilliseconds,
                         bool bIgnoreThreadIdleStats) const
 {
-	return Extras->Completed->Wait(WaitTimeMilliseconds, bIgnoreThreadIdleStats);
+	return Extras->Wait(WaitTimeMilliseconds, bIgnoreThreadIdleStats);
+}
+
+void TCoroutine<>::WaitAndHelp() const
+{
+	if (IsDone())
+		return;
+
+	auto& TaskGraph = FTaskGraphInterface::Get();
+	FGraphEventRef Event = FGraphEvent::CreateGraphEvent();
+	ContinueWith([Event] { Event->DispatchSubsequents(); });
+	TaskGraph.WaitUntilTaskCompletes(Event,
+	                                 TaskGraph.GetCurrentThreadIfKnown());
 }
 
 bool TCoroutine<>::IsDone() const
@@ -67,7 +83,8 @@ void TCoroutine<>::SetDebugName(const TCHAR* Name)
 {
 #if UE5CORO_DEBUG
 	if (ensureMsgf(GCurrentPromise,
-	               TEXT("Attempting to set a debug name outside a coroutine")))
+	               TEXT("Attempting to set a debug name outside a coroutine")) &&
+	    GDebugMetadata >= 1)
 		GCurrentPromise->Extras->DebugName = Name;
 #endif
 }
@@ -0,0 +1,181 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "UE5Coro/CoroutineArena.h"
+#include "UE5Coro/AsyncCoroutine.h"
+#include "UE5Coro/FrameAllocator.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Private;
+
+struct alignas(16) FCoroutineArena::FBlock
+{
+	FBlock* Prev;
+	size_t Capacity; // Payload only
+	size_t Used;
+
+	uint8* Payload() { return reinterpret_cast<uint8*>(this + 1); }
+};
+
+namespace
+{
+// The largest frame pool size class, minus its header
+constexpr size_t BlockSize = 4096 - 16;
+
+size_t AlignUp(size_t Value, size_t Alignment)
+{
+	return (Value + Alignment - 1) & ~(Alignment - 1);
+}
+}
+
+FCoroutineArena& FCoroutineArena::Current()
+{
+	return FPromise::Current().GetArena();
+}
+
+void* FCoroutineArena::Allocate(size_t Size, size_t Alignment)
+{
+	checkf(FMath::IsPowerOfTwo(Alignment) && Alignment <= alignof(FBlock),
+	       TEXT("Arena alignment %llu is not supported"),
+	       static_cast<uint64>(Alignment));
+	if (LIKELY(Head))
+	{
+		size_t Offset = AlignUp(Head->Used, Alignment);
+		if (Offset + Size <= Head->Capacity)
+		{
+			Head->Used = Offset + Size;
+			return Head->Payload() + Offset;
+		}
+	}
+	return AllocateSlow(Size);
+}
+
+void* FCoroutineArena::AllocateSlow(size_t Size)
+{
+	LLM_SCOPE_BYTAG(UE5Coro_Frames);
+	if (size_t Capacity = AlignUp(Size, alignof(FBlock));
+	    Capacity + sizeof(FBlock) > BlockSize)
+	{
+		// Oversized allocations get a block of their own, which goes behind
+		// the current one to not waste what's left in it
+		auto* Block = static_cast<FBlock*>(
+			FFrameAllocator::Allocate(sizeof(FBlock) + Capacity));
+		Block->Capacity = Block->Used = Capacity;
+		if (Head)
+		{
+			Block->Prev = Head->Prev;
+			Head->Prev = Block;
+		}
+		else
+		{
+			Block->Prev = nullptr;
+			Head = Block;
+		}
+		return Block->Payload();
+	}
+
+	auto* Block = static_cast<FBlock*>(FFrameAllocator::Allocate(BlockSize));
+	Block->Prev = Head;
+	Block->Capacity = BlockSize - sizeof(FBlock);
+	Block->Used = Size;
+	Head = Block;
+	return Block->Payload();
+}
+
+void* FCoroutineArena::Reallocate(void* Ptr, size_t OldSize, size_t NewSize,
+                                  size_t Alignment)
+{
+	if (!Ptr)
+		return Allocate(NewSize, Alignment);
+
+	// Is this the last allocation? It can be resized in place, if it fits
+	auto* Bytes = static_cast<uint8*>(Ptr);
+	if (Head && Bytes + OldSize == Head->Payload() + Head->Used &&
+	    Bytes - Head->Payload() + NewSize <= Head->Capacity)
+	{
+		Head->Used = Bytes - Head->Payload() + NewSize;
+		return Ptr;
+	}
+
+	void* New = Allocate(NewSize, Alignment);
+	FMemory::Memcpy(New, Ptr, FMath::Min(OldSize, NewSize));
+	Free(Ptr, OldSize);
+	return New;
+}
+
+void FCoroutineArena::Free(void* Ptr, size_t Size) noexcept
+{
+	auto* Bytes = static_cast<uint8*>(Ptr);
+	if (Head && Bytes && Bytes + Size == Head->Payload() + Head->Used)
+		Head->Used -= Size;
+}
+
+void FCoroutineArena::Reset() noexcept
+{
+	while (Head)
+		FFrameAllocator::Free(std::exchange(Head, Head->Prev));
+}
+
+FCoroutineArenaAllocator::ForAnyElementType::ForAnyElementType()
+	: Arena(&FCoroutineArena::Current())
+{
+}
+
+FCoroutineArenaAllocator::ForAnyElementType::~ForAnyElementType()
+{
+	Arena->Free(Data, NumBytes);
+}
+
+void FCoroutineArenaAllocator::ForAnyElementType::MoveToEmpty(
+	ForAnyElementType& Other)
+{
+	checkf(this != &Other, TEXT("Internal error: moving into itself"));
+	checkf(Arena == Other.Arena,
+	       TEXT("Arena containers may not be moved between coroutines"));
+	Arena->Free(Data, NumBytes);
+	Data = std::exchange(Other.Data, nullptr);
+	NumBytes = std::exchange(Other.NumBytes, 0);
+}
+
+void FCoroutineArenaAllocator::ForAnyElementType::ResizeAllocation(
+	SizeType, SizeType NewMax, SIZE_T NumBytesPerElement)
+{
+	SIZE_T NewBytes = static_cast<SIZE_T>(NewMax) * NumBytesPerElement;
+	if (NewBytes == 0)
+	{
+		Arena->Free(Data, NumBytes);
+		Data = nullptr;
+	}
+	else
+		Data = static_cast<FScriptContainerElement*>(
+			Arena->Reallocate(Data, NumBytes, NewBytes));
+	NumBytes = NewBytes;
+}
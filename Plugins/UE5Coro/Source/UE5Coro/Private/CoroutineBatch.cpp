@@ -0,0 +1,241 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "UE5Coro/CoroutineBatch.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Private;
+
+namespace
+{
+/** Moves the awaiters whose keys are <= Now to Ready, keeping the rest in
+ *  their original order. This is a single linear pass over the keys. */
+template<typename T, typename A>
+void Sweep(TArray<T>& Keys, TArray<A*>& Awaiters, T Now,
+           TArray<FBatchAwaiter*>& Ready)
+{
+	int32 Num = Keys.Num();
+	T* KeyData = Keys.GetData();
+	A** AwaiterData = Awaiters.GetData();
+	int32 Kept = 0;
+	for (int32 i = 0; i < Num; ++i)
+	{
+		if (KeyData[i] <= Now)
+			Ready.Add(AwaiterData[i]);
+		else
+		{
+			KeyData[Kept] = KeyData[i];
+			AwaiterData[Kept++] = AwaiterData[i];
+		}
+	}
+#if ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION < 4
+	Keys.SetNum(Kept, false);
+	Awaiters.SetNum(Kept, false);
+#else
+	Keys.SetNum(Kept, EAllowShrinking::No);
+	Awaiters.SetNum(Kept, EAllowShrinking::No);
+#endif
+}
+
+template<typename A>
+bool RemoveAwaiter(TArray<A*>& Awaiters, FBatchAwaiter& Awaiter, int32& Index)
+{
+	Index = Awaiters.IndexOfByKey(&Awaiter);
+	if (Index == INDEX_NONE)
+		return false;
+	Awaiters.RemoveAt(Index);
+	return true;
+}
+}
+
+FCoroutineBatch::~FCoroutineBatch()
+{
+	TArray<FBatchAwaiter*> Remaining;
+	{
+		std::scoped_lock _(Lock);
+		Remaining = std::move(Canceled);
+		Remaining.Append(FrameAwaiters);
+		Remaining.Append(DeadlineAwaiters);
+		Remaining.Append(UntilAwaiters);
+		FrameTargets.Empty();
+		FrameAwaiters.Empty();
+		Deadlines.Empty();
+		DeadlineAwaiters.Empty();
+		UntilAwaiters.Empty();
+	}
+	// Nothing else can find these awaiters anymore, their hooks are harmless
+	for (auto* Awaiter : Remaining)
+		Awaiter->Promise->Cancel();
+	for (auto* Awaiter : Remaining)
+		Awaiter->ResumeFromBatch();
+}
+
+void FCoroutineBatch::Tick(double DeltaSeconds)
+{
+	checkf(Ready.IsEmpty(), TEXT("FCoroutineBatch::Tick is not reentrant"));
+	{
+		std::scoped_lock _(Lock);
+		++FrameCounter;
+		Time += DeltaSeconds;
+		Ready.Append(Canceled);
+		Canceled.Reset();
+		Sweep(FrameTargets, FrameAwaiters, FrameCounter, Ready);
+		Sweep(Deadlines, DeadlineAwaiters, Time, Ready);
+
+		int32 Kept = 0;
+		for (int32 i = 0; i < UntilAwaiters.Num(); ++i)
+		{
+			auto* Awaiter = UntilAwaiters[i];
+			if (Awaiter->Predicate())
+				Ready.Add(Awaiter);
+			else
+				UntilAwaiters[Kept++] = Awaiter;
+		}
+#if ENGINE_MAJOR_VERSION == 5 && ENGINE_MINOR_VERSION < 4
+		UntilAwaiters.SetNum(Kept, false);
+#else
+		UntilAwaiters.SetNum(Kept, EAllowShrinking::No);
+#endif
+	}
+
+	// Resumed coroutines may await this batch again, which needs the lock
+	for (auto* Awaiter : Ready)
+		Awaiter->ResumeFromBatch();
+	Ready.Reset();
+}
+
+int32 FCoroutineBatch::GetNumWaiting() const
+{
+	std::scoped_lock _(Lock);
+	return FrameAwaiters.Num() + DeadlineAwaiters.Num() + UntilAwaiters.Num() +
+	       Canceled.Num();
+}
+
+int64 FCoroutineBatch::GetFrameCounter() const
+{
+	std::scoped_lock _(Lock);
+	return FrameCounter;
+}
+
+double FCoroutineBatch::GetTime() const
+{
+	std::scoped_lock _(Lock);
+	return Time;
+}
+
+FBatchFramesAwaiter FCoroutineBatch::Frames(int32 Num)
+{
+	return FBatchFramesAwaiter(*this, Num);
+}
+
+FBatchSecondsAwaiter FCoroutineBatch::Seconds(double Seconds)
+{
+	return FBatchSecondsAwaiter(*this, Seconds);
+}
+
+FBatchUntilAwaiter FCoroutineBatch::Until(std::function<bool()> Predicate)
+{
+	checkf(Predicate, TEXT("Waiting on empty predicate"));
+	return FBatchUntilAwaiter(*this, std::move(Predicate));
+}
+
+void FCoroutineBatch::Remove(FBatchAwaiter& Awaiter)
+{
+	checkf(!Lock.try_lock(), TEXT("Internal error: lock not held"));
+	// Cancellations are rare enough for a linear search
+	int32 Index;
+	if (RemoveAwaiter(FrameAwaiters, Awaiter, Index))
+		FrameTargets.RemoveAt(Index);
+	else if (RemoveAwaiter(DeadlineAwaiters, Awaiter, Index))
+		Deadlines.RemoveAt(Index);
+	else if (!RemoveAwaiter(UntilAwaiters, Awaiter, Index))
+		return; // Already on its way out in Tick
+	Canceled.Add(&Awaiter);
+}
+
+void FBatchAwaiter::Suspend(FPromise& InPromise)
+{
+	checkf(!Promise, TEXT("Attempted second concurrent co_await"));
+	Promise = &InPromise;
+	if (!InPromise.AddCancellationHook(*this))
+	{
+		InPromise.Resume(); // Already canceled, process that right away
+		return;
+	}
+
+	{
+		std::scoped_lock _(Batch.Lock);
+		// The hook might have been called before this could be added
+		if (!bCanceledEarly)
+		{
+			Add();
+			bAdded = true;
+			return; // Tick may resume the coroutine as soon as this unlocks
+		}
+	}
+	InPromise.Resume();
+}
+
+void FBatchAwaiter::OnCanceled(FCancellationHook& Hook)
+{
+	auto& This = static_cast<FBatchAwaiter&>(Hook);
+	// Hooks may not resume directly, the next Tick picks this up
+	std::scoped_lock _(This.Batch.Lock);
+	if (This.bAdded)
+		This.Batch.Remove(This);
+	else
+		This.bCanceledEarly = true;
+}
+
+void FBatchAwaiter::ResumeFromBatch()
+{
+	Promise->RemoveCancellationHook(*this);
+	Promise->Resume();
+}
+
+void FBatchFramesAwaiter::Add()
+{
+	Batch.FrameTargets.Add(Batch.FrameCounter + FMath::Max(Num, 1));
+	Batch.FrameAwaiters.Add(this);
+}
+
+void FBatchSecondsAwaiter::Add()
+{
+	// Even 0 is only checked by the next Tick
+	Batch.Deadlines.Add(Batch.Time + FMath::Max(Seconds, 0.0));
+	Batch.DeadlineAwaiters.Add(this);
+}
+
+void FBatchUntilAwaiter::Add()
+{
+	Batch.UntilAwaiters.Add(this);
+}
@@ -0,0 +1,193 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "UE5Coro/CoroutineScope.h"
+#include "CoroutineScopeState.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Private;
+
+void FCoroutineScopeState::Release()
+{
+	int Remaining = --References;
+	checkf(Remaining >= 0, TEXT("Internal error: scope over-released"));
+	if (Remaining == 0)
+		delete this;
+}
+
+void FCoroutineScopeState::Add(const TCoroutine<>& Coroutine)
+{
+	auto& Extras = *Coroutine.Extras;
+	std::scoped_lock _(Extras.Lock);
+	if (Extras.IsComplete())
+		return;
+
+	auto& Promise = *Extras.Promise;
+	if (Promise.ScopeNode.Scope == this)
+		return;
+	checkf(!Promise.ScopeNode.Scope,
+	       TEXT("A coroutine may only be in one scope"));
+	AddRef();
+	{
+		std::scoped_lock _2(Lock);
+		Promise.ScopeNode.Scope = this;
+		Promise.ScopeNode.Prev = nullptr;
+		Promise.ScopeNode.Next = Head;
+		if (Head)
+			Head->ScopeNode.Prev = &Promise;
+		Head = &Promise;
+		++Live;
+	}
+	Promise.CancellationTracker.SetScopeFlag(&bCanceled);
+	Promise.NotifyCanceled(); // Only does something if the scope is canceled
+}
+
+void FCoroutineScopeState::CancelAll()
+{
+	if (bCanceled.exchange(true))
+		return;
+
+	// The flag alone cancels every coroutine at its next co_await, but ones
+	// that are waiting on something cancelable should be woken up now
+	TArray<std::shared_ptr<FPromiseExtras>> Children;
+	{
+		std::scoped_lock _(Lock);
+		Children.Reserve(Live);
+		for (auto* Promise = Head; Promise; Promise = Promise->ScopeNode.Next)
+			Children.Add(Promise->Extras);
+	}
+	for (auto& Extras : Children)
+	{
+		std::scoped_lock _(Extras->Lock);
+		// Promise is only active in the union before completion
+		if (!Extras->IsComplete())
+			Extras->Promise->NotifyCanceled();
+	}
+}
+
+bool FCoroutineScopeState::TryJoin(FPromise& Promise)
+{
+	std::scoped_lock _(Lock);
+	if (Live == 0)
+		return false;
+	Joiners.Add(&Promise);
+	return true;
+}
+
+void FCoroutineScopeState::Remove(FPromise& Promise)
+{
+	auto* Scope = std::exchange(Promise.ScopeNode.Scope, nullptr);
+	checkf(Scope, TEXT("Internal error: removing promise without a scope"));
+	Promise.CancellationTracker.SetScopeFlag(nullptr);
+
+	TArray<FPromise*> Ready;
+	{
+		std::scoped_lock _(Scope->Lock);
+		auto& Node = Promise.ScopeNode;
+		if (Node.Prev)
+			Node.Prev->ScopeNode.Next = Node.Next;
+		else
+			Scope->Head = Node.Next;
+		if (Node.Next)
+			Node.Next->ScopeNode.Prev = Node.Prev;
+		Node.Prev = Node.Next = nullptr;
+		if (--Scope->Live == 0)
+			Ready = std::move(Scope->Joiners);
+	}
+
+	for (auto* Joiner : Ready)
+		Joiner->Resume();
+	Scope->Release();
+}
+
+FCoroutineScope::FCoroutineScope()
+	: State(new FCoroutineScopeState)
+{
+}
+
+FCoroutineScope::~FCoroutineScope()
+{
+	State->CancelAll();
+	State->Release();
+}
+
+void FCoroutineScope::Add(const TCoroutine<>& Coroutine)
+{
+	State->Add(Coroutine);
+}
+
+void FCoroutineScope::CancelAll()
+{
+	State->CancelAll();
+}
+
+bool FCoroutineScope::IsCanceled() const
+{
+	return State->IsCanceled();
+}
+
+int32 FCoroutineScope::Num() const
+{
+	return State->Num();
+}
+
+FScopeJoinAwaiter FCoroutineScope::Join()
+{
+	return FScopeJoinAwaiter(State);
+}
+
+FScopeJoinAwaiter::FScopeJoinAwaiter(FCoroutineScopeState* State)
+	: State(State)
+{
+	State->AddRef();
+}
+
+FScopeJoinAwaiter::FScopeJoinAwaiter(const FScopeJoinAwaiter& Other)
+	: State(Other.State)
+{
+	State->AddRef();
+}
+
+FScopeJoinAwaiter::~FScopeJoinAwaiter()
+{
+	State->Release();
+}
+
+bool FScopeJoinAwaiter::await_ready()
+{
+	return State->Num() == 0;
+}
+
+void FScopeJoinAwaiter::Suspend(FPromise& Promise)
+{
+	if (!State->TryJoin(Promise))
+		Promise.Resume(); // Emptied in the meantime
+}
@@ -0,0 +1,66 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UE5Coro/Definitions.h"
+#include "UE5Coro/AsyncCoroutine.h"
+
+namespace UE5Coro::Private
+{
+/** Shared between FCoroutineScope, its coroutines, and its join awaiters.
+ *  Every one of these holds a reference. */
+class FCoroutineScopeState final
+{
+	std::atomic<int> References = 1;
+	std::atomic<bool> bCanceled = false;
+	std::atomic<int32> Live = 0;
+	FMutex Lock;
+	FPromise* Head = nullptr;
+	TArray<FPromise*> Joiners;
+	// end Lock
+
+public:
+	void AddRef() { verify(++References > 1); }
+	void Release();
+
+	void Add(const TCoroutine<>& Coroutine);
+	void CancelAll();
+	bool IsCanceled() const { return bCanceled; }
+	int32 Num() const { return Live; }
+	/** @return false if the scope is empty, Promise will not be resumed. */
+	bool TryJoin(FPromise& Promise);
+
+	/** Called by a promise that's in a scope, after it has completed. */
+	static void Remove(FPromise& Promise);
+};
+}
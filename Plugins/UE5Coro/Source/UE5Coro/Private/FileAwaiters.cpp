@@ -0,0 +1,439 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "UE5Coro/FileAwaiters.h"
+#include "GameThreadInbox.h"
+#include "Async/Async.h"
+#include "HAL/PlatformFileManager.h"
+#include "UE5Coro/AsyncAwaiters.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Private;
+
+namespace UE5Coro::Private
+{
+/** Shared by every read of the same file. The handle is destroyed after the
+ *  last read using it, which is required by IAsyncReadFileHandle. */
+struct FAsyncReadFile
+{
+	const TUniquePtr<IAsyncReadFileHandle> Handle;
+	std::atomic<int64> Size = -1; // Cached once known
+
+	explicit FAsyncReadFile(const FString& Path)
+		: Handle(FPlatformFileManager::Get().GetPlatformFile()
+		                                    .OpenAsyncRead(*Path)) { }
+};
+
+struct FReadFileAwaiter::FState
+{
+	const TSharedRef<FAsyncReadFile> File;
+	const int64 Offset;
+	const int64 Size;
+	const EAsyncIOPriorityAndFlags Priority;
+	// These are referenced by the requests, and need to outlive them
+	FAsyncFileCallBack SizeCallback;
+	FAsyncFileCallBack ReadCallback;
+	IAsyncReadRequest* SizeRequest = nullptr;
+	IAsyncReadRequest* ReadRequest = nullptr;
+	TArray64<uint8> Buffer; // Written by the platform directly
+	FMutex Lock;
+	FPromise* Promise = nullptr;
+	ENamedThreads::Type Thread = ENamedThreads::AnyThread;
+	bool bSuspended = false;
+	bool bDone = false;
+	bool bSucceeded = false;
+	bool bAbandoned = false;
+	// end Lock
+
+	explicit FState(TSharedRef<FAsyncReadFile>&& File, int64 Offset,
+	                int64 Size, EAsyncIOPriorityAndFlags Priority)
+		: File(std::move(File)), Offset(Offset), Size(Size)
+		, Priority(Priority) { }
+	~FState();
+
+	void Start();
+	void Read(int64 FileSize);
+	void Finish(bool bSuccess);
+};
+
+struct FMapFileState
+{
+	const FString Path;
+	const int64 Offset;
+	const int64 Size;
+	const bool bPrefault;
+	FMutex Lock;
+	FPromise* Promise = nullptr;
+	ENamedThreads::Type Thread = ENamedThreads::AnyThread;
+	bool bSuspended = false;
+	bool bDone = false;
+	// end Lock
+	Async::FMappedFileRegion Result;
+
+	explicit FMapFileState(FString&& Path, int64 Offset, int64 Size,
+	                       bool bPrefault)
+		: Path(std::move(Path)), Offset(Offset), Size(Size)
+		, bPrefault(bPrefault) { }
+
+	void Map();
+};
+}
+
+namespace
+{
+void DeleteRequest(IAsyncReadRequest* Request)
+{
+	if (!Request)
+		return;
+	Request->Cancel(); // No-op if it's already complete
+	Request->WaitCompletion();
+	delete Request;
+}
+
+void ResumeOn(ENamedThreads::Type Thread, FPromise* Promise)
+{
+	// Fast path if the target thread is the current thread
+	auto ThisThread = FTaskGraphInterface::Get().GetCurrentThreadIfKnown();
+	if ((Thread & ThreadTypeMask) == (ThisThread & ThreadTypeMask))
+		Promise->Resume();
+	else
+	{
+		Promise->MarkAwaitReady();
+		Thread = Promise->WithTaskPriority(Thread);
+		if (!FGameThreadInbox::TryPush(Thread, *Promise))
+			AsyncTask(Thread, [Promise] { Promise->Resume(); });
+	}
+}
+
+TCoroutine<> ReadChunks(TAsyncGeneratorSink<TArray64<uint8>> Sink,
+                        TSharedRef<FAsyncReadFile> File, int64 ChunkSize,
+                        int32 ReadAhead, EAsyncIOPriorityAndFlags Priority)
+{
+	TArray<FReadFileAwaiter> InFlight;
+	int64 Offset = 0;
+	for (;;)
+	{
+		while (InFlight.Num() < ReadAhead)
+		{
+			// The file size is not known until the first read gets that far
+			if (auto Size = File->Size.load(); Size >= 0 && Offset >= Size)
+				break;
+			InFlight.Emplace(File, Offset, ChunkSize, Priority);
+			Offset += ChunkSize;
+		}
+		if (InFlight.IsEmpty())
+			co_return;
+
+		auto Chunk = co_await InFlight[0];
+		InFlight.RemoveAt(0);
+		if (!Chunk || Chunk->IsEmpty()) // Failed, or past the end of the file
+			co_return;
+		bool bLast = Chunk->Num() < ChunkSize;
+		co_await Sink.Yield(std::move(*Chunk));
+		if (bLast)
+			co_return;
+	}
+}
+}
+
+FReadFileAwaiter Async::ReadFileAsync(FString Path, int64 Offset, int64 Size,
+                                      EAsyncIOPriorityAndFlags Priority)
+{
+	return FReadFileAwaiter(MakeShared<FAsyncReadFile>(Path), Offset, Size,
+	                        Priority);
+}
+
+TAsyncGenerator<TArray64<uint8>> Async::ReadFileChunks(
+	FString Path, int64 ChunkSize, int32 ReadAhead,
+	EAsyncIOPriorityAndFlags Priority)
+{
+	checkf(ChunkSize > 0, TEXT("Chunk size must be positive"));
+	return TAsyncGenerator<TArray64<uint8>>(
+		[&](TAsyncGeneratorSink<TArray64<uint8>> Sink)
+		{
+			return ReadChunks(std::move(Sink),
+			                  MakeShared<FAsyncReadFile>(Path), ChunkSize,
+			                  FMath::Max(1, ReadAhead), Priority);
+		});
+}
+
+FMapFileAwaiter Async::MapFileAsync(FString Path, int64 Offset, int64 Size,
+                                    bool bPrefault)
+{
+	return FMapFileAwaiter(std::move(Path), Offset, Size, bPrefault);
+}
+
+Async::FMappedFileRegion::FMappedFileRegion(
+	TUniquePtr<IMappedFileHandle> Handle, TUniquePtr<IMappedFileRegion> Region)
+	: Handle(std::move(Handle)), Region(std::move(Region))
+{
+}
+
+Async::FMappedFileRegion& Async::FMappedFileRegion::operator=(
+	FMappedFileRegion&& Other)
+{
+	if (this != &Other)
+	{
+		Reset();
+		Handle = std::move(Other.Handle);
+		Region = std::move(Other.Region);
+	}
+	return *this;
+}
+
+Async::FMappedFileRegion::~FMappedFileRegion()
+{
+	Reset();
+}
+
+void Async::FMappedFileRegion::Reset()
+{
+	// Regions have to be deleted before the handle they were mapped from
+	Region.Reset();
+	Handle.Reset();
+}
+
+TArrayView64<const uint8> Async::FMappedFileRegion::GetView() const
+{
+	if (!Region)
+		return {};
+	return {Region->GetMappedPtr(), Region->GetMappedSize()};
+}
+
+FMapFileAwaiter::FMapFileAwaiter(FString&& Path, int64 Offset, int64 Size,
+                                 bool bPrefault)
+{
+	checkf(Offset >= 0, TEXT("Attempting to map at a negative offset"));
+	{
+		LLM_SCOPE_BYTAG(UE5Coro_AwaiterState);
+		State = MakeShared<FMapFileState>(std::move(Path), Offset, Size,
+		                                  bPrefault);
+	}
+	// Opening and mapping might block on the disk, too
+	AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask,
+	          [State = State] { State->Map(); });
+}
+
+void FMapFileState::Map()
+{
+	TUniquePtr<IMappedFileHandle> Handle(
+		FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*Path));
+	int64 Available = 0;
+	if (Handle)
+		Available = FMath::Max<int64>(Handle->GetFileSize() - Offset, 0);
+	int64 Bytes = Size < 0 ? Available : FMath::Min(Size, Available);
+	if (Bytes > 0)
+	{
+		TUniquePtr<IMappedFileRegion> Region(Handle->MapRegion(Offset, Bytes));
+		if (Region)
+		{
+			if (bPrefault)
+			{
+				// Touch every page so that the OS maps them in now
+				const volatile uint8* Data = Region->GetMappedPtr();
+				int64 Num = Region->GetMappedSize();
+				int64 PageSize = FPlatformMemory::GetConstants().PageSize;
+				for (int64 i = 0; i < Num; i += PageSize)
+					(void)Data[i];
+			}
+			Result = Async::FMappedFileRegion(std::move(Handle),
+			                                  std::move(Region));
+		}
+	}
+
+	std::unique_lock _(Lock);
+	bDone = true;
+	if (bSuspended)
+	{
+		_.unlock();
+		ResumeOn(Thread, Promise);
+	}
+}
+
+bool FMapFileAwaiter::await_ready()
+{
+	std::unique_lock _(State->Lock);
+
+	// Skip suspension if the mapping finished first
+	if (State->bDone)
+		return true;
+
+	_.release(); // Carry the lock into Suspend()
+	checkf(!State->bSuspended, TEXT("Attempted second concurrent co_await"));
+	State->bSuspended = true;
+	return false;
+}
+
+void FMapFileAwaiter::Suspend(FPromise& Promise)
+{
+	// This should be locked from await_ready
+	checkf(!State->Lock.try_lock(), TEXT("Internal error: lock wasn't taken"));
+	State->Promise = &Promise;
+	State->Thread = FTaskGraphInterface::Get().GetCurrentThreadIfKnown();
+	State->Lock.unlock();
+}
+
+Async::FMappedFileRegion FMapFileAwaiter::await_resume()
+{
+	return std::move(State->Result);
+}
+
+FReadFileAwaiter::FReadFileAwaiter(TSharedRef<FAsyncReadFile> File,
+                                   int64 Offset, int64 Size,
+                                   EAsyncIOPriorityAndFlags Priority)
+{
+	checkf(Offset >= 0, TEXT("Attempting to read at a negative offset"));
+	{
+		LLM_SCOPE_BYTAG(UE5Coro_AwaiterState);
+		State = MakeUnique<FState>(std::move(File), Offset, Size, Priority);
+	}
+	State->Start();
+}
+
+FReadFileAwaiter::FReadFileAwaiter(FReadFileAwaiter&&) noexcept = default;
+
+FReadFileAwaiter::~FReadFileAwaiter() = default;
+
+FReadFileAwaiter::FState::~FState()
+{
+	{
+		std::scoped_lock _(Lock);
+		bAbandoned = true; // Prevents the size callback from starting a read
+	}
+	// With the size request gone, ReadRequest cannot change anymore
+	DeleteRequest(SizeRequest);
+	DeleteRequest(ReadRequest);
+}
+
+void FReadFileAwaiter::FState::Start()
+{
+	if (!File->Handle)
+	{
+		Finish(false);
+		return;
+	}
+
+	if (auto FileSize = File->Size.load(); FileSize >= 0)
+	{
+		Read(FileSize);
+		return;
+	}
+
+	SizeCallback = [this](bool bWasCanceled, IAsyncReadRequest* Request)
+	{
+		auto FileSize = bWasCanceled ? -1 : Request->GetSizeResults();
+		if (FileSize >= 0)
+			File->Size = FileSize;
+		{
+			std::scoped_lock _(Lock);
+			if (bAbandoned)
+				return;
+		}
+		Read(FileSize);
+	};
+	SizeRequest = File->Handle->SizeRequest(&SizeCallback);
+}
+
+void FReadFileAwaiter::FState::Read(int64 FileSize)
+{
+	if (FileSize < 0)
+	{
+		Finish(false);
+		return;
+	}
+
+	int64 Available = FMath::Max<int64>(FileSize - Offset, 0);
+	int64 Bytes = Size < 0 ? Available : FMath::Min(Size, Available);
+	if (Bytes == 0)
+	{
+		Finish(true);
+		return;
+	}
+
+	Buffer.SetNumUninitialized(Bytes);
+	ReadCallback = [this](bool bWasCanceled, IAsyncReadRequest* Request)
+	{
+		// With user-supplied memory, this returns Buffer without a copy
+		Finish(!bWasCanceled && Request->GetReadResults());
+	};
+	ReadRequest = File->Handle->ReadRequest(Offset, Bytes, Priority,
+	                                        &ReadCallback, Buffer.GetData());
+}
+
+void FReadFileAwaiter::FState::Finish(bool bSuccess)
+{
+	std::unique_lock _(Lock);
+	bDone = true;
+	bSucceeded = bSuccess;
+	if (!bSuspended)
+		return;
+	_.unlock();
+
+	// Never resume inline: the request's callback needs to return before the
+	// awaiter is allowed to delete it
+	Promise->MarkAwaitReady();
+	auto ResumeThread = Promise->WithTaskPriority(Thread);
+	if (!FGameThreadInbox::TryPush(ResumeThread, *Promise))
+		AsyncTask(ResumeThread,
+		          [Promise2 = Promise] { Promise2->Resume(); });
+}
+
+bool FReadFileAwaiter::await_ready()
+{
+	checkf(State, TEXT("Attempting to await a moved-from object"));
+	std::unique_lock _(State->Lock);
+
+	// Skip suspension if the read finished first
+	if (State->bDone)
+		return true;
+
+	_.release(); // Carry the lock into Suspend()
+	checkf(!State->bSuspended, TEXT("Attempted second concurrent co_await"));
+	State->bSuspended = true;
+	return false;
+}
+
+void FReadFileAwaiter::Suspend(FPromise& Promise)
+{
+	// This should be locked from await_ready
+	checkf(!State->Lock.try_lock(), TEXT("Internal error: lock wasn't taken"));
+	State->Promise = &Promise;
+	State->Thread = FTaskGraphInterface::Get().GetCurrentThreadIfKnown();
+	State->Lock.unlock();
+}
+
+TOptional<TArray64<uint8>> FReadFileAwaiter::await_resume()
+{
+	// This is either after a resume, or after await_ready took the lock
+	if (!State->bSucceeded)
+		return {};
+	return std::move(State->Buffer);
+}
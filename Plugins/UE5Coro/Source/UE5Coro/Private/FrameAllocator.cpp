@@ -0,0 +1,432 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "UE5Coro/FrameAllocator.h"
+#include <atomic>
+#include "UE5Coro/Private.h"
+#include "Census.h"
+
+using namespace UE5Coro::Private;
+
+LLM_DEFINE_TAG(UE5Coro);
+LLM_DEFINE_TAG(UE5Coro_Frames);
+LLM_DEFINE_TAG(UE5Coro_Extras);
+LLM_DEFINE_TAG(UE5Coro_LatentActions);
+LLM_DEFINE_TAG(UE5Coro_AwaiterState);
+
+#if UE5CORO_FRAME_POOL
+namespace
+{
+struct FThreadCache;
+
+// Every frame is prefixed by this, which also keeps the default alignment
+struct alignas(16) FHeader
+{
+	FThreadCache* Owner; // nullptr for frames that are too large to be pooled
+	int32 Class;
+	uint32 Size; // Including the header
+};
+static_assert(sizeof(FHeader) % alignof(std::max_align_t) == 0);
+
+// Sizes include FHeader. Classes are denser where most frames are.
+constexpr uint32 ClassSizes[] = {64, 128, 192, 256, 384, 512, 768, 1024,
+                                 1536, 2048, 3072, 4096};
+constexpr int32 NumClasses = UE_ARRAY_COUNT(ClassSizes);
+// Per size class, per thread. Frames above this go back to FMemory.
+constexpr int32 MaxCachedFrames = 128;
+
+std::atomic<int64> GBytesReserved = 0;
+std::atomic<int64> GPeakBytesReserved = 0;
+
+// Free frames are linked through their first payload bytes
+FHeader*& NextOf(FHeader* Header)
+{
+	return *reinterpret_cast<FHeader**>(Header + 1);
+}
+
+int32 ClassFor(size_t TotalSize)
+{
+	for (int32 i = 0; i < NumClasses; ++i)
+		if (TotalSize <= ClassSizes[i])
+			return i;
+	return INDEX_NONE;
+}
+
+struct FRegistry
+{
+	FMutex Lock;
+	TArray<FThreadCache*> Caches;
+	// Statistics of caches whose threads have exited
+	uint64 RetiredAllocations = 0;
+	uint64 RetiredPoolHits = 0;
+
+	static FRegistry& Get()
+	{
+		// Leaked on purpose: threads might exit after static destruction
+		static FRegistry* Registry = new FRegistry;
+		return *Registry;
+	}
+};
+
+struct FThreadCache
+{
+	FHeader* FreeLists[NumClasses] = {};
+	int32 FreeCounts[NumClasses] = {};
+
+	// Frames that were freed by other threads, waiting to be reclaimed
+	std::atomic<FHeader*> Remote = nullptr;
+	// One for the owning thread, one for every frame allocated from this cache
+	// that's not returned to FMemory yet, one per remote free in progress
+	std::atomic<int64> Refs = 1;
+	std::atomic<bool> bAlive = true;
+
+	// Only written by the owning thread
+	std::atomic<uint64> Allocations = 0;
+	std::atomic<uint64> PoolHits = 0;
+
+	void AddRef() { ++Refs; }
+	void Release()
+	{
+		if (--Refs == 0)
+			delete this;
+	}
+
+	FHeader* Pop(int32 Class);
+	void Push(FHeader*);
+	void PushRemote(FHeader*);
+	void ReclaimRemote();
+	void Trim();
+	void Retire();
+};
+
+thread_local FThreadCache* GThreadCache = nullptr;
+thread_local bool GThreadCacheRetired = false;
+
+struct FThreadCacheRetirer
+{
+	~FThreadCacheRetirer()
+	{
+		if (GThreadCache)
+			GThreadCache->Retire();
+		GThreadCache = nullptr;
+		GThreadCacheRetired = true;
+	}
+};
+
+FThreadCache* GetThreadCache()
+{
+	if (LIKELY(GThreadCache))
+		return GThreadCache;
+	// Frames allocated during thread teardown bypass the pool
+	if (GThreadCacheRetired)
+		return nullptr;
+
+	thread_local FThreadCacheRetirer Retirer;
+	GThreadCache = new FThreadCache;
+	auto& Registry = FRegistry::Get();
+	std::scoped_lock _(Registry.Lock);
+	Registry.Caches.Add(GThreadCache);
+	return GThreadCache;
+}
+
+FHeader* AllocateFromSystem(FThreadCache* Owner, int32 Class, uint32 Size)
+{
+	LLM_SCOPE_BYTAG(UE5Coro_Frames);
+	auto* Header = static_cast<FHeader*>(FMemory::Malloc(Size, alignof(FHeader)));
+	Header->Owner = Owner;
+	Header->Class = Class;
+	Header->Size = Size;
+	if (Owner)
+		Owner->AddRef();
+
+	int64 Reserved = GBytesReserved += Size;
+	int64 Peak = GPeakBytesReserved.load(std::memory_order_relaxed);
+	while (Reserved > Peak &&
+	       !GPeakBytesReserved.compare_exchange_weak(Peak, Reserved,
+	                                                 std::memory_order_relaxed))
+		;
+	return Header;
+}
+
+void FreeToSystem(FHeader* Header)
+{
+	auto* Owner = Header->Owner;
+	GBytesReserved -= Header->Size;
+	FMemory::Free(Header);
+	if (Owner)
+		Owner->Release();
+}
+
+void FreeList(FHeader* List)
+{
+	while (List)
+	{
+		auto* Next = NextOf(List);
+		FreeToSystem(List);
+		List = Next;
+	}
+}
+
+FHeader* FThreadCache::Pop(int32 Class)
+{
+	if (!FreeLists[Class])
+		ReclaimRemote();
+	auto* Header = FreeLists[Class];
+	if (Header)
+	{
+		FreeLists[Class] = NextOf(Header);
+		--FreeCounts[Class];
+		PoolHits.store(PoolHits.load(std::memory_order_relaxed) + 1,
+		               std::memory_order_relaxed);
+	}
+	return Header;
+}
+
+void FThreadCache::Push(FHeader* Header)
+{
+	int32 Class = Header->Class;
+	if (FreeCounts[Class] >= MaxCachedFrames)
+	{
+		FreeToSystem(Header);
+		return;
+	}
+	NextOf(Header) = FreeLists[Class];
+	FreeLists[Class] = Header;
+	++FreeCounts[Class];
+}
+
+void FThreadCache::PushRemote(FHeader* Header)
+{
+	AddRef(); // Keep this alive even if the frame below gets freed by Retire
+	auto* Head = Remote.load(std::memory_order_relaxed);
+	do
+		NextOf(Header) = Head;
+	while (!Remote.compare_exchange_weak(Head, Header));
+
+	// If the owning thread has already exited, nobody else will reclaim this
+	if (!bAlive)
+		FreeList(Remote.exchange(nullptr));
+	Release();
+}
+
+void FThreadCache::ReclaimRemote()
+{
+	for (auto* List = Remote.exchange(nullptr); List;)
+	{
+		auto* Next = NextOf(List);
+		Push(List);
+		List = Next;
+	}
+}
+
+void FThreadCache::Trim()
+{
+	ReclaimRemote();
+	for (int32 i = 0; i < NumClasses; ++i)
+	{
+		FreeList(FreeLists[i]);
+		FreeLists[i] = nullptr;
+		FreeCounts[i] = 0;
+	}
+}
+
+void FThreadCache::Retire()
+{
+	// Remote frees after this point will clean up after themselves
+	bAlive = false;
+	Trim();
+	FreeList(Remote.exchange(nullptr));
+
+	{
+		auto& Registry = FRegistry::Get();
+		std::scoped_lock _(Registry.Lock);
+		Registry.Caches.RemoveSingleSwap(this);
+		Registry.RetiredAllocations += Allocations;
+		Registry.RetiredPoolHits += PoolHits;
+	}
+	Release(); // Frames still in use elsewhere will keep this alive
+}
+}
+
+void* FFrameAllocator::Allocate(size_t Size)
+{
+	size_t TotalSize = Size + sizeof(FHeader);
+	checkf(TotalSize <= MAX_uint32, TEXT("Coroutine frame too large"));
+	int32 Class = ClassFor(TotalSize);
+	auto* Cache = GetThreadCache();
+	FHeader* Header = nullptr;
+	if (Cache)
+	{
+		Cache->Allocations.store(
+			Cache->Allocations.load(std::memory_order_relaxed) + 1,
+			std::memory_order_relaxed);
+		if (Class != INDEX_NONE)
+			Header = Cache->Pop(Class);
+	}
+	if (!Header)
+	{
+		if (Class == INDEX_NONE || !Cache)
+			Header = AllocateFromSystem(nullptr, INDEX_NONE,
+			                            static_cast<uint32>(TotalSize));
+		else
+			Header = AllocateFromSystem(Cache, Class, ClassSizes[Class]);
+	}
+	return Header + 1;
+}
+
+void FFrameAllocator::Free(void* Ptr) noexcept
+{
+	if (!Ptr)
+		return;
+	auto* Header = static_cast<FHeader*>(Ptr) - 1;
+	if (auto* Owner = Header->Owner; !Owner)
+		FreeToSystem(Header);
+	else if (Owner == GThreadCache)
+		Owner->Push(Header);
+	else
+		Owner->PushRemote(Header);
+}
+
+void FFrameAllocator::Trim()
+{
+	if (GThreadCache)
+		GThreadCache->Trim();
+}
+
+FFrameAllocator::FStats FFrameAllocator::GetStats()
+{
+	FStats Stats;
+	{
+		auto& Registry = FRegistry::Get();
+		std::scoped_lock _(Registry.Lock);
+		Stats.Allocations = Registry.RetiredAllocations;
+		Stats.PoolHits = Registry.RetiredPoolHits;
+		for (auto* Cache : Registry.Caches)
+		{
+			Stats.Allocations += Cache->Allocations;
+			Stats.PoolHits += Cache->PoolHits;
+		}
+	}
+	Stats.BytesReserved = GBytesReserved;
+	Stats.PeakBytesReserved = GPeakBytesReserved;
+	return Stats;
+}
+#else
+void* FFrameAllocator::Allocate(size_t Size)
+{
+	LLM_SCOPE_BYTAG(UE5Coro_Frames);
+	return FMemory::Malloc(Size);
+}
+
+void FFrameAllocator::Free(void* Ptr) noexcept
+{
+	FMemory::Free(Ptr);
+}
+
+void FFrameAllocator::Trim()
+{
+}
+
+FFrameAllocator::FStats FFrameAllocator::GetStats()
+{
+	return {};
+}
+#endif
+
+namespace
+{
+// Frames with larger extras + frames are allocated separately, to avoid
+// keeping a large dead frame around because of an outstanding handle
+constexpr size_t MaxCoAllocation = 4096 - 16;
+}
+
+struct alignas(16) FExtrasCoAllocator::FBlock // Immediately before the frame
+{
+	void* Start;
+	std::atomic<int32> Refs;
+	bool bHasExtras;
+};
+
+void* FExtrasCoAllocator::AllocateFrame(size_t FrameSize, size_t ExtrasSize,
+                                        size_t ExtrasAlignment)
+{
+	if (UNLIKELY(GCensusEnabled))
+		GLastFrameSize = FrameSize;
+	size_t ExtrasSpace = Align(ExtrasSize, alignof(FBlock));
+	bool bCoAllocate = ExtrasAlignment <= alignof(FBlock) &&
+	                   ControlBlockSize + ExtrasSpace + sizeof(FBlock) +
+	                   FrameSize <= MaxCoAllocation;
+	size_t Prefix = sizeof(FBlock);
+	if (bCoAllocate)
+		Prefix += ControlBlockSize + ExtrasSpace;
+
+	auto* Start = static_cast<uint8*>(FFrameAllocator::Allocate(Prefix +
+	                                                           FrameSize));
+	auto* Block = reinterpret_cast<FBlock*>(Start + Prefix) - 1;
+	new (Block) FBlock{Start, 1, bCoAllocate}; // The frame's reference
+	return Start + Prefix;
+}
+
+void FExtrasCoAllocator::FreeFrame(void* Frame) noexcept
+{
+	Release(static_cast<FBlock*>(Frame) - 1);
+}
+
+FExtrasCoAllocator::FBlock* FExtrasCoAllocator::GetBlock(void* Frame)
+{
+	auto* Block = static_cast<FBlock*>(Frame) - 1;
+	return Block->bHasExtras ? Block : nullptr;
+}
+
+void* FExtrasCoAllocator::GetControlBlockStorage(FBlock* Block)
+{
+	return Block->Start;
+}
+
+void* FExtrasCoAllocator::GetExtrasStorage(FBlock* Block)
+{
+	return static_cast<uint8*>(Block->Start) + ControlBlockSize;
+}
+
+void FExtrasCoAllocator::AddRef(FBlock* Block)
+{
+	verify(++Block->Refs > 1);
+}
+
+void FExtrasCoAllocator::Release(FBlock* Block) noexcept
+{
+	if (--Block->Refs == 0)
+	{
+		void* Start = Block->Start;
+		Block->~FBlock();
+		FFrameAllocator::Free(Start);
+	}
+}
@@ -0,0 +1,172 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "FrameWork.h"
+#include "Async/Async.h"
+#include "Containers/Queue.h"
+#include "Engine/World.h"
+#include "UE5Coro/AsyncAwaiters.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Private;
+
+namespace
+{
+struct FFrameWorkState
+{
+	// Coroutines that are waiting for a worker
+	FMutex PopLock; // Serializes consumers of Queue
+	TQueue<FPromise*, EQueueMode::Mpsc> Queue;
+	// Promises with bInFrameWork set
+	std::atomic<int32> NumOutstanding = 0;
+	// Deliberately leaked, the pool might be gone by the time this would be
+	// destroyed at exit
+	FEvent* AllJoined = FPlatformProcess::GetSynchEventFromPool();
+	FMutex JoinedLock;
+	TArray<FPromise*> Joined;
+	std::atomic<bool> bRegistered = false;
+
+	static FFrameWorkState& Get()
+	{
+		static FFrameWorkState State;
+		return State;
+	}
+
+	void EnsureRegistered()
+	{
+		if (bRegistered)
+			return;
+		// Delegates are not thread safe, let the game thread take care of this
+		if (!IsInGameThread())
+		{
+			AsyncTask(ENamedThreads::GameThread,
+			          [this] { EnsureRegistered(); });
+			return;
+		}
+		bRegistered = true;
+		FWorldDelegates::OnWorldPostActorTick.AddLambda(
+			[this](UWorld*, ELevelTick, float) { Join(); });
+	}
+
+	bool RunOne()
+	{
+		FPromise* Promise;
+		{
+			std::scoped_lock _(PopLock);
+			if (!Queue.Dequeue(Promise))
+				return false;
+		}
+		Promise->Resume();
+		return true;
+	}
+
+	void Join()
+	{
+		checkf(IsInGameThread(),
+		       TEXT("Internal error: join off the game thread"));
+		// Help with work that no worker has picked up yet, then wait for the
+		// rest. The timeout covers a Trigger that raced the check.
+		while (NumOutstanding > 0)
+			if (!RunOne())
+				AllJoined->Wait(1);
+
+		TArray<FPromise*> Ready;
+		{
+			std::scoped_lock _(JoinedLock);
+			Ready = std::move(Joined);
+		}
+		// Coroutines joining again from here will wait for the next join
+		for (auto* Promise : Ready)
+			Promise->Resume();
+	}
+};
+}
+
+void FFrameWork::Enter(FPromise& Promise)
+{
+	auto& State = FFrameWorkState::Get();
+	State.EnsureRegistered();
+	if (!Promise.IsInFrameWork())
+	{
+		Promise.SetInFrameWork(true);
+		++State.NumOutstanding;
+	}
+	State.Queue.Enqueue(&Promise);
+	// This might find nothing if the game thread got to it first
+	AsyncTask(Promise.WithTaskPriority(ENamedThreads::AnyHiPriThreadNormalTask),
+	          [&State] { State.RunOne(); });
+}
+
+void FFrameWork::Leave()
+{
+	auto& State = FFrameWorkState::Get();
+	if (--State.NumOutstanding == 0)
+		State.AllJoined->Trigger();
+}
+
+void FFrameWork::AddJoined(FPromise& Promise)
+{
+	auto& State = FFrameWorkState::Get();
+	State.EnsureRegistered();
+	{
+		std::scoped_lock _(State.JoinedLock);
+		State.Joined.Add(&Promise);
+	}
+	// Leave after being added, so that the join can't miss this promise
+	if (Promise.IsInFrameWork())
+	{
+		Promise.SetInFrameWork(false);
+		Leave();
+	}
+}
+
+FFrameWorkerAwaiter Async::MoveToFrameWorker()
+{
+	return {};
+}
+
+FFrameJoinAwaiter Async::JoinAtFrameEnd()
+{
+	return {};
+}
+
+void FFrameWorkerAwaiter::Suspend(FPromise& Promise)
+{
+	checkf(IsInGameThread(),
+	       TEXT("Frame work may only be started from the game thread"));
+	FFrameWork::Enter(Promise);
+}
+
+void FFrameJoinAwaiter::Suspend(FPromise& Promise)
+{
+	FFrameWork::AddJoined(Promise);
+}
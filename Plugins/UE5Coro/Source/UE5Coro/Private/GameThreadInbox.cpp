@@ -0,0 +1,167 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "GameThreadInbox.h"
+#include "ReadyQueue.h"
+#include "UE5Coro/FrameAllocator.h"
+#include "Async/Async.h"
+#include "HAL/IConsoleManager.h"
+
+using namespace UE5Coro::Private;
+
+namespace
+{
+bool GGameThreadInbox = true;
+FAutoConsoleVariableRef CVarGameThreadInbox(
+	TEXT("UE5Coro.GameThreadInbox"), GGameThreadInbox,
+	TEXT("Coalesce coroutines resuming on the game thread from other threads ")
+	TEXT("into one game thread task per batch, instead of one task each."));
+
+std::atomic<FInboxNode*> GInboxHead = nullptr;
+
+/** Continuations, unlike promises, don't have a node of their own. */
+struct FInboxContinuation
+{
+	FInboxNode Node;
+	FContinuation Fn;
+
+	explicit FInboxContinuation(FContinuation Fn) : Fn(std::move(Fn))
+	{
+		Node.Target = this;
+		Node.Run = &Run;
+	}
+
+	static void* operator new(size_t Size)
+	{
+		return FFrameAllocator::Allocate(Size);
+	}
+	static void operator delete(void* Ptr) noexcept
+	{
+		FFrameAllocator::Free(Ptr);
+	}
+
+	static void Run(void* Target)
+	{
+		auto* This = static_cast<FInboxContinuation*>(Target);
+		This->Fn(nullptr);
+		delete This;
+	}
+};
+
+bool IsInboxThread(ENamedThreads::Type Thread)
+{
+	// Thread priority doesn't apply to named threads, but queue and task
+	// priority do; those keep going through the task graph
+	return GGameThreadInbox && (Thread & ~ENamedThreads::ThreadPriorityMask) ==
+	                           ENamedThreads::GameThread;
+}
+}
+
+bool FGameThreadInbox::TryPush(ENamedThreads::Type Thread, FPromise& Promise)
+{
+	auto& Node = Promise.InboxNode;
+	Node.Target = &Promise;
+	Node.Run = [](void* Target) { static_cast<FPromise*>(Target)->Resume(); };
+	return TryPush(Thread, Node);
+}
+
+void FGameThreadInbox::ResumeOn(ENamedThreads::Type Thread, FPromise& Promise)
+{
+	auto ThisThread = FTaskGraphInterface::Get().GetCurrentThreadIfKnown();
+	if ((Thread & ThreadTypeMask) == (ThisThread & ThreadTypeMask))
+		Promise.Resume();
+	else
+	{
+		Promise.MarkAwaitReady();
+		Thread = Promise.WithTaskPriority(Thread);
+		if (!TryPush(Thread, Promise))
+			AsyncTask(Thread, [&Promise] { Promise.Resume(); });
+	}
+}
+
+void FGameThreadInbox::Post(ENamedThreads::Type Thread, FContinuation Fn)
+{
+	if (!IsInboxThread(Thread))
+	{
+		AsyncTask(Thread, [Fn = std::move(Fn)]() mutable { Fn(nullptr); });
+		return;
+	}
+	LLM_SCOPE_BYTAG(UE5Coro_AwaiterState);
+	auto* Node = new FInboxContinuation(std::move(Fn));
+	// The CVar might have changed since the check above
+	if (!TryPush(Thread, Node->Node))
+		AsyncTask(Thread, [Node] { FInboxContinuation::Run(Node); });
+}
+
+bool FGameThreadInbox::TryPush(ENamedThreads::Type Thread, FInboxNode& Node)
+{
+	if (!IsInboxThread(Thread))
+		return false;
+
+	auto* Head = GInboxHead.load(std::memory_order_relaxed);
+	do
+		Node.Next = Head;
+	while (!GInboxHead.compare_exchange_weak(Head, &Node,
+	                                         std::memory_order_release,
+	                                         std::memory_order_relaxed));
+	// Whoever fills an empty inbox schedules the drain, others join the batch
+	if (!Head)
+		AsyncTask(ENamedThreads::GameThread, [] { Drain(); });
+	return true;
+}
+
+void FGameThreadInbox::Drain()
+{
+	checkf(IsInGameThread(), TEXT("Internal error: drain off the game thread"));
+	auto* Node = GInboxHead.exchange(nullptr, std::memory_order_acquire);
+
+	// The inbox is LIFO, restore the order in which work arrived
+	FInboxNode* Ordered = nullptr;
+	while (Node)
+	{
+		auto* Next = Node->Next;
+		Node->Next = Ordered;
+		Ordered = Node;
+		Node = Next;
+	}
+
+	// Anything pushed while these are running goes into the next batch.
+	// Coroutines yielding in this batch are resumed right after it, within
+	// UE5Coro.YieldQuota, the same as in a resume task.
+	FReadyQueueScope _;
+	while (Ordered)
+	{
+		// Running the node might destroy it
+		auto* Next = Ordered->Next;
+		Ordered->Run(Ordered->Target);
+		Ordered = Next;
+	}
+}
@@ -0,0 +1,63 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UE5Coro/Definitions.h"
+#include "UE5Coro/AsyncCoroutine.h"
+
+namespace UE5Coro::Private
+{
+/** Lock-free queue of work going to the game thread.<br>
+ *  Promises to resume and continuations are linked intrusively, and a single
+ *  game thread task runs everything that arrived since the previous one. */
+class FGameThreadInbox
+{
+public:
+	/** Queues Promise to be resumed on the game thread, if Thread refers to
+	 *  the game thread's main queue at normal task priority.<br>
+	 *  Returns false if the caller needs to schedule the resumption itself. */
+	static bool TryPush(ENamedThreads::Type Thread, FPromise& Promise);
+
+	/** Calls Fn(nullptr) on Thread, through the inbox if it supports Thread,
+	 *  otherwise with a task of its own. */
+	static void Post(ENamedThreads::Type Thread, FContinuation Fn);
+
+	/** Resumes Promise right away if this is the same kind of thread as
+	 *  Thread, otherwise sends it there, through the inbox if possible. */
+	static void ResumeOn(ENamedThreads::Type Thread, FPromise& Promise);
+
+private:
+	static bool TryPush(ENamedThreads::Type Thread, FInboxNode& Node);
+	static void Drain();
+};
+}
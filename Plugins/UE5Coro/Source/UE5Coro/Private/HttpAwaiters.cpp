@@ -30,11 +30,75 @@
 // ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "UE5Coro/HttpAwaiters.h"
+#include "GameThreadInbox.h"
+#include "Async/Async.h"
+#include "Containers/Queue.h"
+#include "Dom/JsonObject.h"
+#include "GenericPlatform/GenericPlatformHttp.h"
+#include "JsonObjectConverter.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
 #include "UE5Coro/AsyncAwaiters.h"
 
 using namespace UE5Coro;
 using namespace UE5Coro::Private;
 
+namespace UE5Coro::Private
+{
+struct FResponseStreamState
+{
+	const FHttpRequestRef Request;
+	const int64 MaxBufferedBytes;
+	FEventRef Room; // Triggered when chunks are consumed
+	FMutex Lock;
+	TQueue<TArray<uint8>> Chunks;
+	int64 BufferedBytes = 0;
+	FPromise* Promise = nullptr;
+	ENamedThreads::Type Thread = ENamedThreads::AnyThread;
+	bool bDone = false;
+	bool bClosed = false;
+	FHttpResponsePtr Response;
+	bool bConnectedSuccessfully = false;
+	// end Lock
+
+	explicit FResponseStreamState(FHttpRequestRef&& Request,
+	                              int64 MaxBufferedBytes)
+		: Request(std::move(Request)), MaxBufferedBytes(MaxBufferedBytes) { }
+
+	void Push(TArray<uint8>&&, std::unique_lock<FMutex>&);
+	bool ReceiveStream(void* Ptr, int64 Length);
+	void RequestComplete(FHttpRequestPtr, FHttpResponsePtr, bool);
+};
+
+struct FRequestQueueState : TSharedFromThis<FRequestQueueState>
+{
+	using FAwaiterState = FHttpAwaiter::FState;
+	struct FEntry
+	{
+		TSharedPtr<FAwaiterState> State;
+		FString Host;
+	};
+
+	const int32 MaxInFlight;
+	const int32 MaxPerHost;
+	mutable FMutex Lock;
+	TArray<FEntry> Lanes[static_cast<int>(EQueuedWorkPriority::Count)];
+	TMap<FString, int32> HostInFlight;
+	int32 InFlight = 0;
+	int32 Queued = 0;
+	// end Lock
+
+	explicit FRequestQueueState(int32 MaxInFlight, int32 MaxPerHost)
+		: MaxInFlight(FMath::Max(1, MaxInFlight))
+		, MaxPerHost(FMath::Max(0, MaxPerHost)) { }
+
+	void Enqueue(TSharedPtr<FAwaiterState>, EQueuedWorkPriority);
+	void Pump();
+	void Finished(const FString& Host);
+	void Shutdown();
+};
+}
+
 namespace
 {
 ENamedThreads::Type ThreadForRequest(const FHttpRequestRef& Request)
@@ -46,6 +110,21 @@ ENamedThreads::Type ThreadForRequest(const FHttpRequestRef& Request)
 #endif
 	return FTaskGraphInterface::Get().GetCurrentThreadIfKnown();
 }
+
+void ResumeOn(ENamedThreads::Type Thread, FPromise* Promise)
+{
+	// Fast path if the target thread is the current thread
+	auto ThisThread = FTaskGraphInterface::Get().GetCurrentThreadIfKnown();
+	if ((Thread & ThreadTypeMask) == (ThisThread & ThreadTypeMask))
+		Promise->Resume();
+	else
+	{
+		Promise->MarkAwaitReady();
+		Thread = Promise->WithTaskPriority(Thread);
+		if (!FGameThreadInbox::TryPush(Thread, *Promise))
+			AsyncTask(Thread, [Promise] { Promise->Resume(); });
+	}
+}
 }
 
 FHttpAwaiter Http::ProcessAsync(FHttpRequestRef Request)
@@ -102,7 +181,13 @@ void FHttpAwaiter::FState::Resume()
 	    (Thread & ThreadTypeMask) == (ThisThread & ThreadTypeMask))
 		Promise->Resume();
 	else
-		AsyncTask(Thread, [Promise2 = Promise] { Promise2->Resume(); });
+	{
+		Promise->MarkAwaitReady();
+		auto ResumeThread = Promise->WithTaskPriority(Thread);
+		if (!FGameThreadInbox::TryPush(ResumeThread, *Promise))
+			AsyncTask(ResumeThread,
+			          [Promise2 = Promise] { Promise2->Resume(); });
+	}
 }
 
 void FHttpAwaiter::FState::RequestComplete(FHttpRequestPtr,
@@ -124,3 +209,350 @@ TTuple<FHttpResponsePtr, bool> FHttpAwaiter::await_resume()
 	       TEXT("Internal error: resuming with no value"));
 	return *State->Result;
 }
+
+namespace
+{
+TCoroutine<TArray<TTuple<FHttpResponsePtr, bool>>> AwaitAll(
+	TArray<FHttpAwaiter> Awaiters)
+{
+	TArray<TTuple<FHttpResponsePtr, bool>> Results;
+	Results.Reserve(Awaiters.Num());
+	for (auto& Awaiter : Awaiters)
+		Results.Add(co_await Awaiter);
+	co_return Results;
+}
+}
+
+bool Private::DeserializeJson(TConstArrayView<uint8> Utf8,
+                              const UScriptStruct* Struct, void* Out)
+{
+	auto* Chars = reinterpret_cast<const UTF8CHAR*>(Utf8.GetData());
+#if ENGINE_MINOR_VERSION >= 4
+	// Parse the UTF-8 bytes as they are, without widening them into a FString
+	auto Reader = TJsonReaderFactory<UTF8CHAR>::CreateFromView(
+		FUtf8StringView(Chars, Utf8.Num()));
+#else
+	FUTF8ToTCHAR Converted(reinterpret_cast<const ANSICHAR*>(Chars),
+	                       Utf8.Num());
+	auto Reader = TJsonReaderFactory<>::Create(
+		FString(Converted.Length(), Converted.Get()));
+#endif
+	TSharedPtr<FJsonObject> Object;
+	return FJsonSerializer::Deserialize(Reader, Object) && Object &&
+	       FJsonObjectConverter::JsonObjectToUStruct(Object.ToSharedRef(),
+	                                                 Struct, Out);
+}
+
+TCoroutine<TArray<TTuple<FHttpResponsePtr, bool>>> Http::ProcessAllAsync(
+	TArray<FHttpRequestRef> Requests)
+{
+	// Start every request before the first co_await
+	TArray<FHttpAwaiter> Awaiters;
+	Awaiters.Reserve(Requests.Num());
+	for (auto& Request : Requests)
+		Awaiters.Add(ProcessAsync(std::move(Request)));
+	return AwaitAll(std::move(Awaiters));
+}
+
+FRequestQueue::FRequestQueue(int32 MaxInFlight, int32 MaxPerHost)
+	: State(MakeShared<FRequestQueueState>(MaxInFlight, MaxPerHost))
+{
+}
+
+FRequestQueue::~FRequestQueue()
+{
+	State->Shutdown();
+}
+
+FHttpAwaiter FRequestQueue::Process(FHttpRequestRef Request,
+                                    EQueuedWorkPriority Priority)
+{
+	TSharedPtr<FHttpAwaiter::FState> AwaiterState(
+		new FHttpAwaiter::FState(std::move(Request)));
+	State->Enqueue(AwaiterState, Priority);
+	State->Pump();
+	return FHttpAwaiter(std::move(AwaiterState));
+}
+
+TCoroutine<TArray<TTuple<FHttpResponsePtr, bool>>> FRequestQueue::ProcessAll(
+	TArray<FHttpRequestRef> Requests, EQueuedWorkPriority Priority)
+{
+	// Queue every request before the first co_await, the coroutine does not
+	// need this object after that
+	TArray<FHttpAwaiter> Awaiters;
+	Awaiters.Reserve(Requests.Num());
+	for (auto& Request : Requests)
+		Awaiters.Add(Process(std::move(Request), Priority));
+	return AwaitAll(std::move(Awaiters));
+}
+
+int32 FRequestQueue::NumInFlight() const
+{
+	std::scoped_lock _(State->Lock);
+	return State->InFlight;
+}
+
+int32 FRequestQueue::NumQueued() const
+{
+	std::scoped_lock _(State->Lock);
+	return State->Queued;
+}
+
+void FRequestQueueState::Enqueue(TSharedPtr<FAwaiterState> AwaiterState,
+                                 EQueuedWorkPriority Priority)
+{
+	auto Lane = FMath::Clamp(static_cast<int>(Priority), 0,
+	                         static_cast<int>(EQueuedWorkPriority::Count) - 1);
+	FString Host;
+	if (MaxPerHost > 0)
+		Host = FGenericPlatformHttp::GetUrlDomain(
+			AwaiterState->Request->GetURL());
+
+	std::scoped_lock _(Lock);
+	Lanes[Lane].Add({std::move(AwaiterState), std::move(Host)});
+	++Queued;
+}
+
+void FRequestQueueState::Pump()
+{
+	TArray<FEntry> Start;
+	{
+		std::scoped_lock _(Lock);
+		for (auto& Lane : Lanes)
+			for (int32 i = 0; i < Lane.Num() && InFlight < MaxInFlight;)
+			{
+				int32& Num = HostInFlight.FindOrAdd(Lane[i].Host);
+				if (MaxPerHost > 0 && Num >= MaxPerHost)
+				{
+					++i; // Leave it for later, but look for other hosts
+					continue;
+				}
+				++Num;
+				++InFlight;
+				--Queued;
+				Start.Add(std::move(Lane[i]));
+				Lane.RemoveAt(i);
+			}
+	}
+
+	// ProcessRequest might complete synchronously, call it without the lock
+	for (auto& Entry : Start)
+	{
+		auto& Request = Entry.State->Request;
+		Request->OnProcessRequestComplete().BindLambda(
+			[WeakQueue = TWeakPtr<FRequestQueueState>(AsShared()),
+			 WeakState = TWeakPtr<FAwaiterState>(Entry.State),
+			 Host = std::move(Entry.Host)](FHttpRequestPtr InRequest,
+			                               FHttpResponsePtr Response,
+			                               bool bConnectedSuccessfully)
+		{
+			// Start the next requests before resuming this one
+			if (auto Queue = WeakQueue.Pin())
+				Queue->Finished(Host);
+			if (auto AwaiterState = WeakState.Pin())
+				AwaiterState->RequestComplete(std::move(InRequest),
+				                              std::move(Response),
+				                              bConnectedSuccessfully);
+		});
+		Request->ProcessRequest();
+	}
+}
+
+void FRequestQueueState::Finished(const FString& Host)
+{
+	{
+		std::scoped_lock _(Lock);
+		--InFlight;
+		if (int32* Num = HostInFlight.Find(Host); Num && --*Num <= 0)
+			HostInFlight.Remove(Host);
+	}
+	Pump();
+}
+
+void FRequestQueueState::Shutdown()
+{
+	TArray<FEntry> Rejected;
+	{
+		std::scoped_lock _(Lock);
+		for (auto& Lane : Lanes)
+		{
+			Rejected.Append(std::move(Lane));
+			Lane.Empty();
+		}
+		Queued = 0;
+	}
+	if (Rejected.Num() == 0)
+		return;
+
+	// Match the HTTP module, which calls completion delegates on the game thread
+	auto Reject = [Rejected = std::move(Rejected)]
+	{
+		for (auto& Entry : Rejected)
+			Entry.State->RequestComplete(nullptr, nullptr, false);
+	};
+	if (IsInGameThread())
+		Reject();
+	else
+		AsyncTask(ENamedThreads::GameThread, std::move(Reject));
+}
+
+FResponseStream Http::StreamAsync(FHttpRequestRef Request,
+                                  int64 MaxBufferedBytes)
+{
+	return FResponseStream(std::move(Request), MaxBufferedBytes);
+}
+
+FResponseStream::FResponseStream(FHttpRequestRef Request,
+                                 int64 MaxBufferedBytes)
+	: State(new FResponseStreamState(std::move(Request),
+	                                 FMath::Max<int64>(1, MaxBufferedBytes)))
+{
+	auto StateRef = State.ToSharedRef();
+	auto& Req = State->Request;
+	Req->OnProcessRequestComplete().BindSP(
+		StateRef, &FResponseStreamState::RequestComplete);
+#if ENGINE_MINOR_VERSION >= 3
+	Req->SetResponseBodyReceiveStreamDelegate(
+		FHttpRequestStreamDelegate::CreateSP(
+			StateRef, &FResponseStreamState::ReceiveStream));
+#endif
+	Req->ProcessRequest();
+}
+
+FResponseStream& FResponseStream::operator=(FResponseStream&& Other)
+{
+	if (this != &Other)
+	{
+		Close();
+		State = std::move(Other.State);
+	}
+	return *this;
+}
+
+FResponseStream::~FResponseStream()
+{
+	Close();
+}
+
+void FResponseStream::Close()
+{
+	if (!State) // Moved from
+		return;
+	bool bDone;
+	{
+		std::scoped_lock _(State->Lock);
+		State->bClosed = true;
+		bDone = State->bDone;
+	}
+	State->Room->Trigger(); // Unblock the HTTP thread if it's waiting
+	if (!bDone)
+		State->Request->CancelRequest();
+	State = nullptr;
+}
+
+FResponseStreamAwaiter FResponseStream::Next()
+{
+	checkf(State, TEXT("Attempting to use a moved-from stream"));
+	return FResponseStreamAwaiter(State);
+}
+
+FHttpResponsePtr FResponseStream::GetResponse() const
+{
+	std::scoped_lock _(State->Lock);
+	return State->Response;
+}
+
+bool FResponseStream::WasConnectedSuccessfully() const
+{
+	std::scoped_lock _(State->Lock);
+	return State->bConnectedSuccessfully;
+}
+
+void FResponseStreamState::Push(TArray<uint8>&& Chunk,
+                                std::unique_lock<FMutex>& L)
+{
+	checkf(L.owns_lock(), TEXT("Internal error: lock not held"));
+	BufferedBytes += Chunk.Num();
+	Chunks.Enqueue(std::move(Chunk));
+	auto* Waiting = std::exchange(Promise, nullptr);
+	L.unlock();
+	if (Waiting)
+		ResumeOn(Thread, Waiting);
+}
+
+bool FResponseStreamState::ReceiveStream(void* Ptr, int64 Length)
+{
+	TArray<uint8> Chunk(static_cast<const uint8*>(Ptr),
+	                    static_cast<int32>(Length));
+	std::unique_lock L(Lock);
+	if (bClosed)
+		return false; // Abort the request, nobody will read this
+	Push(std::move(Chunk), L);
+
+	// Backpressure: hold up the HTTP thread until the coroutine catches up
+	for (;;)
+	{
+		L.lock();
+		if (bClosed || BufferedBytes <= MaxBufferedBytes)
+			return !bClosed;
+		L.unlock();
+		Room->Wait();
+	}
+}
+
+void FResponseStreamState::RequestComplete(FHttpRequestPtr,
+                                           FHttpResponsePtr InResponse,
+                                           bool bInConnectedSuccessfully)
+{
+	std::unique_lock L(Lock);
+	Response = std::move(InResponse);
+	bConnectedSuccessfully = bInConnectedSuccessfully;
+#if ENGINE_MINOR_VERSION < 3
+	// No streaming support, provide everything at once
+	if (Response && Response->GetContent().Num() > 0)
+	{
+		BufferedBytes += Response->GetContent().Num();
+		Chunks.Enqueue(Response->GetContent());
+	}
+#endif
+	bDone = true;
+	auto* Waiting = std::exchange(Promise, nullptr);
+	L.unlock();
+	if (Waiting)
+		ResumeOn(Thread, Waiting);
+}
+
+bool FResponseStreamAwaiter::await_ready()
+{
+	std::unique_lock L(State->Lock);
+	if (!State->Chunks.IsEmpty() || State->bDone)
+		return true;
+	checkf(!State->Promise, TEXT("Attempted second concurrent co_await"));
+	L.release(); // Carry the lock into Suspend()
+	return false;
+}
+
+void FResponseStreamAwaiter::Suspend(FPromise& Promise)
+{
+	// This should be locked from await_ready
+	checkf(!State->Lock.try_lock(), TEXT("Internal error: lock wasn't taken"));
+	State->Promise = &Promise;
+	State->Thread = FTaskGraphInterface::Get().GetCurrentThreadIfKnown();
+	State->Lock.unlock();
+}
+
+TOptional<TArray<uint8>> FResponseStreamAwaiter::await_resume()
+{
+	TArray<uint8> Chunk;
+	{
+		std::scoped_lock _(State->Lock);
+		if (!State->Chunks.Dequeue(Chunk))
+		{
+			checkf(State->bDone, TEXT("Internal error: resumed too early"));
+			return {};
+		}
+		State->BufferedBytes -= Chunk.Num();
+	}
+	State->Room->Trigger();
+	return Chunk;
+}
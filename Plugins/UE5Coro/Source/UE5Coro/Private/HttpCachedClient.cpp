@@ -0,0 +1,308 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "UE5Coro/HttpAwaiters.h"
+#include "Async/Async.h"
+#include "Interfaces/IHttpResponse.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Private;
+
+namespace UE5Coro::Private
+{
+struct FCachedClientState : TSharedFromThis<FCachedClientState>
+{
+	using FAwaiterState = FHttpAwaiter::FState;
+	struct FEntry
+	{
+		FString Url;
+		FHttpResponsePtr Response;
+		FString ETag;
+		FString LastModified;
+		double FreshUntil = 0;
+		int64 Bytes = 0;
+		uint64 LastUse = 0;
+	};
+
+	const int64 MaxBytes;
+	mutable FMutex Lock;
+	TMap<FString, FEntry> Entries;
+	/** Awaiters of requests that are being processed, by key. */
+	TMap<FString, TArray<TSharedPtr<FAwaiterState>>> InFlight;
+	int64 CachedBytes = 0;
+	uint64 UseCounter = 0;
+	// end Lock
+
+	explicit FCachedClientState(int64 MaxBytes)
+		: MaxBytes(FMath::Max<int64>(0, MaxBytes)) { }
+
+	void Start(FString Key, TSharedPtr<FAwaiterState>);
+	void Complete(const FString& Key, FHttpResponsePtr, bool);
+	void Store(const FString& Key, const FString& Url, const FHttpResponsePtr&,
+	           std::unique_lock<FMutex>&);
+	void Remove(const FString& Key, std::unique_lock<FMutex>&);
+	static void Resume(const TSharedPtr<FAwaiterState>&, FHttpResponsePtr,
+	                   bool);
+};
+}
+
+namespace
+{
+struct FCacheControl
+{
+	double MaxAge = 0;
+	bool bNoStore = false;
+	bool bNoCache = false;
+};
+
+FCacheControl ParseCacheControl(const FString& Header)
+{
+	FCacheControl Result;
+	TArray<FString> Directives;
+	Header.ParseIntoArray(Directives, TEXT(","));
+	for (auto& Directive : Directives)
+	{
+		Directive.TrimStartAndEndInline();
+		if (Directive.Equals(TEXT("no-store"), ESearchCase::IgnoreCase))
+			Result.bNoStore = true;
+		else if (Directive.Equals(TEXT("no-cache"), ESearchCase::IgnoreCase))
+			Result.bNoCache = true;
+		else if (Directive.StartsWith(TEXT("max-age="),
+		                              ESearchCase::IgnoreCase))
+			Result.MaxAge = FCString::Atod(*Directive + 8);
+	}
+	return Result;
+}
+
+FString MakeKey(const FHttpRequestRef& Request)
+{
+	// Header order doesn't matter for the cache
+	auto Headers = Request->GetAllHeaders();
+	Headers.Sort();
+	FString Key = Request->GetURL();
+	for (auto& Header : Headers)
+	{
+		Key += TEXT('\n');
+		Key += Header;
+	}
+	return Key;
+}
+}
+
+FCachedClient::FCachedClient(int64 MaxBytes)
+	: State(MakeShared<FCachedClientState>(MaxBytes))
+{
+}
+
+FHttpAwaiter FCachedClient::Process(FHttpRequestRef Request)
+{
+	if (auto Verb = Request->GetVerb();
+	    !Verb.IsEmpty() && !Verb.Equals(TEXT("GET"), ESearchCase::IgnoreCase))
+		return Http::ProcessAsync(std::move(Request));
+
+	auto Key = MakeKey(Request);
+	TSharedPtr<FHttpAwaiter::FState> AwaiterState(
+		new FHttpAwaiter::FState(std::move(Request)));
+	State->Start(std::move(Key), AwaiterState);
+	return FHttpAwaiter(std::move(AwaiterState));
+}
+
+void FCachedClient::Invalidate(const FString& Url)
+{
+	std::scoped_lock _(State->Lock);
+	for (auto It = State->Entries.CreateIterator(); It; ++It)
+		if (It->Value.Url == Url)
+		{
+			State->CachedBytes -= It->Value.Bytes;
+			It.RemoveCurrent();
+		}
+}
+
+void FCachedClient::Empty()
+{
+	std::scoped_lock _(State->Lock);
+	State->Entries.Empty();
+	State->CachedBytes = 0;
+}
+
+int64 FCachedClient::GetCachedBytes() const
+{
+	std::scoped_lock _(State->Lock);
+	return State->CachedBytes;
+}
+
+void FCachedClientState::Start(FString Key,
+                               TSharedPtr<FAwaiterState> AwaiterState)
+{
+	std::unique_lock L(Lock);
+	if (auto* Entry = Entries.Find(Key))
+	{
+		Entry->LastUse = ++UseCounter;
+		if (FPlatformTime::Seconds() < Entry->FreshUntil)
+		{
+			// The awaiter isn't suspended yet, this only stores the result
+			auto Response = Entry->Response;
+			L.unlock();
+			AwaiterState->RequestComplete(nullptr, std::move(Response), true);
+			return;
+		}
+	}
+
+	if (auto* Waiting = InFlight.Find(Key))
+	{
+		Waiting->Add(std::move(AwaiterState));
+		return;
+	}
+	InFlight.Add(Key, {AwaiterState});
+
+	auto& Request = AwaiterState->Request;
+	if (auto* Entry = Entries.Find(Key))
+	{
+		if (!Entry->ETag.IsEmpty())
+			Request->SetHeader(TEXT("If-None-Match"), Entry->ETag);
+		else if (!Entry->LastModified.IsEmpty())
+			Request->SetHeader(TEXT("If-Modified-Since"), Entry->LastModified);
+	}
+	L.unlock();
+
+	// In-flight requests keep the state alive, so that every awaiter resumes
+	Request->OnProcessRequestComplete().BindLambda(
+		[This = AsShared(), Key = std::move(Key)](FHttpRequestPtr,
+		                                          FHttpResponsePtr Response,
+		                                          bool bConnectedSuccessfully)
+	{
+		This->Complete(Key, std::move(Response), bConnectedSuccessfully);
+	});
+	Request->ProcessRequest();
+}
+
+void FCachedClientState::Complete(const FString& Key,
+                                  FHttpResponsePtr Response,
+                                  bool bConnectedSuccessfully)
+{
+	std::unique_lock L(Lock);
+	auto Waiting = InFlight.FindAndRemoveChecked(Key);
+	if (bConnectedSuccessfully && Response)
+	{
+		auto Code = Response->GetResponseCode();
+		auto* Entry = Entries.Find(Key);
+		if (Code == 304 && Entry)
+		{
+			// Not modified: keep the original response, refresh its lifetime
+			auto Control = ParseCacheControl(
+				Response->GetHeader(TEXT("Cache-Control")));
+			if (!Control.bNoCache)
+				Entry->FreshUntil = FPlatformTime::Seconds() + Control.MaxAge;
+			Entry->LastUse = ++UseCounter;
+			Response = Entry->Response;
+		}
+		else if (Code == 200)
+			Store(Key, Waiting[0]->Request->GetURL(), Response, L);
+		else if (Entry) // The entry might not be valid anymore
+			Remove(Key, L);
+	}
+	L.unlock();
+
+	for (auto& AwaiterState : Waiting)
+		Resume(AwaiterState, Response, bConnectedSuccessfully);
+}
+
+void FCachedClientState::Store(const FString& Key, const FString& Url,
+                               const FHttpResponsePtr& Response,
+                               std::unique_lock<FMutex>& L)
+{
+	checkf(L.owns_lock(), TEXT("Internal error: lock not held"));
+	Remove(Key, L);
+
+	auto Control = ParseCacheControl(
+		Response->GetHeader(TEXT("Cache-Control")));
+	double Now = FPlatformTime::Seconds();
+	FEntry Entry;
+	Entry.Url = Url;
+	Entry.Response = Response;
+	Entry.ETag = Response->GetHeader(TEXT("ETag"));
+	Entry.LastModified = Response->GetHeader(TEXT("Last-Modified"));
+	Entry.FreshUntil = Control.bNoCache ? 0 : Now + Control.MaxAge;
+	Entry.Bytes = Response->GetContent().Num();
+	Entry.LastUse = ++UseCounter;
+
+	// Don't keep responses that could never be reused
+	bool bReusable = Entry.FreshUntil > Now || !Entry.ETag.IsEmpty() ||
+	                 !Entry.LastModified.IsEmpty();
+	if (Control.bNoStore || !bReusable || Entry.Bytes > MaxBytes)
+		return;
+
+	CachedBytes += Entry.Bytes;
+	Entries.Add(Key, std::move(Entry));
+
+	// Evict the least recently used entries to make room
+	while (CachedBytes > MaxBytes)
+	{
+		const FString* Oldest = nullptr;
+		uint64 OldestUse = MAX_uint64;
+		for (auto& Pair : Entries)
+			if (Pair.Value.LastUse < OldestUse)
+			{
+				Oldest = &Pair.Key;
+				OldestUse = Pair.Value.LastUse;
+			}
+		Remove(FString(*Oldest), L);
+	}
+}
+
+void FCachedClientState::Remove(const FString& Key,
+                                std::unique_lock<FMutex>& L)
+{
+	checkf(L.owns_lock(), TEXT("Internal error: lock not held"));
+	FEntry Entry;
+	if (Entries.RemoveAndCopyValue(Key, Entry))
+		CachedBytes -= Entry.Bytes;
+}
+
+void FCachedClientState::Resume(const TSharedPtr<FAwaiterState>& AwaiterState,
+                                FHttpResponsePtr Response,
+                                bool bConnectedSuccessfully)
+{
+	// FState expects the game thread unless its request completes on the HTTP
+	// thread, but the request that was sent might have had another policy
+	if (IsInGameThread() ||
+	    AwaiterState->Thread == ENamedThreads::UnusedAnchor)
+		AwaiterState->RequestComplete(nullptr, std::move(Response),
+		                              bConnectedSuccessfully);
+	else
+		AsyncTask(ENamedThreads::GameThread,
+		          [AwaiterState, Response = std::move(Response),
+		           bConnectedSuccessfully]() mutable
+		{
+			AwaiterState->RequestComplete(nullptr, std::move(Response),
+			                              bConnectedSuccessfully);
+		});
+}
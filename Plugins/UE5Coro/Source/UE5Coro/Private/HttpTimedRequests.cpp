@@ -0,0 +1,293 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "UE5Coro/HttpAwaiters.h"
+#include "HttpModule.h"
+#include "TimerThread.h"
+#include "Async/Async.h"
+#include "Interfaces/IHttpResponse.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Private;
+
+namespace UE5Coro::Private
+{
+/** Request state with a timer on FTimerThread that fires on the game thread.
+ *  This is used instead of a WhenAny with a helper coroutine. */
+struct FTimedRequestState : TSharedFromThis<FTimedRequestState>
+{
+	using FAwaiterState = FHttpAwaiter::FState;
+
+	const TSharedPtr<FAwaiterState> AwaiterState;
+	FMutex Lock;
+	TUniquePtr<FAsyncTimeAwaiter> Timer;
+	/** Keeps this object and Timer alive while the timer thread uses it. */
+	TSharedPtr<FTimedRequestState> TimerSelf;
+	bool bDone = false;
+	// end Lock
+
+	explicit FTimedRequestState(FHttpRequestRef&& Request)
+		: AwaiterState(new FAwaiterState(std::move(Request))) { }
+	virtual ~FTimedRequestState() = default;
+
+	FHttpAwaiter MakeAwaiter() const { return FHttpAwaiter(AwaiterState); }
+	void Arm(double Seconds, std::unique_lock<FMutex>&);
+	/** Returns false if the timer wasn't armed, or if it's already firing. */
+	bool Disarm(std::unique_lock<FMutex>&);
+	static void OnTimer(void* Context);
+	/** Called on the game thread when the timer fires. */
+	virtual void Timeout() = 0;
+};
+
+struct FHedgedRequestState final : FTimedRequestState
+{
+	const double HedgeAfter;
+	const int32 MaxAttempts;
+	TArray<FHttpRequestRef> Attempts; // Attempts[0] is the original
+	int32 NumFailed = 0;
+	// end Lock
+
+	explicit FHedgedRequestState(FHttpRequestRef&& Request, double HedgeAfter,
+	                             int32 MaxAttempts)
+		: FTimedRequestState(std::move(Request)), HedgeAfter(HedgeAfter)
+		, MaxAttempts(FMath::Max(1, MaxAttempts)) { }
+
+	void Start();
+	void Send(const FHttpRequestRef&);
+	void Hedge(std::unique_lock<FMutex>&);
+	virtual void Timeout() override;
+	void AttemptComplete(FHttpRequestPtr, FHttpResponsePtr, bool);
+};
+
+struct FDeadlineRequestState final : FTimedRequestState
+{
+	using FTimedRequestState::FTimedRequestState;
+
+	void Start(double Seconds);
+	virtual void Timeout() override;
+	void RequestComplete(FHttpRequestPtr, FHttpResponsePtr, bool);
+};
+}
+
+namespace
+{
+FHttpRequestRef CopyRequest(const FHttpRequestRef& Request)
+{
+	auto Copy = FHttpModule::Get().CreateRequest();
+	Copy->SetURL(Request->GetURL());
+	Copy->SetVerb(Request->GetVerb());
+	for (auto& Header : Request->GetAllHeaders())
+	{
+		FString Name, Value;
+		if (Header.Split(TEXT(": "), &Name, &Value))
+			Copy->SetHeader(Name, Value);
+	}
+	Copy->SetContent(Request->GetContent());
+#if ENGINE_MINOR_VERSION >= 3
+	Copy->SetDelegateThreadPolicy(Request->GetDelegateThreadPolicy());
+#endif
+	return Copy;
+}
+}
+
+FHttpAwaiter Http::ProcessHedged(FHttpRequestRef Request,
+                                 double HedgeAfterSeconds, int32 MaxAttempts)
+{
+	auto State = MakeShared<FHedgedRequestState>(std::move(Request),
+	                                             HedgeAfterSeconds,
+	                                             MaxAttempts);
+	State->Start();
+	return State->MakeAwaiter();
+}
+
+FHttpAwaiter Http::ProcessWithDeadline(FHttpRequestRef Request, double Seconds)
+{
+	auto State = MakeShared<FDeadlineRequestState>(std::move(Request));
+	State->Start(Seconds);
+	return State->MakeAwaiter();
+}
+
+void FTimedRequestState::Arm(double Seconds, std::unique_lock<FMutex>& L)
+{
+	checkf(L.owns_lock(), TEXT("Internal error: lock not held"));
+	checkf(!TimerSelf, TEXT("Internal error: timer already armed"));
+	// The previous timer, if any, is no longer used by the timer thread
+	Timer = MakeUnique<FAsyncTimeAwaiter>(FPlatformTime::Seconds() + Seconds,
+	                                      true);
+	TimerSelf = AsShared();
+	FTimerThread::Get().RegisterCallback(Timer.Get(), &OnTimer, this);
+}
+
+bool FTimedRequestState::Disarm(std::unique_lock<FMutex>& L)
+{
+	checkf(L.owns_lock(), TEXT("Internal error: lock not held"));
+	if (!TimerSelf || !FTimerThread::Get().TryUnregister(Timer.Get()))
+		return false;
+	// The timer thread will not see the timer again, TimerSelf can go. This
+	// cannot be the last reference, the caller is a member function.
+	TimerSelf = nullptr;
+	return true;
+}
+
+void FTimedRequestState::OnTimer(void* Context)
+{
+	auto* This = static_cast<FTimedRequestState*>(Context);
+	TSharedPtr<FTimedRequestState> Self;
+	{
+		std::scoped_lock _(This->Lock);
+		Self = std::move(This->TimerSelf);
+	}
+	// Timer is not touched after this, it's safe to replace it from now on
+	AsyncTask(ENamedThreads::GameThread,
+	          [Self = std::move(Self)] { Self->Timeout(); });
+}
+
+void FHedgedRequestState::Start()
+{
+	std::unique_lock L(Lock);
+	auto& Request = AwaiterState->Request;
+	Attempts.Add(Request);
+	if (Attempts.Num() < MaxAttempts)
+		Arm(HedgeAfter, L);
+	L.unlock();
+	Send(Request);
+}
+
+void FHedgedRequestState::Send(const FHttpRequestRef& Request)
+{
+	Request->OnProcessRequestComplete().BindSP(
+		StaticCastSharedRef<FHedgedRequestState>(AsShared()),
+		&FHedgedRequestState::AttemptComplete);
+	Request->ProcessRequest();
+}
+
+void FHedgedRequestState::Hedge(std::unique_lock<FMutex>& L)
+{
+	checkf(L.owns_lock(), TEXT("Internal error: lock not held"));
+	if (bDone || Attempts.Num() >= MaxAttempts)
+	{
+		L.unlock();
+		return;
+	}
+	auto Copy = CopyRequest(Attempts[0]);
+	Attempts.Add(Copy);
+	if (Attempts.Num() < MaxAttempts)
+		Arm(HedgeAfter, L);
+	L.unlock();
+	Send(Copy);
+}
+
+void FHedgedRequestState::Timeout()
+{
+	std::unique_lock L(Lock);
+	Hedge(L);
+}
+
+void FHedgedRequestState::AttemptComplete(FHttpRequestPtr Request,
+                                          FHttpResponsePtr Response,
+                                          bool bConnectedSuccessfully)
+{
+	std::unique_lock L(Lock);
+	if (bDone) // Canceled loser
+		return;
+
+	if (bConnectedSuccessfully && Response)
+	{
+		bDone = true;
+		Disarm(L);
+		TArray<FHttpRequestRef> Losers;
+		for (auto& Attempt : Attempts)
+			if (&Attempt.Get() != Request.Get())
+				Losers.Add(Attempt);
+		L.unlock();
+		for (auto& Loser : Losers)
+			Loser->CancelRequest();
+		AwaiterState->RequestComplete(std::move(Request), std::move(Response),
+		                              true);
+		return;
+	}
+
+	// Wait for the others if there's still something in flight
+	if (++NumFailed < Attempts.Num())
+		return;
+	if (Attempts.Num() < MaxAttempts)
+	{
+		// Send the next one now, unless the timer is already doing that
+		if (!Disarm(L))
+			return;
+		L.unlock();
+		AsyncTask(ENamedThreads::GameThread,
+		          [This = AsShared()] { This->Timeout(); });
+		return;
+	}
+
+	bDone = true;
+	L.unlock();
+	AwaiterState->RequestComplete(std::move(Request), std::move(Response),
+	                              bConnectedSuccessfully);
+}
+
+void FDeadlineRequestState::Start(double Seconds)
+{
+	auto& Request = AwaiterState->Request;
+	Request->OnProcessRequestComplete().BindSP(
+		StaticCastSharedRef<FDeadlineRequestState>(AsShared()),
+		&FDeadlineRequestState::RequestComplete);
+	{
+		std::unique_lock L(Lock);
+		Arm(Seconds, L);
+	}
+	Request->ProcessRequest();
+}
+
+void FDeadlineRequestState::Timeout()
+{
+	{
+		std::scoped_lock _(Lock);
+		if (bDone)
+			return;
+	}
+	// This will complete the request unsuccessfully
+	AwaiterState->Request->CancelRequest();
+}
+
+void FDeadlineRequestState::RequestComplete(FHttpRequestPtr Request,
+                                            FHttpResponsePtr Response,
+                                            bool bConnectedSuccessfully)
+{
+	{
+		std::unique_lock L(Lock);
+		bDone = true;
+		Disarm(L);
+	}
+	AwaiterState->RequestComplete(std::move(Request), std::move(Response),
+	                              bConnectedSuccessfully);
+}
@@ -30,6 +30,7 @@
 // ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "LatentActions.h"
+#include "HAL/IConsoleManager.h"
 #include "UE5Coro/AsyncCoroutine.h"
 #include "UE5Coro/LatentAwaiters.h"
 #include "UE5Coro/UE5CoroSubsystem.h"
@@ -38,13 +39,21 @@ using namespace UE5Coro::Private;
 
 namespace
 {
+TAutoConsoleVariable<bool> CVarFlatLatentScheduler(
+	TEXT("UE5Coro.FlatLatentScheduler"), true,
+	TEXT("Poll latent awaiters in async coroutines from a single array owned ")
+	TEXT("by the world's UE5Coro subsystem, instead of registering a latent ")
+	TEXT("action for each of them."));
+
 struct [[nodiscard]] FPendingAsyncCoroutine final : FPendingLatentAction
 {
 	FAsyncPromise* Promise;
 	FLatentAwaiter* Awaiter;
+	TWeakObjectPtr<UWorld> World; // The promise's home world
 
 	FPendingAsyncCoroutine(FAsyncPromise& Promise, FLatentAwaiter* Awaiter)
-		: Promise(&Promise), Awaiter(Awaiter) { }
+		: Promise(&Promise), Awaiter(Awaiter), World(Promise.GetHomeWorld())
+	{ }
 	UE_NONCOPYABLE(FPendingAsyncCoroutine);
 
 	virtual ~FPendingAsyncCoroutine() override
@@ -59,6 +68,8 @@ struct [[nodiscard]] FPendingAsyncCoroutine final : FPendingLatentAction
 
 	virtual void UpdateOperation(FLatentResponse& Response) override
 	{
+		// Poll in the coroutine's world, which might not be GWorld
+		FLatentWorldScope _(World.Get());
 		if (!Awaiter->ShouldResume())
 			return;
 
@@ -72,10 +83,16 @@ struct [[nodiscard]] FPendingAsyncCoroutine final : FPendingLatentAction
 }
 
 FLatentAwaiter::FLatentAwaiter(FLatentAwaiter&& Other) noexcept
-	: State(Other.State), Resume(Other.Resume)
+	: State(Other.State), Resume(Other.Resume), Relocate(Other.Relocate)
 {
+	if (Relocate)
+	{
+		(*Relocate)(Other.InlineState, InlineState);
+		State = InlineState;
+	}
 	Other.State = nullptr;
 	Other.Resume = nullptr;
+	Other.Relocate = nullptr;
 }
 
 FLatentAwaiter::~FLatentAwaiter()
@@ -84,6 +101,7 @@ FLatentAwaiter::~FLatentAwaiter()
 		(*Resume)(State, true);
 	State = nullptr;
 	Resume = nullptr;
+	Relocate = nullptr;
 }
 
 bool FLatentAwaiter::ShouldResume()
@@ -98,15 +116,25 @@ void FLatentAwaiter::Suspend(FAsyncPromise& Promise)
 {
 	checkf(IsInGameThread(),
 	       TEXT("Latent awaiters may only be used on the game thread"));
-	checkf(GWorld,
+	auto* World = GetLatentWorld();
+	checkf(World,
 	       TEXT("Awaiting this can only be done in the context of a world"));
+	// Stay in this world even if GWorld changes, and resume from it
+	if (!Promise.GetHomeWorld())
+		Promise.SetHomeWorld(World);
+
+	auto* Sys = World->GetSubsystem<UUE5CoroSubsystem>();
+	if (CVarFlatLatentScheduler.GetValueOnGameThread())
+	{
+		Sys->AddPendingAwaiter(Promise, *this);
+		return;
+	}
 
 	// Prepare a latent action on the subsystem and transfer ownership to that
-	auto* Sys = GWorld->GetSubsystem<UUE5CoroSubsystem>();
 	auto* Latent = new FPendingAsyncCoroutine(Promise, this);
 	auto LatentInfo = Sys->MakeLatentInfo();
-	GWorld->GetLatentActionManager().AddNewAction(LatentInfo.CallbackTarget,
-	                                              LatentInfo.UUID, Latent);
+	World->GetLatentActionManager().AddNewAction(LatentInfo.CallbackTarget,
+	                                             LatentInfo.UUID, Latent);
 }
 
 void FLatentAwaiter::Suspend(FLatentPromise& Promise)
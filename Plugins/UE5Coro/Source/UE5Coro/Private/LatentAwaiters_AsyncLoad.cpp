@@ -29,32 +29,264 @@
 // OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
 // ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
+#include "Async/Async.h"
 #include "Engine/AssetManager.h"
+#include "HAL/IConsoleManager.h"
+#include "UE5Coro/AsyncAwaiters.h"
 #include "UE5Coro/LatentAwaiters.h"
+#include "UE5Coro/UE5CoroSubsystem.h"
 
 using namespace UE5Coro;
 using namespace UE5Coro::Private;
 
 namespace
 {
-template<typename T, typename Item>
+TAutoConsoleVariable<int32> CVarAsyncLoadCacheSize(
+	TEXT("UE5Coro.AsyncLoadCacheSize"), 16,
+	TEXT("Number of recent asynchronous loads of a single object that are kept ")
+	TEXT("alive by UE5Coro after their last awaiter is gone, to avoid repeatedly ")
+	TEXT("loading and unloading the same object."));
+
+TAutoConsoleVariable<int32> CVarAsyncLoadAwaitedPriority(
+	TEXT("UE5Coro.AsyncLoadAwaitedPriority"),
+	FStreamableManager::AsyncLoadHighPriority,
+	TEXT("Asynchronous loads that a coroutine is waiting for are raised to at ")
+	TEXT("least this priority, ahead of loads that were only started. ")
+	TEXT("Negative values disable this."));
+
+/** Wakes one awaiter. Bound weakly, since loads might finish after the loader
+ *  is gone. */
+struct FLoadNotify
+{
+	bool bDone = false;
+	TWeakObjectPtr<UUE5CoroSubsystem> Subsystem;
+	FAsyncPromise* Promise = nullptr;
+
+	virtual ~FLoadNotify() = default;
+
+	virtual void Done()
+	{
+		checkf(IsInGameThread(),
+		       TEXT("Internal error: expected callback on the game thread"));
+		bDone = true;
+		if (auto* Sys = Subsystem.Get(); Sys && Promise)
+			Sys->ResumeReady(*std::exchange(Promise, nullptr));
+	}
+};
+using FLoadNotifyRef = TSharedRef<FLoadNotify, ESPMode::NotThreadSafe>;
+
+/** Streamable handle shared by every loader that requested the same object. */
+struct FSharedHandle
+	: TSharedFromThis<FSharedHandle, ESPMode::NotThreadSafe>
+{
+	TSharedPtr<FStreamableHandle> Handle;
+	TArray<TWeakPtr<FLoadNotify, ESPMode::NotThreadSafe>> Waiters;
+	FSoftObjectPath Key; // Only set if this handle is deduplicated
+	TAsyncLoadPriority Priority;
+	bool bCacheWhenDone = false;
+
+	explicit FSharedHandle(TSharedPtr<FStreamableHandle> Handle,
+	                       TAsyncLoadPriority Priority, FSoftObjectPath Key)
+		: Handle(std::move(Handle)), Key(std::move(Key)), Priority(Priority)
+	{
+	}
+	UE_NONCOPYABLE(FSharedHandle);
+	~FSharedHandle();
+
+	static TSharedRef<FSharedHandle, ESPMode::NotThreadSafe> Make(
+		TSharedPtr<FStreamableHandle>, TAsyncLoadPriority,
+		FSoftObjectPath Key = {});
+
+	bool IsDone() const
+	{
+		// This is the same logic that FLoadAssetActionBase::UpdateOperation()
+		// uses. !Handle is how UAssetManager communicates an instant finish.
+		return !Handle || Handle->HasLoadCompleted() || Handle->WasCanceled();
+	}
+
+	bool WasCanceled() const { return Handle && Handle->WasCanceled(); }
+
+	void Escalate(TAsyncLoadPriority NewPriority);
+	void Done();
+};
+using FSharedHandleRef = TSharedRef<FSharedHandle, ESPMode::NotThreadSafe>;
+
+/** Routes loads through one FStreamableManager, and lets concurrent loads of the
+ *  same object share a handle. */
+class FSharedLoads final
+{
+	FStreamableManager Manager;
+	TMap<FSoftObjectPath, TWeakPtr<FSharedHandle, ESPMode::NotThreadSafe>>
+		Handles;
+	/** Recently completed loads, the most recent last. */
+	TArray<FSharedHandleRef> Recent;
+
+public:
+	static FSharedLoads& Get()
+	{
+		checkf(IsInGameThread(),
+		       TEXT("Latent awaiters may only be used on the game thread"));
+		// Deliberately never destroyed: FStreamableManager is a FGCObject,
+		// static destruction would be too late for it
+		static auto* Instance = new FSharedLoads;
+		return *Instance;
+	}
+
+	FSharedHandleRef Request(const TArray<FSoftObjectPath>& Paths,
+	                         TAsyncLoadPriority Priority)
+	{
+		// Multiple paths still share the underlying loads within Manager
+		bool bDeduplicate = Paths.Num() == 1;
+		if (bDeduplicate)
+			if (auto* Weak = Handles.Find(Paths[0]))
+				if (auto Existing = Weak->Pin();
+				    Existing && !Existing->WasCanceled())
+				{
+					// A more urgent request shouldn't wait behind the original
+					Existing->Escalate(Priority);
+					Touch(*Existing);
+					return Existing.ToSharedRef();
+				}
+
+		auto Shared = FSharedHandle::Make(
+			Manager.RequestAsyncLoad(Paths, FStreamableDelegate(), Priority),
+			Priority, bDeduplicate ? Paths[0] : FSoftObjectPath());
+		if (bDeduplicate)
+		{
+			Handles.Add(Paths[0], Shared);
+			// Only real loads are worth caching. Objects that are already in
+			// memory, such as transient ones, resolve instantly anyway.
+			Shared->bCacheWhenDone = !Shared->IsDone();
+		}
+		return Shared;
+	}
+
+	TSharedPtr<FSharedHandle, ESPMode::NotThreadSafe> Find(
+		const FSoftObjectPath& Path) const
+	{
+		auto* Weak = Handles.Find(Path);
+		return Weak ? Weak->Pin() : nullptr;
+	}
+
+	void Remember(FSharedHandleRef Shared)
+	{
+		Recent.Add(std::move(Shared));
+		int32 Max = FMath::Max(0, CVarAsyncLoadCacheSize.GetValueOnGameThread());
+		if (Recent.Num() > Max)
+			Recent.RemoveAt(0, Recent.Num() - Max);
+	}
+
+	void Forget(const FSoftObjectPath& Key)
+	{
+		// The entry might have been replaced by a newer, live handle
+		if (auto* Weak = Handles.Find(Key); Weak && !Weak->IsValid())
+			Handles.Remove(Key);
+	}
+
+	/** Stops new requests from sharing this handle. */
+	void Forget(FSharedHandle& Shared)
+	{
+		auto* Weak = Handles.Find(Shared.Key);
+		if (Weak && Weak->Pin().Get() == &Shared)
+			Handles.Remove(Shared.Key);
+		Shared.Key.Reset();
+	}
+
+private:
+	void Touch(FSharedHandle& Shared)
+	{
+		int32 Index = Recent.IndexOfByPredicate([&](const FSharedHandleRef& i)
+		{
+			return &*i == &Shared;
+		});
+		if (Index != INDEX_NONE)
+		{
+			auto Ref = std::move(Recent[Index]);
+			Recent.RemoveAt(Index);
+			Recent.Add(std::move(Ref));
+		}
+	}
+};
+
+FSharedHandle::~FSharedHandle()
+{
+	checkf(IsInGameThread(), TEXT("Unexpected cleanup off the game thread"));
+	if (!Key.IsNull())
+		FSharedLoads::Get().Forget(Key);
+	if (Handle)
+		Handle->ReleaseHandle();
+}
+
+FSharedHandleRef FSharedHandle::Make(TSharedPtr<FStreamableHandle> Handle,
+                                     TAsyncLoadPriority Priority,
+                                     FSoftObjectPath Key)
+{
+	FSharedHandleRef Shared = MakeShared<FSharedHandle, ESPMode::NotThreadSafe>(
+		std::move(Handle), Priority, std::move(Key));
+	if (!Shared->IsDone())
+	{
+		// Canceled handles don't call the completion delegate
+		auto& StreamableHandle = *Shared->Handle;
+		StreamableHandle.BindCompleteDelegate(
+			FStreamableDelegate::CreateSP(Shared, &FSharedHandle::Done));
+		StreamableHandle.BindCancelDelegate(
+			FStreamableDelegate::CreateSP(Shared, &FSharedHandle::Done));
+	}
+	return Shared;
+}
+
+void FSharedHandle::Escalate(TAsyncLoadPriority NewPriority)
+{
+	checkf(IsInGameThread(),
+	       TEXT("Latent awaiters may only be used on the game thread"));
+	if (NewPriority <= Priority || IsDone())
+		return;
+	Priority = NewPriority;
+
+	// FStreamableManager doesn't reissue requests that are already in flight,
+	// but the package loader raises the priority of an in-flight package when
+	// it's requested again with a higher one
+	TArray<FSoftObjectPath> Paths;
+	Handle->GetRequestedAssets(Paths);
+	TSet<FString> Packages;
+	for (auto& Path : Paths)
+		Packages.Add(Path.GetLongPackageName());
+	for (auto& Package : Packages)
+		LoadPackageAsync(Package, FLoadPackageAsyncDelegate(), NewPriority);
+}
+
+void FSharedHandle::Done()
+{
+	// A canceled load would resolve every later request to nullptr
+	if (WasCanceled())
+	{
+		bCacheWhenDone = false;
+		if (!Key.IsNull())
+			FSharedLoads::Get().Forget(*this);
+	}
+	if (std::exchange(bCacheWhenDone, false))
+		FSharedLoads::Get().Remember(AsShared());
+	for (auto& Weak : std::exchange(Waiters, {}))
+		if (auto Notify = Weak.Pin())
+			Notify->Done();
+}
+
+template<typename Item>
 struct TLatentLoader
 {
-	T Manager;
 	TArray<Item> Sources;
-	TSharedPtr<FStreamableHandle> Handle;
+	FSharedHandleRef Shared;
+	FLoadNotifyRef Notify = MakeShared<FLoadNotify, ESPMode::NotThreadSafe>();
+	bool bAwaited = false;
 
 	explicit TLatentLoader(TArray<Item> Paths, TAsyncLoadPriority Priority)
 #if UE5CORO_CPP20
 		requires std::is_same_v<Item, FSoftObjectPath>
 #endif
 		: Sources(std::move(Paths))
+		, Shared(FSharedLoads::Get().Request(Sources, Priority))
 	{
-		static_assert(std::is_same_v<T, FStreamableManager>);
-		checkf(IsInGameThread(),
-		       TEXT("Latent awaiters may only be used on the game thread"));
-		Handle = Manager.RequestAsyncLoad(Sources, FStreamableDelegate(),
-		                                  Priority);
+		Attach();
 	}
 
 	explicit TLatentLoader(TArray<Item> AssetIds, const TArray<FName>& Bundles,
@@ -62,20 +294,47 @@ struct TLatentLoader
 #if UE5CORO_CPP20
 		requires std::is_same_v<Item, FPrimaryAssetId>
 #endif
-		: Manager(UAssetManager::Get()), Sources(std::move(AssetIds))
+		: Sources(std::move(AssetIds))
+		, Shared(FSharedHandle::Make(LoadPrimary(Sources, Bundles, Priority),
+		                             Priority))
 	{
-		static_assert(std::is_same_v<T, UAssetManager&>);
-		checkf(IsInGameThread(),
-		       TEXT("Latent awaiters may only be used on the game thread"));
-		Handle = Manager.LoadPrimaryAssets(Sources, Bundles,
-		                                   FStreamableDelegate(), Priority);
+		Attach();
 	}
 
 	~TLatentLoader()
 	{
 		checkf(IsInGameThread(), TEXT("Unexpected cleanup off the game thread"));
-		if (Handle)
-			Handle->ReleaseHandle();
+		Notify->Promise = nullptr;
+	}
+
+	void Awaited()
+	{
+		if (std::exchange(bAwaited, true))
+			return;
+		if (int32 Priority = CVarAsyncLoadAwaitedPriority.GetValueOnGameThread();
+		    Priority >= 0)
+			Shared->Escalate(Priority);
+	}
+
+	void Attach()
+	{
+		if (!Shared->IsDone())
+			Shared->Waiters.Add(Notify);
+	}
+
+	static TSharedPtr<FStreamableHandle> LoadPrimary(
+		const TArray<FPrimaryAssetId>& AssetIds, const TArray<FName>& Bundles,
+		TAsyncLoadPriority Priority)
+	{
+		checkf(IsInGameThread(),
+		       TEXT("Latent awaiters may only be used on the game thread"));
+		return UAssetManager::Get().LoadPrimaryAssets(
+			AssetIds, Bundles, FStreamableDelegate(), Priority);
+	}
+
+	bool IsReady() const
+	{
+		return Notify->bDone || Shared->IsDone();
 	}
 
 	TArray<UObject*> ResolveItems()
@@ -91,7 +350,7 @@ struct TLatentLoader
 			if constexpr (std::is_same_v<Item, FSoftObjectPath>)
 				Obj = i.ResolveObject();
 			else if constexpr (std::is_same_v<Item, FPrimaryAssetId>)
-				Obj = Manager.GetPrimaryAssetObject(i);
+				Obj = UAssetManager::Get().GetPrimaryAssetObject(i);
 			else
 				// This needs to depend on a template parameter
 				static_assert(false && std::is_void_v<Item>, "Unknown type");
@@ -103,8 +362,8 @@ struct TLatentLoader
 		return Items;
 	}
 };
-using FLatentLoader = TLatentLoader<FStreamableManager, FSoftObjectPath>;
-using FPrimaryLoader = TLatentLoader<UAssetManager&, FPrimaryAssetId>;
+using FLatentLoader = TLatentLoader<FSoftObjectPath>;
+using FPrimaryLoader = TLatentLoader<FPrimaryAssetId>;
 
 template<typename T>
 bool ShouldResume(void* Loader, bool bCleanup)
@@ -117,13 +376,165 @@ bool ShouldResume(void* Loader, bool bCleanup)
 		return false;
 	}
 
-	// This is the same logic that FLoadAssetActionBase::UpdateOperation() uses.
-	// !Handle is how UAssetManager communicates an instant/synchronous finish.
-	auto& Handle = This->Handle;
-	return !Handle || Handle->HasLoadCompleted() || Handle->WasCanceled();
+	// Only awaiting or polling gets here, merely holding the awaiter doesn't
+	This->Awaited();
+	return This->IsReady();
+}
+
+/** Registered by other modules, there are only a handful of these.<br>
+ *  This is a function to not depend on static initialization order. */
+TArray<TPair<bool (*)(void*, bool), FLatentReadyCallback::FBinder>>&
+ReadyBinders()
+{
+	static TArray<TPair<bool (*)(void*, bool), FLatentReadyCallback::FBinder>>
+		Binders;
+	return Binders;
+}
+
+template<typename T>
+bool TryBindLoader(void* State, UUE5CoroSubsystem& Sys,
+                   FAsyncPromise& Promise)
+{
+	auto* This = static_cast<T*>(State);
+	checkf(!This->IsReady(), TEXT("Internal error: binding a ready loader"));
+	auto& Notify = *This->Notify;
+	checkf(!Notify.Promise, TEXT("Attempted second concurrent co_await"));
+	Notify.Subsystem = &Sys;
+	Notify.Promise = &Promise;
+	return true;
 }
 }
 
+namespace UE5Coro::Private
+{
+struct FAsyncLoadProgressState
+{
+	struct FItem final : FLoadNotify
+	{
+		FAsyncLoadProgressState* Owner;
+		int32 Index;
+
+		explicit FItem(FAsyncLoadProgressState* Owner, int32 Index)
+			: Owner(Owner), Index(Index) { }
+
+		virtual void Done() override
+		{
+			checkf(IsInGameThread(),
+			       TEXT("Internal error: expected callback on the game thread"));
+			bDone = true;
+			Owner->Finished(Index); // This might destroy Owner
+		}
+	};
+
+	TArray<FSoftObjectPath> Paths;
+	TArray<FSharedHandleRef> Handles;
+	TArray<TSharedRef<FItem, ESPMode::NotThreadSafe>> Items;
+	TArray<int32> Ready; // Indices in the order they finished
+	int32 NumReported = 0;
+	FPromise* Promise = nullptr;
+
+	void Finished(int32 Index)
+	{
+		Ready.Add(Index);
+		if (Promise)
+			std::exchange(Promise, nullptr)->Resume();
+	}
+};
+}
+
+bool FLatentReadyCallback::TryBind(FLatentAwaiter& Awaiter,
+                                   UUE5CoroSubsystem& Sys,
+                                   FAsyncPromise& Promise)
+{
+	checkf(IsInGameThread(),
+	       TEXT("Latent awaiters may only be used on the game thread"));
+	if (Awaiter.Resume == &ShouldResume<FLatentLoader>)
+		return TryBindLoader<FLatentLoader>(Awaiter.State, Sys, Promise);
+	if (Awaiter.Resume == &ShouldResume<FPrimaryLoader>)
+		return TryBindLoader<FPrimaryLoader>(Awaiter.State, Sys, Promise);
+	for (auto [Resume, Binder] : ReadyBinders())
+		if (Awaiter.Resume == Resume)
+			return Binder(Awaiter.State, Sys, Promise);
+	return false; // Everything else is polled
+}
+
+void FLatentReadyCallback::Register(bool (*Resume)(void*, bool),
+                                    FBinder Binder)
+{
+	checkf(Resume && Binder, TEXT("Registering invalid ready callback"));
+	checkf(!ReadyBinders().ContainsByPredicate([&](auto& Pair)
+	       {
+		       return Pair.Key == Resume;
+	       }), TEXT("Ready callback registered twice"));
+	ReadyBinders().Emplace(Resume, Binder);
+}
+
+void FLatentReadyCallback::Unregister(bool (*Resume)(void*, bool))
+{
+	ReadyBinders().RemoveAll([&](auto& Pair) { return Pair.Key == Resume; });
+}
+
+FAsyncLoadProgress::FAsyncLoadProgress(TArray<FSoftObjectPath> Paths,
+                                       TAsyncLoadPriority Priority)
+	: State(MakeShared<FAsyncLoadProgressState, ESPMode::NotThreadSafe>())
+{
+	auto& Loads = FSharedLoads::Get();
+	int32 Num = Paths.Num();
+	State->Paths = std::move(Paths);
+	State->Handles.Reserve(Num);
+	State->Items.Reserve(Num);
+	for (int32 i = 0; i < Num; ++i)
+	{
+		// One handle per object, these are deduplicated with other awaiters
+		auto& Shared = State->Handles.Add_GetRef(
+			Loads.Request(TArray{State->Paths[i]}, Priority));
+		auto& Item = State->Items.Add_GetRef(
+			MakeShared<FAsyncLoadProgressState::FItem, ESPMode::NotThreadSafe>(
+				State.Get(), i));
+		if (Shared->IsDone())
+			State->Ready.Add(i);
+		else
+			Shared->Waiters.Add(Item);
+	}
+}
+
+FAsyncLoadProgress::~FAsyncLoadProgress()
+{
+	checkf(!State || IsInGameThread(),
+	       TEXT("Unexpected cleanup off the game thread"));
+}
+
+FAsyncLoadProgressAwaiter FAsyncLoadProgress::Next()
+{
+	checkf(State, TEXT("Attempting to use a moved-from object"));
+	return FAsyncLoadProgressAwaiter(State);
+}
+
+bool FAsyncLoadProgressAwaiter::await_ready()
+{
+	checkf(IsInGameThread(),
+	       TEXT("Latent awaiters may only be used on the game thread"));
+	return State->NumReported < State->Ready.Num() ||
+	       State->NumReported == State->Paths.Num();
+}
+
+void FAsyncLoadProgressAwaiter::Suspend(FPromise& Promise)
+{
+	checkf(!State->Promise, TEXT("Attempted second concurrent co_await"));
+	State->Promise = &Promise;
+}
+
+TOptional<UObject*> FAsyncLoadProgressAwaiter::await_resume()
+{
+	checkf(IsInGameThread(),
+	       TEXT("Internal error: expected to resume on the game thread"));
+	if (State->NumReported == State->Paths.Num())
+		return {};
+	int32 Index = State->Ready[State->NumReported++];
+	UObject* Object = State->Paths[Index].ResolveObject();
+	return IsValid(Object) ? Object : nullptr;
+}
+
 template<int HiddenType>
 TArray<UObject*> AsyncLoad::InternalResume(void* State)
 {
@@ -136,9 +547,30 @@ TArray<UObject*> AsyncLoad::InternalResume(void* State)
 template UE5CORO_API TArray<UObject*> AsyncLoad::InternalResume<0>(void*);
 template UE5CORO_API TArray<UObject*> AsyncLoad::InternalResume<1>(void*);
 
+template<int HiddenType>
+void AsyncLoad::Boost(void* State, TAsyncLoadPriority Priority)
+{
+	using T = std::conditional_t<HiddenType, FPrimaryLoader, FLatentLoader>;
+	checkf(State, TEXT("Attempting to boost invalid latent awaiter"));
+	static_cast<T*>(State)->Shared->Escalate(Priority);
+}
+template UE5CORO_API void AsyncLoad::Boost<0>(void*, TAsyncLoadPriority);
+template UE5CORO_API void AsyncLoad::Boost<1>(void*, TAsyncLoadPriority);
+
+bool Latent::BoostAsyncLoad(const FSoftObjectPath& Path,
+                            TAsyncLoadPriority Priority)
+{
+	auto Shared = FSharedLoads::Get().Find(Path);
+	if (!Shared || Shared->IsDone())
+		return false;
+	Shared->Escalate(Priority);
+	return true;
+}
+
 FLatentAwaiter Latent::AsyncLoadObjects(TArray<FSoftObjectPath> Paths,
                                         TAsyncLoadPriority Priority)
 {
+	LLM_SCOPE_BYTAG(UE5Coro_AwaiterState);
 	return FLatentAwaiter(new FLatentLoader(std::move(Paths), Priority),
 	                      &ShouldResume<FLatentLoader>);
 }
@@ -208,6 +640,13 @@ FPackageLoadAwaiter::FPackageLoadAwaiter(
 	                 InstancingContext);
 }
 
+FPackageLoadAwaiter::~FPackageLoadAwaiter()
+{
+	// TStrongObjectPtr wants to be released on the game thread
+	if (State && !IsInGameThread())
+		AsyncTask(ENamedThreads::GameThread, [State = std::move(State)] { });
+}
+
 void FPackageLoadAwaiter::FState::Loaded(const FName&, UPackage* Package,
                                          EAsyncLoadingResult::Type)
 {
@@ -215,33 +654,48 @@ void FPackageLoadAwaiter::FState::Loaded(const FName&, UPackage* Package,
 	       TEXT("Internal error: expected callback on the game thread"));
 	Result.Reset(Package); // Store the result
 
+	std::unique_lock L(Lock);
+	bLoaded = true;
 	// Promise being nullptr indicates that the load finished between
 	// AsyncLoadPackage() and co_await
-	if (Promise)
-		Promise->Resume();
+	auto* Waiting = std::exchange(Promise, nullptr);
+	L.unlock();
+	if (!Waiting)
+		return;
+
+	// Resume inline if the coroutine is waiting on the game thread
+	if ((Thread & ThreadTypeMask) == ENamedThreads::GameThread)
+		Waiting->Resume();
+	else
+	{
+		Waiting->MarkAwaitReady();
+		AsyncTask(Waiting->WithTaskPriority(Thread),
+		          [Waiting] { Waiting->Resume(); });
+	}
 }
 
 bool FPackageLoadAwaiter::await_ready()
 {
-	checkf(IsInGameThread(),
-	       TEXT("Latent awaiters may only be used on the game thread"));
 	checkf(State, TEXT("Attempting to use invalid awaiter"));
-	return State->Result.IsValid();
+	std::unique_lock L(State->Lock);
+	if (State->bLoaded)
+		return true;
+	checkf(!State->Promise, TEXT("Attempted second concurrent co_await"));
+	L.release(); // Carry the lock into Suspend()
+	return false;
 }
 
 void FPackageLoadAwaiter::Suspend(FPromise& Promise)
 {
-	checkf(IsInGameThread(),
-	       TEXT("Latent awaiters may only be used on the game thread"));
-	checkf(!State->Promise, TEXT("Attempted second concurrent co_await"));
-
+	// This should be locked from await_ready
+	checkf(!State->Lock.try_lock(), TEXT("Internal error: lock wasn't taken"));
 	State->Promise = &Promise;
+	State->Thread = FTaskGraphInterface::Get().GetCurrentThreadIfKnown();
+	State->Lock.unlock();
 }
 
 UPackage* FPackageLoadAwaiter::await_resume()
 {
-	checkf(IsInGameThread(),
-	       TEXT("Internal error: expected to resume on the game thread"));
 	checkf(State, TEXT("Internal error: resuming without a result"));
 	return State->Result.Get();
 }
@@ -29,6 +29,10 @@
 // OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
 // ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
+#include "Async/Async.h"
+#include "Containers/Queue.h"
+#include "Containers/Ticker.h"
+#include "UE5Coro/AsyncAwaiters.h"
 #include "UE5Coro/LatentAwaiters.h"
 #include <optional>
 
@@ -138,6 +142,247 @@ template class UE5CORO_API TAsyncQueryAwaiter<FOverlapResult>;
 template class UE5CORO_API TAsyncQueryAwaiterRV<FOverlapResult>;
 }
 
+namespace UE5Coro::Private
+{
+/** Pooled state of a single async trace. Slots are never freed, which lets
+ *  their delegates be bound raw. Results that arrive after the slot was given
+ *  to another trace are recognized and ignored based on UserData. */
+struct FAsyncTraceSlot
+{
+	uint32 Generation = 0;
+	FPromise* Promise = nullptr;
+	bool bDone = false;
+	TOptional<FHitResult> Hit;
+	void* Out = nullptr;
+	void (*Store)(void*, TArray<FHitResult>&) = nullptr;
+	FTraceDelegate Delegate;
+
+	static FAsyncTraceSlot* Acquire();
+	void Release();
+	void ReceiveResult(const FTraceHandle&, FTraceDatum& Datum);
+};
+}
+
+namespace
+{
+TArray<FAsyncTraceSlot*> FreeTraceSlots; // Game thread only
+}
+
+FAsyncTraceSlot* FAsyncTraceSlot::Acquire()
+{
+	checkf(IsInGameThread(),
+	       TEXT("Async queries may only be started from the game thread."));
+	if (FreeTraceSlots.Num() > 0)
+		return FreeTraceSlots.Pop();
+	auto* Slot = new FAsyncTraceSlot;
+	Slot->Delegate.BindRaw(Slot, &FAsyncTraceSlot::ReceiveResult);
+	return Slot;
+}
+
+void FAsyncTraceSlot::Release()
+{
+	checkf(IsInGameThread(), TEXT("Unexpected cleanup off the game thread"));
+	++Generation; // Invalidate a result that's still pending
+	Promise = nullptr;
+	bDone = false;
+	Hit.Reset();
+	Out = nullptr;
+	Store = nullptr;
+	FreeTraceSlots.Push(this);
+}
+
+void FAsyncTraceSlot::ReceiveResult(const FTraceHandle&, FTraceDatum& Datum)
+{
+	if (Datum.UserData != Generation)
+		return; // The awaiter that requested this is gone
+	if (Store)
+		(*Store)(Out, Datum.OutHits);
+	else if (Datum.OutHits.Num() > 0)
+		Hit.Emplace(std::move(Datum.OutHits[0]));
+	bDone = true;
+
+	// If the coroutine is suspended (Promise is valid), resume it now
+	if (Promise)
+		std::exchange(Promise, nullptr)->Resume();
+}
+
+FAsyncTraceSlotAwaiter::FAsyncTraceSlotAwaiter(
+	const UObject* WorldContextObject, EAsyncTraceType InTraceType,
+	const FVector& Start, const FVector& End, ECollisionChannel TraceChannel,
+	const FCollisionQueryParams& Params,
+	const FCollisionResponseParams& ResponseParam, void* Out,
+	void (*Store)(void*, TArray<FHitResult>&))
+	: Slot(FAsyncTraceSlot::Acquire())
+{
+	Slot->Out = Out;
+	Slot->Store = Store;
+	auto* World = GEngine->GetWorldFromContextObjectChecked(WorldContextObject);
+	World->AsyncLineTraceByChannel(InTraceType, Start, End, TraceChannel, Params,
+	                               ResponseParam, &Slot->Delegate,
+	                               Slot->Generation);
+}
+
+FAsyncTraceSlotAwaiter::FAsyncTraceSlotAwaiter(
+	FAsyncTraceSlotAwaiter&& Other) noexcept
+	: Slot(std::exchange(Other.Slot, nullptr))
+{
+}
+
+FAsyncTraceSlotAwaiter::~FAsyncTraceSlotAwaiter()
+{
+	if (Slot)
+		Slot->Release();
+}
+
+bool FAsyncTraceSlotAwaiter::await_ready()
+{
+	checkf(IsInGameThread(),
+	       TEXT("Async queries may only be awaited on the game thread."));
+	checkf(Slot, TEXT("Attempting to use invalid awaiter"));
+	return Slot->bDone;
+}
+
+void FAsyncTraceSlotAwaiter::Suspend(FPromise& Promise)
+{
+	checkf(IsInGameThread(),
+	       TEXT("Async queries may only be awaited on the game thread."));
+	checkf(!Slot->Promise, TEXT("Attempted second concurrent co_await"));
+	Slot->Promise = &Promise;
+}
+
+FAsyncSingleTraceAwaiter::FAsyncSingleTraceAwaiter(
+	const UObject* WorldContextObject, const FVector& Start, const FVector& End,
+	ECollisionChannel TraceChannel, const FCollisionQueryParams& Params,
+	const FCollisionResponseParams& ResponseParam)
+	: FAsyncTraceSlotAwaiter(WorldContextObject, EAsyncTraceType::Single, Start,
+	                         End, TraceChannel, Params, ResponseParam, nullptr,
+	                         nullptr)
+{
+}
+
+TOptional<FHitResult> FAsyncSingleTraceAwaiter::await_resume()
+{
+	checkf(IsInGameThread(),
+	       TEXT("Internal error: expected to resume on the game thread"));
+	checkf(Slot->bDone,
+	       TEXT("Internal error: resuming without a query result"));
+	return std::move(Slot->Hit);
+}
+
+FAsyncSingleTraceAwaiter Latent::AsyncLineTraceSingleByChannel(
+	const UObject* WorldContextObject, const FVector& Start, const FVector& End,
+	ECollisionChannel TraceChannel, const FCollisionQueryParams& Params,
+	const FCollisionResponseParams& ResponseParam)
+{
+	return FAsyncSingleTraceAwaiter(WorldContextObject, Start, End,
+	                                TraceChannel, Params, ResponseParam);
+}
+
+namespace UE5Coro::Private
+{
+struct FAsyncTraceBatchState
+{
+	FPromise* Promise = nullptr;
+	TArray<TArray<FHitResult>> PerTrace;
+	int32 NumPending = 0;
+	bool bDone = false;
+	Latent::FTraceBatchResults Results;
+
+	void ReceiveResult(const FTraceHandle&, FTraceDatum& Datum)
+	{
+		PerTrace[static_cast<int32>(Datum.UserData)] = std::move(Datum.OutHits);
+		if (--NumPending == 0)
+			Finish();
+	}
+
+	void Finish()
+	{
+		// Flatten the results into one array
+		int32 NumHits = 0;
+		for (auto& Hits : PerTrace)
+			NumHits += Hits.Num();
+		Results.Hits.Reserve(NumHits);
+		Results.Offsets.Reserve(PerTrace.Num() + 1);
+		for (auto& Hits : PerTrace)
+		{
+			Results.Hits.Append(std::move(Hits));
+			Results.Offsets.Add(Results.Hits.Num());
+		}
+		PerTrace.Empty();
+		bDone = true;
+
+		// If the coroutine is suspended (Promise is valid), resume it now
+		if (Promise)
+			std::exchange(Promise, nullptr)->Resume();
+	}
+};
+}
+
+FAsyncTraceBatchAwaiter::FAsyncTraceBatchAwaiter(
+	UWorld* World, EAsyncTraceType InTraceType,
+	TArrayView<const Latent::FTraceRequest> Requests,
+	const FCollisionQueryParams& Params,
+	const FCollisionResponseParams& ResponseParam)
+	: State(MakeShared<FAsyncTraceBatchState, ESPMode::NotThreadSafe>())
+{
+	checkf(IsInGameThread(),
+	       TEXT("Async queries may only be started from the game thread."));
+	int32 Num = Requests.Num();
+	State->PerTrace.SetNum(Num);
+	State->NumPending = Num;
+	if (Num == 0)
+	{
+		State->bDone = true;
+		return;
+	}
+
+	// Every trace shares this delegate, UserData identifies them
+	auto Delegate = FTraceDelegate::CreateSP(
+		State.ToSharedRef(), &FAsyncTraceBatchState::ReceiveResult);
+	for (int32 i = 0; i < Num; ++i)
+	{
+		auto& Request = Requests[i];
+		World->AsyncLineTraceByChannel(InTraceType, Request.Start, Request.End,
+		                               Request.TraceChannel, Params,
+		                               ResponseParam, &Delegate, i);
+	}
+}
+
+bool FAsyncTraceBatchAwaiter::await_ready()
+{
+	checkf(IsInGameThread(),
+	       TEXT("Async queries may only be awaited on the game thread."));
+	return State->bDone;
+}
+
+void FAsyncTraceBatchAwaiter::Suspend(FPromise& Promise)
+{
+	checkf(IsInGameThread(),
+	       TEXT("Async queries may only be awaited on the game thread."));
+	checkf(!State->Promise, TEXT("Attempted second concurrent co_await"));
+	State->Promise = &Promise;
+}
+
+Latent::FTraceBatchResults FAsyncTraceBatchAwaiter::await_resume()
+{
+	checkf(IsInGameThread(),
+	       TEXT("Internal error: expected to resume on the game thread"));
+	checkf(State->bDone,
+	       TEXT("Internal error: resuming without a query result"));
+	return std::move(State->Results);
+}
+
+FAsyncTraceBatchAwaiter Latent::AsyncLineTraceBatch(
+	const UObject* WorldContextObject, EAsyncTraceType InTraceType,
+	TArrayView<const FTraceRequest> Requests,
+	const FCollisionQueryParams& Params,
+	const FCollisionResponseParams& ResponseParam)
+{
+	return FAsyncTraceBatchAwaiter(
+		GEngine->GetWorldFromContextObjectChecked(WorldContextObject),
+		InTraceType, Requests, Params, ResponseParam);
+}
+
 TAsyncQueryAwaiter<FHitResult> Latent::AsyncLineTraceByChannel(
 	const UObject* WorldContextObject, EAsyncTraceType InTraceType,
 	const FVector& Start, const FVector& End, ECollisionChannel TraceChannel,
@@ -243,3 +488,143 @@ TAsyncQueryAwaiter<FOverlapResult> Latent::AsyncOverlapByProfile(
 		&UWorld::AsyncOverlapByProfile, Pos, Rot, ProfileName, CollisionShape,
 		Params);
 }
+
+struct FAnyThreadTraceAwaiter::FState
+{
+	// Request parameters, only read on the game thread after submission
+	TWeakObjectPtr<const UObject> WorldContextObject;
+	EAsyncTraceType TraceType = EAsyncTraceType::Test;
+	FVector Start;
+	FVector End;
+	ECollisionChannel TraceChannel = ECC_Visibility;
+	FCollisionQueryParams Params;
+	FCollisionResponseParams ResponseParam;
+
+	FMutex Lock;
+	FPromise* Promise = nullptr;
+	ENamedThreads::Type Thread = ENamedThreads::GameThread;
+	bool bDone = false;
+	// end Lock
+	TArray<FHitResult> Result; // Written before bDone, read after it
+
+	void ReceiveResult(const FTraceHandle&, FTraceDatum& Datum)
+	{
+		Result = std::move(Datum.OutHits);
+		Complete();
+	}
+
+	void Complete()
+	{
+		checkf(IsInGameThread(),
+		       TEXT("Internal error: expected to complete on the game thread"));
+		std::unique_lock L(Lock);
+		bDone = true;
+		// Promise being nullptr indicates that the trace finished before the
+		// coroutine reached co_await
+		auto* Waiting = std::exchange(Promise, nullptr);
+		L.unlock();
+		if (!Waiting)
+			return;
+
+		// Resume inline if the coroutine is waiting on the game thread
+		if ((Thread & ThreadTypeMask) == ENamedThreads::GameThread)
+			Waiting->Resume();
+		else
+		{
+			Waiting->MarkAwaitReady();
+			AsyncTask(Waiting->WithTaskPriority(Thread),
+			          [Waiting] { Waiting->Resume(); });
+		}
+	}
+};
+
+namespace
+{
+TQueue<TSharedPtr<FAnyThreadTraceAwaiter::FState>, EQueueMode::Mpsc>
+	PendingTraces;
+
+bool FlushPendingTraces(float)
+{
+	TSharedPtr<FAnyThreadTraceAwaiter::FState> State;
+	while (PendingTraces.Dequeue(State))
+	{
+		if (State.IsUnique())
+			continue; // Nobody is interested in this trace anymore
+
+		auto* World = GEngine->GetWorldFromContextObject(
+			State->WorldContextObject.Get(), EGetWorldErrorMode::ReturnNull);
+		if (!World)
+		{
+			State->Complete(); // With an empty result
+			continue;
+		}
+
+		// If the awaiter goes away, the result will be silently dropped
+		auto Delegate = FTraceDelegate::CreateSP(
+			State.ToSharedRef(), &FAnyThreadTraceAwaiter::FState::ReceiveResult);
+		World->AsyncLineTraceByChannel(State->TraceType, State->Start,
+		                               State->End, State->TraceChannel,
+		                               State->Params, State->ResponseParam,
+		                               &Delegate);
+	}
+	return true;
+}
+}
+
+FAnyThreadTraceAwaiter::FAnyThreadTraceAwaiter(
+	const UObject* WorldContextObject, EAsyncTraceType InTraceType,
+	const FVector& Start, const FVector& End, ECollisionChannel TraceChannel,
+	const FCollisionQueryParams& Params,
+	const FCollisionResponseParams& ResponseParam)
+	: State(new FState)
+{
+	// FTSTicker is thread safe, the first submission from any thread sets up
+	// the per-frame flush
+	static FTSTicker::FDelegateHandle Ticker = FTSTicker::GetCoreTicker()
+		.AddTicker(FTickerDelegate::CreateStatic(&FlushPendingTraces));
+
+	State->WorldContextObject = WorldContextObject;
+	State->TraceType = InTraceType;
+	State->Start = Start;
+	State->End = End;
+	State->TraceChannel = TraceChannel;
+	State->Params = Params;
+	State->ResponseParam = ResponseParam;
+	PendingTraces.Enqueue(State);
+}
+
+bool FAnyThreadTraceAwaiter::await_ready()
+{
+	checkf(State, TEXT("Attempting to use invalid awaiter"));
+	std::unique_lock L(State->Lock);
+	if (State->bDone)
+		return true;
+	checkf(!State->Promise, TEXT("Attempted second concurrent co_await"));
+	L.release(); // Carry the lock into Suspend()
+	return false;
+}
+
+void FAnyThreadTraceAwaiter::Suspend(FPromise& Promise)
+{
+	// This should be locked from await_ready
+	checkf(!State->Lock.try_lock(), TEXT("Internal error: lock wasn't taken"));
+	State->Promise = &Promise;
+	State->Thread = FTaskGraphInterface::Get().GetCurrentThreadIfKnown();
+	State->Lock.unlock();
+}
+
+const TArray<FHitResult>& FAnyThreadTraceAwaiter::await_resume()
+{
+	checkf(State, TEXT("Internal error: resuming without a result"));
+	return State->Result;
+}
+
+FAnyThreadTraceAwaiter Latent::AsyncLineTraceByChannelAnyThread(
+	const UObject* WorldContextObject, EAsyncTraceType InTraceType,
+	const FVector& Start, const FVector& End, ECollisionChannel TraceChannel,
+	const FCollisionQueryParams& Params,
+	const FCollisionResponseParams& ResponseParam)
+{
+	return FAnyThreadTraceAwaiter(WorldContextObject, InTraceType, Start, End,
+	                              TraceChannel, Params, ResponseParam);
+}
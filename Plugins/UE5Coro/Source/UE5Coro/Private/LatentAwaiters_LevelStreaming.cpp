@@ -0,0 +1,260 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "UE5Coro/LatentAwaiters.h"
+#include "Engine/LevelStreaming.h"
+#include "UObject/UObjectGlobals.h"
+#include "UE5Coro/UE5CoroSubsystem.h"
+#include "UE5CoroDelegateCallbackTarget.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Private;
+
+namespace
+{
+enum class ELevelGoal : uint8
+{
+	Loaded,
+	Visible,
+	Unloaded,
+};
+
+/** Waits for one or more streaming levels to reach the same goal.<br>
+ *  Streaming levels only broadcast on the game thread, so there's no need for
+ *  synchronization or shared ownership like in FUntilDelegateState. */
+class [[nodiscard]] FLevelStreamingState
+{
+	struct FEntry
+	{
+		TWeakObjectPtr<ULevelStreaming> Level;
+		UUE5CoroDelegateCallbackTarget* Target = nullptr;
+	};
+
+	TArray<FEntry, TInlineAllocator<1>> Entries;
+	ELevelGoal Goal;
+	TWeakObjectPtr<UUE5CoroSubsystem> Subsystem;
+	FAsyncPromise* Promise = nullptr;
+	/** Destroyed levels don't broadcast, this notices them instead. */
+	FDelegateHandle GCHandle;
+
+	FMulticastScriptDelegate& GetDelegate(ULevelStreaming& Level) const
+	{
+		switch (Goal)
+		{
+			case ELevelGoal::Loaded: return Level.OnLevelLoaded;
+			case ELevelGoal::Visible: return Level.OnLevelShown;
+			default: return Level.OnLevelUnloaded;
+		}
+	}
+
+	bool IsDone(const FEntry& Entry) const
+	{
+		// Destroyed levels would never finish, don't let them block forever
+		auto* Level = Entry.Level.Get();
+		if (!Level)
+			return true;
+		switch (Goal)
+		{
+			case ELevelGoal::Loaded: return Level->IsLevelLoaded();
+			case ELevelGoal::Visible: return Level->IsLevelVisible();
+			default: return !Level->IsLevelLoaded();
+		}
+	}
+
+	bool IsReady() const
+	{
+		for (auto& Entry : Entries)
+			if (!IsDone(Entry))
+				return false;
+		return true;
+	}
+
+	static void Unbind(void* Delegate, UObject* Target)
+	{
+		if (Delegate)
+			static_cast<FMulticastScriptDelegate*>(Delegate)->Remove(Target,
+			                                                         NAME_Core);
+	}
+
+	void Release(const FEntry& Entry, UUE5CoroDelegateCallbackTarget* Target)
+	{
+		// Always unbind, so that the raw this in Target won't be called later
+		if (auto* Level = Entry.Level.Get())
+			Unbind(&GetDelegate(*Level), Target);
+		Target->Release(nullptr, &Unbind);
+	}
+
+	void Bind(int32 Index)
+	{
+		auto& Entry = Entries[Index];
+		Entry.Target = UUE5CoroDelegateCallbackTarget::Create(
+			[this, Index](void*) { OnNotified(Index); });
+		FScriptDelegate Delegate;
+		Delegate.BindUFunction(Entry.Target, NAME_Core);
+		GetDelegate(*Entry.Level).Add(Delegate);
+	}
+
+	void OnNotified(int32 Index)
+	{
+		auto& Entry = Entries[Index];
+		auto* Fired = std::exchange(Entry.Target, nullptr);
+		// Targets only fire once, keep listening if this was a false alarm.
+		// The replacement is made first to get a different pooled target.
+		if (!IsDone(Entry))
+			Bind(Index);
+		Release(Entry, Fired);
+		TryResume();
+	}
+
+	void TryResume()
+	{
+		if (Promise && IsReady())
+			if (auto* Sys = Subsystem.Get())
+				Sys->ResumeReady(*std::exchange(Promise, nullptr));
+	}
+
+public:
+	explicit FLevelStreamingState(TArrayView<ULevelStreaming* const> Levels,
+	                              ELevelGoal Goal)
+		: Goal(Goal)
+	{
+		Entries.Reserve(Levels.Num());
+		for (auto* Level : Levels)
+		{
+			checkf(IsValid(Level), TEXT("Attempting to await invalid level"));
+			Entries.Add({Level});
+		}
+		// Entries won't move from now on, their indices are safe to capture
+		for (int32 i = 0; i < Entries.Num(); ++i)
+			if (!IsDone(Entries[i]))
+				Bind(i);
+	}
+
+	~FLevelStreamingState()
+	{
+		FCoreUObjectDelegates::GetPostGarbageCollect().Remove(GCHandle);
+		for (auto& Entry : Entries)
+			if (Entry.Target)
+				Release(Entry, Entry.Target);
+	}
+
+	static bool ShouldResume(void* State, bool bCleanup)
+	{
+		auto* This = static_cast<FLevelStreamingState*>(State);
+		if (UNLIKELY(bCleanup))
+		{
+			delete This;
+			return false;
+		}
+		return This->IsReady();
+	}
+
+	static bool BindReady(void* State, UUE5CoroSubsystem& Sys,
+	                      FAsyncPromise& Promise)
+	{
+		auto* This = static_cast<FLevelStreamingState*>(State);
+		if (This->IsReady())
+			return false;
+		checkf(!This->Promise, TEXT("Attempted second concurrent co_await"));
+		This->Subsystem = &Sys;
+		This->Promise = &Promise;
+		if (!This->GCHandle.IsValid())
+			This->GCHandle = FCoreUObjectDelegates::GetPostGarbageCollect()
+				.AddRaw(This, &FLevelStreamingState::TryResume);
+		return true;
+	}
+};
+
+/** Lets the subsystem resume async coroutines from level streaming delegates
+ *  instead of polling them. */
+struct FLevelStreamingReadyCallbacks
+{
+	FLevelStreamingReadyCallbacks()
+	{
+		FLatentReadyCallback::Register(&FLevelStreamingState::ShouldResume,
+		                               &FLevelStreamingState::BindReady);
+	}
+
+	~FLevelStreamingReadyCallbacks()
+	{
+		FLatentReadyCallback::Unregister(&FLevelStreamingState::ShouldResume);
+	}
+} GLevelStreamingReadyCallbacks;
+
+FLatentAwaiter UntilLevels(TArrayView<ULevelStreaming* const> Levels,
+                           ELevelGoal Goal)
+{
+	checkf(IsInGameThread(),
+	       TEXT("Level streaming may only be awaited on the game thread"));
+	LLM_SCOPE_BYTAG(UE5Coro_AwaiterState);
+	return FLatentAwaiter(new FLevelStreamingState(Levels, Goal),
+	                      &FLevelStreamingState::ShouldResume);
+}
+}
+
+FLatentAwaiter Latent::UntilLevelLoaded(ULevelStreaming* Level)
+{
+	return UntilLevels({&Level, 1}, ELevelGoal::Loaded);
+}
+
+FLatentAwaiter Latent::UntilLevelVisible(ULevelStreaming* Level)
+{
+	return UntilLevels({&Level, 1}, ELevelGoal::Visible);
+}
+
+FLatentAwaiter Latent::UntilLevelUnloaded(ULevelStreaming* Level)
+{
+	return UntilLevels({&Level, 1}, ELevelGoal::Unloaded);
+}
+
+FLatentAwaiter Latent::UntilLevelsVisible(
+	TArrayView<ULevelStreaming* const> Levels)
+{
+	return UntilLevels(Levels, ELevelGoal::Visible);
+}
+
+FLatentAwaiter Latent::LoadStreamLevel(ULevelStreaming* Level,
+                                       bool bMakeVisibleAfterLoad)
+{
+	checkf(IsValid(Level), TEXT("Attempting to load invalid level"));
+	Level->SetShouldBeLoaded(true);
+	Level->SetShouldBeVisible(bMakeVisibleAfterLoad);
+	return bMakeVisibleAfterLoad ? UntilLevelVisible(Level)
+	                             : UntilLevelLoaded(Level);
+}
+
+FLatentAwaiter Latent::UnloadStreamLevel(ULevelStreaming* Level)
+{
+	checkf(IsValid(Level), TEXT("Attempting to unload invalid level"));
+	Level->SetShouldBeVisible(false);
+	Level->SetShouldBeLoaded(false);
+	return UntilLevelUnloaded(Level);
+}
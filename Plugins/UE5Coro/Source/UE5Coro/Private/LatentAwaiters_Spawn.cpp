@@ -0,0 +1,107 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "UE5Coro/LatentAwaiters.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "UObject/StrongObjectPtr.h"
+#include "UE5Coro/UE5CoroSubsystem.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Private;
+
+namespace
+{
+TCoroutine<TArray<AActor*>> SpawnActors(TWeakObjectPtr<UWorld> World,
+                                        TSoftClassPtr<AActor> SoftClass,
+                                        TArray<FTransform> Transforms,
+                                        double BudgetMs,
+                                        FActorSpawnParameters Params)
+{
+	// The class is only referenced by this coroutine between ticks, and the
+	// spawned actors might be destroyed before the next one
+	TArray<TWeakObjectPtr<AActor>> Actors;
+	TStrongObjectPtr<UClass> Class(SoftClass.Get());
+	if (!Class && !SoftClass.IsNull())
+		Class.Reset(co_await Latent::AsyncLoadClass(SoftClass));
+	if (!ensureMsgf(Class && Class->IsChildOf<AActor>(),
+	                TEXT("Could not load actor class %s"),
+	                *SoftClass.ToString()))
+		co_return {};
+
+	Actors.Reserve(Transforms.Num());
+	while (Actors.Num() < Transforms.Num())
+	{
+		// The subsystem counts this resumption against its budget, and defers
+		// it if there's nothing left
+		co_await Latent::NextTick();
+		auto* WorldPtr = World.Get();
+		if (!WorldPtr)
+			break;
+		auto* Sys = WorldPtr->GetSubsystem<UUE5CoroSubsystem>();
+		double End = FPlatformTime::Seconds() +
+		             FMath::Min(BudgetMs / 1000, Sys->GetResumeBudgetLeft());
+		do
+			Actors.Add(WorldPtr->SpawnActor(Class.Get(),
+			                                &Transforms[Actors.Num()], Params));
+		while (Actors.Num() < Transforms.Num() &&
+		       FPlatformTime::Seconds() < End);
+	}
+
+	// Actors that were destroyed since are reported as failed spawns
+	TArray<AActor*> Result;
+	Result.Reserve(Actors.Num());
+	for (auto& Actor : Actors)
+		Result.Add(Actor.Get());
+	co_return Result;
+}
+}
+
+TCoroutine<TArray<AActor*>> Latent::SpawnActorsAmortized(
+	UWorld* World, TSoftClassPtr<AActor> Class,
+	TArrayView<const FTransform> Transforms, double BudgetMs)
+{
+	return SpawnActorsAmortized(World, std::move(Class), Transforms, BudgetMs,
+	                            FActorSpawnParameters());
+}
+
+TCoroutine<TArray<AActor*>> Latent::SpawnActorsAmortized(
+	UWorld* World, TSoftClassPtr<AActor> Class,
+	TArrayView<const FTransform> Transforms, double BudgetMs,
+	const FActorSpawnParameters& Params)
+{
+	checkf(IsInGameThread(),
+	       TEXT("Actors may only be spawned from the game thread"));
+	checkf(IsValid(World), TEXT("Attempting to spawn into invalid world"));
+	// Everything is copied, the coroutine might outlive the caller's data
+	return SpawnActors(World, std::move(Class), TArray<FTransform>(Transforms),
+	                   BudgetMs, Params);
+}
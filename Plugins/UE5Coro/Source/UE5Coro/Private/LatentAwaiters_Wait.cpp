@@ -30,7 +30,9 @@
 // ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "UE5Coro/LatentAwaiters.h"
+#include "Async/Async.h"
 #include "Engine/World.h"
+#include "UE5Coro/UE5CoroSubsystem.h"
 #include "UE5CoroDelegateCallbackTarget.h"
 
 using namespace UE5Coro;
@@ -46,15 +48,16 @@ bool WaitUntilFrame(void* State, bool)
 template<auto GetTime>
 bool WaitUntilTime(void* State, bool bCleanup)
 {
-	// Don't attempt to access GWorld in this case, it could be nullptr
+	// Don't attempt to access the world in this case, it could be nullptr
 	if (UNLIKELY(bCleanup))
 		return false;
 
 	static_assert(sizeof(void*) >= sizeof(double),
 	              "32-bit platforms are not supported");
 	auto& TargetTime = reinterpret_cast<double&>(State);
-	checkf(GWorld, TEXT("Internal error: Latent poll outside of a world"));
-	return (GWorld->*GetTime)() >= TargetTime;
+	auto* World = GetLatentWorld();
+	checkf(World, TEXT("Internal error: Latent poll outside of a world"));
+	return (World->*GetTime)() >= TargetTime;
 }
 
 bool WaitUntilPredicate(void* State, bool bCleanup)
@@ -62,7 +65,7 @@ bool WaitUntilPredicate(void* State, bool bCleanup)
 	auto* Function = static_cast<std::function<bool()>*>(State);
 	if (UNLIKELY(bCleanup))
 	{
-		delete Function;
+		FLatentAwaiter::DestroyState<std::function<bool()>>(State);
 		return false;
 	}
 
@@ -80,13 +83,14 @@ FLatentAwaiter GenericUntil(double Time)
 #endif
 	checkf(IsInGameThread(),
 	       TEXT("Latent awaiters may only be used on the game thread"));
-	checkf(GWorld,
+	auto* World = GetLatentWorld();
+	checkf(World,
 	       TEXT("This function may only be used in the context of a world"));
 
 	if constexpr (bTimeIsOffset)
-		Time += (GWorld->*GetTime)();
+		Time += (World->*GetTime)();
 
-	ensureMsgf((GWorld->*GetTime)() <= Time,
+	ensureMsgf((World->*GetTime)() <= Time,
 	           TEXT("Latent wait will finish immediately"));
 
 	void* State = nullptr;
@@ -94,39 +98,135 @@ FLatentAwaiter GenericUntil(double Time)
 	return FLatentAwaiter(State, &WaitUntilTime<GetTime>);
 }
 
+/** One allocation shared by the awaiter and its callback target.<br>
+ *  The delegate might execute on any thread, but the awaiter and the
+ *  subsystem binding are only used on the game thread. */
 class [[nodiscard]] FUntilDelegateState
-	: public std::enable_shared_from_this<FUntilDelegateState>
 {
-	TStrongObjectPtr<UUE5CoroDelegateCallbackTarget> Target;
-	// This object is on the game thread, but the delegate might not be
+	UUE5CoroDelegateCallbackTarget* Target = nullptr;
+	void* Delegate;
+	void (*Unbind)(void*, UObject*);
+	std::atomic<int> RefCount = 1; // The awaiter's reference
 	std::atomic<bool> bExecuted = false;
+	TWeakObjectPtr<UUE5CoroSubsystem> Subsystem;
+	FAsyncPromise* Promise = nullptr;
+
+	/** Owning reference held by the callback target's function. */
+	class [[nodiscard]] FRef
+	{
+		FUntilDelegateState* Ptr;
+
+	public:
+		explicit FRef(FUntilDelegateState* Ptr) noexcept : Ptr(Ptr)
+		{
+			Ptr->RefCount.fetch_add(1, std::memory_order_relaxed);
+		}
+		FRef(FRef&& Other) noexcept : Ptr(std::exchange(Other.Ptr, nullptr)) { }
+		FRef(const FRef&) = delete;
+		FRef& operator=(const FRef&) = delete;
+		~FRef()
+		{
+			if (Ptr)
+				Ptr->Release();
+		}
+		FUntilDelegateState* operator->() const noexcept { return Ptr; }
+	};
+
+	void Release() noexcept
+	{
+		if (RefCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			delete this;
+	}
+
+	void NotifyOnGameThread()
+	{
+		checkf(IsInGameThread(),
+		       TEXT("Internal error: expected notification on the game thread"));
+		if (auto* Sys = Subsystem.Get(); Sys && Promise)
+			Sys->ResumeReady(*std::exchange(Promise, nullptr));
+	}
 
 public:
-	explicit FUntilDelegateState(UUE5CoroDelegateCallbackTarget* Target)
-		: Target(Target) { }
+	explicit FUntilDelegateState(void* Delegate,
+	                             void (*Unbind)(void*, UObject*))
+		: Delegate(Delegate), Unbind(Unbind) { }
 
-	void Init()
+	UUE5CoroDelegateCallbackTarget* Init()
 	{
-		Target->Init([Weak = weak_from_this()](void*)
-		{
-			if (auto Strong = Weak.lock())
-				Strong->bExecuted = true;
-		});
+		return Target = UUE5CoroDelegateCallbackTarget::Create(
+			[Ref = FRef(this)](void*) mutable
+			{
+				Ref->bExecuted = true;
+				if (IsInGameThread())
+					Ref->NotifyOnGameThread();
+				else
+					AsyncTask(ENamedThreads::GameThread,
+					          [Ref = std::move(Ref)]
+					          {
+						          Ref->NotifyOnGameThread();
+					          });
+			});
 	}
 
 	static bool ShouldResume(void* State, bool bCleanup)
 	{
-		auto& This = *static_cast<std::shared_ptr<FUntilDelegateState>*>(State);
+		auto* This = static_cast<FUntilDelegateState*>(State);
 		if (UNLIKELY(bCleanup))
 		{
-			if (This->Target.IsValid())
-				This->Target->MarkAsGarbage();
-			delete &This;
+			This->Promise = nullptr;
+			This->Target->Release(This->Delegate, This->Unbind);
+			This->Release();
 			return false;
 		}
 		return This->bExecuted;
 	}
+
+	static bool BindReady(void* State, UUE5CoroSubsystem& Sys,
+	                      FAsyncPromise& Promise)
+	{
+		auto* This = static_cast<FUntilDelegateState*>(State);
+		// A notification from another thread might have already been missed
+		if (This->bExecuted)
+			return false;
+		checkf(!This->Promise, TEXT("Attempted second concurrent co_await"));
+		This->Subsystem = &Sys;
+		This->Promise = &Promise;
+		return true;
+	}
 };
+
+/** Lets the subsystem resume async coroutines from delegate callbacks instead
+ *  of polling them. */
+struct FWaitReadyCallbacks
+{
+	FWaitReadyCallbacks()
+	{
+		FLatentReadyCallback::Register(&FUntilDelegateState::ShouldResume,
+		                               &FUntilDelegateState::BindReady);
+	}
+
+	~FWaitReadyCallbacks()
+	{
+		FLatentReadyCallback::Unregister(&FUntilDelegateState::ShouldResume);
+	}
+} GWaitReadyCallbacks;
+}
+
+FLatentDeadline FLatentDeadline::Of(const FLatentAwaiter& Awaiter)
+{
+	auto TimeOf = [&] { return reinterpret_cast<const double&>(Awaiter.State); };
+	if (Awaiter.Resume == &WaitUntilFrame)
+		return {static_cast<double>(reinterpret_cast<uint64>(Awaiter.State)),
+		        FrameCounter};
+	if (Awaiter.Resume == &WaitUntilTime<&UWorld::GetTimeSeconds>)
+		return {TimeOf(), GameTime};
+	if (Awaiter.Resume == &WaitUntilTime<&UWorld::GetUnpausedTimeSeconds>)
+		return {TimeOf(), UnpausedTime};
+	if (Awaiter.Resume == &WaitUntilTime<&UWorld::GetRealTimeSeconds>)
+		return {TimeOf(), RealTime};
+	if (Awaiter.Resume == &WaitUntilTime<&UWorld::GetAudioTimeSeconds>)
+		return {TimeOf(), AudioTime};
+	return {};
 }
 
 FLatentAwaiter Latent::NextTick()
@@ -143,21 +243,64 @@ FLatentAwaiter Latent::Ticks(int64 Ticks)
 	return FLatentAwaiter(reinterpret_cast<void*>(Target), &WaitUntilFrame);
 }
 
+FTickGroupAwaiter Latent::NextTick(ETickingGroup Group)
+{
+	return FTickGroupAwaiter(Group);
+}
+
+FTickGroupAwaiter::~FTickGroupAwaiter()
+{
+	// Only set while suspended, e.g., if a latent coroutine was destroyed
+	if (UNLIKELY(Subsystem))
+		Subsystem->RemoveTickGroupAwaiter(*this);
+}
+
+void FTickGroupAwaiter::Suspend(FPromise& InPromise)
+{
+	checkf(IsInGameThread(),
+	       TEXT("Latent awaiters may only be used on the game thread"));
+	auto* World = GetLatentWorld();
+	checkf(World,
+	       TEXT("Awaiting this can only be done in the context of a world"));
+	checkf(!Promise, TEXT("Internal error: double suspension"));
+	Promise = &InPromise;
+	Subsystem = World->GetSubsystem<UUE5CoroSubsystem>();
+	Subsystem->AddTickGroupAwaiter(*this);
+}
+
 FLatentAwaiter Latent::Until(std::function<bool()> Function)
 {
 	checkf(Function, TEXT("Provided function is empty"));
-	return FLatentAwaiter(new std::function(std::move(Function)),
-	                      &WaitUntilPredicate);
+	return FLatentAwaiter(std::in_place_type<std::function<bool()>>,
+	                      &WaitUntilPredicate, std::move(Function));
+}
+
+double Private::GameTimeAfter(double Seconds)
+{
+	checkf(IsInGameThread(),
+	       TEXT("Latent awaiters may only be used on the game thread"));
+	auto* World = GetLatentWorld();
+	checkf(World,
+	       TEXT("This function may only be used in the context of a world"));
+	return World->GetTimeSeconds() + Seconds;
+}
+
+bool Private::IsGameTimePast(double Time)
+{
+	auto* World = GetLatentWorld();
+	checkf(World, TEXT("Internal error: Latent poll outside of a world"));
+	return World->GetTimeSeconds() >= Time;
 }
 
-std::tuple<FLatentAwaiter, UObject*> Private::UntilDelegateCore()
+std::tuple<FLatentAwaiter, UObject*> Private::UntilDelegateCore(
+	void* Delegate, void (*Unbind)(void*, UObject*))
 {
 	checkf(IsInGameThread(), TEXT("")
 	       "Awaiting delegates this way is only available on the game thread. "
 	       "co_awaiting delegates directly works on any thread.");
-	auto* Target = NewObject<UUE5CoroDelegateCallbackTarget>();
-	auto* State = new auto(std::make_shared<FUntilDelegateState>(Target));
-	(*State)->Init();
+	LLM_SCOPE_BYTAG(UE5Coro_AwaiterState);
+	auto* State = new FUntilDelegateState(Delegate, Unbind);
+	auto* Target = State->Init();
 	return {FLatentAwaiter(State, &FUntilDelegateState::ShouldResume), Target};
 }
 
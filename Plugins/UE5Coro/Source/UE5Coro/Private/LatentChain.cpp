@@ -30,31 +30,81 @@
 // ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "UE5Coro/LatentAwaiters.h"
+#include "Kismet/GameplayStatics.h"
+#include "Kismet/KismetSystemLibrary.h"
 #include "UE5Coro/UE5CoroSubsystem.h"
+#include "UE5CoroChainCallbackTarget.h"
 
 using namespace UE5Coro;
 using namespace UE5Coro::Private;
 
 std::tuple<FLatentActionInfo, FTwoLives*> Private::MakeLatentInfo()
 {
-	checkf(GWorld, TEXT("Internal error: Unguarded world access"));
-	auto* Sys = GWorld->GetSubsystem<UUE5CoroSubsystem>();
+	auto* World = GetLatentWorld();
+	checkf(World, TEXT("Internal error: Unguarded world access"));
+	auto* Sys = World->GetSubsystem<UUE5CoroSubsystem>();
 	// Will be Released by the FLatentAwaiter from the caller
-	// and UUE5CoroSubsystem on the latent action's completion.
-	auto* Done = new FTwoLives;
+	// and the callback target on the latent action's completion.
+	LLM_SCOPE_BYTAG(UE5Coro_AwaiterState);
+	auto* Done = new FChainState;
 	return {Sys->MakeLatentInfo(Done), Done};
 }
 
 FLatentChainAwaiter::FLatentChainAwaiter(FTwoLives* Done) noexcept
-	: FLatentAwaiter(Done, &FTwoLives::ShouldResume)
+	: FLatentAwaiter(Done, &FChainState::ShouldResume)
+{
+}
+
+FLatentChainAwaiter::FLatentChainAwaiter(FLatentAwaiter&& Direct) noexcept
+	: FLatentAwaiter(std::move(Direct))
 {
 }
 
 bool FLatentChainAwaiter::await_resume()
 {
+	if (Resume != &FChainState::ShouldResume) // Direct
+		return true;
 	// This function being called implies that there's a reference on State.
 	const int& UserData = static_cast<FTwoLives*>(State)->UserData;
 	checkf(UserData == 0 || UserData == 1, TEXT("Unexpected user data"));
 	// Core() sets this, otherwise it's 0. This is the only usage currently.
 	return UserData == 1;
 }
+
+TOptional<FLatentChainAwaiter> Private::ChainDirect(FChainDelay Function,
+                                                    float Duration)
+{
+	if (Function != &UKismetSystemLibrary::Delay)
+		return {};
+	return FLatentChainAwaiter(Latent::Seconds(Duration));
+}
+
+TOptional<FLatentChainAwaiter> Private::ChainDirect(
+	FChainLoadStreamLevel Function, FName LevelName,
+	bool bMakeVisibleAfterLoad, bool bShouldBlockOnLoad)
+{
+	// Blocking loads are left to the engine
+	if (Function != &UGameplayStatics::LoadStreamLevel || bShouldBlockOnLoad)
+		return {};
+	// So are levels that don't exist, it reports them
+	auto* Level = UGameplayStatics::GetStreamingLevel(GetLatentWorld(),
+	                                                  LevelName);
+	if (!Level)
+		return {};
+	return FLatentChainAwaiter(Latent::LoadStreamLevel(Level,
+	                                                   bMakeVisibleAfterLoad));
+}
+
+TOptional<FLatentChainAwaiter> Private::ChainDirect(
+	FChainUnloadStreamLevel Function, FName LevelName,
+	bool bShouldBlockOnUnload)
+{
+	if (Function != &UGameplayStatics::UnloadStreamLevel ||
+	    bShouldBlockOnUnload)
+		return {};
+	auto* Level = UGameplayStatics::GetStreamingLevel(GetLatentWorld(),
+	                                                  LevelName);
+	if (!Level)
+		return {};
+	return FLatentChainAwaiter(Latent::UnloadStreamLevel(Level));
+}
@@ -35,6 +35,7 @@
 #include "UE5Coro/AsyncAwaiters.h"
 #include "UE5Coro/AsyncCoroutine.h"
 #include "UE5Coro/LatentAwaiters.h"
+#include "UE5Coro/UE5CoroSubsystem.h"
 
 using namespace UE5Coro::Private;
 
@@ -50,6 +51,37 @@ class [[nodiscard]] FPendingLatentCoroutine final : public FPendingLatentAction
 	bool bTriggerLink = false;
 	FLatentActionInfo LatentInfo;
 	FLatentAwaiter* CurrentAwaiter = nullptr;
+	TWeakObjectPtr<UUE5CoroSubsystem> Subsystem;
+	// The latent action manager only updates this while Owner is alive
+	const UObject* Owner = nullptr;
+	float SincePoll = 0;
+
+	bool IsPollDue(FLatentPromise& LatentPromise, float DeltaTime)
+	{
+		float Interval = LatentPromise.GetPollInterval();
+		if (auto* Sys = Subsystem.Get())
+		{
+			float ForObject = Sys->GetPollInterval(Owner);
+			Interval = FMath::Max(Interval, ForObject);
+		}
+		if (Interval <= 0)
+			return true;
+		SincePoll += DeltaTime;
+		if (SincePoll < Interval)
+			return false;
+		SincePoll = 0;
+		return true;
+	}
+
+	bool HasResumeBudget(FLatentPromise& LatentPromise)
+	{
+		auto* Sys = Subsystem.Get();
+		if (!Sys || Sys->HasResumeBudget(LatentPromise.GetResumePriority()))
+			return true;
+		// Don't even poll, some awaiters only report being ready once
+		Sys->SkipPoll();
+		return false;
+	}
 
 public:
 	explicit FPendingLatentCoroutine(std::shared_ptr<FPromiseExtras> Extras,
@@ -83,11 +115,26 @@ public:
 			return;
 		}
 
-		if (CurrentAwaiter && CurrentAwaiter->ShouldResume())
+		// Detached coroutines have nothing to do here until they reattach,
+		// which happens before they can complete or await something latent
+		if (!CurrentAwaiter && !LatentPromise->IsOnGameThread())
+			return;
+
+		// Poll in this action's world, which might not be GWorld
+		FLatentWorldScope _(Owner ? Owner->GetWorld() : nullptr);
+
+		// Off frames skip polling, but still process completion and
+		// cancellation below
+		if (CurrentAwaiter &&
+		    IsPollDue(*LatentPromise, Response.ElapsedTime()) &&
+		    HasResumeBudget(*LatentPromise) && CurrentAwaiter->ShouldResume())
 		{
 			CurrentAwaiter = nullptr;
+			double Start = FPlatformTime::Seconds();
 			// This might set the awaiter for next time
 			LatentPromise->Resume();
+			if (auto* Sys = Subsystem.Get())
+				Sys->ChargeResumeBudget(FPlatformTime::Seconds() - Start);
 		}
 
 		// Resume() might have deleted LatentPromise, check it again
@@ -130,6 +177,9 @@ public:
 
 	const FLatentActionInfo& GetLatentInfo() const { return LatentInfo; }
 
+	void SetSubsystem(UUE5CoroSubsystem* Sys) { Subsystem = Sys; }
+	void SetOwner(const UObject* Object) { Owner = Object; }
+
 	void RequestLink() { bTriggerLink = true; }
 
 	void FinishNow(FLatentResponse& Response)
@@ -172,6 +222,7 @@ void FLatentPromise::CreateLatentAction(FLatentActionInfo&& LatentInfo)
 	checkf(!PendingLatentCoroutine,
 	       TEXT("Internal error: multiple latent infos were not prevented"));
 
+	LLM_SCOPE_BYTAG(UE5Coro_LatentActions);
 	PendingLatentCoroutine = new FPendingLatentCoroutine(Extras, LatentInfo);
 }
 
@@ -325,6 +376,9 @@ FInitialSuspend FLatentPromise::initial_suspend()
 	// These will usually be the same object for latent UFUNCTIONs, but
 	// FForceLatentCoroutine uses UUE5CoroSubsystem as a helper callback target.
 	LAM.AddNewAction(Owner, LatentInfo.UUID, Pending);
+	Pending->SetSubsystem(Owner->GetWorld()->GetSubsystem<UUE5CoroSubsystem>());
+	Pending->SetOwner(Owner);
+	SetHomeWorld(Owner->GetWorld());
 
 	// Let the coroutine start immediately on its calling thread
 	return {FInitialSuspend::Resume};
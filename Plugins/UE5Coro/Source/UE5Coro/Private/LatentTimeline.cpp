@@ -30,19 +30,322 @@
 // ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "UE5Coro/LatentTimeline.h"
+#include "Curves/CurveFloat.h"
 #include "UE5Coro/Coroutine.h"
 #include "UE5Coro/LatentAwaiters.h"
 
 using namespace UE5Coro;
 using namespace UE5Coro::Latent;
+using namespace UE5Coro::Private;
 
 namespace
 {
+using FGetTime = decltype(&UWorld::GetTimeSeconds);
+
+// Stored instead of an EEasingFunc if the timeline uses a curve
+constexpr uint8 CurveEasing = 0xFF;
+
+/** Where a timeline's values go. Lives in the timeline coroutine's frame. */
+struct FTimelineOutput
+{
+	enum EKind : uint8
+	{
+		Function,
+		Float,
+		Double,
+		Vector,
+		LinearColor,
+	} Kind = Function;
+	bool bInObject = false; // Target points into Object
+	std::function<void(double)> Fn;
+	void* Target = nullptr;
+	TWeakObjectPtr<UObject> Object;
+	// Used by Vector and LinearColor, the scalar values are used by the others
+	FVector4 From4;
+	FVector4 To4;
+
+	void Write(double Value, double Alpha)
+	{
+		if (bInObject && !Object.IsValid())
+			return;
+		switch (Kind)
+		{
+			case Function:
+				Fn(Value);
+				break;
+			case Float:
+				*static_cast<float*>(Target) = static_cast<float>(Value);
+				break;
+			case Double:
+				*static_cast<double*>(Target) = Value;
+				break;
+			case Vector:
+				*static_cast<FVector*>(Target) =
+					FVector(From4 + (To4 - From4) * Alpha);
+				break;
+			case LinearColor:
+				*static_cast<FLinearColor*>(Target) =
+					FLinearColor(From4 + (To4 - From4) * Alpha);
+				break;
+		}
+	}
+};
+
+double Ease(uint8 Function, double BlendExp, int32 Steps,
+            const UCurveFloat* Curve, double Alpha)
+{
+	if (Function == CurveEasing)
+		return Curve ? Curve->GetFloatValue(static_cast<float>(Alpha)) : Alpha;
+	return UKismetMathLibrary::Ease(0, 1, Alpha,
+	                                static_cast<EEasingFunc::Type>(Function),
+	                                BlendExp, Steps);
+}
+
+uint8 EasingOf(const FTimelineEasing& Easing)
+{
+	return Easing.Curve.IsExplicitlyNull() ? static_cast<uint8>(Easing.Function)
+	                                       : CurveEasing;
+}
+
+/** Evaluates every timeline of a world and time domain in a single pass.<br>
+ *  Timelines are stored as a structure of arrays, and their coroutines are
+ *  only resumed when they finish. Game thread only. */
+class FTimelineManager
+{
+	struct FBatch
+	{
+		UWorld* World;
+		FGetTime GetTime;
+		uint64 LastFrame = 0;
+		bool bEvaluating = false;
+		bool bNeedsCompaction = false;
+
+		// Dense, indexed by each ticket's Index
+		TArray<double> From;
+		TArray<double> To;
+		TArray<double> Length;
+		TArray<double> Start;
+		TArray<uint8> Easing;
+		TArray<double> BlendExp;
+		TArray<int32> Steps;
+		TArray<TWeakObjectPtr<const UCurveFloat>> Curve;
+		TArray<bool> bRunWhenPaused;
+		TArray<uint64> FirstFrame;
+		TArray<int32> Ticket; // INDEX_NONE if removed during evaluation
+
+		// Scratch space for Evaluate
+		TArray<double> Alpha;
+		TArray<double> Value;
+		TArray<bool> bDone;
+
+		int32 Num() const { return Ticket.Num(); }
+	};
+
+	struct FTicket
+	{
+		FBatch* Batch;
+		int32 Index;
+		bool bFinished;
+		// Owned by the suspended coroutine's frame, this is not relocatable
+		FTimelineOutput* Output;
+	};
+
+	TArray<TUniquePtr<FBatch>> Batches;
+	TSparseArray<FTicket> Tickets;
+
+	FBatch& GetBatch(UWorld* World, FGetTime GetTime)
+	{
+		for (auto& Batch : Batches)
+			if (Batch->World == World && Batch->GetTime == GetTime)
+				return *Batch;
+		auto& Batch = Batches.Add_GetRef(MakeUnique<FBatch>());
+		Batch->World = World;
+		Batch->GetTime = GetTime;
+		return *Batch;
+	}
+
+	void RemoveAt(FBatch& Batch, int32 Index)
+	{
+		auto Remove = [&](auto& Array)
+		{
+			Array[Index] = MoveTemp(Array.Last());
+			Array.Pop();
+		};
+		Remove(Batch.From);
+		Remove(Batch.To);
+		Remove(Batch.Length);
+		Remove(Batch.Start);
+		Remove(Batch.Easing);
+		Remove(Batch.BlendExp);
+		Remove(Batch.Steps);
+		Remove(Batch.Curve);
+		Remove(Batch.bRunWhenPaused);
+		Remove(Batch.FirstFrame);
+		Remove(Batch.Ticket);
+		if (Index < Batch.Num()) // Something was moved into Index
+			Tickets[Batch.Ticket[Index]].Index = Index;
+	}
+
+	void RemoveIfEmpty(FBatch& Batch)
+	{
+		if (Batch.Num() == 0 && !Batch.bEvaluating)
+			Batches.RemoveAllSwap([&](auto& Ptr) { return Ptr.Get() == &Batch; });
+	}
+
+	void Evaluate(FBatch& Batch)
+	{
+		// How and why is the latent action manager still ticking this?
+		checkf(IsValid(Batch.World),
+		       TEXT("Internal error: timeline still running on invalid world"));
+		Batch.LastFrame = GFrameCounter;
+		Batch.bEvaluating = true;
+
+		int32 Num = Batch.Num();
+		Batch.Alpha.SetNumUninitialized(Num);
+		Batch.Value.SetNumUninitialized(Num);
+		Batch.bDone.SetNumUninitialized(Num);
+		double Now = (Batch.World->*Batch.GetTime)();
+		const double* RESTRICT From = Batch.From.GetData();
+		const double* RESTRICT To = Batch.To.GetData();
+		const double* RESTRICT Length = Batch.Length.GetData();
+		const double* RESTRICT Start = Batch.Start.GetData();
+		double* RESTRICT Alpha = Batch.Alpha.GetData();
+		double* RESTRICT Value = Batch.Value.GetData();
+		bool* RESTRICT bDone = Batch.bDone.GetData();
+		// No branches or calls, this is meant to be vectorized
+		for (int32 i = 0; i < Num; ++i)
+		{
+			// Make sure the last call is exactly at Length
+			double Time = FMath::Min(Now - Start[i], Length[i]);
+			Alpha[i] = Time / Length[i];
+			bDone[i] = Time == Length[i]; // This hard == will work due to Min()
+		}
+
+		// Easing is kept out of the loops above and below so that they remain
+		// vectorizable. Linear timelines skip this entirely.
+		for (int32 i = 0; i < Num; ++i)
+			if (uint8 Easing = Batch.Easing[i]; Easing != EEasingFunc::Linear)
+				Alpha[i] = Ease(Easing, Batch.BlendExp[i], Batch.Steps[i],
+				                Batch.Curve[i].Get(), Alpha[i]);
+
+		for (int32 i = 0; i < Num; ++i)
+			Value[i] = FMath::Lerp(From[i], To[i], Alpha[i]);
+
+		// Callbacks may start or cancel timelines, including in this batch.
+		// New ones are past Num and their first call already happened.
+		bool bPaused = Batch.World->IsPaused();
+		for (int32 i = 0; i < Num; ++i)
+		{
+			int32 TicketIndex = Batch.Ticket[i];
+			if (TicketIndex == INDEX_NONE || Batch.FirstFrame[i] == GFrameCounter)
+				continue;
+			// If the world is paused, only evaluate the function if asked.
+			if (!Batch.bRunWhenPaused[i] && bPaused)
+				continue;
+#if ENABLE_NAN_DIAGNOSTIC
+			// Incredibly high Time values could cause this to go wrong
+			if (UNLIKELY(!FMath::IsFinite(Batch.Value[i])))
+			{
+				logOrEnsureNanError(TEXT("Latent timeline derailed"));
+			}
+#endif
+			Tickets[TicketIndex].Output->Write(Batch.Value[i], Batch.Alpha[i]);
+			// The callback might've canceled its own timeline
+			if (Batch.bDone[i] && Batch.Ticket[i] != INDEX_NONE)
+			{
+				auto& Ticket = Tickets[TicketIndex];
+				Ticket.bFinished = true;
+				Ticket.Batch = nullptr;
+				Batch.Ticket[i] = INDEX_NONE;
+				Batch.bNeedsCompaction = true;
+			}
+		}
+
+		// Entries are swapped in from the end, go backwards
+		if (std::exchange(Batch.bNeedsCompaction, false))
+			for (int32 i = Batch.Num() - 1; i >= 0; --i)
+				if (Batch.Ticket[i] == INDEX_NONE)
+					RemoveAt(Batch, i);
+		Batch.bEvaluating = false;
+		RemoveIfEmpty(Batch);
+	}
+
+public:
+	static FTimelineManager& Get()
+	{
+		checkf(IsInGameThread(),
+		       TEXT("Internal error: timeline manager used outside GT"));
+		static FTimelineManager Manager;
+		return Manager;
+	}
+
+	int32 Add(UWorld* World, FGetTime GetTime, double From, double To,
+	          double Length, double Start, const FTimelineEasing& Easing,
+	          FTimelineOutput& Output, bool bRunWhenPaused)
+	{
+		auto& Batch = GetBatch(World, GetTime);
+		int32 TicketIndex = Tickets.Add({&Batch, Batch.Num(), false, &Output});
+		Batch.From.Add(From);
+		Batch.To.Add(To);
+		Batch.Length.Add(Length);
+		Batch.Start.Add(Start);
+		Batch.Easing.Add(EasingOf(Easing));
+		Batch.BlendExp.Add(Easing.BlendExp);
+		Batch.Steps.Add(Easing.Steps);
+		Batch.Curve.Add(Easing.Curve);
+		Batch.bRunWhenPaused.Add(bRunWhenPaused);
+		Batch.FirstFrame.Add(GFrameCounter);
+		Batch.Ticket.Add(TicketIndex);
+		return TicketIndex;
+	}
+
+	bool Poll(int32 TicketIndex)
+	{
+		auto& Ticket = Tickets[TicketIndex];
+		if (Ticket.Batch && Ticket.Batch->LastFrame != GFrameCounter)
+			Evaluate(*Ticket.Batch);
+		return Tickets[TicketIndex].bFinished;
+	}
+
+	void Remove(int32 TicketIndex)
+	{
+		if (auto* Batch = Tickets[TicketIndex].Batch)
+		{
+			int32 Index = Tickets[TicketIndex].Index;
+			if (Batch->bEvaluating)
+			{
+				Batch->Ticket[Index] = INDEX_NONE;
+				Batch->bNeedsCompaction = true;
+			}
+			else
+			{
+				RemoveAt(*Batch, Index);
+				RemoveIfEmpty(*Batch);
+			}
+		}
+		Tickets.RemoveAt(TicketIndex);
+	}
+};
+
+bool ShouldResumeTimeline(void* State, bool bCleanup)
+{
+	// The ticket index is offset by one, State cannot be nullptr
+	int32 TicketIndex = static_cast<int32>(reinterpret_cast<UPTRINT>(State)) - 1;
+	auto& Manager = FTimelineManager::Get();
+	if (UNLIKELY(bCleanup))
+	{
+		Manager.Remove(TicketIndex);
+		return false;
+	}
+	return Manager.Poll(TicketIndex);
+}
+
 // Force to latent, otherwise it would keep running even after the world is gone.
 template<auto GetTime>
 TCoroutine<> CommonTimeline(const UObject* WCO, double From, double To,
-                            double Length, std::function<void(double)> Fn,
-                            bool bRunWhenPaused, FForceLatentCoroutine = {})
+                            double Length, FTimelineEasing Easing,
+                            FTimelineOutput Output, bool bRunWhenPaused,
+                            FForceLatentCoroutine = {})
 {
 #if ENABLE_NAN_DIAGNOSTIC
 	if (FMath::IsNaN(From) || FMath::IsNaN(To) || FMath::IsNaN(Length))
@@ -65,41 +368,117 @@ TCoroutine<> CommonTimeline(const UObject* WCO, double From, double To,
 	       TEXT("Latent timeline started without valid world"));
 	auto* World = WCO->GetWorld();
 
+	// The first call is at Time == 0, which cannot be Length
 	double Start = (World->*GetTime)();
-	for (;;)
+	if (bRunWhenPaused || !World->IsPaused())
 	{
-		// Make sure the last call is exactly at Length
-		double Time = FMath::Min((World->*GetTime)() - Start, Length);
-		// If the world is paused, only evaluate the function if asked.
-		if (bRunWhenPaused || !World->IsPaused())
+		double Alpha = Ease(EasingOf(Easing), Easing.BlendExp, Easing.Steps,
+		                    Easing.Curve.Get(), 0);
+		Output.Write(FMath::Lerp(From, To, Alpha), Alpha);
+	}
+
+	// Every following call is made by the manager, which only resumes this
+	// coroutine once it's done
+	int32 TicketIndex = FTimelineManager::Get().Add(
+		World, GetTime, From, To, Length, Start, Easing, Output,
+		bRunWhenPaused);
+	co_await FLatentAwaiter(reinterpret_cast<void*>(
+		static_cast<UPTRINT>(TicketIndex + 1)), &ShouldResumeTimeline);
+}
+
+template<auto GetTime>
+TCoroutine<> FunctionTimeline(const UObject* WCO, double From, double To,
+                              double Length, FTimelineEasing Easing,
+                              std::function<void(double)> Fn,
+                              bool bRunWhenPaused)
+{
+	FTimelineOutput Output;
+	Output.Fn = std::move(Fn);
+	return CommonTimeline<GetTime>(WCO, From, To, Length, std::move(Easing),
+	                               std::move(Output), bRunWhenPaused);
+}
+
+template<typename T>
+constexpr auto KindOf = std::is_same_v<T, float>  ? FTimelineOutput::Float
+                      : std::is_same_v<T, double> ? FTimelineOutput::Double
+                      : std::is_same_v<T, FVector> ? FTimelineOutput::Vector
+                                                   : FTimelineOutput::LinearColor;
+
+template<auto GetTime, typename T>
+TCoroutine<> TypedTimeline(const UObject* WCO, void* Target, UObject* Object,
+                           const T& From, const T& To, double Length,
+                           FTimelineEasing Easing, bool bRunWhenPaused)
+{
+	static_assert(std::is_same_v<T, float> || std::is_same_v<T, double> ||
+	              std::is_same_v<T, FVector> || std::is_same_v<T, FLinearColor>,
+	              "Unsupported timeline type");
+	FTimelineOutput Output;
+	Output.Kind = KindOf<T>;
+	Output.Target = Target;
+	Output.bInObject = Object != nullptr;
+	Output.Object = Object;
+	if constexpr (std::is_arithmetic_v<T>)
+		return CommonTimeline<GetTime>(WCO, From, To, Length,
+		                               std::move(Easing), std::move(Output),
+		                               bRunWhenPaused);
+	else
+	{
+		// The scalar part of the timeline is only used for its alpha
+		if constexpr (std::is_same_v<T, FVector>)
 		{
-			double Value = FMath::Lerp(From, To, Time / Length);
-#if ENABLE_NAN_DIAGNOSTIC
-			// Incredibly high Time values could cause this to go wrong
-			if (UNLIKELY(!FMath::IsFinite(Value)))
-			{
-				logOrEnsureNanError(TEXT("Latent timeline derailed"));
-			}
-#endif
-			Fn(Value);
-			if (Time == Length) // This hard == will work due to Min()
-				co_return;
+			Output.From4 = FVector4(From, 0);
+			Output.To4 = FVector4(To, 0);
+		}
+		else
+		{
+			Output.From4 = FVector4(From);
+			Output.To4 = FVector4(To);
 		}
-		co_await NextTick();
+		return CommonTimeline<GetTime>(WCO, 0, 1, Length, std::move(Easing),
+		                               std::move(Output), bRunWhenPaused);
+	}
+}
 
-		// How and why is the latent action manager still ticking this?
-		checkf(IsValid(World),
-		       TEXT("Internal error: timeline still running on invalid world"));
+template<typename T>
+bool IsPropertyOfType(const FProperty* Property)
+{
+	if constexpr (std::is_same_v<T, float>)
+		return Property->IsA<FFloatProperty>();
+	else if constexpr (std::is_same_v<T, double>)
+		return Property->IsA<FDoubleProperty>();
+	else
+	{
+		auto* StructProperty = CastField<FStructProperty>(Property);
+		return StructProperty &&
+		       StructProperty->Struct == TBaseStructure<T>::Get();
 	}
 }
+
+template<auto GetTime, typename T>
+TCoroutine<> PropertyTimeline(const UObject* WCO, UObject* Object,
+                              FName PropertyName, const T& From, const T& To,
+                              double Length, FTimelineEasing Easing,
+                              bool bRunWhenPaused)
+{
+	checkf(IsValid(Object), TEXT("Attempting to animate invalid object"));
+	auto* Property = FindFProperty<FProperty>(Object->GetClass(), PropertyName);
+	checkf(Property, TEXT("Property %s not found on %s"),
+	       *PropertyName.ToString(), *Object->GetName());
+	checkf(IsPropertyOfType<T>(Property),
+	       TEXT("Property %s does not match the timeline's type"),
+	       *PropertyName.ToString());
+	return TypedTimeline<GetTime, T>(
+		WCO, Property->ContainerPtrToValuePtr<void>(Object), Object, From, To,
+		Length, std::move(Easing), bRunWhenPaused);
+}
 }
 
 TCoroutine<> Latent::Timeline(const UObject* WCO, double From, double To,
                               double Length, std::function<void(double)> Fn,
                               bool bRunWhenPaused)
 {
-	return CommonTimeline<&UWorld::GetTimeSeconds>(
-		WCO, From, To, Length, std::move(Fn), bRunWhenPaused);
+	return FunctionTimeline<&UWorld::GetTimeSeconds>(
+		WCO, From, To, Length, {}, std::move(Fn), bRunWhenPaused);
 }
 
 TCoroutine<> Latent::UnpausedTimeline(const UObject* WCO, double From,
@@ -107,22 +486,176 @@ TCoroutine<> Latent::UnpausedTimeline(const UObject* WCO, double From,
                                       std::function<void(double)> Fn,
                                       bool bRunWhenPaused)
 {
-	return CommonTimeline<&UWorld::GetUnpausedTimeSeconds>(
-		WCO, From, To, Length, std::move(Fn), bRunWhenPaused);
+	return FunctionTimeline<&UWorld::GetUnpausedTimeSeconds>(
+		WCO, From, To, Length, {}, std::move(Fn), bRunWhenPaused);
 }
 
 TCoroutine<> Latent::RealTimeline(const UObject* WCO, double From, double To,
                                   double Length, std::function<void(double)> Fn,
                                   bool bRunWhenPaused)
 {
-	return CommonTimeline<&UWorld::GetRealTimeSeconds>(
-		WCO, From, To, Length, std::move(Fn), bRunWhenPaused);
+	return FunctionTimeline<&UWorld::GetRealTimeSeconds>(
+		WCO, From, To, Length, {}, std::move(Fn), bRunWhenPaused);
 }
 
 TCoroutine<> Latent::AudioTimeline(const UObject* WCO, double From, double To,
                                    double Length, std::function<void(double)> Fn,
                                    bool bRunWhenPaused)
 {
-	return CommonTimeline<&UWorld::GetAudioTimeSeconds>(
-		WCO, From, To, Length, std::move(Fn), bRunWhenPaused);
+	return FunctionTimeline<&UWorld::GetAudioTimeSeconds>(
+		WCO, From, To, Length, {}, std::move(Fn), bRunWhenPaused);
+}
+
+TCoroutine<> Latent::Timeline(const UObject* WCO, double From, double To,
+                              double Length, FTimelineEasing Easing,
+                              std::function<void(double)> Fn,
+                              bool bRunWhenPaused)
+{
+	return FunctionTimeline<&UWorld::GetTimeSeconds>(
+		WCO, From, To, Length, std::move(Easing), std::move(Fn),
+		bRunWhenPaused);
+}
+
+TCoroutine<> Latent::UnpausedTimeline(const UObject* WCO, double From,
+                                      double To, double Length,
+                                      FTimelineEasing Easing,
+                                      std::function<void(double)> Fn,
+                                      bool bRunWhenPaused)
+{
+	return FunctionTimeline<&UWorld::GetUnpausedTimeSeconds>(
+		WCO, From, To, Length, std::move(Easing), std::move(Fn),
+		bRunWhenPaused);
+}
+
+TCoroutine<> Latent::RealTimeline(const UObject* WCO, double From, double To,
+                                  double Length, FTimelineEasing Easing,
+                                  std::function<void(double)> Fn,
+                                  bool bRunWhenPaused)
+{
+	return FunctionTimeline<&UWorld::GetRealTimeSeconds>(
+		WCO, From, To, Length, std::move(Easing), std::move(Fn),
+		bRunWhenPaused);
+}
+
+TCoroutine<> Latent::AudioTimeline(const UObject* WCO, double From, double To,
+                                   double Length, FTimelineEasing Easing,
+                                   std::function<void(double)> Fn,
+                                   bool bRunWhenPaused)
+{
+	return FunctionTimeline<&UWorld::GetAudioTimeSeconds>(
+		WCO, From, To, Length, std::move(Easing), std::move(Fn),
+		bRunWhenPaused);
+}
+
+template<typename T>
+TCoroutine<> Latent::Timeline(const UObject* WCO, T& Target, const T& From,
+                              const T& To, double Length,
+                              FTimelineEasing Easing, bool bRunWhenPaused)
+{
+	return TypedTimeline<&UWorld::GetTimeSeconds, T>(
+		WCO, &Target, nullptr, From, To, Length, std::move(Easing),
+		bRunWhenPaused);
+}
+
+template<typename T>
+TCoroutine<> Latent::UnpausedTimeline(const UObject* WCO, T& Target,
+                                      const T& From, const T& To,
+                                      double Length, FTimelineEasing Easing,
+                                      bool bRunWhenPaused)
+{
+	return TypedTimeline<&UWorld::GetUnpausedTimeSeconds, T>(
+		WCO, &Target, nullptr, From, To, Length, std::move(Easing),
+		bRunWhenPaused);
+}
+
+template<typename T>
+TCoroutine<> Latent::RealTimeline(const UObject* WCO, T& Target, const T& From,
+                                  const T& To, double Length,
+                                  FTimelineEasing Easing, bool bRunWhenPaused)
+{
+	return TypedTimeline<&UWorld::GetRealTimeSeconds, T>(
+		WCO, &Target, nullptr, From, To, Length, std::move(Easing),
+		bRunWhenPaused);
+}
+
+template<typename T>
+TCoroutine<> Latent::AudioTimeline(const UObject* WCO, T& Target, const T& From,
+                                   const T& To, double Length,
+                                   FTimelineEasing Easing, bool bRunWhenPaused)
+{
+	return TypedTimeline<&UWorld::GetAudioTimeSeconds, T>(
+		WCO, &Target, nullptr, From, To, Length, std::move(Easing),
+		bRunWhenPaused);
+}
+
+template<typename T>
+TCoroutine<> Latent::Timeline(const UObject* WCO, UObject* Object,
+                              FName PropertyName, const T& From, const T& To,
+                              double Length, FTimelineEasing Easing,
+                              bool bRunWhenPaused)
+{
+	return PropertyTimeline<&UWorld::GetTimeSeconds, T>(
+		WCO, Object, PropertyName, From, To, Length, std::move(Easing),
+		bRunWhenPaused);
+}
+
+template<typename T>
+TCoroutine<> Latent::UnpausedTimeline(const UObject* WCO, UObject* Object,
+                                      FName PropertyName, const T& From,
+                                      const T& To, double Length,
+                                      FTimelineEasing Easing,
+                                      bool bRunWhenPaused)
+{
+	return PropertyTimeline<&UWorld::GetUnpausedTimeSeconds, T>(
+		WCO, Object, PropertyName, From, To, Length, std::move(Easing),
+		bRunWhenPaused);
+}
+
+template<typename T>
+TCoroutine<> Latent::RealTimeline(const UObject* WCO, UObject* Object,
+                                  FName PropertyName, const T& From,
+                                  const T& To, double Length,
+                                  FTimelineEasing Easing, bool bRunWhenPaused)
+{
+	return PropertyTimeline<&UWorld::GetRealTimeSeconds, T>(
+		WCO, Object, PropertyName, From, To, Length, std::move(Easing),
+		bRunWhenPaused);
 }
+
+template<typename T>
+TCoroutine<> Latent::AudioTimeline(const UObject* WCO, UObject* Object,
+                                   FName PropertyName, const T& From,
+                                   const T& To, double Length,
+                                   FTimelineEasing Easing, bool bRunWhenPaused)
+{
+	return PropertyTimeline<&UWorld::GetAudioTimeSeconds, T>(
+		WCO, Object, PropertyName, From, To, Length, std::move(Easing),
+		bRunWhenPaused);
+}
+
+#define UE5CORO_INSTANTIATE_TIMELINES(T)                                       \
+	template UE5CORO_API TCoroutine<> Latent::Timeline<T>(                     \
+		const UObject*, T&, const T&, const T&, double, FTimelineEasing, bool); \
+	template UE5CORO_API TCoroutine<> Latent::UnpausedTimeline<T>(             \
+		const UObject*, T&, const T&, const T&, double, FTimelineEasing, bool); \
+	template UE5CORO_API TCoroutine<> Latent::RealTimeline<T>(                 \
+		const UObject*, T&, const T&, const T&, double, FTimelineEasing, bool); \
+	template UE5CORO_API TCoroutine<> Latent::AudioTimeline<T>(                \
+		const UObject*, T&, const T&, const T&, double, FTimelineEasing, bool); \
+	template UE5CORO_API TCoroutine<> Latent::Timeline<T>(                     \
+		const UObject*, UObject*, FName, const T&, const T&, double,           \
+		FTimelineEasing, bool);                                                \
+	template UE5CORO_API TCoroutine<> Latent::UnpausedTimeline<T>(             \
+		const UObject*, UObject*, FName, const T&, const T&, double,           \
+		FTimelineEasing, bool);                                                \
+	template UE5CORO_API TCoroutine<> Latent::RealTimeline<T>(                 \
+		const UObject*, UObject*, FName, const T&, const T&, double,           \
+		FTimelineEasing, bool);                                                \
+	template UE5CORO_API TCoroutine<> Latent::AudioTimeline<T>(                \
+		const UObject*, UObject*, FName, const T&, const T&, double,           \
+		FTimelineEasing, bool);
+UE5CORO_INSTANTIATE_TIMELINES(float)
+UE5CORO_INSTANTIATE_TIMELINES(double)
+UE5CORO_INSTANTIATE_TIMELINES(FVector)
+UE5CORO_INSTANTIATE_TIMELINES(FLinearColor)
+#undef UE5CORO_INSTANTIATE_TIMELINES
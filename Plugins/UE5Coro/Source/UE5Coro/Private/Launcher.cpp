@@ -0,0 +1,152 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "UE5Coro/AsyncAwaiters.h"
+#include "Containers/Queue.h"
+#include "UE5Coro/Threading.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Private;
+
+namespace UE5Coro::Private
+{
+struct FLauncherState : TSharedFromThis<FLauncherState>
+{
+	using FFactory = TUniqueFunction<TCoroutine<>()>;
+
+	const int32 MaxConcurrent;
+	// Every count is a slot. Owning one is a license to call Run().
+	FAwaitableSemaphore Slots;
+	FAwaitableMutex DrainLock;
+	TQueue<FFactory, EQueueMode::Mpsc> Queue;
+	FMutex PopLock; // Serializes consumers of Queue
+	std::atomic<int32> NumQueued = 0;
+	std::atomic<int32> NumRunning = 0;
+	std::atomic<bool> bShutdown = false;
+
+	explicit FLauncherState(int32 MaxConcurrent)
+		: MaxConcurrent(MaxConcurrent), Slots(MaxConcurrent, MaxConcurrent)
+	{
+	}
+
+	bool Pop(FFactory& Factory)
+	{
+		std::scoped_lock _(PopLock);
+		if (bShutdown || !Queue.Dequeue(Factory))
+			return false;
+		--NumQueued;
+		return true;
+	}
+
+	/** Expects to own one slot, which it passes on to a queued factory, or
+	 *  releases if there are none. */
+	void Run()
+	{
+		for (;;)
+		{
+			FFactory Factory;
+			if (!Pop(Factory))
+			{
+				Slots.Unlock();
+				// Something might have been queued before the slot was freed
+				if (NumQueued > 0 && Slots.TryLock())
+					continue;
+				return;
+			}
+
+			++NumRunning;
+			TCoroutine<> Coroutine = Factory();
+			// Loop instead of recursing if it finished synchronously
+			if (Coroutine.IsDone())
+			{
+				--NumRunning;
+				continue;
+			}
+			Coroutine.ContinueWith([This = AsShared()]
+			{
+				--This->NumRunning;
+				This->Run();
+			});
+			return;
+		}
+	}
+
+	static TCoroutine<> Drain(TSharedRef<FLauncherState> This)
+	{
+		auto Lock = co_await This->DrainLock.Lock();
+		// Slots are only released when nothing is queued for them
+		for (int32 i = 0; i < This->MaxConcurrent; ++i)
+			co_await This->Slots;
+		// Hand the slots back, starting anything that arrived in the meantime
+		for (int32 i = 0; i < This->MaxConcurrent; ++i)
+			This->Run();
+	}
+};
+}
+
+Async::FLauncher::FLauncher(int32 MaxConcurrent)
+	: State(MakeShared<FLauncherState>(MaxConcurrent))
+{
+	checkf(MaxConcurrent > 0, TEXT("FLauncher needs at least one slot"));
+}
+
+Async::FLauncher::~FLauncher()
+{
+	State->bShutdown = true;
+	std::scoped_lock _(State->PopLock);
+	State->Queue.Empty();
+	State->NumQueued = 0;
+}
+
+void Async::FLauncher::Launch(TUniqueFunction<TCoroutine<>()> Factory)
+{
+	checkf(Factory, TEXT("Launching empty factory"));
+	// Counted after it's in the queue, see the recheck in Run()
+	State->Queue.Enqueue(std::move(Factory));
+	++State->NumQueued;
+	if (State->Slots.TryLock())
+		State->Run();
+}
+
+int32 Async::FLauncher::NumQueued() const
+{
+	return FMath::Max(0, State->NumQueued.load());
+}
+
+int32 Async::FLauncher::NumRunning() const
+{
+	return State->NumRunning;
+}
+
+TCoroutine<> Async::FLauncher::Drain()
+{
+	return FLauncherState::Drain(State);
+}
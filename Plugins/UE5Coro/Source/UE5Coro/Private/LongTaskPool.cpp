@@ -0,0 +1,217 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "LongTaskPool.h"
+#include <mutex>
+#include "HAL/IConsoleManager.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Private;
+
+std::once_flag FLongTaskPool::Once;
+FLongTaskPool* FLongTaskPool::Instance;
+
+namespace
+{
+TAutoConsoleVariable<int32> CVarLongTaskMaxThreads(
+	TEXT("UE5Coro.LongTaskPool.MaxThreads"), 64,
+	TEXT("Maximum number of threads used by Async::MoveToLongTaskPool. ")
+	TEXT("Coroutines wait in FIFO order for a thread if every one is busy."));
+
+TAutoConsoleVariable<float> CVarLongTaskIdleTimeout(
+	TEXT("UE5Coro.LongTaskPool.IdleTimeout"), 30.0f,
+	TEXT("Seconds after which an unused Async::MoveToLongTaskPool thread ")
+	TEXT("exits."));
+}
+
+class FLongTaskPool::FWorker final : public FRunnable
+{
+	FLongTaskPool& Pool;
+	EThreadPriority Priority;
+	uint64 Affinity;
+
+public:
+	FWork Work; // Protected by Pool.Lock while this worker is idle
+	FEvent* WakeEvent = FPlatformProcess::GetSynchEventFromPool();
+	std::atomic<FRunnableThread*> Thread = nullptr;
+
+	explicit FWorker(FLongTaskPool& Pool, const FWork& Work)
+		: Pool(Pool), Priority(Work.Priority), Affinity(Work.Affinity)
+		, Work(Work) { }
+	UE_NONCOPYABLE(FWorker);
+
+	virtual ~FWorker() override
+	{
+		FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+	}
+
+	virtual uint32 Run() override
+	{
+		FWork Current = Work;
+		Work = {};
+		do
+		{
+			// Threads are reused for other keys instead of starving them
+			if (Current.Priority != Priority)
+			{
+				while (!Thread.load())
+					FPlatformProcess::Yield();
+				Thread.load()->SetThreadPriority(Priority = Current.Priority);
+			}
+			if (Current.Affinity != Affinity)
+				FPlatformProcess::SetThreadAffinityMask(
+					Affinity = Current.Affinity);
+			Current.Promise->Resume();
+		} while (Pool.Next(*this, Current));
+		return 0;
+	}
+};
+
+FLongTaskPool& FLongTaskPool::Get()
+{
+	std::call_once(Once, [] { Instance = new FLongTaskPool; });
+	return *Instance;
+}
+
+void FLongTaskPool::Schedule(FPromise& Promise, EThreadPriority Priority,
+                             uint64 Affinity)
+{
+	FWork Work{&Promise, Priority, Affinity};
+	FWorker* Worker = nullptr;
+	TArray<FWorker*> ToReap;
+	{
+		std::scoped_lock _(Lock);
+		Swap(ToReap, Retired);
+
+		// Prefer a parked thread that's already set up correctly, then a new
+		// thread, then re-keying a parked thread
+		int32 MaxThreads = CVarLongTaskMaxThreads.GetValueOnAnyThread();
+		int32 Index = Idle.FindLastByPredicate([&](FWorker* Idler)
+		{
+			return Idler->Work.HasSameKey(Work);
+		});
+		if (Index == INDEX_NONE && NumThreads >= MaxThreads)
+			Index = Idle.Num() - 1;
+		if (Index != INDEX_NONE)
+		{
+			Worker = Idle[Index];
+			Idle.RemoveAt(Index);
+		}
+
+		if (Worker)
+			Worker->Work = Work;
+		else if (NumThreads < MaxThreads)
+			++NumThreads;
+		else
+		{
+			Backlog.Add(Work);
+			Work.Promise = nullptr;
+		}
+	}
+	Reap(ToReap);
+
+	if (Worker)
+		Worker->WakeEvent->Trigger();
+	else if (Work.Promise)
+	{
+		Worker = new FWorker(*this, Work);
+		// Run() might start before this assignment finishes
+		Worker->Thread = FRunnableThread::Create(
+			Worker, TEXT("UE5Coro::Async::MoveToLongTaskPool"), 0, Priority,
+			Affinity);
+		checkf(Worker->Thread.load(),
+		       TEXT("Internal error: could not create thread"));
+	}
+}
+
+int32 FLongTaskPool::GetNumThreads()
+{
+	std::scoped_lock _(Lock);
+	return NumThreads;
+}
+
+bool FLongTaskPool::Next(FWorker& Worker, FWork& Work)
+{
+	{
+		std::scoped_lock _(Lock);
+		if (Backlog.Num() > 0)
+		{
+			Work = Backlog[0];
+			Backlog.RemoveAt(0);
+			return true;
+		}
+		// Idle workers keep their last key to be matched against
+		Worker.Work = Work;
+		Worker.Work.Promise = nullptr;
+		Idle.Add(&Worker);
+	}
+
+	for (;;)
+	{
+		uint32 Timeout = static_cast<uint32>(FMath::Max(
+			0.0f, CVarLongTaskIdleTimeout.GetValueOnAnyThread()) * 1000.0f);
+		bool bSignaled = Worker.WakeEvent->Wait(Timeout);
+		TArray<FWorker*> ToReap;
+		{
+			std::scoped_lock _(Lock);
+			if (Worker.Work.Promise)
+			{
+				Work = Worker.Work;
+				Worker.Work.Promise = nullptr;
+				return true;
+			}
+			// Wakeups that were meant for a previous Work
+			if (bSignaled)
+				continue;
+
+			Idle.RemoveSingle(&Worker);
+			--NumThreads;
+			Swap(ToReap, Retired);
+			Retired.Add(&Worker); // Reaped by the next thread to get here
+		}
+		Reap(ToReap);
+		return false;
+	}
+}
+
+void FLongTaskPool::Reap(TArray<FWorker*>& Workers)
+{
+	for (auto* Worker : Workers)
+	{
+		while (!Worker->Thread.load())
+			FPlatformProcess::Yield();
+		// These have already returned from Run() or are about to
+		delete Worker->Thread.load();
+		delete Worker;
+	}
+}
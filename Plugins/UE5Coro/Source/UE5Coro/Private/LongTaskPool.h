@@ -0,0 +1,80 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UE5Coro/Definitions.h"
+#include "UE5Coro/AsyncAwaiters.h"
+#include "UE5Coro/Private.h"
+
+namespace UE5Coro::Private
+{
+/** Parked threads used by Async::MoveToLongTaskPool.<br>
+ *  Threads are created on demand up to UE5Coro.LongTaskPool.MaxThreads, keyed
+ *  by their priority and affinity, and exit after not being used for
+ *  UE5Coro.LongTaskPool.IdleTimeout seconds. */
+class UE5CORO_API FLongTaskPool final
+{
+	struct FWork
+	{
+		FPromise* Promise = nullptr;
+		EThreadPriority Priority = TPri_Normal;
+		uint64 Affinity = 0;
+
+		bool HasSameKey(const FWork& Other) const
+		{
+			return Priority == Other.Priority && Affinity == Other.Affinity;
+		}
+	};
+	class FWorker;
+
+	static std::once_flag Once;
+	static FLongTaskPool* Instance;
+
+	FMutex Lock;
+	int32 NumThreads = 0;
+	TArray<FWorker*> Idle; // Most recently parked last
+	TArray<FWork> Backlog; // Only used when every allowed thread is busy
+	TArray<FWorker*> Retired; // Exited, but not yet joined
+
+public:
+	static FLongTaskPool& Get();
+	void Schedule(FPromise&, EThreadPriority, uint64 Affinity);
+	int32 GetNumThreads();
+
+private:
+	explicit FLongTaskPool() = default;
+	~FLongTaskPool() = delete;
+	bool Next(FWorker&, FWork&);
+	static void Reap(TArray<FWorker*>&);
+};
+}
@@ -0,0 +1,149 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "UE5Coro/PhysicsAwaiters.h"
+#include "GameThreadInbox.h"
+#include "PBDRigidsSolver.h"
+#include "Async/Async.h"
+#include "Engine/Engine.h"
+#include "Physics/Experimental/PhysScene_Chaos.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Private;
+
+FPhysicsTickAwaiter Async::NextPhysicsTick(const UObject* WorldContextObject)
+{
+	return FPhysicsTickAwaiter(
+		GEngine->GetWorldFromContextObjectChecked(WorldContextObject));
+}
+
+struct FPhysicsTickAwaiter::FState
+{
+	// Whoever takes this resumes the coroutine
+	std::atomic<FPromise*> Promise = nullptr;
+	bool bTicked = false; // Set by the solver's callback before resuming
+
+	/** Resumes the coroutine on the game thread, if it's still suspended. */
+	void ResumeOnGameThread()
+	{
+		auto* ToResume = Promise.exchange(nullptr);
+		if (!ToResume)
+			return;
+		auto Thread = ToResume->WithTaskPriority(ENamedThreads::GameThread);
+		if (!FGameThreadInbox::TryPush(Thread, *ToResume))
+			AsyncTask(Thread, [ToResume] { ToResume->Resume(); });
+	}
+
+	/** Owned by the solver's callback, which the solver destroys without
+	 *  running it if it's torn down before its next step. */
+	struct FGuard
+	{
+		TSharedRef<FState> State;
+
+		explicit FGuard(TSharedRef<FState> State) : State(MoveTemp(State)) { }
+		UE_NONCOPYABLE(FGuard);
+		~FGuard() { State->ResumeOnGameThread(); } // No-op after the step
+	};
+};
+
+FPhysicsTickAwaiter::FPhysicsTickAwaiter(const FPhysicsTickAwaiter& Other)
+	: FCancellationHook(&OnCanceled), World(Other.World)
+{
+}
+
+FPhysicsTickAwaiter::~FPhysicsTickAwaiter()
+{
+	// The hook goes first, it might otherwise resume a coroutine that's
+	// being destroyed
+	Unhook();
+	if (State)
+		State->Promise = nullptr;
+}
+
+void FPhysicsTickAwaiter::OnCanceled(FCancellationHook& Hook)
+{
+	// Hand the coroutine back early instead of waiting for the next step
+	auto& This = static_cast<FPhysicsTickAwaiter&>(Hook);
+	This.State->ResumeOnGameThread();
+}
+
+void FPhysicsTickAwaiter::Unhook()
+{
+	if (auto* Awaiting = std::exchange(Hooked, nullptr))
+		Awaiting->RemoveCancellationHook(*this);
+}
+
+void FPhysicsTickAwaiter::Suspend(FPromise& Promise)
+{
+	checkf(IsInGameThread(),
+	       TEXT("Physics ticks may only be awaited on the game thread"));
+	checkf(!Hooked, TEXT("Internal error: double physics tick await"));
+	auto* Scene = World.IsValid() ? World->GetPhysicsScene() : nullptr;
+	auto* Solver = Scene ? Scene->GetSolver() : nullptr;
+	State = nullptr;
+	if (!ensureMsgf(Solver, TEXT("Awaiting a physics tick without physics")))
+	{
+		Promise.Resume();
+		return;
+	}
+
+	// The hook may fire on another thread as soon as it's added
+	State = MakeShared<FState>();
+	State->Promise = &Promise;
+	if (LIKELY(Promise.AddCancellationHook(*this)))
+		Hooked = &Promise;
+	else
+	{
+		// Already canceled, let Resume process it
+		State->Promise = nullptr;
+		Promise.Resume();
+		return;
+	}
+
+	// The solver runs these at the start of its next step
+	auto Guard = MakeShared<FState::FGuard>(State.ToSharedRef());
+	Solver->RegisterSimOneShotCallback([Guard = MoveTemp(Guard)]
+	{
+		auto& GuardState = *Guard->State;
+		if (auto* ToResume = GuardState.Promise.exchange(nullptr))
+		{
+			GuardState.bTicked = true;
+			ToResume->Resume();
+		}
+	});
+}
+
+bool FPhysicsTickAwaiter::await_resume()
+{
+	// Allow this awaiter to be reused
+	Unhook();
+	return State && State->bTicked;
+}
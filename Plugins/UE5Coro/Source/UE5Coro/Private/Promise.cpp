@@ -31,24 +31,296 @@
 
 #include "UE5Coro/AsyncCoroutine.h"
 #include "Misc/ScopeExit.h"
+#include "Census.h"
+#include "CoroutineScopeState.h"
+#include "FrameWork.h"
+#include "GameThreadInbox.h"
+#include "HAL/IConsoleManager.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#include "Trace/Trace.inl"
+
+#define UE5CORO_PRIVATE_TRACE (UE5CORO_DEBUG && CPUPROFILERTRACE_ENABLED)
 
 using namespace UE5Coro::Private;
 
 #if UE5CORO_DEBUG
-std::atomic<int> UE5Coro::Private::GLastDebugID = -1; // -1 = no coroutines yet
+int UE5Coro::Private::GDebugMetadata = 2;
+
+namespace
+{
+FAutoConsoleVariableRef CVarDebugMetadata(
+	TEXT("UE5Coro.DebugMetadata"), GDebugMetadata,
+	TEXT("How much debug information new coroutines and co_awaits record. ")
+	TEXT("0: IDs only, 1: also promise types and debug names, 2 (default): ")
+	TEXT("also awaiter types, which UE5Coro.AwaitStats and UE5Coro.Record ")
+	TEXT("need."));
+
+// IDs are handed out to threads in blocks, to keep coroutines started on
+// different threads from contending on a single counter
+constexpr int DebugIDBlockSize = 1024;
+std::atomic<int> GNextDebugIDBlock = 0;
+thread_local int GNextDebugID = 0;
+thread_local int GDebugIDBlockEnd = 0;
+
+int NextDebugID()
+{
+	if (UNLIKELY(GNextDebugID == GDebugIDBlockEnd))
+	{
+		GNextDebugID = GNextDebugIDBlock.fetch_add(DebugIDBlockSize,
+		                                           std::memory_order_relaxed);
+		GDebugIDBlockEnd = GNextDebugID + DebugIDBlockSize;
+	}
+	return GNextDebugID++;
+}
+}
+
+const TCHAR* UE5Coro::Private::ParseDebugTypeName(const ANSICHAR* Signature)
+{
+	FString Name(Signature);
+#ifdef _MSC_VER
+	// const wchar_t *__cdecl UE5Coro::Private::DebugTypeName<class X>(void)
+	int32 Start = Name.Find(TEXT("DebugTypeName<"));
+	int32 End;
+	if (Start != INDEX_NONE && Name.FindLastChar(TEXT('>'), End))
+	{
+		Start += 14;
+		Name = Name.Mid(Start, End - Start);
+		Name.ReplaceInline(TEXT("class "), TEXT(""));
+		Name.ReplaceInline(TEXT("struct "), TEXT(""));
+		Name.ReplaceInline(TEXT("enum "), TEXT(""));
+	}
+#else
+	// Clang: ... DebugTypeName() [T = X]
+	// GCC: ... DebugTypeName() [with T = X; TCHAR = char16_t]
+	int32 Start = Name.Find(TEXT("[T = "));
+	if (Start != INDEX_NONE)
+		Start += 5;
+	else if ((Start = Name.Find(TEXT("[with T = "))) != INDEX_NONE)
+		Start += 10;
+	if (Start != INDEX_NONE)
+	{
+		int32 Depth = 0;
+		int32 End = Start;
+		for (; End < Name.Len(); ++End)
+		{
+			TCHAR C = Name[End];
+			if (C == TEXT('<') || C == TEXT('(') || C == TEXT('['))
+				++Depth;
+			else if ((C == TEXT(']') || C == TEXT(';')) && Depth == 0)
+				break;
+			else if (C == TEXT('>') || C == TEXT(')') || C == TEXT(']'))
+				--Depth;
+		}
+		Name = Name.Mid(Start, End - Start);
+	}
+#endif
+	// This is called once per type, the result is intentionally leaked
+	auto* Result = new TCHAR[Name.Len() + 1];
+	FCString::Strcpy(Result, Name.Len() + 1, *Name);
+	return Result;
+}
+#endif
+
+#if UE5CORO_PRIVATE_TRACE
+UE_TRACE_CHANNEL_DEFINE(UE5CoroChannel)
+
+// Every resume of a coroutine is bracketed by these events. Wall time and time
+// spent suspended can be derived from them and the coroutine's ID, on-CPU time
+// is also visible as a CPU timer named after the coroutine.
+UE_TRACE_EVENT_BEGIN(UE5Coro, ResumeBegin)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(int32, CoroutineId)
+	UE_TRACE_EVENT_FIELD(uint32, ThreadId)
+	UE_TRACE_EVENT_FIELD(UE::Trace::WideString, Name)
+	UE_TRACE_EVENT_FIELD(UE::Trace::WideString, PromiseType)
+	// The coroutine co_awaiting this one (-1 if none), and the outermost one
+	// in that chain, which time spent in this resume can be attributed to
+	UE_TRACE_EVENT_FIELD(int32, CallerId)
+	UE_TRACE_EVENT_FIELD(int32, RootId)
+	UE_TRACE_EVENT_FIELD(UE::Trace::WideString, RootName)
+UE_TRACE_EVENT_END()
+
+UE_TRACE_EVENT_BEGIN(UE5Coro, ResumeEnd)
+	UE_TRACE_EVENT_FIELD(uint64, Cycle)
+	UE_TRACE_EVENT_FIELD(int32, CoroutineId)
+	UE_TRACE_EVENT_FIELD(uint8, bCompleted)
+	// What the coroutine is now suspended on, if it's not complete
+	UE_TRACE_EVENT_FIELD(UE::Trace::WideString, AwaiterType)
+UE_TRACE_EVENT_END()
+
+namespace
+{
+class [[nodiscard]] FResumeTraceScope final
+{
+	// The innermost scope on this thread, symmetric transfer continues in it
+	static thread_local FResumeTraceScope* GInnermost;
+
+	// The promise might be gone by the time this ends, the extras will not
+	std::shared_ptr<FPromiseExtras> Extras;
+	const TCHAR* Name = TEXT("");
+	FResumeTraceScope* Outer;
+
+public:
+	explicit FResumeTraceScope(const std::shared_ptr<FPromiseExtras>& InExtras)
+		: Outer(std::exchange(GInnermost, this))
+	{
+		Begin(InExtras);
+	}
+	UE_NONCOPYABLE(FResumeTraceScope);
+
+	~FResumeTraceScope()
+	{
+		End();
+		GInnermost = Outer;
+	}
+
+	/** Ends the current resume event, and begins one for the coroutine that
+	 *  symmetric transfer continues in, which ends with this scope. */
+	static void Transfer(const std::shared_ptr<FPromiseExtras>& Next)
+	{
+		if (auto* Scope = GInnermost)
+		{
+			Scope->End();
+			Scope->Begin(Next);
+		}
+	}
+
+	const TCHAR* GetName() const { return Name; }
+
+private:
+	void Begin(const std::shared_ptr<FPromiseExtras>& InExtras)
+	{
+		if (!UE_TRACE_CHANNELEXPR_IS_ENABLED(UE5CoroChannel))
+			return;
+		Extras = InExtras;
+		Name = GetName(*Extras);
+		// The callers could be destroyed by now, the census keeps these alive
+		auto [Caller, Root] = FCoroutineCensus::GetCallers(*Extras);
+		auto* RootExtras = Root ? Root.get() : Extras.get();
+		UE_TRACE_LOG(UE5Coro, ResumeBegin, UE5CoroChannel)
+			<< ResumeBegin.Cycle(FPlatformTime::Cycles64())
+			<< ResumeBegin.CoroutineId(Extras->DebugID)
+			<< ResumeBegin.ThreadId(FPlatformTLS::GetCurrentThreadId())
+			<< ResumeBegin.Name(Name)
+			<< ResumeBegin.PromiseType(Extras->DebugPromiseType
+				? Extras->DebugPromiseType : TEXT(""))
+			<< ResumeBegin.CallerId(Caller ? Caller->DebugID : -1)
+			<< ResumeBegin.RootId(RootExtras->DebugID)
+			<< ResumeBegin.RootName(GetName(*RootExtras));
+	}
+
+	void End()
+	{
+		if (!Extras)
+			return;
+		bool bCompleted = Extras->IsComplete();
+		const TCHAR* AwaiterType = bCompleted || !Extras->DebugAwaiterType
+			? TEXT("") : Extras->DebugAwaiterType;
+		UE_TRACE_LOG(UE5Coro, ResumeEnd, UE5CoroChannel)
+			<< ResumeEnd.Cycle(FPlatformTime::Cycles64())
+			<< ResumeEnd.CoroutineId(Extras->DebugID)
+			<< ResumeEnd.bCompleted(bCompleted)
+			<< ResumeEnd.AwaiterType(AwaiterType);
+		Extras = nullptr;
+	}
+
+	static const TCHAR* GetName(const FPromiseExtras& Extras)
+	{
+		if (Extras.DebugName)
+			return Extras.DebugName;
+		// Not recorded below UE5Coro.DebugMetadata 1
+		return Extras.DebugPromiseType ? Extras.DebugPromiseType
+		                               : TEXT("Coroutine");
+	}
+};
+
+thread_local FResumeTraceScope* FResumeTraceScope::GInnermost = nullptr;
+}
+
+// The CPU timer ends before the ResumeEnd event
+#define UE5CORO_PRIVATE_TRACE_RESUME() \
+	FResumeTraceScope TraceScope(Extras); \
+	TRACE_CPUPROFILER_EVENT_SCOPE_TEXT_ON_CHANNEL(TraceScope.GetName(), \
+	                                              UE5CoroChannel)
+#else
+#define UE5CORO_PRIVATE_TRACE_RESUME() do { } while (false)
 #endif
 
 thread_local FPromise* UE5Coro::Private::GCurrentPromise = nullptr;
+thread_local FPromise** UE5Coro::Private::GSymmetricTransfer = nullptr;
+thread_local uint64 UE5Coro::Private::GResumeCycles = 0;
 thread_local bool UE5Coro::Private::GDestroyedEarly = false;
 
-bool FPromiseExtras::IsComplete() const
+FPromiseExtras::~FPromiseExtras()
+{
+	if (CompletedEvent)
+		FPlatformProcess::ReturnSynchEventToPool(CompletedEvent);
+}
+
+bool FPromiseExtras::Wait(uint32 WaitTimeMilliseconds,
+                          bool bIgnoreThreadIdleStats)
 {
-	return Completed->Wait(0, true);
+	if (IsComplete())
+		return true;
+	if (WaitTimeMilliseconds == 0)
+		return false;
+
+	FEvent* Event;
+	{
+		std::scoped_lock _(Lock);
+		if (IsComplete())
+			return true;
+		if (!CompletedEvent)
+			CompletedEvent = FPlatformProcess::GetSynchEventFromPool(true);
+		Event = CompletedEvent; // This will live as long as this object
+	}
+	return Event->Wait(WaitTimeMilliseconds, bIgnoreThreadIdleStats);
+}
+
+bool FPromiseExtras::ResumeWhenComplete(FPromise& Awaiting)
+{
+	std::scoped_lock _(Lock);
+	if (IsComplete())
+		return false;
+	checkf(Promise,
+	       TEXT("Internal error: attaching continuation to a complete promise"));
+	Promise->AddAwaitingPromise(Awaiting);
+	return true;
+}
+
+void FPromiseExtras::ContinueOn(ENamedThreads::Type Thread, FContinuation Fn)
+{
+	std::unique_lock _(Lock);
+	if (IsComplete())
+	{
+		_.unlock();
+		FGameThreadInbox::Post(Thread, std::move(Fn));
+		return;
+	}
+
+	checkf(Promise,
+	       TEXT("Internal error: attaching continuation to a complete promise"));
+	Promise->AddContinuation([Thread, Fn = std::move(Fn)](void*) mutable
+	{
+		FGameThreadInbox::Post(Thread, std::move(Fn));
+	});
+}
+
+void FPromiseExtras::Complete()
+{
+	checkf(!Lock.try_lock(), TEXT("Internal error: lock not held"));
+	bCompleted.store(true, std::memory_order_release);
+	if (CompletedEvent)
+		CompletedEvent->Trigger();
 }
 
 bool FCancellationTracker::ShouldCancel(bool bBypassHolds) const
 {
-	return bCanceled && (bBypassHolds || CancellationHolds == 0);
+	bool bAny = bCanceled;
+	if (!bAny)
+		if (auto* Flag = ScopeCanceled.load(std::memory_order_acquire))
+			bAny = *Flag;
+	return bAny && (bBypassHolds || CancellationHolds == 0);
 }
 
 FPromise::FPromise(std::shared_ptr<FPromiseExtras> InExtras,
@@ -56,13 +328,32 @@ FPromise::FPromise(std::shared_ptr<FPromiseExtras> InExtras,
 	: Extras(std::move(InExtras))
 {
 #if UE5CORO_DEBUG
-	Extras->DebugID = ++GLastDebugID;
-	Extras->DebugPromiseType = PromiseType;
+	Extras->DebugID = NextDebugID();
+	if (GDebugMetadata >= 1)
+		Extras->DebugPromiseType = PromiseType;
 #endif
+	if (UNLIKELY(GCensusEnabled))
+		FCoroutineCensus::Add(*this, PromiseType);
+	// Coroutines started from another one stay in the same world
+	if (GCurrentPromise)
+		HomeWorld = GCurrentPromise->HomeWorld;
 }
 
 FPromise::~FPromise()
 {
+	if (UNLIKELY(bInCensus))
+		FCoroutineCensus::Remove(*this);
+
+	// Completing counts as joining, the game thread might be waiting for it
+	if (UNLIKELY(bInFrameWork))
+		FFrameWork::Leave();
+
+	// Scratch memory is not allowed to outlive the coroutine's own locals
+	Arena.Reset();
+
+	// Only this destructor may use this, not others that it causes
+	auto** Transfer = std::exchange(GSymmetricTransfer, nullptr);
+
 	// Expecting the lock to be taken by a derived destructor
 	checkf(!Extras->Lock.try_lock(), TEXT("Internal error: lock not held"));
 	checkf(!Extras->IsComplete(),
@@ -75,12 +366,24 @@ FPromise::~FPromise()
 	GDestroyedEarly = false;
 
 	// The coroutine is considered completed NOW
-	Extras->Completed->Trigger();
+	Extras->Complete();
 	Extras->Lock.unlock();
 
 	for (auto& Fn : OnCompleted)
 		Fn(Extras->ReturnValuePtr);
 	Extras->ReturnValuePtr = nullptr;
+
+	// This might resume coroutines that are joining the scope
+	if (UNLIKELY(ScopeNode.Scope))
+		FCoroutineScopeState::Remove(*this);
+
+	if (AwaitingPromise)
+	{
+		if (Transfer)
+			*Transfer = AwaitingPromise;
+		else
+			AwaitingPromise->Resume();
+	}
 }
 
 void FPromise::ThreadSafeDestroy()
@@ -124,14 +427,19 @@ void FPromise::Resume(bool bBypassCancellationHolds)
 	checkf(this, TEXT("Corruption")); // Still useful on some compilers
 	checkf(!Extras->IsComplete(),
 	       TEXT("Attempting to resume completed coroutine"));
+	UE5CORO_PRIVATE_TRACE_RESUME();
 	auto* CallerPromise = GCurrentPromise;
+	auto CallerCycles = GResumeCycles;
 	GCurrentPromise = this;
+	GResumeCycles = FPlatformTime::Cycles64();
 	ON_SCOPE_EXIT
 	{
-		// Coroutine resumption might result in `this` having been freed already
-		checkf(GCurrentPromise == this,
+		// Coroutine resumption might result in `this` having been freed already,
+		// and symmetric transfer might have moved on to other coroutines
+		checkf(GCurrentPromise,
 		       TEXT("Internal error: coroutine resume tracking derailed"));
 		GCurrentPromise = CallerPromise;
+		GResumeCycles = CallerCycles;
 	};
 
 	// Self-destruct instead of resuming if a cancellation was received.
@@ -140,7 +448,17 @@ void FPromise::Resume(bool bBypassCancellationHolds)
 	if (UNLIKELY(ShouldCancel(bBypassCancellationHolds)))
 		ThreadSafeDestroy();
 	else
-		stdcoro::coroutine_handle<FPromise>::from_promise(*this).resume();
+	{
+		EndAwait(GResumeCycles);
+		TakeResumeHandle().resume();
+	}
+}
+
+void FPromise::TraceTransferredResume()
+{
+#if UE5CORO_PRIVATE_TRACE
+	FResumeTraceScope::Transfer(Extras);
+#endif
 }
 
 void FPromise::ResumeFast()
@@ -148,13 +466,21 @@ void FPromise::ResumeFast()
 	checkf(!Extras->IsComplete() && !ShouldCancel(true),
 	       TEXT("Internal error: Fast resume preconditions not met"));
 	// If this is a FLatentPromise, !LF_Detached is also assumed
+	UE5CORO_PRIVATE_TRACE_RESUME();
 	auto* CallerPromise = GCurrentPromise;
+	auto CallerCycles = GResumeCycles;
 	GCurrentPromise = this;
-	ON_SCOPE_EXIT { GCurrentPromise = CallerPromise; };
-	stdcoro::coroutine_handle<FPromise>::from_promise(*this).resume();
+	GResumeCycles = FPlatformTime::Cycles64();
+	ON_SCOPE_EXIT
+	{
+		GCurrentPromise = CallerPromise;
+		GResumeCycles = CallerCycles;
+	};
+	EndAwait(GResumeCycles);
+	TakeResumeHandle().resume();
 }
 
-void FPromise::AddContinuation(std::function<void(void*)> Fn)
+void FPromise::AddContinuation(FContinuation Fn)
 {
 	// Expecting a non-empty function and the lock to be held by the caller
 	checkf(!Extras->Lock.try_lock(), TEXT("Internal error: lock not held"));
@@ -163,6 +489,85 @@ void FPromise::AddContinuation(std::function<void(void*)> Fn)
 	OnCompleted.Add(std::move(Fn));
 }
 
+void FPromise::AddAwaitingPromise(FPromise& Awaiting)
+{
+	checkf(!Extras->Lock.try_lock(), TEXT("Internal error: lock not held"));
+	if (!AwaitingPromise)
+		AwaitingPromise = &Awaiting;
+	else // Only one of them can be transferred to
+		OnCompleted.Add([&Awaiting](void*) { Awaiting.Resume(); });
+}
+
+bool FPromise::AddCancellationHook(FCancellationHook& Hook)
+{
+	std::scoped_lock _(Extras->Lock);
+	checkf(!Hook.bLinked, TEXT("Internal error: double hook registration"));
+	if (UNLIKELY(ShouldCancel(false)))
+		return false;
+	Hook.Prev = nullptr;
+	Hook.Next = CancellationHooks;
+	if (CancellationHooks)
+		CancellationHooks->Prev = &Hook;
+	CancellationHooks = &Hook;
+	Hook.bLinked = true;
+	return true;
+}
+
+void FPromise::RemoveCancellationHook(FCancellationHook& Hook)
+{
+	std::scoped_lock _(Extras->Lock);
+	if (!Hook.bLinked)
+		return;
+	if (Hook.Prev)
+		Hook.Prev->Next = Hook.Next;
+	else
+		CancellationHooks = Hook.Next;
+	if (Hook.Next)
+		Hook.Next->Prev = Hook.Prev;
+	Hook.bLinked = false;
+}
+
+void FPromise::NotifyCanceled()
+{
+	checkf(!Extras->Lock.try_lock(), TEXT("Internal error: lock not held"));
+	// FCancellationGuards defer this to the next co_await
+	if (!ShouldCancel(false))
+		return;
+	while (auto* Hook = CancellationHooks)
+	{
+		CancellationHooks = Hook->Next;
+		if (CancellationHooks)
+			CancellationHooks->Prev = nullptr;
+		Hook->bLinked = false;
+		Hook->Callback(*Hook);
+	}
+}
+
+ENamedThreads::Type FPromise::WithTaskPriority(ENamedThreads::Type Thread) const
+{
+	if (!bHasTaskPriority)
+		return Thread;
+	constexpr uint32 Mask = ENamedThreads::ThreadPriorityMask |
+	                        ENamedThreads::TaskPriorityMask;
+	return static_cast<ENamedThreads::Type>((Thread & ~Mask) | TaskPriority);
+}
+
+void FPromise::SetTaskPriority(ENamedThreads::Type Priority)
+{
+	TaskPriority = Priority & (ENamedThreads::ThreadPriorityMask |
+	                           ENamedThreads::TaskPriorityMask);
+	bHasTaskPriority = bExplicitTaskPriority = true;
+}
+
+void FPromise::InheritTaskPriority(ENamedThreads::Type Thread)
+{
+	if (bExplicitTaskPriority)
+		return;
+	TaskPriority = Thread & (ENamedThreads::ThreadPriorityMask |
+	                         ENamedThreads::TaskPriorityMask);
+	bHasTaskPriority = true;
+}
+
 void FPromise::unhandled_exception()
 {
 #if PLATFORM_EXCEPTIONS_DISABLED
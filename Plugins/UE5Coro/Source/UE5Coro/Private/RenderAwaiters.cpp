@@ -0,0 +1,365 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "UE5Coro/RenderAwaiters.h"
+#include "GameThreadInbox.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Containers/Ticker.h"
+#include "Components/PrimitiveComponent.h"
+#include "ContentStreaming.h"
+#include "Engine/Texture.h"
+#include "Materials/MaterialInterface.h"
+#include "RenderingThread.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Private;
+
+FRenderThreadAwaiter Async::MoveToRenderThread()
+{
+	return {};
+}
+
+FReadbackAwaiter Async::UntilReadbackReady(FRHIGPUReadback& Readback)
+{
+	return FReadbackAwaiter(Readback);
+}
+
+struct FRenderResourceAwaiter::FState
+{
+	// Only used on the game thread
+	TFunction<bool()> Poll; // Returns true once this is done, if set
+	double Deadline = 0; // FPlatformTime::Seconds(), 0 if there's none
+	FPromise* Promise = nullptr;
+	bool bDone = false;
+	bool bSucceeded = false;
+
+	void Finish(bool bInSucceeded)
+	{
+		checkf(IsInGameThread(),
+		       TEXT("Internal error: expected render wait on the game thread"));
+		if (bDone)
+			return;
+		bDone = true;
+		bSucceeded = bInSucceeded;
+		Poll = nullptr;
+		if (auto* ToResume = std::exchange(Promise, nullptr))
+			ToResume->Resume();
+	}
+
+	/** Calls Poll (if any) and checks the timeout (if any) once per frame
+	 *  until this is done, or its awaiter is destroyed. */
+	static void Watch(const TSharedRef<FState>& State, float TimeoutSeconds)
+	{
+		if (TimeoutSeconds > 0)
+			State->Deadline = FPlatformTime::Seconds() + TimeoutSeconds;
+		else if (!State->Poll)
+			return; // Nothing to check
+		FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda(
+			[State](float)
+			{
+				if (State->bDone)
+					return false;
+				if (State->Poll && State->Poll())
+					State->Finish(true);
+				else if (State->Deadline &&
+				         FPlatformTime::Seconds() >= State->Deadline)
+					State->Finish(false);
+				return !State->bDone;
+			}));
+	}
+
+	static FRenderResourceAwaiter Done()
+	{
+		auto State = MakeShared<FState>();
+		State->bDone = State->bSucceeded = true;
+		return FRenderResourceAwaiter(State);
+	}
+};
+
+FRenderResourceAwaiter Render::PrecachePSOs(
+	TArrayView<UPrimitiveComponent*> Components, float TimeoutSeconds)
+{
+	checkf(IsInGameThread(),
+	       TEXT("PSOs may only be precached from the game thread"));
+	using FState = FRenderResourceAwaiter::FState;
+	TArray<TWeakObjectPtr<UPrimitiveComponent>> Precaching;
+#if ENGINE_MINOR_VERSION >= 3
+	// Components do this on their own when they're registered, but they
+	// don't expose its completion event, only whether it's still going
+	for (auto* Component : Components)
+		if (IsValid(Component))
+		{
+			if (!Component->IsPSOPrecaching())
+				Component->PrecachePSOs();
+			if (Component->IsPSOPrecaching())
+				Precaching.Add(Component);
+		}
+#endif
+	if (Precaching.IsEmpty())
+		return FState::Done();
+
+	auto State = MakeShared<FState>();
+	State->Poll = [Precaching = MoveTemp(Precaching)]
+	{
+#if ENGINE_MINOR_VERSION >= 3
+		for (auto& Component : Precaching)
+			if (auto* Ptr = Component.Get(); Ptr && Ptr->IsPSOPrecaching())
+				return false;
+#endif
+		return true;
+	};
+	FState::Watch(State, TimeoutSeconds);
+	return FRenderResourceAwaiter(State);
+}
+
+#if ENGINE_MINOR_VERSION >= 3
+FRenderResourceAwaiter Render::PrecachePSOs(
+	TArrayView<UMaterialInterface*> Materials,
+	const FPSOPrecacheVertexFactoryDataList& VertexFactoryDataList,
+	const FPSOPrecacheParams& Params, float TimeoutSeconds)
+{
+	checkf(IsInGameThread(),
+	       TEXT("PSOs may only be precached from the game thread"));
+	using FState = FRenderResourceAwaiter::FState;
+	FGraphEventArray Events;
+	TArray<FMaterialPSOPrecacheRequestID> RequestIDs;
+	for (auto* Material : Materials)
+		if (IsValid(Material))
+			Events.Append(Material->PrecachePSOs(VertexFactoryDataList, Params,
+			                                     EPSOPrecachePriority::High,
+			                                     RequestIDs));
+	if (Events.IsEmpty())
+		return FState::Done();
+
+	auto State = MakeShared<FState>();
+	// Precaching might take much longer than the timeout or the awaiter
+	FFunctionGraphTask::CreateAndDispatchWhenReady(
+		[WeakState = TWeakPtr<FState>(State)]
+		{
+			if (auto Pinned = WeakState.Pin())
+				Pinned->Finish(true);
+		}, TStatId(), &Events, ENamedThreads::GameThread);
+	FState::Watch(State, TimeoutSeconds);
+	return FRenderResourceAwaiter(State);
+}
+#endif
+
+FRenderResourceAwaiter Render::UntilTexturesResident(
+	TArrayView<UPrimitiveComponent*> Components, float Threshold,
+	float TimeoutSeconds)
+{
+	checkf(IsInGameThread(),
+	       TEXT("Texture streaming may only be awaited on the game thread"));
+	using FState = FRenderResourceAwaiter::FState;
+	TSet<UTexture*> Textures;
+	TArray<UTexture*> Used;
+	for (auto* Component : Components)
+		if (IsValid(Component))
+		{
+			Used.Reset();
+			Component->GetUsedTextures(Used, EMaterialQualityLevel::Num);
+			for (auto* Texture : Used)
+				if (IsValid(Texture))
+					Textures.Add(Texture);
+		}
+
+	// Non-streamable textures are always fully streamed in
+	TArray<TWeakObjectPtr<UTexture>> Pending;
+	for (auto* Texture : Textures)
+		if (!Texture->IsFullyStreamedIn())
+		{
+			Texture->SetForceMipLevelsToBeResident(1);
+			Pending.Add(Texture);
+		}
+	int32 Total = Textures.Num();
+	float Fraction = FMath::Clamp(Threshold, 0.0f, 1.0f);
+	int32 Allowed = Total - FMath::CeilToInt(Fraction * Total);
+	if (Pending.Num() <= Allowed)
+		return FState::Done();
+
+	auto State = MakeShared<FState>();
+	State->Poll = [Pending = MoveTemp(Pending), Allowed]() mutable
+	{
+		// Only the textures that are still pending are checked and kept wanted
+		for (int32 i = Pending.Num() - 1; i >= 0; --i)
+			if (auto* Texture = Pending[i].Get();
+			    Texture && !Texture->IsFullyStreamedIn())
+				Texture->SetForceMipLevelsToBeResident(1);
+			else
+				Pending.RemoveAtSwap(i);
+		return Pending.Num() <= Allowed;
+	};
+	FState::Watch(State, TimeoutSeconds);
+	return FRenderResourceAwaiter(State);
+}
+
+FRenderResourceAwaiter Render::UntilTexturesResident(const FVector& Location,
+                                                     float Threshold,
+                                                     float TimeoutSeconds)
+{
+	checkf(IsInGameThread(),
+	       TEXT("Texture streaming may only be awaited on the game thread"));
+	using FState = FRenderResourceAwaiter::FState;
+	auto& Streaming = IStreamingManager::Get();
+	Streaming.AddViewLocation(Location);
+
+	auto State = MakeShared<FState>();
+	State->Poll = [Location, Threshold = FMath::Clamp(Threshold, 0.0f, 1.0f),
+	               LastID = Streaming.GetNumWantingResourcesID(), Updates = 0,
+	               Peak = 0]() mutable
+	{
+		// View locations only last until the next update
+		auto& Streaming = IStreamingManager::Get();
+		Streaming.AddViewLocation(Location);
+		int32 ID = Streaming.GetNumWantingResourcesID();
+		if (ID == LastID)
+			return false; // Nothing new yet
+		LastID = ID;
+		int32 Wanting = Streaming.GetNumWantingResources();
+		Peak = FMath::Max(Peak, Wanting);
+		// The first update might have started before Location was added
+		return ++Updates >= 2 &&
+		       Wanting <= FMath::FloorToInt((1 - Threshold) * Peak);
+	};
+	FState::Watch(State, TimeoutSeconds);
+	return FRenderResourceAwaiter(State);
+}
+
+void FRenderThreadAwaiter::Suspend(FPromise& Promise)
+{
+	ENQUEUE_RENDER_COMMAND(UE5Coro_MoveToRenderThread)(
+		[&Promise](FRHICommandListImmediate&) { Promise.Resume(); });
+}
+
+bool FRenderFenceAwaiter::await_ready()
+{
+	checkf(IsInGameThread(),
+	       TEXT("Fences may only be awaited on the game thread"));
+	return Fence.IsFenceComplete();
+}
+
+void FRenderFenceAwaiter::Suspend(FPromise& InPromise)
+{
+	Promise = &InPromise;
+	// Render commands run in order, this one runs right after the fence.
+	// IsFenceComplete is only allowed on the game thread.
+	ENQUEUE_RENDER_COMMAND(UE5Coro_FenceAwaiter)(
+		[this](FRHICommandListImmediate&)
+		{
+			FGameThreadInbox::Post(ENamedThreads::GameThread,
+			                       [this](void*) { Check(); });
+		});
+}
+
+void FRenderFenceAwaiter::Check()
+{
+	if (Fence.IsFenceComplete())
+	{
+		Promise->Resume();
+		return;
+	}
+
+	// Fences that sync to the RHI thread or the GPU complete later than the
+	// rendering thread reaching them
+	FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda(
+		[this](float)
+		{
+			if (!Fence.IsFenceComplete())
+				return true;
+			Promise->Resume(); // This might destroy this awaiter
+			return false;
+		}));
+}
+
+void FReadbackAwaiter::Suspend(FPromise& InPromise)
+{
+	Promise = &InPromise;
+	Poll();
+}
+
+void FReadbackAwaiter::Poll()
+{
+	ENQUEUE_RENDER_COMMAND(UE5Coro_ReadbackAwaiter)(
+		[this](FRHICommandListImmediate&)
+		{
+			if (Readback.IsReady())
+			{
+				Promise->Resume();
+				return;
+			}
+			// Try again next frame
+			FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateLambda(
+				[this](float)
+				{
+					Poll();
+					return false;
+				}));
+		});
+}
+
+FRenderResourceAwaiter::FRenderResourceAwaiter(TSharedPtr<FState> State)
+	: State(std::move(State))
+{
+}
+
+FRenderResourceAwaiter::FRenderResourceAwaiter(
+	FRenderResourceAwaiter&&) noexcept = default;
+
+FRenderResourceAwaiter::~FRenderResourceAwaiter()
+{
+	// Don't resume a coroutine that's being destroyed while suspended, and
+	// stop the ticker that's watching for it, if there's one
+	if (State)
+	{
+		State->Promise = nullptr;
+		State->bDone = true;
+		State->Poll = nullptr;
+	}
+}
+
+bool FRenderResourceAwaiter::await_ready()
+{
+	checkf(IsInGameThread(),
+	       TEXT("Render resources may only be awaited on the game thread"));
+	checkf(State, TEXT("Attempting to await a moved-from awaiter"));
+	return State->bDone;
+}
+
+void FRenderResourceAwaiter::Suspend(FPromise& Promise)
+{
+	checkf(!State->Promise, TEXT("Attempted second concurrent co_await"));
+	State->Promise = &Promise;
+}
+
+bool FRenderResourceAwaiter::await_resume()
+{
+	return State->bSucceeded;
+}
@@ -0,0 +1,238 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "UE5Coro/SaveGameAwaiters.h"
+#include "Async/Async.h"
+#include "GameFramework/SaveGame.h"
+#include "Kismet/GameplayStatics.h"
+#include "Misc/Compression.h"
+#include "PlatformFeatures.h"
+#include "SaveGameSystem.h"
+#include "Serialization/MemoryReader.h"
+#include "Serialization/MemoryWriter.h"
+#include "UObject/StrongObjectPtr.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Private;
+
+namespace
+{
+// Compressed saves start with this, their format's name, and their size.
+// Uncompressed saves start with a GVAS tag instead.
+constexpr uint32 CompressedTag = 0x5A433555; // U5CZ
+
+#if ENGINE_MINOR_VERSION >= 1
+FPlatformUserId ToPlatformUser(int32 UserIndex)
+{
+	return FPlatformMisc::GetPlatformUserForUserIndex(UserIndex);
+}
+#else
+int32 ToPlatformUser(int32 UserIndex)
+{
+	return UserIndex;
+}
+#endif
+
+bool Compress(FName Format, TArray<uint8>& Data)
+{
+	TArray<uint8> Result;
+	FMemoryWriter Writer(Result);
+	uint32 Tag = CompressedTag;
+	FString FormatName = Format.ToString();
+	int64 Size = Data.Num();
+	Writer << Tag << FormatName << Size;
+
+	int32 HeaderSize = Result.Num();
+	int32 CompressedSize = FCompression::CompressMemoryBound(Format,
+	                                                         Data.Num());
+	Result.AddUninitialized(CompressedSize);
+	if (!FCompression::CompressMemory(Format, Result.GetData() + HeaderSize,
+	                                  CompressedSize, Data.GetData(),
+	                                  Data.Num()))
+		return false;
+	Result.SetNum(HeaderSize + CompressedSize);
+	Data = MoveTemp(Result);
+	return true;
+}
+
+bool Decompress(TArray<uint8>& Data)
+{
+	FMemoryReader Reader(Data);
+	uint32 Tag = 0;
+	Reader << Tag;
+	if (Reader.IsError() || Tag != CompressedTag)
+		return true; // Not compressed, leave it to LoadGameFromMemory
+
+	FString FormatName;
+	int64 Size = 0;
+	Reader << FormatName << Size;
+	if (Reader.IsError() || Size < 0 || Size > MAX_int32)
+		return false;
+
+	TArray<uint8> Result;
+	Result.SetNumUninitialized(static_cast<int32>(Size));
+	int32 HeaderSize = static_cast<int32>(Reader.Tell());
+	if (!FCompression::UncompressMemory(FName(FormatName), Result.GetData(),
+	                                    Result.Num(),
+	                                    Data.GetData() + HeaderSize,
+	                                    Data.Num() - HeaderSize))
+		return false;
+	Data = MoveTemp(Result);
+	return true;
+}
+}
+
+struct FSaveGameAwaiter::FState
+{
+	// Only used on the game thread
+	FPromise* Promise = nullptr;
+	TStrongObjectPtr<USaveGame> Loaded; // This might be carried across frames
+	bool bDone = false;
+	bool bSucceeded = false;
+
+	void Finish(bool bInSucceeded)
+	{
+		checkf(IsInGameThread(),
+		       TEXT("Internal error: expected save game on the game thread"));
+		bDone = true;
+		bSucceeded = bInSucceeded;
+		if (auto* ToResume = std::exchange(Promise, nullptr))
+			ToResume->Resume();
+	}
+};
+
+FSaveGameAwaiter Save::SaveGameAsync(USaveGame* SaveGame, FString SlotName,
+                                     int32 UserIndex, FName CompressionFormat)
+{
+	checkf(IsInGameThread(),
+	       TEXT("Save games may only be saved from the game thread"));
+	auto State = MakeShared<FSaveGameAwaiter::FState>();
+	auto* System = IPlatformFeaturesModule::Get().GetSaveGameSystem();
+
+	// Serializing UObjects is not safe off the game thread, the serialized
+	// bytes are the snapshot
+	TArray<uint8> Data;
+	if (!System || SlotName.IsEmpty() ||
+	    !UGameplayStatics::SaveGameToMemory(SaveGame, Data))
+	{
+		State->bDone = true;
+		return FSaveGameAwaiter(State);
+	}
+
+	AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask,
+	          [State, System, SlotName = MoveTemp(SlotName), UserIndex,
+	           CompressionFormat, Data = MoveTemp(Data)]() mutable
+	{
+		bool bSucceeded = (CompressionFormat.IsNone() ||
+		                   Compress(CompressionFormat, Data)) &&
+		                  System->SaveGame(false, *SlotName,
+		                                   ToPlatformUser(UserIndex), Data);
+		AsyncTask(ENamedThreads::GameThread,
+		          [State = MoveTemp(State), bSucceeded]
+		          {
+			          State->Finish(bSucceeded);
+		          });
+	});
+	return FSaveGameAwaiter(State);
+}
+
+FLoadGameAwaiter Save::LoadGameAsync(FString SlotName, int32 UserIndex)
+{
+	checkf(IsInGameThread(),
+	       TEXT("Save games may only be loaded from the game thread"));
+	auto State = MakeShared<FSaveGameAwaiter::FState>();
+	auto* System = IPlatformFeaturesModule::Get().GetSaveGameSystem();
+	if (!System || SlotName.IsEmpty())
+	{
+		State->bDone = true;
+		return FLoadGameAwaiter(State);
+	}
+
+	AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask,
+	          [State, System, SlotName = MoveTemp(SlotName), UserIndex]() mutable
+	{
+		TArray<uint8> Data;
+		bool bRead = System->LoadGame(false, *SlotName,
+		                              ToPlatformUser(UserIndex), Data) &&
+		             Decompress(Data);
+		if (!bRead)
+			Data.Empty();
+		AsyncTask(ENamedThreads::GameThread,
+		          [State = MoveTemp(State), Data = MoveTemp(Data)]
+		          {
+			          // LoadGameFromMemory fails on empty data
+			          auto* SaveGame =
+			              UGameplayStatics::LoadGameFromMemory(Data);
+			          State->Loaded.Reset(SaveGame);
+			          State->Finish(SaveGame != nullptr);
+		          });
+	});
+	return FLoadGameAwaiter(State);
+}
+
+FSaveGameAwaiter::FSaveGameAwaiter(TSharedPtr<FState> State)
+	: State(std::move(State))
+{
+}
+
+FSaveGameAwaiter::FSaveGameAwaiter(FSaveGameAwaiter&&) noexcept = default;
+
+FSaveGameAwaiter::~FSaveGameAwaiter()
+{
+	// Don't resume a coroutine that's being destroyed while suspended
+	if (State)
+		State->Promise = nullptr;
+}
+
+bool FSaveGameAwaiter::await_ready()
+{
+	checkf(IsInGameThread(),
+	       TEXT("Save games may only be awaited on the game thread"));
+	checkf(State, TEXT("Attempting to await a moved-from awaiter"));
+	return State->bDone;
+}
+
+void FSaveGameAwaiter::Suspend(FPromise& Promise)
+{
+	checkf(!State->Promise, TEXT("Attempted second concurrent co_await"));
+	State->Promise = &Promise;
+}
+
+bool FSaveGameAwaiter::await_resume()
+{
+	return State->bSucceeded;
+}
+
+USaveGame* FLoadGameAwaiter::await_resume()
+{
+	return State->Loaded.Get();
+}
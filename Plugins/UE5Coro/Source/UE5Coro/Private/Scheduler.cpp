@@ -0,0 +1,434 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "UE5Coro/Scheduler.h"
+#include "HAL/Event.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Private;
+
+namespace
+{
+/** Chase-Lev deque, as described in "Correct and Efficient Work-Stealing for
+ *  Weak Memory Models" (Lê et al. 2013).<br>
+ *  Only the owner pushes and pops the bottom, anyone can steal the top. */
+class FWorkStealingDeque final
+{
+	struct FRing
+	{
+		int64 Mask;
+		TUniquePtr<std::atomic<FPromise*>[]> Items;
+
+		explicit FRing(int64 Size)
+			: Mask(Size - 1), Items(MakeUnique<std::atomic<FPromise*>[]>(Size))
+		{
+		}
+
+		FPromise* Get(int64 Index) const
+		{
+			return Items[Index & Mask].load(std::memory_order_relaxed);
+		}
+
+		void Put(int64 Index, FPromise* Promise)
+		{
+			Items[Index & Mask].store(Promise, std::memory_order_relaxed);
+		}
+	};
+
+	std::atomic<int64> Top = 0;
+	std::atomic<int64> Bottom = 0;
+	std::atomic<FRing*> Ring;
+	// Thieves might still be reading old rings, these are freed at the end
+	TArray<TUniquePtr<FRing>> Rings;
+
+public:
+	FWorkStealingDeque()
+	{
+		Rings.Add(MakeUnique<FRing>(256));
+		Ring = Rings.Last().Get();
+	}
+
+	UE_NONCOPYABLE(FWorkStealingDeque);
+
+	void Push(FPromise* Promise)
+	{
+		auto B = Bottom.load(std::memory_order_relaxed);
+		auto T = Top.load(std::memory_order_acquire);
+		auto* R = Ring.load(std::memory_order_relaxed);
+		if (B - T > R->Mask)
+			R = Grow(R, T, B);
+		R->Put(B, Promise);
+		std::atomic_thread_fence(std::memory_order_release);
+		Bottom.store(B + 1, std::memory_order_relaxed);
+	}
+
+	FPromise* Pop()
+	{
+		auto B = Bottom.load(std::memory_order_relaxed) - 1;
+		auto* R = Ring.load(std::memory_order_relaxed);
+		Bottom.store(B, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		auto T = Top.load(std::memory_order_relaxed);
+		if (T > B)
+		{
+			Bottom.store(B + 1, std::memory_order_relaxed);
+			return nullptr;
+		}
+
+		auto* Promise = R->Get(B);
+		if (T == B)
+		{
+			// Last item, race the thieves for it
+			if (!Top.compare_exchange_strong(T, T + 1,
+			                                 std::memory_order_seq_cst,
+			                                 std::memory_order_relaxed))
+				Promise = nullptr;
+			Bottom.store(B + 1, std::memory_order_relaxed);
+		}
+		return Promise;
+	}
+
+	FPromise* Steal()
+	{
+		auto T = Top.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		auto B = Bottom.load(std::memory_order_acquire);
+		if (T >= B)
+			return nullptr;
+		auto* Promise = Ring.load(std::memory_order_acquire)->Get(T);
+		if (!Top.compare_exchange_strong(T, T + 1, std::memory_order_seq_cst,
+		                                 std::memory_order_relaxed))
+			return nullptr; // Lost the race
+		return Promise;
+	}
+
+private:
+	FRing* Grow(FRing* Old, int64 T, int64 B)
+	{
+		auto* New = Rings.Add_GetRef(MakeUnique<FRing>((Old->Mask + 1) * 2)).Get();
+		for (auto i = T; i < B; ++i)
+			New->Put(i, Old->Get(i));
+		Ring.store(New, std::memory_order_release);
+		return New;
+	}
+};
+}
+
+struct FScheduler::FWorker final : FRunnable
+{
+	FScheduler& Scheduler;
+	const int32 Index;
+	FWorkStealingDeque Deque;
+	std::atomic<FPromise*> LIFOSlot = nullptr;
+	FEvent* WakeEvent = FPlatformProcess::GetSynchEventFromPool(false);
+	FRunnableThread* Thread = nullptr;
+	uint32 Seed;
+	uint32 Tick = 0;
+	// Only written by this worker
+	std::atomic<uint64> NumResumed = 0;
+	std::atomic<uint64> NumFromLIFOSlot = 0;
+	std::atomic<uint64> NumStolen = 0;
+
+	explicit FWorker(FScheduler& Scheduler, int32 Index)
+		: Scheduler(Scheduler), Index(Index), Seed(Index * 2654435761u + 1) { }
+	UE_NONCOPYABLE(FWorker);
+
+	virtual ~FWorker() override
+	{
+		FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+	}
+
+	virtual uint32 Run() override;
+
+	FPromise* FindWork();
+	FPromise* TakeShared();
+	FPromise* StealWork();
+	void SetIdle(bool bIdle);
+};
+
+namespace
+{
+// FScheduler::FWorker*, it's private
+thread_local void* GCurrentWorker = nullptr;
+
+void Count(std::atomic<uint64>& Counter)
+{
+	// Single writer, readers are fine seeing stale values
+	Counter.store(Counter.load(std::memory_order_relaxed) + 1,
+	              std::memory_order_relaxed);
+}
+}
+
+uint32 FScheduler::FWorker::Run()
+{
+	GCurrentWorker = this;
+	for (;;)
+	{
+		auto* Promise = FindWork();
+		if (!Promise)
+		{
+			// Announce going to sleep, then check again to not miss anything
+			// that was scheduled in the meantime
+			SetIdle(true);
+			Promise = FindWork();
+			if (!Promise)
+			{
+				if (Scheduler.bStopping.load())
+				{
+					SetIdle(false);
+					break;
+				}
+				WakeEvent->Wait();
+				SetIdle(false);
+				continue;
+			}
+			SetIdle(false);
+		}
+		Count(NumResumed);
+		Promise->Resume();
+	}
+	GCurrentWorker = nullptr;
+	return 0;
+}
+
+FPromise* FScheduler::FWorker::FindWork()
+{
+	// Check the shared queue first every now and then, so that it can't be
+	// starved by coroutines that keep rescheduling themselves locally
+	if (++Tick % 61 == 0)
+		if (auto* Promise = TakeShared())
+			return Promise;
+
+	if (auto* Promise = LIFOSlot.exchange(nullptr, std::memory_order_acquire))
+	{
+		Count(NumFromLIFOSlot);
+		return Promise;
+	}
+	if (auto* Promise = Deque.Pop())
+		return Promise;
+	if (auto* Promise = TakeShared())
+		return Promise;
+	return StealWork();
+}
+
+FPromise* FScheduler::FWorker::TakeShared()
+{
+	FPromise* Promise = nullptr;
+	if (Scheduler.NumShared.load() > 0)
+	{
+		std::scoped_lock _(Scheduler.InboxLock);
+		if (auto* Node = Scheduler.InboxHead)
+		{
+			Scheduler.InboxHead = Node->Next;
+			if (!Scheduler.InboxHead)
+				Scheduler.InboxTail = nullptr;
+			Promise = static_cast<FPromise*>(Node->Target);
+			--Scheduler.NumShared;
+		}
+	}
+	return Promise;
+}
+
+FPromise* FScheduler::FWorker::StealWork()
+{
+	auto& Workers = Scheduler.Workers;
+	int32 Num = Workers.Num();
+	// xorshift, to not have every idle worker start at the same victim
+	Seed ^= Seed << 13;
+	Seed ^= Seed >> 17;
+	Seed ^= Seed << 5;
+	for (int32 i = 0, Start = Seed % Num; i < Num; ++i)
+	{
+		auto& Victim = *Workers[(Start + i) % Num];
+		if (&Victim == this)
+			continue;
+		auto* Promise = Victim.Deque.Steal();
+		if (!Promise)
+			Promise = Victim.LIFOSlot.exchange(nullptr,
+			                                   std::memory_order_acquire);
+		if (Promise)
+		{
+			Count(NumStolen);
+			return Promise;
+		}
+	}
+	return nullptr;
+}
+
+void FScheduler::FWorker::SetIdle(bool bIdle)
+{
+	{
+		std::scoped_lock _(Scheduler.IdleLock);
+		if (bIdle)
+		{
+			Scheduler.IdleWorkers.Add(Index);
+			++Scheduler.NumIdle;
+		}
+		else if (Scheduler.IdleWorkers.RemoveSingleSwap(Index))
+			--Scheduler.NumIdle;
+	}
+	// Pairs with WakeOne
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+FScheduler::FScheduler(int NumWorkers, EThreadPriority Priority)
+{
+	if (NumWorkers <= 0)
+		NumWorkers = FMath::Max(1, FPlatformMisc::NumberOfWorkerThreadsToSpawn());
+	IdleWorkers.Reserve(NumWorkers);
+
+	// Every worker needs to exist before any of them start stealing
+	for (int32 i = 0; i < NumWorkers; ++i)
+		Workers.Add(MakeUnique<FWorker>(*this, i));
+	for (auto& Worker : Workers)
+	{
+		Worker->Thread = FRunnableThread::Create(
+			Worker.Get(),
+			*FString::Printf(TEXT("UE5Coro::FScheduler worker %d"),
+			                 Worker->Index),
+			0, Priority);
+		checkf(Worker->Thread, TEXT("Could not create scheduler thread"));
+	}
+}
+
+FScheduler::~FScheduler()
+{
+	checkf(!IsInScheduler(),
+	       TEXT("Destroying a scheduler from one of its own workers"));
+	bStopping = true;
+	for (auto& Worker : Workers)
+		Worker->WakeEvent->Trigger();
+	for (auto& Worker : Workers)
+	{
+		Worker->Thread->WaitForCompletion();
+		delete Worker->Thread;
+	}
+	ensureMsgf(!InboxHead,
+	           TEXT("Coroutines were scheduled during destruction"));
+}
+
+int FScheduler::GetNumWorkers() const
+{
+	return Workers.Num();
+}
+
+bool FScheduler::IsInScheduler() const
+{
+	auto* Worker = static_cast<FWorker*>(GCurrentWorker);
+	return Worker && &Worker->Scheduler == this;
+}
+
+FScheduler::FStats FScheduler::GetStats() const
+{
+	FStats Stats;
+	for (auto& Worker : Workers)
+	{
+		Stats.NumResumed += Worker->NumResumed.load(std::memory_order_relaxed);
+		Stats.NumFromLIFOSlot +=
+			Worker->NumFromLIFOSlot.load(std::memory_order_relaxed);
+		Stats.NumStolen += Worker->NumStolen.load(std::memory_order_relaxed);
+	}
+	return Stats;
+}
+
+void FScheduler::Schedule(FPromise& Promise)
+{
+	if (!IsInScheduler())
+	{
+		ScheduleShared(Promise);
+		return;
+	}
+
+	// Whatever was in the LIFO slot can go where others may steal it
+	auto* Worker = static_cast<FWorker*>(GCurrentWorker);
+	if (auto* Old = Worker->LIFOSlot.exchange(&Promise,
+	                                          std::memory_order_acq_rel))
+	{
+		Worker->Deque.Push(Old);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		WakeOne();
+	}
+}
+
+void FScheduler::ScheduleShared(FPromise& Promise)
+{
+	{
+		auto& Node = Promise.InboxNode;
+		Node.Next = nullptr;
+		Node.Target = &Promise;
+		std::scoped_lock _(InboxLock);
+		(InboxTail ? InboxTail->Next : InboxHead) = &Node;
+		InboxTail = &Node;
+		++NumShared;
+	}
+	// Pairs with SetIdle
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	WakeOne();
+}
+
+void FScheduler::WakeOne()
+{
+	if (NumIdle.load(std::memory_order_relaxed) == 0)
+		return;
+
+	int32 Index = INDEX_NONE;
+	{
+		std::scoped_lock _(IdleLock);
+		if (IdleWorkers.Num() > 0)
+		{
+			Index = IdleWorkers.Pop();
+			--NumIdle;
+		}
+	}
+	if (Index != INDEX_NONE)
+		Workers[Index]->WakeEvent->Trigger();
+}
+
+bool FScheduler::TryYield(FPromise& Promise)
+{
+	auto* Worker = static_cast<FWorker*>(GCurrentWorker);
+	if (!Worker)
+		return false;
+	Worker->Scheduler.ScheduleShared(Promise);
+	return true;
+}
+
+FSchedulerAwaiter Async::MoveToScheduler(FScheduler& Scheduler)
+{
+	return FSchedulerAwaiter(Scheduler);
+}
+
+void FSchedulerAwaiter::Suspend(FPromise& Promise)
+{
+	Scheduler.Schedule(Promise);
+}
@@ -0,0 +1,144 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "UE5Coro/SocketAwaiters.h"
+#include "SocketPoller.h"
+#include "Sockets.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Private;
+
+FSocketAwaiter Sockets::Readable(FSocket& Socket)
+{
+	return FSocketAwaiter(Socket, false);
+}
+
+FSocketAwaiter Sockets::Writable(FSocket& Socket)
+{
+	return FSocketAwaiter(Socket, true);
+}
+
+TCoroutine<int32> Sockets::Receive(FSocket& Socket, TArrayView<uint8> Buffer)
+{
+	checkf(Buffer.Num() > 0, TEXT("Attempting to receive into empty buffer"));
+	for (;;)
+	{
+		if (!co_await Readable(Socket))
+			co_return 0;
+		// Streaming sockets report a closed connection as a failure
+		int32 BytesRead = 0;
+		if (!Socket.Recv(Buffer.GetData(), Buffer.Num(), BytesRead))
+			co_return 0;
+		if (BytesRead > 0)
+			co_return BytesRead;
+		// Readable was spurious, wait for the next one
+	}
+}
+
+TCoroutine<bool> Sockets::ReceiveExactly(FSocket& Socket,
+                                         TArrayView<uint8> Buffer)
+{
+	int32 Offset = 0;
+	while (Offset < Buffer.Num())
+	{
+		if (!co_await Readable(Socket))
+			co_return false;
+		int32 BytesRead = 0;
+		if (!Socket.Recv(Buffer.GetData() + Offset, Buffer.Num() - Offset,
+		                 BytesRead))
+			co_return false;
+		Offset += BytesRead;
+	}
+	co_return true;
+}
+
+FSocketAwaiter::FSocketAwaiter(const FSocketAwaiter& Other)
+	: FCancellationHook(&OnCanceled), Socket(Other.Socket)
+	, bWrite(Other.bWrite)
+{
+}
+
+FSocketAwaiter::~FSocketAwaiter()
+{
+	// The hook goes first, it could be racing the unregistration otherwise
+	Unhook();
+	if (UNLIKELY(Promise))
+		FSocketPoller::Get().TryUnregister(this);
+}
+
+void FSocketAwaiter::OnCanceled(FCancellationHook& Hook)
+{
+	// Hand the coroutine back early instead of waiting for the socket
+	FSocketPoller::Get().Cancel(static_cast<FSocketAwaiter*>(&Hook));
+}
+
+void FSocketAwaiter::Unhook()
+{
+	if (auto* Awaiting = std::exchange(Hooked, nullptr))
+		Awaiting->RemoveCancellationHook(*this);
+}
+
+bool FSocketAwaiter::IsReady() const
+{
+	return Socket->Wait(bWrite ? ESocketWaitConditions::WaitForWrite
+	                           : ESocketWaitConditions::WaitForRead,
+	                    FTimespan::Zero());
+}
+
+bool FSocketAwaiter::await_ready()
+{
+	// Skip the poller if there's something to do right away
+	return bResult = IsReady();
+}
+
+void FSocketAwaiter::Suspend(FPromise& InPromise)
+{
+	checkf(!Promise, TEXT("Internal error: double resume"));
+	Thread = FTaskGraphInterface::Get().GetCurrentThreadIfKnown();
+	// The poller dispatches Thread as-is
+	Thread = InPromise.WithTaskPriority(Thread);
+	Promise = &InPromise;
+	// Nothing else can see this before the hook is added
+	bCanceled = false;
+	// The hook might run right away and set bCanceled in the poller's lock
+	if (LIKELY(InPromise.AddCancellationHook(*this)))
+		Hooked = &InPromise;
+	else
+		bCanceled = true;
+	FSocketPoller::Get().Register(this);
+}
+
+bool FSocketAwaiter::await_resume()
+{
+	// Allow this awaiter to be reused
+	Unhook();
+	return bResult;
+}
@@ -0,0 +1,184 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "SocketPoller.h"
+#include "GameThreadInbox.h"
+#include <mutex>
+#include "Sockets.h"
+#include "Async/Async.h"
+#include "HAL/IConsoleManager.h"
+
+using namespace UE5Coro::Private;
+
+std::once_flag FSocketPoller::Once;
+FSocketPoller* FSocketPoller::Instance;
+
+namespace
+{
+TAutoConsoleVariable<float> CVarSocketPollInterval(
+	TEXT("UE5Coro.SocketPollInterval"), 0.001f,
+	TEXT("Seconds that the socket poller thread sleeps when none of the ")
+	TEXT("awaited sockets were ready. New co_awaits wake it up early."));
+
+// Failed sockets usually report being readable and writable, this only
+// catches the rest, so it doesn't need to run on every round
+constexpr double ErrorCheckInterval = 0.1;
+}
+
+FSocketPoller& FSocketPoller::Get()
+{
+	std::call_once(Once, [] { Instance = new FSocketPoller; });
+	return *Instance;
+}
+
+void FSocketPoller::Register(FSocketAwaiter* Awaiter)
+{
+	std::unique_lock _(Lock);
+	// The cancellation hook might have run before this
+	if (UNLIKELY(Awaiter->bCanceled))
+	{
+		auto Thread = Awaiter->Thread;
+		auto* Promise = Awaiter->Promise.exchange(nullptr);
+		_.unlock();
+		if (!FGameThreadInbox::TryPush(Thread, *Promise))
+			AsyncTask(Thread, [Promise] { Promise->Resume(); });
+		return;
+	}
+	checkf(Awaiter->QueueIndex == INDEX_NONE,
+	       TEXT("Internal error: double socket registration"));
+	Awaiter->QueueIndex = Awaiters.Add(Awaiter);
+	Event->Trigger();
+}
+
+void FSocketPoller::TryUnregister(FSocketAwaiter* Awaiter)
+{
+	std::scoped_lock _(Lock);
+	if (Awaiter->QueueIndex != INDEX_NONE)
+		RemoveAt(Awaiter->QueueIndex);
+}
+
+void FSocketPoller::Cancel(FSocketAwaiter* Awaiter)
+{
+	std::unique_lock _(Lock);
+	if (Awaiter->QueueIndex == INDEX_NONE)
+	{
+		// Either not registered yet, in which case Register will pick this
+		// up, or already claimed, in which case the resume is on its way
+		Awaiter->bCanceled = true;
+		return;
+	}
+	RemoveAt(Awaiter->QueueIndex);
+	auto Thread = Awaiter->Thread;
+	auto* Promise = Awaiter->Promise.exchange(nullptr);
+	checkf(Promise, TEXT("Internal error: queued socket without a promise"));
+	_.unlock();
+	// The resume is pushed to the thread that would have resumed normally,
+	// where it will see the cancellation and destroy the coroutine
+	if (!FGameThreadInbox::TryPush(Thread, *Promise))
+		AsyncTask(Thread, [Promise] { Promise->Resume(); });
+}
+
+FSocketPoller::FSocketPoller()
+	: Event(FPlatformProcess::GetSynchEventFromPool())
+	, Thread(TEXT("UE5Coro Socket Poller"), [this] { Run(); })
+{
+}
+
+void FSocketPoller::Run()
+{
+	for (;;)
+		RunOnce();
+}
+
+void FSocketPoller::RunOnce()
+{
+	bool bIdle, bEmpty;
+	{
+		// Awaiters can't be destroyed while they're being checked
+		std::scoped_lock _(Lock);
+		double Now = FPlatformTime::Seconds();
+		bool bCheckErrors = Now >= NextErrorCheck;
+		if (bCheckErrors)
+			NextErrorCheck = Now + ErrorCheckInterval;
+		int32 NumBefore = Awaiters.Num();
+		// Backwards, RemoveAt only moves already checked awaiters
+		for (int32 i = Awaiters.Num() - 1; i >= 0; --i)
+		{
+			auto* Awaiter = Awaiters[i];
+			if (Awaiter->IsReady())
+				Claim(Awaiter, true);
+			else if (bCheckErrors && Awaiter->Socket->GetConnectionState() ==
+			                         SCS_ConnectionError)
+				Claim(Awaiter, false);
+		}
+		// Something became ready, there's probably more to come soon
+		bIdle = Awaiters.Num() == NumBefore;
+		bEmpty = Awaiters.Num() == 0;
+	}
+	Dispatch();
+
+	if (bEmpty)
+		Event->Wait();
+	else if (bIdle)
+		Event->Wait(FTimespan::FromSeconds(
+			CVarSocketPollInterval.GetValueOnAnyThread()));
+}
+
+void FSocketPoller::RemoveAt(int32 Index)
+{
+	checkf(Awaiters[Index]->QueueIndex == Index,
+	       TEXT("Internal error: bad index"));
+	Awaiters[Index]->QueueIndex = INDEX_NONE;
+	auto* Last = Awaiters.Pop();
+	if (Index < Awaiters.Num())
+	{
+		Awaiters[Index] = Last;
+		Last->QueueIndex = Index;
+	}
+}
+
+void FSocketPoller::Claim(FSocketAwaiter* Awaiter, bool bResult)
+{
+	RemoveAt(Awaiter->QueueIndex);
+	Awaiter->bResult = bResult;
+	auto* Promise = Awaiter->Promise.exchange(nullptr);
+	checkf(Promise, TEXT("Internal error: spurious resume without suspension"));
+	Promise->MarkAwaitReady();
+	if (!FGameThreadInbox::TryPush(Awaiter->Thread, *Promise))
+		Ready.Emplace(Awaiter->Thread, Promise);
+}
+
+void FSocketPoller::Dispatch()
+{
+	for (auto& [Thread, Promise] : Ready)
+		AsyncTask(Thread, [Promise = Promise] { Promise->Resume(); });
+	Ready.Reset();
+}
@@ -0,0 +1,75 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UE5Coro/Definitions.h"
+#include "HAL/Thread.h"
+#include "UE5Coro/Private.h"
+#include "UE5Coro/SocketAwaiters.h"
+
+namespace UE5Coro::Private
+{
+/** Checks every suspended FSocketAwaiter from a single thread.<br>
+ *  The engine doesn't expose native socket handles portably, so instead of
+ *  epoll/kqueue this polls each socket with a zero timeout, and sleeps for
+ *  UE5Coro.SocketPollInterval between rounds where nothing was ready. */
+class FSocketPoller final
+{
+	static std::once_flag Once;
+	static FSocketPoller* Instance;
+
+	FEvent* Event;
+	FMutex Lock;
+	TArray<FSocketAwaiter*> Awaiters;
+	double NextErrorCheck = 0;
+	TArray<TPair<ENamedThreads::Type, FPromise*>> Ready; // Poller thread only
+	FThread Thread; // Must come last
+
+public:
+	static FSocketPoller& Get();
+	void Register(FSocketAwaiter*);
+	void TryUnregister(FSocketAwaiter*);
+	/** Resumes the awaiter's coroutine early if it hasn't been resumed yet.
+	 *  Called from the awaiter's cancellation hook. */
+	void Cancel(FSocketAwaiter*);
+
+private:
+	explicit FSocketPoller();
+	~FSocketPoller() = delete;
+	void Run();
+	void RunOnce();
+	void RemoveAt(int32 Index);
+	void Claim(FSocketAwaiter*, bool bResult);
+	void Dispatch();
+};
+}
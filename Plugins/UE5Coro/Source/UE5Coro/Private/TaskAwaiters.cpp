@@ -33,12 +33,74 @@
 
 using namespace UE5Coro::Private;
 
-FTaskAwaiter UE5Coro::Tasks::MoveToTask(const TCHAR* DebugName)
+#if ENGINE_MINOR_VERSION >= 1
+FTaskAwaiter UE5Coro::Tasks::MoveToTask(
+	const TCHAR* DebugName, UE::Tasks::ETaskPriority Priority,
+	UE::Tasks::EExtendedTaskPriority ExtendedPriority)
 {
-	return FTaskAwaiter(DebugName);
+	return FTaskAwaiter(DebugName, Priority, ExtendedPriority);
+}
+
+FPipeAwaiter UE5Coro::Tasks::MoveToPipe(
+	UE::Tasks::FPipe& Pipe, const TCHAR* DebugName,
+	UE::Tasks::ETaskPriority Priority,
+	UE::Tasks::EExtendedTaskPriority ExtendedPriority)
+{
+	return FPipeAwaiter(Pipe, FTaskAwaiter(DebugName, Priority,
+	                                       ExtendedPriority));
 }
 
 void FTaskAwaiter::Suspend(FPromise& Promise)
 {
-	UE::Tasks::Launch(DebugName, [&Promise] { Promise.Resume(); });
+	UE::Tasks::Launch(DebugName, [&Promise] { Promise.Resume(); }, Priority,
+	                  ExtendedPriority);
+}
+
+void FPipeAwaiter::Suspend(FPromise& Promise)
+{
+	Pipe.Launch(Task.DebugName, [&Promise] { Promise.Resume(); },
+	            Task.Priority, Task.ExtendedPriority);
+}
+#else
+FTaskAwaiter UE5Coro::Tasks::MoveToTask(const TCHAR* DebugName,
+                                        UE::Tasks::ETaskPriority Priority)
+{
+	return FTaskAwaiter(DebugName, Priority);
+}
+
+FPipeAwaiter UE5Coro::Tasks::MoveToPipe(UE::Tasks::FPipe& Pipe,
+                                        const TCHAR* DebugName,
+                                        UE::Tasks::ETaskPriority Priority)
+{
+	return FPipeAwaiter(Pipe, FTaskAwaiter(DebugName, Priority));
+}
+
+void FTaskAwaiter::Suspend(FPromise& Promise)
+{
+	UE::Tasks::Launch(DebugName, [&Promise] { Promise.Resume(); }, Priority);
+}
+
+void FPipeAwaiter::Suspend(FPromise& Promise)
+{
+	Pipe.Launch(Task.DebugName, [&Promise] { Promise.Resume(); },
+	            Task.Priority);
+}
+#endif
+
+FTaskWhenAllAwaiter UE5Coro::Tasks::WhenAll(TArray<UE::Tasks::FTask> Tasks)
+{
+	return FTaskWhenAllAwaiter(std::move(Tasks));
+}
+
+bool FTaskWhenAllAwaiter::await_ready()
+{
+	for (auto& Task : Tasks)
+		if (!Task.IsCompleted())
+			return false;
+	return true;
+}
+
+void FTaskWhenAllAwaiter::Suspend(FPromise& Promise)
+{
+	ResumeAfter(Promise, TEXT("UE5Coro Tasks::WhenAll"), Tasks);
 }
@@ -30,8 +30,11 @@
 // ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "TimerThread.h"
-#include "UE5Coro/AsyncAwaiters.h"
+#include "GameThreadInbox.h"
 #include <mutex>
+#include "Algo/StableSort.h"
+#include "Async/Async.h"
+#include "HAL/IConsoleManager.h"
 
 using namespace UE5Coro::Private;
 
@@ -40,12 +43,282 @@ FTimerThread* FTimerThread::Instance;
 
 namespace
 {
-// TArray auto-dereferencing requires an explicit predicate
-bool Less(const FAsyncTimeAwaiter& A, const FAsyncTimeAwaiter& B)
+TAutoConsoleVariable<bool> CVarExactTimers(
+	TEXT("UE5Coro.ExactTimers"), false,
+	TEXT("Use a heap instead of a timing wheel for Async::PlatformSeconds, ")
+	TEXT("resuming timers in exact order without millisecond rounding. ")
+	TEXT("Only read when the timer thread starts."),
+	ECVF_ReadOnly);
+
+TAutoConsoleVariable<int32> CVarTimerBatchSize(
+	TEXT("UE5Coro.TimerBatchSize"), 64,
+	TEXT("Maximum number of expired Async::PlatformSeconds timers that are ")
+	TEXT("resumed by a single task. Expired timers are grouped by their target ")
+	TEXT("thread, and every group is split into tasks of at most this size."));
+
+TAutoConsoleVariable<float> CVarTimerSpinTime(
+	TEXT("UE5Coro.TimerSpinTime"), 0.002f,
+	TEXT("Seconds before the target time of an Async::PlatformSecondsPrecise ")
+	TEXT("timer when the timer thread stops sleeping and starts spinning."));
+
+FAutoConsoleCommandWithOutputDevice CmdTimerLateness(
+	TEXT("UE5Coro.TimerLateness"),
+	TEXT("Prints how late Async::PlatformSeconds timers were resumed."),
+	FConsoleCommandWithOutputDeviceDelegate::CreateLambda([](FOutputDevice& Ar)
+	{
+		auto Stats = FTimerLateness::Get();
+		Ar.Logf(TEXT("Lateness             Standard      Precise"));
+		for (int i = 0; i < FTimerLateness::NumBuckets; ++i)
+		{
+			FString Range = TEXT("<1 us");
+			if (i == FTimerLateness::NumBuckets - 1)
+				Range = FString::Printf(TEXT(">=%d us"), 1 << (i - 1));
+			else if (i > 0)
+				Range = FString::Printf(TEXT("%d-%d us"), 1 << (i - 1), 1 << i);
+			Ar.Logf(TEXT("%-16s %12llu %12llu"), *Range, Stats.Standard[i],
+			        Stats.Precise[i]);
+		}
+	}));
+
+int BucketOf(double Seconds)
+{
+	auto Micros = static_cast<uint64>(FMath::Max(0.0, Seconds) * 1e6);
+	int Bucket = Micros == 0
+		? 0 : static_cast<int>(FMath::FloorLog2_64(Micros)) + 1;
+	return FMath::Min(Bucket, FTimerLateness::NumBuckets - 1);
+}
+}
+
+FTimerLateness FTimerLateness::Get()
+{
+	return FTimerThread::Get().GetLateness();
+}
+
+#pragma region FTimerHeap
+void FTimerHeap::Add(FAsyncTimeAwaiter* Awaiter)
+{
+	checkf(Awaiter->QueueIndex == INDEX_NONE,
+	       TEXT("Internal error: double timer registration"));
+	Place(Awaiter, Heap.Add(Awaiter));
+	SiftUp(Awaiter->QueueIndex);
+}
+
+void FTimerHeap::Remove(FAsyncTimeAwaiter* Awaiter)
+{
+	if (Awaiter->QueueIndex != INDEX_NONE)
+		RemoveAt(Awaiter->QueueIndex);
+}
+
+double FTimerHeap::GetNextTime() const
+{
+	return Heap.Num() > 0 ? Heap[0]->TargetTime : NoTime;
+}
+
+void FTimerHeap::Expire(double Now,
+                        TFunctionRef<void(FAsyncTimeAwaiter*)> Fn)
+{
+	while (Heap.Num() > 0 && Heap[0]->TargetTime <= Now)
+	{
+		auto* Awaiter = Heap[0];
+		RemoveAt(0);
+		Fn(Awaiter);
+	}
+}
+
+void FTimerHeap::RemoveAt(int32 Index)
+{
+	checkf(Heap[Index]->QueueIndex == Index, TEXT("Internal error: bad index"));
+	Heap[Index]->QueueIndex = INDEX_NONE;
+	auto* Last = Heap.Pop();
+	if (Index < Heap.Num())
+	{
+		Place(Last, Index);
+		SiftDown(Index);
+		SiftUp(Last->QueueIndex);
+	}
+}
+
+void FTimerHeap::Place(FAsyncTimeAwaiter* Awaiter, int32 Index)
+{
+	Heap[Index] = Awaiter;
+	Awaiter->QueueIndex = Index;
+}
+
+void FTimerHeap::SiftUp(int32 Index)
+{
+	while (Index > 0)
+	{
+		int32 Parent = (Index - 1) / 2;
+		if (!(*Heap[Index] < *Heap[Parent]))
+			break;
+		auto* Awaiter = Heap[Index];
+		Place(Heap[Parent], Index);
+		Place(Awaiter, Parent);
+		Index = Parent;
+	}
+}
+
+void FTimerHeap::SiftDown(int32 Index)
+{
+	for (;;)
+	{
+		int32 Smallest = Index;
+		for (int32 Child = 2 * Index + 1;
+		     Child <= 2 * Index + 2 && Child < Heap.Num(); ++Child)
+			if (*Heap[Child] < *Heap[Smallest])
+				Smallest = Child;
+		if (Smallest == Index)
+			break;
+		auto* Awaiter = Heap[Index];
+		Place(Heap[Smallest], Index);
+		Place(Awaiter, Smallest);
+		Index = Smallest;
+	}
+}
+#pragma endregion
+
+#pragma region FTimerWheel
+FTimerWheel::FTimerWheel()
+	: StartTime(FPlatformTime::Seconds())
+{
+}
+
+void FTimerWheel::Add(FAsyncTimeAwaiter* Awaiter)
+{
+	checkf(Awaiter->QueueIndex == INDEX_NONE,
+	       TEXT("Internal error: double timer registration"));
+	Insert(Awaiter);
+	++Num;
+}
+
+void FTimerWheel::Remove(FAsyncTimeAwaiter* Awaiter)
+{
+	if (Awaiter->QueueIndex == INDEX_NONE)
+		return;
+	Unlink(Awaiter);
+	--Num;
+}
+
+double FTimerWheel::GetNextTime() const
+{
+	if (Num == 0)
+		return NoTime;
+
+	// Look for something in the innermost level, up to the next cascade
+	for (uint64 Tick = CurrentTick; ; ++Tick)
+	{
+		if (Slots[0][Tick % NumSlots])
+			return TimeOf(Tick + 1);
+		if ((Tick + 1) % NumSlots == 0)
+			return TimeOf(Tick + 1); // Wake up to cascade
+	}
+}
+
+void FTimerWheel::Expire(double Now,
+                         TFunctionRef<void(FAsyncTimeAwaiter*)> Fn)
+{
+	// Ticks are only expired after they've fully elapsed
+	while (Num > 0 && TimeOf(CurrentTick + 1) <= Now)
+	{
+		for (auto*& Head = Slots[0][CurrentTick % NumSlots]; Head;)
+		{
+			auto* Awaiter = Head;
+			Unlink(Awaiter);
+			--Num;
+			Fn(Awaiter);
+		}
+		Advance();
+	}
+
+	// With nothing queued there's nothing to cascade, skip ahead
+	if (Num == 0)
+		CurrentTick = FMath::Max(CurrentTick, TickOf(Now));
+}
+
+uint64 FTimerWheel::TickOf(double Time) const
+{
+	return Time <= StartTime
+		? 0 : static_cast<uint64>((Time - StartTime) / TickSeconds);
+}
+
+double FTimerWheel::TimeOf(uint64 Tick) const
+{
+	return StartTime + static_cast<double>(Tick) * TickSeconds;
+}
+
+FAsyncTimeAwaiter*& FTimerWheel::ListAt(int32 QueueIndex)
+{
+	if (QueueIndex == OverflowIndex)
+		return Overflow;
+	return Slots[QueueIndex / NumSlots][QueueIndex % NumSlots];
+}
+
+void FTimerWheel::Insert(FAsyncTimeAwaiter* Awaiter)
+{
+	uint64 Tick = FMath::Max(TickOf(Awaiter->TargetTime), CurrentTick);
+	uint64 Delta = Tick - CurrentTick;
+	for (int Level = 0; Level < NumLevels; ++Level)
+		if (Delta < 1ull << (SlotBits * (Level + 1)))
+		{
+			auto Slot = (Tick >> (SlotBits * Level)) % NumSlots;
+			Link(Awaiter, Level * NumSlots + static_cast<int32>(Slot));
+			return;
+		}
+	Link(Awaiter, OverflowIndex);
+}
+
+void FTimerWheel::Link(FAsyncTimeAwaiter* Awaiter, int32 QueueIndex)
+{
+	auto*& Head = ListAt(QueueIndex);
+	Awaiter->Prev = nullptr;
+	Awaiter->Next = Head;
+	if (Head)
+		Head->Prev = Awaiter;
+	Head = Awaiter;
+	Awaiter->QueueIndex = QueueIndex;
+}
+
+void FTimerWheel::Unlink(FAsyncTimeAwaiter* Awaiter)
 {
-	return A < B;
+	if (Awaiter->Prev)
+		Awaiter->Prev->Next = Awaiter->Next;
+	else
+		ListAt(Awaiter->QueueIndex) = Awaiter->Next;
+	if (Awaiter->Next)
+		Awaiter->Next->Prev = Awaiter->Prev;
+	Awaiter->Prev = Awaiter->Next = nullptr;
+	Awaiter->QueueIndex = INDEX_NONE;
 }
+
+void FTimerWheel::Cascade(int32 QueueIndex)
+{
+	// Redistribute the list, usually into lower levels
+	auto* List = std::exchange(ListAt(QueueIndex), nullptr);
+	while (List)
+	{
+		auto* Next = List->Next;
+		List->Prev = List->Next = nullptr;
+		List->QueueIndex = INDEX_NONE;
+		Insert(List);
+		List = Next;
+	}
+}
+
+void FTimerWheel::Advance()
+{
+	++CurrentTick;
+	// Entering a new lap of a level pulls down the next slot of the level above
+	for (int Level = 1; Level < NumLevels; ++Level)
+	{
+		if ((CurrentTick >> (SlotBits * (Level - 1))) % NumSlots != 0)
+			return;
+		auto Slot = (CurrentTick >> (SlotBits * Level)) % NumSlots;
+		Cascade(Level * NumSlots + static_cast<int32>(Slot));
+	}
+	if ((CurrentTick >> (SlotBits * (NumLevels - 1))) % NumSlots == 0)
+		Cascade(OverflowIndex);
 }
+#pragma endregion
 
 FTimerThread& FTimerThread::Get()
 {
@@ -55,23 +328,78 @@ FTimerThread& FTimerThread::Get()
 
 void FTimerThread::Register(FAsyncTimeAwaiter* Awaiter)
 {
+	std::unique_lock _(Lock);
+	// The cancellation hook might have run before this
+	if (UNLIKELY(Awaiter->bCanceled))
+	{
+		auto Thread = Awaiter->U.Thread;
+		auto* Promise = Awaiter->Promise.exchange(nullptr);
+		_.unlock();
+		if (!FGameThreadInbox::TryPush(Thread, *Promise))
+			AsyncTask(Thread, [Promise] { Promise->Resume(); });
+		return;
+	}
+	QueueFor(Awaiter).Add(Awaiter);
+	Event->Trigger();
+}
+
+void FTimerThread::RegisterCallback(FAsyncTimeAwaiter* Awaiter,
+                                    void (*Fn)(void*), void* Context)
+{
+	checkf(!Awaiter->Promise, TEXT("Internal error: timer already in use"));
+	Awaiter->Callback = Fn;
+	Awaiter->Context = Context;
 	std::scoped_lock _(Lock);
-	Queue.HeapPush(Awaiter, &Less);
+	QueueFor(Awaiter).Add(Awaiter);
 	Event->Trigger();
 }
 
-void FTimerThread::TryUnregister(FAsyncTimeAwaiter* Awaiter)
+bool FTimerThread::TryUnregister(FAsyncTimeAwaiter* Awaiter)
 {
 	std::scoped_lock _(Lock);
-	// Slow, but this function is called extremely rarely
-	auto Idx = Queue.Find(Awaiter);
-	if (Idx == INDEX_NONE)
+	bool bQueued = Awaiter->QueueIndex != INDEX_NONE;
+	// O(1) or O(log n), awaiters know their position
+	QueueFor(Awaiter).Remove(Awaiter);
+	return bQueued;
+}
+
+void FTimerThread::Cancel(FAsyncTimeAwaiter* Awaiter)
+{
+	std::unique_lock _(Lock);
+	if (Awaiter->QueueIndex == INDEX_NONE)
+	{
+		// Either not registered yet, in which case Register will pick this
+		// up, or already claimed, in which case the resume is on its way
+		Awaiter->bCanceled = true;
 		return;
-	Queue.HeapRemoveAt(Idx, &Less);
+	}
+	QueueFor(Awaiter).Remove(Awaiter);
+	auto Thread = Awaiter->U.Thread;
+	auto* Promise = Awaiter->Promise.exchange(nullptr);
+	checkf(Promise, TEXT("Internal error: queued timer without a promise"));
+	_.unlock();
+	// The resume is pushed to the thread that would have resumed normally,
+	// where it will see the cancellation and destroy the coroutine
+	if (!FGameThreadInbox::TryPush(Thread, *Promise))
+		AsyncTask(Thread, [Promise] { Promise->Resume(); });
+}
+
+FTimerLateness FTimerThread::GetLateness() const
+{
+	FTimerLateness Stats;
+	for (int i = 0; i < FTimerLateness::NumBuckets; ++i)
+	{
+		Stats.Standard[i] = Lateness[0][i].load(std::memory_order_relaxed);
+		Stats.Precise[i] = Lateness[1][i].load(std::memory_order_relaxed);
+	}
+	return Stats;
 }
 
 FTimerThread::FTimerThread()
 	: Event(FPlatformProcess::GetSynchEventFromPool())
+	, Queue(CVarExactTimers.GetValueOnAnyThread()
+		? TUniquePtr<FTimerQueue>(MakeUnique<FTimerHeap>())
+		: TUniquePtr<FTimerQueue>(MakeUnique<FTimerWheel>()))
 	, Thread(TEXT("UE5Coro Timer Thread"), [this] { Run(); })
 {
 }
@@ -84,30 +412,103 @@ void FTimerThread::Run()
 
 void FTimerThread::RunOnce()
 {
+	double Next, PreciseNext;
+	{
+		std::scoped_lock _(Lock);
+		Next = Queue->GetNextTime();
+		PreciseNext = PreciseQueue.GetNextTime();
+	}
+
+	// Precise timers wake up early and spin the rest of the way
+	double WakeTime = Next;
+	if (PreciseNext != FTimerQueue::NoTime)
+	{
+		double SpinTime = CVarTimerSpinTime.GetValueOnAnyThread();
+		WakeTime = FMath::Min(WakeTime, PreciseNext - SpinTime);
+	}
 	auto Wait = FTimespan::MaxValue();
+	if (WakeTime != FTimerQueue::NoTime)
+		Wait = FMath::Max(FTimespan::Zero(),
+		                  FTimespan::FromSeconds(WakeTime -
+		                                         FPlatformTime::Seconds()));
+	if (!Event->Wait(Wait) && PreciseNext < Next)
+		Spin(PreciseNext);
+
 	{
+		// Only claim the promises while locked, everything else can wait
 		std::scoped_lock _(Lock);
-		if (Queue.Num() > 0)
-			Wait = FMath::Max(FTimespan::Zero(),
-			                  FTimespan::FromSeconds(Queue.HeapTop()->TargetTime -
-			                                         FPlatformTime::Seconds()));
+		double Now = FPlatformTime::Seconds();
+		auto Fn = [&](FAsyncTimeAwaiter* Awaiter) { Claim(Awaiter, Now); };
+		PreciseQueue.Expire(Now, Fn);
+		Queue->Expire(Now, Fn);
 	}
-	Event->Wait(Wait);
-	std::scoped_lock _(Lock);
-	auto Now = FPlatformTime::Seconds();
-	while (Queue.Num() > 0)
+	Dispatch();
+}
+
+void FTimerThread::Spin(double Until)
+{
+	while (FPlatformTime::Seconds() < Until)
+	{
+		// A new registration might be due sooner, or it might need a cascade
+		if (Event->Wait(0))
+			return;
+		FPlatformProcess::YieldThread();
+	}
+}
+
+void FTimerThread::Claim(FAsyncTimeAwaiter* Awaiter, double Now)
+{
+	if (Awaiter->Callback)
+	{
+		ExpiredCallbacks.Add(Awaiter);
+		return;
+	}
+	auto* Promise = Awaiter->Promise.exchange(nullptr);
+	checkf(Promise, TEXT("Internal error: spurious resume without suspension"));
+	Promise->MarkAwaitReady();
+	if (!FGameThreadInbox::TryPush(Awaiter->U.Thread, *Promise))
+		Expired.Emplace(Awaiter->U.Thread, Promise);
+	// Only this thread writes these
+	int Index = BucketOf(Now - Awaiter->TargetTime);
+	auto& Bucket = Lateness[Awaiter->bPrecise][Index];
+	Bucket.store(Bucket.load(std::memory_order_relaxed) + 1,
+	             std::memory_order_relaxed);
+}
+
+void FTimerThread::Dispatch()
+{
+	// The callbacks' owners may free their awaiters as soon as they're called
+	for (auto* Awaiter : ExpiredCallbacks)
+		Awaiter->Callback(Awaiter->Context);
+	ExpiredCallbacks.Reset();
+
+	if (Expired.Num() == 0)
+		return;
+
+	// Group by thread, keeping the original order within each group
+	Algo::StableSortBy(Expired, [](auto& Pair) { return Pair.Key; });
+
+	int32 BatchSize = FMath::Max(1, CVarTimerBatchSize.GetValueOnAnyThread());
+	for (int32 Start = 0; Start < Expired.Num();)
 	{
-		if (auto& Next = Queue.HeapTop(); Next->TargetTime <= Now)
+		auto Thread = Expired[Start].Key;
+		TArray<FPromise*> Batch;
+		Batch.Reserve(FMath::Min(BatchSize, Expired.Num() - Start));
+		for (; Start < Expired.Num() && Expired[Start].Key == Thread &&
+		       Batch.Num() < BatchSize; ++Start)
+			Batch.Add(Expired[Start].Value);
+		AsyncTask(Thread, [Batch = std::move(Batch)]
 		{
-			Resume(Next);
-			Queue.HeapPopDiscard(&Less);
-		}
-		else
-			break;
+			for (auto* Promise : Batch)
+				Promise->Resume();
+		});
 	}
+	Expired.Reset();
 }
 
-void FTimerThread::Resume(FAsyncTimeAwaiter* Awaiter)
+FTimerQueue& FTimerThread::QueueFor(FAsyncTimeAwaiter* Awaiter)
 {
-	Awaiter->Resume();
+	if (Awaiter->bPrecise)
+		return PreciseQueue;
+	return *Queue;
 }
@@ -33,10 +33,84 @@
 
 #include "CoreMinimal.h"
 #include "UE5Coro/Definitions.h"
+#include "UE5Coro/AsyncAwaiters.h"
 #include "UE5Coro/Private.h"
 
 namespace UE5Coro::Private
 {
+class FAsyncTimeAwaiter;
+
+/** Pending FAsyncTimeAwaiters. Not thread safe, FTimerThread locks these. */
+class FTimerQueue
+{
+public:
+	virtual ~FTimerQueue() = default;
+	virtual void Add(FAsyncTimeAwaiter*) = 0;
+	virtual void Remove(FAsyncTimeAwaiter*) = 0;
+	/** Returns the earliest time something might be due, or NoTime. */
+	virtual double GetNextTime() const = 0;
+	/** Removes everything that's due at Now, calling Fn on each of them. */
+	virtual void Expire(double Now,
+	                    TFunctionRef<void(FAsyncTimeAwaiter*)> Fn) = 0;
+
+	static constexpr double NoTime = TNumericLimits<double>::Max();
+};
+
+/** Binary heap with exact ordering and O(log n) register and cancel. */
+class FTimerHeap final : public FTimerQueue
+{
+	TArray<FAsyncTimeAwaiter*> Heap;
+
+public:
+	virtual void Add(FAsyncTimeAwaiter*) override;
+	virtual void Remove(FAsyncTimeAwaiter*) override;
+	virtual double GetNextTime() const override;
+	virtual void Expire(double Now,
+	                    TFunctionRef<void(FAsyncTimeAwaiter*)>) override;
+
+private:
+	void RemoveAt(int32 Index);
+	void Place(FAsyncTimeAwaiter*, int32 Index);
+	void SiftUp(int32 Index);
+	void SiftDown(int32 Index);
+};
+
+/** Hierarchical timing wheel with O(1) register and cancel.<br>
+ *  Timers are resolved at millisecond granularity, in no particular order
+ *  within the same millisecond. */
+class FTimerWheel final : public FTimerQueue
+{
+	static constexpr int SlotBits = 8;
+	static constexpr int NumSlots = 1 << SlotBits;
+	static constexpr int NumLevels = 4;
+	static constexpr double TickSeconds = 0.001;
+	static constexpr int32 OverflowIndex = NumLevels * NumSlots;
+
+	double StartTime;
+	uint64 CurrentTick = 0; // Every tick before this has been expired
+	int32 Num = 0;
+	FAsyncTimeAwaiter* Slots[NumLevels][NumSlots] = {};
+	FAsyncTimeAwaiter* Overflow = nullptr;
+
+public:
+	FTimerWheel();
+	virtual void Add(FAsyncTimeAwaiter*) override;
+	virtual void Remove(FAsyncTimeAwaiter*) override;
+	virtual double GetNextTime() const override;
+	virtual void Expire(double Now,
+	                    TFunctionRef<void(FAsyncTimeAwaiter*)>) override;
+
+private:
+	uint64 TickOf(double Time) const;
+	double TimeOf(uint64 Tick) const;
+	FAsyncTimeAwaiter*& ListAt(int32 QueueIndex);
+	void Insert(FAsyncTimeAwaiter*);
+	void Link(FAsyncTimeAwaiter*, int32 QueueIndex);
+	void Unlink(FAsyncTimeAwaiter*);
+	void Cascade(int32 QueueIndex);
+	void Advance();
+};
+
 class UE5CORO_API FTimerThread final
 {
 	static std::once_flag Once;
@@ -44,19 +118,35 @@ class UE5CORO_API FTimerThread final
 
 	FEvent* Event;
 	FMutex Lock;
-	TArray<class FAsyncTimeAwaiter*> Queue;
+	TUniquePtr<FTimerQueue> Queue;
+	FTimerHeap PreciseQueue;
+	std::atomic<uint64> Lateness[2][FTimerLateness::NumBuckets] = {};
+	TArray<TPair<ENamedThreads::Type, FPromise*>> Expired; // Timer thread only
+	TArray<FAsyncTimeAwaiter*> ExpiredCallbacks; // Timer thread only
 	FThread Thread; // Must come last
 
 public:
 	static FTimerThread& Get();
 	void Register(FAsyncTimeAwaiter*);
-	void TryUnregister(FAsyncTimeAwaiter*);
+	/** Registers a timer that calls Fn(Context) on the timer thread when it's
+	 *  due, instead of resuming a coroutine. The awaiter must stay alive until
+	 *  Fn is called or TryUnregister returns true. */
+	void RegisterCallback(FAsyncTimeAwaiter*, void (*Fn)(void*), void* Context);
+	/** Returns true if the awaiter was still queued. */
+	bool TryUnregister(FAsyncTimeAwaiter*);
+	/** Resumes the awaiter's coroutine early if it hasn't been resumed yet.
+	 *  Called from the awaiter's cancellation hook. */
+	void Cancel(FAsyncTimeAwaiter*);
+	FTimerLateness GetLateness() const;
 
 private:
 	explicit FTimerThread();
 	~FTimerThread() = delete;
 	void Run();
 	void RunOnce();
-	void Resume(FAsyncTimeAwaiter*);
+	void Spin(double Until);
+	void Claim(FAsyncTimeAwaiter*, double Now);
+	void Dispatch();
+	FTimerQueue& QueueFor(FAsyncTimeAwaiter*);
 };
 }
@@ -0,0 +1,65 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "UE5Coro/UE5CoroAggregateLibrary.h"
+#include "UE5Coro/AggregateAwaiters.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Private;
+
+namespace
+{
+TArray<TCoroutine<>> ToHandles(const TArray<FAsyncCoroutine>& Coroutines)
+{
+	TArray<TCoroutine<>> Handles;
+	Handles.Reserve(Coroutines.Num());
+	for (auto& Coroutine : Coroutines)
+		Handles.Add(Coroutine);
+	return Handles;
+}
+}
+
+FAsyncCoroutine UUE5CoroAggregateLibrary::WaitForAll(
+	const TArray<FAsyncCoroutine>& Coroutines, FLatentActionInfo)
+{
+	// Coroutines refers to BP memory, copy it before the first co_await
+	co_await FAllAwaiter(std::true_type(), ToHandles(Coroutines));
+}
+
+FAsyncCoroutine UUE5CoroAggregateLibrary::WaitForAny(
+	const TArray<FAsyncCoroutine>& Coroutines, int32& Winner, FLatentActionInfo)
+{
+	Winner = -1;
+	if (Coroutines.IsEmpty())
+		co_return;
+	// Winner lives in the BP's persistent frame, it outlives this coroutine
+	Winner = co_await FAnyAwaiter(std::false_type(), ToHandles(Coroutines));
+}
@@ -31,6 +31,9 @@
 
 #include "UE5CoroAnimCallbackTarget.h"
 #include "UE5Coro/AnimationAwaiters.h"
+#include "Animation/AnimInstance.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "UObject/GCObject.h"
 
 using namespace UE5Coro::Private;
 
@@ -51,131 +54,335 @@ template<FPrivateMapPtr Ptr>
 TPrivateSpy<Ptr> TPrivateSpy<Ptr>::Instance;
 
 template class TPrivateSpy<&UAnimInstance::ExternalNotifyHandlers>;
+
+class FAnimListeners final : public FGCObject
+{
+public:
+	TMap<TWeakObjectPtr<UAnimInstance>, UUE5CoroAnimCallbackTarget*> Listeners;
+
+	static FAnimListeners& Get()
+	{
+		static FAnimListeners Instance;
+		return Instance;
+	}
+
+	virtual void AddReferencedObjects(FReferenceCollector& Collector) override
+	{
+		for (auto& [Instance, Listener] : Listeners)
+			Collector.AddReferencedObject(Listener);
+	}
+
+	virtual FString GetReferencerName() const override
+	{
+		return TEXT("UE5Coro anim listeners");
+	}
+};
 }
 
-void UUE5CoroAnimCallbackTarget::TryResume()
+UUE5CoroAnimCallbackTarget* UUE5CoroAnimCallbackTarget::ForInstance(
+	UAnimInstance* Instance)
 {
 	checkf(IsInGameThread(),
-	       TEXT("Internal error: attempting to resume from wrong thread"));
-	if (Promise) // Is there anything suspended?
+	       TEXT("Internal error: anim listener requested outside GT"));
+	if (!IsValid(Instance))
+		return nullptr;
+
+	auto*& Listener = FAnimListeners::Get().Listeners.FindOrAdd(
+		TWeakObjectPtr<UAnimInstance>(Instance));
+	if (!Listener)
 	{
-		WeakInstance = nullptr; // Stop watching the instance
-		std::exchange(Promise, nullptr)->Resume(); // Resume exactly once
+		Listener = NewObject<ThisClass>();
+		Listener->WeakInstance = Instance;
 	}
+	return Listener;
 }
 
-void UUE5CoroAnimCallbackTarget::ListenForMontageEvent(UAnimInstance* Instance,
+void UUE5CoroAnimCallbackTarget::Link(FAnimAwaiter& Awaiter)
+{
+	checkf(!Awaiter.Listener, TEXT("Internal error: awaiter linked twice"));
+	auto*& Head = Awaiters.FindOrAdd(Awaiter.Key);
+	Awaiter.Listener = this;
+	Awaiter.Prev = nullptr;
+	Awaiter.Next = Head;
+	if (Head)
+		Head->Prev = &Awaiter;
+	Head = &Awaiter;
+}
+
+void UUE5CoroAnimCallbackTarget::Unlink(FAnimAwaiter& Awaiter)
+{
+	checkf(Awaiter.Listener == this,
+	       TEXT("Internal error: unlinking foreign awaiter"));
+	if (Awaiter.Prev)
+		Awaiter.Prev->Next = Awaiter.Next;
+	else if (Awaiter.Next)
+		Awaiters.FindChecked(Awaiter.Key) = Awaiter.Next;
+	else
+		Awaiters.Remove(Awaiter.Key);
+	if (Awaiter.Next)
+		Awaiter.Next->Prev = Awaiter.Prev;
+	Awaiter.Listener = nullptr;
+	Awaiter.Prev = nullptr;
+	Awaiter.Next = nullptr;
+}
+
+void UUE5CoroAnimCallbackTarget::Collect(FAnimAwaiter* Head,
+                                         const FAnimResult& Result,
+                                         FResumeList& ToResume)
+{
+	for (auto* Awaiter = Head; Awaiter; )
+	{
+		auto* Next = std::exchange(Awaiter->Next, nullptr);
+		Awaiter->Listener = nullptr;
+		Awaiter->Prev = nullptr;
+		Awaiter->Result = Result;
+		if (Awaiter->Promise) // Awaiters that aren't co_awaited yet just store
+			ToResume.Add(Awaiter);
+		Awaiter = Next;
+	}
+}
+
+void UUE5CoroAnimCallbackTarget::Collect(const FAnimEventKey& Key,
+                                         const FAnimResult& Result,
+                                         FResumeList& ToResume)
+{
+	if (FAnimAwaiter* Head; Awaiters.RemoveAndCopyValue(Key, Head))
+		Collect(Head, Result, ToResume);
+}
+
+void UUE5CoroAnimCallbackTarget::Resume(FResumeList& ToResume)
+{
+	// Resuming one coroutine might destroy the other awaiters, which will null
+	// their slots. ToResume is not modified after this point.
+	for (auto*& Awaiter : ToResume)
+		Awaiter->DispatchSlot = &Awaiter;
+	for (auto*& Slot : ToResume)
+		if (auto* Awaiter = std::exchange(Slot, nullptr))
+		{
+			Awaiter->DispatchSlot = nullptr;
+			std::exchange(Awaiter->Promise, nullptr)->Resume();
+		}
+}
+
+void UUE5CoroAnimCallbackTarget::ListenForMontageEvent(FAnimAwaiter& Awaiter,
                                                        UAnimMontage* Montage,
                                                        bool bEnd)
 {
 	checkf(IsInGameThread(),
 	       TEXT("Internal error: animation montage event received outside GT"));
+	auto* Instance = WeakInstance.Get();
 	checkf(Instance,
 	       TEXT("Internal error: anim montage event without anim instance"));
-	WeakInstance = Instance;
-	auto Callback = FOnMontageEnded::CreateUObject(
-		this, &ThisClass::BoolProperty);
-	if (bEnd)
-		Instance->Montage_SetEndDelegate(Callback, Montage);
-	else
-		Instance->Montage_SetBlendingOutDelegate(Callback, Montage);
+
+	// Same as Montage_SetEndDelegate and Montage_SetBlendingOutDelegate
+	auto* MontageInstance = Montage
+		? Instance->GetActiveInstanceForMontage(Montage)
+		: Instance->GetActiveMontageInstance();
+	int32 ID = MontageInstance ? MontageInstance->GetInstanceID() : INDEX_NONE;
+	Awaiter.Key = {bEnd ? EAnimEvent::MontageEnded
+	                    : EAnimEvent::MontageBlendingOut, ID, NAME_None};
+
+	// The montage instance only has room for one delegate, which is shared by
+	// every awaiter listening to it
+	if (MontageInstance)
+	{
+		auto Bind = [&](auto& Delegate)
+		{
+			if (!Delegate.IsBoundToObject(this))
+				Delegate.BindUObject(this, &ThisClass::OnMontageEvent, bEnd, ID);
+		};
+		if (bEnd)
+			Bind(MontageInstance->OnMontageEnded);
+		else
+			Bind(MontageInstance->OnMontageBlendingOutStarted);
+	}
+	Link(Awaiter);
 }
 
-void UUE5CoroAnimCallbackTarget::ListenForNotify(UAnimInstance* Instance,
-                                                 UAnimMontage* Montage,
+void UUE5CoroAnimCallbackTarget::ListenForNotify(FAnimAwaiter& Awaiter,
                                                  FName NotifyName)
 {
 	checkf(IsInGameThread(),
 	       TEXT("Internal error: notify event received outside GT"));
+	auto* Instance = WeakInstance.Get();
 	checkf(Instance,
 	       TEXT("Internal error: anim montage event without anim instance"));
 	checkf(GExternalNotifyHandlersPtr,
 	       TEXT("Internal error: anim instance spy failed"));
-	WeakInstance = Instance;
+	Awaiter.Key = {EAnimEvent::Notify, INDEX_NONE, NotifyName};
 
-	// UAnimInstance::AddExternalNotifyHandler() ties the notify name and the
-	// called UFUNCTION's name together. :(
-	auto& ExternalNotifyHandlers = Instance->*GExternalNotifyHandlersPtr;
-	FName HandlerName = *(TEXT("AnimNotify_") + NotifyName.ToString());
-	auto& Delegate = ExternalNotifyHandlers.FindOrAdd(HandlerName);
-	Delegate.AddUObject(this, &ThisClass::Core);
+	// If there's another awaiter for this name, the handler is already bound
+	if (!Awaiters.Contains(Awaiter.Key))
+	{
+		// UAnimInstance::AddExternalNotifyHandler() ties the notify name and
+		// the called UFUNCTION's name together. :(
+		auto& ExternalNotifyHandlers = Instance->*GExternalNotifyHandlersPtr;
+		FName HandlerName = *(TEXT("AnimNotify_") + NotifyName.ToString());
+		auto& Delegate = ExternalNotifyHandlers.FindOrAdd(HandlerName);
+		if (!Delegate.IsBoundToObject(this))
+			Delegate.AddUObject(this, &ThisClass::OnNotify, NotifyName);
+	}
+	Link(Awaiter);
 }
 
 void UUE5CoroAnimCallbackTarget::ListenForPlayMontageNotify(
-	UAnimInstance* Instance, UAnimMontage* Montage,
+	FAnimAwaiter& Awaiter, UAnimMontage* Montage,
 	std::optional<FName> NotifyName, bool bEnd)
 {
 	checkf(IsInGameThread(),
 	       TEXT("Internal error: play montage event received outside GT"));
+	auto* Instance = WeakInstance.Get();
 	checkf(Instance,
 	       TEXT("Internal error: play montage event without anim instance"));
-	checkf(MontageIDFilter == INDEX_NONE && !NotifyFilter.has_value(),
-	       TEXT("Internal error: montage filter already set up"));
-	WeakInstance = Instance;
 
+	// UPlayMontageCallbackProxy uses this value as the default
+	int32 ID = INDEX_NONE;
 	if (auto* MontageInstance = Instance->GetActiveInstanceForMontage(Montage))
-		MontageIDFilter = MontageInstance->GetInstanceID();
-	NotifyFilter = NotifyName;
+		ID = MontageInstance->GetInstanceID();
+	auto Event = NotifyName.has_value()
+		? bEnd ? EAnimEvent::PlayMontageNotifyEnd
+		       : EAnimEvent::PlayMontageNotifyBegin
+		: bEnd ? EAnimEvent::AnyPlayMontageNotifyEnd
+		       : EAnimEvent::AnyPlayMontageNotifyBegin;
+	Awaiter.Key = {Event, ID, NotifyName.value_or(NAME_None)};
 
-	(bEnd ? Instance->OnPlayMontageNotifyEnd
-	      : Instance->OnPlayMontageNotifyBegin)
-		.AddDynamic(this, &ThisClass::NameProperty);
+	if (bEnd)
+		Instance->OnPlayMontageNotifyEnd.AddUniqueDynamic(this,
+		                                                  &ThisClass::NotifyEnd);
+	else
+		Instance->OnPlayMontageNotifyBegin.AddUniqueDynamic(
+			this, &ThisClass::NameProperty);
+	Link(Awaiter);
 }
 
-void UUE5CoroAnimCallbackTarget::RequestResume(FPromise& InPromise)
+void UUE5CoroAnimCallbackTarget::ListenForCurve(FAnimCurveAwaiter& Awaiter,
+                                                FName CurveName)
 {
-	checkf(!Promise, TEXT("Attempted second concurrent co_await"));
-	// await_ready should've prevented suspension if there's already a result
-	checkf(IsInGameThread(), TEXT("Internal error: suspending on wrong thread"));
-	checkf(std::holds_alternative<std::monostate>(Result),
-	       TEXT("Internal error: reused callback target"));
-	Promise = &InPromise;
+	checkf(IsInGameThread(),
+	       TEXT("Internal error: curve listener requested outside GT"));
+	auto* Instance = WeakInstance.Get();
+	checkf(Instance, TEXT("Internal error: curve event without anim instance"));
+	Awaiter.Key = {EAnimEvent::Curve, INDEX_NONE, CurveName};
+
+	// Crossings are relative to the most recent evaluation
+	Awaiter.LastValue = 0;
+	Instance->GetCurveValue(CurveName, Awaiter.LastValue);
+	if (auto* Mesh = Instance->GetSkelMeshComponent())
+		Mesh->OnBoneTransformsFinalized.AddUniqueDynamic(
+			this, &ThisClass::OnBoneTransformsFinalized);
+	Link(Awaiter);
 }
 
-void UUE5CoroAnimCallbackTarget::CancelResume()
+void UUE5CoroAnimCallbackTarget::OnMontageEvent(UAnimMontage*,
+                                                bool bInterrupted, bool bEnd,
+                                                int32 MontageInstanceID)
 {
-	checkf(IsInGameThread(), TEXT("Internal error: canceling on wrong thread"));
-	// Promise can be nullptr already if this is a deferred destruction
-	Promise = nullptr;
+	checkf(IsInGameThread(),
+	       TEXT("Internal error: expected montage callback on game thread"));
+
+	FResumeList ToResume;
+	Collect({bEnd ? EAnimEvent::MontageEnded : EAnimEvent::MontageBlendingOut,
+	         MontageInstanceID, NAME_None}, bInterrupted, ToResume);
+	Resume(ToResume);
 }
 
-void UUE5CoroAnimCallbackTarget::Core()
+void UUE5CoroAnimCallbackTarget::OnNotify(FName NotifyName)
 {
 	checkf(IsInGameThread(),
 	       TEXT("Internal error: expected notify callback on game thread"));
 
-	Result = true; // This is for the void awaiter
-	TryResume();
+	FResumeList ToResume;
+	// This is for the void awaiter
+	Collect({EAnimEvent::Notify, INDEX_NONE, NotifyName}, true, ToResume);
+	Resume(ToResume);
 }
 
-void UUE5CoroAnimCallbackTarget::BoolProperty(UAnimMontage*, bool bInterrupted)
+void UUE5CoroAnimCallbackTarget::OnPlayMontageNotify(
+	FName NotifyName, const FBranchingPointNotifyPayload& Payload, bool bEnd)
 {
 	checkf(IsInGameThread(),
 	       TEXT("Internal error: expected montage callback on game thread"));
 
-	Result = bInterrupted;
-	TryResume();
+	auto Named = bEnd ? EAnimEvent::PlayMontageNotifyEnd
+	                  : EAnimEvent::PlayMontageNotifyBegin;
+	auto Any = bEnd ? EAnimEvent::AnyPlayMontageNotifyEnd
+	                : EAnimEvent::AnyPlayMontageNotifyBegin;
+	FAnimResult Tuple(FPayloadTuple(NotifyName, &Payload));
+
+	// Everything is collected before resuming anything, so that awaiters
+	// created by the resumed coroutines don't receive this same notify
+	FResumeList ToResume;
+	auto CollectID = [&](int32 ID)
+	{
+		Collect({Named, ID, NotifyName}, &Payload, ToResume);
+		Collect({Any, ID, NAME_None}, Tuple, ToResume);
+	};
+	CollectID(INDEX_NONE); // Awaiters without a montage instance filter
+	if (Payload.MontageInstanceID != INDEX_NONE)
+		CollectID(Payload.MontageInstanceID);
+	Resume(ToResume);
 }
 
 void UUE5CoroAnimCallbackTarget::NameProperty(
 	FName NotifyName, const FBranchingPointNotifyPayload& Payload)
 {
-	checkf(IsInGameThread(),
-	       TEXT("Internal error: expected montage callback on game thread"));
+	OnPlayMontageNotify(NotifyName, Payload, false);
+}
+
+void UUE5CoroAnimCallbackTarget::NotifyEnd(
+	FName NotifyName, const FBranchingPointNotifyPayload& Payload)
+{
+	OnPlayMontageNotify(NotifyName, Payload, true);
+}
 
-	// Apply filters
-	if (MontageIDFilter != INDEX_NONE &&
-	    Payload.MontageInstanceID != MontageIDFilter)
+void UUE5CoroAnimCallbackTarget::OnBoneTransformsFinalized()
+{
+	checkf(IsInGameThread(),
+	       TEXT("Internal error: expected bone transforms on game thread"));
+	auto* Instance = WeakInstance.Get();
+	if (!Instance) // Tick will take care of the awaiters
 		return;
-	if (NotifyFilter.has_value() && *NotifyFilter != NotifyName)
+
+	// Every awaiter sees the same evaluation, even if a resumed coroutine
+	// creates new ones
+	bool bAnyCurves = false;
+	TArray<FAnimCurveAwaiter*, TInlineAllocator<8>> Crossed;
+	for (auto& [Key, Head] : Awaiters)
+	{
+		if (Key.Event != EAnimEvent::Curve)
+			continue;
+		bAnyCurves = true;
+		float Value = 0;
+		Instance->GetCurveValue(Key.Name, Value);
+		for (auto* Awaiter = Head; Awaiter; Awaiter = Awaiter->Next)
+		{
+			auto* Curve = static_cast<FAnimCurveAwaiter*>(Awaiter);
+			float Last = std::exchange(Curve->LastValue, Value);
+			float Threshold = Curve->Threshold;
+			if (Curve->bRising ? Last <= Threshold && Value > Threshold
+			                   : Last >= Threshold && Value < Threshold)
+				Crossed.Add(Curve);
+		}
+	}
+
+	// Nothing else is waiting for curves on this instance, stop listening
+	if (!bAnyCurves)
+	{
+		if (auto* Mesh = Instance->GetSkelMeshComponent())
+			Mesh->OnBoneTransformsFinalized.RemoveDynamic(
+				this, &ThisClass::OnBoneTransformsFinalized);
 		return;
+	}
 
-	// This callback passed all filters. Store the result, then resume.
-	if (NotifyFilter.has_value())
-		Result = &Payload;
-	else
-		Result = FPayloadTuple(NotifyName, &Payload);
-	TryResume();
+	FResumeList ToResume;
+	for (auto* Curve : Crossed)
+	{
+		Unlink(*Curve);
+		Curve->Result = Curve->LastValue;
+		if (Curve->Promise)
+			ToResume.Add(Curve);
+	}
+	Resume(ToResume);
 }
 
 ETickableTickType UUE5CoroAnimCallbackTarget::GetTickableTickType() const
@@ -185,13 +392,20 @@ ETickableTickType UUE5CoroAnimCallbackTarget::GetTickableTickType() const
 
 void UUE5CoroAnimCallbackTarget::Tick(float DeltaTime)
 {
-	// Keep trying to resume on tick, because it's possible that an animation
-	// awaiter exists but it will only get co_awaited in the future.
-	// A successful resume will explicitly null WeakInstance.
-	// TAnimAwaiter is dealing with unexpected/early resumptions from this
-	// code path, mainly by checking if Result is still std::monostate.
-	if (WeakInstance.IsStale())
-		TryResume();
+	// Awaiters that are not co_awaited yet won't have a result, which
+	// TAnimAwaiter reports as the anim instance being destroyed.
+	if (!WeakInstance.IsStale())
+		return;
+
+	// This listener is done. Let GC collect it once it's no longer ticking.
+	FAnimListeners::Get().Listeners.Remove(WeakInstance);
+	WeakInstance = nullptr;
+
+	FResumeList ToResume;
+	for (auto& [Key, Head] : Awaiters)
+		Collect(Head, FAnimResult(), ToResume);
+	Awaiters.Empty();
+	Resume(ToResume);
 }
 
 TStatId UUE5CoroAnimCallbackTarget::GetStatId() const
@@ -34,44 +34,61 @@
 #include "CoreMinimal.h"
 #include "UE5Coro/Definitions.h"
 #include <optional>
-#include <variant>
-#include "UE5Coro/AsyncCoroutine.h"
+#include "UE5Coro/AnimationAwaiters.h"
 #include "UE5CoroAnimCallbackTarget.generated.h"
 
+/** Shared listener for every anim awaiter on a single anim instance.<br>
+ *  Delegates are bound once per instance and event, and awaiters are
+ *  dispatched through a table indexed by what they're waiting for. */
 UCLASS(Hidden)
 class UE5CORO_API UUE5CoroAnimCallbackTarget : public UObject,
                                                public FTickableGameObject
 {
 	GENERATED_BODY()
 
+	using FAnimAwaiter = UE5Coro::Private::FAnimAwaiter;
+	using FAnimCurveAwaiter = UE5Coro::Private::FAnimCurveAwaiter;
+	using FAnimEventKey = UE5Coro::Private::FAnimEventKey;
+	using FAnimResult = UE5Coro::Private::FAnimResult;
+	using FResumeList = TArray<FAnimAwaiter*, TInlineAllocator<8>>;
+
 	TWeakObjectPtr<UAnimInstance> WeakInstance;
-	UE5Coro::Private::FPromise* Promise = nullptr;
-	// UPlayMontageCallbackProxy uses this value as the default
-	int32 MontageIDFilter = INDEX_NONE;
-	std::optional<FName> NotifyFilter; // "None" is a valid name for a notify
+	// Heads of intrusive lists of awaiters
+	TMap<FAnimEventKey, FAnimAwaiter*> Awaiters;
+
+	void Collect(FAnimAwaiter* Head, const FAnimResult&, FResumeList&);
+	void Collect(const FAnimEventKey&, const FAnimResult&, FResumeList&);
+	static void Resume(FResumeList&);
 
-	void TryResume();
+	void OnMontageEvent(UAnimMontage*, bool bInterrupted, bool bEnd,
+	                    int32 MontageInstanceID);
+	void OnNotify(FName NotifyName);
+	void OnPlayMontageNotify(FName NotifyName,
+	                         const FBranchingPointNotifyPayload& Payload,
+	                         bool bEnd);
 
 public:
-	// Void's result is indicated by this holding a bool, not monostate
-	std::variant<std::monostate, bool, const FBranchingPointNotifyPayload*,
-	             TTuple<FName, const FBranchingPointNotifyPayload*>> Result;
+	/** Returns the shared listener for the instance, nullptr if it's not
+	 *  valid anymore. */
+	static UUE5CoroAnimCallbackTarget* ForInstance(UAnimInstance*);
 
-	void ListenForMontageEvent(UAnimInstance*, UAnimMontage*, bool);
-	void ListenForNotify(UAnimInstance*, UAnimMontage*, FName);
-	void ListenForPlayMontageNotify(UAnimInstance*, UAnimMontage*,
+	void ListenForMontageEvent(FAnimAwaiter&, UAnimMontage*, bool);
+	void ListenForNotify(FAnimAwaiter&, FName);
+	void ListenForPlayMontageNotify(FAnimAwaiter&, UAnimMontage*,
 	                                std::optional<FName>, bool);
-	void RequestResume(UE5Coro::Private::FPromise&);
-	void CancelResume();
+	void ListenForCurve(FAnimCurveAwaiter&, FName);
+	void Link(FAnimAwaiter&);
+	void Unlink(FAnimAwaiter&);
 
 #pragma region Callbacks
-	// These function names are chosen to match predefined FNames
+	// NameProperty is chosen to match a predefined FName
 	UFUNCTION()
-	void Core(); // void
+	void NameProperty(FName NotifyName, const FBranchingPointNotifyPayload& Payload);
 	UFUNCTION()
-	void BoolProperty(UAnimMontage* Montage, bool bInterrupted);
+	void NotifyEnd(FName NotifyName, const FBranchingPointNotifyPayload& Payload);
+	// Curve awaiters are checked here, once per evaluation for all of them
 	UFUNCTION()
-	void NameProperty(FName NotifyName, const FBranchingPointNotifyPayload& Payload);
+	void OnBoneTransformsFinalized();
 #pragma endregion
 
 #pragma region FTickableGameObject overrides
@@ -30,44 +30,81 @@
 // ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "UE5CoroChainCallbackTarget.h"
+#include "LatentActions.h"
 #include "UE5Coro/UE5CoroSubsystem.h"
 
 using namespace UE5Coro::Private;
 
-void UUE5CoroChainCallbackTarget::Activate(int32 InExpectedLink,
-                                           FTwoLives* InState)
+bool FChainState::ShouldResume(void* State, bool bCleanup)
+{
+	auto* This = static_cast<FChainState*>(State);
+	if (auto* Target = This->Target)
+	{
+		if (UNLIKELY(bCleanup))
+			Target->Orphan(This);
+		else
+			Target->Poll(This);
+	}
+	return FTwoLives::ShouldResume(State, bCleanup);
+}
+
+void UUE5CoroChainCallbackTarget::Activate(FChainState* InState,
+                                           bool bInShared)
 {
 	check(IsInGameThread());
 	checkf(!State, TEXT("Unexpected double activation"));
-	ExpectedLink = InExpectedLink;
-	State = InState;
+	checkf(!InState->Target, TEXT("Unexpected reactivation"));
+	InState->Target = this;
+	if ((bShared = bInShared))
+	{
+		checkf(!SharedStates.Contains(InState->Link),
+		       TEXT("Unexpected linkage collision"));
+		SharedStates.Add(InState->Link, InState);
+	}
+	else
+		State = InState;
+}
+
+void UUE5CoroChainCallbackTarget::Release(FChainState* InState)
+{
+	checkf(InState->Target == this, TEXT("Internal error: foreign chain"));
+	InState->Target = nullptr;
+	Orphans.Remove(InState);
+	if (bShared)
+		verify(SharedStates.Remove(InState->Link) == 1);
+	else
+	{
+		State = nullptr;
+		GetOuterUUE5CoroSubsystem()->ReleaseChainCallbackTarget(InState->Link);
+	}
+	InState->Release();
 }
 
-void UUE5CoroChainCallbackTarget::Deactivate()
+void UUE5CoroChainCallbackTarget::Poll(FChainState* InState)
 {
 	check(IsInGameThread());
-	checkf(State, TEXT("Unexpected deactivation while not active"));
-	// Leave ExpectedLink stale for the check in Core()
-	if (!State->Release())
-		State = nullptr; // The other side is not interested anymore
+	// Core() might have already run, but regardless of that, the latent action
+	// is known to be over when it's gone from the latent action manager
+	if (!GetWorld()->GetLatentActionManager()
+	                .FindExistingAction<FPendingLatentAction>(this,
+	                                                          InState->Link))
+		Release(InState);
 }
 
-int32 UUE5CoroChainCallbackTarget::GetExpectedLink() const
+void UUE5CoroChainCallbackTarget::Orphan(FChainState* InState)
 {
 	check(IsInGameThread());
-	checkf(State, TEXT("Unexpected linkage query on inactive object"));
-	return ExpectedLink;
+	checkf(InState->Target == this, TEXT("Internal error: foreign chain"));
+	Orphans.Add(InState);
 }
 
 void UUE5CoroChainCallbackTarget::Core(int32 Link)
 {
 	check(IsInGameThread());
-	checkf(Link == ExpectedLink, TEXT("Unexpected linkage"));
-	if (State)
-	{
-		State->UserData = 1;
-		State = nullptr;
-	}
+	auto* Target = bShared ? SharedStates.FindRef(Link) : State;
+	checkf(!Target || Target->Link == Link, TEXT("Unexpected linkage"));
+	if (Target)
+		Target->UserData = 1;
 }
 
 ETickableTickType UUE5CoroChainCallbackTarget::GetTickableTickType() const
@@ -77,13 +114,18 @@ ETickableTickType UUE5CoroChainCallbackTarget::GetTickableTickType() const
 
 void UUE5CoroChainCallbackTarget::Tick(float DeltaTime)
 {
-	if (!State)
+	if (!State && SharedStates.Num() == 0)
 		return;
 
 	// ProcessLatentActions refuses to work on non-BP classes.
 	GetClass()->ClassFlags |= CLASS_CompiledFromBlueprint;
 	GetWorld()->GetLatentActionManager().ProcessLatentActions(this, DeltaTime);
 	GetClass()->ClassFlags &= ~CLASS_CompiledFromBlueprint;
+
+	// Nothing else will notice these finishing
+	if (Orphans.Num() > 0)
+		for (auto* Orphan : Orphans.Array())
+			Poll(Orphan);
 }
 
 TStatId UUE5CoroChainCallbackTarget::GetStatId() const
@@ -92,6 +134,23 @@ TStatId UUE5CoroChainCallbackTarget::GetStatId() const
 	                                STATGROUP_Tickables);
 }
 
+void UUE5CoroChainCallbackTarget::BeginDestroy()
+{
+	// The latent actions will never call Core() now, resume as aborted
+	auto Release = [](FChainState* InState)
+	{
+		InState->Target = nullptr;
+		InState->Release();
+	};
+	if (State)
+		Release(std::exchange(State, nullptr));
+	for (auto& [Link, SharedState] : std::exchange(SharedStates, {}))
+		Release(SharedState);
+	Orphans.Reset();
+
+	Super::BeginDestroy();
+}
+
 // This is only used by tests
 namespace UE5Coro::Private
 {
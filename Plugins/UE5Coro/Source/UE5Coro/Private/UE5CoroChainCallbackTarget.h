@@ -33,11 +33,26 @@
 
 #include "CoreMinimal.h"
 #include "UE5Coro/Definitions.h"
+#include "UE5Coro/UE5CoroSubsystem.h"
 #include "UE5CoroChainCallbackTarget.generated.h"
 
+class UUE5CoroChainCallbackTarget;
+
 namespace UE5Coro::Private
 {
-class FTwoLives;
+/** Shared between a chained latent action and the coroutine awaiting it.<br>
+ *  The target's life is released when it's found that the latent action is
+ *  gone, which is checked by the awaiter's polls, or the target's own Tick if
+ *  nothing is awaiting anymore. */
+class [[nodiscard]] FChainState final : public FTwoLives
+{
+public:
+	/** Valid until the target releases its life. */
+	UUE5CoroChainCallbackTarget* Target = nullptr;
+	int32 Link = 0;
+
+	static bool ShouldResume(void* State, bool bCleanup);
+};
 }
 
 UCLASS(Hidden, Within = UE5CoroSubsystem)
@@ -46,13 +61,26 @@ class UE5CORO_API UUE5CoroChainCallbackTarget : public UObject,
 {
 	GENERATED_BODY()
 
-	int32 ExpectedLink = 0;
-	UE5Coro::Private::FTwoLives* State = nullptr;
+	UE5Coro::Private::FChainState* State = nullptr;
+
+	// Used instead of the above if this is the world's shared target
+	bool bShared = false;
+	TMap<int32, UE5Coro::Private::FChainState*> SharedStates;
+	// Chains that nothing awaits anymore, these are checked every Tick
+	TSet<UE5Coro::Private::FChainState*> Orphans;
+
+	void Release(UE5Coro::Private::FChainState* InState);
 
 public:
-	void Activate(int32 InExpectedLink, UE5Coro::Private::FTwoLives* InState);
-	void Deactivate();
-	[[nodiscard]] int32 GetExpectedLink() const;
+	/** Makes this object the target of one more chained action.<br>
+	 *  Only the world's shared target accepts more than one. */
+	void Activate(UE5Coro::Private::FChainState* InState, bool bInShared);
+
+	/** Releases InState if its latent action is not running anymore. */
+	void Poll(UE5Coro::Private::FChainState* InState);
+
+	/** Called when nothing is awaiting InState anymore. */
+	void Orphan(UE5Coro::Private::FChainState* InState);
 
 	/** Signals the coroutine suspended with this linkage that it may resume. */
 	UFUNCTION()
@@ -65,4 +93,6 @@ public:
 	virtual void Tick(float DeltaTime) override;
 	virtual TStatId GetStatId() const override;
 #pragma endregion
+
+	virtual void BeginDestroy() override;
 };
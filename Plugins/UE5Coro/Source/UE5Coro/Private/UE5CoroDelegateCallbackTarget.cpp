@@ -30,18 +30,116 @@
 // ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "UE5CoroDelegateCallbackTarget.h"
+#include "HAL/IConsoleManager.h"
+#include "UObject/GCObject.h"
 
-void UUE5CoroDelegateCallbackTarget::Init(std::function<void(void*)> InFn)
+using namespace UE5Coro::Private;
+
+namespace
+{
+TAutoConsoleVariable<bool> CVarPoolDelegateCallbackTargets(
+	TEXT("UE5Coro.PoolDelegateCallbackTargets"), false,
+	TEXT("Recycle the objects used to co_await dynamic delegates and to ")
+	TEXT("Latent::UntilDelegate any delegate, instead of making a new UObject ")
+	TEXT("for every await. If set, awaited delegates must outlive their ")
+	TEXT("awaiters so that the targets can be unbound from them."));
+
+class FDelegateTargetPool final : public FGCObject
+{
+	FMutex Lock;
+	TArray<UUE5CoroDelegateCallbackTarget*> All;
+	TArray<UUE5CoroDelegateCallbackTarget*> Free;
+
+public:
+	static FDelegateTargetPool& Get()
+	{
+		// Deliberately never destroyed: static destruction would be too late
+		// for a FGCObject
+		static auto* Instance = new FDelegateTargetPool;
+		return *Instance;
+	}
+
+	UUE5CoroDelegateCallbackTarget* Acquire()
+	{
+		{
+			std::scoped_lock _(Lock);
+			if (Free.Num() > 0)
+				return Free.Pop();
+		}
+		// New objects are kept alive by All, GC can't run until then
+		FGCScopeGuard _;
+		auto* Target = NewObject<UUE5CoroDelegateCallbackTarget>();
+		std::scoped_lock L(Lock);
+		All.Add(Target);
+		return Target;
+	}
+
+	void Recycle(UUE5CoroDelegateCallbackTarget* Target)
+	{
+		std::scoped_lock _(Lock);
+		Free.Push(Target);
+	}
+
+	virtual void AddReferencedObjects(FReferenceCollector& Collector) override
+	{
+		std::scoped_lock _(Lock);
+		Collector.AddReferencedObjects(All);
+	}
+
+	virtual FString GetReferencerName() const override
+	{
+		return TEXT("UE5Coro delegate callback targets");
+	}
+};
+}
+
+UUE5CoroDelegateCallbackTarget* UUE5CoroDelegateCallbackTarget::Create(
+	TInlineFunction<void(void*)> InFn)
+{
+	UUE5CoroDelegateCallbackTarget* Target;
+	if (CVarPoolDelegateCallbackTargets.GetValueOnAnyThread())
+	{
+		Target = FDelegateTargetPool::Get().Acquire();
+		Target->bPooled = true;
+	}
+	else
+	{
+		FGCScopeGuard _;
+		Target = NewObject<ThisClass>();
+		Target->SetInternalFlags(EInternalObjectFlags::Async);
+	}
+	checkf(!Target->Fn, TEXT("Internal error: callback target reused early"));
+	Target->Fn = std::move(InFn);
+	return Target;
+}
+
+void UUE5CoroDelegateCallbackTarget::Release(void* Delegate,
+                                             void (*Unbind)(void*, UObject*))
 {
-	Fn = std::move(InFn);
+	if (bPooled)
+	{
+		// Nothing may call this object after it's reused
+		Unbind(Delegate, this);
+		Fn.Reset();
+		FDelegateTargetPool::Get().Recycle(this);
+	}
+	else
+	{
+		FGCScopeGuard _;
+		ClearInternalFlags(EInternalObjectFlags::Async);
+		MarkAsGarbage();
+	}
 }
 
 void UUE5CoroDelegateCallbackTarget::ProcessEvent(UFunction*, void* Parms)
 {
+	if (bPooled && !Fn)
+		return; // A multicast delegate fired again before Release
 	// This might also be caused by a multithreaded race condition
 	checkf(Fn, TEXT("Internal error: Unexpected early or double callback"));
 	std::exchange(Fn, nullptr)(Parms);
-	MarkAsGarbage(); // Prevent further calls from dynamic delegates
+	if (!bPooled)
+		MarkAsGarbage(); // Prevent further calls from dynamic delegates
 }
 
 void UUE5CoroDelegateCallbackTarget::Core()
@@ -41,10 +41,20 @@ class UUE5CoroDelegateCallbackTarget : public UObject
 {
 	GENERATED_BODY()
 
-	std::function<void(void*)> Fn;
+	UE5Coro::Private::TInlineFunction<void(void*)> Fn;
+	bool bPooled = false;
 
 public:
-	void Init(std::function<void(void*)>);
+	/** Returns a target that will call Fn once when any delegate calls it.<br>
+	 *  This comes from a pool if UE5Coro.PoolDelegateCallbackTargets is set. */
+	static UUE5CoroDelegateCallbackTarget* Create(
+		UE5Coro::Private::TInlineFunction<void(void*)> Fn);
+
+	/** Lets go of this target after it was bound to Delegate.<br>
+	 *  Pooled targets use Unbind to remove themselves from the delegate, which
+	 *  must still be alive in that case. */
+	void Release(void* Delegate, void (*Unbind)(void*, UObject*));
+
 	virtual void ProcessEvent(UFunction*, void*) override;
 
 	UFUNCTION()
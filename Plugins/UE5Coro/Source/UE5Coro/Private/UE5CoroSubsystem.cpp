@@ -30,10 +30,52 @@
 // ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "UE5Coro/UE5CoroSubsystem.h"
+#include "UE5Coro/AsyncCoroutine.h"
+#include "UE5Coro/LatentAwaiters.h"
+#include "HAL/IConsoleManager.h"
 #include "UE5CoroChainCallbackTarget.h"
 
+using namespace UE5Coro;
 using namespace UE5Coro::Private;
 
+namespace
+{
+TAutoConsoleVariable<bool> CVarSharedChainCallbackTarget(
+	TEXT("UE5Coro.SharedChainCallbackTarget"), false,
+	TEXT("Latent::Chain and ChainEx use a single callback target per world ")
+	TEXT("instead of a new UObject for every chained call."));
+
+TAutoConsoleVariable<float> CVarLatentResumeBudget(
+	TEXT("UE5Coro.LatentResumeBudget"), 0,
+	TEXT("Microseconds per frame that a world may spend resuming coroutines ")
+	TEXT("from latent awaiters. Coroutines over the budget are deferred to the ")
+	TEXT("next frame. 0 or less means unlimited."));
+
+TAutoConsoleVariable<bool> CVarSkipEditorWorlds(
+	TEXT("UE5Coro.SkipEditorWorlds"), false,
+	TEXT("Don't tick coroutines in editor worlds, e.g., the editor world ")
+	TEXT("during PIE. Coroutines waiting on latent awaiters there are ")
+	TEXT("resumed once this is turned off again."));
+
+thread_local UWorld* GLatentWorld = nullptr;
+
+using FDeferred = TTuple<int8, uint64, double, FAsyncPromise*>;
+
+bool BeforeDeferred(const FDeferred& A, const FDeferred& B)
+{
+	// Higher priority first, then FIFO
+	if (A.Get<0>() != B.Get<0>())
+		return A.Get<0>() > B.Get<0>();
+	return A.Get<1>() < B.Get<1>();
+}
+
+bool EarlierDeadline(const TTuple<double, FAsyncPromise*>& A,
+                     const TTuple<double, FAsyncPromise*>& B)
+{
+	return A.Get<0>() < B.Get<0>();
+}
+}
+
 bool FTwoLives::Release()
 {
 	// The <= 2 part should help catch use-after-free bugs in full debug builds.
@@ -66,40 +108,158 @@ FLatentActionInfo UUE5CoroSubsystem::MakeLatentInfo()
 	return {INDEX_NONE, NextLinkage++, TEXT("None"), this};
 }
 
-FLatentActionInfo UUE5CoroSubsystem::MakeLatentInfo(FTwoLives* State)
+FLatentActionInfo UUE5CoroSubsystem::MakeLatentInfo(FChainState* State)
 {
 	checkf(IsInGameThread(), TEXT("Unexpected latent info off the game thread"));
 
-	// Lazy delegate binding in order to not affect
-	// projects that never use Chain/ChainEx.
-	if (UNLIKELY(!LatentActionsChangedHandle.IsValid()))
-		LatentActionsChangedHandle =
-			FLatentActionManager::OnLatentActionsChanged().AddUObject(
-				this, &ThisClass::LatentActionsChanged);
+	// Completion is detected by the awaiter polling for its own latent action,
+	// which is cheaper than listening to every change in every world.
+	int32 Linkage = State->Link = NextLinkage++;
+	if (CVarSharedChainCallbackTarget.GetValueOnGameThread())
+	{
+		if (UNLIKELY(!SharedChainCallbackTarget))
+			SharedChainCallbackTarget =
+				NewObject<UUE5CoroChainCallbackTarget>(this);
+		SharedChainCallbackTarget->Activate(State, true);
+		return {Linkage, Linkage, TEXT("Core"), SharedChainCallbackTarget};
+	}
 
-	int32 Linkage = NextLinkage++;
 	checkf(!ChainCallbackTargets.Contains(Linkage),
 	       TEXT("Unexpected linkage collision"));
 	// Pooling these objects was found to be consistently slower
-	// than making new ones every time.
+	// than making new ones every time. See UE5Coro.Chain.Benchmark.
 	auto* Target = NewObject<UUE5CoroChainCallbackTarget>(this);
-	Target->Activate(Linkage, State);
+	Target->Activate(State, false);
 	ChainCallbackTargets.Add(Linkage, Target);
 	return {Linkage, Linkage, TEXT("Core"), Target};
 }
 
+void UUE5CoroSubsystem::ReleaseChainCallbackTarget(int32 Link)
+{
+	checkf(IsInGameThread(),
+	       TEXT("Unexpected chain release off the game thread"));
+	verifyf(ChainCallbackTargets.Remove(Link) == 1,
+	        TEXT("Internal error: unknown chain callback target"));
+}
+
+void UUE5CoroSubsystem::AddPendingAwaiter(FAsyncPromise& Promise,
+                                          FLatentAwaiter& Awaiter)
+{
+	checkf(IsInGameThread(),
+	       TEXT("Latent awaiters may only be used on the game thread"));
+	if (FLatentReadyCallback::TryBind(Awaiter, *this, Promise))
+		CallbackAwaiters.Add(&Promise);
+	else if (auto Deadline = FLatentDeadline::Of(Awaiter);
+	    Deadline.Clock != FLatentDeadline::None)
+		Deadlines[Deadline.Clock].HeapPush(MakeTuple(Deadline.Time, &Promise),
+		                                   &EarlierDeadline);
+	else
+		PendingAwaiters.Emplace(&Promise, &Awaiter);
+}
+
+void UUE5CoroSubsystem::AddTickGroupAwaiter(FTickGroupAwaiter& Awaiter)
+{
+	checkf(IsInGameThread(),
+	       TEXT("Latent awaiters may only be used on the game thread"));
+	checkf(Awaiter.Group >= 0 && Awaiter.Group < TG_NewlySpawned,
+	       TEXT("Invalid tick group %d"), static_cast<int>(Awaiter.Group));
+
+	// Having every group ready avoids registering new tick functions in the
+	// middle of a frame, which would run them at the wrong time
+	auto* World = GetWorld();
+	if (UNLIKELY(!TickGroupFunctions[0]) && World->IsGameWorld())
+		for (int i = 0; i < TG_NewlySpawned; ++i)
+		{
+			auto& Function = TickGroupFunctions[i];
+			Function = MakeUnique<FTickGroupFunction>();
+			Function->Subsystem = this;
+			Function->TickGroup = Function->EndTickGroup =
+				static_cast<ETickingGroup>(i);
+			Function->bCanEverTick = true;
+			Function->bTickEvenWhenPaused = true;
+			Function->RegisterTickFunction(World->PersistentLevel);
+		}
+	TickGroupAwaiters[Awaiter.Group].Add(&Awaiter);
+}
+
+void UUE5CoroSubsystem::RemoveTickGroupAwaiter(FTickGroupAwaiter& Awaiter)
+{
+	checkf(IsInGameThread(),
+	       TEXT("Latent awaiters may only be used on the game thread"));
+	if (TickGroupAwaiters[Awaiter.Group].RemoveSingle(&Awaiter) == 1)
+		return;
+	int32 Index = ResumingTickGroup.Find(&Awaiter);
+	checkf(Index != INDEX_NONE, TEXT("Internal error: unknown awaiter"));
+	ResumingTickGroup[Index] = nullptr;
+}
+
+void UUE5CoroSubsystem::ResumeReady(FAsyncPromise& Promise)
+{
+	checkf(IsInGameThread(),
+	       TEXT("Internal error: expected callback on the game thread"));
+	verifyf(CallbackAwaiters.Remove(&Promise) == 1,
+	        TEXT("Internal error: unexpected ready callback"));
+	ReadyAwaiters.Add(&Promise);
+}
+
 void UUE5CoroSubsystem::Deinitialize()
 {
 	Super::Deinitialize();
 
-	if (LatentActionsChangedHandle.IsValid())
-		FLatentActionManager::OnLatentActionsChanged().Remove(
-			LatentActionsChangedHandle);
+	// These coroutines will never resume normally, cancel them like the
+	// latent action manager would have
+	TArray<FAsyncPromise*> Promises;
+	for (auto [Promise, Awaiter] : std::exchange(PendingAwaiters, {}))
+		Promises.Add(Promise);
+	for (auto* Promise : std::exchange(CallbackAwaiters, {}))
+		Promises.Add(Promise);
+	Promises.Append(std::exchange(ReadyAwaiters, {}));
+	for (auto& Heap : Deadlines)
+		for (auto [Time, Promise] : std::exchange(Heap, {}))
+			Promises.Add(Promise);
+	for (auto& Item : std::exchange(Deferred, {}))
+		Promises.Add(Item.Get<3>());
+	for (auto* Promise : Promises)
+	{
+		// The subsystem doesn't own the coroutine, it owns itself
+		Promise->Cancel();
+		Promise->Resume(false); // No need to bypass cancellation holds
+	}
+
+	for (auto& Function : TickGroupFunctions)
+		Function.Reset(); // This unregisters it
+	TArray<FPromise*> TickGroupPromises;
+	for (auto& Awaiters : TickGroupAwaiters)
+		for (auto* Awaiter : std::exchange(Awaiters, {}))
+		{
+			Awaiter->Subsystem = nullptr;
+			TickGroupPromises.Add(std::exchange(Awaiter->Promise, nullptr));
+		}
+	for (auto* Promise : TickGroupPromises)
+	{
+		Promise->Cancel();
+		Promise->Resume(false);
+	}
+}
+
+bool UUE5CoroSubsystem::IsTickableInEditor() const
+{
+	return !CVarSkipEditorWorlds.GetValueOnGameThread();
 }
 
 void UUE5CoroSubsystem::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
+	FLatentWorldScope _(GetWorld());
+
+	TickDeferred();
+	TickReadyAwaiters();
+	TickDeadlines();
+	TickPendingAwaiters();
+	// Worlds without tick functions resume every group here, in order
+	for (int i = 0; i < TG_NewlySpawned; ++i)
+		if (!TickGroupFunctions[i] && TickGroupAwaiters[i].Num() > 0)
+			TickGroup(static_cast<ETickingGroup>(i));
 
 	// ProcessLatentActions refuses to work on non-BP classes.
 	GetClass()->ClassFlags |= CLASS_CompiledFromBlueprint;
@@ -112,19 +272,238 @@ TStatId UUE5CoroSubsystem::GetStatId() const
 	RETURN_QUICK_DECLARE_CYCLE_STAT(UUE5CoroSubsystem, STATGROUP_Tickables);
 }
 
-void UUE5CoroSubsystem::LatentActionsChanged(UObject* Object,
-                                             ELatentActionChangeType Change)
+bool UUE5CoroSubsystem::HasResumeBudget(int8 Priority)
 {
-	checkf(IsInGameThread(),
-	       TEXT("Unexpected latent action update off the game thread"));
+	float Budget = CVarLatentResumeBudget.GetValueOnGameThread();
+	if (Budget <= 0 || Priority > 0)
+		return true;
+	if (BudgetFrame != GFrameCounter)
+	{
+		BudgetFrame = GFrameCounter;
+		BudgetSpent = 0;
+	}
+	return BudgetSpent * 1e6 < Budget;
+}
+
+void UUE5CoroSubsystem::ChargeResumeBudget(double Seconds)
+{
+	if (BudgetFrame != GFrameCounter)
+	{
+		BudgetFrame = GFrameCounter;
+		BudgetSpent = 0;
+	}
+	BudgetSpent += Seconds;
+}
+
+double UUE5CoroSubsystem::GetResumeBudgetLeft()
+{
+	float Budget = CVarLatentResumeBudget.GetValueOnGameThread();
+	if (Budget <= 0)
+		return TNumericLimits<double>::Max();
+	if (BudgetFrame != GFrameCounter)
+	{
+		BudgetFrame = GFrameCounter;
+		BudgetSpent = 0;
+	}
+	return FMath::Max(0.0, Budget * 1e-6 - BudgetSpent);
+}
+
+void UUE5CoroSubsystem::TickDeferred()
+{
+	// Make progress every frame, even if the budget was already spent
+	for (bool bFirst = true;
+	     Deferred.Num() > 0 && (bFirst || HasResumeBudget(0)); bFirst = false)
+	{
+		FDeferred Item;
+		Deferred.HeapPop(Item, &BeforeDeferred);
+		double Latency = FPlatformTime::Seconds() - Item.Get<2>();
+		ResumeStats.TotalAddedLatency += Latency;
+		ResumeStats.MaxAddedLatency = FMath::Max(ResumeStats.MaxAddedLatency,
+		                                         Latency);
+		ResumeTimed(Item.Get<3>());
+	}
+}
 
-	if (Change != ELatentActionChangeType::ActionsRemoved)
+void UUE5CoroSubsystem::ResumeOrDefer(FAsyncPromise* Promise)
+{
+	int8 Priority = Promise->GetResumePriority();
+	// Don't let anything overtake coroutines that are already waiting
+	if ((Deferred.Num() == 0 || Priority > 0) && HasResumeBudget(Priority))
+	{
+		ResumeTimed(Promise);
 		return;
+	}
+	++ResumeStats.NumDeferred;
+	Deferred.HeapPush(MakeTuple(Priority, NextDeferredSequence++,
+	                            FPlatformTime::Seconds(), Promise),
+	                  &BeforeDeferred);
+}
+
+void UUE5CoroSubsystem::ResumeTimed(FAsyncPromise* Promise)
+{
+	double Start = FPlatformTime::Seconds();
+	Promise->Resume(); // This might destroy Promise
+	ChargeResumeBudget(FPlatformTime::Seconds() - Start);
+}
+
+void UUE5CoroSubsystem::TickReadyAwaiters()
+{
+	// Callbacks during these resumptions will be processed next tick
+	for (auto* Promise : std::exchange(ReadyAwaiters, {}))
+		ResumeOrDefer(Promise);
+}
+
+void UUE5CoroSubsystem::TickPendingAwaiters()
+{
+	// Resuming might add new awaiters to the end of the array, these will be
+	// polled in the same loop, similarly to new latent actions
+	for (int32 i = 0; i < PendingAwaiters.Num();)
+	{
+		auto [Promise, Awaiter] = PendingAwaiters[i];
+		if (!Awaiter->ShouldResume())
+		{
+			++i;
+			continue;
+		}
+		PendingAwaiters.RemoveAtSwap(i);
+		ResumeOrDefer(Promise);
+	}
+}
+
+void UUE5CoroSubsystem::TickDeadlines()
+{
+	for (int i = 0; i < FLatentDeadline::NumClocks; ++i)
+	{
+		auto& Heap = Deadlines[i];
+		if (Heap.Num() == 0)
+			continue;
+		double Now = GetClock(static_cast<FLatentDeadline::EClock>(i));
+		// Resuming might push more, possibly already expired deadlines
+		while (Heap.Num() > 0 && Heap.HeapTop().Get<0>() <= Now)
+		{
+			TTuple<double, FAsyncPromise*> Top;
+			Heap.HeapPop(Top, &EarlierDeadline);
+			ResumeOrDefer(Top.Get<1>());
+		}
+	}
+}
 
-	if (auto* Target = Cast<UUE5CoroChainCallbackTarget>(Object);
-	    IsValid(Target) && Target->GetOuter() == this)
+void UUE5CoroSubsystem::TickGroup(ETickingGroup Group)
+{
+	checkf(ResumingTickGroup.Num() == 0,
+	       TEXT("Internal error: overlapping tick groups"));
+	FLatentWorldScope _(GetWorld());
+	// Coroutines co_awaiting the same group again will resume next frame
+	ResumingTickGroup = std::exchange(TickGroupAwaiters[Group], {});
+	for (auto*& Awaiter : ResumingTickGroup)
+		if (Awaiter) // Destroyed by a previous resumption otherwise
+		{
+			Awaiter->Subsystem = nullptr;
+			auto* Promise = std::exchange(Awaiter->Promise, nullptr);
+			Promise->Resume(); // This might destroy Awaiter
+		}
+	ResumingTickGroup.Reset();
+}
+
+double UUE5CoroSubsystem::GetClock(FLatentDeadline::EClock Clock) const
+{
+	auto* World = GetWorld();
+	switch (Clock)
 	{
-		verify(ChainCallbackTargets.Remove(Target->GetExpectedLink()) == 1);
-		Target->Deactivate();
+		case FLatentDeadline::FrameCounter:
+			return static_cast<double>(GFrameCounter);
+		case FLatentDeadline::GameTime:
+			return World->GetTimeSeconds();
+		case FLatentDeadline::UnpausedTime:
+			return World->GetUnpausedTimeSeconds();
+		case FLatentDeadline::RealTime:
+			return World->GetRealTimeSeconds();
+		case FLatentDeadline::AudioTime:
+			return World->GetAudioTimeSeconds();
+		default:
+			checkf(false, TEXT("Internal error: invalid clock"));
+			return 0;
 	}
 }
+
+void FTickGroupFunction::ExecuteTick(float, ELevelTick, ENamedThreads::Type,
+                                     const FGraphEventRef&)
+{
+	Subsystem->TickGroup(TickGroup);
+}
+
+FString FTickGroupFunction::DiagnosticMessage()
+{
+	return FString::Printf(TEXT("UE5Coro tick group %d"),
+	                       static_cast<int>(TickGroup.GetValue()));
+}
+
+void Latent::SetResumePriority(int8 Priority)
+{
+	FPromise::Current().SetResumePriority(Priority);
+}
+
+void UUE5CoroSubsystem::SetPollInterval(const UObject* Object, float Seconds)
+{
+	if (Seconds > 0)
+		PollIntervals.Add(Object, Seconds);
+	else
+		PollIntervals.Remove(Object);
+}
+
+void Latent::SetPollInterval(double Seconds)
+{
+	checkf(Seconds >= 0, TEXT("Poll interval cannot be negative"));
+	FPromise::Current().SetPollInterval(static_cast<float>(Seconds));
+}
+
+void Latent::SetPollInterval(const UObject* Object, double Seconds)
+{
+	checkf(IsInGameThread(),
+	       TEXT("Poll intervals may only be set on the game thread"));
+	checkf(Seconds >= 0, TEXT("Poll interval cannot be negative"));
+	if (!ensureMsgf(IsValid(Object), TEXT("Invalid object for poll interval")))
+		return;
+	if (auto* World = Object->GetWorld())
+		if (auto* Sys = World->GetSubsystem<UUE5CoroSubsystem>())
+			Sys->SetPollInterval(Object, static_cast<float>(Seconds));
+}
+
+void Latent::SetHomeWorld(const UObject* WorldContext)
+{
+	checkf(IsInGameThread(),
+	       TEXT("Home worlds may only be set on the game thread"));
+	auto* World = IsValid(WorldContext) ? WorldContext->GetWorld() : nullptr;
+	ensureMsgf(IsValid(World), TEXT("Could not determine home world"));
+	FPromise::Current().SetHomeWorld(World);
+}
+
+UWorld* FPromise::GetHomeWorld() const
+{
+	return Cast<UWorld>(HomeWorld.Get());
+}
+
+void FPromise::SetHomeWorld(UWorld* World)
+{
+	HomeWorld = World;
+}
+
+UWorld* Private::GetLatentWorld()
+{
+	if (auto* Promise = GCurrentPromise)
+		if (auto* World = Promise->GetHomeWorld())
+			return World;
+	return GLatentWorld ? GLatentWorld : GWorld.GetReference();
+}
+
+FLatentWorldScope::FLatentWorldScope(UWorld* World)
+	: Previous(std::exchange(GLatentWorld, World))
+{
+	checkf(IsInGameThread(),
+	       TEXT("Internal error: latent world scope off the game thread"));
+}
+
+FLatentWorldScope::~FLatentWorldScope()
+{
+	GLatentWorld = Previous;
+}
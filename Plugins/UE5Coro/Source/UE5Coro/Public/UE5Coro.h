@@ -35,14 +35,26 @@
 #include "UE5Coro/Definitions.h"
 #include "UE5Coro/AggregateAwaiters.h"
 #include "UE5Coro/AnimationAwaiters.h"
+#include "UE5Coro/AssetAwaiters.h"
 #include "UE5Coro/AsyncAwaiters.h"
+#include "UE5Coro/AsyncGenerator.h"
 #include "UE5Coro/Cancellation.h"
+#include "UE5Coro/CompressionAwaiters.h"
 #include "UE5Coro/Coroutine.h"
 #include "UE5Coro/CoroutineAwaiters.h"
+#include "UE5Coro/CoroutineBatch.h"
+#include "UE5Coro/DelegateSubscription.h"
+#include "UE5Coro/FileAwaiters.h"
 #include "UE5Coro/Generator.h"
 #include "UE5Coro/HttpAwaiters.h"
 #include "UE5Coro/LatentAwaiters.h"
 #include "UE5Coro/LatentCallbacks.h"
 #include "UE5Coro/LatentTimeline.h"
+#include "UE5Coro/LazyCoroutine.h"
+#include "UE5Coro/PhysicsAwaiters.h"
+#include "UE5Coro/RenderAwaiters.h"
+#include "UE5Coro/SaveGameAwaiters.h"
+#include "UE5Coro/Scheduler.h"
+#include "UE5Coro/SocketAwaiters.h"
 #include "UE5Coro/TaskAwaiters.h"
 #include "UE5Coro/Threading.h"
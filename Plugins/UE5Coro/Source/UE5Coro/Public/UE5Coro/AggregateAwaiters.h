@@ -43,6 +43,14 @@ namespace UE5Coro::Private
 class FAnyAwaiter;
 class FAllAwaiter;
 class FRaceAwaiter;
+class FTimeoutAwaiter;
+template<typename, bool> class TAllResultsAwaiter;
+template<typename> class TTimeoutAwaiter;
+
+template<typename>
+constexpr bool TIsCoroutine = false;
+template<typename T>
+constexpr bool TIsCoroutine<TCoroutine<T>> = true;
 
 #if UE5CORO_CPP20
 // If your WhenAny/WhenAll call doesn't satisfy this concept, you'll need to
@@ -97,6 +105,31 @@ Private::FAllAwaiter WhenAll(T&&...);
 /** Resumes the awaiting coroutine when all other coroutines have completed. */
 UE5CORO_API Private::FAllAwaiter WhenAll(const TArray<TCoroutine<>>&);
 #endif
+
+/** Resumes the awaiting coroutine when all coroutines in the array have
+ *  completed.<br>
+ *  The result of the co_await expression is a TArray of their results in the
+ *  same order, moved out of each coroutine as it completes. Unsuccessful
+ *  coroutines provide a default-constructed T. */
+template<typename T>
+Private::TAllResultsAwaiter<T, false> WhenAllResults(TArray<TCoroutine<T>>);
+
+/** Resumes the awaiting coroutine when all coroutines in the array have
+ *  completed.<br>
+ *  The result of the co_await expression is a TArray in the same order, with
+ *  an element for each coroutine: a TOptional<T> that's only set if the
+ *  coroutine was successful, or a bool for TCoroutine<>. */
+template<typename T>
+Private::TAllResultsAwaiter<T, true> WhenAllSettled(TArray<TCoroutine<T>>);
+
+/** co_awaits the coroutine for at most the provided number of seconds.<br>
+ *  If it doesn't complete in time, it's canceled, and the caller is resumed
+ *  without waiting for the cancellation to take effect.<br>
+ *  The result of the co_await expression is a TOptional<T> that's only set if
+ *  the coroutine completed in time, or a bool for TCoroutine<>. */
+template<typename T>
+Private::TTimeoutAwaiter<T> WithTimeout(TCoroutine<T> Coroutine,
+                                        double Seconds);
 }
 
 namespace UE5Coro::Private
@@ -104,20 +137,30 @@ namespace UE5Coro::Private
 class [[nodiscard]] UE5CORO_API FAggregateAwaiter
 	: public TAwaiter<FAggregateAwaiter>
 {
-	struct FData
+	struct FData : FCancellationHook
 	{
 		FMutex Lock;
 		int Count;
 		int Index = -1;
 		FPromise* Promise = nullptr;
+		// Helpers are owned and canceled once they're not needed anymore.
+		// Coroutines passed in directly are only canceled with the caller.
+		TArray<TCoroutine<>> Helpers;
+		TArray<TCoroutine<>> Coroutines;
 
-		explicit FData(int Count) : Count(Count) { }
+		explicit FData(int Count)
+			: FCancellationHook(&OnCanceled), Count(Count) { }
 	};
 
 	std::shared_ptr<FData> Data;
 
+	template<typename T>
+	static void Register(const std::shared_ptr<FData>&, int, T&&);
 	template<typename T>
 	static TCoroutine<> Consume(std::shared_ptr<FData>, int, T&&);
+	static void Finish(const std::shared_ptr<FData>&, int);
+	static void OnCanceled(FCancellationHook&);
+	static void CancelChildren(FData&, bool bHelpersOnly);
 
 protected:
 	int GetResumerIndex() const;
@@ -128,11 +171,14 @@ public:
 		: Data(std::make_shared<FData>(Count))
 	{
 		int Idx = 0;
-		(Consume(Data, Idx++, std::forward<T>(Awaiters)), ...);
+		(Register(Data, Idx++, std::forward<T>(Awaiters)), ...);
 	}
 
 	template<typename T>
 	explicit FAggregateAwaiter(T, const TArray<TCoroutine<>>& Coroutines);
+	FAggregateAwaiter(const FAggregateAwaiter&) = delete;
+	FAggregateAwaiter(FAggregateAwaiter&&) = default;
+	~FAggregateAwaiter();
 
 	bool await_ready();
 	void Suspend(FPromise&);
@@ -158,7 +204,7 @@ public:
 
 class [[nodiscard]] UE5CORO_API FRaceAwaiter : public TAwaiter<FRaceAwaiter>
 {
-	struct FData
+	struct FData : FCancellationHook
 	{
 		FMutex Lock;
 		TArray<TCoroutine<>> Handles;
@@ -166,16 +212,102 @@ class [[nodiscard]] UE5CORO_API FRaceAwaiter : public TAwaiter<FRaceAwaiter>
 		FPromise* Promise = nullptr;
 
 		explicit FData(TArray<TCoroutine<>>&& Array)
-			: Handles(std::move(Array)) { }
+			: FCancellationHook(&OnCanceled), Handles(std::move(Array)) { }
 	};
 	std::shared_ptr<FData> Data;
 
+	static void OnCanceled(FCancellationHook&);
+
 public:
 	explicit FRaceAwaiter(TArray<TCoroutine<>>&&);
+	FRaceAwaiter(const FRaceAwaiter&) = delete;
+	FRaceAwaiter(FRaceAwaiter&&) = default;
+	~FRaceAwaiter();
 	bool await_ready();
 	void Suspend(FPromise&);
 	int await_resume() noexcept;
 };
+
+class [[nodiscard]] UE5CORO_API FTimeoutAwaiter
+	: public TAwaiter<FTimeoutAwaiter>
+{
+	struct FState;
+	std::shared_ptr<FState> State;
+
+public:
+	explicit FTimeoutAwaiter(TCoroutine<> Antecedent, double Seconds);
+	UE_NONCOPYABLE(FTimeoutAwaiter);
+	~FTimeoutAwaiter();
+
+	bool await_ready();
+	void Suspend(FPromise&);
+	/** @return true if the coroutine completed in time. */
+	bool await_resume();
+};
+
+template<typename T>
+class [[nodiscard]] TTimeoutAwaiter final : public FTimeoutAwaiter
+{
+	TCoroutine<T> Antecedent;
+
+public:
+	explicit TTimeoutAwaiter(TCoroutine<T> Antecedent, double Seconds)
+		: FTimeoutAwaiter(Antecedent, Seconds)
+		, Antecedent(std::move(Antecedent)) { }
+
+	TOptional<T> await_resume()
+	{
+		if (!FTimeoutAwaiter::await_resume())
+			return {};
+		return Antecedent.MoveResult();
+	}
+};
+
+template<>
+class [[nodiscard]] TTimeoutAwaiter<void> final : public FTimeoutAwaiter
+{
+public:
+	using FTimeoutAwaiter::FTimeoutAwaiter;
+};
+
+template<typename T, bool bSettled>
+class [[nodiscard]] TAllResultsAwaiter
+	: public TAwaiter<TAllResultsAwaiter<T, bSettled>>
+{
+	static_assert(bSettled || !std::is_void_v<T>,
+	              "WhenAllResults needs coroutines with a return value");
+	using FResult = std::conditional_t<!bSettled, T,
+	                std::conditional_t<std::is_void_v<T>, bool, TOptional<T>>>;
+
+	struct FData : FCancellationHook
+	{
+		FMutex Lock;
+		int Count;
+		TArray<TCoroutine<T>> Coroutines; // Doesn't change after construction
+		TArray<FResult> Results;
+		FPromise* Promise = nullptr;
+
+		explicit FData(TArray<TCoroutine<T>>&& Array)
+			: FCancellationHook(&OnCanceled), Count(Array.Num())
+			, Coroutines(std::move(Array))
+		{
+			Results.SetNum(Coroutines.Num());
+		}
+	};
+	std::shared_ptr<FData> Data;
+
+	static void Finish(const std::shared_ptr<FData>&, int);
+	static void OnCanceled(FCancellationHook&);
+
+public:
+	explicit TAllResultsAwaiter(TArray<TCoroutine<T>>&&);
+	TAllResultsAwaiter(const TAllResultsAwaiter&) = delete;
+	TAllResultsAwaiter(TAllResultsAwaiter&&) = default;
+	~TAllResultsAwaiter();
+	bool await_ready();
+	void Suspend(FPromise&);
+	TArray<FResult> await_resume();
+};
 }
 
 template<UE5CORO_PRIVATE_AWAITABLE... T>
@@ -203,6 +335,27 @@ UE5Coro::Private::FAllAwaiter UE5Coro::WhenAll(T&&... Args)
 	return Private::FAllAwaiter(sizeof...(Args), std::forward<T>(Args)...);
 }
 
+template<typename T>
+void UE5Coro::Private::FAggregateAwaiter::Register(
+	const std::shared_ptr<FData>& Data, int Index, T&& Awaiter)
+{
+	// Coroutines can report their completion directly, everything else is
+	// consumed by a helper coroutine
+	if constexpr (TIsCoroutine<std::decay_t<T>>)
+	{
+		TCoroutine<> Coro = std::forward<T>(Awaiter);
+		Coro.ContinueWith([Data, Index] { Finish(Data, Index); });
+		std::scoped_lock _(Data->Lock);
+		Data->Coroutines.Add(std::move(Coro));
+	}
+	else
+	{
+		auto Helper = Consume(Data, Index, std::forward<T>(Awaiter));
+		std::scoped_lock _(Data->Lock);
+		Data->Helpers.Add(std::move(Helper));
+	}
+}
+
 template<typename T>
 UE5Coro::TCoroutine<> UE5Coro::Private::FAggregateAwaiter::Consume(
 	std::shared_ptr<FData> Data, int Index, T&& Awaiter)
@@ -211,21 +364,129 @@ UE5Coro::TCoroutine<> UE5Coro::Private::FAggregateAwaiter::Consume(
 	// you'll need to fix your usage of WhenAny/WhenAll and move the affected
 	// noncopyable parameter into the call with MoveTemp/std::move/etc.
 
-	ON_SCOPE_EXIT
+	ON_SCOPE_EXIT { Finish(Data, Index); };
+	co_await std::move(AwaiterCopy);
+}
+
+template<typename T>
+UE5Coro::Private::TTimeoutAwaiter<T> UE5Coro::WithTimeout(
+	TCoroutine<T> Coroutine, double Seconds)
+{
+	return Private::TTimeoutAwaiter<T>(std::move(Coroutine), Seconds);
+}
+
+template<typename T>
+UE5Coro::Private::TAllResultsAwaiter<T, false> UE5Coro::WhenAllResults(
+	TArray<TCoroutine<T>> Coroutines)
+{
+	return Private::TAllResultsAwaiter<T, false>(std::move(Coroutines));
+}
+
+template<typename T>
+UE5Coro::Private::TAllResultsAwaiter<T, true> UE5Coro::WhenAllSettled(
+	TArray<TCoroutine<T>> Coroutines)
+{
+	return Private::TAllResultsAwaiter<T, true>(std::move(Coroutines));
+}
+
+template<typename T, bool bSettled>
+UE5Coro::Private::TAllResultsAwaiter<T, bSettled>::TAllResultsAwaiter(
+	TArray<TCoroutine<T>>&& Array)
+	: Data(std::make_shared<FData>(std::move(Array)))
+{
+	// Data->Coroutines doesn't change, but Finish may already run in here
+	for (int i = 0; i < Data->Coroutines.Num(); ++i)
+		Data->Coroutines[i].ContinueWith([Data = Data, i]
+		{
+			Finish(Data, i);
+		});
+}
+
+template<typename T, bool bSettled>
+UE5Coro::Private::TAllResultsAwaiter<T, bSettled>::~TAllResultsAwaiter()
+{
+	if (!Data)
+		return;
+	FPromise* Awaiting;
+	bool bPending;
 	{
-		std::unique_lock _(Data->Lock);
-		if (--Data->Count != 0)
-			return;
-		Data->Index = Index; // Mark that this index was the one reaching 0
-		auto* Promise = Data->Promise;
-		_.unlock();
-
-		// Not co_awaited yet if this is nullptr, await_ready deals with this
-		if (Promise != nullptr)
-			Promise->Resume();
-	};
+		std::scoped_lock _(Data->Lock);
+		Awaiting = Data->Promise;
+		bPending = Awaiting && Data->Count > 0;
+		if (bPending) // The awaiting coroutine is being destroyed early
+			Data->Promise = nullptr;
+	}
+	if (Awaiting)
+		Awaiting->RemoveCancellationHook(*Data);
+	if (bPending)
+		OnCanceled(*Data);
+}
 
-	co_await std::move(AwaiterCopy);
+template<typename T, bool bSettled>
+void UE5Coro::Private::TAllResultsAwaiter<T, bSettled>::OnCanceled(
+	FCancellationHook& Hook)
+{
+	for (auto& Coro : static_cast<FData&>(Hook).Coroutines)
+		Coro.Cancel();
+}
+
+template<typename T, bool bSettled>
+void UE5Coro::Private::TAllResultsAwaiter<T, bSettled>::Finish(
+	const std::shared_ptr<FData>& Data, int Index)
+{
+	// Every index is only written once, by its own coroutine's continuation
+	auto& Coro = Data->Coroutines[Index];
+	if constexpr (!bSettled)
+		Data->Results[Index] = Coro.MoveResult();
+	else if constexpr (std::is_void_v<T>)
+		Data->Results[Index] = Coro.WasSuccessful();
+	else if (Coro.WasSuccessful())
+		Data->Results[Index].Emplace(Coro.MoveResult());
+
+	std::unique_lock _(Data->Lock);
+	if (--Data->Count != 0)
+		return;
+	auto* Promise = Data->Promise;
+	_.unlock();
+
+	// Not co_awaited yet if this is nullptr, await_ready deals with this
+	if (Promise != nullptr)
+		Promise->Resume();
+}
+
+template<typename T, bool bSettled>
+bool UE5Coro::Private::TAllResultsAwaiter<T, bSettled>::await_ready()
+{
+	checkf(Data, TEXT("Attempting to await moved-from aggregate awaiter"));
+	Data->Lock.lock();
+	checkf(!Data->Promise, TEXT("Attempting to reuse aggregate awaiter"));
+
+	// Carry the lock to Suspend if not ready
+	bool bReady = Data->Count <= 0;
+	if (bReady)
+		Data->Lock.unlock();
+	return bReady;
+}
+
+template<typename T, bool bSettled>
+void UE5Coro::Private::TAllResultsAwaiter<T, bSettled>::Suspend(
+	FPromise& Promise)
+{
+	checkf(!Data->Lock.try_lock(), TEXT("Internal error: lock was not taken"));
+	Data->Promise = &Promise;
+	// This needs to happen before unlocking, `this` might be gone after that.
+	// OnCanceled doesn't need the lock.
+	if (!Promise.AddCancellationHook(*Data))
+		OnCanceled(*Data);
+	Data->Lock.unlock();
+}
+
+template<typename T, bool bSettled>
+auto UE5Coro::Private::TAllResultsAwaiter<T, bSettled>::await_resume()
+	-> TArray<FResult>
+{
+	checkf(Data->Count <= 0, TEXT("Internal error: resuming too early"));
+	return std::move(Data->Results);
 }
 
 #undef UE5CORO_PRIVATE_AWAITABLE
@@ -44,6 +44,7 @@ namespace UE5Coro::Private
 using FPayloadPtr = const FBranchingPointNotifyPayload*;
 using FPayloadTuple = TTuple<FName, const FBranchingPointNotifyPayload*>;
 template<typename> class TAnimAwaiter;
+class FAnimCurveAwaiter;
 using FAnimAwaiterVoid = TAnimAwaiter<std::monostate>;
 using FAnimAwaiterBool = TAnimAwaiter<bool>;
 using FAnimAwaiterPayload = TAnimAwaiter<FPayloadPtr>;
@@ -142,15 +143,92 @@ UE5CORO_API auto PlayMontageNotifyBegin(UAnimInstance* Instance,
 UE5CORO_API auto PlayMontageNotifyEnd(UAnimInstance* Instance,
                                       UAnimMontage* Montage, FName NotifyName)
 	-> Private::FAnimAwaiterPayload;
+
+/** Waits for the anim instance's curve to go from at most Threshold to above
+ *  it.<br>
+ *  Curves are checked once per animation evaluation, as soon as its results
+ *  are available on the game thread, together with every other curve awaiter
+ *  on the same anim instance.<br>
+ *  The result of the co_await expression is the curve's new value.<br>
+ *  The return value of this function is copyable but only one copy may be
+ *  co_awaited at the same time.<br>
+ *  The anim instance getting destroyed early counts as the curve having
+ *  crossed the threshold, with a result of 0.
+ *  Use IsValid(Instance) after the co_await to detect this, if desired. */
+UE5CORO_API Private::FAnimCurveAwaiter CurveRisesAbove(UAnimInstance* Instance,
+                                                       FName CurveName,
+                                                       float Threshold);
+
+/** Waits for the anim instance's curve to go from at least Threshold to below
+ *  it.<br>
+ *  Curves are checked once per animation evaluation, as soon as its results
+ *  are available on the game thread, together with every other curve awaiter
+ *  on the same anim instance.<br>
+ *  The result of the co_await expression is the curve's new value.<br>
+ *  The return value of this function is copyable but only one copy may be
+ *  co_awaited at the same time.<br>
+ *  The anim instance getting destroyed early counts as the curve having
+ *  crossed the threshold, with a result of 0.
+ *  Use IsValid(Instance) after the co_await to detect this, if desired. */
+UE5CORO_API Private::FAnimCurveAwaiter CurveFallsBelow(UAnimInstance* Instance,
+                                                       FName CurveName,
+                                                       float Threshold);
 }
 
 namespace UE5Coro::Private
 {
+enum class EAnimEvent : uint8
+{
+	MontageBlendingOut,
+	MontageEnded,
+	Notify,
+	PlayMontageNotifyBegin,
+	PlayMontageNotifyEnd,
+	AnyPlayMontageNotifyBegin,
+	AnyPlayMontageNotifyEnd,
+	Curve,
+};
+
+/** Identifies what an anim awaiter is waiting for on its anim instance. */
+struct FAnimEventKey
+{
+	EAnimEvent Event = EAnimEvent::Notify;
+	int32 MontageInstanceID = INDEX_NONE;
+	FName Name;
+
+	bool operator==(const FAnimEventKey& Other) const
+	{
+		return Event == Other.Event &&
+		       MontageInstanceID == Other.MontageInstanceID &&
+		       Name == Other.Name;
+	}
+
+	friend uint32 GetTypeHash(const FAnimEventKey& Key)
+	{
+		return HashCombine(HashCombine(GetTypeHash(Key.Name),
+		                               ::GetTypeHash(Key.MontageInstanceID)),
+		                   static_cast<uint32>(Key.Event));
+	}
+};
+
+// Void's result is indicated by this holding a bool, not monostate
+using FAnimResult = std::variant<std::monostate, bool, FPayloadPtr,
+                                 FPayloadTuple, float>;
+
 class [[nodiscard]] FAnimAwaiter : public TAwaiter<FAnimAwaiter>
 {
+	friend UUE5CoroAnimCallbackTarget;
+
 protected:
-	TStrongObjectPtr<UUE5CoroAnimCallbackTarget> Target;
-	bool bSuspended = false;
+	// Intrusive list node in the anim instance's shared listener.
+	// Listener is nullptr if this is not waiting for anything (anymore).
+	UUE5CoroAnimCallbackTarget* Listener = nullptr;
+	FAnimAwaiter* Prev = nullptr;
+	FAnimAwaiter* Next = nullptr;
+	FAnimAwaiter** DispatchSlot = nullptr;
+	FPromise* Promise = nullptr;
+	FAnimEventKey Key;
+	FAnimResult Result;
 
 	FAnimAwaiter(UAnimInstance*, UAnimMontage*);
 	~FAnimAwaiter();
@@ -165,8 +243,6 @@ public:
 template<typename T>
 class [[nodiscard]] TAnimAwaiter : public FAnimAwaiter
 {
-	friend UUE5CoroAnimCallbackTarget;
-
 	static constexpr enum
 	{
 		Void,
@@ -188,4 +264,20 @@ public:
 	UE5CORO_API bool await_ready();
 	UE5CORO_API std::conditional_t<Type == Void, void, T> await_resume();
 };
+class [[nodiscard]] FAnimCurveAwaiter : public FAnimAwaiter
+{
+	friend UUE5CoroAnimCallbackTarget;
+
+	float Threshold;
+	float LastValue = 0;
+	bool bRising;
+
+public:
+	FAnimCurveAwaiter(UAnimInstance*, FName CurveName, float Threshold,
+	                  bool bRising);
+	UE5CORO_API ~FAnimCurveAwaiter();
+
+	UE5CORO_API bool await_ready();
+	UE5CORO_API float await_resume();
+};
 }
@@ -45,10 +45,18 @@ class FAsyncAwaiter;
 class FAsyncPromise;
 class FAsyncTimeAwaiter;
 class FAsyncYieldAwaiter;
+class FFrameJoinAwaiter;
+class FFrameWorkerAwaiter;
 class FLatentPromise;
+struct FLauncherState;
+class FLongTaskAwaiter;
 class FNewThreadAwaiter;
+class FPeriodicTimerAwaiter;
 template<typename, typename...> class TDelegateAwaiter;
+template<typename, typename...> class TDelegateViewAwaiter;
 template<typename, typename...> class TDynamicDelegateAwaiter;
+template<typename> class TParallelForAwaiter;
+template<typename, typename> class TParallelTransformAwaiter;
 }
 
 namespace UE5Coro::Async
@@ -71,6 +79,15 @@ UE5CORO_API Private::FAsyncAwaiter MoveToGameThread();
  *  stored to "remember" the original thread, then co_awaited later. */
 UE5CORO_API Private::FAsyncAwaiter MoveToSimilarThread();
 
+/** Sets the thread and task priority that the calling coroutine is resumed
+ *  with when it goes through the task graph, e.g., after PlatformSeconds,
+ *  Yield, or an HTTP request.<br>
+ *  Only the priority bits of the provided value are used, and they override
+ *  the ones passed to MoveToThread.
+ *  Without a call to this function, coroutines keep the priority of their
+ *  last MoveToThread target. */
+UE5CORO_API void SetTaskPriority(ENamedThreads::Type Priority);
+
 /** Always suspends the coroutine and resumes it on the same kind of named
  *  thread that it's currently running on, or AnyThread otherwise.<br>
  *  The return value of this function is reusable and always refers to the
@@ -78,6 +95,14 @@ UE5CORO_API Private::FAsyncAwaiter MoveToSimilarThread();
  *  was called. */
 UE5CORO_API Private::FAsyncYieldAwaiter Yield();
 
+/** Like Yield, but only suspends the coroutine if it has been running for at
+ *  least the provided amount of time since it was last resumed.<br>
+ *  Intended for long loops that should periodically let others run, without
+ *  paying for a suspension on every iteration.<br>
+ *  The return value of this function is reusable. */
+UE5CORO_API Private::FAsyncYieldAwaiter YieldIfBudgetExceeded(
+	int64 Microseconds);
+
 /** Starts a new thread with additional control over priority, affinity, etc.
  *  and resumes the coroutine there.<br>
  *  Intended for long-running operations before the next co_await or co_return.
@@ -89,6 +114,33 @@ UE5CORO_API Private::FNewThreadAwaiter MoveToNewThread(
 	uint64 Affinity = FPlatformAffinity::GetNoAffinityMask(),
 	EThreadCreateFlags Flags = EThreadCreateFlags::None);
 
+/** Resumes the coroutine on a thread owned by UE5Coro that's dedicated to
+ *  long-running operations, similarly to MoveToNewThread.<br>
+ *  Threads are reused between co_awaits, and exit after not being used for a
+ *  while. See the UE5Coro.LongTaskPool console variables for the limits.<br>
+ *  The return value of this function is reusable. */
+UE5CORO_API Private::FLongTaskAwaiter MoveToLongTaskPool(
+	EThreadPriority Priority = TPri_Normal,
+	uint64 Affinity = FPlatformAffinity::GetNoAffinityMask());
+
+/** Resumes the coroutine on a task graph worker thread, as work that belongs
+ *  to the current frame. This may only be co_awaited on the game thread.<br>
+ *  The game thread joins this work after every world's last tick group: it
+ *  runs frame work that hasn't started yet itself, then waits for the rest to
+ *  co_await JoinAtFrameEnd or complete.<br>
+ *  In between, the coroutine must not wait for anything that needs the game
+ *  thread, which is blocked during the join.<br>
+ *  The return value of this function is reusable. */
+UE5CORO_API Private::FFrameWorkerAwaiter MoveToFrameWorker();
+
+/** Resumes the coroutine on the game thread when the frame work is joined,
+ *  after the last tick group of the current world tick. It's ready before the
+ *  world's end-of-frame updates.<br>
+ *  This ends the frame work started by MoveToFrameWorker. It can also be used
+ *  on its own, in which case it doesn't hold up the game thread.<br>
+ *  The return value of this function is reusable. */
+UE5CORO_API Private::FFrameJoinAwaiter JoinAtFrameEnd();
+
 /** Resumes the coroutine after the specified amount of time has elapsed, based
  *  on FPlatformTime.<br>
  *  The coroutine will resume on the same kind of named thread as it was running
@@ -100,6 +152,14 @@ UE5CORO_API Private::FAsyncTimeAwaiter PlatformSeconds(double Seconds);
  *  The coroutine will resume on an unspecified worker thread. */
 UE5CORO_API Private::FAsyncTimeAwaiter PlatformSecondsAnyThread(double Seconds);
 
+/** Resumes the coroutine after the specified amount of time has elapsed, based
+ *  on FPlatformTime, trading CPU time for accuracy.<br>
+ *  The timer thread sleeps until shortly before the target time, then spins for
+ *  the rest of the wait (see UE5Coro.TimerSpinTime).<br>
+ *  The coroutine will resume on the same kind of named thread as it was running
+ *  on when it was suspended. */
+UE5CORO_API Private::FAsyncTimeAwaiter PlatformSecondsPrecise(double Seconds);
+
 /** Resumes the coroutine after FPlatformTime::Seconds has reached the specified
  *  amount.<br>
  *  The coroutine will resume on the same kind of named thread as it was running
@@ -110,6 +170,85 @@ UE5CORO_API Private::FAsyncTimeAwaiter UntilPlatformTime(double Time);
  *  amount.<br>
  *  The coroutine will resume on an unspecified worker thread. */
 UE5CORO_API Private::FAsyncTimeAwaiter UntilPlatformTimeAnyThread(double Time);
+
+/** Resumes the coroutine after FPlatformTime::Seconds has reached the specified
+ *  amount, trading CPU time for accuracy like PlatformSecondsPrecise.<br>
+ *  The coroutine will resume on the same kind of named thread as it was running
+ *  on when it was suspended. */
+UE5CORO_API Private::FAsyncTimeAwaiter UntilPlatformTimePrecise(double Time);
+
+/** Calls Body with every index in [0, Num) on the task graph's background
+ *  worker threads, in batches of at least MinBatchSize indices.<br>
+ *  The coroutine is resumed once, after every call has returned, on the same
+ *  kind of named thread as it was running on when it was suspended.<br>
+ *  Body may be called concurrently from multiple threads. */
+template<typename F>
+Private::TParallelForAwaiter<std::decay_t<F>> ParallelFor(
+	int32 Num, F&& Body, int32 MinBatchSize = 1);
+
+/** co_awaiting the return value behaves like co_awaiting Delegate directly,
+ *  but the parameters are not copied: the result refers to the parameters of
+ *  the Execute or Broadcast call, which are only valid until the next
+ *  co_await.<br>
+ *  This is only useful for delegates with large parameters, and only
+ *  supported for native delegates. */
+template<typename T>
+auto ViewPayload(T& Delegate);
+
+/** Like ParallelFor, calling Fn with every element of Input.<br>
+ *  The result of the co_await expression is a TArray of Fn's return values,
+ *  in the same order as Input. Input must stay alive until then. */
+template<typename T, typename A, typename F>
+Private::TParallelTransformAwaiter<T, std::decay_t<F>> ParallelTransform(
+	const TArray<T, A>& Input, F&& Fn, int32 MinBatchSize = 1);
+
+/** Starts coroutines from factories, with at most a fixed number of them
+ *  running at the same time.<br>
+ *  Factories that cannot start yet are queued, and only called once a slot is
+ *  free, so that queued work does not need a coroutine frame of its own.
+ *  They are started in the order they were launched, on the thread where the
+ *  previous coroutine in their slot completed.<br>
+ *  This object is thread safe. Destroying it discards factories that haven't
+ *  been called yet, but coroutines that are already running are unaffected. */
+class [[nodiscard]] UE5CORO_API FLauncher final
+{
+	TSharedRef<Private::FLauncherState> State;
+
+public:
+	explicit FLauncher(int32 MaxConcurrent);
+	UE_NONCOPYABLE(FLauncher);
+	~FLauncher();
+
+	/** Calls Factory now if there's a free slot, otherwise queues it until
+	 *  there is. The slot is freed when the returned coroutine completes. */
+	void Launch(TUniqueFunction<TCoroutine<>()> Factory);
+
+	/** @return The number of factories that are waiting for a free slot. */
+	[[nodiscard]] int32 NumQueued() const;
+
+	/** @return The number of coroutines that are running in the slots. */
+	[[nodiscard]] int32 NumRunning() const;
+
+	/** The returned coroutine completes once nothing is running or queued,
+	 *  which includes everything that was launched before it, on the thread
+	 *  where the last running coroutine completed. Factories launched while
+	 *  draining are held back until it's done. Concurrent Drains are served one
+	 *  at a time. */
+	TCoroutine<> Drain();
+};
+
+/** What a FPeriodicTimer does with ticks that were missed because the awaiting
+ *  coroutine was late to co_await it again. */
+enum class EMissedTicks : uint8
+{
+	/** Drops the missed ticks, and keeps the original schedule. */
+	Skip,
+	/** Delivers every missed tick, without suspending, until caught up. */
+	Burst,
+	/** Delivers the missed ticks as one, and keeps the original schedule.
+	 *  The result of the co_await expression is the number of ticks. */
+	Coalesce,
+};
 }
 
 namespace UE5Coro::Private
@@ -131,11 +270,14 @@ public:
 };
 
 class [[nodiscard]] UE5CORO_API FAsyncTimeAwaiter
-	: public TAwaiter<FAsyncTimeAwaiter>
+	: public TAwaiter<FAsyncTimeAwaiter>, private FCancellationHook
 {
 	friend class FTimerThread;
+	friend class FTimerHeap;
+	friend class FTimerWheel;
 
 	const double TargetTime;
+	const bool bPrecise;
 	union FState
 	{
 		bool bAnyThread; // Before suspension
@@ -143,29 +285,134 @@ class [[nodiscard]] UE5CORO_API FAsyncTimeAwaiter
 		explicit FState(bool bAnyThread) : bAnyThread(bAnyThread) { }
 	} U;
 	std::atomic<FPromise*> Promise = nullptr;
+	FPromise* Hooked = nullptr; // Where the cancellation hook was registered
+
+	// Intrusive queue state, owned by FTimerThread and guarded by its lock
+	FAsyncTimeAwaiter* Prev = nullptr;
+	FAsyncTimeAwaiter* Next = nullptr;
+	int32 QueueIndex = INDEX_NONE; // INDEX_NONE if not queued
+	bool bCanceled = false; // Resume as soon as possible instead of queueing
+	// Called on the timer thread instead of resuming a Promise, if set
+	void (*Callback)(void*) = nullptr;
+	void* Context = nullptr;
+
+	static void OnCanceled(FCancellationHook&);
+	void Unhook();
 
 public:
-	explicit FAsyncTimeAwaiter(double TargetTime, bool bAnyThread)
-		: TargetTime(TargetTime), U(bAnyThread) { }
+	explicit FAsyncTimeAwaiter(double TargetTime, bool bAnyThread,
+	                           bool bPrecise = false)
+		: FCancellationHook(&OnCanceled), TargetTime(TargetTime)
+		, bPrecise(bPrecise), U(bAnyThread) { }
 	FAsyncTimeAwaiter(const FAsyncTimeAwaiter&);
 	~FAsyncTimeAwaiter();
 
 	bool await_ready();
 	void Suspend(FPromise&);
+	void await_resume();
 
 	bool operator<(const FAsyncTimeAwaiter& Other) const noexcept
 	{
 		return TargetTime < Other.TargetTime;
 	}
+};
 
-private:
-	void Resume();
+/** Histograms of how late FAsyncTimeAwaiters were resumed by the timer thread,
+ *  measured from their target time to the moment they were dispatched. */
+struct UE5CORO_API FTimerLateness
+{
+	/** Bucket 0 counts timers that were less than 1 µs late, bucket N counts
+	 *  [2^(N-1), 2^N) µs, and the last bucket counts everything above. */
+	static constexpr int NumBuckets = 16;
+	uint64 Standard[NumBuckets] = {};
+	uint64 Precise[NumBuckets] = {};
+
+	/** Returns a snapshot of the lateness observed since startup. */
+	static FTimerLateness Get();
+};
+}
+
+namespace UE5Coro::Async
+{
+/**
+ * Reusable timer that resumes its awaiting coroutine every Period seconds,
+ * based on FPlatformTime.<br>
+ * Ticks are scheduled against absolute deadlines from construction or the
+ * last Reset(), so that late resumptions don't accumulate drift. co_awaiting
+ * this object reuses the same timer node every time, and does not allocate.
+ * <br>The result of the co_await expression is the number of ticks that it
+ * delivered, which is always 1 unless the policy is EMissedTicks::Coalesce.
+ * <br>The coroutine will resume on the same kind of named thread as it was
+ * running on when it was suspended, or any worker thread if bAnyThread is
+ * true.<br>
+ * Only one coroutine may co_await a periodic timer at a time.
+ */
+class UE5CORO_API FPeriodicTimer final
+{
+	friend Private::FPeriodicTimerAwaiter;
+
+	const double Period;
+	const EMissedTicks Policy;
+	const bool bAnyThread;
+	double NextTime;
+	TOptional<Private::FAsyncTimeAwaiter> Timer;
+
+public:
+	explicit FPeriodicTimer(double Period,
+	                        EMissedTicks Policy = EMissedTicks::Skip,
+	                        bool bAnyThread = false);
+	UE_NONCOPYABLE(FPeriodicTimer);
+
+	/** Restarts the schedule, the next tick is one period from now. */
+	void Reset();
+
+	/** @return The FPlatformTime::Seconds() of the next tick. */
+	[[nodiscard]] double GetNextTime() const { return NextTime; }
+};
+}
+
+namespace UE5Coro::Private
+{
+class [[nodiscard]] UE5CORO_API FPeriodicTimerAwaiter final
+{
+	Async::FPeriodicTimer& Timer;
+
+public:
+	explicit FPeriodicTimerAwaiter(Async::FPeriodicTimer& Timer)
+		: Timer(Timer) { }
+	UE_NONCOPYABLE(FPeriodicTimerAwaiter);
+	~FPeriodicTimerAwaiter();
+
+	bool await_ready();
+
+	template<typename P>
+	void await_suspend(stdcoro::coroutine_handle<P> Handle)
+	{
+		Timer.Timer->await_suspend(Handle);
+	}
+
+	int await_resume();
+};
+
+template<typename P>
+struct TAwaitTransform<P, Async::FPeriodicTimer>
+{
+	FPeriodicTimerAwaiter operator()(Async::FPeriodicTimer& Timer)
+	{
+		return FPeriodicTimerAwaiter(Timer);
+	}
 };
 
 class [[nodiscard]] UE5CORO_API FAsyncYieldAwaiter
 	: public TAwaiter<FAsyncYieldAwaiter>
 {
+	uint64 BudgetCycles = 0; // 0 means always yield
+
 public:
+	FAsyncYieldAwaiter() = default;
+	explicit FAsyncYieldAwaiter(int64 Microseconds);
+
+	bool await_ready();
 	void Suspend(FPromise&);
 };
 
@@ -175,6 +422,15 @@ class [[nodiscard]] TFutureAwaiter final : public TAwaiter<TFutureAwaiter<T>>
 	TFuture<T> Future;
 	std::remove_reference_t<T>* Result = nullptr; // Dangerous!
 
+	// Get() would return a const&, and force a copy
+	static auto Take(TFuture<T>& InFuture)
+	{
+		if constexpr (std::is_void_v<T>)
+			return InFuture.Get();
+		else
+			return InFuture.Consume();
+	}
+
 public:
 	explicit TFutureAwaiter(TFuture<T>&& Future) : Future(std::move(Future)) { }
 	UE_NONCOPYABLE(TFutureAwaiter);
@@ -212,7 +468,7 @@ public:
 				// is harmless to process; await_resume will ignore it.
 
 				// It's normally dangerous to expose a pointer to a local, but
-				auto Value = InFuture.Get(); // This will be alive while...
+				auto Value = Take(InFuture); // This will be alive while...
 				Result = &Value;
 				Promise.Resume(); // ...await_resume moves from it here
 			}
@@ -227,7 +483,10 @@ public:
 			// Then has not and will not run, and Future is still valid
 			checkf(Future.IsValid(), TEXT("Internal error: future was consumed"));
 			Result = reinterpret_cast<decltype(Result)>(-1); // Mark as spent
-			return Future.Get();
+			if constexpr (std::is_lvalue_reference_v<T> || std::is_void_v<T>)
+				return Future.Get();
+			else
+				return Take(Future);
 		}
 		else
 		{
@@ -262,6 +521,7 @@ struct TDelegateAwaiterFor<R (T::*)(A...) const>
 	using type = std::conditional_t<TIsDynamicDelegate<T>,
 	                                TDynamicDelegateAwaiter<R, A...>,
 	                                TDelegateAwaiter<R, A...>>;
+	using view = TDelegateViewAwaiter<R, A...>;
 };
 
 template<typename P, typename T>
@@ -281,6 +541,7 @@ struct TAwaitTransform<P, T, std::enable_if_t<TIsDelegate<T>>>
 	}
 	using FExecutePtr = decltype(ExecutePtr(std::declval<T>()));
 	using FAwaiter = typename TDelegateAwaiterFor<FExecutePtr>::type;
+	using FViewAwaiter = typename TDelegateAwaiterFor<FExecutePtr>::view;
 
 	FAwaiter operator()(T& Delegate) { return FAwaiter(Delegate); }
 
@@ -303,6 +564,174 @@ public:
 	void Suspend(FPromise&);
 };
 
+class [[nodiscard]] UE5CORO_API FFrameWorkerAwaiter
+	: public TAwaiter<FFrameWorkerAwaiter>
+{
+public:
+	void Suspend(FPromise&);
+};
+
+class [[nodiscard]] UE5CORO_API FFrameJoinAwaiter
+	: public TAwaiter<FFrameJoinAwaiter>
+{
+public:
+	void Suspend(FPromise&);
+};
+
+class [[nodiscard]] UE5CORO_API FLongTaskAwaiter
+	: public TAwaiter<FLongTaskAwaiter>
+{
+	EThreadPriority Priority;
+	uint64 Affinity;
+
+public:
+	explicit FLongTaskAwaiter(EThreadPriority Priority, uint64 Affinity)
+		: Priority(Priority), Affinity(Affinity) { }
+
+	void Suspend(FPromise&);
+};
+
+class [[nodiscard]] UE5CORO_API FSharedFutureAwaiterBase
+{
+protected:
+	/** Blocks a long task pool thread in Wait(Future), then resumes the
+	 *  coroutine on the thread that it was suspended on. */
+	static void WaitAndResume(FPromise&, const void* Future,
+	                          void (*Wait)(const void*));
+};
+
+template<typename T>
+class [[nodiscard]] TSharedFutureAwaiter final
+	: public TAwaiter<TSharedFutureAwaiter<T>>, FSharedFutureAwaiterBase
+{
+	const TSharedFuture<T>& Future;
+
+public:
+	explicit TSharedFutureAwaiter(const TSharedFuture<T>& Future)
+		: Future(Future)
+	{
+		checkf(Future.IsValid(),
+		       TEXT("Awaiting invalid shared future will never resume"));
+	}
+
+	bool await_ready() { return Future.IsReady(); }
+
+	void Suspend(FPromise& Promise)
+	{
+		// TSharedFuture has no continuations, and its state only takes one
+		// callback, which would be overwritten by every other awaiter.
+		// Wait for it on a thread that's meant for blocking instead.
+		WaitAndResume(Promise, &Future, [](const void* Ptr)
+		{
+			static_cast<const TSharedFuture<T>*>(Ptr)->Wait();
+		});
+	}
+
+	decltype(auto) await_resume()
+	{
+		if constexpr (!std::is_void_v<T>)
+			return Future.Get(); // Reference into the shared state, no copy
+	}
+};
+
+template<typename P, typename T>
+struct TAwaitTransform<P, TSharedFuture<T>>
+{
+	// The result refers into the shared state, which has to stay alive
+	TSharedFutureAwaiter<T> operator()(const TSharedFuture<T>& Future)
+	{
+		return TSharedFutureAwaiter<T>(Future);
+	}
+
+	TSharedFutureAwaiter<T> operator()(TSharedFuture<T>&&) = delete;
+};
+
+template<typename P, typename T>
+struct TAwaitTransform<P, const TSharedFuture<T>>
+	: TAwaitTransform<P, TSharedFuture<T>>
+{
+};
+
+class [[nodiscard]] UE5CORO_API FParallelForAwaiter
+	: public TAwaiter<FParallelForAwaiter>
+{
+protected:
+	using FRunFn = void (*)(FParallelForAwaiter&, int32 Begin, int32 End);
+
+	const int32 Num;
+	const int32 MinBatchSize;
+	const FRunFn Run;
+	int32 BatchSize = 0;
+	std::atomic<int32> NextIndex = 0;
+	std::atomic<int32> NumWorking = 0;
+	FPromise* Promise = nullptr;
+	ENamedThreads::Type Thread = ENamedThreads::AnyThread;
+
+	explicit FParallelForAwaiter(int32 Num, int32 MinBatchSize, FRunFn Run)
+		: Num(Num), MinBatchSize(FMath::Max(1, MinBatchSize)), Run(Run) { }
+
+private:
+	void Work();
+
+public:
+	UE_NONCOPYABLE(FParallelForAwaiter);
+
+	bool await_ready() { return Num <= 0; }
+	void Suspend(FPromise&);
+};
+
+template<typename F>
+class [[nodiscard]] TParallelForAwaiter final : public FParallelForAwaiter
+{
+	F Body;
+
+	static void RunBatch(FParallelForAwaiter& This, int32 Begin, int32 End)
+	{
+		auto& Body = static_cast<TParallelForAwaiter&>(This).Body;
+		for (int32 i = Begin; i < End; ++i)
+			std::invoke(Body, i);
+	}
+
+public:
+	explicit TParallelForAwaiter(int32 Num, F Body, int32 MinBatchSize)
+		: FParallelForAwaiter(Num, MinBatchSize, &RunBatch)
+		, Body(std::move(Body)) { }
+};
+
+template<typename T, typename F>
+class [[nodiscard]] TParallelTransformAwaiter final
+	: public FParallelForAwaiter
+{
+	using U = std::decay_t<std::invoke_result_t<F&, const T&>>;
+	const T* Input;
+	F Fn;
+	TArray<U> Result;
+
+	static void RunBatch(FParallelForAwaiter& This, int32 Begin, int32 End)
+	{
+		auto& Self = static_cast<TParallelTransformAwaiter&>(This);
+		U* Out = Self.Result.GetData();
+		for (int32 i = Begin; i < End; ++i)
+			new (Out + i) U(std::invoke(Self.Fn, Self.Input[i]));
+	}
+
+public:
+	explicit TParallelTransformAwaiter(const T* Input, int32 Num, F Fn,
+	                                   int32 MinBatchSize)
+		: FParallelForAwaiter(Num, MinBatchSize, &RunBatch), Input(Input)
+		, Fn(std::move(Fn)) { }
+
+	template<typename P>
+	void await_suspend(stdcoro::coroutine_handle<P> Handle)
+	{
+		// Every element will be constructed by the time this resumes
+		Result.AddUninitialized(Num);
+		FParallelForAwaiter::await_suspend(Handle);
+	}
+
+	TArray<U> await_resume() { return std::move(Result); }
+};
+
 // Stores references as values. Structured bindings will give references.
 // Used with DYNAMIC delegates.
 // The memory layout has to match TBaseUFunctionDelegateInstance::Execute!
@@ -320,14 +749,51 @@ public:
 	TType<N>& get() { return this->Values.template Get<N>(); }
 };
 
+// References to a native delegate's parameters, without copying them.
+// Used with wide payloads of NATIVE delegates, the referenced parameters only
+// live until the coroutine suspends again.
+template<typename... T>
+class TPayloadView
+{
+	template<size_t N>
+	using TType = std::tuple_element_t<N, std::tuple<T...>>;
+
+	TTuple<std::add_lvalue_reference_t<T>...> Refs;
+
+	template<size_t... N>
+	TTuple<T...> Take(std::index_sequence<N...>)
+	{
+		return TTuple<T...>(std::forward<T>(Refs.template Get<N>())...);
+	}
+
+public:
+	explicit TPayloadView(std::add_lvalue_reference_t<T>... Args)
+		: Refs(Args...) { }
+
+	template<size_t N>
+	std::remove_reference_t<TType<N>>& get() { return Refs.template Get<N>(); }
+
+	/** Moves value parameters out, references are kept as references. */
+	TTuple<T...> Take() { return Take(std::index_sequence_for<T...>()); }
+};
+
 class [[nodiscard]] UE5CORO_API FDelegateAwaiter
 	: public TAwaiter<FDelegateAwaiter>
 {
 protected:
 	FPromise* Promise = nullptr;
-	std::function<void()> Cleanup;
+	// Unbinding is stored inline instead of as a std::function, the derived
+	// class picks what these values mean
+	void (*Cleanup)(FDelegateAwaiter&) = nullptr;
+	void* CleanupTarget = nullptr;
+	FDelegateHandle CleanupHandle;
+	// Lets pooled callback targets remove themselves from the delegate
+	void* CleanupDelegate = nullptr;
+	void (*Unbind)(void* Delegate, UObject* Target) = nullptr;
+
 	void TryResumeOnce();
-	UObject* SetupCallbackTarget(std::function<void(void*)>);
+	UObject* SetupCallbackTarget(TInlineFunction<void(void*)>, void* Delegate,
+	                             void (*Unbind)(void*, UObject*));
 
 public:
 	~FDelegateAwaiter();
@@ -338,23 +804,35 @@ template<typename R, typename... A>
 class [[nodiscard]] TDelegateAwaiter : public FDelegateAwaiter
 {
 	using ThisClass = TDelegateAwaiter;
-	using FResult = std::conditional_t<sizeof...(A) != 0, TTuple<A...>, void>;
-	TTuple<A...>* Result = nullptr;
+	using FResult = std::conditional_t<sizeof...(A) == 0, void, TTuple<A...>>;
+
+protected:
+	TPayloadView<A...>* Result = nullptr;
 
 public:
 	template<typename T>
 	explicit TDelegateAwaiter(T& Delegate)
 	{
 		static_assert(!TIsDynamicDelegate<T>);
+		CleanupTarget = &Delegate;
 		if constexpr (TIsMulticastDelegate<T>)
 		{
-			auto Handle = Delegate.AddRaw(this, &ThisClass::ResumeWith<A...>);
-			Cleanup = [Handle, &Delegate] { Delegate.Remove(Handle); };
+			CleanupHandle = Delegate.AddRaw(this,
+			                                &ThisClass::ResumeWith<A...>);
+			Cleanup = [](FDelegateAwaiter& Base)
+			{
+				auto& This = static_cast<ThisClass&>(Base);
+				static_cast<T*>(This.CleanupTarget)->Remove(This.CleanupHandle);
+			};
 		}
 		else
 		{
 			Delegate.BindRaw(this, &ThisClass::ResumeWith<A...>);
-			Cleanup = [&Delegate] { Delegate.Unbind(); };
+			Cleanup = [](FDelegateAwaiter& Base)
+			{
+				auto& This = static_cast<ThisClass&>(Base);
+				static_cast<T*>(This.CleanupTarget)->Unbind();
+			};
 		}
 	}
 	UE_NONCOPYABLE(TDelegateAwaiter);
@@ -362,8 +840,8 @@ public:
 	template<typename... T>
 	R ResumeWith(T... Args)
 	{
-		TTuple<T...> Values(std::forward<T>(Args)...);
-		Result = &Values; // This exposes a pointer to a local, but...
+		TPayloadView<T...> View(Args...);
+		Result = &View; // This exposes a pointer to a local, but...
 		TryResumeOnce(); // ...it's only read by await_resume, right here
 		// The coroutine might have completed, destroying this object
 		return R();
@@ -373,7 +851,26 @@ public:
 	{
 		checkf(Result, TEXT("Internal error: resumed without a result"));
 		if constexpr (sizeof...(A) != 0)
-			return std::move(*Result);
+			return Result->Take();
+	}
+};
+
+template<typename R, typename... A>
+class [[nodiscard]] TDelegateViewAwaiter final
+	: public TDelegateAwaiter<R, A...>
+{
+	using FResult = std::conditional_t<sizeof...(A) == 0, void,
+	                                   TPayloadView<A...>>;
+
+public:
+	using TDelegateAwaiter<R, A...>::TDelegateAwaiter;
+
+	/** The view is only valid until the next co_await. */
+	FResult await_resume()
+	{
+		checkf(this->Result, TEXT("Internal error: resumed without a result"));
+		if constexpr (sizeof...(A) != 0)
+			return *this->Result;
 	}
 };
 
@@ -400,7 +897,7 @@ public:
 			// The coroutine might have completed, deleting the awaiter
 			if constexpr (!std::is_void_v<R>)
 				static_cast<FPayload*>(Params)->template get<sizeof...(A)>() = R();
-		});
+		}, &InDelegate, &UnbindCallbackTarget<T>);
 
 		if constexpr (TIsMulticastDelegate<T>)
 		{
@@ -435,3 +932,41 @@ struct std::tuple_element<N, UE5Coro::Private::TDecayedPayload<T...>>
 {
 	using type = std::tuple_element_t<N, std::tuple<T...>>;
 };
+
+template<typename... T>
+struct std::tuple_size<UE5Coro::Private::TPayloadView<T...>>
+{
+	static constexpr size_t value = sizeof...(T);
+};
+
+template<size_t N, typename... T>
+struct std::tuple_element<N, UE5Coro::Private::TPayloadView<T...>>
+{
+	using type = std::tuple_element_t<N, std::tuple<T...>>;
+};
+
+template<typename F>
+UE5Coro::Private::TParallelForAwaiter<std::decay_t<F>>
+UE5Coro::Async::ParallelFor(int32 Num, F&& Body, int32 MinBatchSize)
+{
+	return Private::TParallelForAwaiter<std::decay_t<F>>(
+		Num, std::forward<F>(Body), MinBatchSize);
+}
+
+template<typename T>
+auto UE5Coro::Async::ViewPayload(T& Delegate)
+{
+	static_assert(!Private::TIsDynamicDelegate<T>,
+	              "Dynamic delegates are already awaited without copies");
+	using FTransform = Private::TAwaitTransform<Private::FAsyncPromise, T>;
+	return typename FTransform::FViewAwaiter(Delegate);
+}
+
+template<typename T, typename A, typename F>
+UE5Coro::Private::TParallelTransformAwaiter<T, std::decay_t<F>>
+UE5Coro::Async::ParallelTransform(const TArray<T, A>& Input, F&& Fn,
+                                  int32 MinBatchSize)
+{
+	return Private::TParallelTransformAwaiter<T, std::decay_t<F>>(
+		Input.GetData(), Input.Num(), std::forward<F>(Fn), MinBatchSize);
+}
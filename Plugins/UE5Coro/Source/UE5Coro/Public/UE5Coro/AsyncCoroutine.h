@@ -38,11 +38,24 @@
 
 #include "CoreMinimal.h"
 #include "UE5Coro/Definitions.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "UObject/WeakObjectPtr.h"
 #include <functional>
+#include <new>
 #define UE5CORO_PRIVATE_SUPPRESS_COROUTINE_INL
 #include "UE5Coro/Coroutine.h"
+#include "UE5Coro/CoroutineArena.h"
+#include "UE5Coro/FrameAllocator.h"
+#include "UE5Coro/InlineFunction.h"
 #include "UE5Coro/Private.h"
 
+class UWorld;
+
+namespace UE5Coro
+{
+class FScheduler;
+}
+
 namespace UE5Coro::Private
 {
 enum class ELatentExitReason : uint8;
@@ -52,6 +65,7 @@ class FLatentAwaiter;
 class FLatentPromise;
 class FPromise;
 class FPromiseExtras;
+struct FLazyPromiseBase;
 template<typename> class TFutureAwaiter;
 template<typename> class TTaskAwaiter;
 namespace Test { class FTestHelper; }
@@ -138,6 +152,38 @@ struct FFinalSuspend
 	void await_resume() noexcept { }
 };
 
+#if UE5CORO_PRIVATE_SYMMETRIC_TRANSFER
+/** Destroys the coroutine, then transfers to the coroutine that was
+ *  co_awaiting it, if there's one. */
+struct UE5CORO_API FAsyncFinalSuspend
+{
+	bool await_ready() noexcept { return false; }
+	stdcoro::coroutine_handle<> await_suspend(
+		stdcoro::coroutine_handle<> Handle) noexcept;
+	void await_resume() noexcept { }
+};
+#endif
+
+/** Lets an awaiter react to TCoroutine::Cancel while its coroutine is
+ *  suspended, instead of at the next resumption.<br>
+ *  The callback is called at most once per registration, on the canceling
+ *  thread, with the coroutine's lock held. It must not resume the coroutine
+ *  directly, or cancel the coroutine it was registered on. */
+struct FCancellationHook
+{
+	void (*Callback)(FCancellationHook&);
+	FCancellationHook* Prev = nullptr;
+	FCancellationHook* Next = nullptr;
+	bool bLinked = false; // Guarded by the coroutine's lock
+
+	explicit FCancellationHook(void (*Callback)(FCancellationHook&)) noexcept
+		: Callback(Callback) { }
+	UE_NONCOPYABLE(FCancellationHook);
+};
+
+/** Called with a pointer to the return value, or nullptr for void. */
+using FContinuation = TInlineFunction<void(void*)>;
+
 /** Fields of FPromise that may be alive after the coroutine is done. */
 class [[nodiscard]] UE5CORO_API FPromiseExtras
 {
@@ -146,11 +192,23 @@ public:
 	int DebugID = -1;
 	const TCHAR* DebugPromiseType = nullptr;
 	const TCHAR* DebugName = nullptr;
+	// Type of the most recent co_await's operand
+	const TCHAR* DebugAwaiterType = nullptr;
+	// FPlatformTime::Cycles64() of the current co_await's suspension and of
+	// its awaiter becoming ready, 0 if not measured. See UE5Coro.AwaitStats
+	// and UE5Coro.Record.
+	uint64 AwaitSuspendCycles = 0;
+	uint64 AwaitReadyCycles = 0;
 #endif
 
-	FEventRef Completed{EEventMode::ManualReset};
-	// This could be read from another thread
+	// These could be read from another thread
+	std::atomic<bool> bCompleted = false;
 	std::atomic<bool> bWasSuccessful = false;
+	// Only created if something blocks on the coroutine, guarded by Lock
+	FEvent* CompletedEvent = nullptr;
+	// The coroutine that's suspended in a co_await on this one, if any.
+	// This is the logical caller, see UE5Coro.DumpStacks.
+	std::atomic<FPromise*> AwaitedBy = nullptr;
 
 	FMutex Lock;
 	union
@@ -161,11 +219,24 @@ public:
 
 	explicit FPromiseExtras(FPromise& Promise) noexcept : Promise(&Promise) { }
 	UE_NONCOPYABLE(FPromiseExtras);
-	virtual ~FPromiseExtras() = default; // Virtual for warning suppression only
+	virtual ~FPromiseExtras(); // Virtual for warning suppression only
 
-	bool IsComplete() const;
+	bool IsComplete() const
+	{
+		return bCompleted.load(std::memory_order_acquire);
+	}
+	bool Wait(uint32 WaitTimeMilliseconds, bool bIgnoreThreadIdleStats);
+	/** Marks the coroutine as completed. Expects the lock to be held. */
+	void Complete();
 	template<typename T, typename F>
 	void ContinueWith(F Fn);
+	/** Calls Fn(nullptr) on Thread after completion, batched with other
+	 *  work going to the same thread if possible. */
+	void ContinueOn(ENamedThreads::Type Thread, FContinuation Fn);
+	/** Resumes the awaiting coroutine when this one completes, directly
+	 *  transferring to it if possible.
+	 *  @return false if this was already complete, and nothing happened. */
+	bool ResumeWhenComplete(FPromise& Awaiting);
 };
 
 template<typename T>
@@ -174,50 +245,220 @@ struct [[nodiscard]] TPromiseExtras final : FPromiseExtras
 #if UE5CORO_DEBUG
 	std::atomic<bool> bMoveUsed = false;
 #endif
-	T ReturnValue{};
+	bool bHasReturnValue = false;
+	// Constructed in place by co_return, or at completion without one
+	alignas(T) unsigned char ReturnValueStorage[sizeof(T)];
 
 	explicit TPromiseExtras(FPromise& Promise) noexcept
 		: FPromiseExtras(Promise) { }
+
+	virtual ~TPromiseExtras() override
+	{
+		if (bHasReturnValue)
+			ReturnValue().~T();
+	}
+
+	template<typename... A>
+	void EmplaceReturnValue(A&&... Args)
+	{
+		checkf(!bHasReturnValue, TEXT("Internal error: double co_return"));
+		new (&ReturnValueStorage) T(std::forward<A>(Args)...);
+		bHasReturnValue = true;
+	}
+
+	T& ReturnValue()
+	{
+		checkf(bHasReturnValue,
+		       TEXT("Coroutine completed without a return value, and T() is ")
+		       TEXT("not available"));
+		return *std::launder(reinterpret_cast<T*>(&ReturnValueStorage));
+	}
+
+	const T& ReturnValue() const
+	{
+		return const_cast<TPromiseExtras*>(this)->ReturnValue();
+	}
 };
 
+/** Creates the extras for the promise, in its frame's allocation if possible.
+ *  Coroutine heap allocation elision is not a concern: the promise escapes
+ *  in its constructor, and frames destroy themselves. */
+template<typename E>
+std::shared_ptr<FPromiseExtras> MakeExtras(FPromise& Promise, void* Frame)
+{
+	if (auto* Block = FExtrasCoAllocator::GetBlock(Frame))
+	{
+		auto* Extras = new (FExtrasCoAllocator::GetExtrasStorage(Block))
+			E(Promise);
+		return std::shared_ptr<FPromiseExtras>(
+			Extras, [](FPromiseExtras* Ptr) { Ptr->~FPromiseExtras(); },
+			FExtrasCoAllocator::TAllocator<FPromiseExtras>(Block));
+	}
+	LLM_SCOPE_BYTAG(UE5Coro_Extras);
+	return std::make_shared<E>(Promise);
+}
+
 class [[nodiscard]] UE5CORO_API FCancellationTracker
 {
 	std::atomic<bool> bCanceled = false;
 	std::atomic<int> CancellationHolds = 0;
+	// Shared by every coroutine in the same FCoroutineScope
+	std::atomic<const std::atomic<bool>*> ScopeCanceled = nullptr;
 
 public:
 	void Cancel() { bCanceled = true; }
+	void SetScopeFlag(const std::atomic<bool>* Flag) { ScopeCanceled = Flag; }
 	void Hold() { verify(++CancellationHolds >= 0); }
 	void Release() { verify(--CancellationHolds >= 0); }
 	bool ShouldCancel(bool bBypassHolds) const;
 };
 
 #if UE5CORO_DEBUG
-extern std::atomic<int> GLastDebugID;
+/** Set by UE5Coro.DebugMetadata. 0: IDs only, 1: also promise types and debug
+ *  names, 2: also the awaiter type of every co_await. */
+extern UE5CORO_API int GDebugMetadata;
+
+/** Extracts T from DebugTypeName<T>'s signature. The result is never freed. */
+UE5CORO_API const TCHAR* ParseDebugTypeName(const ANSICHAR* Signature);
+
+/** Returns a readable name for T, for debugging and profiling only. */
+template<typename T>
+const TCHAR* DebugTypeName()
+{
+#ifdef _MSC_VER
+	static const TCHAR* Name = ParseDebugTypeName(__FUNCSIG__);
+#else
+	static const TCHAR* Name = ParseDebugTypeName(__PRETTY_FUNCTION__);
 #endif
+	return Name;
+}
+
+/** Set by UE5Coro.AwaitStats. */
+extern UE5CORO_API bool GAwaitStatsEnabled;
+/** Set while UE5Coro.Record is recording. */
+extern UE5CORO_API bool GAwaitRecordEnabled;
+
+enum class EAwaitEvent : uint8
+{
+	Suspend,
+	Ready,
+	Resume,
+};
+
+/** Adds an event of the extras' coroutine to the UE5Coro.Record buffer. */
+UE5CORO_API void RecordAwaitEvent(const FPromiseExtras& Extras,
+                                  EAwaitEvent Event, uint64 Cycles);
+
+/** Adds the extras' current co_await to the calling thread's histograms and
+ *  the recording, then resets its timestamps. */
+UE5CORO_API void RecordAwaitStats(FPromiseExtras& Extras, uint64 ResumeCycles);
+#endif
+
+/** Prints an analysis of a file saved by UE5Coro.Record.Save.
+ *  @return false if the file could not be read. */
+UE5CORO_API bool AnalyzeAwaitRecording(const FString& Path, FOutputDevice& Ar);
 
 extern thread_local FPromise* GCurrentPromise;
+// Set while an async coroutine destroys itself at its final suspend point
+extern thread_local FPromise** GSymmetricTransfer;
+// FPlatformTime::Cycles64() when GCurrentPromise was last resumed
+extern thread_local uint64 GResumeCycles;
+
+/** Intrusive node of the FCoroutineScope that the promise is in, if any. */
+struct FScopeNode
+{
+	FCoroutineScopeState* Scope = nullptr;
+	FPromise* Prev = nullptr;
+	FPromise* Next = nullptr;
+};
+
+/** Intrusive node of FGameThreadInbox, Run(Target) is called once.<br>
+ *  FScheduler also links promises through it while they're in its shared
+ *  queue, a promise is only ever scheduled in one of them at a time. */
+struct FInboxNode
+{
+	FInboxNode* Next = nullptr;
+	void* Target = nullptr;
+	void (*Run)(void*) = nullptr;
+};
 
 class [[nodiscard]] UE5CORO_API FPromise
 {
 	friend void TCoroutine<>::SetDebugName(const TCHAR*);
+	friend class FCoroutineCensus;
+	friend class FCoroutineScopeState;
+	friend class FGameThreadInbox;
+	friend struct FLazyPromiseBase;
+	friend class UE5Coro::FScheduler;
 
 	FCancellationTracker CancellationTracker;
+	FScopeNode ScopeNode;
+	FInboxNode InboxNode;
+	FCoroutineArena Arena;
 
 protected:
 	std::shared_ptr<FPromiseExtras> Extras;
-	TArray<std::function<void(void*)>> OnCompleted;
+	// Most coroutines have at most one or two things waiting on them
+	TArray<FContinuation, TInlineAllocator<2>> OnCompleted;
+	// The first coroutine co_awaiting this one, resumed after OnCompleted
+	FPromise* AwaitingPromise = nullptr;
+	// Innermost TLazyCoroutine that suspended this, resumed instead of it
+	stdcoro::coroutine_handle<> LazyResume;
+	// Guarded by Extras->Lock
+	FCancellationHook* CancellationHooks = nullptr;
 #if !PLATFORM_EXCEPTIONS_DISABLED
 	std::atomic<bool> bUnhandledException = false;
 #endif
+	int8 ResumePriority = 0;
+	// ENamedThreads priority bits for resuming through the task graph
+	uint32 TaskPriority = 0;
+	bool bHasTaskPriority = false;
+	bool bExplicitTaskPriority = false;
+	// Minimum seconds between latent polls, from Latent::SetPollInterval
+	float PollInterval = 0;
+	// The world used by latent awaiters, from Latent::SetHomeWorld
+	FWeakObjectPtr HomeWorld;
+	// Between Async::MoveToFrameWorker and JoinAtFrameEnd
+	bool bInFrameWork = false;
+	// Registered in UE5Coro.Census, only changed by the owning promise
+	bool bInCensus = false;
 
 	explicit FPromise(std::shared_ptr<FPromiseExtras>, const TCHAR* PromiseType);
 	UE_NONCOPYABLE(FPromise);
 	virtual ~FPromise(); // Virtual for warning suppression only
 	virtual bool IsEarlyDestroy() const = 0;
 
+#if UE5CORO_DEBUG
+	void BeginAwait(const TCHAR* AwaiterType)
+	{
+		Extras->DebugAwaiterType = AwaiterType;
+		Extras->AwaitReadyCycles = 0;
+		// Both of these need the awaiter type
+		if (UNLIKELY(GAwaitStatsEnabled || GAwaitRecordEnabled) && AwaiterType)
+		{
+			Extras->AwaitSuspendCycles = FPlatformTime::Cycles64();
+			if (GAwaitRecordEnabled)
+				RecordAwaitEvent(*Extras, EAwaitEvent::Suspend,
+				                 Extras->AwaitSuspendCycles);
+		}
+		else
+			Extras->AwaitSuspendCycles = 0;
+	}
+#endif
+
 public:
+	// Coroutine frames are allocated through these
+	static void* operator new(size_t Size)
+	{
+		return FFrameAllocator::Allocate(Size);
+	}
+	static void operator delete(void* Ptr) noexcept
+	{
+		FFrameAllocator::Free(Ptr);
+	}
+
 	static FPromise& Current();
+	FCoroutineArena& GetArena() noexcept { return Arena; }
 
 	/** Request deletion now or very soon. */
 	virtual void ThreadSafeDestroy();
@@ -227,7 +468,66 @@ public:
 	void ReleaseCancellation();
 	virtual void Resume(bool bBypassCancellationHolds = false);
 	void ResumeFast();
-	void AddContinuation(std::function<void(void*)>);
+	void AddContinuation(FContinuation);
+	void AddAwaitingPromise(FPromise&);
+	/** @return false if this is already canceled, and the hook was not
+	 *  registered. Its callback is not called in this case. */
+	bool AddCancellationHook(FCancellationHook&);
+	/** Does nothing if the hook is not registered. */
+	void RemoveCancellationHook(FCancellationHook&);
+	/** Calls every registered hook if there's an active cancellation.
+	 *  Expects the lock to be held. */
+	void NotifyCanceled();
+	/** Notes that the current co_await's awaiter is ready, if it takes a
+	 *  while to actually resume this. Used by UE5Coro.AwaitStats/Record. */
+	void MarkAwaitReady()
+	{
+#if UE5CORO_DEBUG
+		if (UNLIKELY(Extras->AwaitSuspendCycles) && !Extras->AwaitReadyCycles)
+		{
+			Extras->AwaitReadyCycles = FPlatformTime::Cycles64();
+			if (GAwaitRecordEnabled)
+				RecordAwaitEvent(*Extras, EAwaitEvent::Ready,
+				                 Extras->AwaitReadyCycles);
+		}
+#endif
+	}
+	/** Called with GResumeCycles right before the coroutine resumes. */
+	void EndAwait(uint64 ResumeCycles)
+	{
+#if UE5CORO_DEBUG
+		if (UNLIKELY(Extras->AwaitSuspendCycles))
+			RecordAwaitStats(*Extras, ResumeCycles);
+#endif
+	}
+	/** Returns what resuming this coroutine continues in: its own handle, or
+	 *  that of a TLazyCoroutine that it's running, which suspended it. */
+	stdcoro::coroutine_handle<> TakeResumeHandle() noexcept
+	{
+		if (auto Lazy = std::exchange(LazyResume, nullptr))
+			return Lazy;
+		return stdcoro::coroutine_handle<FPromise>::from_promise(*this);
+	}
+	/** Called when symmetric transfer continues in this coroutine, bypassing
+	 *  Resume(). Traces the rest of the current resume as this coroutine's. */
+	void TraceTransferredResume();
+	int8 GetResumePriority() const { return ResumePriority; }
+	void SetResumePriority(int8 Priority) { ResumePriority = Priority; }
+	float GetPollInterval() const { return PollInterval; }
+	void SetPollInterval(float Seconds) { PollInterval = Seconds; }
+	/** Returns the coroutine's home world, nullptr if it has none yet. */
+	UWorld* GetHomeWorld() const;
+	void SetHomeWorld(UWorld* World);
+	bool IsInFrameWork() const { return bInFrameWork; }
+	void SetInFrameWork(bool bValue) { bInFrameWork = bValue; }
+	/** Replaces the priority bits of Thread with this coroutine's, if it has
+	 *  any from Async::SetTaskPriority or an earlier MoveToThread. */
+	ENamedThreads::Type WithTaskPriority(ENamedThreads::Type Thread) const;
+	/** Overrides the priority of every future resume through the task graph.
+	 *  Only the thread and task priority bits of Priority are used. */
+	void SetTaskPriority(ENamedThreads::Type Priority);
+	/** Adopts the priority of Thread, unless one was explicitly set. */
+	void InheritTaskPriority(ENamedThreads::Type Thread);
 
 	void unhandled_exception();
 
@@ -251,11 +551,19 @@ public:
 		return {FInitialSuspend::Resume};
 	}
 
+#if UE5CORO_PRIVATE_SYMMETRIC_TRANSFER
+	FAsyncFinalSuspend final_suspend() noexcept { return {}; }
+#else
 	stdcoro::suspend_never final_suspend() noexcept { return {}; }
+#endif
 
 	template<typename T>
 	decltype(auto) await_transform(T&& Awaitable)
 	{
+#if UE5CORO_DEBUG
+		BeginAwait(LIKELY(GDebugMetadata >= 2)
+		           ? DebugTypeName<std::decay_t<T>>() : nullptr);
+#endif
 		TAwaitTransform<FAsyncPromise, std::remove_reference_t<T>> Transform;
 		return Transform(std::forward<T>(Awaitable));
 	}
@@ -307,6 +615,10 @@ public:
 	template<typename T>
 	decltype(auto) await_transform(T&& Awaitable)
 	{
+#if UE5CORO_DEBUG
+		BeginAwait(LIKELY(GDebugMetadata >= 2)
+		           ? DebugTypeName<std::decay_t<T>>() : nullptr);
+#endif
 		TAwaitTransform<FLatentPromise, std::remove_reference_t<T>> Transform;
 		return Transform(std::forward<T>(Awaitable));
 	}
@@ -318,29 +630,64 @@ class TCoroutinePromise : public Base
 public:
 	template<typename... A>
 	explicit TCoroutinePromise(A&&... Args)
-		: Base(std::make_shared<TPromiseExtras<T>>(*this),
+		: Base(MakeExtras<TPromiseExtras<T>>(*this, FrameOf(*this)),
 		       std::forward<A>(Args)...) { }
 	UE_NONCOPYABLE(TCoroutinePromise);
 
+	static void* operator new(size_t Size)
+	{
+		return FExtrasCoAllocator::AllocateFrame(
+			Size, sizeof(TPromiseExtras<T>), alignof(TPromiseExtras<T>));
+	}
+	static void operator delete(void* Ptr) noexcept
+	{
+		FExtrasCoAllocator::FreeFrame(Ptr);
+	}
+
 	~TCoroutinePromise()
 	{
 		auto* ExtrasT = static_cast<TPromiseExtras<T>*>(this->Extras.get());
 		ExtrasT->Lock.lock(); // This will be held until the end of ~FPromise
 		checkf(ExtrasT->Promise, TEXT("Unexpected double promise destruction"));
-		ExtrasT->ReturnValuePtr = &ExtrasT->ReturnValue;
+		// Coroutines that didn't co_return (e.g., canceled ones) result in T()
+		if constexpr (std::is_default_constructible_v<T>)
+			if (!ExtrasT->bHasReturnValue)
+				ExtrasT->EmplaceReturnValue();
+		ExtrasT->ReturnValuePtr = ExtrasT->bHasReturnValue
+			                          ? &ExtrasT->ReturnValueStorage : nullptr;
+	}
+
+	// co_return {...}
+	void return_value(T&& Value) { Emplace(std::move(Value)); }
+
+	// Everything else that co_return T could implicitly convert is
+	// constructed directly into place
+	template<typename U, typename = std::enable_if_t<
+		std::is_convertible_v<U&&, T> &&
+		(!std::is_same_v<std::decay_t<U>, T> || std::is_lvalue_reference_v<U>)>>
+	void return_value(U&& Value) { Emplace(std::forward<U>(Value)); }
+
+	TCoroutine<T> get_return_object() noexcept
+	{
+		return TCoroutine<T>(this->Extras);
 	}
 
-	void return_value(T Value)
+private:
+	template<typename U>
+	void Emplace(U&& Value)
 	{
+		static_assert(std::is_convertible_v<U&&, T>,
+		              "Explicit conversions are not allowed by co_return");
 		auto* ExtrasT = static_cast<TPromiseExtras<T>*>(this->Extras.get());
 		std::scoped_lock _(ExtrasT->Lock);
 		check(!ExtrasT->IsComplete()); // Completion is after a value is returned
-		ExtrasT->ReturnValue = std::move(Value);
+		ExtrasT->EmplaceReturnValue(std::forward<U>(Value));
 	}
 
-	TCoroutine<T> get_return_object() noexcept
+	static void* FrameOf(TCoroutinePromise& Promise)
 	{
-		return TCoroutine<T>(this->Extras);
+		return stdcoro::coroutine_handle<TCoroutinePromise>::from_promise(Promise)
+		       .address();
 	}
 };
 
@@ -350,10 +697,20 @@ class TCoroutinePromise<void, Base> : public Base
 public:
 	template<typename... A>
 	explicit TCoroutinePromise(A&&... Args)
-		: Base(std::make_shared<FPromiseExtras>(*this), std::forward<A>(Args)...)
-	{ }
+		: Base(MakeExtras<FPromiseExtras>(*this, FrameOf(*this)),
+		       std::forward<A>(Args)...) { }
 	UE_NONCOPYABLE(TCoroutinePromise);
 
+	static void* operator new(size_t Size)
+	{
+		return FExtrasCoAllocator::AllocateFrame(
+			Size, sizeof(FPromiseExtras), alignof(FPromiseExtras));
+	}
+	static void operator delete(void* Ptr) noexcept
+	{
+		FExtrasCoAllocator::FreeFrame(Ptr);
+	}
+
 	~TCoroutinePromise()
 	{
 		// This will be held until the end of ~FPromise
@@ -369,6 +726,13 @@ public:
 	{
 		return TCoroutine<>(this->Extras);
 	}
+
+private:
+	static void* FrameOf(TCoroutinePromise& Promise)
+	{
+		return stdcoro::coroutine_handle<TCoroutinePromise>::from_promise(Promise)
+		       .address();
+	}
 };
 
 template<typename T, typename F>
@@ -381,7 +745,7 @@ void FPromiseExtras::ContinueWith(F Fn)
 		if constexpr (std::is_void_v<T>)
 			Fn();
 		else // T is controlled by TCoroutine<T>, safe to cast
-			Fn(static_cast<const TPromiseExtras<T>*>(this)->ReturnValue);
+			Fn(static_cast<const TPromiseExtras<T>*>(this)->ReturnValue());
 		return;
 	}
 
@@ -392,7 +756,11 @@ void FPromiseExtras::ContinueWith(F Fn)
 		if constexpr (std::is_void_v<T>)
 			Fn();
 		else
+		{
+			checkf(Data, TEXT("Coroutine completed without a return value, ")
+			             TEXT("and T() is not available"));
 			Fn(*static_cast<const T*>(Data));
+		}
 	});
 }
 
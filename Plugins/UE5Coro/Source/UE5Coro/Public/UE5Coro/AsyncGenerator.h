@@ -0,0 +1,262 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UE5Coro/Definitions.h"
+#include <functional>
+#include "Async/TaskGraphInterfaces.h"
+#include "UE5Coro/AsyncCoroutine.h"
+#include "UE5Coro/Private.h"
+
+namespace UE5Coro
+{
+template<typename> class TAsyncGeneratorSink;
+namespace Private
+{
+template<typename> class TAsyncGeneratorNextAwaiter;
+template<typename> class TAsyncGeneratorState;
+template<typename> class TAsyncGeneratorYieldAwaiter;
+}
+
+/**
+ * Asynchronous generator. Values are produced by a separate TCoroutine that
+ * may co_await anything, and consumed one at a time with co_await Next().<br>
+ * The producer is allowed to run ahead of the consumer by the prefetch count
+ * provided at construction, after which it's suspended until there's room.<br>
+ * Destroying the generator cancels the producer.
+ */
+template<typename T>
+class [[nodiscard]] TAsyncGenerator
+{
+	std::shared_ptr<Private::TAsyncGeneratorState<T>> State;
+	TCoroutine<> Producer;
+
+public:
+	/** Starts the producer, a callable taking TAsyncGeneratorSink<T> and
+	 *  returning TCoroutine<>. Like every other coroutine, it runs
+	 *  synchronously until its first suspension. */
+	template<typename F>
+	explicit TAsyncGenerator(F&& Fn, int32 Prefetch = 1);
+	TAsyncGenerator(TAsyncGenerator&& Other) noexcept
+		: State(std::move(Other.State)), Producer(Other.Producer) { }
+	TAsyncGenerator(const TAsyncGenerator&) = delete;
+	TAsyncGenerator& operator=(const TAsyncGenerator&) = delete;
+	TAsyncGenerator& operator=(TAsyncGenerator&&) = delete;
+	~TAsyncGenerator();
+
+	/** co_await the return value of this function to retrieve the next value,
+	 *  or an empty TOptional if the producer has finished.<br>
+	 *  There may only be one co_await on Next() in progress at a time. */
+	Private::TAsyncGeneratorNextAwaiter<T> Next();
+
+	/** Returns the producer coroutine, e.g., to check if it was successful. */
+	const TCoroutine<>& GetProducer() const noexcept { return Producer; }
+};
+
+/** Passed to the producer of a TAsyncGenerator to provide values through. */
+template<typename T>
+class TAsyncGeneratorSink
+{
+	friend TAsyncGenerator<T>;
+	std::shared_ptr<Private::TAsyncGeneratorState<T>> State;
+
+	explicit TAsyncGeneratorSink(
+		std::shared_ptr<Private::TAsyncGeneratorState<T>> State) noexcept
+		: State(std::move(State)) { }
+
+public:
+	/** co_await the return value of this function to provide the next value
+	 *  to the consumer. Suspends while the prefetch buffer is full. */
+	Private::TAsyncGeneratorYieldAwaiter<T> Yield(T Value);
+
+	/** Returns true if the generator is gone, and nothing else will be
+	 *  consumed. The producer is canceled when this happens. */
+	bool IsClosed() const;
+};
+}
+
+namespace UE5Coro::Private
+{
+class [[nodiscard]] UE5CORO_API FAsyncGeneratorState
+{
+protected:
+	FMutex Lock;
+	const int32 Capacity;
+	int32 Num = 0; // Buffered values
+	FPromise* Consumer = nullptr;
+	FPromise* Producer = nullptr;
+	ENamedThreads::Type ConsumerThread = ENamedThreads::AnyThread;
+	ENamedThreads::Type ProducerThread = ENamedThreads::AnyThread;
+	bool bFinished = false; // The producer completed
+	bool bClosed = false; // The generator was destroyed
+	// end Lock
+
+	explicit FAsyncGeneratorState(int32 Capacity);
+	/** Expects the lock to be held, and releases it. */
+	void ResumeConsumer(std::unique_lock<FMutex>&);
+	/** Expects the lock to be held, and releases it. */
+	void ResumeProducer(std::unique_lock<FMutex>&);
+	static void Resume(FPromise*, ENamedThreads::Type);
+
+public:
+	UE_NONCOPYABLE(FAsyncGeneratorState);
+	void Finish();
+	void Close();
+	bool IsClosed();
+
+	/** If this returns false, the lock is held for SuspendConsumer. */
+	bool TryReadyConsumer();
+	void SuspendConsumer(FPromise&);
+	/** If this returns false, the lock is held for SuspendProducer. */
+	bool TryReadyProducer(TFunctionRef<void()> Push);
+	void SuspendProducer(FPromise&);
+	void ResumedProducer(TFunctionRef<void()> Push);
+};
+
+template<typename T>
+class TAsyncGeneratorState final : public FAsyncGeneratorState
+{
+	TArray<TOptional<T>> Ring;
+	int32 Head = 0;
+
+public:
+	explicit TAsyncGeneratorState(int32 Capacity)
+		: FAsyncGeneratorState(Capacity)
+	{
+		Ring.SetNum(this->Capacity);
+	}
+
+	/** Called by the producer with the lock held, when there's room. */
+	void Push(T& Value)
+	{
+		checkf(Num < Capacity, TEXT("Internal error: generator overflow"));
+		Ring[(Head + Num++) % Capacity].Emplace(std::move(Value));
+	}
+
+	TOptional<T> Pop()
+	{
+		std::unique_lock L(Lock);
+		if (Num == 0)
+			return {};
+		TOptional<T> Value(std::move(*Ring[Head]));
+		Ring[Head].Reset();
+		Head = (Head + 1) % Capacity;
+		--Num;
+		ResumeProducer(L);
+		return Value;
+	}
+};
+
+template<typename T>
+class [[nodiscard]] TAsyncGeneratorNextAwaiter
+	: public TAwaiter<TAsyncGeneratorNextAwaiter<T>>
+{
+	std::shared_ptr<TAsyncGeneratorState<T>> State;
+
+public:
+	explicit TAsyncGeneratorNextAwaiter(
+		std::shared_ptr<TAsyncGeneratorState<T>> State) noexcept
+		: State(std::move(State)) { }
+
+	bool await_ready() { return State->TryReadyConsumer(); }
+	void Suspend(FPromise& Promise) { State->SuspendConsumer(Promise); }
+	TOptional<T> await_resume() { return State->Pop(); }
+};
+
+template<typename T>
+class [[nodiscard]] TAsyncGeneratorYieldAwaiter
+	: public TAwaiter<TAsyncGeneratorYieldAwaiter<T>>
+{
+	std::shared_ptr<TAsyncGeneratorState<T>> State;
+	T Value;
+	bool bPushed = false;
+
+public:
+	explicit TAsyncGeneratorYieldAwaiter(
+		std::shared_ptr<TAsyncGeneratorState<T>> State, T&& Value)
+		: State(std::move(State)), Value(std::move(Value)) { }
+
+	bool await_ready()
+	{
+		return bPushed = State->TryReadyProducer([&] { State->Push(Value); });
+	}
+
+	void Suspend(FPromise& Promise) { State->SuspendProducer(Promise); }
+
+	void await_resume()
+	{
+		if (!bPushed)
+			State->ResumedProducer([&] { State->Push(Value); });
+	}
+};
+}
+
+template<typename T>
+template<typename F>
+UE5Coro::TAsyncGenerator<T>::TAsyncGenerator(F&& Fn, int32 Prefetch)
+	: State(std::make_shared<Private::TAsyncGeneratorState<T>>(Prefetch))
+	, Producer(std::invoke(std::forward<F>(Fn), TAsyncGeneratorSink<T>(State)))
+{
+	Producer.ContinueWith([State = State] { State->Finish(); });
+}
+
+template<typename T>
+UE5Coro::TAsyncGenerator<T>::~TAsyncGenerator()
+{
+	if (!State) // Moved from
+		return;
+	// The producer will see the cancellation when it resumes in Close()
+	Producer.Cancel();
+	State->Close();
+}
+
+template<typename T>
+UE5Coro::Private::TAsyncGeneratorNextAwaiter<T>
+UE5Coro::TAsyncGenerator<T>::Next()
+{
+	checkf(State, TEXT("Attempting to use a moved-from generator"));
+	return Private::TAsyncGeneratorNextAwaiter<T>(State);
+}
+
+template<typename T>
+UE5Coro::Private::TAsyncGeneratorYieldAwaiter<T>
+UE5Coro::TAsyncGeneratorSink<T>::Yield(T Value)
+{
+	return Private::TAsyncGeneratorYieldAwaiter<T>(State, std::move(Value));
+}
+
+template<typename T>
+bool UE5Coro::TAsyncGeneratorSink<T>::IsClosed() const
+{
+	return State->IsClosed();
+}
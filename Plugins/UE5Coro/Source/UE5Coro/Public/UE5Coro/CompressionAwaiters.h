@@ -0,0 +1,104 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UE5Coro/Definitions.h"
+#include "Misc/Compression.h"
+#include "UE5Coro/AsyncAwaiters.h"
+
+namespace UE5Coro::Private
+{
+class FCompressionAwaiter;
+}
+
+namespace UE5Coro::Async
+{
+/** One independently (de)compressed block of data. */
+struct FCompressionChunk
+{
+	/** The bytes to compress or decompress. */
+	TArrayView<const uint8> Input;
+	/** Preallocated memory for the result. When decompressing, this needs to
+	 *  be exactly the uncompressed size. When compressing, this should be at
+	 *  least FCompression::CompressMemoryBound bytes. */
+	TArrayView<uint8> Output;
+	/** Set to the number of bytes written to Output. */
+	int32 OutputSize = 0;
+	/** Set to true if this chunk was processed successfully. */
+	bool bSucceeded = false;
+};
+
+/** Decompresses every chunk in parallel on worker threads, and resumes the
+ *  coroutine once all of them are done.<br>
+ *  The chunks, and the memory that they refer to, must remain valid until
+ *  the co_await is done.<br>
+ *  The result of the co_await expression is true if every chunk succeeded,
+ *  the results of individual chunks are stored in the chunks. */
+UE5CORO_API Private::FCompressionAwaiter DecompressChunks(
+	FName Format, TArrayView<FCompressionChunk> Chunks,
+	ECompressionFlags Flags = COMPRESS_NoFlags);
+
+/** Compresses every chunk in parallel on worker threads, and resumes the
+ *  coroutine once all of them are done.<br>
+ *  The chunks, and the memory that they refer to, must remain valid until
+ *  the co_await is done.<br>
+ *  The result of the co_await expression is true if every chunk succeeded,
+ *  the results of individual chunks are stored in the chunks. */
+UE5CORO_API Private::FCompressionAwaiter CompressChunks(
+	FName Format, TArrayView<FCompressionChunk> Chunks,
+	ECompressionFlags Flags = COMPRESS_NoFlags);
+}
+
+namespace UE5Coro::Private
+{
+/** Async::ParallelFor over the chunks, with a batch function that doesn't
+ *  need to be a template. */
+class [[nodiscard]] UE5CORO_API FCompressionAwaiter final
+	: public FParallelForAwaiter
+{
+	const bool bCompress;
+	const FName Format;
+	const TArrayView<Async::FCompressionChunk> Chunks;
+	const ECompressionFlags Flags;
+	std::atomic<bool> bAllSucceeded = true;
+
+	static void RunBatch(FParallelForAwaiter&, int32 Begin, int32 End);
+
+public:
+	explicit FCompressionAwaiter(bool bCompress, FName Format,
+	                             TArrayView<Async::FCompressionChunk> Chunks,
+	                             ECompressionFlags Flags);
+
+	bool await_resume();
+};
+}
@@ -33,6 +33,7 @@
 
 #include "CoreMinimal.h"
 #include "UE5Coro/Definitions.h"
+#include "Async/TaskGraphInterfaces.h"
 #if UE5CORO_CPP20
 #include <compare>
 #include <concepts>
@@ -59,9 +60,14 @@ class TCoroutine;
 template<>
 class UE5CORO_API TCoroutine<>
 {
+	template<typename>
+	friend class Private::TAsyncCoroutineAwaiter;
+	template<typename>
+	friend class Private::TLatentCoroutineAwaiter;
 	template<typename, typename>
 	friend class Private::TCoroutinePromise;
 	friend std::hash<TCoroutine<>>;
+	friend Private::FCoroutineScopeState;
 
 protected:
 	std::shared_ptr<Private::FPromiseExtras> Extras;
@@ -91,6 +97,14 @@ public:
 	bool Wait(uint32 WaitTimeMilliseconds = MAX_uint32,
 	          bool bIgnoreThreadIdleStats = false) const;
 
+	/** Blocks until the coroutine completes for any reason, like Wait, but
+	 *  keeps processing task graph work on the calling thread in the meantime,
+	 *  the same way FTaskGraphInterface::WaitUntilTaskCompletes does.<br>
+	 *  This lets named threads such as the game thread wait for coroutines
+	 *  that need to run on them. Tasks that run this way might reenter the
+	 *  caller. */
+	void WaitAndHelp() const;
+
 	/** Returns true if the coroutine has ended for any reason, including normal
 	 *  completion, cancellation, or an unhandled exception. */
 	[[nodiscard]] bool IsDone() const;
@@ -108,6 +122,15 @@ public:
 	auto ContinueWith(F Continuation)
 		-> std::enable_if_t<std::is_invocable_v<F>>;
 
+	/** Calls the provided functor on the given thread when this coroutine is
+	 *  complete, including unsuccessful completions such as being canceled.<br>
+	 *  The functor is always queued, even if the coroutine is already
+	 *  complete. Continuations going to the game thread are delivered in
+	 *  batches, together with coroutines resuming there. */
+	template<typename F>
+	auto ContinueWithOn(ENamedThreads::Type Thread, F Continuation)
+		-> std::enable_if_t<std::is_invocable_v<F>>;
+
 	/** Like ContinueWith, but the provided functor will only be called if the
 	 *  object is still alive at the time of coroutine completion.<br>
 	 *  The first parameter may be UObject*, TSharedPtr, or std::shared_ptr. */
@@ -167,6 +190,16 @@ public:
 	auto ContinueWith(F Continuation)
 		-> std::enable_if_t<std::is_invocable_v<F> || std::is_invocable_v<F, T>>;
 
+	/** Calls the provided functor with this coroutine's result on the given
+	 *  thread when it's complete, including unsuccessful completions such as
+	 *  being canceled.<br>
+	 *  The functor is always queued, even if the coroutine is already
+	 *  complete. Continuations going to the game thread are delivered in
+	 *  batches, together with coroutines resuming there. */
+	template<typename F>
+	auto ContinueWithOn(ENamedThreads::Type Thread, F Continuation)
+		-> std::enable_if_t<std::is_invocable_v<F> || std::is_invocable_v<F, T>>;
+
 	/** Like ContinueWith, but the provided functor will only be called if the
 	 *  object is still alive at the time of coroutine completion.<br>
 	 *  The first parameter may be UObject*, TSharedPtr, or std::shared_ptr. */
@@ -53,7 +53,7 @@ const T& TCoroutine<T>::GetResult() const
 {
 	Wait();
 	auto* ExtrasT = static_cast<Private::TPromiseExtras<T>*>(Extras.get());
-	return ExtrasT->ReturnValue;
+	return ExtrasT->ReturnValue();
 }
 
 template<typename T>
@@ -66,7 +66,7 @@ T&& TCoroutine<T>::MoveResult()
 	ensureMsgf(ExtrasT->bMoveUsed.compare_exchange_strong(bOld, true),
 	           TEXT("MoveResult called multiple times on the same value"));
 #endif
-	return std::move(ExtrasT->ReturnValue);
+	return std::move(ExtrasT->ReturnValue());
 }
 
 template<typename F>
@@ -76,6 +76,16 @@ auto TCoroutine<>::ContinueWith(F Continuation)
 	Extras->ContinueWith<void>(std::move(Continuation));
 }
 
+template<typename F>
+auto TCoroutine<>::ContinueWithOn(ENamedThreads::Type Thread, F Continuation)
+	-> std::enable_if_t<std::is_invocable_v<F>>
+{
+	Extras->ContinueOn(Thread, [Fn = std::move(Continuation)](void*) mutable
+	{
+		Fn();
+	});
+}
+
 template<typename U, typename F>
 auto TCoroutine<>::ContinueWithWeak(U Ptr, F Continuation)
 	-> std::enable_if_t<Private::TWeak<U>::value && std::is_invocable_v<F>>
@@ -115,6 +125,21 @@ auto TCoroutine<T>::ContinueWith(F Continuation)
 		Extras->ContinueWith<T>(std::move(Continuation));
 }
 
+template<typename T>
+template<typename F>
+auto TCoroutine<T>::ContinueWithOn(ENamedThreads::Type Thread, F Continuation)
+	-> std::enable_if_t<std::is_invocable_v<F> || std::is_invocable_v<F, T>>
+{
+	if constexpr (!std::is_invocable_v<F, T>)
+		TCoroutine<>::ContinueWithOn(Thread, std::move(Continuation));
+	else // The copy keeps the result alive until Fn runs on Thread
+		TCoroutine<>::ContinueWithOn(Thread,
+			[Coro = *this, Fn = std::move(Continuation)]() mutable
+			{
+				Fn(Coro.GetResult());
+			});
+}
+
 template<typename T>
 template<typename U, typename F>
 auto TCoroutine<T>::ContinueWithWeak(U Ptr, F Continuation)
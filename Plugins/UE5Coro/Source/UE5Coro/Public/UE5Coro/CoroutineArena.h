@@ -0,0 +1,159 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UE5Coro/Definitions.h"
+
+namespace UE5Coro
+{
+/** Bump allocator for scratch memory that's owned by a single coroutine.<br>
+ *  Everything allocated from it is released at once when the coroutine
+ *  completes. Memory blocks are recycled through the pool that's used for
+ *  coroutine frames.<br>
+ *  Arenas are not thread safe, but they don't need to be: only the owning
+ *  coroutine is supposed to access its own arena.
+ *  @see FCoroutineArenaAllocator */
+class [[nodiscard]] UE5CORO_API FCoroutineArena final
+{
+	struct FBlock;
+	FBlock* Head = nullptr;
+
+	void* AllocateSlow(size_t Size);
+
+public:
+	FCoroutineArena() noexcept = default;
+	UE_NONCOPYABLE(FCoroutineArena);
+	~FCoroutineArena() { Reset(); }
+
+	/** Returns the arena of the calling coroutine. */
+	static FCoroutineArena& Current();
+
+	/** Returns uninitialized memory that's valid until the next Reset. */
+	void* Allocate(size_t Size, size_t Alignment = alignof(std::max_align_t));
+
+	/** Grows or shrinks the allocation in place if it was the last one,
+	 *  otherwise, copies the first OldSize or NewSize bytes, whichever is
+	 *  smaller, into a new allocation. */
+	void* Reallocate(void* Ptr, size_t OldSize, size_t NewSize,
+	                 size_t Alignment = alignof(std::max_align_t));
+
+	/** Reclaims the memory immediately if it was the last allocation.
+	 *  Other allocations are only released by Reset. */
+	void Free(void* Ptr, size_t Size) noexcept;
+
+	/** Releases every allocation. */
+	void Reset() noexcept;
+};
+
+/** TArray allocator policy that uses the arena of the coroutine that created
+ *  the container.<br>
+ *  Containers using this must not outlive or leave their coroutine, e.g., by
+ *  being co_returned. */
+class UE5CORO_API FCoroutineArenaAllocator
+{
+public:
+	using SizeType = int32;
+
+	enum { NeedsElementType = false };
+	enum { RequireRangeCheck = true };
+
+	class UE5CORO_API ForAnyElementType
+	{
+		FCoroutineArena* Arena;
+		FScriptContainerElement* Data = nullptr;
+		SIZE_T NumBytes = 0;
+
+	public:
+		ForAnyElementType();
+		UE_NONCOPYABLE(ForAnyElementType);
+		~ForAnyElementType();
+
+		void MoveToEmpty(ForAnyElementType& Other);
+
+		FScriptContainerElement* GetAllocation() const { return Data; }
+
+		void ResizeAllocation(SizeType CurrentNum, SizeType NewMax,
+		                      SIZE_T NumBytesPerElement);
+
+		SizeType CalculateSlackReserve(SizeType NewMax,
+		                               SIZE_T NumBytesPerElement) const
+		{
+			return DefaultCalculateSlackReserve(NewMax, NumBytesPerElement,
+			                                    false);
+		}
+
+		SizeType CalculateSlackShrink(SizeType NewMax, SizeType CurrentMax,
+		                              SIZE_T NumBytesPerElement) const
+		{
+			return DefaultCalculateSlackShrink(NewMax, CurrentMax,
+			                                   NumBytesPerElement, false);
+		}
+
+		SizeType CalculateSlackGrow(SizeType NewMax, SizeType CurrentMax,
+		                            SIZE_T NumBytesPerElement) const
+		{
+			return DefaultCalculateSlackGrow(NewMax, CurrentMax,
+			                                 NumBytesPerElement, false);
+		}
+
+		SIZE_T GetAllocatedSize(SizeType CurrentMax,
+		                        SIZE_T NumBytesPerElement) const
+		{
+			return CurrentMax * NumBytesPerElement;
+		}
+
+		bool HasAllocation() const { return Data != nullptr; }
+
+		SizeType GetInitialCapacity() const { return 0; }
+	};
+
+	template<typename ElementType>
+	class ForElementType : public ForAnyElementType
+	{
+	public:
+		ElementType* GetAllocation() const
+		{
+			return reinterpret_cast<ElementType*>(
+				ForAnyElementType::GetAllocation());
+		}
+	};
+};
+}
+
+template<>
+struct TAllocatorTraits<UE5Coro::FCoroutineArenaAllocator>
+	: TAllocatorTraitsBase<UE5Coro::FCoroutineArenaAllocator>
+{
+	enum { SupportsMove = true };
+	enum { IsZeroConstruct = false };
+};
@@ -40,23 +40,88 @@
 
 namespace UE5Coro::Private
 {
+/** Records the awaiting coroutine as the logical caller of the awaited one
+ *  while it's suspended on it, for debuggers and UE5Coro.DumpStacks. */
+class [[nodiscard]] FAwaitedByLink final
+{
+	FPromiseExtras* Awaited = nullptr;
+	FPromise* Awaiting = nullptr;
+
+public:
+	FAwaitedByLink() = default;
+	FAwaitedByLink(FAwaitedByLink&& Other) noexcept
+		: Awaited(std::exchange(Other.Awaited, nullptr)),
+		  Awaiting(std::exchange(Other.Awaiting, nullptr)) { }
+	~FAwaitedByLink() { Reset(); }
+
+	void Set(FPromiseExtras& Extras, FPromise& Promise)
+	{
+		Awaited = &Extras;
+		Awaiting = &Promise;
+		// If there are multiple awaiters, the first one is the caller
+		FPromise* Expected = nullptr;
+		Extras.AwaitedBy.compare_exchange_strong(Expected, &Promise,
+		                                         std::memory_order_release);
+	}
+
+	void Reset()
+	{
+		if (!Awaited)
+			return;
+		FPromise* Expected = Awaiting;
+		Awaited->AwaitedBy.compare_exchange_strong(Expected, nullptr,
+		                                           std::memory_order_release);
+		Awaited = nullptr;
+	}
+};
+
 template<typename T>
-class TAsyncCoroutineAwaiter : public TAwaiter<TAsyncCoroutineAwaiter<T>>
+class TAsyncCoroutineAwaiter : public TAwaiter<TAsyncCoroutineAwaiter<T>>,
+                               private FCancellationHook
 {
 	TCoroutine<T> Antecedent;
+	FPromise* Awaiting = nullptr;
+	bool bResumed = false;
+	FAwaitedByLink Caller; // Destroyed before Antecedent
+
+	// Canceling the awaiting coroutine cancels the awaited one, too
+	static void OnCanceled(FCancellationHook& Hook)
+	{
+		static_cast<TAsyncCoroutineAwaiter&>(Hook).Antecedent.Cancel();
+	}
 
 public:
 	explicit TAsyncCoroutineAwaiter(TCoroutine<T> Antecedent)
-		: Antecedent(std::move(Antecedent)) { }
+		: FCancellationHook(&OnCanceled), Antecedent(std::move(Antecedent)) { }
+	UE_NONCOPYABLE(TAsyncCoroutineAwaiter);
+
+	~TAsyncCoroutineAwaiter()
+	{
+		if (!Awaiting)
+			return;
+		Awaiting->RemoveCancellationHook(*this);
+		// The awaiting coroutine is being destroyed while suspended
+		if (UNLIKELY(!bResumed))
+			Antecedent.Cancel();
+	}
+
+	bool await_ready() { return Antecedent.IsDone(); }
 
 	void Suspend(FPromise& Promise)
 	{
-		Antecedent.ContinueWith([&Promise] { Promise.Resume(); });
+		Awaiting = &Promise;
+		Caller.Set(*Antecedent.Extras, Promise);
+		if (!Promise.AddCancellationHook(*this))
+			Antecedent.Cancel();
+		if (!Antecedent.Extras->ResumeWhenComplete(Promise))
+			Promise.Resume(); // Completed since await_ready
 	}
 
 	T await_resume()
 	{
 		checkf(Antecedent.IsDone(), TEXT("Internal error: resuming too early"));
+		bResumed = true;
+		Caller.Reset();
 		if constexpr (!std::is_void_v<T>)
 			return Antecedent.GetResult();
 	}
@@ -68,7 +133,7 @@ bool ShouldResumeLatentCoroutine(void* State, bool bCleanup)
 	auto* This = static_cast<TCoroutine<T>*>(State);
 	if (UNLIKELY(bCleanup))
 	{
-		delete This;
+		FLatentAwaiter::DestroyState<TCoroutine<T>>(State);
 		return false;
 	}
 	return This->IsDone();
@@ -77,10 +142,21 @@ bool ShouldResumeLatentCoroutine(void* State, bool bCleanup)
 template<typename T>
 class TLatentCoroutineAwaiter : public FLatentAwaiter
 {
+	FAwaitedByLink Caller; // Destroyed before State
+
 public:
 	explicit TLatentCoroutineAwaiter(TCoroutine<T> Antecedent)
-		: FLatentAwaiter(new TCoroutine<T>(std::move(Antecedent)),
-		                 &ShouldResumeLatentCoroutine<T>) { }
+		: FLatentAwaiter(std::in_place_type<TCoroutine<T>>,
+		                 &ShouldResumeLatentCoroutine<T>,
+		                 std::move(Antecedent)) { }
+
+	template<typename P>
+	void await_suspend(stdcoro::coroutine_handle<P> Handle)
+	{
+		auto* Coro = static_cast<TCoroutine<T>*>(State);
+		Caller.Set(*Coro->Extras, Handle.promise());
+		FLatentAwaiter::await_suspend(Handle);
+	}
 
 	// Prevent surprises with `co_await SomeCoroutine();` by making a copy.
 	// This cannot be moved as there could be another TCoroutine still owning it
@@ -88,6 +164,7 @@ public:
 	{
 		auto* Coro = static_cast<TCoroutine<T>*>(State);
 		checkf(Coro->IsDone(), TEXT("Internal error: resuming too early"));
+		Caller.Reset();
 		return Coro->GetResult();
 	}
 };
@@ -95,10 +172,23 @@ public:
 template<>
 class TLatentCoroutineAwaiter<void> : public FLatentAwaiter
 {
+	FAwaitedByLink Caller; // Destroyed before State
+
 public:
 	explicit TLatentCoroutineAwaiter(TCoroutine<> Antecedent)
-		: FLatentAwaiter(new TCoroutine(std::move(Antecedent)),
-		                 &ShouldResumeLatentCoroutine<void>) { }
+		: FLatentAwaiter(std::in_place_type<TCoroutine<>>,
+		                 &ShouldResumeLatentCoroutine<void>,
+		                 std::move(Antecedent)) { }
+
+	template<typename P>
+	void await_suspend(stdcoro::coroutine_handle<P> Handle)
+	{
+		auto* Coro = static_cast<TCoroutine<>*>(State);
+		Caller.Set(*Coro->Extras, Handle.promise());
+		FLatentAwaiter::await_suspend(Handle);
+	}
+
+	void await_resume() noexcept { Caller.Reset(); }
 };
 
 template<typename T>
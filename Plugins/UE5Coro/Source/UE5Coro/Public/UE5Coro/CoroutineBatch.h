@@ -0,0 +1,193 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UE5Coro/Definitions.h"
+#include <functional>
+#include "UE5Coro/AsyncCoroutine.h"
+#include "UE5Coro/Private.h"
+
+namespace UE5Coro::Private
+{
+class FBatchAwaiter;
+class FBatchFramesAwaiter;
+class FBatchSecondsAwaiter;
+class FBatchUntilAwaiter;
+}
+
+namespace UE5Coro
+{
+/**
+ * Advances large numbers of coroutines together, from a system that updates
+ * them in bulk, e.g., a Mass processor.<br>
+ * Coroutines co_await the batch's own awaiters instead of latent or async ones.
+ * Waits of the same kind are kept together in contiguous arrays, which Tick
+ * checks in one sweep each. There are no latent actions, timers, or callback
+ * objects involved per coroutine.<br>
+ * The batch has its own clock and frame counter, advanced by Tick.
+ * Coroutines are resumed on the thread calling Tick, which may be any thread.
+ * Awaiting the batch is thread safe, Tick itself is not reentrant.
+ */
+class UE5CORO_API FCoroutineBatch final
+{
+	friend Private::FBatchAwaiter;
+	friend Private::FBatchFramesAwaiter;
+	friend Private::FBatchSecondsAwaiter;
+	friend Private::FBatchUntilAwaiter;
+
+	mutable Private::FMutex Lock;
+	int64 FrameCounter = 0;
+	double Time = 0;
+	// Keys and awaiters at the same index belong together
+	TArray<int64> FrameTargets;
+	TArray<Private::FBatchAwaiter*> FrameAwaiters;
+	TArray<double> Deadlines;
+	TArray<Private::FBatchAwaiter*> DeadlineAwaiters;
+	TArray<Private::FBatchUntilAwaiter*> UntilAwaiters;
+	// Removed from the arrays above by cancellation, resumed by the next Tick
+	TArray<Private::FBatchAwaiter*> Canceled;
+	// Tick only, kept to reuse its allocation
+	TArray<Private::FBatchAwaiter*> Ready;
+
+public:
+	FCoroutineBatch() = default;
+	UE_NONCOPYABLE(FCoroutineBatch);
+
+	/** Cancels every coroutine that's still waiting on this batch, and resumes
+	 *  them on the calling thread to process their cancellations. */
+	~FCoroutineBatch();
+
+	/** Advances the batch's clock by DeltaSeconds and its frame counter by one,
+	 *  then resumes every coroutine that's done waiting.<br>
+	 *  Coroutines awaiting again while they're being resumed will wait for the
+	 *  next Tick at the earliest. */
+	void Tick(double DeltaSeconds);
+
+	/** Number of coroutines currently waiting on this batch. */
+	[[nodiscard]] int32 GetNumWaiting() const;
+
+	/** Number of times Tick has been called. */
+	[[nodiscard]] int64 GetFrameCounter() const;
+
+	/** Sum of the DeltaSeconds that were passed to Tick. */
+	[[nodiscard]] double GetTime() const;
+
+	/** Resumes the awaiting coroutine after the given number of Ticks.<br>
+	 *  Every wait takes at least one Tick. */
+	[[nodiscard]] Private::FBatchFramesAwaiter Frames(int32 Num);
+
+	/** Resumes the awaiting coroutine on the first Tick that advances the
+	 *  batch's clock by at least the given number of seconds.<br>
+	 *  Every wait takes at least one Tick. */
+	[[nodiscard]] Private::FBatchSecondsAwaiter Seconds(double Seconds);
+
+	/** Resumes the awaiting coroutine on the first Tick where the predicate
+	 *  returns true.<br>
+	 *  Predicates are evaluated by Tick with the batch locked. They must not
+	 *  use the batch itself, and should be cheap. */
+	[[nodiscard]] Private::FBatchUntilAwaiter Until(
+		std::function<bool()> Predicate);
+
+private:
+	void Remove(Private::FBatchAwaiter&);
+};
+}
+
+namespace UE5Coro::Private
+{
+class [[nodiscard]] UE5CORO_API FBatchAwaiter
+	: public TAwaiter<FBatchAwaiter>, private FCancellationHook
+{
+	friend FCoroutineBatch;
+
+protected:
+	FCoroutineBatch& Batch;
+	FPromise* Promise = nullptr;
+	// Guarded by the batch's lock
+	bool bAdded = false;
+	bool bCanceledEarly = false;
+
+	explicit FBatchAwaiter(FCoroutineBatch& Batch)
+		: FCancellationHook(&OnCanceled), Batch(Batch) { }
+	UE_NONCOPYABLE(FBatchAwaiter);
+
+	/** Called with the batch locked. */
+	virtual void Add() = 0;
+
+public:
+	virtual ~FBatchAwaiter() = default;
+	void Suspend(FPromise&);
+
+private:
+	static void OnCanceled(FCancellationHook&);
+	void ResumeFromBatch();
+};
+
+class [[nodiscard]] UE5CORO_API FBatchFramesAwaiter final : public FBatchAwaiter
+{
+	friend FCoroutineBatch;
+	int32 Num;
+
+	FBatchFramesAwaiter(FCoroutineBatch& Batch, int32 Num)
+		: FBatchAwaiter(Batch), Num(Num) { }
+
+protected:
+	virtual void Add() override;
+};
+
+class [[nodiscard]] UE5CORO_API FBatchSecondsAwaiter final
+	: public FBatchAwaiter
+{
+	friend FCoroutineBatch;
+	double Seconds;
+
+	FBatchSecondsAwaiter(FCoroutineBatch& Batch, double Seconds)
+		: FBatchAwaiter(Batch), Seconds(Seconds) { }
+
+protected:
+	virtual void Add() override;
+};
+
+class [[nodiscard]] UE5CORO_API FBatchUntilAwaiter final : public FBatchAwaiter
+{
+	friend FCoroutineBatch;
+	std::function<bool()> Predicate;
+
+	FBatchUntilAwaiter(FCoroutineBatch& Batch, std::function<bool()> Predicate)
+		: FBatchAwaiter(Batch), Predicate(std::move(Predicate)) { }
+
+protected:
+	virtual void Add() override;
+};
+}
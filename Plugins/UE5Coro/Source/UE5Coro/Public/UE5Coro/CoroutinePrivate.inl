@@ -35,7 +35,10 @@
 
 namespace UE5Coro::Private
 {
+class FCoroutineScopeState;
 class FPromiseExtras;
+template<typename> class TAsyncCoroutineAwaiter;
+template<typename> class TLatentCoroutineAwaiter;
 template<typename, typename> class TCoroutinePromise;
 
 // Transforms T to its weak pointer version
@@ -0,0 +1,105 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UE5Coro/Definitions.h"
+#include "UE5Coro/AsyncCoroutine.h"
+
+namespace UE5Coro
+{
+namespace Private
+{
+class FCoroutineScopeState;
+class FScopeJoinAwaiter;
+}
+
+/** Groups coroutines, so that they can be canceled and co_awaited together.
+ *  <br>The scope does not store handles to its coroutines: each one links
+ *  itself into the scope when it's added, and unlinks itself when it
+ *  completes. CancelAll sets a single flag that every coroutine in the scope
+ *  checks along with its own cancellation, then wakes the ones that are
+ *  waiting on something that can be canceled early, such as timers.<br>
+ *  Destroying the scope cancels every coroutine that's still in it.<br>
+ *  This object is thread safe. */
+class [[nodiscard]] UE5CORO_API FCoroutineScope final
+{
+	Private::FCoroutineScopeState* State;
+
+public:
+	FCoroutineScope();
+	UE_NONCOPYABLE(FCoroutineScope);
+	~FCoroutineScope();
+
+	/** Adds the coroutine to this scope. Coroutines that have already
+	 *  completed are ignored.<br>
+	 *  A coroutine may be in at most one scope. Adding a coroutine to a scope
+	 *  that has been canceled cancels the coroutine. */
+	void Add(const TCoroutine<>& Coroutine);
+
+	/** Cancels every coroutine in this scope, including ones that will be
+	 *  added later. This cannot be undone. */
+	void CancelAll();
+
+	/** @return True if CancelAll was called. */
+	[[nodiscard]] bool IsCanceled() const;
+
+	/** @return The number of coroutines in the scope that have not completed
+	 *  yet. This might be outdated by the time it's returned. */
+	[[nodiscard]] int32 Num() const;
+
+	/** co_awaiting the return value resumes the awaiting coroutine once every
+	 *  coroutine in the scope has completed, on the thread where the last one
+	 *  finished. If the scope is empty, the co_await continues immediately.
+	 *  <br>The return value is not affected by coroutines that are added after
+	 *  it has resumed, but it is reusable. */
+	Private::FScopeJoinAwaiter Join();
+};
+}
+
+namespace UE5Coro::Private
+{
+class [[nodiscard]] UE5CORO_API FScopeJoinAwaiter
+	: public TAwaiter<FScopeJoinAwaiter>
+{
+	FCoroutineScopeState* State;
+
+public:
+	explicit FScopeJoinAwaiter(FCoroutineScopeState* State);
+	FScopeJoinAwaiter(const FScopeJoinAwaiter&);
+	FScopeJoinAwaiter& operator=(const FScopeJoinAwaiter&) = delete;
+	~FScopeJoinAwaiter();
+
+	bool await_ready();
+	void Suspend(FPromise&);
+};
+}
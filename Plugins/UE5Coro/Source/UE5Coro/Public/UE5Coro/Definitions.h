@@ -54,10 +54,21 @@ namespace UE5Coro::Private
 #error UE5Coro requires C++20 or the Coroutines TS for C++17.
 #endif
 
+// noop_coroutine is needed to not transfer anywhere
+#if defined(__cpp_lib_coroutine) || defined(_LIBCPP_VERSION)
+#define UE5CORO_PRIVATE_SYMMETRIC_TRANSFER 1
+#else
+#define UE5CORO_PRIVATE_SYMMETRIC_TRANSFER 0
+#endif
+
 #ifndef UE5CORO_DEBUG
 #define UE5CORO_DEBUG (UE_BUILD_DEBUG || UE_BUILD_DEVELOPMENT)
 #endif
 
+#ifndef UE5CORO_FRAME_POOL
+#define UE5CORO_FRAME_POOL 1
+#endif
+
 #if defined(_LIBCPP_VERSION) && _LIBCPP_VERSION < 16000
 #define UE5CORO_PRIVATE_LIBCPP_IS_BROKEN 1
 #else
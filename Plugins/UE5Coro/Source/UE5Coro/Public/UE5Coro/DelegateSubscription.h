@@ -0,0 +1,167 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UE5Coro/Definitions.h"
+#include "UE5Coro/Private.h"
+#include "UE5Coro/Threading.h"
+
+namespace UE5Coro
+{
+/** What a delegate subscription does with a payload when its buffer is full. */
+enum class ESubscriptionOverflow : uint8
+{
+	/** Discards the oldest buffered payload to make room for the new one. */
+	DropOldest,
+	/** Discards the new payload, keeping the ones that are already buffered. */
+	DropNewest,
+};
+
+template<typename...>
+class TDelegateSubscription;
+
+namespace Private
+{
+template<typename>
+struct TDelegateSubscriptionFor;
+template<typename T, typename... A>
+struct TDelegateSubscriptionFor<void (T::*)(A...) const>
+{
+	using type = TDelegateSubscription<A...>;
+};
+}
+
+/**
+ * Subscribes to a native multicast delegate, binding to it only once.<br>
+ * Every Broadcast is copied into a buffer of the given capacity, which is
+ * co_awaited one payload at a time through the subscription's Next().
+ * Broadcasts that happen while the coroutine is busy are not lost, unless the
+ * buffer overflows.<br>
+ * The delegate must outlive the returned subscription, or be unsubscribed.
+ */
+template<typename T>
+[[nodiscard]] auto Subscribe(T& Delegate, int Capacity = 16,
+                             ESubscriptionOverflow Overflow =
+                                 ESubscriptionOverflow::DropOldest)
+{
+	static_assert(Private::TIsMulticastDelegate<T> &&
+	              !Private::TIsDynamicDelegate<T>,
+	              "Only native multicast delegates are supported");
+	using FSubscription = typename Private::TDelegateSubscriptionFor<
+		decltype(&T::Broadcast)>::type;
+	return FSubscription(Delegate, Capacity, Overflow);
+}
+
+/**
+ * Persistent subscription to a native multicast delegate.<br>
+ * Use UE5Coro::Subscribe to create one.
+ */
+template<typename... A>
+class TDelegateSubscription final
+{
+public:
+	/** Copies of a single Broadcast's parameters. */
+	using FPayload = TTuple<std::decay_t<A>...>;
+
+private:
+	TChannel<FPayload> Channel;
+	ESubscriptionOverflow Overflow;
+	std::atomic<int> NumDropped = 0;
+	void* Delegate = nullptr;
+	FDelegateHandle Handle;
+	void (*Remove)(void*, FDelegateHandle) = nullptr;
+
+public:
+	/** Use UE5Coro::Subscribe instead of calling this directly. */
+	template<typename T>
+	explicit TDelegateSubscription(T& InDelegate, int Capacity,
+	                               ESubscriptionOverflow Overflow)
+		: Channel(Capacity), Overflow(Overflow), Delegate(&InDelegate)
+	{
+		Handle = InDelegate.AddRaw(this, &TDelegateSubscription::OnBroadcast);
+		Remove = [](void* Target, FDelegateHandle InHandle)
+		{
+			static_cast<T*>(Target)->Remove(InHandle);
+		};
+	}
+	UE_NONCOPYABLE(TDelegateSubscription);
+
+	~TDelegateSubscription() { Unsubscribe(); }
+
+	/** co_await the return value to receive the next buffered payload.<br>
+	 *  The result of the co_await expression is a TOptional<FPayload>, which
+	 *  is only unset after Unsubscribe() once the buffer ran out. */
+	[[nodiscard]] auto Next() { return Channel.Receive(); }
+
+	/** Takes the next buffered payload, if there is one. */
+	[[nodiscard]] TOptional<FPayload> TryNext()
+	{
+		return Channel.TryReceive();
+	}
+
+	/** Unbinds from the delegate. Payloads that were already buffered can
+	 *  still be received, after which Next() results in nothing.<br>
+	 *  This must not race with the delegate being broadcast. */
+	void Unsubscribe()
+	{
+		if (!Remove)
+			return;
+		std::exchange(Remove, nullptr)(Delegate, Handle);
+		Channel.Close();
+	}
+
+	/** @return true until Unsubscribe() is called. */
+	[[nodiscard]] bool IsSubscribed() const { return Remove != nullptr; }
+
+	/** @return The number of payloads discarded because of overflow. */
+	[[nodiscard]] int GetNumDropped() const { return NumDropped.load(); }
+
+private:
+	void OnBroadcast(A... Args)
+	{
+		FPayload Payload(Args...);
+		if (Overflow == ESubscriptionOverflow::DropNewest)
+		{
+			if (!Channel.TrySend(std::move(Payload)))
+				++NumDropped;
+			return;
+		}
+
+		// A failed TrySend would consume a moved payload, keep a copy until
+		// there's room for it
+		while (!Channel.TrySend(Payload) && !Channel.IsClosed())
+			if (Channel.TryReceive())
+				++NumDropped;
+	}
+};
+}
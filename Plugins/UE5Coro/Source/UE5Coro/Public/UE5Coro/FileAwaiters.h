@@ -0,0 +1,150 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UE5Coro/Definitions.h"
+#include "Async/AsyncFileHandle.h"
+#include "Async/MappedFileHandle.h"
+#include "UE5Coro/AsyncCoroutine.h"
+#include "UE5Coro/AsyncGenerator.h"
+
+namespace UE5Coro::Private
+{
+class FMapFileAwaiter;
+class FReadFileAwaiter;
+struct FAsyncReadFile;
+struct FMapFileState;
+}
+
+namespace UE5Coro::Async
+{
+/** Reads Size bytes of the file starting at Offset without blocking a thread,
+ *  and resumes the coroutine after it's done.<br>
+ *  A negative Size reads until the end of the file, and reads extending past
+ *  the end of the file are shortened to fit.<br>
+ *  The result of the co_await expression is the data read, or an empty
+ *  TOptional if the file could not be read. The platform reads directly into
+ *  the returned array, there are no intermediate copies. */
+UE5CORO_API Private::FReadFileAwaiter ReadFileAsync(
+	FString Path, int64 Offset = 0, int64 Size = -1,
+	EAsyncIOPriorityAndFlags Priority = AIOP_Normal);
+
+/** Reads the file in consecutive chunks of ChunkSize bytes, yielding them in
+ *  order. The last chunk may be smaller.<br>
+ *  Up to ReadAhead reads are kept in flight while the consumer is processing
+ *  earlier chunks, in addition to those buffered by the generator itself.<br>
+ *  The generator finishes early if the file could not be read. */
+UE5CORO_API TAsyncGenerator<TArray64<uint8>> ReadFileChunks(
+	FString Path, int64 ChunkSize = 1 << 20, int32 ReadAhead = 2,
+	EAsyncIOPriorityAndFlags Priority = AIOP_Normal);
+
+/** Read-only memory mapping of a part of a file. See MapFileAsync.<br>
+ *  The mapping is released when this object is destroyed. */
+class [[nodiscard]] UE5CORO_API FMappedFileRegion
+{
+	friend Private::FMapFileState;
+	TUniquePtr<IMappedFileHandle> Handle;
+	TUniquePtr<IMappedFileRegion> Region; // Released before Handle
+
+	explicit FMappedFileRegion(TUniquePtr<IMappedFileHandle> Handle,
+	                           TUniquePtr<IMappedFileRegion> Region);
+
+public:
+	FMappedFileRegion() = default;
+	FMappedFileRegion(FMappedFileRegion&&) = default;
+	FMappedFileRegion& operator=(FMappedFileRegion&&);
+	FMappedFileRegion(const FMappedFileRegion&) = delete;
+	FMappedFileRegion& operator=(const FMappedFileRegion&) = delete;
+	~FMappedFileRegion();
+
+	/** Releases the mapping early. */
+	void Reset();
+
+	/** Returns true if this object holds a mapping. */
+	bool IsValid() const noexcept { return Region.IsValid(); }
+
+	/** Returns the mapped bytes, or an empty view if there's no mapping.
+	 *  <br>The view is only valid while this object holds the mapping. */
+	TArrayView64<const uint8> GetView() const;
+};
+
+/** Memory maps Size bytes of the file starting at Offset on a background
+ *  thread, and resumes the coroutine after it's done.<br>
+ *  A negative Size maps until the end of the file, and ranges extending past
+ *  the end of the file are shortened to fit.<br>
+ *  If bPrefault is true, every mapped page is touched before resuming, so
+ *  that accessing the data does not page fault on the calling thread.<br>
+ *  The result of the co_await expression is a FMappedFileRegion, which is not
+ *  valid if the file could not be mapped, or the range was empty. */
+UE5CORO_API Private::FMapFileAwaiter MapFileAsync(FString Path,
+                                                  int64 Offset = 0,
+                                                  int64 Size = -1,
+                                                  bool bPrefault = true);
+}
+
+namespace UE5Coro::Private
+{
+class [[nodiscard]] UE5CORO_API FReadFileAwaiter
+	: public TAwaiter<FReadFileAwaiter>
+{
+	struct FState;
+	TUniquePtr<FState> State;
+
+public:
+	explicit FReadFileAwaiter(TSharedRef<FAsyncReadFile> File, int64 Offset,
+	                          int64 Size, EAsyncIOPriorityAndFlags Priority);
+	FReadFileAwaiter(FReadFileAwaiter&&) noexcept;
+	FReadFileAwaiter(const FReadFileAwaiter&) = delete;
+	FReadFileAwaiter& operator=(const FReadFileAwaiter&) = delete;
+	/** Cancels the read if it's still in progress, and waits for it. */
+	~FReadFileAwaiter();
+
+	bool await_ready();
+	void Suspend(FPromise&);
+	TOptional<TArray64<uint8>> await_resume();
+};
+
+class [[nodiscard]] UE5CORO_API FMapFileAwaiter
+	: public TAwaiter<FMapFileAwaiter>
+{
+	TSharedPtr<FMapFileState> State;
+
+public:
+	explicit FMapFileAwaiter(FString&& Path, int64 Offset, int64 Size,
+	                         bool bPrefault);
+
+	bool await_ready();
+	void Suspend(FPromise&);
+	Async::FMappedFileRegion await_resume();
+};
+}
@@ -0,0 +1,148 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+/******************************************************************************
+ *          This file only contains private implementation details.           *
+ ******************************************************************************/
+
+#include "CoreMinimal.h"
+#include "UE5Coro/Definitions.h"
+#include "HAL/LowLevelMemTracker.h"
+
+// LLM tags for memory owned by coroutines, visible in stat LLM and memreports
+LLM_DECLARE_TAG_API(UE5Coro, UE5CORO_API);
+/** Frames, including co-allocated extras. */
+LLM_DECLARE_TAG_API(UE5Coro_Frames, UE5CORO_API);
+/** Extras that did not fit into their frame's allocation. */
+LLM_DECLARE_TAG_API(UE5Coro_Extras, UE5CORO_API);
+/** Latent actions owning latent coroutines. */
+LLM_DECLARE_TAG_API(UE5Coro_LatentActions, UE5CORO_API);
+/** State shared between awaiters and their callbacks or latent actions. */
+LLM_DECLARE_TAG_API(UE5Coro_AwaiterState, UE5CORO_API);
+
+namespace UE5Coro::Private
+{
+/** Pooled allocator for coroutine frames.<br>
+ *  Frames are sorted into size classes and recycled through thread-local free
+ *  lists. Frames freed on a thread other than the one that allocated them are
+ *  returned to their original thread through a lock-free queue. */
+class [[nodiscard]] UE5CORO_API FFrameAllocator final
+{
+public:
+	struct FStats
+	{
+		/** Number of frames that were allocated through the pool. */
+		uint64 Allocations = 0;
+		/** Number of allocations that were served from a free list. */
+		uint64 PoolHits = 0;
+		/** Bytes currently obtained from FMemory, including cached frames. */
+		int64 BytesReserved = 0;
+		/** Highest value that BytesReserved has reached. */
+		int64 PeakBytesReserved = 0;
+
+		double HitRate() const
+		{
+			return Allocations ? static_cast<double>(PoolHits) / Allocations
+			                   : 0.0;
+		}
+	};
+
+	static void* Allocate(size_t Size);
+	static void Free(void* Ptr) noexcept;
+
+	/** Releases the calling thread's cached frames back to FMemory. */
+	static void Trim();
+
+	/** Returns a snapshot of the pool's statistics across all threads.<br>
+	 *  This locks the pool's thread registry and is intended for diagnostics,
+	 *  not for hot paths. */
+	static FStats GetStats();
+};
+
+/** Places a TCoroutine's extras in the same allocation as its frame.<br>
+ *  The allocation is released when both the frame and every handle referring
+ *  to the extras are gone. */
+class [[nodiscard]] UE5CORO_API FExtrasCoAllocator final
+{
+public:
+	struct FBlock;
+
+	/** Room reserved for std::shared_ptr's control block. */
+	static constexpr size_t ControlBlockSize = 64;
+
+	static void* AllocateFrame(size_t FrameSize, size_t ExtrasSize,
+	                           size_t ExtrasAlignment);
+	static void FreeFrame(void* Frame) noexcept;
+	/** nullptr if the frame did not have room for its extras. */
+	static FBlock* GetBlock(void* Frame);
+	static void* GetExtrasStorage(FBlock*);
+	static void* GetControlBlockStorage(FBlock*);
+	static void AddRef(FBlock*);
+	static void Release(FBlock*) noexcept;
+
+	/** Hands out the control block storage of a single FBlock. */
+	template<typename T>
+	struct TAllocator
+	{
+		using value_type = T;
+		FBlock* Block;
+
+		explicit TAllocator(FBlock* Block) noexcept : Block(Block) { }
+		template<typename U>
+		TAllocator(const TAllocator<U>& Other) noexcept : Block(Other.Block) { }
+
+		T* allocate(size_t Num)
+		{
+			static_assert(alignof(T) <= 16);
+			checkf(Num * sizeof(T) <= ControlBlockSize,
+			       TEXT("Internal error: control block does not fit"));
+			AddRef(Block);
+			return static_cast<T*>(GetControlBlockStorage(Block));
+		}
+
+		void deallocate(T*, size_t) noexcept { Release(Block); }
+
+		template<typename U>
+		bool operator==(const TAllocator<U>& Other) const noexcept
+		{
+			return Block == Other.Block;
+		}
+
+		template<typename U>
+		bool operator!=(const TAllocator<U>& Other) const noexcept
+		{
+			return Block != Other.Block;
+		}
+	};
+};
+}
@@ -33,17 +33,29 @@
 
 #include "CoreMinimal.h"
 #include "UE5Coro/Definitions.h"
+#include <memory>
+#include <new>
+#include "UE5Coro/FrameAllocator.h"
 
 namespace UE5Coro
 {
 template<typename> class TGeneratorIterator;
-namespace Private { template<typename> class TGeneratorPromise; }
+template<typename> class TGeneratorRange;
+template<typename, int32> class TChunkedGeneratorIterator;
+namespace Private
+{
+template<typename> class TGeneratorPromise;
+template<typename, int32> class TChunkedGeneratorPromise;
+}
 
 /**
  * Generator coroutine. Make a function return Generator<T> instead of T and
  * it will be able to co_yield multiple values throughout its execution.
  * Callers can either manually fetch values or use the provided iterator
- * wrappers to treat the returned values as a virtual container.
+ * wrappers to treat the returned values as a virtual container.<br>
+ * Frames are pooled, or if the coroutine's parameters start with
+ * std::allocator_arg followed by a standard allocator, they're allocated from
+ * a copy of that allocator instead.
  */
 template<typename T>
 struct [[nodiscard]] TGenerator
@@ -51,6 +63,7 @@ struct [[nodiscard]] TGenerator
 	using promise_type = Private::TGeneratorPromise<T>;
 	using iterator = TGeneratorIterator<T>;
 	friend promise_type;
+	friend iterator;
 
 private:
 	Private::stdcoro::coroutine_handle<promise_type> Handle;
@@ -94,6 +107,34 @@ public:
 	iterator CreateIterator() noexcept { return iterator(*this); }
 	iterator begin() noexcept { return iterator(*this); }
 	iterator end() const noexcept { return iterator(nullptr); }
+
+	// Lazy views of the remaining values. These don't add coroutines, every
+	// value is processed in the loop that consumes the view.
+	// Views of rvalue generators own them, other views refer to the generator,
+	// which must outlive them. See TGeneratorRange for more.
+
+	auto View() &;
+	auto View() &&;
+	/** Transforms every value with Fn. */
+	template<typename F> auto Map(F&& Fn) &;
+	template<typename F> auto Map(F&& Fn) &&;
+	/** Skips values that don't satisfy Pred. */
+	template<typename F> auto Filter(F&& Pred) &;
+	template<typename F> auto Filter(F&& Pred) &&;
+	/** Ends after Num values, without resuming the generator for more. */
+	auto Take(int32 Num) &;
+	auto Take(int32 Num) &&;
+	/** Groups the values into TArrayViews of up to Size values. */
+	auto Chunk(int32 Size) &;
+	auto Chunk(int32 Size) &&;
+	/** Pairs the values with another generator's or view's into TTuples,
+	 *  ending with the shorter one. */
+	template<typename U> auto Zip(U&& Other) &;
+	template<typename U> auto Zip(U&& Other) &&;
+	/** Collects every remaining value into an array, which is presized to
+	 *  fit Reserve values. */
+	template<typename A = FDefaultAllocator> auto ToArray(int32 Reserve = 0) &;
+	template<typename A = FDefaultAllocator> auto ToArray(int32 Reserve = 0) &&;
 };
 
 /** Provides an iterator-like interface over TGenerator: operator++ advances
@@ -101,39 +142,47 @@ public:
 template<typename T>
 class TGeneratorIterator
 {
-	TGenerator<T>* Generator; // nullptr == end()
+	// Holding the handle instead of the TGenerator keeps the frame from
+	// escaping through a pointer, so that a generator that's created and fully
+	// iterated in the same scope is eligible for heap allocation elision.
+	using handle_type =
+		Private::stdcoro::coroutine_handle<Private::TGeneratorPromise<T>>;
+	handle_type Handle; // nullptr == end()
 
 public:
 	/** Constructs an iterator wrapper over a generator coroutine. */
 	explicit TGeneratorIterator(TGenerator<T>& Generator) noexcept
-		: Generator(Generator ? &Generator : nullptr) { }
+		: Handle(Generator ? Generator.Handle : handle_type()) { }
 
 	/** The end() iterator for every generator coroutine. */
-	explicit TGeneratorIterator(std::nullptr_t) noexcept
-		: Generator(nullptr) { }
+	explicit TGeneratorIterator(std::nullptr_t) noexcept { }
 
 	/** Returns true if the iterator is not equal to end().
 	 *  Provided for compatibility with code expecting UE-style iterators. */
-	explicit operator bool() const noexcept { return Generator != nullptr; }
+	explicit operator bool() const noexcept
+	{
+		return static_cast<bool>(Handle);
+	}
 
 	/** Compares this iterator with another. Provided for STL compatibility. */
 	bool operator==(const TGeneratorIterator& Other) const noexcept
 	{
-		return Generator == Other.Generator;
+		return Handle == Other.Handle;
 	}
 
 	/** Compares this iterator with another. Provided for STL compatibility. */
 	bool operator!=(const TGeneratorIterator& Other) const noexcept
 	{
-		return Generator != Other.Generator;
+		return Handle != Other.Handle;
 	}
 
 	/** Advances the generator. */
 	TGeneratorIterator& operator++()
 	{
-		checkf(Generator, TEXT("Attempted to move iterator past end()"));
-		if (UNLIKELY(!Generator->Resume())) // Did the coroutine finish?
-			Generator = nullptr; // Become end() if it did
+		checkf(Handle, TEXT("Attempted to move iterator past end()"));
+		Handle.resume();
+		if (UNLIKELY(Handle.done())) // Did the coroutine finish?
+			Handle = nullptr; // Become end() if it did
 		return *this;
 	}
 
@@ -145,17 +194,235 @@ public:
 	/** Returns the generator's Current() value. */
 	T& operator*() const
 	{
-		checkf(Generator, TEXT("Attempted to dereference invalid iterator"));
-		return Generator->Current();
+		checkf(Handle && Handle.promise().Current,
+		       TEXT("Attempted to dereference invalid iterator"));
+		return *static_cast<T*>(Handle.promise().Current);
 	}
 
 	/** Returns a pointer to the generator's Current() value. */
 	T* operator->() const { return std::addressof(operator*()); }
 };
+
+/**
+ * Generator coroutine that collects the values that it co_yields into chunks
+ * of up to ChunkSize, and only suspends once a chunk is full, or at the end.
+ * <br>Callers receive each chunk in one piece as a contiguous TArrayView, or
+ * may use the provided iterators to go through the individual values like
+ * they would with TGenerator.
+ */
+template<typename T, int32 ChunkSize = 256>
+struct [[nodiscard]] TChunkedGenerator
+{
+	static_assert(ChunkSize > 0, "Invalid chunk size");
+	using promise_type = Private::TChunkedGeneratorPromise<T, ChunkSize>;
+	using iterator = TChunkedGeneratorIterator<T, ChunkSize>;
+	friend promise_type;
+
+private:
+	Private::stdcoro::coroutine_handle<promise_type> Handle;
+
+	explicit TChunkedGenerator(
+		Private::stdcoro::coroutine_handle<promise_type> Handle) noexcept
+		: Handle(Handle) { }
+
+public:
+	TChunkedGenerator(TChunkedGenerator&& Other) noexcept
+	{
+		std::swap(Handle, Other.Handle);
+	}
+
+	~TChunkedGenerator()
+	{
+		if (Handle)
+			Handle.destroy();
+	}
+
+	TChunkedGenerator(const TChunkedGenerator&) = delete;
+	TChunkedGenerator& operator=(const TChunkedGenerator&) = delete;
+	TChunkedGenerator& operator=(TChunkedGenerator&&) = delete;
+
+	/** Returns true if Current() is not empty. */
+	explicit operator bool() const noexcept
+	{
+		return Handle && Handle.promise().Buffer.Num() > 0;
+	}
+
+	/** Discards the current chunk and resumes the generator to fill the next
+	 *  one. Returns true if Current() is not empty. */
+	bool Resume()
+	{
+		if (LIKELY(Handle))
+		{
+			Handle.promise().Buffer.Reset();
+			if (!Handle.done())
+				Handle.resume();
+		}
+		return operator bool();
+	}
+
+	/** Returns the values that were co_yielded since the last resumption. */
+	TArrayView<T> Current() const
+	{
+		checkf(Handle, TEXT("Attempting to read from invalid generator"));
+		return Handle.promise().Buffer;
+	}
+
+	iterator CreateIterator() noexcept { return iterator(*this); }
+	iterator begin() noexcept { return iterator(*this); }
+	iterator end() const noexcept { return iterator(nullptr); }
+};
+
+/** Iterates the individual values of a TChunkedGenerator, resuming it when the
+ *  current chunk runs out. */
+template<typename T, int32 ChunkSize>
+class TChunkedGeneratorIterator
+{
+	TChunkedGenerator<T, ChunkSize>* Generator; // nullptr == end()
+	int32 Index = 0;
+
+public:
+	/** Constructs an iterator wrapper over a generator coroutine. */
+	explicit TChunkedGeneratorIterator(
+		TChunkedGenerator<T, ChunkSize>& Generator) noexcept
+		: Generator(Generator ? &Generator : nullptr) { }
+
+	/** The end() iterator for every generator coroutine. */
+	explicit TChunkedGeneratorIterator(std::nullptr_t) noexcept
+		: Generator(nullptr) { }
+
+	/** Returns true if the iterator is not equal to end().
+	 *  Provided for compatibility with code expecting UE-style iterators. */
+	explicit operator bool() const noexcept { return Generator != nullptr; }
+
+	/** Compares this iterator with another. Provided for STL compatibility. */
+	bool operator==(const TChunkedGeneratorIterator& Other) const noexcept
+	{
+		return Generator == Other.Generator && Index == Other.Index;
+	}
+
+	/** Compares this iterator with another. Provided for STL compatibility. */
+	bool operator!=(const TChunkedGeneratorIterator& Other) const noexcept
+	{
+		return !(*this == Other);
+	}
+
+	/** Moves to the next value, resuming the generator if necessary. */
+	TChunkedGeneratorIterator& operator++()
+	{
+		checkf(Generator, TEXT("Attempted to move iterator past end()"));
+		if (LIKELY(++Index < Generator->Current().Num()))
+			return *this;
+		Index = 0;
+		if (UNLIKELY(!Generator->Resume())) // Did the coroutine finish?
+			Generator = nullptr; // Become end() if it did
+		return *this;
+	}
+
+	/** Moves to the next value. Returns void for consistency with
+	 *  TGeneratorIterator. */
+	void operator++(int) { operator++(); }
+
+	/** Returns the current value. */
+	T& operator*() const
+	{
+		checkf(Generator, TEXT("Attempted to dereference invalid iterator"));
+		return Generator->Current()[Index];
+	}
+
+	/** Returns a pointer to the current value. */
+	T* operator->() const { return std::addressof(operator*()); }
+};
 }
 
 namespace UE5Coro::Private
 {
+/** Allocates generator frames, and stores the function that frees each frame
+ *  right after it. */
+struct FGeneratorFrame
+{
+	using FFree = void (*)(void* Frame, size_t Size) noexcept;
+
+	struct alignas(__STDCPP_DEFAULT_NEW_ALIGNMENT__) FBlock
+	{
+		unsigned char Bytes[__STDCPP_DEFAULT_NEW_ALIGNMENT__];
+	};
+
+	template<typename A>
+	struct TLayout
+	{
+		using FAlloc =
+			typename std::allocator_traits<A>::template rebind_alloc<FBlock>;
+		static_assert(alignof(FAlloc) <= alignof(FBlock),
+		              "Overaligned allocators are not supported");
+
+		static constexpr size_t AllocOffset(size_t Size) noexcept
+		{
+			return Align(FreeOffset(Size) + sizeof(FFree), alignof(FAlloc));
+		}
+
+		static constexpr size_t NumBlocks(size_t Size) noexcept
+		{
+			return (AllocOffset(Size) + sizeof(FAlloc) + sizeof(FBlock) - 1) /
+			       sizeof(FBlock);
+		}
+
+		static FAlloc* GetAlloc(void* Frame, size_t Size) noexcept
+		{
+			return reinterpret_cast<FAlloc*>(static_cast<char*>(Frame) +
+			                                 AllocOffset(Size));
+		}
+
+		static void Free(void* Frame, size_t Size) noexcept
+		{
+			auto* Stored = GetAlloc(Frame, Size);
+			FAlloc Alloc(std::move(*Stored));
+			Stored->~FAlloc();
+			std::allocator_traits<FAlloc>::deallocate(
+				Alloc, static_cast<FBlock*>(Frame), NumBlocks(Size));
+		}
+	};
+
+	static constexpr size_t FreeOffset(size_t Size) noexcept
+	{
+		return Align(Size, alignof(FFree));
+	}
+
+	static FFree& GetFree(void* Frame, size_t Size) noexcept
+	{
+		return *reinterpret_cast<FFree*>(static_cast<char*>(Frame) +
+		                                 FreeOffset(Size));
+	}
+
+	static void* Allocate(size_t Size)
+	{
+		void* Frame = FFrameAllocator::Allocate(FreeOffset(Size) +
+		                                        sizeof(FFree));
+		GetFree(Frame, Size) = [](void* Ptr, size_t) noexcept
+		{
+			FFrameAllocator::Free(Ptr);
+		};
+		return Frame;
+	}
+
+	template<typename A>
+	static void* Allocate(size_t Size, const A& Allocator)
+	{
+		using FLayout = TLayout<A>;
+		typename FLayout::FAlloc Alloc(Allocator);
+		void* Frame = std::allocator_traits<typename FLayout::FAlloc>::allocate(
+			Alloc, FLayout::NumBlocks(Size));
+		new (FLayout::GetAlloc(Frame, Size))
+			typename FLayout::FAlloc(std::move(Alloc));
+		GetFree(Frame, Size) = &FLayout::Free;
+		return Frame;
+	}
+
+	static void Free(void* Frame, size_t Size) noexcept
+	{
+		GetFree(Frame, Size)(Frame, Size);
+	}
+};
+
 class [[nodiscard]] UE5CORO_API FGeneratorPromise
 {
 protected:
@@ -166,6 +433,32 @@ public:
 	FGeneratorPromise() = default;
 	UE_NONCOPYABLE(FGeneratorPromise);
 
+	static void* operator new(size_t Size)
+	{
+		return FGeneratorFrame::Allocate(Size);
+	}
+
+	// Free functions: (std::allocator_arg_t, const A&, ...)
+	template<typename A, typename... T>
+	static void* operator new(size_t Size, std::allocator_arg_t,
+	                          const A& Allocator, const T&...)
+	{
+		return FGeneratorFrame::Allocate(Size, Allocator);
+	}
+
+	// Member functions and lambdas: (this, std::allocator_arg_t, const A&, ...)
+	template<typename C, typename A, typename... T>
+	static void* operator new(size_t Size, const C&, std::allocator_arg_t,
+	                          const A& Allocator, const T&...)
+	{
+		return FGeneratorFrame::Allocate(Size, Allocator);
+	}
+
+	static void operator delete(void* Ptr, size_t Size) noexcept
+	{
+		FGeneratorFrame::Free(Ptr, Size);
+	}
+
 	stdcoro::suspend_never initial_suspend() noexcept { return {}; }
 	stdcoro::suspend_always final_suspend() noexcept { return {}; }
 	void return_void() noexcept { Current = nullptr; }
@@ -180,6 +473,7 @@ template<typename T>
 class [[nodiscard]] TGeneratorPromise : public FGeneratorPromise
 {
 	friend TGenerator<T>;
+	friend TGeneratorIterator<T>;
 	using handle_type = stdcoro::coroutine_handle<TGeneratorPromise>;
 
 public:
@@ -200,4 +494,431 @@ public:
 		return stdcoro::suspend_always();
 	}
 };
+
+template<typename T, int32 ChunkSize>
+class [[nodiscard]] TChunkedGeneratorPromise : public FGeneratorPromise
+{
+	friend TChunkedGenerator<T, ChunkSize>;
+	using handle_type = stdcoro::coroutine_handle<TChunkedGeneratorPromise>;
+
+	TArray<T> Buffer;
+
+	/** Only suspends if the chunk is full. */
+	struct FYieldAwaiter : stdcoro::suspend_always
+	{
+		bool bReady;
+		bool await_ready() const noexcept { return bReady; }
+	};
+
+public:
+	TChunkedGeneratorPromise() { Buffer.Reserve(ChunkSize); }
+
+	TChunkedGenerator<T, ChunkSize> get_return_object() noexcept
+	{
+		return TChunkedGenerator<T, ChunkSize>(handle_type::from_promise(*this));
+	}
+
+	FYieldAwaiter yield_value(const T& Value)
+	{
+		Buffer.Add(Value);
+		return {{}, Buffer.Num() < ChunkSize};
+	}
+
+	FYieldAwaiter yield_value(T&& Value)
+	{
+		Buffer.Add(std::move(Value));
+		return {{}, Buffer.Num() < ChunkSize};
+	}
+};
+}
+
+namespace UE5Coro::Private
+{
+/** Reads the values of a TGenerator, either owning it or referring to it. */
+template<typename T, bool bOwned>
+class TGeneratorCursor
+{
+	std::conditional_t<bOwned, TGenerator<T>, TGenerator<T>*> Generator;
+	bool bStarted = false;
+
+	TGenerator<T>& Get() noexcept
+	{
+		if constexpr (bOwned)
+			return Generator;
+		else
+			return *Generator;
+	}
+
+public:
+	explicit TGeneratorCursor(TGenerator<T>&& Generator) noexcept
+		: Generator(std::move(Generator)) { }
+	explicit TGeneratorCursor(TGenerator<T>* Generator) noexcept
+		: Generator(Generator) { }
+
+	/** Moves to the next value, returns false if there's none.
+	 *  Generators are already on their first value, that's not skipped. */
+	bool Next()
+	{
+		if (UNLIKELY(!bStarted))
+		{
+			bStarted = true;
+			return static_cast<bool>(Get());
+		}
+		return Get().Resume();
+	}
+
+	T& Current() { return Get().Current(); }
+};
+
+template<typename C, typename F>
+class TMapCursor
+{
+	using FResult = std::invoke_result_t<F&, decltype(std::declval<C&>()
+	                                                  .Current())>;
+	static constexpr bool bCache = !std::is_reference_v<FResult>;
+
+	C Inner;
+	F Fn;
+	// Filter and the consumer both read the current value, Fn only runs once
+	std::conditional_t<bCache, TOptional<FResult>, std::nullptr_t> Cache{};
+
+public:
+	explicit TMapCursor(C&& Inner, F&& Fn)
+		: Inner(std::move(Inner)), Fn(std::move(Fn)) { }
+
+	bool Next()
+	{
+		if constexpr (bCache)
+			Cache.Reset();
+		return Inner.Next();
+	}
+
+	decltype(auto) Current()
+	{
+		if constexpr (bCache)
+		{
+			if (!Cache)
+				Cache.Emplace(std::invoke(Fn, Inner.Current()));
+			return *Cache;
+		}
+		else
+			return std::invoke(Fn, Inner.Current());
+	}
+};
+
+template<typename C, typename F>
+class TFilterCursor
+{
+	C Inner;
+	F Pred;
+
+public:
+	explicit TFilterCursor(C&& Inner, F&& Pred)
+		: Inner(std::move(Inner)), Pred(std::move(Pred)) { }
+
+	bool Next()
+	{
+		while (Inner.Next())
+			if (std::invoke(Pred, Inner.Current()))
+				return true;
+		return false;
+	}
+
+	decltype(auto) Current() { return Inner.Current(); }
+};
+
+template<typename C>
+class TTakeCursor
+{
+	C Inner;
+	int32 Remaining;
+
+public:
+	explicit TTakeCursor(C&& Inner, int32 Num)
+		: Inner(std::move(Inner)), Remaining(Num) { }
+
+	bool Next() { return Remaining-- > 0 && Inner.Next(); }
+	decltype(auto) Current() { return Inner.Current(); }
+};
+
+template<typename C>
+class TChunkCursor
+{
+	using FValue = std::decay_t<decltype(std::declval<C&>().Current())>;
+
+	C Inner;
+	int32 Size;
+	TArray<FValue> Buffer;
+
+public:
+	explicit TChunkCursor(C&& Inner, int32 Size)
+		: Inner(std::move(Inner)), Size(Size)
+	{
+		checkf(Size > 0, TEXT("Invalid chunk size"));
+		Buffer.Reserve(Size);
+	}
+
+	bool Next()
+	{
+		Buffer.Reset();
+		while (Buffer.Num() < Size && Inner.Next())
+			Buffer.Emplace(Inner.Current());
+		return Buffer.Num() > 0;
+	}
+
+	TArrayView<FValue> Current() { return Buffer; }
+};
+
+template<typename C1, typename C2>
+class TZipCursor
+{
+	C1 First;
+	C2 Second;
+
+public:
+	explicit TZipCursor(C1&& First, C2&& Second)
+		: First(std::move(First)), Second(std::move(Second)) { }
+
+	bool Next() { return First.Next() && Second.Next(); }
+
+	auto Current()
+	{
+		return TTuple<decltype(First.Current()), decltype(Second.Current())>(
+			First.Current(), Second.Current());
+	}
+};
+
+template<typename T>
+TGeneratorCursor<T, false> MakeCursor(TGenerator<T>& Generator) noexcept
+{
+	return TGeneratorCursor<T, false>(&Generator);
+}
+
+template<typename T>
+TGeneratorCursor<T, true> MakeCursor(TGenerator<T>&& Generator) noexcept
+{
+	return TGeneratorCursor<T, true>(std::move(Generator));
+}
+
+template<typename C>
+C MakeCursor(TGeneratorRange<C>&& Range)
+{
+	return std::move(Range).ReleaseCursor();
+}
+}
+
+namespace UE5Coro
+{
+/** Lazy, single-pass view of a TGenerator's values, optionally transformed by
+ *  a chain of adaptors.<br>
+ *  Adaptors consume the view that they're called on, and return a new one.
+ *  Nothing runs until the final view is iterated or collected with ToArray.
+ *  Values are computed one by one as they're read, so iteration usually
+ *  compiles into a single loop around the generator's resumptions. */
+template<typename C>
+class [[nodiscard]] TGeneratorRange
+{
+	template<typename> friend class TGeneratorRange;
+	template<typename D>
+	friend D Private::MakeCursor(TGeneratorRange<D>&&);
+
+	C Cursor;
+
+	C ReleaseCursor() && { return std::move(Cursor); }
+
+public:
+	using reference = decltype(std::declval<C&>().Current());
+	using value_type = std::decay_t<reference>;
+
+	explicit TGeneratorRange(C&& Cursor) : Cursor(std::move(Cursor)) { }
+	TGeneratorRange(TGeneratorRange&&) = default;
+	TGeneratorRange(const TGeneratorRange&) = delete;
+	TGeneratorRange& operator=(const TGeneratorRange&) = delete;
+
+	class iterator
+	{
+		C* Cursor; // nullptr == end()
+
+	public:
+		explicit iterator(C* Cursor) : Cursor(Cursor)
+		{
+			if (Cursor && !Cursor->Next())
+				this->Cursor = nullptr;
+		}
+
+		explicit operator bool() const noexcept { return Cursor != nullptr; }
+
+		bool operator==(const iterator& Other) const noexcept
+		{
+			return Cursor == Other.Cursor;
+		}
+
+		bool operator!=(const iterator& Other) const noexcept
+		{
+			return Cursor != Other.Cursor;
+		}
+
+		iterator& operator++()
+		{
+			checkf(Cursor, TEXT("Attempted to move iterator past end()"));
+			if (UNLIKELY(!Cursor->Next()))
+				Cursor = nullptr;
+			return *this;
+		}
+
+		/** Returns void, like TGeneratorIterator. */
+		void operator++(int) { operator++(); }
+
+		reference operator*() const
+		{
+			checkf(Cursor, TEXT("Attempted to dereference invalid iterator"));
+			return Cursor->Current();
+		}
+	};
+
+	/** Starts iterating the view. This may only be called once. */
+	iterator begin() { return iterator(&Cursor); }
+	iterator end() const noexcept { return iterator(nullptr); }
+
+	template<typename F>
+	auto Map(F&& Fn) &&
+	{
+		using FCursor = Private::TMapCursor<C, std::decay_t<F>>;
+		return TGeneratorRange<FCursor>(FCursor(std::move(Cursor),
+		                                        std::decay_t<F>(
+			                                        std::forward<F>(Fn))));
+	}
+
+	template<typename F>
+	auto Filter(F&& Pred) &&
+	{
+		using FCursor = Private::TFilterCursor<C, std::decay_t<F>>;
+		return TGeneratorRange<FCursor>(FCursor(std::move(Cursor),
+		                                        std::decay_t<F>(
+			                                        std::forward<F>(Pred))));
+	}
+
+	auto Take(int32 Num) &&
+	{
+		using FCursor = Private::TTakeCursor<C>;
+		return TGeneratorRange<FCursor>(FCursor(std::move(Cursor), Num));
+	}
+
+	auto Chunk(int32 Size) &&
+	{
+		using FCursor = Private::TChunkCursor<C>;
+		return TGeneratorRange<FCursor>(FCursor(std::move(Cursor), Size));
+	}
+
+	template<typename U>
+	auto Zip(U&& Other) &&
+	{
+		using FOther = decltype(Private::MakeCursor(std::forward<U>(Other)));
+		using FCursor = Private::TZipCursor<C, FOther>;
+		return TGeneratorRange<FCursor>(FCursor(
+			std::move(Cursor), Private::MakeCursor(std::forward<U>(Other))));
+	}
+
+	template<typename A = FDefaultAllocator>
+	TArray<value_type, A> ToArray(int32 Reserve = 0) &&
+	{
+		TArray<value_type, A> Array;
+		Array.Reserve(Reserve);
+		while (Cursor.Next())
+			Array.Emplace(Cursor.Current());
+		return Array;
+	}
+};
+
+template<typename T>
+auto TGenerator<T>::View() &
+{
+	return TGeneratorRange(Private::MakeCursor(*this));
+}
+
+template<typename T>
+auto TGenerator<T>::View() &&
+{
+	return TGeneratorRange(Private::MakeCursor(std::move(*this)));
+}
+
+template<typename T>
+template<typename F>
+auto TGenerator<T>::Map(F&& Fn) &
+{
+	return View().Map(std::forward<F>(Fn));
+}
+
+template<typename T>
+template<typename F>
+auto TGenerator<T>::Map(F&& Fn) &&
+{
+	return std::move(*this).View().Map(std::forward<F>(Fn));
+}
+
+template<typename T>
+template<typename F>
+auto TGenerator<T>::Filter(F&& Pred) &
+{
+	return View().Filter(std::forward<F>(Pred));
+}
+
+template<typename T>
+template<typename F>
+auto TGenerator<T>::Filter(F&& Pred) &&
+{
+	return std::move(*this).View().Filter(std::forward<F>(Pred));
+}
+
+template<typename T>
+auto TGenerator<T>::Take(int32 Num) &
+{
+	return View().Take(Num);
+}
+
+template<typename T>
+auto TGenerator<T>::Take(int32 Num) &&
+{
+	return std::move(*this).View().Take(Num);
+}
+
+template<typename T>
+auto TGenerator<T>::Chunk(int32 Size) &
+{
+	return View().Chunk(Size);
+}
+
+template<typename T>
+auto TGenerator<T>::Chunk(int32 Size) &&
+{
+	return std::move(*this).View().Chunk(Size);
+}
+
+template<typename T>
+template<typename U>
+auto TGenerator<T>::Zip(U&& Other) &
+{
+	return View().Zip(std::forward<U>(Other));
+}
+
+template<typename T>
+template<typename U>
+auto TGenerator<T>::Zip(U&& Other) &&
+{
+	return std::move(*this).View().Zip(std::forward<U>(Other));
+}
+
+template<typename T>
+template<typename A>
+auto TGenerator<T>::ToArray(int32 Reserve) &
+{
+	return View().template ToArray<A>(Reserve);
+}
+
+template<typename T>
+template<typename A>
+auto TGenerator<T>::ToArray(int32 Reserve) &&
+{
+	return std::move(*this).View().template ToArray<A>(Reserve);
+}
 }
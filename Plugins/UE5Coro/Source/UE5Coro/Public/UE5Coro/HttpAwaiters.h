@@ -35,11 +35,22 @@
 #include "UE5Coro/Definitions.h"
 #include <optional>
 #include "Interfaces/IHttpRequest.h"
+#include "Misc/IQueuedWork.h"
+#include "UE5Coro/AsyncAwaiters.h"
 #include "UE5Coro/AsyncCoroutine.h"
 
+class UScriptStruct;
+
 namespace UE5Coro::Private
 {
 class FHttpAwaiter;
+class FResponseStreamAwaiter;
+struct FCachedClientState;
+struct FRequestQueueState;
+struct FResponseStreamState;
+struct FTimedRequestState;
+UE5CORO_API bool DeserializeJson(TConstArrayView<uint8> Utf8,
+                                 const UScriptStruct* Struct, void* Out);
 }
 
 namespace UE5Coro::Http
@@ -48,6 +59,155 @@ namespace UE5Coro::Http
  *  The result of the co_await expression will be a TTuple of
  *  FHttpResponsePtr and bool bConnectedSuccessfully. */
 UE5CORO_API Private::FHttpAwaiter ProcessAsync(FHttpRequestRef);
+
+/** Processes the request, then deserializes the JSON object in its response
+ *  body into a USTRUCT on a background thread, directly from the received
+ *  bytes.<br>
+ *  The coroutine completes on the same kind of named thread that this function
+ *  was called on. The result is empty if the request failed, or if the
+ *  response was not a JSON object that could be converted to T.<br>
+ *  T must be safe to construct and fill off the game thread, i.e., it should
+ *  not contain hard UObject references. */
+template<typename T>
+TCoroutine<TOptional<T>> ProcessJsonAsync(FHttpRequestRef Request);
+
+/** Processes every request concurrently, and completes once all of them are
+ *  done. The results are in the same order as the requests. */
+UE5CORO_API TCoroutine<TArray<TTuple<FHttpResponsePtr, bool>>>
+ProcessAllAsync(TArray<FHttpRequestRef> Requests);
+
+/** Processes the request, and sends a copy of it if it has not completed
+ *  after HedgeAfterSeconds. This repeats until MaxAttempts requests are in
+ *  flight.<br>
+ *  The first response that connected successfully is the result, and the
+ *  other requests are canceled. If every attempt fails, the result is the
+ *  last failure. An unsuccessful attempt sends the next copy immediately.<br>
+ *  Copies have the same URL, verb, headers, and content as the request.
+ *  Only use this with requests that are safe to repeat.<br>
+ *  co_awaiting the return value behaves like Http::ProcessAsync. */
+UE5CORO_API Private::FHttpAwaiter ProcessHedged(FHttpRequestRef Request,
+                                                double HedgeAfterSeconds,
+                                                int32 MaxAttempts = 2);
+
+/** Processes the request, and cancels it if it hasn't completed after the
+ *  specified amount of time.<br>
+ *  co_awaiting the return value behaves like Http::ProcessAsync. A request
+ *  that was canceled will not be successful. */
+UE5CORO_API Private::FHttpAwaiter ProcessWithDeadline(FHttpRequestRef Request,
+                                                      double Seconds);
+
+/** Limits how many HTTP requests are being processed at the same time.<br>
+ *  Requests beyond the limits wait in the queue, and are started in priority
+ *  order, then in the order they were submitted, as earlier ones complete.
+ *  <br>This object is thread safe. Destroying it fails requests that haven't
+ *  started yet; requests that are already in flight are not affected. */
+class [[nodiscard]] UE5CORO_API FRequestQueue
+{
+	TSharedPtr<Private::FRequestQueueState> State;
+
+public:
+	/** @param MaxInFlight Maximum number of concurrent requests.
+	 *  @param MaxPerHost Maximum number of concurrent requests to the same
+	 *  domain, 0 for no separate limit. */
+	explicit FRequestQueue(int32 MaxInFlight = 16, int32 MaxPerHost = 0);
+	UE_NONCOPYABLE(FRequestQueue);
+	~FRequestQueue();
+
+	/** Queues the request for processing.<br>
+	 *  co_awaiting the return value behaves like Http::ProcessAsync.
+	 *  A request that is rejected without being processed because the queue
+	 *  was destroyed will result in nullptr and false. */
+	Private::FHttpAwaiter Process(
+		FHttpRequestRef Request,
+		EQueuedWorkPriority Priority = EQueuedWorkPriority::Normal);
+
+	/** Queues every request, and completes once all of them are done.
+	 *  The results are in the same order as the requests. */
+	TCoroutine<TArray<TTuple<FHttpResponsePtr, bool>>> ProcessAll(
+		TArray<FHttpRequestRef> Requests,
+		EQueuedWorkPriority Priority = EQueuedWorkPriority::Normal);
+
+	/** Returns the number of requests currently being processed. */
+	int32 NumInFlight() const;
+
+	/** Returns the number of requests waiting in the queue. */
+	int32 NumQueued() const;
+};
+
+/** Processes GET requests through an in-memory LRU cache of responses.<br>
+ *  Responses are keyed by their URL and request headers. Each one is reused
+ *  while it's fresh according to its Cache-Control: max-age, then revalidated
+ *  using its ETag or Last-Modified header, if it has one. Responses with
+ *  Cache-Control: no-store are not cached.<br>
+ *  Identical requests that are processed at the same time are coalesced into
+ *  one, and every awaiter receives the same FHttpResponsePtr. A response that
+ *  was revalidated with 304 Not Modified is provided as the original 200.<br>
+ *  This object is thread safe. Requests in flight keep working after it's
+ *  destroyed, but they will not be cached. */
+class [[nodiscard]] UE5CORO_API FCachedClient
+{
+	TSharedPtr<Private::FCachedClientState> State;
+
+public:
+	/** @param MaxBytes Total size of cached response bodies, least recently
+	 *  used responses are evicted above this. */
+	explicit FCachedClient(int64 MaxBytes = 16 << 20);
+	UE_NONCOPYABLE(FCachedClient);
+
+	/** Processes the request, or provides a cached response to it.<br>
+	 *  co_awaiting the return value behaves like Http::ProcessAsync.
+	 *  Requests with verbs other than GET bypass the cache. Revalidation adds
+	 *  If-None-Match or If-Modified-Since headers to the request. */
+	Private::FHttpAwaiter Process(FHttpRequestRef Request);
+
+	/** Removes every cached response for this URL. */
+	void Invalidate(const FString& Url);
+
+	/** Removes every cached response. */
+	void Empty();
+
+	/** Returns the total size of the cached response bodies. */
+	int64 GetCachedBytes() const;
+};
+
+/** Incrementally received body of an HTTP response. See StreamAsync. */
+class [[nodiscard]] UE5CORO_API FResponseStream
+{
+	TSharedPtr<Private::FResponseStreamState> State;
+
+	void Close();
+
+public:
+	explicit FResponseStream(FHttpRequestRef Request, int64 MaxBufferedBytes);
+	FResponseStream(FResponseStream&&) = default;
+	FResponseStream& operator=(FResponseStream&&);
+	FResponseStream(const FResponseStream&) = delete;
+	FResponseStream& operator=(const FResponseStream&) = delete;
+	/** Cancels the request if it's still in progress. */
+	~FResponseStream();
+
+	/** co_await the return value of this function to receive the next chunk
+	 *  of the response body, or an empty TOptional once the request is done.
+	 *  <br>There may only be one co_await on Next() in progress at a time. */
+	Private::FResponseStreamAwaiter Next();
+
+	/** Valid after Next() resulted in an empty TOptional.<br>
+	 *  On UE 5.3+, the response's content will be empty, since it was returned
+	 *  in chunks instead. */
+	FHttpResponsePtr GetResponse() const;
+
+	/** Valid after Next() resulted in an empty TOptional. */
+	bool WasConnectedSuccessfully() const;
+};
+
+/** Processes the request, providing the response body in chunks as they are
+ *  received instead of buffering all of it.<br>
+ *  If more than MaxBufferedBytes are waiting to be consumed, the HTTP thread is
+ *  blocked until the coroutine catches up. This stalls other requests, too.
+ *  <br>Streaming requires UE 5.3 or later. On earlier versions, the entire
+ *  body is returned as one chunk once the request completes. */
+UE5CORO_API FResponseStream StreamAsync(FHttpRequestRef Request,
+                                        int64 MaxBufferedBytes = 16 << 20);
 }
 
 namespace UE5Coro::Private
@@ -70,6 +230,14 @@ class [[nodiscard]] UE5CORO_API FHttpAwaiter : public TAwaiter<FHttpAwaiter>
 	};
 	TSharedPtr<FState> State;
 
+	friend Http::FCachedClient;
+	friend Http::FRequestQueue;
+	friend FCachedClientState;
+	friend FRequestQueueState;
+	friend FTimedRequestState;
+	explicit FHttpAwaiter(TSharedPtr<FState> State)
+		: State(std::move(State)) { }
+
 public:
 	explicit FHttpAwaiter(FHttpRequestRef&& Request);
 
@@ -77,4 +245,37 @@ public:
 	void Suspend(FPromise&);
 	TTuple<FHttpResponsePtr, bool> await_resume();
 };
+
+class [[nodiscard]] UE5CORO_API FResponseStreamAwaiter
+	: public TAwaiter<FResponseStreamAwaiter>
+{
+	TSharedPtr<FResponseStreamState> State;
+
+public:
+	explicit FResponseStreamAwaiter(TSharedPtr<FResponseStreamState> State)
+		: State(std::move(State)) { }
+
+	bool await_ready();
+	void Suspend(FPromise&);
+	TOptional<TArray<uint8>> await_resume();
+};
+}
+
+template<typename T>
+UE5Coro::TCoroutine<TOptional<T>> UE5Coro::Http::ProcessJsonAsync(
+	FHttpRequestRef Request)
+{
+	auto Return = Async::MoveToSimilarThread();
+	auto [Response, bSuccess] = co_await ProcessAsync(std::move(Request));
+	TOptional<T> Result;
+	if (bSuccess && Response)
+	{
+		co_await Async::MoveToThread(
+			ENamedThreads::AnyBackgroundThreadNormalTask);
+		if (!Private::DeserializeJson(Response->GetContent(),
+		                              T::StaticStruct(), &Result.Emplace()))
+			Result.Reset();
+	}
+	co_await Return;
+	co_return Result;
 }
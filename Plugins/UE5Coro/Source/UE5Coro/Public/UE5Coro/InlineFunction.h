@@ -0,0 +1,193 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+/******************************************************************************
+ *          This file only contains private implementation details.           *
+ ******************************************************************************/
+
+#include "CoreMinimal.h"
+#include "UE5Coro/Definitions.h"
+#include <functional>
+#include <new>
+#include <type_traits>
+
+namespace UE5Coro::Private
+{
+template<typename, size_t = 4 * sizeof(void*)>
+class TInlineFunction;
+
+/** Move-only callable wrapper that stores small functors without allocating.
+ *  Functors that are too large, overaligned, or not nothrow movable are
+ *  stored on the heap instead. */
+template<typename R, typename... A, size_t InlineSize>
+class TInlineFunction<R(A...), InlineSize>
+{
+	static_assert(InlineSize >= sizeof(void*));
+
+	struct FOps
+	{
+		R (*Invoke)(void*, A&&...);
+		void (*Move)(void* From, void* To) noexcept; // Also destroys From
+		void (*Destroy)(void*) noexcept;
+		bool bInline;
+	};
+
+	template<typename F>
+	static constexpr bool bStoredInline = sizeof(F) <= InlineSize &&
+	                                      alignof(F) <= alignof(void*) &&
+	                                      std::is_nothrow_move_constructible_v<F>;
+
+	template<typename F>
+	struct TInlineOps
+	{
+		static R Invoke(void* Storage, A&&... Args)
+		{
+			return std::invoke(*static_cast<F*>(Storage),
+			                   std::forward<A>(Args)...);
+		}
+
+		static void Move(void* From, void* To) noexcept
+		{
+			auto* Fn = static_cast<F*>(From);
+			new (To) F(std::move(*Fn));
+			Fn->~F();
+		}
+
+		static void Destroy(void* Storage) noexcept
+		{
+			static_cast<F*>(Storage)->~F();
+		}
+
+		static constexpr FOps Ops{&Invoke, &Move, &Destroy, true};
+	};
+
+	template<typename F>
+	struct THeapOps
+	{
+		static R Invoke(void* Storage, A&&... Args)
+		{
+			return std::invoke(**static_cast<F**>(Storage),
+			                   std::forward<A>(Args)...);
+		}
+
+		static void Move(void* From, void* To) noexcept
+		{
+			*static_cast<F**>(To) = *static_cast<F**>(From);
+		}
+
+		static void Destroy(void* Storage) noexcept
+		{
+			delete *static_cast<F**>(Storage);
+		}
+
+		static constexpr FOps Ops{&Invoke, &Move, &Destroy, false};
+	};
+
+	alignas(void*) unsigned char Storage[InlineSize];
+	const FOps* Ops = nullptr;
+
+public:
+	TInlineFunction() noexcept = default;
+	TInlineFunction(std::nullptr_t) noexcept { }
+
+	template<typename F, typename = std::enable_if_t<
+		!std::is_same_v<std::decay_t<F>, TInlineFunction> &&
+		std::is_invocable_r_v<R, std::decay_t<F>&, A...>>>
+	TInlineFunction(F&& Fn)
+	{
+		using FDecayed = std::decay_t<F>;
+		if constexpr (bStoredInline<FDecayed>)
+		{
+			new (Storage) FDecayed(std::forward<F>(Fn));
+			Ops = &TInlineOps<FDecayed>::Ops;
+		}
+		else
+		{
+			*reinterpret_cast<FDecayed**>(Storage) =
+				new FDecayed(std::forward<F>(Fn));
+			Ops = &THeapOps<FDecayed>::Ops;
+		}
+	}
+
+	TInlineFunction(TInlineFunction&& Other) noexcept : Ops(Other.Ops)
+	{
+		if (Ops)
+		{
+			Ops->Move(Other.Storage, Storage);
+			Other.Ops = nullptr;
+		}
+	}
+
+	TInlineFunction& operator=(TInlineFunction&& Other) noexcept
+	{
+		if (this != &Other)
+		{
+			Reset();
+			if ((Ops = Other.Ops))
+			{
+				Ops->Move(Other.Storage, Storage);
+				Other.Ops = nullptr;
+			}
+		}
+		return *this;
+	}
+
+	TInlineFunction(const TInlineFunction&) = delete;
+	TInlineFunction& operator=(const TInlineFunction&) = delete;
+
+	~TInlineFunction() { Reset(); }
+
+	void Reset() noexcept
+	{
+		if (Ops)
+		{
+			Ops->Destroy(Storage);
+			Ops = nullptr;
+		}
+	}
+
+	explicit operator bool() const noexcept { return Ops != nullptr; }
+
+	/** @return True if the current target (if any) didn't need allocation. */
+	bool IsStoredInline() const noexcept
+	{
+		return !Ops || Ops->bInline;
+	}
+
+	R operator()(A... Args)
+	{
+		checkf(Ops, TEXT("Calling empty TInlineFunction"));
+		return Ops->Invoke(Storage, std::forward<A>(Args)...);
+	}
+};
+}
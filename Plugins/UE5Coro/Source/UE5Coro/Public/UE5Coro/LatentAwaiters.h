@@ -37,23 +37,70 @@
 #include <concepts>
 #endif
 #include <functional>
+#include <new>
+#include <utility>
+#include "Engine/EngineBaseTypes.h"
 #include "Engine/StreamableManager.h"
 #include "UE5Coro/AsyncCoroutine.h"
+#include "UE5Coro/AsyncGenerator.h"
 #include "UE5Coro/Private.h"
 
+class AActor;
+struct FActorSpawnParameters;
+class ULevelStreaming;
+class UUE5CoroSubsystem;
+class UWorld;
+
 namespace UE5Coro::Private
 {
+class FAnyThreadTraceAwaiter;
+class FAsyncLoadProgress;
+class FAsyncLoadProgressAwaiter;
+struct FAsyncLoadProgressState;
 class FAsyncPromise;
+class FAsyncSingleTraceAwaiter;
+class FAsyncTraceBatchAwaiter;
+struct FAsyncTraceBatchState;
+class FAsyncTraceIntoAwaiter;
+struct FAsyncTraceSlot;
 class FLatentAwaiter;
 class FLatentCancellation;
 class FLatentChainAwaiter;
 class FLatentPromise;
 class FPackageLoadAwaiter;
+class FTickGroupAwaiter;
 template<typename, int> class TAsyncLoadAwaiter;
 template<typename> class TAsyncQueryAwaiter;
 template<typename> class TAsyncQueryAwaiterRV;
+template<typename> class TUntilTimeoutAwaiter;
+
+template<typename F>
+constexpr bool TIsInlinePredicate =
+	std::is_invocable_r_v<bool, std::decay_t<F>&> &&
+	!std::is_same_v<std::decay_t<F>, std::function<bool()>>;
 
-UE5CORO_API std::tuple<FLatentAwaiter, UObject*> UntilDelegateCore();
+/** Returns the world that latent awaiters should use on the game thread: the
+ *  home world of the current coroutine, the world being updated by
+ *  UE5Coro, or GWorld, in this order. */
+UE5CORO_API UWorld* GetLatentWorld();
+
+/** Makes GetLatentWorld return World outside of coroutines with a home world
+ *  while this is alive, e.g., to poll latent awaiters for World. */
+class [[nodiscard]] UE5CORO_API FLatentWorldScope final
+{
+	UWorld* Previous;
+
+public:
+	explicit FLatentWorldScope(UWorld* World);
+	UE_NONCOPYABLE(FLatentWorldScope);
+	~FLatentWorldScope();
+};
+
+UE5CORO_API double GameTimeAfter(double Seconds);
+UE5CORO_API bool IsGameTimePast(double Time);
+
+UE5CORO_API std::tuple<FLatentAwaiter, UObject*> UntilDelegateCore(
+	void* Delegate, void (*Unbind)(void*, UObject*));
 }
 
 namespace UE5Coro::Latent
@@ -73,17 +120,72 @@ UE5CORO_API Private::FLatentAwaiter NextTick();
 /** Resumes the coroutine the given number of ticks later. */
 UE5CORO_API Private::FLatentAwaiter Ticks(int64);
 
+/** Resumes the coroutine during the provided tick group of the current
+ *  world.<br>
+ *  If that group hasn't run yet in this frame, this happens in the current
+ *  frame, otherwise in the next one.
+ *  The return value of this function is reusable. */
+UE5CORO_API Private::FTickGroupAwaiter NextTick(ETickingGroup);
+
 /** Polls the provided function, resumes the coroutine when it returns true. */
 UE5CORO_API Private::FLatentAwaiter Until(std::function<bool()> Function);
 
+/** Polls the provided function, resumes the coroutine when it returns true.
+ *  <br>Small functors are stored in the awaiter and called directly, without
+ *  the allocation and type erasure of std::function. */
+template<typename F>
+auto Until(F&& Function)
+	-> std::enable_if_t<Private::TIsInlinePredicate<F>, Private::FLatentAwaiter>;
+
+/** Polls the provided function like Until, but stops waiting after the
+ *  provided amount of game time.<br>
+ *  The result of the co_await expression is true if the function returned
+ *  true, false if the time ran out first. */
+template<typename F>
+auto UntilWithTimeout(F&& Function, double Seconds)
+	-> std::enable_if_t<Private::TIsInlinePredicate<F>,
+	                    Private::TUntilTimeoutAwaiter<std::decay_t<F>>>;
+
 /** Resumes the coroutine after the delegate executes.<br>
  *  Delegate parameters are ignored, a return value is not provided.<br>
  *  Delegates are also co_awaitable without this wrapper.
- *  See the documentation for details on the differences in behavior. */
+ *  See the documentation for details on the differences in behavior.<br>
+ *  If UE5Coro.PoolDelegateCallbackTargets is set, Delegate must outlive the
+ *  returned awaiter. */
 template<typename T>
 auto UntilDelegate(T& Delegate)
 	-> std::enable_if_t<Private::TIsDelegate<T>, Private::FLatentAwaiter>;
 
+/** Sets the priority of the calling coroutine for UE5Coro.LatentResumeBudget.
+ *  <br>When the budget runs out, deferred coroutines are resumed in descending
+ *  priority order, then in the order they became ready.
+ *  Coroutines with a positive priority are never deferred. */
+UE5CORO_API void SetResumePriority(int8 Priority);
+
+/** Lowers how often the calling latent coroutine's awaiters are polled, to at
+ *  most once every Seconds of game time. 0 polls every tick again.<br>
+ *  Time-based awaiters stay correct, but they might resume up to this much
+ *  later than requested. Cancellations are still processed every tick.<br>
+ *  This has no effect on async coroutines. */
+UE5CORO_API void SetPollInterval(double Seconds);
+
+/** Like SetPollInterval, but for every latent coroutine whose world context
+ *  is Object, such as an actor's latent UFUNCTIONs or a gameplay ability's
+ *  coroutines. The larger of the two intervals is used.<br>
+ *  Intended to be driven by a significance or LOD system, for instance the
+ *  post-significance function of USignificanceManager. Set it back to 0 when
+ *  the object is no longer managed to free its entry. */
+UE5CORO_API void SetPollInterval(const UObject* Object, double Seconds);
+
+/** Sets the world of the calling coroutine's latent awaiters in async mode,
+ *  instead of using GWorld. Their time is measured in this world, and they're
+ *  resumed by it. Coroutines started by this coroutine inherit its world.<br>
+ *  Latent coroutines always use their latent action's world, and async
+ *  coroutines default to GWorld at their first latent co_await.<br>
+ *  Intended for processes that host multiple game worlds at once, such as
+ *  dedicated servers running several sessions. */
+UE5CORO_API void SetHomeWorld(const UObject* WorldContext);
+
 #pragma endregion
 
 #pragma region Time
@@ -129,6 +231,8 @@ UE5CORO_API Private::FLatentAwaiter UntilAudioTime(double);
  *  with automatic parameter matching.<br>
  *  The result of the co_await expression is true if the chained latent action
  *  finished normally, false if it didn't.<br>
+ *  Delay, LoadStreamLevel, and UnloadStreamLevel are implemented directly,
+ *  without a latent action.<br>
  *  Example usage:<br>
  *  co_await Latent::Chain(&UKismetSystemLibrary::Delay, 1.0f); */
 template<typename... FnParams>
@@ -176,12 +280,35 @@ auto AsyncLoadObjects(const TArray<TSoftObjectPtr<T>>&,
 	-> std::enable_if_t<std::is_base_of_v<UObject, T>,
 	                    Private::TAsyncLoadAwaiter<TArray<T*>, 0>>;
 
+/** Asynchronously starts loading the objects, and yields each of them as soon
+ *  as it's loaded, in the order in which they finish loading.<br>
+ *  This lets work on the first objects start before the entire batch is done.
+ *  Objects that fail to load are skipped. The producer runs on the game
+ *  thread, but the generator may be consumed from any thread.<br>
+ *  Up to Prefetch objects are buffered if the consumer falls behind. */
+template<typename T>
+auto AsyncLoadObjectsProgressive(const TArray<TSoftObjectPtr<T>>&,
+	TAsyncLoadPriority = FStreamableManager::DefaultAsyncLoadPriority,
+	int32 Prefetch = 16)
+	-> std::enable_if_t<std::is_base_of_v<UObject, T>, TAsyncGenerator<T*>>;
+
 /** Asynchronously starts loading the objects at the given paths,
  *  resumes once they're loaded. The loaded objects are not resolved. */
 UE5CORO_API auto AsyncLoadObjects(TArray<FSoftObjectPath>,
 	TAsyncLoadPriority = FStreamableManager::DefaultAsyncLoadPriority)
 	-> Private::FLatentAwaiter;
 
+/** Raises the priority of a pending load of a single object, if it's lower
+ *  than the provided value. This finds loads that were started by
+ *  AsyncLoadObject, AsyncLoadClass, AsyncLoadObjectsProgressive, or any other
+ *  function that was asked to load only this object.<br>
+ *  Returns false if no such load was in progress.<br>
+ *  Loads are also raised to UE5Coro.AsyncLoadAwaitedPriority automatically
+ *  when they're co_awaited, and when another load of the same object is
+ *  requested with a higher priority. */
+UE5CORO_API bool BoostAsyncLoad(const FSoftObjectPath&,
+                                TAsyncLoadPriority Priority);
+
 /** Asynchronously starts loading the primary asset with any bundles specified,
  *  resumes once they're loaded.<br>
  *  The asset will stay in memory until explicitly unloaded. */
@@ -234,6 +361,9 @@ UE5CORO_API auto AsyncLoadClasses(const TArray<TSoftClassPtr<UObject>>&,
 
 /** Asynchronously starts loading the package, resumes once it's loaded.<br>
  *  The result of the co_await expression is the UPackage*.<br>
+ *  This must be called on the game thread, but async mode coroutines may
+ *  co_await the result on any thread, and they will be resumed on the same
+ *  kind of thread when the load completes.<br>
  *  For parameters see the engine function ::LoadPackageAsync(). */
 UE5CORO_API auto AsyncLoadPackage(const FPackagePath& Path,
 	FName PackageNameToCreate = NAME_None,
@@ -244,6 +374,64 @@ UE5CORO_API auto AsyncLoadPackage(const FPackagePath& Path,
 
 #pragma endregion
 
+#pragma region Level streaming
+
+// These bind directly to ULevelStreaming's delegates. Compared to chaining
+// UGameplayStatics::LoadStreamLevel, there's no latent action or chain target,
+// and async coroutines don't need polling while they wait.
+// Levels that are destroyed while being awaited count as finished.
+
+/** Resumes the coroutine once the streaming level is loaded.<br>
+ *  This doesn't request loading by itself, see LoadStreamLevel for that. */
+UE5CORO_API Private::FLatentAwaiter UntilLevelLoaded(ULevelStreaming* Level);
+
+/** Resumes the coroutine once the streaming level is visible.<br>
+ *  This doesn't request loading by itself, see LoadStreamLevel for that. */
+UE5CORO_API Private::FLatentAwaiter UntilLevelVisible(ULevelStreaming* Level);
+
+/** Resumes the coroutine once the streaming level is no longer loaded.<br>
+ *  This doesn't request unloading by itself, see UnloadStreamLevel for that. */
+UE5CORO_API Private::FLatentAwaiter UntilLevelUnloaded(ULevelStreaming* Level);
+
+/** Resumes the coroutine once every provided streaming level is visible.<br>
+ *  The coroutine is resumed only once, after the last level was shown. */
+UE5CORO_API Private::FLatentAwaiter UntilLevelsVisible(
+	TArrayView<ULevelStreaming* const> Levels);
+
+/** Requests the streaming level to be loaded, and optionally shown,
+ *  then resumes the coroutine once that's done. */
+UE5CORO_API Private::FLatentAwaiter LoadStreamLevel(
+	ULevelStreaming* Level, bool bMakeVisibleAfterLoad = true);
+
+/** Requests the streaming level to be unloaded, then resumes the coroutine
+ *  once that's done. */
+UE5CORO_API Private::FLatentAwaiter UnloadStreamLevel(ULevelStreaming* Level);
+
+#pragma endregion
+
+#pragma region Actor spawning
+
+/** Spawns an actor of Class at every transform, spread over multiple frames.
+ *  <br>Class is loaded with AsyncLoadClass first if needed. Spawning starts on
+ *  the next tick, and stops each frame after BudgetMs milliseconds, or when
+ *  UE5Coro.LatentResumeBudget runs out, whichever comes first.
+ *  At least one actor is spawned per frame.<br>
+ *  The result is the spawned actors in the order of Transforms, with nullptr
+ *  for those that failed to spawn or were destroyed before the last one was
+ *  spawned. It's empty if Class could not be loaded.
+ *  Actors are no longer spawned if the world is destroyed midway. */
+UE5CORO_API TCoroutine<TArray<AActor*>> SpawnActorsAmortized(
+	UWorld* World, TSoftClassPtr<AActor> Class,
+	TArrayView<const FTransform> Transforms, double BudgetMs = 1);
+
+/** Like the overload above, with custom spawn parameters for every actor. */
+UE5CORO_API TCoroutine<TArray<AActor*>> SpawnActorsAmortized(
+	UWorld* World, TSoftClassPtr<AActor> Class,
+	TArrayView<const FTransform> Transforms, double BudgetMs,
+	const FActorSpawnParameters& Params);
+
+#pragma endregion
+
 #pragma region Async collision queries
 
 // Async UWorld queries. For parameters, see their originals in World.h.
@@ -288,6 +476,83 @@ UE5CORO_API Private::TAsyncQueryAwaiter<FHitResult> AsyncSweepByProfile(
 	FName ProfileName, const FCollisionShape& CollisionShape,
 	const FCollisionQueryParams& Params = FCollisionQueryParams::DefaultQueryParam);
 
+/** Like AsyncLineTraceByChannel with EAsyncTraceType::Single, but the result
+ *  of the co_await expression is the blocking hit, if there was one.<br>
+ *  The state of the query is pooled, so this does not allocate memory in
+ *  UE5Coro. */
+UE5CORO_API Private::FAsyncSingleTraceAwaiter AsyncLineTraceSingleByChannel(
+	const UObject* WorldContextObject, const FVector& Start, const FVector& End,
+	ECollisionChannel TraceChannel,
+	const FCollisionQueryParams& Params = FCollisionQueryParams::DefaultQueryParam,
+	const FCollisionResponseParams& ResponseParam =
+		FCollisionResponseParams::DefaultResponseParam);
+
+/** Like AsyncLineTraceByChannel, but the results are stored in OutHits,
+ *  reusing its existing storage. The co_await expression has no value.<br>
+ *  OutHits must remain valid until the co_await finishes, or the awaiter is
+ *  destroyed without being co_awaited. */
+template<typename A>
+Private::FAsyncTraceIntoAwaiter AsyncLineTraceByChannel(
+	const UObject* WorldContextObject, EAsyncTraceType InTraceType,
+	const FVector& Start, const FVector& End, ECollisionChannel TraceChannel,
+	TArray<FHitResult, A>& OutHits,
+	const FCollisionQueryParams& Params = FCollisionQueryParams::DefaultQueryParam,
+	const FCollisionResponseParams& ResponseParam =
+		FCollisionResponseParams::DefaultResponseParam);
+
+/** One line trace within AsyncLineTraceBatch. */
+struct FTraceRequest
+{
+	FVector Start;
+	FVector End;
+	ECollisionChannel TraceChannel = ECC_Visibility;
+};
+
+/** Results of AsyncLineTraceBatch, stored in one contiguous array. */
+struct FTraceBatchResults
+{
+	/** Every hit of every trace, grouped by trace, in the order of requests. */
+	TArray<FHitResult> Hits;
+	/** Trace i's hits are Hits[Offsets[i]] until Hits[Offsets[i + 1]]. */
+	TArray<int32> Offsets{0};
+
+	/** Returns the number of traces. */
+	int32 Num() const { return Offsets.Num() - 1; }
+
+	/** Returns the hits of the trace at the given index. */
+	TArrayView<const FHitResult> operator[](int32 Index) const
+	{
+		return TArrayView<const FHitResult>(Hits).Slice(
+			Offsets[Index], Offsets[Index + 1] - Offsets[Index]);
+	}
+};
+
+/** Starts every line trace in Requests at once, and resumes after they all
+ *  finished. Params and ResponseParam are shared by every trace.<br>
+ *  Compared to separate AsyncLineTraceByChannel calls, this only has one
+ *  delegate and one allocation for the entire batch.<br>
+ *  The result of the co_await expression is FTraceBatchResults.
+ *  The awaiter may only be co_awaited once, since the results are moved out. */
+UE5CORO_API Private::FAsyncTraceBatchAwaiter AsyncLineTraceBatch(
+	const UObject* WorldContextObject, EAsyncTraceType InTraceType,
+	TArrayView<const FTraceRequest> Requests,
+	const FCollisionQueryParams& Params = FCollisionQueryParams::DefaultQueryParam,
+	const FCollisionResponseParams& ResponseParam =
+		FCollisionResponseParams::DefaultResponseParam);
+
+/** Like AsyncLineTraceByChannel, but this may be called and co_awaited on any
+ *  thread, without moving to the game thread first.<br>
+ *  The trace is buffered, and submitted to the world on the game thread's next
+ *  tick. The coroutine resumes on the thread that it co_awaited from.<br>
+ *  If WorldContextObject's world is gone by the time the trace would be
+ *  submitted, the result is an empty array. */
+UE5CORO_API Private::FAnyThreadTraceAwaiter AsyncLineTraceByChannelAnyThread(
+	const UObject* WorldContextObject, EAsyncTraceType InTraceType,
+	const FVector& Start, const FVector& End, ECollisionChannel TraceChannel,
+	const FCollisionQueryParams& Params = FCollisionQueryParams::DefaultQueryParam,
+	const FCollisionResponseParams& ResponseParam =
+		FCollisionResponseParams::DefaultResponseParam);
+
 UE5CORO_API Private::TAsyncQueryAwaiter<FOverlapResult> AsyncOverlapByChannel(
 	const UObject* WorldContextObject, const FVector& Pos, const FQuat& Rot,
 	ECollisionChannel TraceChannel, const FCollisionShape& CollisionShape,
@@ -327,18 +592,85 @@ public:
 	void await_resume() noexcept { }
 };
 
+class [[nodiscard]] UE5CORO_API FTickGroupAwaiter
+	: public TAwaiter<FTickGroupAwaiter>
+{
+	friend UUE5CoroSubsystem;
+
+	ETickingGroup Group;
+	UUE5CoroSubsystem* Subsystem = nullptr;
+	FPromise* Promise = nullptr;
+
+public:
+	explicit FTickGroupAwaiter(ETickingGroup Group) : Group(Group) { }
+	FTickGroupAwaiter(const FTickGroupAwaiter& Other) : Group(Other.Group) { }
+	~FTickGroupAwaiter();
+
+	void Suspend(FPromise&);
+};
+
 class [[nodiscard]] UE5CORO_API FLatentAwaiter // not TAwaiter
 {
+	friend struct FLatentDeadline;
+	friend struct FLatentReadyCallback;
+
 	void Suspend(FAsyncPromise&);
 	void Suspend(FLatentPromise&);
 
+	static constexpr size_t InlineSize = 4 * sizeof(void*);
+
+	template<typename T>
+	static constexpr bool bStoredInline =
+		sizeof(T) <= InlineSize && alignof(T) <= alignof(void*) &&
+		std::is_nothrow_move_constructible_v<T>;
+
+	template<typename T>
+	static void RelocateState(void* From, void* To) noexcept
+	{
+		auto* Ptr = static_cast<T*>(From);
+		new (To) T(std::move(*Ptr));
+		Ptr->~T();
+	}
+
 protected:
 	void* State;
 	bool (*Resume)(void* State, bool bCleanup);
+	// Only set if State points to InlineState
+	void (*Relocate)(void* From, void* To) noexcept = nullptr;
+	alignas(void*) unsigned char InlineState[InlineSize];
 
 public:
 	explicit FLatentAwaiter(void* State, bool (*Resume)(void*, bool)) noexcept
 		: State(State), Resume(Resume) { }
+
+	/** Stores a T constructed from Args in the awaiter itself if it's small
+	 *  enough, on the heap otherwise.<br>
+	 *  Resume receives a T* either way, and needs to call DestroyState<T> on
+	 *  it when cleaning up. */
+	template<typename T, typename... A>
+	explicit FLatentAwaiter(std::in_place_type_t<T>,
+	                        bool (*Resume)(void*, bool), A&&... Args)
+		: Resume(Resume)
+	{
+		if constexpr (bStoredInline<T>)
+		{
+			State = new (InlineState) T(std::forward<A>(Args)...);
+			Relocate = &RelocateState<T>;
+		}
+		else
+			State = new T(std::forward<A>(Args)...);
+	}
+
+	/** Destroys state that was created by the in_place_type constructor. */
+	template<typename T>
+	static void DestroyState(void* State) noexcept
+	{
+		if constexpr (bStoredInline<T>)
+			static_cast<T*>(State)->~T();
+		else
+			delete static_cast<T*>(State);
+	}
+
 	FLatentAwaiter(const FLatentAwaiter&) = delete;
 	FLatentAwaiter(FLatentAwaiter&&) noexcept;
 	~FLatentAwaiter();
@@ -361,6 +693,8 @@ namespace AsyncLoad
 {
 template<int> // Switches between non-exported types
 UE5CORO_API TArray<UObject*> InternalResume(void*);
+template<int>
+UE5CORO_API void Boost(void*, TAsyncLoadPriority);
 }
 
 template<typename T, int HiddenType>
@@ -371,6 +705,14 @@ public:
 		: FLatentAwaiter(std::move(Other)) { }
 	TAsyncLoadAwaiter(TAsyncLoadAwaiter&&) noexcept = default;
 
+	/** Raises the priority of the load to at least the provided value, if it
+	 *  hasn't finished yet. Other awaiters sharing the same load are also
+	 *  affected. */
+	void Boost(TAsyncLoadPriority Priority)
+	{
+		AsyncLoad::Boost<HiddenType>(State, Priority);
+	}
+
 	T await_resume()
 	{
 		TArray<UObject*> Assets = AsyncLoad::InternalResume<HiddenType>(State);
@@ -403,16 +745,63 @@ static_assert(sizeof(FLatentAwaiter) ==
 static_assert(sizeof(FLatentAwaiter) ==
               sizeof(TAsyncLoadAwaiter<TArray<UObject*>, 0>));
 
+/** Loads objects with a separate handle for each of them, and reports them
+ *  one by one as they finish. */
+class [[nodiscard]] UE5CORO_API FAsyncLoadProgress final
+{
+	TSharedPtr<FAsyncLoadProgressState, ESPMode::NotThreadSafe> State;
+
+public:
+	explicit FAsyncLoadProgress(TArray<FSoftObjectPath> Paths,
+	                            TAsyncLoadPriority Priority);
+	FAsyncLoadProgress(FAsyncLoadProgress&&) = default;
+	FAsyncLoadProgress(const FAsyncLoadProgress&) = delete;
+	FAsyncLoadProgress& operator=(const FAsyncLoadProgress&) = delete;
+	~FAsyncLoadProgress();
+
+	/** The result of the co_await expression is the next loaded object,
+	 *  nullptr if it failed to load, or an empty TOptional at the end. */
+	FAsyncLoadProgressAwaiter Next();
+};
+
+class [[nodiscard]] UE5CORO_API FAsyncLoadProgressAwaiter
+	: public TAwaiter<FAsyncLoadProgressAwaiter>
+{
+	TSharedPtr<FAsyncLoadProgressState, ESPMode::NotThreadSafe> State;
+
+public:
+	explicit FAsyncLoadProgressAwaiter(
+		TSharedPtr<FAsyncLoadProgressState, ESPMode::NotThreadSafe> State)
+		: State(std::move(State)) { }
+
+	bool await_ready();
+	void Suspend(FPromise&);
+	TOptional<UObject*> await_resume();
+};
+
+template<typename T>
+TCoroutine<> AsyncLoadProgressive(TAsyncGeneratorSink<T*> Sink,
+                                  FAsyncLoadProgress Progress)
+{
+	while (TOptional<UObject*> Object = co_await Progress.Next())
+		if (T* Typed = Cast<T>(*Object))
+			co_await Sink.Yield(Typed);
+}
+
 class [[nodiscard]] UE5CORO_API FPackageLoadAwaiter
 	: public TAwaiter<FPackageLoadAwaiter>
 {
 	struct FState
 	{
+		FMutex Lock;
 		FPromise* Promise = nullptr;
+		ENamedThreads::Type Thread = ENamedThreads::GameThread;
+		bool bLoaded = false;
+		// end Lock
 		TStrongObjectPtr<UPackage> Result; // This might be carried across co_awaits
 		void Loaded(const FName&, UPackage*, EAsyncLoadingResult::Type);
 	};
-	TSharedPtr<FState, ESPMode::NotThreadSafe> State;
+	TSharedPtr<FState> State;
 
 public:
 	explicit FPackageLoadAwaiter(
@@ -420,6 +809,9 @@ public:
 		EPackageFlags PackageFlags, int32 PIEInstanceID,
 		TAsyncLoadPriority PackagePriority,
 		const FLinkerInstancingContext* InstancingContext);
+	FPackageLoadAwaiter(const FPackageLoadAwaiter&) = default;
+	FPackageLoadAwaiter(FPackageLoadAwaiter&&) = default;
+	~FPackageLoadAwaiter();
 
 	bool await_ready();
 	void Suspend(FPromise&);
@@ -447,6 +839,108 @@ public:
 	const TArray<T>& await_resume();
 };
 
+class [[nodiscard]] UE5CORO_API FAsyncTraceSlotAwaiter // not TAwaiter
+{
+protected:
+	FAsyncTraceSlot* Slot;
+
+	explicit FAsyncTraceSlotAwaiter(
+		const UObject* WorldContextObject, EAsyncTraceType, const FVector&,
+		const FVector&, ECollisionChannel, const FCollisionQueryParams&,
+		const FCollisionResponseParams&, void* Out,
+		void (*Store)(void* Out, TArray<FHitResult>& Hits));
+
+public:
+	FAsyncTraceSlotAwaiter(FAsyncTraceSlotAwaiter&&) noexcept;
+	FAsyncTraceSlotAwaiter(const FAsyncTraceSlotAwaiter&) = delete;
+	FAsyncTraceSlotAwaiter& operator=(const FAsyncTraceSlotAwaiter&) = delete;
+	~FAsyncTraceSlotAwaiter();
+
+	bool await_ready();
+
+	template<typename P>
+	auto await_suspend(stdcoro::coroutine_handle<P> Handle)
+		-> std::enable_if_t<std::is_base_of_v<FPromise, P>>
+	{
+		Suspend(Handle.promise());
+	}
+
+private:
+	void Suspend(FPromise&);
+};
+
+class [[nodiscard]] UE5CORO_API FAsyncSingleTraceAwaiter
+	: public FAsyncTraceSlotAwaiter
+{
+public:
+	explicit FAsyncSingleTraceAwaiter(
+		const UObject* WorldContextObject, const FVector& Start,
+		const FVector& End, ECollisionChannel TraceChannel,
+		const FCollisionQueryParams& Params,
+		const FCollisionResponseParams& ResponseParam);
+
+	TOptional<FHitResult> await_resume();
+};
+
+class [[nodiscard]] FAsyncTraceIntoAwaiter : public FAsyncTraceSlotAwaiter
+{
+public:
+	template<typename A>
+	explicit FAsyncTraceIntoAwaiter(
+		const UObject* WorldContextObject, EAsyncTraceType InTraceType,
+		const FVector& Start, const FVector& End,
+		ECollisionChannel TraceChannel, TArray<FHitResult, A>& OutHits,
+		const FCollisionQueryParams& Params,
+		const FCollisionResponseParams& ResponseParam)
+		: FAsyncTraceSlotAwaiter(WorldContextObject, InTraceType, Start, End,
+		                         TraceChannel, Params, ResponseParam, &OutHits,
+		                         [](void* Out, TArray<FHitResult>& Hits)
+		{
+			auto& Array = *static_cast<TArray<FHitResult, A>*>(Out);
+			Array.Reset(); // Keep the existing capacity
+			for (auto& Hit : Hits)
+				Array.Add(std::move(Hit));
+		}) { }
+
+	void await_resume() noexcept { }
+};
+
+class [[nodiscard]] UE5CORO_API FAnyThreadTraceAwaiter
+	: public TAwaiter<FAnyThreadTraceAwaiter>
+{
+public:
+	struct FState;
+
+private:
+	TSharedPtr<FState> State;
+
+public:
+	explicit FAnyThreadTraceAwaiter(
+		const UObject* WorldContextObject, EAsyncTraceType InTraceType,
+		const FVector& Start, const FVector& End,
+		ECollisionChannel TraceChannel, const FCollisionQueryParams& Params,
+		const FCollisionResponseParams& ResponseParam);
+
+	bool await_ready();
+	void Suspend(FPromise&);
+	const TArray<FHitResult>& await_resume();
+};
+
+class [[nodiscard]] UE5CORO_API FAsyncTraceBatchAwaiter
+	: public TAwaiter<FAsyncTraceBatchAwaiter>
+{
+	TSharedPtr<FAsyncTraceBatchState, ESPMode::NotThreadSafe> State;
+
+public:
+	explicit FAsyncTraceBatchAwaiter(
+		UWorld*, EAsyncTraceType, TArrayView<const Latent::FTraceRequest>,
+		const FCollisionQueryParams&, const FCollisionResponseParams&);
+
+	bool await_ready();
+	void Suspend(FPromise&);
+	Latent::FTraceBatchResults await_resume();
+};
+
 template<typename T>
 class [[nodiscard]] UE5CORO_API TAsyncQueryAwaiterRV
 	: public TAsyncQueryAwaiter<T>
@@ -455,6 +949,58 @@ public:
 	TAsyncQueryAwaiterRV() = delete; // Objects of this type are never created
 	TArray<T> await_resume();
 };
+
+template<typename F>
+bool PollPredicate(void* State, bool bCleanup)
+{
+	if (UNLIKELY(bCleanup))
+	{
+		FLatentAwaiter::DestroyState<F>(State);
+		return false;
+	}
+	return std::invoke(*static_cast<F*>(State));
+}
+
+template<typename F>
+struct TUntilTimeoutState
+{
+	F Function;
+	double Deadline;
+	bool bSucceeded = false;
+
+	template<typename T>
+	explicit TUntilTimeoutState(T&& Function, double Deadline)
+		: Function(std::forward<T>(Function)), Deadline(Deadline) { }
+
+	static bool Poll(void* State, bool bCleanup)
+	{
+		if (UNLIKELY(bCleanup))
+		{
+			FLatentAwaiter::DestroyState<TUntilTimeoutState>(State);
+			return false;
+		}
+		auto* This = static_cast<TUntilTimeoutState*>(State);
+		if (This->bSucceeded || std::invoke(This->Function))
+			return This->bSucceeded = true;
+		return IsGameTimePast(This->Deadline);
+	}
+};
+
+template<typename F>
+class [[nodiscard]] TUntilTimeoutAwaiter : public FLatentAwaiter
+{
+public:
+	template<typename T>
+	explicit TUntilTimeoutAwaiter(T&& Function, double Deadline)
+		: FLatentAwaiter(std::in_place_type<TUntilTimeoutState<F>>,
+		                 &TUntilTimeoutState<F>::Poll,
+		                 std::forward<T>(Function), Deadline) { }
+
+	bool await_resume()
+	{
+		return static_cast<TUntilTimeoutState<F>*>(State)->bSucceeded;
+	}
+};
 }
 
 inline UE5Coro::Private::FLatentCancellation UE5Coro::Latent::Cancel() noexcept
@@ -462,12 +1008,32 @@ inline UE5Coro::Private::FLatentCancellation UE5Coro::Latent::Cancel() noexcept
 	return {};
 }
 
+template<typename F>
+auto UE5Coro::Latent::Until(F&& Function)
+	-> std::enable_if_t<Private::TIsInlinePredicate<F>, Private::FLatentAwaiter>
+{
+	using FFunction = std::decay_t<F>;
+	return Private::FLatentAwaiter(std::in_place_type<FFunction>,
+	                               &Private::PollPredicate<FFunction>,
+	                               std::forward<F>(Function));
+}
+
+template<typename F>
+auto UE5Coro::Latent::UntilWithTimeout(F&& Function, double Seconds)
+	-> std::enable_if_t<Private::TIsInlinePredicate<F>,
+	                    Private::TUntilTimeoutAwaiter<std::decay_t<F>>>
+{
+	return Private::TUntilTimeoutAwaiter<std::decay_t<F>>(
+		std::forward<F>(Function), Private::GameTimeAfter(Seconds));
+}
+
 template<typename T>
 auto UE5Coro::Latent::UntilDelegate(T& Delegate)
 	-> std::enable_if_t<Private::TIsDelegate<T>, Private::FLatentAwaiter>
 {
 	using namespace UE5Coro::Private;
-	auto [Awaiter, Target] = UntilDelegateCore();
+	auto [Awaiter, Target] = UntilDelegateCore(&Delegate,
+	                                           &UnbindCallbackTarget<T>);
 
 	if constexpr (TIsMulticastDelegate<T>)
 	{
@@ -511,6 +1077,38 @@ auto UE5Coro::Latent::AsyncLoadObjects(const TArray<TSoftObjectPtr<T>>& Ptrs,
 		AsyncLoadObjects(std::move(Paths), Priority));
 }
 
+template<typename A>
+UE5Coro::Private::FAsyncTraceIntoAwaiter
+UE5Coro::Latent::AsyncLineTraceByChannel(
+	const UObject* WorldContextObject, EAsyncTraceType InTraceType,
+	const FVector& Start, const FVector& End, ECollisionChannel TraceChannel,
+	TArray<FHitResult, A>& OutHits, const FCollisionQueryParams& Params,
+	const FCollisionResponseParams& ResponseParam)
+{
+	return Private::FAsyncTraceIntoAwaiter(WorldContextObject, InTraceType,
+	                                       Start, End, TraceChannel, OutHits,
+	                                       Params, ResponseParam);
+}
+
+template<typename T>
+auto UE5Coro::Latent::AsyncLoadObjectsProgressive(
+	const TArray<TSoftObjectPtr<T>>& Ptrs, TAsyncLoadPriority Priority,
+	int32 Prefetch)
+	-> std::enable_if_t<std::is_base_of_v<UObject, T>, TAsyncGenerator<T*>>
+{
+	TArray<FSoftObjectPath> Paths;
+	Paths.Reserve(Ptrs.Num());
+	for (const auto& Ptr : Ptrs)
+		Paths.Add(Ptr.ToSoftObjectPath());
+
+	return TAsyncGenerator<T*>([&](TAsyncGeneratorSink<T*> Sink)
+	{
+		return Private::AsyncLoadProgressive<T>(
+			std::move(Sink),
+			Private::FAsyncLoadProgress(std::move(Paths), Priority));
+	}, Prefetch);
+}
+
 template<typename T>
 auto UE5Coro::Latent::AsyncLoadPrimaryAsset(FPrimaryAssetId AssetToLoad,
                                             const TArray<FName>& LoadBundles,
@@ -49,6 +49,9 @@ class [[nodiscard]] UE5CORO_API FLatentChainAwaiter : public FLatentAwaiter
 {
 public:
 	explicit FLatentChainAwaiter(FTwoLives* Done) noexcept;
+	/** Wraps an awaiter that replaces the chained latent action entirely.
+	 *  These always finish normally. */
+	explicit FLatentChainAwaiter(FLatentAwaiter&& Direct) noexcept;
 	FLatentChainAwaiter(FLatentChainAwaiter&&) noexcept = default;
 	bool await_resume();
 };
@@ -65,6 +68,21 @@ concept TWorldContext = std::same_as<std::decay_t<T>, UObject*> ||
 template<typename T>
 concept TLatentInfo = std::same_as<std::decay_t<T>, FLatentActionInfo>;
 
+// Chain checks calls with these signatures against a few commonly-used engine
+// functions, and implements those directly instead of through the latent
+// action manager and a callback target. These return an empty TOptional for
+// everything else, including calls that only the engine can handle.
+using FChainDelay = void (*)(const UObject*, float, FLatentActionInfo);
+using FChainLoadStreamLevel = void (*)(const UObject*, FName, bool, bool,
+                                       FLatentActionInfo);
+using FChainUnloadStreamLevel = void (*)(const UObject*, FName,
+                                         FLatentActionInfo, bool);
+UE5CORO_API TOptional<FLatentChainAwaiter> ChainDirect(FChainDelay, float);
+UE5CORO_API TOptional<FLatentChainAwaiter> ChainDirect(FChainLoadStreamLevel,
+                                                       FName, bool, bool);
+UE5CORO_API TOptional<FLatentChainAwaiter> ChainDirect(FChainUnloadStreamLevel,
+                                                       FName, bool);
+
 template<typename T>
 using TForwardRef =
 	std::conditional_t<std::is_lvalue_reference_v<T>,
@@ -90,9 +108,10 @@ struct FLatentChain<true, bInfo, Type, Types...>
 {
 	static void Call(auto&& Fn, FLatentActionInfo LatentInfo, auto&&... Args)
 	{
-		checkf(GWorld, TEXT("Could not chain latent action: no world found"));
+		auto* World = GetLatentWorld();
+		checkf(World, TEXT("Could not chain latent action: no world found"));
 		FLatentChain<false, bInfo, Types...>::Call(
-			std::bind_front(std::move(Fn), &*GWorld),
+			std::bind_front(std::move(Fn), World),
 			LatentInfo,
 			TForwardRef<decltype(Args)>(Args)...);
 	}
@@ -153,6 +172,9 @@ Private::FLatentChainAwaiter Chain(auto (*Function)(FnParams...), auto&&... Args
 {
 	checkf(IsInGameThread(),
 	       TEXT("Latent awaiters may only be used on the game thread"));
+	if constexpr (requires { Private::ChainDirect(Function, Args...); })
+		if (auto Direct = Private::ChainDirect(Function, Args...))
+			return std::move(*Direct);
 	auto [LatentInfo, Done] = Private::MakeLatentInfo();
 	Private::FLatentChain<true, true, FnParams...>::Call(
 		Function,
@@ -185,15 +207,16 @@ Private::FLatentChainAwaiter ChainEx(F&& Function, A&&... Args)
 {
 	checkf(IsInGameThread(),
 	       TEXT("Latent awaiters may only be used on the game thread"));
+	auto* World = Private::GetLatentWorld();
 	if constexpr ((... || (std::is_placeholder_v<std::decay_t<A>> == 1)))
-		checkf(GWorld,
+		checkf(World,
 		       TEXT("Could not chain latent action: no world found for _1"));
 	static_assert((... || (std::is_placeholder_v<std::decay_t<A>> == 2)),
 	              "The _2 parameter for LatentInfo is mandatory");
 
 	auto [LatentInfo, Done] = Private::MakeLatentInfo();
 	std::bind(std::forward<F>(Function),
-	          std::forward<A>(Args)...)(&*GWorld, LatentInfo);
+	          std::forward<A>(Args)...)(World, LatentInfo);
 	return Private::FLatentChainAwaiter(Done);
 }
 }
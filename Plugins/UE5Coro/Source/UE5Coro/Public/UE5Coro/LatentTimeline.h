@@ -34,10 +34,29 @@
 #include "CoreMinimal.h"
 #include "UE5Coro/Definitions.h"
 #include <functional>
+#include "Curves/CurveFloat.h"
+#include "Kismet/KismetMathLibrary.h"
 #include "UE5Coro/Coroutine.h"
 
 namespace UE5Coro::Latent
 {
+/** Shapes how timelines move from From to To.<br>
+ *  Curves are sampled with the timeline's linear progress, from 0 to 1.
+ *  If the curve is destroyed, the timeline falls back to linear. */
+struct FTimelineEasing
+{
+	EEasingFunc::Type Function = EEasingFunc::Linear;
+	double BlendExp = 2;
+	int32 Steps = 2;
+	TWeakObjectPtr<const UCurveFloat> Curve;
+
+	FTimelineEasing() = default;
+	FTimelineEasing(EEasingFunc::Type Function, double BlendExp = 2,
+	                int32 Steps = 2)
+		: Function(Function), BlendExp(BlendExp), Steps(Steps) { }
+	FTimelineEasing(const UCurveFloat* Curve) : Curve(Curve) { }
+};
+
 /** Repeatedly calls the provided function with linearly-interpolated values. */
 UE5CORO_API TCoroutine<> Timeline(const UObject* WorldContextObject,
                                   double From, double To, double Length,
@@ -64,4 +83,113 @@ UE5CORO_API TCoroutine<> AudioTimeline(const UObject* WorldContextObject,
                                        double From, double To, double Length,
                                        std::function<void(double)> Fn,
                                        bool bRunWhenPaused = false);
+
+/** Repeatedly calls the provided function with eased values. */
+UE5CORO_API TCoroutine<> Timeline(const UObject* WorldContextObject,
+                                  double From, double To, double Length,
+                                  FTimelineEasing Easing,
+                                  std::function<void(double)> Fn,
+                                  bool bRunWhenPaused = false);
+
+/** Repeatedly calls the provided function with eased values.<br>
+ *  This is affected by time dilation only, NOT pause. */
+UE5CORO_API TCoroutine<> UnpausedTimeline(const UObject* WorldContextObject,
+                                          double From, double To, double Length,
+                                          FTimelineEasing Easing,
+                                          std::function<void(double)> Fn,
+                                          bool bRunWhenPaused = true);
+
+/** Repeatedly calls the provided function with eased values.<br>
+ *  This is not affected by pause or time dilation. */
+UE5CORO_API TCoroutine<> RealTimeline(const UObject* WorldContextObject,
+                                      double From, double To, double Length,
+                                      FTimelineEasing Easing,
+                                      std::function<void(double)> Fn,
+                                      bool bRunWhenPaused = true);
+
+/** Repeatedly calls the provided function with eased values.<br>
+ *  This is affected by pause only, NOT time dilation. */
+UE5CORO_API TCoroutine<> AudioTimeline(const UObject* WorldContextObject,
+                                       double From, double To, double Length,
+                                       FTimelineEasing Easing,
+                                       std::function<void(double)> Fn,
+                                       bool bRunWhenPaused = false);
+
+/** Repeatedly writes interpolated values into Target, without a callback.<br>
+ *  T may be float, double, FVector, or FLinearColor.<br>
+ *  Target must remain valid until the coroutine completes. */
+template<typename T>
+UE5CORO_API TCoroutine<> Timeline(const UObject* WorldContextObject,
+                                  T& Target, const T& From, const T& To,
+                                  double Length, FTimelineEasing Easing = {},
+                                  bool bRunWhenPaused = false);
+
+/** Repeatedly writes interpolated values into Target, without a callback.<br>
+ *  This is affected by time dilation only, NOT pause.
+ *  @see Timeline for the supported types of T. */
+template<typename T>
+UE5CORO_API TCoroutine<> UnpausedTimeline(const UObject* WorldContextObject,
+                                          T& Target, const T& From,
+                                          const T& To, double Length,
+                                          FTimelineEasing Easing = {},
+                                          bool bRunWhenPaused = true);
+
+/** Repeatedly writes interpolated values into Target, without a callback.<br>
+ *  This is not affected by pause or time dilation.
+ *  @see Timeline for the supported types of T. */
+template<typename T>
+UE5CORO_API TCoroutine<> RealTimeline(const UObject* WorldContextObject,
+                                      T& Target, const T& From, const T& To,
+                                      double Length, FTimelineEasing Easing = {},
+                                      bool bRunWhenPaused = true);
+
+/** Repeatedly writes interpolated values into Target, without a callback.<br>
+ *  This is affected by pause only, NOT time dilation.
+ *  @see Timeline for the supported types of T. */
+template<typename T>
+UE5CORO_API TCoroutine<> AudioTimeline(const UObject* WorldContextObject,
+                                       T& Target, const T& From, const T& To,
+                                       double Length, FTimelineEasing Easing = {},
+                                       bool bRunWhenPaused = false);
+
+/** Repeatedly writes interpolated values into a property of Object.<br>
+ *  T may be float, double, FVector, or FLinearColor, and it must match the
+ *  property's type. Writes stop if Object is destroyed. */
+template<typename T>
+UE5CORO_API TCoroutine<> Timeline(const UObject* WorldContextObject,
+                                  UObject* Object, FName PropertyName,
+                                  const T& From, const T& To, double Length,
+                                  FTimelineEasing Easing = {},
+                                  bool bRunWhenPaused = false);
+
+/** Repeatedly writes interpolated values into a property of Object.<br>
+ *  This is affected by time dilation only, NOT pause.
+ *  @see Timeline for the supported types of T. */
+template<typename T>
+UE5CORO_API TCoroutine<> UnpausedTimeline(const UObject* WorldContextObject,
+                                          UObject* Object, FName PropertyName,
+                                          const T& From, const T& To,
+                                          double Length,
+                                          FTimelineEasing Easing = {},
+                                          bool bRunWhenPaused = true);
+
+/** Repeatedly writes interpolated values into a property of Object.<br>
+ *  This is not affected by pause or time dilation.
+ *  @see Timeline for the supported types of T. */
+template<typename T>
+UE5CORO_API TCoroutine<> RealTimeline(const UObject* WorldContextObject,
+                                      UObject* Object, FName PropertyName,
+                                      const T& From, const T& To,
+                                      double Length, FTimelineEasing Easing = {},
+                                      bool bRunWhenPaused = true);
+
+/** Repeatedly writes interpolated values into a property of Object.<br>
+ *  This is affected by pause only, NOT time dilation.
+ *  @see Timeline for the supported types of T. */
+template<typename T>
+UE5CORO_API TCoroutine<> AudioTimeline(const UObject* WorldContextObject,
+                                       UObject* Object, FName PropertyName,
+                                       const T& From, const T& To,
+                                       double Length, FTimelineEasing Easing = {},
+                                       bool bRunWhenPaused = false);
 }
@@ -0,0 +1,533 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UE5Coro/Definitions.h"
+#include "UE5Coro/Coroutine.h"
+#include "UE5Coro/FrameAllocator.h"
+#if !PLATFORM_EXCEPTIONS_DISABLED
+#include <exception>
+#endif
+
+namespace UE5Coro
+{
+namespace Private
+{
+template<typename> class TLazyAwaiter;
+template<typename> class TLazyPromise;
+template<typename> class TLazyPromiseBase;
+}
+
+/**
+ * Coroutine that only starts running when it's co_awaited, then runs inline
+ * in the awaiting coroutine until it completes.<br>
+ * This is meant for splitting hot coroutine code into smaller helpers without
+ * paying for a full TCoroutine per call: there is no shared state, completion
+ * event, or continuation storage, only the coroutine frame itself.<br>
+ * Anything else that they co_await is awaited on behalf of the TCoroutine
+ * running them: if that suspends, the TCoroutine is suspended instead, and the
+ * lazy coroutine continues when it's resumed.
+ * TCoroutines and other coroutines can co_await them directly, but lazy
+ * coroutines that are not running in a TCoroutine may not suspend.
+ * An object that's destroyed without being awaited never runs its coroutine.
+ * @tparam T Optional return value of the coroutine. @p void if not provided.
+ */
+template<typename T = void>
+class [[nodiscard]] TLazyCoroutine
+{
+public:
+	using promise_type = Private::TLazyPromise<T>;
+
+private:
+	friend Private::TLazyPromiseBase<T>;
+	Private::stdcoro::coroutine_handle<promise_type> Handle;
+
+	explicit TLazyCoroutine(
+		Private::stdcoro::coroutine_handle<promise_type> Handle) noexcept
+		: Handle(Handle) { }
+
+	static TCoroutine<T> Escape(TLazyCoroutine Lazy)
+	{
+		if constexpr (std::is_void_v<T>)
+			co_await std::move(Lazy);
+		else
+			co_return co_await std::move(Lazy);
+	}
+
+public:
+	TLazyCoroutine(TLazyCoroutine&& Other) noexcept
+		: Handle(std::exchange(Other.Handle, nullptr)) { }
+
+	~TLazyCoroutine()
+	{
+		if (Handle)
+			Handle.destroy();
+	}
+
+	TLazyCoroutine(const TLazyCoroutine&) = delete;
+	TLazyCoroutine& operator=(const TLazyCoroutine&) = delete;
+	TLazyCoroutine& operator=(TLazyCoroutine&&) = delete;
+
+	/** Runs the lazy coroutine in a regular TCoroutine, which may be stored
+	 *  and used like any other.<br>
+	 *  This is the only way for lazy coroutines to pay TCoroutine's costs. */
+	TCoroutine<T> Start() && { return Escape(std::move(*this)); }
+
+	Private::TLazyAwaiter<T> operator co_await() && noexcept
+	{
+		checkf(Handle && !Handle.done(),
+		       TEXT("Attempting to co_await a lazy coroutine twice"));
+		return Private::TLazyAwaiter<T>(Handle);
+	}
+};
+}
+
+namespace UE5Coro::Private
+{
+/** The part of lazy promises that doesn't depend on their return type. */
+struct [[nodiscard]] FLazyPromiseBase
+{
+	// The UE5Coro coroutine that this is ultimately running in. It's the one
+	// that's suspended when something is co_awaited here, null if none.
+	FPromise* Parent = nullptr;
+	// The lazy coroutine co_awaiting this one, if any
+	FLazyPromiseBase* Outer = nullptr;
+	bool bLatentParent = false;
+#if !UE5CORO_PRIVATE_SYMMETRIC_TRANSFER
+	// Set once this suspended, it resumes its awaiter itself from then on
+	bool bSuspended = false;
+	// Tells the TLazyAwaiter running this that it suspended
+	bool* bAwaiterSuspended = nullptr;
+#endif
+
+	template<typename P>
+	void Attach(P& Awaiting)
+	{
+		if constexpr (std::is_base_of_v<FPromise, P>)
+		{
+			Parent = &Awaiting;
+			bLatentParent = std::is_base_of_v<FLatentPromise, P>;
+		}
+		else if constexpr (std::is_base_of_v<FLazyPromiseBase, P>)
+		{
+			Parent = Awaiting.Parent;
+			Outer = &Awaiting;
+			bLatentParent = Awaiting.bLatentParent;
+		}
+	}
+
+	/** Makes the next resume of Parent continue in Handle. This must be
+	 *  called before anything else could resume Parent. */
+	void BeginSuspend(stdcoro::coroutine_handle<> Handle)
+	{
+		checkf(Parent, TEXT("Lazy coroutines can only suspend in a TCoroutine, ")
+		               TEXT("use Start() to run them in one"));
+		Parent->LazyResume = Handle;
+#if !UE5CORO_PRIVATE_SYMMETRIC_TRANSFER
+		// Every awaiter in the chain is suspended with this one
+		for (auto* Lazy = this; Lazy; Lazy = Lazy->Outer)
+		{
+			Lazy->bSuspended = true;
+			if (auto* Flag = std::exchange(Lazy->bAwaiterSuspended, nullptr))
+				*Flag = true;
+		}
+#endif
+	}
+
+	/** Reverts BeginSuspend if the awaiter didn't suspend after all. */
+	void EndSuspend() noexcept { Parent->LazyResume = nullptr; }
+
+#if UE5CORO_DEBUG
+	static void BeginAwait(FPromise& Promise, const TCHAR* AwaiterType)
+	{
+		Promise.BeginAwait(AwaiterType);
+	}
+#endif
+};
+
+template<typename W, typename P, typename = void>
+constexpr bool TCanSuspendIn = false;
+
+template<typename W, typename P>
+constexpr bool TCanSuspendIn<W, P, std::void_t<decltype(std::declval<W&>()
+	.await_suspend(std::declval<stdcoro::coroutine_handle<P>>()))>> = true;
+
+template<typename A, typename = void>
+constexpr bool THasMemberCoAwait = false;
+
+template<typename A>
+constexpr bool THasMemberCoAwait<A, std::void_t<decltype(std::declval<A>()
+	.operator co_await())>> = true;
+
+/** What co_awaiting A in a coroutine with promise type P would await. */
+template<typename P, typename A>
+class [[nodiscard]] TLazyForwardSlot final
+{
+	using FTransform = TAwaitTransform<P, std::remove_reference_t<A>>;
+	using FTransformed = decltype(FTransform()(std::declval<A>()));
+	// Most transforms pass the awaitable through, which will outlive this
+	static constexpr bool bByReference = std::is_reference_v<FTransformed>;
+	std::conditional_t<bByReference, std::remove_reference_t<FTransformed>*,
+	                   FTransformed> Transformed;
+
+	static auto Transform(A&& Awaitable)
+	{
+		if constexpr (bByReference)
+			return &FTransform()(std::forward<A>(Awaitable));
+		else
+			return FTransform()(std::forward<A>(Awaitable));
+	}
+
+public:
+	explicit TLazyForwardSlot(A&& Awaitable)
+		: Transformed(Transform(std::forward<A>(Awaitable))) { }
+	TLazyForwardSlot(const TLazyForwardSlot&) = delete;
+	TLazyForwardSlot& operator=(const TLazyForwardSlot&) = delete;
+
+	auto& Get()
+	{
+		auto&& Result = [this]() -> decltype(auto)
+		{
+			if constexpr (bByReference)
+				return std::forward<FTransformed>(*Transformed);
+			else
+				return std::move(Transformed);
+		}();
+		using FResult = decltype(Result);
+		if constexpr (THasMemberCoAwait<FResult>)
+		{
+			static_assert(std::is_lvalue_reference_v<decltype(
+				std::forward<FResult>(Result).operator co_await())>,
+				"operator co_await is expected to return a reference");
+			return std::forward<FResult>(Result).operator co_await();
+		}
+		else
+			return Result;
+	}
+};
+
+/** Awaits A on behalf of a lazy coroutine, in the coroutine running it. */
+template<typename A>
+class [[nodiscard]] TLazyForwardAwaiter final
+{
+	using FAsyncSlot = TLazyForwardSlot<FAsyncPromise, A>;
+	using FLatentSlot = TLazyForwardSlot<FLatentPromise, A>;
+
+	FLazyPromiseBase& Lazy;
+	union
+	{
+		FAsyncSlot AsyncSlot;
+		FLatentSlot LatentSlot;
+	};
+
+#if UE5CORO_PRIVATE_SYMMETRIC_TRANSFER
+	using FSuspendResult = stdcoro::coroutine_handle<>;
+	static FSuspendResult Suspended() { return stdcoro::noop_coroutine(); }
+	static FSuspendResult Continue(stdcoro::coroutine_handle<> Handle)
+	{
+		return Handle;
+	}
+	static FSuspendResult Transfer(stdcoro::coroutine_handle<> Next)
+	{
+		return Next;
+	}
+#else
+	using FSuspendResult = bool;
+	static FSuspendResult Suspended() { return true; }
+	static FSuspendResult Continue(stdcoro::coroutine_handle<>)
+	{
+		return false;
+	}
+	static FSuspendResult Transfer(stdcoro::coroutine_handle<> Next)
+	{
+		Next.resume();
+		return true;
+	}
+#endif
+
+	template<typename P, typename S>
+	static FSuspendResult Suspend(S& Slot, FLazyPromiseBase& Lazy,
+	                              stdcoro::coroutine_handle<> Handle)
+	{
+		auto& Awaiter = Slot.Get();
+		using FAwaiter = std::remove_reference_t<decltype(Awaiter)>;
+		if constexpr (!TCanSuspendIn<FAwaiter, P>)
+		{
+			checkf(false, TEXT("This cannot be co_awaited in this coroutine"));
+			Lazy.EndSuspend();
+			return Continue(Handle);
+		}
+		else
+		{
+			auto Parent = stdcoro::coroutine_handle<P>::from_promise(
+				static_cast<P&>(*Lazy.Parent));
+			using FResult = decltype(Awaiter.await_suspend(Parent));
+			// Once the awaiter has Parent, Lazy might be resumed and destroyed
+			// at any time, it's only safe to use if it wasn't
+			if constexpr (std::is_void_v<FResult>)
+			{
+				Awaiter.await_suspend(Parent);
+				return Suspended();
+			}
+			else if constexpr (std::is_same_v<FResult, bool>)
+			{
+				if (Awaiter.await_suspend(Parent))
+					return Suspended();
+				Lazy.EndSuspend();
+				return Continue(Handle);
+			}
+			else
+			{
+				stdcoro::coroutine_handle<> Next = Awaiter.await_suspend(Parent);
+				if (Next != Parent)
+					return Transfer(Next);
+				Lazy.EndSuspend();
+				return Continue(Handle);
+			}
+		}
+	}
+
+public:
+	TLazyForwardAwaiter(FLazyPromiseBase& Lazy, A&& Awaitable) : Lazy(Lazy)
+	{
+		if (Lazy.bLatentParent)
+			new (&LatentSlot) FLatentSlot(std::forward<A>(Awaitable));
+		else
+			new (&AsyncSlot) FAsyncSlot(std::forward<A>(Awaitable));
+	}
+	TLazyForwardAwaiter(const TLazyForwardAwaiter&) = delete;
+	TLazyForwardAwaiter& operator=(const TLazyForwardAwaiter&) = delete;
+
+	~TLazyForwardAwaiter()
+	{
+		if (Lazy.bLatentParent)
+			LatentSlot.~FLatentSlot();
+		else
+			AsyncSlot.~FAsyncSlot();
+	}
+
+	bool await_ready()
+	{
+		return Lazy.bLatentParent ? LatentSlot.Get().await_ready()
+		                          : AsyncSlot.Get().await_ready();
+	}
+
+	FSuspendResult await_suspend(stdcoro::coroutine_handle<> Handle)
+	{
+		Lazy.BeginSuspend(Handle);
+		return Lazy.bLatentParent
+			? Suspend<FLatentPromise>(LatentSlot, Lazy, Handle)
+			: Suspend<FAsyncPromise>(AsyncSlot, Lazy, Handle);
+	}
+
+	decltype(auto) await_resume()
+	{
+		static_assert(std::is_same_v<decltype(AsyncSlot.Get().await_resume()),
+		                             decltype(LatentSlot.Get().await_resume())>,
+		              "Unsupported awaiter in lazy coroutines");
+		if (Lazy.bLatentParent)
+			return LatentSlot.Get().await_resume();
+		return AsyncSlot.Get().await_resume();
+	}
+};
+
+template<typename T>
+class [[nodiscard]] TLazyPromiseBase : public FLazyPromiseBase
+{
+	template<typename> friend class TLazyAwaiter;
+
+	struct FFinalSuspend
+	{
+		bool await_ready() noexcept { return false; }
+#if UE5CORO_PRIVATE_SYMMETRIC_TRANSFER
+		stdcoro::coroutine_handle<> await_suspend(
+			stdcoro::coroutine_handle<TLazyPromise<T>> Handle) noexcept
+		{
+			return Handle.promise().Continuation;
+		}
+#else
+		void await_suspend(
+			stdcoro::coroutine_handle<TLazyPromise<T>> Handle) noexcept
+		{
+			// Otherwise, the awaiter resumed this coroutine and will continue
+			// from there
+			if (auto& Promise = Handle.promise(); Promise.bSuspended)
+				Promise.Continuation.resume();
+		}
+#endif
+		void await_resume() noexcept { }
+	};
+
+protected:
+	stdcoro::coroutine_handle<> Continuation;
+#if !PLATFORM_EXCEPTIONS_DISABLED
+	std::exception_ptr Exception;
+#endif
+
+public:
+	TLazyPromiseBase() = default;
+	UE_NONCOPYABLE(TLazyPromiseBase);
+
+	static void* operator new(size_t Size)
+	{
+		return FFrameAllocator::Allocate(Size);
+	}
+	static void operator delete(void* Ptr) noexcept
+	{
+		FFrameAllocator::Free(Ptr);
+	}
+
+	TLazyCoroutine<T> get_return_object() noexcept
+	{
+		return TLazyCoroutine<T>(
+			stdcoro::coroutine_handle<TLazyPromise<T>>::from_promise(
+				static_cast<TLazyPromise<T>&>(*this)));
+	}
+
+	stdcoro::suspend_always initial_suspend() noexcept { return {}; }
+	FFinalSuspend final_suspend() noexcept { return {}; }
+
+	void unhandled_exception()
+	{
+#if PLATFORM_EXCEPTIONS_DISABLED
+		check(!"Exceptions are not supported");
+#else
+		// Rethrown in the awaiting coroutine by TLazyAwaiter
+		Exception = std::current_exception();
+#endif
+	}
+
+	template<typename U>
+	TLazyCoroutine<U>&& await_transform(TLazyCoroutine<U>&& Lazy) noexcept
+	{
+		return std::move(Lazy);
+	}
+
+	// Everything else is co_awaited by the coroutine running this one
+	template<typename U>
+	TLazyForwardAwaiter<U> await_transform(U&& Awaitable)
+	{
+#if UE5CORO_DEBUG
+		if (Parent)
+			BeginAwait(*Parent, LIKELY(GDebugMetadata >= 2)
+			                    ? DebugTypeName<std::decay_t<U>>() : nullptr);
+#endif
+		return TLazyForwardAwaiter<U>(*this, std::forward<U>(Awaitable));
+	}
+
+	// co_yield is not allowed in lazy coroutines
+	template<typename U>
+	stdcoro::suspend_never yield_value(U&&) = delete;
+};
+
+template<typename T>
+class [[nodiscard]] TLazyPromise final : public TLazyPromiseBase<T>
+{
+	template<typename> friend class TLazyAwaiter;
+	TOptional<T> Result;
+
+public:
+	template<typename U = T>
+	void return_value(U&& Value)
+	{
+		Result.Emplace(std::forward<U>(Value));
+	}
+};
+
+template<>
+class [[nodiscard]] TLazyPromise<void> final : public TLazyPromiseBase<void>
+{
+public:
+	void return_void() noexcept { }
+};
+
+template<typename T>
+class [[nodiscard]] TLazyAwaiter
+{
+	stdcoro::coroutine_handle<TLazyPromise<T>> Handle;
+
+	template<typename P>
+	void Attach(stdcoro::coroutine_handle<P> Awaiting)
+	{
+		auto& Promise = Handle.promise();
+		Promise.Continuation = Awaiting;
+		if constexpr (!std::is_void_v<P>)
+			Promise.Attach(Awaiting.promise());
+	}
+
+public:
+	explicit TLazyAwaiter(
+		stdcoro::coroutine_handle<TLazyPromise<T>> Handle) noexcept
+		: Handle(Handle) { }
+
+	bool await_ready() noexcept { return false; }
+
+#if UE5CORO_PRIVATE_SYMMETRIC_TRANSFER
+	template<typename P>
+	stdcoro::coroutine_handle<> await_suspend(
+		stdcoro::coroutine_handle<P> Awaiting) noexcept
+	{
+		Attach(Awaiting);
+		return Handle;
+	}
+#else
+	template<typename P>
+	bool await_suspend(stdcoro::coroutine_handle<P> Awaiting)
+	{
+		Attach(Awaiting);
+		bool bSuspended = false;
+		Handle.promise().bAwaiterSuspended = &bSuspended;
+		Handle.resume(); // This runs until it completes or suspends
+		// If it suspended, this might have been resumed and destroyed since
+		return bSuspended;
+	}
+#endif
+
+	T await_resume()
+	{
+		checkf(Handle.done(),
+		       TEXT("Internal error: lazy coroutine suspended unexpectedly"));
+		auto& Promise = Handle.promise();
+#if !PLATFORM_EXCEPTIONS_DISABLED
+		if (Promise.Exception)
+			std::rethrow_exception(std::exchange(Promise.Exception, nullptr));
+#endif
+		if constexpr (!std::is_void_v<T>)
+		{
+			checkf(Promise.Result.IsSet(),
+			       TEXT("Lazy coroutine finished without co_returning"));
+			return std::move(*Promise.Result);
+		}
+	}
+};
+}
@@ -0,0 +1,80 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UE5Coro/Definitions.h"
+#include "UE5Coro/AsyncCoroutine.h"
+
+namespace UE5Coro::Private
+{
+class FPhysicsTickAwaiter;
+}
+
+namespace UE5Coro::Async
+{
+/** Resumes the coroutine inside the next simulation step of the world's Chaos
+ *  solver. With async physics, this is on the physics thread, close to the
+ *  simulation data, otherwise it's during the physics tick on the game thread.
+ *  <br>Must be co_awaited on the game thread. The result of the co_await is
+ *  true if it resumed in a simulation step. If the world's solver is torn down
+ *  before its next step, the coroutine resumes on the game thread with false
+ *  instead.<br>
+ *  See Latent::NextTick for TG_PrePhysics and TG_PostPhysics. */
+UE5CORO_API Private::FPhysicsTickAwaiter NextPhysicsTick(
+	const UObject* WorldContextObject);
+}
+
+namespace UE5Coro::Private
+{
+class [[nodiscard]] UE5CORO_API FPhysicsTickAwaiter
+	: public TAwaiter<FPhysicsTickAwaiter>, private FCancellationHook
+{
+	struct FState;
+
+	TWeakObjectPtr<UWorld> World;
+	TSharedPtr<FState> State; // Shared with the solver's callback
+	FPromise* Hooked = nullptr; // Where the cancellation hook was registered
+
+	static void OnCanceled(FCancellationHook&);
+	void Unhook();
+
+public:
+	explicit FPhysicsTickAwaiter(UWorld* World)
+		: FCancellationHook(&OnCanceled), World(World) { }
+	FPhysicsTickAwaiter(const FPhysicsTickAwaiter&);
+	~FPhysicsTickAwaiter();
+
+	void Suspend(FPromise&);
+	bool await_resume();
+};
+}
@@ -79,4 +79,17 @@ constexpr bool TIsDelegate =
 	std::is_base_of_v<FDefaultTSDelegateUserPolicy::FDelegateExtras, T> ||
 #endif
 	TIsDynamicDelegate<T> || TIsMulticastDelegate<T>;
+
+// Removes Target's NAME_Core binding from a delegate of type T, if it has one
+template<typename T>
+void UnbindCallbackTarget(void* Delegate, UObject* Target)
+{
+	auto& D = *static_cast<T*>(Delegate);
+	if constexpr (TIsDynamicDelegate<T> && TIsMulticastDelegate<T>)
+		D.Remove(Target, NAME_Core);
+	else if constexpr (TIsMulticastDelegate<T>)
+		D.RemoveAll(Target);
+	else if (D.IsBoundToObject(Target))
+		D.Unbind();
+}
 }
@@ -0,0 +1,193 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UE5Coro/Definitions.h"
+#include "RenderCommandFence.h"
+#include "RHIGPUReadback.h"
+#if ENGINE_MINOR_VERSION >= 3
+#include "PSOPrecache.h"
+#endif
+#include "UE5Coro/AsyncCoroutine.h"
+
+class UMaterialInterface;
+class UPrimitiveComponent;
+
+namespace UE5Coro::Private
+{
+class FRenderResourceAwaiter;
+class FReadbackAwaiter;
+class FRenderFenceAwaiter;
+class FRenderThreadAwaiter;
+}
+
+namespace UE5Coro::Async
+{
+/** Resumes the coroutine on the rendering thread, inside a render command that
+ *  is enqueued when the co_await starts, ordered with other render commands.
+ *  <br>Without a separate rendering thread, the coroutine continues
+ *  synchronously.<br>
+ *  The return value of this function is reusable. */
+UE5CORO_API Private::FRenderThreadAwaiter MoveToRenderThread();
+
+/** Resumes the coroutine on the rendering thread once the readback's data is
+ *  available, where it may be locked.<br>
+ *  This is checked once per frame by a render command, and the readback must
+ *  stay alive until the coroutine resumes. */
+UE5CORO_API Private::FReadbackAwaiter UntilReadbackReady(FRHIGPUReadback&);
+}
+
+namespace UE5Coro::Render
+{
+/** Starts precaching the PSOs of the components' materials if they're not
+ *  already being precached, and resumes the coroutine on the game thread once
+ *  every component's precaching has finished.<br>
+ *  If TimeoutSeconds is positive, the coroutine resumes after that much real
+ *  time at the latest, even if precaching is still in progress.<br>
+ *  The result of the co_await expression is true if precaching finished,
+ *  false if it timed out.<br>
+ *  Without PSO precaching (disabled or before UE 5.3), this completes
+ *  immediately with true. Components that get destroyed count as finished. */
+UE5CORO_API Private::FRenderResourceAwaiter PrecachePSOs(
+	TArrayView<UPrimitiveComponent*> Components, float TimeoutSeconds = 0);
+
+#if ENGINE_MINOR_VERSION >= 3
+/** Requests the PSOs of the materials for the given vertex factories, and
+ *  resumes the coroutine on the game thread once the requests complete.<br>
+ *  If TimeoutSeconds is positive, the coroutine resumes after that much real
+ *  time at the latest, even if the requests are still in progress.<br>
+ *  The result of the co_await expression is true if the requests completed,
+ *  false if it timed out. */
+UE5CORO_API Private::FRenderResourceAwaiter PrecachePSOs(
+	TArrayView<UMaterialInterface*> Materials,
+	const FPSOPrecacheVertexFactoryDataList& VertexFactoryDataList,
+	const FPSOPrecacheParams& Params = FPSOPrecacheParams(),
+	float TimeoutSeconds = 0);
+#endif
+
+/** Resumes the coroutine on the game thread once at least Threshold (0-1) of
+ *  the textures used by the components are fully streamed in.<br>
+ *  Textures that are not resident yet are kept wanted at full resolution
+ *  while this is waiting, and briefly afterwards.<br>
+ *  If TimeoutSeconds is positive, the coroutine resumes after that much real
+ *  time at the latest.<br>
+ *  The result of the co_await expression is true if the textures became
+ *  resident, false if it timed out. */
+UE5CORO_API Private::FRenderResourceAwaiter UntilTexturesResident(
+	TArrayView<UPrimitiveComponent*> Components, float Threshold = 1,
+	float TimeoutSeconds = 0);
+
+/** Adds Location as a view location to every texture streaming update while
+ *  this is waiting, e.g., ahead of a camera cut or teleport, and resumes the
+ *  coroutine on the game thread once the streamer has loaded at least
+ *  Threshold (0-1) of the resources that it wanted since then.<br>
+ *  This is only checked when the streamer updates its counts, every few
+ *  frames. The counts are global, including every other view.<br>
+ *  If TimeoutSeconds is positive, the coroutine resumes after that much real
+ *  time at the latest.<br>
+ *  The result of the co_await expression is true if the resources became
+ *  resident, false if it timed out. */
+UE5CORO_API Private::FRenderResourceAwaiter UntilTexturesResident(
+	const FVector& Location, float Threshold = 1, float TimeoutSeconds = 0);
+}
+
+namespace UE5Coro::Private
+{
+class [[nodiscard]] UE5CORO_API FRenderThreadAwaiter
+	: public TAwaiter<FRenderThreadAwaiter>
+{
+public:
+	void Suspend(FPromise&);
+};
+
+/** co_awaiting a FRenderCommandFence on the game thread resumes the coroutine
+ *  once the fence is complete, without polling it from the game thread every
+ *  frame. */
+class [[nodiscard]] UE5CORO_API FRenderFenceAwaiter
+	: public TAwaiter<FRenderFenceAwaiter>
+{
+	FRenderCommandFence& Fence;
+	FPromise* Promise = nullptr;
+
+	void Check();
+
+public:
+	explicit FRenderFenceAwaiter(FRenderCommandFence& Fence) : Fence(Fence) { }
+
+	bool await_ready();
+	void Suspend(FPromise&);
+};
+
+class [[nodiscard]] UE5CORO_API FReadbackAwaiter
+	: public TAwaiter<FReadbackAwaiter>
+{
+	FRHIGPUReadback& Readback;
+	FPromise* Promise = nullptr;
+
+	void Poll();
+
+public:
+	explicit FReadbackAwaiter(FRHIGPUReadback& Readback)
+		: Readback(Readback) { }
+
+	void Suspend(FPromise&);
+};
+
+class [[nodiscard]] UE5CORO_API FRenderResourceAwaiter
+	: public TAwaiter<FRenderResourceAwaiter>
+{
+public:
+	struct FState;
+
+private:
+	TSharedPtr<FState> State; // Only null if moved from
+
+public:
+	explicit FRenderResourceAwaiter(TSharedPtr<FState>);
+	FRenderResourceAwaiter(FRenderResourceAwaiter&&) noexcept;
+	~FRenderResourceAwaiter();
+
+	bool await_ready();
+	void Suspend(FPromise&);
+	bool await_resume();
+};
+
+template<typename P>
+struct TAwaitTransform<P, FRenderCommandFence>
+{
+	FRenderFenceAwaiter operator()(FRenderCommandFence& Fence)
+	{
+		return FRenderFenceAwaiter(Fence);
+	}
+};
+}
@@ -0,0 +1,98 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UE5Coro/Definitions.h"
+#include "UE5Coro/AsyncCoroutine.h"
+
+class USaveGame;
+
+namespace UE5Coro::Private
+{
+class FLoadGameAwaiter;
+class FSaveGameAwaiter;
+}
+
+namespace UE5Coro::Save
+{
+/** Saves the save game to the slot, and resumes the coroutine on the game
+ *  thread after it's done.<br>
+ *  The save game is serialized on the game thread when this is called,
+ *  compression (if a format is provided) and writing the data through the
+ *  platform's save game system happen on a worker thread.<br>
+ *  The result of the co_await expression is true if the save succeeded.<br>
+ *  Compressed saves can only be loaded by LoadGameAsync, not by
+ *  UGameplayStatics. */
+UE5CORO_API Private::FSaveGameAwaiter SaveGameAsync(
+	USaveGame* SaveGame, FString SlotName, int32 UserIndex,
+	FName CompressionFormat = NAME_None);
+
+/** Reads and (if needed) decompresses the slot on a worker thread, then
+ *  resumes the coroutine on the game thread after creating the save game
+ *  object from its data.<br>
+ *  The result of the co_await expression is the loaded save game, or nullptr
+ *  if it could not be loaded. This supports saves from UGameplayStatics. */
+UE5CORO_API Private::FLoadGameAwaiter LoadGameAsync(FString SlotName,
+                                                    int32 UserIndex);
+}
+
+namespace UE5Coro::Private
+{
+class [[nodiscard]] UE5CORO_API FSaveGameAwaiter
+	: public TAwaiter<FSaveGameAwaiter>
+{
+public:
+	struct FState;
+
+protected:
+	TSharedPtr<FState> State; // Only null if moved from
+
+public:
+	explicit FSaveGameAwaiter(TSharedPtr<FState>);
+	FSaveGameAwaiter(FSaveGameAwaiter&&) noexcept;
+	~FSaveGameAwaiter();
+
+	bool await_ready();
+	void Suspend(FPromise&);
+	bool await_resume();
+};
+
+class [[nodiscard]] UE5CORO_API FLoadGameAwaiter : public FSaveGameAwaiter
+{
+public:
+	using FSaveGameAwaiter::FSaveGameAwaiter;
+
+	USaveGame* await_resume();
+};
+}
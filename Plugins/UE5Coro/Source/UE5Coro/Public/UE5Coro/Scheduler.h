@@ -0,0 +1,146 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UE5Coro/Definitions.h"
+#include "UE5Coro/AsyncCoroutine.h"
+#include "UE5Coro/Private.h"
+
+namespace UE5Coro::Private
+{
+class FAsyncYieldAwaiter;
+class FSchedulerAwaiter;
+}
+
+namespace UE5Coro
+{
+/**
+ * Pool of worker threads owned by UE5Coro that run coroutines, as a lighter
+ * weight alternative to moving them between task graph named threads.<br>
+ * Every worker has its own work-stealing deque and a LIFO slot that holds the
+ * coroutine most recently scheduled from that worker, which runs next.
+ * Coroutines scheduled from other threads go to a shared queue that is linked
+ * through the promises themselves.<br>
+ * Nothing is allocated to schedule a coroutine, apart from the occasional
+ * deque growth.<br>
+ * Workers are regular threads that coexist with the task graph and UE::Tasks.
+ * Awaiters that resume coroutines elsewhere (e.g., Async::PlatformSeconds)
+ * will move them out of the scheduler like they would from any other thread.
+ */
+class UE5CORO_API FScheduler final
+{
+	friend Private::FAsyncYieldAwaiter;
+	friend Private::FSchedulerAwaiter;
+
+	struct FWorker;
+
+	TArray<TUniquePtr<FWorker>> Workers;
+	// Coroutines scheduled from outside the workers
+	Private::FMutex InboxLock;
+	// Intrusive FIFO of the promises' inbox nodes, guarded by InboxLock
+	Private::FInboxNode* InboxHead = nullptr;
+	Private::FInboxNode* InboxTail = nullptr;
+	std::atomic<int> NumShared = 0;
+	// Indices of workers that are sleeping or about to
+	Private::FMutex IdleLock;
+	TArray<int32> IdleWorkers;
+	std::atomic<int> NumIdle = 0;
+	std::atomic<bool> bStopping = false;
+
+public:
+	struct FStats
+	{
+		/** Number of coroutines that were resumed by the workers. */
+		uint64 NumResumed = 0;
+		/** How many of those came from a LIFO slot. */
+		uint64 NumFromLIFOSlot = 0;
+		/** How many of those were stolen from another worker. */
+		uint64 NumStolen = 0;
+	};
+
+	/** Starts the worker threads. If NumWorkers is 0, it's chosen based on the
+	 *  number of cores. */
+	explicit FScheduler(int NumWorkers = 0,
+	                    EThreadPriority Priority = TPri_Normal);
+	UE_NONCOPYABLE(FScheduler);
+
+	/** Runs everything that's still scheduled, then stops the workers.<br>
+	 *  This must not be called from one of the scheduler's own workers, and
+	 *  coroutines must not be scheduled onto it while it's being destroyed. */
+	~FScheduler();
+
+	[[nodiscard]] int GetNumWorkers() const;
+
+	/** @return true if this was called on one of this scheduler's workers. */
+	[[nodiscard]] bool IsInScheduler() const;
+
+	/** Returns the statistics of every worker added together. */
+	[[nodiscard]] FStats GetStats() const;
+
+private:
+	void Schedule(Private::FPromise&);
+	void ScheduleShared(Private::FPromise&);
+	void WakeOne();
+	/** Schedules the promise behind everything else if this is called on a
+	 *  worker, and returns whether that happened. */
+	static bool TryYield(Private::FPromise&);
+};
+
+namespace Async
+{
+/** Suspends the coroutine and resumes it on one of the scheduler's worker
+ *  threads.<br>
+ *  If the coroutine is already on a worker of the same scheduler, it's placed
+ *  in that worker's LIFO slot, and continues as soon as the code that resumed
+ *  it returns. This is useful to get off a deep native call stack, e.g., when
+ *  resumed by FAwaitableEvent::Trigger() in the middle of another coroutine.<br>
+ *  Async::Yield() on a worker thread schedules the coroutine behind everything
+ *  else queued on the same scheduler.<br>
+ *  The return value of this function is reusable. */
+UE5CORO_API Private::FSchedulerAwaiter MoveToScheduler(FScheduler&);
+}
+}
+
+namespace UE5Coro::Private
+{
+class [[nodiscard]] UE5CORO_API FSchedulerAwaiter
+	: public TAwaiter<FSchedulerAwaiter>
+{
+	FScheduler& Scheduler;
+
+public:
+	explicit FSchedulerAwaiter(FScheduler& Scheduler) : Scheduler(Scheduler) { }
+
+	void Suspend(FPromise&);
+};
+}
@@ -0,0 +1,106 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UE5Coro/Definitions.h"
+#include "UE5Coro/AsyncCoroutine.h"
+
+class FSocket;
+
+namespace UE5Coro::Private
+{
+class FSocketAwaiter;
+}
+
+namespace UE5Coro::Sockets
+{
+/** Resumes the coroutine once the socket has data to receive, an incoming
+ *  connection, or it was closed by the other side.<br>
+ *  Waiting is done by a single thread for every socket, the coroutine is
+ *  resumed on the same kind of named thread that it co_awaited from.<br>
+ *  The result of the co_await expression is false if the socket has failed.
+ *  The socket must outlive the awaiter. */
+UE5CORO_API Private::FSocketAwaiter Readable(FSocket& Socket);
+
+/** Resumes the coroutine once data can be sent on the socket without
+ *  blocking, otherwise like Readable. */
+UE5CORO_API Private::FSocketAwaiter Writable(FSocket& Socket);
+
+/** Waits for the socket to become readable, then receives as much as fits
+ *  directly into Buffer.<br>
+ *  The result is the number of bytes received, or 0 if the connection was
+ *  closed or failed. Socket and Buffer must stay valid until completion. */
+UE5CORO_API TCoroutine<int32> Receive(FSocket& Socket,
+                                      TArrayView<uint8> Buffer);
+
+/** Keeps receiving directly into Buffer until it's full.<br>
+ *  The result is false if the connection was closed or failed first, in which
+ *  case Buffer is only partially filled. Socket and Buffer must stay valid
+ *  until completion. */
+UE5CORO_API TCoroutine<bool> ReceiveExactly(FSocket& Socket,
+                                            TArrayView<uint8> Buffer);
+}
+
+namespace UE5Coro::Private
+{
+class [[nodiscard]] UE5CORO_API FSocketAwaiter
+	: public TAwaiter<FSocketAwaiter>, private FCancellationHook
+{
+	friend class FSocketPoller;
+
+	FSocket* Socket;
+	const bool bWrite;
+	ENamedThreads::Type Thread = ENamedThreads::AnyThread;
+	std::atomic<FPromise*> Promise = nullptr;
+	FPromise* Hooked = nullptr; // Where the cancellation hook was registered
+
+	// Owned by FSocketPoller and guarded by its lock
+	int32 QueueIndex = INDEX_NONE; // INDEX_NONE if not queued
+	bool bCanceled = false; // Resume as soon as possible instead of queueing
+	bool bResult = false;
+
+	static void OnCanceled(FCancellationHook&);
+	void Unhook();
+	bool IsReady() const;
+
+public:
+	explicit FSocketAwaiter(FSocket& Socket, bool bWrite)
+		: FCancellationHook(&OnCanceled), Socket(&Socket), bWrite(bWrite) { }
+	FSocketAwaiter(const FSocketAwaiter&);
+	~FSocketAwaiter();
+
+	bool await_ready();
+	void Suspend(FPromise&);
+	bool await_resume();
+};
+}
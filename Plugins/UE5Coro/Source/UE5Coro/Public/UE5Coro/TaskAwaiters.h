@@ -33,12 +33,15 @@
 
 #include "CoreMinimal.h"
 #include "UE5Coro/Definitions.h"
+#include "Tasks/Pipe.h"
 #include "Tasks/Task.h"
 #include "UE5Coro/AsyncCoroutine.h"
 
 namespace UE5Coro::Private
 {
+class FPipeAwaiter;
 class FTaskAwaiter;
+class FTaskWhenAllAwaiter;
 }
 
 namespace UE5Coro::Tasks
@@ -46,22 +49,108 @@ namespace UE5Coro::Tasks
 /** Suspends the coroutine and resumes it in a UE::Tasks::TTask.<br>
  *  The return value of this function is reusable. Repeated co_awaits will
  *  keep resuming in a new TTask every time. */
-UE5CORO_API Private::FTaskAwaiter MoveToTask(const TCHAR* DebugName = nullptr);
+UE5CORO_API Private::FTaskAwaiter MoveToTask(
+	const TCHAR* DebugName = nullptr,
+	UE::Tasks::ETaskPriority Priority = UE::Tasks::ETaskPriority::Default
+#if ENGINE_MINOR_VERSION >= 1
+	, UE::Tasks::EExtendedTaskPriority ExtendedPriority =
+		UE::Tasks::EExtendedTaskPriority::None
+#endif
+	);
+
+/** Suspends the coroutine and resumes it in a task launched in the provided
+ *  UE::Tasks::FPipe, serializing it with every other task in the pipe.<br>
+ *  The coroutine only counts as part of the pipe until its next suspension.
+ *  <br>The pipe must outlive the co_await.<br>
+ *  The return value of this function is reusable. Repeated co_awaits will
+ *  keep resuming in a new piped task every time. */
+UE5CORO_API Private::FPipeAwaiter MoveToPipe(
+	UE::Tasks::FPipe& Pipe, const TCHAR* DebugName = nullptr,
+	UE::Tasks::ETaskPriority Priority = UE::Tasks::ETaskPriority::Default
+#if ENGINE_MINOR_VERSION >= 1
+	, UE::Tasks::EExtendedTaskPriority ExtendedPriority =
+		UE::Tasks::EExtendedTaskPriority::None
+#endif
+	);
+
+/** Resumes the coroutine once every provided task has completed.<br>
+ *  This is a single task with the provided tasks as prerequisites, use this
+ *  instead of the generic WhenAll for UE::Tasks. */
+UE5CORO_API Private::FTaskWhenAllAwaiter WhenAll(
+	TArray<UE::Tasks::FTask> Tasks);
 }
 
 namespace UE5Coro::Private
 {
 class [[nodiscard]] UE5CORO_API FTaskAwaiter : public TAwaiter<FTaskAwaiter>
 {
+	friend FPipeAwaiter;
+
 	const TCHAR* DebugName;
+	UE::Tasks::ETaskPriority Priority;
+#if ENGINE_MINOR_VERSION >= 1
+	UE::Tasks::EExtendedTaskPriority ExtendedPriority;
+#endif
+
+public:
+	explicit FTaskAwaiter(const TCHAR* DebugName,
+	                      UE::Tasks::ETaskPriority Priority
+#if ENGINE_MINOR_VERSION >= 1
+	                      , UE::Tasks::EExtendedTaskPriority ExtendedPriority
+#endif
+	                      ) noexcept
+		: DebugName(DebugName), Priority(Priority)
+#if ENGINE_MINOR_VERSION >= 1
+		, ExtendedPriority(ExtendedPriority)
+#endif
+	{
+	}
+
+	void Suspend(FPromise& Promise);
+};
+
+class [[nodiscard]] UE5CORO_API FPipeAwaiter : public TAwaiter<FPipeAwaiter>
+{
+	UE::Tasks::FPipe& Pipe;
+	FTaskAwaiter Task; // Reused for the launch parameters
 
 public:
-	explicit FTaskAwaiter(const TCHAR* DebugName) noexcept
-		: DebugName(DebugName) { }
+	explicit FPipeAwaiter(UE::Tasks::FPipe& Pipe, FTaskAwaiter Task) noexcept
+		: Pipe(Pipe), Task(Task) { }
 
 	void Suspend(FPromise& Promise);
 };
 
+/** Launches a task that resumes the coroutine after its prerequisites. */
+template<typename T>
+void ResumeAfter(FPromise& Promise, const TCHAR* DebugName, T&& Prerequisites)
+{
+#if ENGINE_MINOR_VERSION >= 1
+	// Inline tasks are executed as part of their prerequisites' completion,
+	// skipping a round trip through the scheduler
+	UE::Tasks::Launch(DebugName, [&Promise] { Promise.Resume(); },
+	                  std::forward<T>(Prerequisites),
+	                  UE::Tasks::ETaskPriority::Default,
+	                  UE::Tasks::EExtendedTaskPriority::Inline);
+#else
+	UE::Tasks::Launch(DebugName, [&Promise] { Promise.Resume(); },
+	                  std::forward<T>(Prerequisites));
+#endif
+}
+
+class [[nodiscard]] UE5CORO_API FTaskWhenAllAwaiter
+	: public TAwaiter<FTaskWhenAllAwaiter>
+{
+	TArray<UE::Tasks::FTask> Tasks;
+
+public:
+	explicit FTaskWhenAllAwaiter(TArray<UE::Tasks::FTask>&& Tasks)
+		: Tasks(std::move(Tasks)) { }
+
+	bool await_ready();
+	void Suspend(FPromise&);
+};
+
 template<typename T>
 class [[nodiscard]] TTaskAwaiter : public TAwaiter<TTaskAwaiter<T>>
 {
@@ -74,10 +163,7 @@ public:
 
 	bool await_ready() { return Task.IsCompleted(); }
 
-	void Suspend(FPromise& Promise)
-	{
-		UE::Tasks::Launch(DebugName, [&Promise] { Promise.Resume(); }, Task);
-	}
+	void Suspend(FPromise& Promise) { ResumeAfter(Promise, DebugName, Task); }
 
 	auto await_resume()
 	{
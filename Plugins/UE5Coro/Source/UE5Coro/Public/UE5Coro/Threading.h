@@ -33,6 +33,10 @@
 
 #include "CoreMinimal.h"
 #include "UE5Coro/Definitions.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Containers/Queue.h"
+#include "Templates/TypeCompatibleBytes.h"
+#include "UE5Coro/AsyncAwaiters.h"
 #include "UE5Coro/AsyncCoroutine.h"
 #include "UE5Coro/Private.h"
 
@@ -40,21 +44,54 @@ namespace UE5Coro
 {
 namespace Private
 {
-struct FAwaitingPromise;
+class FBarrierAwaiter;
+class FEventAwaiter;
+class FLatchAwaiter;
+class FRateLimiterAwaiter;
+class FSemaphoreAwaiter;
+class FMutexAwaiter;
+class FRWLockAwaiter;
+class FReadLockAwaiter;
+class FWriteLockAwaiter;
+
+/** Intrusive node in the lock-free waiter lists below. */
+struct FAwaitingPromise
+{
+	FPromise* Promise;
+	FAwaitingPromise* Next;
+};
 }
+
+/** The order in which FAwaitableSemaphore resumes its waiters. */
+enum class ESemaphoreOrder : uint8
+{
+	/** No particular order, slightly faster. */
+	Unordered,
+	/** First come, first served. */
+	FIFO,
+};
+
 /**
  * Awaitable event. co_awaiting this object suspends the coroutine if the event
  * is not triggered, and resumes it at the next call to Trigger().
  * AutoReset events will only resume one awaiter, ManualReset all of them.
  */
 class UE5CORO_API FAwaitableEvent final
-	: public Private::TAwaiter<FAwaitableEvent>
 {
+	friend Private::FEventAwaiter;
+
+	struct FWaitNode : Private::FAwaitingPromise
+	{
+		ENamedThreads::Type Thread;
+		bool bStayOnThread;
+	};
+
 	const EEventMode Mode;
 
-	Private::FMutex Lock;
-	bool bActive;
-	Private::FAwaitingPromise* Awaiters = nullptr;
+	/** 0: not triggered, nothing waiting; Signaled: triggered, nothing waiting;
+	 *  anything else: the FAwaitingPromise* at the top of the waiter stack. */
+	std::atomic<UPTRINT> State;
+	static constexpr UPTRINT Signaled = 1;
 
 public:
 	/** Initializes this event to be in the given mode and state. */
@@ -65,20 +102,37 @@ public:
 	~FAwaitableEvent();
 #endif
 
-	/** Resumes one or more coroutines awaiting this event, depending on Mode. */
+	/** Resumes one or more coroutines awaiting this event, depending on Mode.
+	 *  <br>They are resumed on this thread, one after the other, before this
+	 *  function returns. */
 	void Trigger();
+	/** Triggers the event like Trigger(), but the coroutines that this resumes
+	 *  are sent back to the kind of named thread that they started waiting on.
+	 *  Coroutines from background worker threads are spread over multiple
+	 *  tasks, at most BatchSize each, so that they resume in parallel.<br>
+	 *  This function returns without running any of them. */
+	void TriggerAsync(int32 BatchSize = 32);
+	/** Like TriggerAsync, but one batch of coroutines that were waiting on the
+	 *  same kind of thread as this one is resumed by this thread, before this
+	 *  function returns. */
+	void TriggerParallel(int32 BatchSize = 32);
+	/** co_await the return value of this function to wait for the event like
+	 *  co_awaiting this object directly, but the coroutine is always resumed
+	 *  on the same kind of named thread that it started waiting on, even if
+	 *  the event is triggered by Trigger() on another one. */
+	[[nodiscard]] Private::FEventAwaiter WaitOnThisThread();
 	/** Clears this event, making subsequent co_awaits suspend. */
 	void Reset();
 	/** @return true if this object was made as ManualReset. */
 	[[nodiscard]] bool IsManualReset() const;
 
-	bool await_ready() noexcept;
-	void Suspend(Private::FPromise&);
-	void await_resume() noexcept { }
-
 private:
-	void ResumeOne();
-	void TryResumeAll();
+	static void ResumeAll(Private::FAwaitingPromise*);
+	Private::FAwaitingPromise* Take();
+	void Dispatch(Private::FAwaitingPromise*, int32 BatchSize, bool bRunLocal);
+	bool TryConsume();
+	bool TryEnqueue(Private::FAwaitingPromise&);
+	void Requeue(Private::FAwaitingPromise*);
 };
 
 /**
@@ -87,39 +141,1054 @@ private:
  * the semaphore is next Unlock()ed (released).
  */
 class UE5CORO_API FAwaitableSemaphore final
-	: public Private::TAwaiter<FAwaitableSemaphore>
 {
+	friend Private::FSemaphoreAwaiter;
+
+	struct FWaitNode : Private::FAwaitingPromise
+	{
+		ENamedThreads::Type Thread;
+		double StartTime;
+		bool bStayOnThread;
+	};
+
+public:
+	static constexpr int NumStatBuckets = 32;
+
+	/** Wait times of every suspended co_await on a semaphore.
+	 *  Acquisitions that did not suspend are not included. */
+	struct FStats
+	{
+		uint64 NumWaits = 0;
+		/** Percentiles, rounded up to the next power of two microseconds. */
+		double P50Seconds = 0;
+		double P99Seconds = 0;
+		double MaxSeconds = 0;
+	};
+
+private:
 	const int Capacity;
-	Private::FMutex Lock;
-	int Count;
-	Private::FAwaitingPromise* Awaiters = nullptr;
+	const ESemaphoreOrder Order;
+	/** Available count, or the negated number of committed waiters. */
+	std::atomic<int> Count;
+	std::atomic<FWaitNode*> Awaiters = nullptr;
+	// FIFO only: waiters taken from Awaiters, oldest first, guarded by PopLock
+	Private::FMutex PopLock;
+	FWaitNode* OrderedAwaiters = nullptr;
+	// Bucket 0 is under 1 µs, bucket N is [2^(N-1), 2^N) µs
+	std::atomic<uint64> WaitHistogram[NumStatBuckets] = {};
+	std::atomic<double> MaxWait = 0;
 
 public:
 	/** Initializes the semaphore to the given capacity and initial count.<br>
 	 *  Defaults to being an unlocked mutex. */
-	explicit FAwaitableSemaphore(int Capacity = 1, int InitialCount = 1);
+	explicit FAwaitableSemaphore(int Capacity = 1, int InitialCount = 1,
+	                             ESemaphoreOrder Order =
+	                                 ESemaphoreOrder::Unordered);
 	UE_NONCOPYABLE(FAwaitableSemaphore);
 #if UE5CORO_DEBUG
 	~FAwaitableSemaphore();
 #endif
 
-	/** Unlocks (releases) the semaphore the specified amount of times. */
+	/** Locks (acquires) the semaphore once if that's possible without waiting.
+	 *  @return true if the semaphore was locked. */
+	[[nodiscard]] bool TryLock();
+
+	/** Unlocks (releases) the semaphore the specified amount of times.<br>
+	 *  Waiters are resumed on this thread before this function returns. */
 	void Unlock(int Count = 1);
 
+	/** Unlocks (releases) the semaphore the specified amount of times.<br>
+	 *  The waiters that this resumes are dispatched in one batch per thread to
+	 *  the same kind of named thread that they started waiting on, and this
+	 *  function returns without running any of them. */
+	void UnlockBatch(int Count);
+
+	/** co_await the return value of this function to lock the semaphore like
+	 *  co_awaiting this object directly, but the coroutine is always resumed
+	 *  on the same kind of named thread that it started waiting on, even if
+	 *  the semaphore is unlocked by Unlock() on another one. */
+	[[nodiscard]] Private::FSemaphoreAwaiter LockOnThisThread();
+
+	/** Returns the wait time statistics collected so far. */
+	[[nodiscard]] FStats GetStats() const;
+
+private:
+	int Release(int Count);
+	void Push(FWaitNode&);
+	FWaitNode* Take(int Num);
+	FWaitNode* TakeUnordered(int Num);
+	FWaitNode* TakeFIFO(int Num);
+	void RecordWait(double Seconds);
+};
+
+/**
+ * Awaitable mutex. co_await Lock() to acquire it, which returns a scoped lock
+ * object that unlocks the mutex when it goes out of scope.<br>
+ * Unlocking passes ownership directly to the longest waiting coroutine and
+ * resumes it on the unlocking thread.
+ */
+class UE5CORO_API FAwaitableMutex final
+{
+	friend Private::FMutexAwaiter;
+
+	/** Unlocked, 0: locked with nothing waiting, or anything else: the
+	 *  FAwaitingPromise* at the top of a stack of new waiters. */
+	std::atomic<UPTRINT> State = Unlocked;
+	static constexpr UPTRINT Unlocked = 1;
+	// Oldest first, only accessed by the current owner
+	Private::FAwaitingPromise* Waiters = nullptr;
+
+public:
+	/** Unlocks its mutex when destroyed, unless it was moved from. */
+	class [[nodiscard]] UE5CORO_API FScopedLock final
+	{
+		friend Private::FMutexAwaiter;
+
+		FAwaitableMutex* Mutex;
+
+		explicit FScopedLock(FAwaitableMutex& Mutex) : Mutex(&Mutex) { }
+
+	public:
+		FScopedLock(FScopedLock&&);
+		FScopedLock& operator=(FScopedLock&&) = delete;
+		FScopedLock(const FScopedLock&) = delete;
+		FScopedLock& operator=(const FScopedLock&) = delete;
+		~FScopedLock();
+
+		/** Unlocks the mutex early. The destructor will not unlock it again. */
+		void Unlock();
+	};
+
+	FAwaitableMutex() = default;
+	UE_NONCOPYABLE(FAwaitableMutex);
+#if UE5CORO_DEBUG
+	~FAwaitableMutex();
+#endif
+
+	/** co_await the return value to lock the mutex.<br>
+	 *  The result of the co_await expression is an FScopedLock. */
+	[[nodiscard]] Private::FMutexAwaiter Lock();
+
+	/** Locks the mutex if it's unlocked, without waiting.<br>
+	 *  Returns true if this succeeded, and the mutex must be manually Unlock()ed
+	 *  in this case. */
+	[[nodiscard]] bool TryLock();
+
+	/** Unlocks a mutex that was TryLock()ed, or the lock of a FScopedLock that
+	 *  was released. Locks should be normally unlocked through FScopedLock. */
+	void Unlock();
+};
+
+/**
+ * Awaitable reader/writer lock. Any number of coroutines may hold it in shared
+ * (read) mode at the same time, or one coroutine in exclusive (write) mode.<br>
+ * Waiters are served in FIFO order: once a writer is waiting, new readers line
+ * up behind it instead of starving it. A writer unlocking resumes every reader
+ * waiting in front of the next writer at once.
+ */
+class UE5CORO_API FAwaitableRWLock final
+{
+	friend Private::FRWLockAwaiter;
+
+	struct FWaitNode : Private::FAwaitingPromise
+	{
+		bool bExclusive;
+	};
+
+	// Only held for a few instructions, never while resuming anything
+	Private::FMutex Lock;
+	int NumReaders = 0;
+	bool bWriter = false;
+	FWaitNode* Head = nullptr;
+	FWaitNode* Tail = nullptr;
+
+public:
+	/** Releases its shared lock when destroyed, unless it was moved from. */
+	class [[nodiscard]] UE5CORO_API FScopedReadLock final
+	{
+		friend Private::FReadLockAwaiter;
+
+		FAwaitableRWLock* RWLock;
+
+		explicit FScopedReadLock(FAwaitableRWLock& RWLock) : RWLock(&RWLock) { }
+
+	public:
+		FScopedReadLock(FScopedReadLock&&);
+		FScopedReadLock& operator=(FScopedReadLock&&) = delete;
+		FScopedReadLock(const FScopedReadLock&) = delete;
+		FScopedReadLock& operator=(const FScopedReadLock&) = delete;
+		~FScopedReadLock();
+
+		/** Releases the lock early. The destructor will not release it again. */
+		void Unlock();
+	};
+
+	/** Releases its exclusive lock when destroyed, unless it was moved from. */
+	class [[nodiscard]] UE5CORO_API FScopedWriteLock final
+	{
+		friend Private::FWriteLockAwaiter;
+
+		FAwaitableRWLock* RWLock;
+
+		explicit FScopedWriteLock(FAwaitableRWLock& RWLock) : RWLock(&RWLock) { }
+
+	public:
+		FScopedWriteLock(FScopedWriteLock&&);
+		FScopedWriteLock& operator=(FScopedWriteLock&&) = delete;
+		FScopedWriteLock(const FScopedWriteLock&) = delete;
+		FScopedWriteLock& operator=(const FScopedWriteLock&) = delete;
+		~FScopedWriteLock();
+
+		/** Releases the lock early. The destructor will not release it again. */
+		void Unlock();
+	};
+
+	FAwaitableRWLock() = default;
+	UE_NONCOPYABLE(FAwaitableRWLock);
+#if UE5CORO_DEBUG
+	~FAwaitableRWLock();
+#endif
+
+	/** co_await the return value to lock this in shared mode.<br>
+	 *  The result of the co_await expression is an FScopedReadLock. */
+	[[nodiscard]] Private::FReadLockAwaiter ReadLock();
+
+	/** co_await the return value to lock this in exclusive mode.<br>
+	 *  The result of the co_await expression is an FScopedWriteLock. */
+	[[nodiscard]] Private::FWriteLockAwaiter WriteLock();
+
+	/** Takes a shared lock if that's possible without waiting.<br>
+	 *  If this returns true, the lock must be manually ReadUnlock()ed. */
+	[[nodiscard]] bool TryReadLock();
+
+	/** Takes the exclusive lock if that's possible without waiting.<br>
+	 *  If this returns true, the lock must be manually WriteUnlock()ed. */
+	[[nodiscard]] bool TryWriteLock();
+
+	/** Releases a shared lock that's not owned by an FScopedReadLock. */
+	void ReadUnlock();
+
+	/** Releases an exclusive lock that's not owned by an FScopedWriteLock. */
+	void WriteUnlock();
+
+private:
+	bool TryLockUnsafe(bool bExclusive); // Must hold Lock
+	FWaitNode* TakeNextUnsafe(); // Must hold Lock
+	static void ResumeAll(FWaitNode*);
+};
+
+/**
+ * Awaitable single-use latch. co_awaiting this object suspends the coroutine
+ * until the latch's count has been counted down to zero.<br>
+ * Every waiter is resumed on the thread that counted it down to zero, before
+ * CountDown returns. After that, co_awaits continue immediately.
+ */
+class UE5CORO_API FAwaitableLatch final
+{
+	friend Private::FLatchAwaiter;
+
+	std::atomic<int> Count;
+	/** 0: nothing waiting; Released: the count has reached zero;
+	 *  anything else: the FAwaitingPromise* at the top of the waiter stack. */
+	std::atomic<UPTRINT> State = 0;
+	static constexpr UPTRINT Released = 1;
+
+public:
+	/** Initializes the latch with the given count. 0 is already released. */
+	explicit FAwaitableLatch(int Count);
+	UE_NONCOPYABLE(FAwaitableLatch);
+#if UE5CORO_DEBUG
+	~FAwaitableLatch();
+#endif
+
+	/** Decrements the count, releasing every waiter if it reaches zero.<br>
+	 *  Counting down below zero is not allowed. */
+	void CountDown(int Num = 1);
+
+	/** @return true if the count has reached zero. */
+	[[nodiscard]] bool IsReleased() const;
+
+private:
+	bool TryEnqueue(Private::FAwaitingPromise&);
+};
+
+/**
+ * Awaitable reusable barrier for a fixed number of participants.<br>
+ * co_await ArriveAndWait() suspends the coroutine until every participant has
+ * arrived, at which point the optional completion function is called once,
+ * then every participant is resumed on the thread of the last one to arrive,
+ * and the barrier is reset for the next phase.
+ */
+class UE5CORO_API FAwaitableBarrier final
+{
+	friend Private::FBarrierAwaiter;
+
+	TFunction<void()> OnCompletion;
+	std::atomic<int> Participants;
+	std::atomic<int> Remaining;
+	/** nullptr or the top of the stack of this phase's waiters. */
+	std::atomic<Private::FAwaitingPromise*> Waiters = nullptr;
+
+public:
+	/** Initializes the barrier for the given number of participants.<br>
+	 *  OnCompletion is called by the last participant to arrive in each phase,
+	 *  before the others are resumed. */
+	explicit FAwaitableBarrier(int Participants,
+	                           TFunction<void()> OnCompletion = nullptr);
+	UE_NONCOPYABLE(FAwaitableBarrier);
+#if UE5CORO_DEBUG
+	~FAwaitableBarrier();
+#endif
+
+	/** co_await the return value to arrive at the barrier, and wait for the
+	 *  other participants to do the same. */
+	[[nodiscard]] Private::FBarrierAwaiter ArriveAndWait();
+
+	/** Arrives at the barrier without waiting, and removes the caller from
+	 *  the participants of every later phase. */
+	void ArriveAndDrop();
+
+private:
+	void Enqueue(Private::FAwaitingPromise&);
+	bool Arrive(Private::FAwaitingPromise* Self);
+};
+
+/**
+ * Awaitable token bucket rate limiter.<br>
+ * Tokens are added continuously at Rate per second, up to Burst, starting
+ * full. co_await Acquire(Num) takes Num tokens, suspending until they become
+ * available.<br>
+ * Waiters are served in FIFO order, and a single timer is used for the entire
+ * queue. They resume on the same kind of named thread that they were
+ * suspended on. Awaiting does not allocate.
+ */
+class UE5CORO_API FAwaitableRateLimiter final
+{
+	friend Private::FRateLimiterAwaiter;
+
+	struct FWaitNode
+	{
+		Private::FPromise* Promise = nullptr;
+		FWaitNode* Next = nullptr;
+		int32 Num = 0;
+		ENamedThreads::Type Thread = ENamedThreads::AnyThread;
+	};
+
+	const double Rate;
+	const double Burst;
+	Private::FMutex Lock;
+	double Tokens;
+	double LastRefill;
+	FWaitNode* Head = nullptr;
+	FWaitNode* Tail = nullptr;
+	/** Reused for every wait, armed while the queue is not empty. */
+	TOptional<Private::FAsyncTimeAwaiter> Timer;
+	bool bArmed = false;
+	// end Lock
+
+public:
+	/** Initializes the rate limiter with a full bucket of Burst tokens. */
+	explicit FAwaitableRateLimiter(double Rate, double Burst);
+	UE_NONCOPYABLE(FAwaitableRateLimiter);
+	~FAwaitableRateLimiter();
+
+	/** co_await the return value to take Num tokens, waiting for them if
+	 *  needed.<br>
+	 *  Num may not be greater than the limiter's burst size. */
+	[[nodiscard]] Private::FRateLimiterAwaiter Acquire(int32 Num = 1);
+
+	/** Takes Num tokens if they're available, and nobody is waiting.
+	 *  @return true if the tokens were taken. */
+	[[nodiscard]] bool TryAcquire(int32 Num = 1);
+
+	/** @return The number of tokens that are currently available. */
+	[[nodiscard]] double GetTokens();
+
+private:
+	void Refill();
+	bool TryEnqueue(FWaitNode&);
+	void Arm();
+	static void OnTimer(void*);
+};
+
+namespace Private
+{
+class [[nodiscard]] UE5CORO_API FEventAwaiter
+	: public TAwaiter<FEventAwaiter>
+{
+	FAwaitableEvent& Event;
+	FAwaitableEvent::FWaitNode Node;
+
+public:
+	explicit FEventAwaiter(FAwaitableEvent& Event, bool bStayOnThread = false)
+		: Event(Event) { Node.bStayOnThread = bStayOnThread; }
+
+	bool await_ready();
+	void Suspend(FPromise&);
+};
+
+class [[nodiscard]] UE5CORO_API FSemaphoreAwaiter
+	: public TAwaiter<FSemaphoreAwaiter>
+{
+	friend FAwaitableSemaphore;
+
+	FAwaitableSemaphore& Semaphore;
+	FAwaitableSemaphore::FWaitNode Node;
+
+public:
+	explicit FSemaphoreAwaiter(FAwaitableSemaphore& Semaphore,
+	                           bool bStayOnThread = false)
+		: Semaphore(Semaphore) { Node.bStayOnThread = bStayOnThread; }
+
 	bool await_ready();
-	void Suspend(Private::FPromise&);
-	void await_resume() noexcept { }
+	void Suspend(FPromise&);
+};
+
+class [[nodiscard]] UE5CORO_API FMutexAwaiter
+	: public TAwaiter<FMutexAwaiter>
+{
+	FAwaitableMutex& Mutex;
+	FAwaitingPromise Node;
+
+public:
+	explicit FMutexAwaiter(FAwaitableMutex& Mutex) : Mutex(Mutex) { }
+
+	bool await_ready();
+	void Suspend(FPromise&);
+	FAwaitableMutex::FScopedLock await_resume();
+};
+
+class [[nodiscard]] UE5CORO_API FRWLockAwaiter
+	: public TAwaiter<FRWLockAwaiter>
+{
+protected:
+	FAwaitableRWLock& RWLock;
+	FAwaitableRWLock::FWaitNode Node;
+
+	explicit FRWLockAwaiter(FAwaitableRWLock& RWLock, bool bExclusive)
+		: RWLock(RWLock)
+	{
+		Node.bExclusive = bExclusive;
+	}
+
+public:
+	bool await_ready();
+	void Suspend(FPromise&);
+};
+
+class [[nodiscard]] FReadLockAwaiter final : public FRWLockAwaiter
+{
+public:
+	explicit FReadLockAwaiter(FAwaitableRWLock& RWLock)
+		: FRWLockAwaiter(RWLock, false) { }
+
+	FAwaitableRWLock::FScopedReadLock await_resume()
+	{
+		return FAwaitableRWLock::FScopedReadLock(RWLock);
+	}
+};
+
+class [[nodiscard]] FWriteLockAwaiter final : public FRWLockAwaiter
+{
+public:
+	explicit FWriteLockAwaiter(FAwaitableRWLock& RWLock)
+		: FRWLockAwaiter(RWLock, true) { }
+
+	FAwaitableRWLock::FScopedWriteLock await_resume()
+	{
+		return FAwaitableRWLock::FScopedWriteLock(RWLock);
+	}
+};
+
+class [[nodiscard]] UE5CORO_API FRateLimiterAwaiter
+	: public TAwaiter<FRateLimiterAwaiter>
+{
+	FAwaitableRateLimiter& Limiter;
+	FAwaitableRateLimiter::FWaitNode Node;
+
+public:
+	explicit FRateLimiterAwaiter(FAwaitableRateLimiter& Limiter, int32 Num)
+		: Limiter(Limiter)
+	{
+		Node.Num = Num;
+	}
+
+	bool await_ready();
+	void Suspend(FPromise&);
+};
+
+class [[nodiscard]] UE5CORO_API FLatchAwaiter
+	: public TAwaiter<FLatchAwaiter>
+{
+	FAwaitableLatch& Latch;
+	FAwaitingPromise Node;
+
+public:
+	explicit FLatchAwaiter(FAwaitableLatch& Latch) : Latch(Latch) { }
+
+	bool await_ready();
+	void Suspend(FPromise&);
+};
+
+class [[nodiscard]] UE5CORO_API FBarrierAwaiter
+	: public TAwaiter<FBarrierAwaiter>
+{
+	FAwaitableBarrier& Barrier;
+	FAwaitingPromise Node;
+
+public:
+	explicit FBarrierAwaiter(FAwaitableBarrier& Barrier) : Barrier(Barrier) { }
+
+	bool await_ready() noexcept { return false; }
+	void Suspend(FPromise&);
+};
+
+template<typename P>
+struct TAwaitTransform<P, FAwaitableEvent>
+{
+	FEventAwaiter operator()(FAwaitableEvent& Event)
+	{
+		return FEventAwaiter(Event);
+	}
+};
+
+template<typename P>
+struct TAwaitTransform<P, FAwaitableSemaphore>
+{
+	FSemaphoreAwaiter operator()(FAwaitableSemaphore& Semaphore)
+	{
+		return FSemaphoreAwaiter(Semaphore);
+	}
+};
+
+template<typename P>
+struct TAwaitTransform<P, FAwaitableLatch>
+{
+	FLatchAwaiter operator()(FAwaitableLatch& Latch)
+	{
+		return FLatchAwaiter(Latch);
+	}
+};
+}
+
+template<typename>
+class TChannel;
+
+namespace Private
+{
+template<typename T>
+class [[nodiscard]] TChannelSendAwaiter
+{
+	TChannel<T>& Channel;
+	FSemaphoreAwaiter Slot;
+	T Value;
+	TOptional<bool> Result;
+
+public:
+	explicit TChannelSendAwaiter(TChannel<T>& Channel, T&& Value)
+		: Channel(Channel), Slot(Channel.Slots), Value(std::move(Value)) { }
+
+	bool await_ready()
+	{
+		if (Channel.bClosed.load())
+		{
+			Result = false;
+			return true;
+		}
+		if (!Slot.await_ready())
+			return false;
+		Result = Channel.Enqueue(std::move(Value));
+		return true;
+	}
+
+	template<typename P>
+	void await_suspend(stdcoro::coroutine_handle<P> Handle)
+	{
+		Slot.await_suspend(Handle);
+	}
+
+	bool await_resume()
+	{
+		if (!Result)
+			Result = Channel.Enqueue(std::move(Value));
+		return *Result;
+	}
+};
+
+template<typename T>
+class [[nodiscard]] TChannelReceiveAwaiter
+{
+protected:
+	TChannel<T>& Channel;
+	FSemaphoreAwaiter Item;
+
+public:
+	explicit TChannelReceiveAwaiter(TChannel<T>& Channel)
+		: Channel(Channel), Item(Channel.Items) { }
+
+	bool await_ready() { return Item.await_ready(); }
+
+	template<typename P>
+	void await_suspend(stdcoro::coroutine_handle<P> Handle)
+	{
+		Item.await_suspend(Handle);
+	}
+
+	TOptional<T> await_resume() { return Channel.Dequeue(); }
+};
+
+template<typename T>
+class [[nodiscard]] TChannelReceiveUpToAwaiter final
+	: public TChannelReceiveAwaiter<T>
+{
+	int Num;
+
+public:
+	explicit TChannelReceiveUpToAwaiter(TChannel<T>& Channel, int Num)
+		: TChannelReceiveAwaiter<T>(Channel), Num(Num) { }
+
+	TArray<T> await_resume()
+	{
+		TArray<T> Values;
+		auto First = this->Channel.Dequeue();
+		if (!First)
+			return Values;
+		Values.Reserve(Num);
+		Values.Add(std::move(*First));
+		while (Values.Num() < Num)
+		{
+			auto Next = this->Channel.TryReceive();
+			if (!Next)
+				break;
+			Values.Add(std::move(*Next));
+		}
+		return Values;
+	}
+};
+
+class [[nodiscard]] FChannelReadableAwaiter final
+{
+	FAwaitableSemaphore& Items;
+	FSemaphoreAwaiter Item;
+
+public:
+	explicit FChannelReadableAwaiter(FAwaitableSemaphore& Items)
+		: Items(Items), Item(Items) { }
+
+	bool await_ready()
+	{
+		if (!Item.await_ready())
+			return false;
+		Items.Unlock(); // Only peeking
+		return true;
+	}
+
+	template<typename P>
+	void await_suspend(stdcoro::coroutine_handle<P> Handle)
+	{
+		Item.await_suspend(Handle);
+	}
+
+	void await_resume() { Items.Unlock(); }
+};
+}
+
+/**
+ * Awaitable multi-producer, multi-consumer FIFO queue.<br>
+ * co_await Receive() suspends while the channel is empty. Bounded channels
+ * apply backpressure: co_await Send() suspends while the channel is full.<br>
+ * Waiting receivers and senders are resumed in FIFO order on the thread that
+ * made room for them or sent them a value, respectively.<br>
+ * Once Close()d, sends fail, and receivers get the remaining values followed
+ * by nothing.
+ */
+template<typename T>
+class TChannel final
+{
+	friend Private::TChannelSendAwaiter<T>;
+	friend Private::TChannelReceiveAwaiter<T>;
+	friend Private::TChannelReceiveUpToAwaiter<T>;
+
+	struct FCell
+	{
+		std::atomic<uint64> Sequence;
+		TTypeCompatibleBytes<T> Value;
+	};
+
+	// Close() adds this many counts to the semaphores below, to let everyone
+	// waiting through. Leave room for them.
+	static constexpr int CloseCount = 1 << 20;
+	static constexpr int MaxCount = MAX_int32 / 2;
+
+	// Bounded: lock-free ring buffer with at least Capacity cells
+	TUniquePtr<FCell[]> Cells;
+	uint64 Mask = 0;
+	std::atomic<uint64> EnqueuePos = 0;
+	std::atomic<uint64> DequeuePos = 0;
+	// Unbounded: enqueueing is lock-free, receivers take turns dequeueing
+	TQueue<TOptional<T>, EQueueMode::Mpsc> Queue;
+	Private::FMutex DequeueLock;
+
+	/** One count per value that's ready to be received. */
+	FAwaitableSemaphore Items;
+	/** One count per value that may be sent without waiting. */
+	FAwaitableSemaphore Slots;
+	std::atomic<int> NumSending = 0;
+	std::atomic<bool> bClosed = false;
+
+public:
+	/** Creates an unbounded channel. Sending to it never suspends. */
+	TChannel()
+		: Items(MaxCount, 0, ESemaphoreOrder::FIFO),
+		  Slots(MaxCount, MaxCount / 2, ESemaphoreOrder::FIFO) { }
+
+	/** Creates a bounded channel, holding up to Capacity values. */
+	explicit TChannel(int Capacity)
+		: Items(MaxCount, 0, ESemaphoreOrder::FIFO),
+		  Slots(MaxCount, Capacity, ESemaphoreOrder::FIFO)
+	{
+		checkf(Capacity > 0 && Capacity <= MaxCount / 2,
+		       TEXT("Invalid channel capacity"));
+		uint64 Size = FMath::RoundUpToPowerOfTwo64(Capacity);
+		Cells = MakeUnique<FCell[]>(Size);
+		for (uint64 i = 0; i < Size; ++i)
+			Cells[i].Sequence.store(i, std::memory_order_relaxed);
+		Mask = Size - 1;
+	}
+
+	UE_NONCOPYABLE(TChannel);
+
+	~TChannel()
+	{
+		if (Cells)
+			for (uint64 i = DequeuePos; i != EnqueuePos; ++i)
+				DestructItem(Cells[i & Mask].Value.GetTypedPtr());
+	}
+
+	/** co_await the return value to send Value to a receiver.<br>
+	 *  This suspends while a bounded channel is full.<br>
+	 *  The result of the co_await expression is false if the channel was
+	 *  closed, and Value was not sent. */
+	[[nodiscard]] Private::TChannelSendAwaiter<T> Send(T Value)
+	{
+		return Private::TChannelSendAwaiter<T>(*this, std::move(Value));
+	}
+
+	/** Sends Value if it doesn't need to wait for room in the channel.
+	 *  @return true if Value was sent. */
+	bool TrySend(T Value)
+	{
+		if (bClosed.load() || !Slots.TryLock())
+			return false;
+		return Enqueue(std::move(Value));
+	}
+
+	/** co_await the return value to receive the next value.<br>
+	 *  The result of the co_await expression is a TOptional<T> that's only
+	 *  unset if the channel was closed and there's nothing left to receive.<br>
+	 *  Do not pass this to WhenAny, the value would be lost if another
+	 *  awaiter finishes first. Use WhenReadable() for that instead. */
+	[[nodiscard]] Private::TChannelReceiveAwaiter<T> Receive()
+	{
+		return Private::TChannelReceiveAwaiter<T>(*this);
+	}
+
+	/** co_await the return value to receive between 1 and Num values at once,
+	 *  waiting for the first one if needed.<br>
+	 *  The result of the co_await expression is a TArray<T> that's only empty
+	 *  if the channel was closed and there's nothing left to receive. */
+	[[nodiscard]] Private::TChannelReceiveUpToAwaiter<T> ReceiveUpTo(int Num)
+	{
+		checkf(Num > 0, TEXT("Invalid receive count"));
+		return Private::TChannelReceiveUpToAwaiter<T>(*this, Num);
+	}
+
+	/** Receives the next value if one is ready.
+	 *  @return The value, or an unset TOptional if there was none. */
+	[[nodiscard]] TOptional<T> TryReceive()
+	{
+		if (!Items.TryLock())
+			return {};
+		return Dequeue();
+	}
+
+	/** co_await the return value to wait until there's a value to receive, or
+	 *  the channel is closed, without receiving anything.<br>
+	 *  Intended for WhenAny over multiple channels, followed by TryReceive()
+	 *  on the one that's readable. TryReceive() can still come up empty if
+	 *  another receiver got there first. */
+	[[nodiscard]] Private::FChannelReadableAwaiter WhenReadable()
+	{
+		return Private::FChannelReadableAwaiter(Items);
+	}
+
+	/** Closes the channel, resuming everyone waiting on it.<br>
+	 *  Values that were already sent can still be received. */
+	void Close()
+	{
+		if (bClosed.exchange(true))
+			return;
+		Slots.Unlock(CloseCount);
+		Items.Unlock(CloseCount);
+	}
+
+	/** @return true if the channel was closed. */
+	[[nodiscard]] bool IsClosed() const { return bClosed.load(); }
 
 private:
-	void TryResumeAll();
+	/** Requires a count from Slots, which is consumed by this call. */
+	bool Enqueue(T&& Value)
+	{
+		// Dequeue relies on this being counted before bClosed is checked
+		++NumSending;
+		if (bClosed.load())
+		{
+			--NumSending;
+			Slots.Unlock();
+			return false;
+		}
+
+		if (Cells)
+		{
+			auto Pos = EnqueuePos.fetch_add(1, std::memory_order_relaxed);
+			auto& Cell = Cells[Pos & Mask];
+			// A receiver might still be moving the previous value out
+			while (Cell.Sequence.load(std::memory_order_acquire) != Pos)
+				FPlatformProcess::YieldThread();
+			new (Cell.Value.GetTypedPtr()) T(std::move(Value));
+			Cell.Sequence.store(Pos + 1, std::memory_order_release);
+		}
+		else
+			Queue.Enqueue(TOptional<T>(std::move(Value)));
+
+		--NumSending;
+		Items.Unlock();
+		return true;
+	}
+
+	/** Requires a count from Items, which is consumed by this call. */
+	TOptional<T> Dequeue()
+	{
+		for (;;)
+		{
+			// The order of these reads matters, see Enqueue
+			bool bWasClosed = bClosed.load();
+			bool bWasSending = NumSending.load() > 0;
+			TOptional<T> Value;
+			if (TryDequeue(Value))
+			{
+				Slots.Unlock();
+				return Value;
+			}
+			if (bWasClosed && !bWasSending)
+			{
+				// This was a count from Close(), let others have it too
+				Items.Unlock();
+				return Value;
+			}
+			// A real count's value is still being enqueued, this is short
+			FPlatformProcess::YieldThread();
+		}
+	}
+
+	bool TryDequeue(TOptional<T>& Value)
+	{
+		if (!Cells)
+		{
+			std::scoped_lock _(DequeueLock);
+			return Queue.Dequeue(Value);
+		}
+
+		auto Pos = DequeuePos.load(std::memory_order_relaxed);
+		do
+			if (Pos == EnqueuePos.load(std::memory_order_acquire))
+				return false;
+		while (!DequeuePos.compare_exchange_weak(Pos, Pos + 1,
+		                                         std::memory_order_relaxed));
+
+		auto& Cell = Cells[Pos & Mask];
+		while (Cell.Sequence.load(std::memory_order_acquire) != Pos + 1)
+			FPlatformProcess::YieldThread();
+		T* Ptr = Cell.Value.GetTypedPtr();
+		Value.Emplace(std::move(*Ptr));
+		DestructItem(Ptr);
+		Cell.Sequence.store(Pos + Mask + 1, std::memory_order_release);
+		return true;
+	}
 };
 
+template<typename>
+class TAwaitableValue;
+
 namespace Private
 {
-struct FAwaitingPromise
+template<typename T, typename F>
+class [[nodiscard]] TAwaitableValueAwaiter final
+	: public TAwaiter<TAwaitableValueAwaiter<T, F>>
 {
-	FPromise* Promise;
-	FAwaitingPromise* Next;
+	using FNode = typename TAwaitableValue<T>::FNode;
+
+	TAwaitableValue<T>& Owner;
+	F Predicate;
+	FNode Node;
+	bool bCheckNow;
+
+public:
+	explicit TAwaitableValueAwaiter(TAwaitableValue<T>& Owner, F Predicate,
+	                                bool bCheckNow)
+		: Owner(Owner), Predicate(std::move(Predicate)), bCheckNow(bCheckNow)
+	{
+		Node.Test = &Test;
+		Node.Context = this;
+	}
+	UE_NONCOPYABLE(TAwaitableValueAwaiter);
+
+	bool await_ready()
+	{
+		return bCheckNow && Owner.TryReady(Node);
+	}
+
+	void Suspend(FPromise& Promise)
+	{
+		Node.Promise = &Promise;
+		if (!Owner.TryEnqueue(Node, bCheckNow))
+			Promise.Resume(); // Set in the meantime
+	}
+
+	T await_resume() { return std::move(*Node.Result); }
+
+private:
+	static bool Test(FNode& Node, const T& Value)
+	{
+		auto* This = static_cast<TAwaitableValueAwaiter*>(Node.Context);
+		return std::invoke(This->Predicate, Value);
+	}
 };
 }
+
+/**
+ * Value that coroutines can wait on to change, instead of polling it.<br>
+ * co_await Until(Predicate) suspends until the value satisfies Predicate, and
+ * co_await Changed() until the next Set(). Predicates are only evaluated when
+ * the value is written, on the writing thread, with an internal lock held.<br>
+ * Waiting coroutines are resumed on the thread that Set() the value, after
+ * the lock is released. Awaiting does not allocate.<br>
+ * The result of both co_await expressions is a copy of the value that
+ * resumed the coroutine, which might have been overwritten since.
+ */
+template<typename T>
+class TAwaitableValue final
+{
+	template<typename, typename>
+	friend class Private::TAwaitableValueAwaiter;
+
+	struct FNode
+	{
+		Private::FPromise* Promise = nullptr;
+		FNode* Next = nullptr;
+		bool (*Test)(FNode&, const T&) = nullptr;
+		void* Context = nullptr;
+		TOptional<T> Result;
+	};
+
+	mutable Private::FMutex Lock;
+	T Value;
+	FNode* Head = nullptr;
+
+public:
+	template<typename... A>
+	explicit TAwaitableValue(A&&... Args) : Value(std::forward<A>(Args)...) { }
+	UE_NONCOPYABLE(TAwaitableValue);
+
+#if UE5CORO_DEBUG
+	~TAwaitableValue()
+	{
+		ensureMsgf(!Head,
+		           TEXT("Awaitable value destroyed with active awaiters"));
+	}
+#endif
+
+	/** @return A copy of the current value. */
+	[[nodiscard]] T Get() const
+	{
+		std::scoped_lock _(Lock);
+		return Value;
+	}
+
+	/** Overwrites the value, and resumes the coroutines that were waiting for
+	 *  it, either any change or one that satisfies their predicate. */
+	void Set(T NewValue)
+	{
+		FNode* Ready = nullptr;
+		{
+			std::scoped_lock _(Lock);
+			Value = std::move(NewValue);
+			for (FNode** Link = &Head; *Link;)
+			{
+				FNode* Node = *Link;
+				if (Node->Test(*Node, Value))
+				{
+					*Link = Node->Next;
+					Node->Result.Emplace(Value);
+					Node->Next = Ready;
+					Ready = Node;
+				}
+				else
+					Link = &Node->Next;
+			}
+		}
+
+		while (Ready)
+		{
+			// The node is gone as soon as its coroutine resumes
+			auto* Promise = Ready->Promise;
+			Ready = Ready->Next;
+			Promise->Resume();
+		}
+	}
+
+	/** co_await the return value to wait until Predicate returns true when
+	 *  called with the value. This doesn't suspend if it already does. */
+	template<typename F>
+	[[nodiscard]] auto Until(F Predicate)
+	{
+		static_assert(std::is_invocable_r_v<bool, F&, const T&>,
+		              "Predicate must be callable with const T&");
+		return Private::TAwaitableValueAwaiter<T, F>(*this,
+		                                             std::move(Predicate),
+		                                             true);
+	}
+
+	/** co_await the return value to wait for the next Set(). */
+	[[nodiscard]] auto Changed()
+	{
+		auto Any = [](const T&) { return true; };
+		return Private::TAwaitableValueAwaiter<T, decltype(Any)>(*this, Any,
+		                                                         false);
+	}
+
+private:
+	bool TryReady(FNode& Node)
+	{
+		std::scoped_lock _(Lock);
+		if (!Node.Test(Node, Value))
+			return false;
+		Node.Result.Emplace(Value);
+		return true;
+	}
+
+	bool TryEnqueue(FNode& Node, bool bCheckNow)
+	{
+		std::scoped_lock _(Lock);
+		// Check again, the value might have been set since await_ready
+		if (bCheckNow && Node.Test(Node, Value))
+		{
+			Node.Result.Emplace(Value);
+			return false;
+		}
+		Node.Next = Head;
+		Head = &Node;
+		return true;
+	}
+};
 }
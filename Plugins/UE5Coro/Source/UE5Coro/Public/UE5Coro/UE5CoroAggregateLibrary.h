@@ -0,0 +1,66 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UE5Coro/Definitions.h"
+#include "Engine/LatentActionManager.h"
+#include "Kismet/BlueprintFunctionLibrary.h"
+#include "UE5Coro/Coroutine.h"
+#include "UE5CoroAggregateLibrary.generated.h"
+
+/**
+ * Latent joins over coroutines that were started from Blueprint.<br>
+ * These are used by the "Run Coroutines in Parallel" node, and are not meant to
+ * be called directly.
+ */
+UCLASS(Hidden)
+class UE5CORO_API UUE5CoroAggregateLibrary final
+	: public UBlueprintFunctionLibrary
+{
+	GENERATED_BODY()
+
+public:
+	/** Completes when every coroutine in the array has completed. */
+	UFUNCTION(BlueprintCallable, BlueprintInternalUseOnly,
+	          meta = (Latent, LatentInfo = "LatentInfo"))
+	static FAsyncCoroutine WaitForAll(const TArray<FAsyncCoroutine>& Coroutines,
+	                                  FLatentActionInfo LatentInfo);
+
+	/** Completes when the first coroutine in the array has completed.<br>
+	 *  Winner receives its index, or -1 if the array was empty. */
+	UFUNCTION(BlueprintCallable, BlueprintInternalUseOnly,
+	          meta = (Latent, LatentInfo = "LatentInfo"))
+	static FAsyncCoroutine WaitForAny(const TArray<FAsyncCoroutine>& Coroutines,
+	                                  int32& Winner,
+	                                  FLatentActionInfo LatentInfo);
+};
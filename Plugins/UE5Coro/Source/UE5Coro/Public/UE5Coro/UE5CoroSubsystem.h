@@ -33,12 +33,20 @@
 
 #include "CoreMinimal.h"
 #include "UE5Coro/Definitions.h"
+#include "Engine/EngineBaseTypes.h"
 #include "Engine/LatentActionManager.h"
 #include "Subsystems/WorldSubsystem.h"
 #include "UE5CoroSubsystem.generated.h"
 
+class UUE5CoroSubsystem;
+
 namespace UE5Coro::Private
 {
+class FAsyncPromise;
+class FChainState;
+class FLatentAwaiter;
+class FTickGroupAwaiter;
+
 class [[nodiscard]] UE5CORO_API FTwoLives
 {
 	std::atomic<int> RefCount = 2;
@@ -46,11 +54,77 @@ class [[nodiscard]] UE5CORO_API FTwoLives
 public:
 	int UserData = 0;
 
+	virtual ~FTwoLives() = default;
+
 	bool Release(); // Dangerous! Only call externally exactly once!
 
 	// Generic implementation for FLatentAwaiter
 	static bool ShouldResume(void* State, bool bCleanup);
 };
+
+/** The point in time when a FLatentAwaiter is known to become ready. */
+struct [[nodiscard]] FLatentDeadline
+{
+	enum EClock : uint8
+	{
+		FrameCounter,
+		GameTime,
+		UnpausedTime,
+		RealTime,
+		AudioTime,
+		NumClocks,
+		None = NumClocks,
+	};
+
+	double Time = 0;
+	EClock Clock = None;
+
+	/** Returns the deadline of time-based awaiters, or None for the rest. */
+	static FLatentDeadline Of(const FLatentAwaiter&);
+};
+
+/** Latent awaiters that report becoming ready instead of being polled. */
+struct [[nodiscard]] UE5CORO_API FLatentReadyCallback
+{
+	/** Binds an awaiter's state to call UUE5CoroSubsystem::ResumeReady(Promise)
+	 *  once it's ready. The awaiter's Resume function is responsible for
+	 *  unbinding if it's cleaned up before that happens. */
+	using FBinder = bool (*)(void* State, UUE5CoroSubsystem&, FAsyncPromise&);
+
+	/** Arranges for UUE5CoroSubsystem::ResumeReady(Promise) to be called once
+	 *  the awaiter becomes ready.
+	 *  @return False if the awaiter doesn't support this and needs polling. */
+	static bool TryBind(FLatentAwaiter&, UUE5CoroSubsystem&, FAsyncPromise&);
+
+	/** Lets awaiters from other modules, identified by their Resume function,
+	 *  opt out of polling. */
+	static void Register(bool (*Resume)(void*, bool), FBinder);
+	static void Unregister(bool (*Resume)(void*, bool));
+};
+
+/** Statistics about UE5Coro.LatentResumeBudget's effects in a world. */
+struct FLatentResumeStats
+{
+	/** Number of async coroutines that were ready but had to wait. */
+	uint64 NumDeferred = 0;
+	/** Number of times a latent coroutine was not polled due to the budget. */
+	uint64 NumSkippedPolls = 0;
+	/** Total and worst added latency of deferred async coroutines. */
+	double TotalAddedLatency = 0;
+	double MaxAddedLatency = 0;
+};
+
+/** Resumes the coroutines waiting for a single tick group in a world. */
+struct FTickGroupFunction final : FTickFunction
+{
+	UUE5CoroSubsystem* Subsystem = nullptr;
+
+	virtual void ExecuteTick(float DeltaTime, ELevelTick TickType,
+	                         ENamedThreads::Type CurrentThread,
+	                         const FGraphEventRef& CompletionGraphEvent)
+		override;
+	virtual FString DiagnosticMessage() override;
+};
 }
 
 /**
@@ -61,27 +135,119 @@ UCLASS(Hidden)
 class UE5CORO_API UUE5CoroSubsystem final : public UTickableWorldSubsystem
 {
 	GENERATED_BODY()
+	friend UE5Coro::Private::FTickGroupFunction;
 
 	UPROPERTY()
 	TMap<int32, class UUE5CoroChainCallbackTarget*> ChainCallbackTargets;
+	/** Used by every chain if UE5Coro.SharedChainCallbackTarget is set. */
+	UPROPERTY()
+	UUE5CoroChainCallbackTarget* SharedChainCallbackTarget = nullptr;
 	int32 NextLinkage = 0;
-	FDelegateHandle LatentActionsChangedHandle;
+	TArray<TPair<UE5Coro::Private::FAsyncPromise*,
+	             UE5Coro::Private::FLatentAwaiter*>> PendingAwaiters;
+	/** Coroutines waiting for a FLatentReadyCallback, these cost nothing
+	 *  per tick. */
+	TSet<UE5Coro::Private::FAsyncPromise*> CallbackAwaiters;
+	/** Coroutines that became ready from a callback, resumed next Tick. */
+	TArray<UE5Coro::Private::FAsyncPromise*> ReadyAwaiters;
+	/** Min-heaps of awaiters that are only polled when they're due. */
+	TArray<TTuple<double, UE5Coro::Private::FAsyncPromise*>>
+		Deadlines[UE5Coro::Private::FLatentDeadline::NumClocks];
+	/** Ready coroutines waiting for budget, heap ordered by priority and
+	 *  sequence number. The double is the time when they were deferred. */
+	TArray<TTuple<int8, uint64, double, UE5Coro::Private::FAsyncPromise*>>
+		Deferred;
+	/** Coroutines waiting for Latent::NextTick(ETickingGroup). */
+	TArray<UE5Coro::Private::FTickGroupAwaiter*>
+		TickGroupAwaiters[TG_NewlySpawned];
+	/** The group that's currently being resumed. Awaiters that are destroyed
+	 *  before their turn are replaced with nullptr. */
+	TArray<UE5Coro::Private::FTickGroupAwaiter*> ResumingTickGroup;
+	/** Registered together on first use, only in game worlds. */
+	TUniquePtr<UE5Coro::Private::FTickGroupFunction>
+		TickGroupFunctions[TG_NewlySpawned];
+	/** Minimum seconds between polls of every latent coroutine whose
+	 *  latent action is on the object. */
+	TMap<TObjectKey<UObject>, float> PollIntervals;
+	uint64 NextDeferredSequence = 0;
+	uint64 BudgetFrame = 0;
+	double BudgetSpent = 0;
+	UE5Coro::Private::FLatentResumeStats ResumeStats;
 
 public:
 	/** Creates a unique LatentInfo that does not lead anywhere. */
 	FLatentActionInfo MakeLatentInfo();
 
 	/** Creates a LatentInfo suitable for the Latent::Chain* functions. */
-	FLatentActionInfo MakeLatentInfo(UE5Coro::Private::FTwoLives* State);
+	FLatentActionInfo MakeLatentInfo(UE5Coro::Private::FChainState* State);
+
+	/** Stops keeping the per-chain callback target for Link alive. */
+	void ReleaseChainCallbackTarget(int32 Link);
+
+	/** Resumes Promise when Awaiter is ready.<br>
+	 *  This is a lightweight alternative to a latent action per awaiter.
+	 *  Time-based awaiters are kept sorted and only checked when they're due,
+	 *  everything else is polled every tick. */
+	void AddPendingAwaiter(UE5Coro::Private::FAsyncPromise& Promise,
+	                       UE5Coro::Private::FLatentAwaiter& Awaiter);
+
+	/** Schedules a coroutine that was bound by FLatentReadyCallback to be
+	 *  resumed during the next tick. */
+	void ResumeReady(UE5Coro::Private::FAsyncPromise& Promise);
+
+	/** Resumes the awaiter's coroutine the next time its tick group runs in
+	 *  this world, which may be later in the current frame. */
+	void AddTickGroupAwaiter(UE5Coro::Private::FTickGroupAwaiter& Awaiter);
+
+	/** Forgets an awaiter that was destroyed before it could resume. */
+	void RemoveTickGroupAwaiter(UE5Coro::Private::FTickGroupAwaiter& Awaiter);
+
+	/** Returns statistics about UE5Coro.LatentResumeBudget in this world. */
+	const UE5Coro::Private::FLatentResumeStats& GetResumeStats() const
+	{
+		return ResumeStats;
+	}
+
+	/** Checks if coroutines with the given priority may be resumed now. */
+	bool HasResumeBudget(int8 Priority);
+
+	/** Counts time spent resuming coroutines against this frame's budget. */
+	void ChargeResumeBudget(double Seconds);
+
+	/** Returns the seconds left in this frame's budget, not counting the
+	 *  coroutine that's currently being resumed. */
+	double GetResumeBudgetLeft();
+
+	/** Records that a latent coroutine was not polled due to the budget. */
+	void SkipPoll() { ++ResumeStats.NumSkippedPolls; }
+
+	/** Returns the poll interval set for latent coroutines on Object. */
+	float GetPollInterval(const UObject* Object) const
+	{
+		if (PollIntervals.Num() == 0)
+			return 0;
+		auto* Interval = PollIntervals.Find(Object);
+		return Interval ? *Interval : 0;
+	}
+
+	/** Sets the poll interval of latent coroutines on Object, 0 removes it. */
+	void SetPollInterval(const UObject* Object, float Seconds);
 
 #pragma region UTickableWorldSubsystem overrides
 	virtual void Deinitialize() override;
 	virtual bool IsTickableWhenPaused() const override { return true; }
-	virtual bool IsTickableInEditor() const override { return true; }
+	virtual bool IsTickableInEditor() const override;
 	virtual void Tick(float DeltaTime) override;
 	virtual TStatId GetStatId() const override;
 #pragma endregion
 
 private:
-	void LatentActionsChanged(UObject* Object, ELatentActionChangeType Change);
+	void TickDeferred();
+	void TickReadyAwaiters();
+	void TickPendingAwaiters();
+	void TickDeadlines();
+	void TickGroup(ETickingGroup);
+	void ResumeOrDefer(UE5Coro::Private::FAsyncPromise*);
+	void ResumeTimed(UE5Coro::Private::FAsyncPromise*);
+	double GetClock(UE5Coro::Private::FLatentDeadline::EClock) const;
 };
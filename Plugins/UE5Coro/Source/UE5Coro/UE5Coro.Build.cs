@@ -38,7 +38,19 @@ public class UE5Coro : UE5CoroModuleRules
 	{
 		PublicDependencyModuleNames.AddRange(new[]
 		{
+			"AssetRegistry",
 			"HTTP",
+			"RenderCore",
+			"RHI",
+		});
+
+		PrivateDependencyModuleNames.AddRange(new[]
+		{
+			"Chaos",
+			"Json",
+			"JsonUtilities",
+			"PhysicsCore",
+			"Sockets",
 		});
 	}
 }
@@ -0,0 +1,124 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "Benchmark.h"
+#include "Containers/SortedMap.h"
+#include "Dom/JsonObject.h"
+#include "Misc/App.h"
+#include "Misc/CommandLine.h"
+#include "Misc/EngineVersion.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonSerializer.h"
+
+using namespace UE5Coro::Private::Benchmark;
+
+namespace
+{
+struct FResult
+{
+	int64 Ops;
+	double NsPerOp; // Median
+	double P99NsPerOp;
+	double AllocationsPerOp; // Negative if unknown
+};
+
+// Game thread only, sorted by name for stable diffs
+TSortedMap<FString, FResult> GResults;
+
+FString OutputPath()
+{
+	FString Path;
+	if (!FParse::Value(FCommandLine::Get(), TEXT("UE5CoroBenchmarkOutput="),
+	                   Path))
+		Path = FPaths::ProjectSavedDir() / TEXT("Benchmarks/UE5Coro.json");
+	return Path;
+}
+
+void WriteReport()
+{
+	auto Root = MakeShared<FJsonObject>();
+	Root->SetStringField(TEXT("engine"),
+	                     FEngineVersion::Current().ToString());
+	Root->SetStringField(TEXT("configuration"),
+	                     LexToString(FApp::GetBuildConfiguration()));
+	TArray<TSharedPtr<FJsonValue>> Results;
+	for (auto& [Name, Result] : GResults)
+	{
+		auto Object = MakeShared<FJsonObject>();
+		Object->SetStringField(TEXT("name"), Name);
+		Object->SetNumberField(TEXT("ops"), Result.Ops);
+		Object->SetNumberField(TEXT("ns_per_op"), Result.NsPerOp);
+		Object->SetNumberField(TEXT("p99_ns_per_op"), Result.P99NsPerOp);
+		if (Result.AllocationsPerOp >= 0)
+			Object->SetNumberField(TEXT("frame_allocations_per_op"),
+			                       Result.AllocationsPerOp);
+		Results.Add(MakeShared<FJsonValueObject>(Object));
+	}
+	Root->SetArrayField(TEXT("results"), Results);
+
+	FString Json;
+	auto Writer = TJsonWriterFactory<>::Create(&Json);
+	FJsonSerializer::Serialize(Root, Writer);
+	FFileHelper::SaveStringToFile(Json, *OutputPath());
+}
+}
+
+void UE5Coro::Private::Benchmark::Report(FAutomationTestBase& Test,
+                                         const FString& Name, int64 Ops,
+                                         TArray<double> SampleSeconds,
+                                         uint64 FrameAllocations)
+{
+	checkf(IsInGameThread(),
+	       TEXT("Benchmarks are expected to run on the game thread"));
+	checkf(Ops > 0 && SampleSeconds.Num() > 0,
+	       TEXT("Nothing was measured for %s"), *Name);
+	SampleSeconds.Sort();
+	int32 Num = SampleSeconds.Num();
+	int32 P99 = FMath::Min(Num - 1, FMath::CeilToInt(Num * 0.99) - 1);
+
+	FResult Result;
+	Result.Ops = Ops;
+	Result.NsPerOp = SampleSeconds[Num / 2] * 1e9 / Ops;
+	Result.P99NsPerOp = SampleSeconds[P99] * 1e9 / Ops;
+#if UE5CORO_FRAME_POOL
+	Result.AllocationsPerOp = static_cast<double>(FrameAllocations) /
+	                          (static_cast<double>(Ops) * Num);
+#else
+	Result.AllocationsPerOp = -1;
+#endif
+	GResults.Add(Name, Result);
+
+	Test.AddInfo(FString::Printf(
+		TEXT("%s: %.1f ns/op, p99 %.1f ns/op, %.2f frame allocations/op"),
+		*Name, Result.NsPerOp, Result.P99NsPerOp, Result.AllocationsPerOp));
+	WriteReport();
+}
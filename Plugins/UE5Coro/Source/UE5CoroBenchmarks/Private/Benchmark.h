@@ -0,0 +1,69 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "UE5Coro/FrameAllocator.h"
+
+namespace UE5Coro::Private::Benchmark
+{
+/** Adds one measurement to the test's output and the JSON report.<br>
+ *  The report is written to Saved/Benchmarks/UE5Coro.json, or the path given
+ *  by -UE5CoroBenchmarkOutput=, after every call. */
+void Report(FAutomationTestBase& Test, const FString& Name, int64 Ops,
+            TArray<double> SampleSeconds, uint64 FrameAllocations);
+
+/** Calls Fn once to warm up, then times it Samples times.<br>
+ *  Every call of Fn is expected to perform Ops operations. */
+template<typename F>
+void Measure(FAutomationTestBase& Test, const FString& Name, int64 Ops,
+             int32 Samples, F&& Fn)
+{
+	Fn();
+	TArray<double> Seconds;
+	Seconds.Reserve(Samples);
+	auto Before = FFrameAllocator::GetStats();
+	for (int32 i = 0; i < Samples; ++i)
+	{
+		double Start = FPlatformTime::Seconds();
+		Fn();
+		Seconds.Add(FPlatformTime::Seconds() - Start);
+	}
+	auto After = FFrameAllocator::GetStats();
+	Report(Test, Name, Ops, std::move(Seconds),
+	       After.Allocations - Before.Allocations);
+}
+
+/** Concurrency levels for the scaling runs. */
+inline constexpr int32 ScalingCounts[] = {1000, 10000, 100000};
+}
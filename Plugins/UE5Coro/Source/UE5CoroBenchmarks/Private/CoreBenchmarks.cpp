@@ -0,0 +1,204 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "Benchmark.h"
+#include "UE5Coro/AggregateAwaiters.h"
+#include "UE5Coro/AsyncAwaiters.h"
+#include "UE5Coro/Threading.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Private::Benchmark;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FStartBenchmark, "UE5Coro.Benchmarks.Start",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::MediumPriority |
+                                 EAutomationTestFlags::PerfFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FReadyAwaitBenchmark,
+                                 "UE5Coro.Benchmarks.ReadyAwait",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::MediumPriority |
+                                 EAutomationTestFlags::PerfFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMoveToThreadBenchmark,
+                                 "UE5Coro.Benchmarks.MoveToThread",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::MediumPriority |
+                                 EAutomationTestFlags::PerfFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSemaphoreBenchmark,
+                                 "UE5Coro.Benchmarks.Semaphore",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::MediumPriority |
+                                 EAutomationTestFlags::PerfFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FWhenAllBenchmark,
+                                 "UE5Coro.Benchmarks.WhenAll",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::MediumPriority |
+                                 EAutomationTestFlags::PerfFilter)
+
+namespace
+{
+TCoroutine<> Empty()
+{
+	co_return;
+}
+
+TCoroutine<> AwaitEvent(FAwaitableEvent& Event)
+{
+	co_await Event;
+}
+
+TCoroutine<> AwaitReady(const TCoroutine<>& Ready, int32 Count)
+{
+	for (int32 i = 0; i < Count; ++i)
+		co_await Ready;
+}
+
+TCoroutine<> PingPong(int32 Count)
+{
+	for (int32 i = 0; i < Count; ++i)
+	{
+		co_await Async::MoveToThread(ENamedThreads::AnyBackgroundThreadNormalTask);
+		co_await Async::MoveToThread(ENamedThreads::GameThread);
+	}
+}
+
+TCoroutine<> Contend(FAwaitableSemaphore& Semaphore, int32 Count)
+{
+	co_await Async::MoveToThread(ENamedThreads::AnyBackgroundThreadNormalTask);
+	for (int32 i = 0; i < Count; ++i)
+	{
+		co_await Semaphore;
+		// Move away before unlocking, otherwise resumptions would nest
+		co_await Async::Yield();
+		Semaphore.Unlock();
+	}
+}
+
+TCoroutine<> AwaitAll(const TArray<TCoroutine<>>& Coros)
+{
+	co_await WhenAll(Coros);
+}
+}
+
+bool FStartBenchmark::RunTest(const FString& Parameters)
+{
+	constexpr int32 Count = 10000;
+	Measure(*this, TEXT("Start.Immediate"), Count, 50, []
+	{
+		for (int32 i = 0; i < Count; ++i)
+			Empty();
+	});
+
+	// Start N coroutines that are all suspended at the same time, then let
+	// them finish
+	for (int32 N : ScalingCounts)
+	{
+		TArray<TCoroutine<>> Coros;
+		Coros.Reserve(N);
+		Measure(*this, FString::Printf(TEXT("Start.Suspended.%d"), N), N,
+		        N >= 100000 ? 5 : 20, [&]
+		{
+			FAwaitableEvent Event(EEventMode::ManualReset);
+			for (int32 i = 0; i < N; ++i)
+				Coros.Add(AwaitEvent(Event));
+			Event.Trigger();
+			Coros.Reset();
+		});
+	}
+	return true;
+}
+
+bool FReadyAwaitBenchmark::RunTest(const FString& Parameters)
+{
+	constexpr int32 Count = 100000;
+	auto Ready = Empty();
+	TestTrue(TEXT("Ready"), Ready.IsDone());
+	Measure(*this, TEXT("ReadyAwait"), Count, 50, [&]
+	{
+		AwaitReady(Ready, Count);
+	});
+	return true;
+}
+
+bool FMoveToThreadBenchmark::RunTest(const FString& Parameters)
+{
+	constexpr int32 Count = 1000;
+	Measure(*this, TEXT("MoveToThread.RoundTrip"), Count, 10, []
+	{
+		auto Coro = PingPong(Count);
+		while (!Coro.IsDone())
+			FTaskGraphInterface::Get().ProcessThreadUntilIdle(
+				ENamedThreads::GameThread);
+	});
+	return true;
+}
+
+bool FSemaphoreBenchmark::RunTest(const FString& Parameters)
+{
+	constexpr int32 NumWorkers = 32;
+	constexpr int32 Count = 500;
+	for (int32 Capacity : {1, 4})
+		Measure(*this, FString::Printf(TEXT("Semaphore.Capacity%d"), Capacity),
+		        NumWorkers * Count, 5, [&]
+		{
+			FAwaitableSemaphore Semaphore(Capacity, Capacity);
+			TArray<TCoroutine<>> Workers;
+			for (int32 i = 0; i < NumWorkers; ++i)
+				Workers.Add(Contend(Semaphore, Count));
+			for (auto& Coro : Workers)
+				Coro.Wait();
+		});
+	return true;
+}
+
+bool FWhenAllBenchmark::RunTest(const FString& Parameters)
+{
+	for (int32 N : ScalingCounts)
+	{
+		TArray<TCoroutine<>> Coros;
+		Coros.Reserve(N);
+		Measure(*this, FString::Printf(TEXT("WhenAll.%d"), N), N,
+		        N >= 100000 ? 5 : 20, [&]
+		{
+			FAwaitableEvent Event(EEventMode::ManualReset);
+			for (int32 i = 0; i < N; ++i)
+				Coros.Add(AwaitEvent(Event));
+			auto All = AwaitAll(Coros);
+			Event.Trigger();
+			TestTrue(TEXT("WhenAll completed"), All.IsDone());
+			Coros.Reset();
+		});
+	}
+	return true;
+}
@@ -0,0 +1,70 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "Benchmark.h"
+#include "TestWorld.h"
+#include "UE5Coro/LatentAwaiters.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Private::Benchmark;
+using namespace UE5Coro::Private::Test;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FNextTickBenchmark,
+                                 "UE5Coro.Benchmarks.NextTick",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::MediumPriority |
+                                 EAutomationTestFlags::PerfFilter)
+
+bool FNextTickBenchmark::RunTest(const FString& Parameters)
+{
+	for (int32 N : ScalingCounts)
+	{
+		FTestWorld World;
+		bool bStop = false;
+		int32 Stopped = 0;
+		for (int32 i = 0; i < N; ++i)
+			World.Run([&]() -> TCoroutine<>
+			{
+				while (!bStop)
+					co_await Latent::NextTick();
+				++Stopped;
+			});
+
+		// Every tick resumes every coroutine once
+		Measure(*this, FString::Printf(TEXT("NextTick.%d"), N), N,
+		        N >= 100000 ? 10 : 30, [&] { World.Tick(0); });
+
+		bStop = true;
+		World.Tick(0);
+		TestEqual(TEXT("Every coroutine finished"), Stopped, N);
+	}
+	return true;
+}
@@ -34,6 +34,7 @@
 #include "BlueprintNodeSpawner.h"
 #include "EdGraphSchema_K2.h"
 #include "UE5Coro/AsyncCoroutine.h"
+#include "UE5Coro/UE5CoroAggregateLibrary.h"
 #include "UObject/Class.h"
 #include "UObject/Field.h"
 #include "UObject/UnrealType.h"
@@ -48,18 +49,24 @@ void UK2Node_UE5CoroCallCoroutine::CustomizeNode(UEdGraphNode* NewNode, bool,
 	This->SetFromFunction(Function);
 }
 
+bool UK2Node_UE5CoroCallCoroutine::IsBlueprintCoroutine(const UFunction* Fn)
+{
+	auto* Return = CastField<FStructProperty>(Fn->GetReturnProperty());
+	if (LIKELY(!Return || Return->Struct != FAsyncCoroutine::StaticStruct()))
+		return false;
+	// Helpers for other nodes are not meant to be called directly
+	return Fn->HasAllFunctionFlags(FUNC_BlueprintCallable) &&
+	       Fn->GetOwnerClass() != UUE5CoroAggregateLibrary::StaticClass();
+}
+
 void UK2Node_UE5CoroCallCoroutine::GetMenuActions(
 	FBlueprintActionDatabaseRegistrar& BlueprintActionDatabaseRegistrar) const
 {
 	auto* Struct = FAsyncCoroutine::StaticStruct();
 	// Sign up for every BPCallable UFUNCTION that returns a FAsyncCoroutine
 	for (auto* Fn : TObjectRange<UFunction>())
-		if (auto* Return = CastField<FStructProperty>(Fn->GetReturnProperty());
-		    UNLIKELY(Return && Return->Struct == Struct))
+		if (UNLIKELY(IsBlueprintCoroutine(Fn)))
 		{
-			if (!Fn->HasAllFunctionFlags(FUNC_BlueprintCallable))
-				continue;
-
 			// Patch the UFUNCTION to hide the regular function call
 			Fn->SetMetaData(FBlueprintMetadata::MD_BlueprintInternalUseOnly,
 			                TEXT("true"));
@@ -45,6 +45,10 @@ class UE5COROK2_API UK2Node_UE5CoroCallCoroutine : public UK2Node_CallFunction
 	static void CustomizeNode(UEdGraphNode*, bool, UFunction*);
 
 public:
+	/** Returns true for BlueprintCallable coroutines that nodes should be
+	 *  offered for. */
+	static bool IsBlueprintCoroutine(const UFunction*);
+
 	virtual void GetMenuActions(FBlueprintActionDatabaseRegistrar&) const override;
 	virtual void PostParameterPinCreated(UEdGraphPin*) override;
 };
@@ -0,0 +1,293 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "K2Node_UE5CoroRunInParallel.h"
+#include "BlueprintActionDatabaseRegistrar.h"
+#include "BlueprintNodeSpawner.h"
+#include "EdGraphSchema_K2.h"
+#include "K2Node_CallFunction.h"
+#include "K2Node_ExecutionSequence.h"
+#include "K2Node_MakeArray.h"
+#include "K2Node_UE5CoroCallCoroutine.h"
+#include "KismetCompiler.h"
+#include "Kismet2/BlueprintEditorUtils.h"
+#include "UE5Coro/AsyncCoroutine.h"
+#include "UE5Coro/UE5CoroAggregateLibrary.h"
+#include "UObject/UObjectIterator.h"
+
+#define LOCTEXT_NAMESPACE "UE5Coro"
+
+namespace
+{
+const FName WinnerPinName(TEXT("Winner"));
+}
+
+void UK2Node_UE5CoroRunInParallel::CustomizeNode(UEdGraphNode* NewNode, bool,
+                                                 UFunction* Function)
+{
+	auto* This = CastChecked<ThisClass>(NewNode);
+	This->FunctionReference.SetFromField<UFunction>(Function, false);
+}
+
+bool UK2Node_UE5CoroRunInParallel::IsCallParameter(const UFunction* Function,
+                                                   const FProperty* Param)
+{
+	if (Param->HasAnyPropertyFlags(CPF_ReturnParm))
+		return false;
+	// Output parameters are not supported, but inputs by reference are
+	if (Param->HasAnyPropertyFlags(CPF_OutParm) &&
+	    !Param->HasAnyPropertyFlags(CPF_ReferenceParm))
+		return false;
+
+	// These are filled in automatically by the BP compiler or ignored
+	FString Name = Param->GetName();
+	if (Name == Function->GetMetaData(FBlueprintMetadata::MD_LatentInfo) ||
+	    Name == Function->GetMetaData(FBlueprintMetadata::MD_WorldContext))
+		return false;
+	auto* Struct = CastField<FStructProperty>(Param);
+	return !Struct || Struct->Struct != FForceLatentCoroutine::StaticStruct();
+}
+
+FName UK2Node_UE5CoroRunInParallel::GetCallPinName(const FProperty* Param,
+                                                   int32 Index)
+{
+	return *FString::Printf(TEXT("%s_%d"), *Param->GetName(), Index);
+}
+
+UFunction* UK2Node_UE5CoroRunInParallel::GetTargetFunction() const
+{
+	return FunctionReference.ResolveMember<UFunction>(
+		GetBlueprintClassFromNode());
+}
+
+void UK2Node_UE5CoroRunInParallel::AllocateDefaultPins()
+{
+	auto* Schema = GetDefault<UEdGraphSchema_K2>();
+	CreatePin(EGPD_Input, UEdGraphSchema_K2::PC_Exec,
+	          UEdGraphSchema_K2::PN_Execute);
+	auto* Then = CreatePin(EGPD_Output, UEdGraphSchema_K2::PC_Exec,
+	                       UEdGraphSchema_K2::PN_Then);
+	Then->PinFriendlyName = LOCTEXT("Completed", "Completed");
+	if (Mode == EUE5CoroParallelMode::Any)
+		CreatePin(EGPD_Output, UEdGraphSchema_K2::PC_Int, WinnerPinName)
+			->PinToolTip = LOCTEXT("WinnerTooltip",
+			                       "Index of the call that completed first")
+				.ToString();
+
+	auto* Function = GetTargetFunction();
+	if (!Function)
+		return;
+
+	// Every call shares the same target object
+	if (!Function->HasAnyFunctionFlags(FUNC_Static))
+	{
+		auto* Self = CreatePin(EGPD_Input, UEdGraphSchema_K2::PC_Object,
+		                       Function->GetOwnerClass(),
+		                       UEdGraphSchema_K2::PN_Self);
+		Self->PinFriendlyName = LOCTEXT("Target", "Target");
+	}
+
+	for (int32 i = 0; i < NumCalls; ++i)
+		for (TFieldIterator<FProperty> It(Function);
+		     It && It->HasAnyPropertyFlags(CPF_Parm); ++It)
+		{
+			if (!IsCallParameter(Function, *It))
+				continue;
+
+			FEdGraphPinType Type;
+			Schema->ConvertPropertyToPinType(*It, Type);
+			auto* Pin = CreatePin(EGPD_Input, Type, GetCallPinName(*It, i));
+			Pin->PinFriendlyName = FText::Format(
+				LOCTEXT("CallPin", "{0} ({1})"), It->GetDisplayNameText(),
+				i + 1);
+			FString Default;
+			if (UEdGraphSchema_K2::FindFunctionParameterDefaultValue(
+				    Function, *It, Default))
+				Schema->SetPinAutogeneratedDefaultValue(Pin, Default);
+			else
+				Schema->SetPinAutogeneratedDefaultValueBasedOnType(Pin);
+		}
+}
+
+FText UK2Node_UE5CoroRunInParallel::GetNodeTitle(ENodeTitleType::Type) const
+{
+	auto* Function = GetTargetFunction();
+	auto Name = Function ? Function->GetDisplayNameText()
+	                     : FText::FromName(FunctionReference.GetMemberName());
+	return FText::Format(Mode == EUE5CoroParallelMode::All
+		                     ? LOCTEXT("AllTitle", "{0} in Parallel (All)")
+		                     : LOCTEXT("AnyTitle", "{0} in Parallel (Any)"),
+	                     Name);
+}
+
+FText UK2Node_UE5CoroRunInParallel::GetTooltipText() const
+{
+	return LOCTEXT("Tooltip",
+	               "Calls the coroutine once for every set of inputs, with "
+	               "the calls running concurrently.\nCompleted is triggered "
+	               "when all of them, or the first one, complete.");
+}
+
+void UK2Node_UE5CoroRunInParallel::PostEditChangeProperty(
+	FPropertyChangedEvent& Event)
+{
+	NumCalls = FMath::Max(NumCalls, 1);
+	ReconstructNode();
+	FBlueprintEditorUtils::MarkBlueprintAsStructurallyModified(GetBlueprint());
+	Super::PostEditChangeProperty(Event);
+}
+
+void UK2Node_UE5CoroRunInParallel::GetMenuActions(
+	FBlueprintActionDatabaseRegistrar& BlueprintActionDatabaseRegistrar) const
+{
+	auto* Struct = FAsyncCoroutine::StaticStruct();
+	for (auto* Fn : TObjectRange<UFunction>())
+		if (UNLIKELY(UK2Node_UE5CoroCallCoroutine::IsBlueprintCoroutine(Fn)))
+		{
+			auto* BNS = UBlueprintNodeSpawner::Create(GetClass());
+			BNS->CustomizeNodeDelegate.BindWeakLambda(
+				Fn, &ThisClass::CustomizeNode, Fn);
+
+			auto& Menu = BNS->DefaultMenuSignature;
+			Menu.MenuName = FText::Format(
+				LOCTEXT("MenuName", "{0} in Parallel"),
+				Fn->GetDisplayNameText());
+			Menu.Category = GetMenuCategory();
+			Menu.Tooltip = GetTooltipText();
+			Menu.Keywords = LOCTEXT("Keywords", "WhenAll WhenAny concurrent");
+
+			BlueprintActionDatabaseRegistrar.AddBlueprintAction(Struct, BNS);
+		}
+}
+
+FText UK2Node_UE5CoroRunInParallel::GetMenuCategory() const
+{
+	return LOCTEXT("ParallelCategory", "Call Coroutine|Parallel");
+}
+
+void UK2Node_UE5CoroRunInParallel::ExpandNode(
+	FKismetCompilerContext& CompilerContext, UEdGraph* SourceGraph)
+{
+	Super::ExpandNode(CompilerContext, SourceGraph);
+
+	auto* Function = GetTargetFunction();
+	if (!Function)
+	{
+		CompilerContext.MessageLog.Error(
+			*LOCTEXT("NoFunction", "@@ calls a missing coroutine").ToString(),
+			this);
+		BreakAllNodeLinks();
+		return;
+	}
+
+	auto* Schema = CompilerContext.GetSchema();
+	bool bOk = true;
+
+	// Start every call from a sequence. Latent calls return immediately, so
+	// all of them will be running when the last pin starts the join.
+	auto* Sequence = CompilerContext.SpawnIntermediateNode<
+		UK2Node_ExecutionSequence>(this, SourceGraph);
+	Sequence->AllocateDefaultPins();
+	while (!Sequence->GetThenPinGivenIndex(NumCalls))
+		Sequence->AddInputPin();
+	bOk &= CompilerContext.MovePinLinksToIntermediate(
+		*GetExecPin(), *Sequence->GetExecPin()).CanSafeConnect();
+
+	auto* Join = CompilerContext.SpawnIntermediateNode<UK2Node_CallFunction>(
+		this, SourceGraph);
+	Join->FunctionReference.SetExternalMember(
+		Mode == EUE5CoroParallelMode::All
+			? GET_FUNCTION_NAME_CHECKED(UUE5CoroAggregateLibrary, WaitForAll)
+			: GET_FUNCTION_NAME_CHECKED(UUE5CoroAggregateLibrary, WaitForAny),
+		UUE5CoroAggregateLibrary::StaticClass());
+	Join->AllocateDefaultPins();
+
+	// The coroutines returned by the calls are collected for the join
+	auto* Handles = CompilerContext.SpawnIntermediateNode<UK2Node_MakeArray>(
+		this, SourceGraph);
+	Handles->NumInputs = NumCalls;
+	Handles->AllocateDefaultPins();
+	auto* HandlesOut = Handles->GetOutputPin();
+	bOk &= Schema->TryCreateConnection(
+		HandlesOut, Join->FindPinChecked(TEXT("Coroutines")));
+	Handles->PinConnectionListChanged(HandlesOut);
+
+	auto* Self = FindPin(UEdGraphSchema_K2::PN_Self);
+	for (int32 i = 0; i < NumCalls; ++i)
+	{
+		auto* Call = CompilerContext.SpawnIntermediateNode<
+			UK2Node_CallFunction>(this, SourceGraph);
+		Call->SetFromFunction(Function);
+		Call->AllocateDefaultPins();
+		bOk &= Schema->TryCreateConnection(Sequence->GetThenPinGivenIndex(i),
+		                                   Call->GetExecPin());
+		if (Self)
+			bOk &= CompilerContext.CopyPinLinksToIntermediate(
+				*Self, *Call->FindPinChecked(UEdGraphSchema_K2::PN_Self))
+				.CanSafeConnect();
+
+		for (TFieldIterator<FProperty> It(Function);
+		     It && It->HasAnyPropertyFlags(CPF_Parm); ++It)
+			if (IsCallParameter(Function, *It))
+				bOk &= CompilerContext.MovePinLinksToIntermediate(
+					*FindPinChecked(GetCallPinName(*It, i)),
+					*Call->FindPinChecked(It->GetFName())).CanSafeConnect();
+
+		auto* Element = Handles->FindPinChecked(
+			*FString::Printf(TEXT("[%d]"), i));
+		bOk &= Schema->TryCreateConnection(Call->GetReturnValuePin(), Element);
+	}
+
+	bOk &= Schema->TryCreateConnection(Sequence->GetThenPinGivenIndex(NumCalls),
+	                                   Join->GetExecPin());
+	bOk &= CompilerContext.MovePinLinksToIntermediate(
+		*GetThenPin(), *Join->GetThenPin()).CanSafeConnect();
+	if (Mode == EUE5CoroParallelMode::Any)
+		bOk &= CompilerContext.MovePinLinksToIntermediate(
+			*FindPinChecked(WinnerPinName),
+			*Join->FindPinChecked(WinnerPinName)).CanSafeConnect();
+
+	if (!bOk)
+		CompilerContext.MessageLog.Error(
+			*LOCTEXT("ExpandError", "Internal error expanding @@").ToString(),
+			this);
+	BreakAllNodeLinks();
+}
+
+void UK2Node_UE5CoroRunInParallel::AddInputPin()
+{
+	Modify();
+	++NumCalls;
+	ReconstructNode();
+	FBlueprintEditorUtils::MarkBlueprintAsStructurallyModified(GetBlueprint());
+}
+
+#undef LOCTEXT_NAMESPACE
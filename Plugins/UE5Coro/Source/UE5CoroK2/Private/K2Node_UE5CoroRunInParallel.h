@@ -0,0 +1,84 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "K2Node.h"
+#include "K2Node_AddPinInterface.h"
+#include "K2Node_UE5CoroRunInParallel.generated.h"
+
+UENUM()
+enum class EUE5CoroParallelMode : uint8
+{
+	/** Continue when every call has completed. */
+	All,
+	/** Continue when the first call has completed. The others keep running. */
+	Any,
+};
+
+/** Calls the same coroutine several times with different arguments, running
+ *  the calls concurrently, then continues once all or any of them complete.
+ *  <br>This expands to the individual calls followed by a latent WhenAll or
+ *  WhenAny over their coroutines. */
+UCLASS()
+class UE5COROK2_API UK2Node_UE5CoroRunInParallel
+	: public UK2Node, public IK2Node_AddPinInterface
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FMemberReference FunctionReference;
+
+	/** How many times the coroutine is called. */
+	UPROPERTY(EditAnywhere, Category = "Coroutine", meta = (ClampMin = 1))
+	int32 NumCalls = 2;
+
+	UPROPERTY(EditAnywhere, Category = "Coroutine")
+	EUE5CoroParallelMode Mode = EUE5CoroParallelMode::All;
+
+	static void CustomizeNode(UEdGraphNode*, bool, UFunction*);
+	static bool IsCallParameter(const UFunction*, const FProperty*);
+	static FName GetCallPinName(const FProperty*, int32 Index);
+	UFunction* GetTargetFunction() const;
+
+public:
+	virtual void AllocateDefaultPins() override;
+	virtual FText GetNodeTitle(ENodeTitleType::Type) const override;
+	virtual FText GetTooltipText() const override;
+	virtual void PostEditChangeProperty(FPropertyChangedEvent&) override;
+	virtual void GetMenuActions(FBlueprintActionDatabaseRegistrar&) const override;
+	virtual FText GetMenuCategory() const override;
+	virtual void ExpandNode(FKismetCompilerContext&, UEdGraph*) override;
+
+	virtual void AddInputPin() override;
+	virtual bool CanAddPin() const override { return true; }
+};
@@ -41,5 +41,11 @@ public class UE5CoroK2 : UE5CoroModuleRules
 			"BlueprintGraph",
 			"UE5Coro",
 		});
+
+		PrivateDependencyModuleNames.AddRange(new[]
+		{
+			"KismetCompiler",
+			"UnrealEd",
+		});
 	}
 }
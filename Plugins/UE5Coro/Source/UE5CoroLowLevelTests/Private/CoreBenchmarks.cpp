@@ -0,0 +1,104 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "TestHarness.h"
+#include "UE5Coro/Threading.h"
+
+using namespace UE5Coro;
+
+// Hidden by default, run with the [.benchmark] tag or by name
+namespace
+{
+TCoroutine<> Empty()
+{
+	co_return;
+}
+
+TCoroutine<> AwaitEvent(FAwaitableEvent& Event)
+{
+	co_await Event;
+}
+
+TCoroutine<> LockUnlock(FAwaitableSemaphore& Semaphore, int Count)
+{
+	for (int i = 0; i < Count; ++i)
+	{
+		co_await Semaphore;
+		Semaphore.Unlock();
+	}
+}
+
+template<typename F>
+double NsPerOp(int Ops, F Fn)
+{
+	Fn(); // Warm up
+	double Start = FPlatformTime::Seconds();
+	Fn();
+	return (FPlatformTime::Seconds() - Start) * 1e9 / Ops;
+}
+}
+
+TEST_CASE("UE5Coro::Benchmark::Start", "[UE5Coro][.benchmark]")
+{
+	constexpr int Count = 100000;
+	double Ns = NsPerOp(Count, []
+	{
+		for (int i = 0; i < Count; ++i)
+			Empty();
+	});
+	WARN("Start: " << Ns << " ns/op");
+}
+
+TEST_CASE("UE5Coro::Benchmark::Event", "[UE5Coro][.benchmark]")
+{
+	constexpr int Count = 100000;
+	double Ns = NsPerOp(Count, []
+	{
+		FAwaitableEvent Event(EEventMode::ManualReset);
+		TArray<TCoroutine<>> Coros;
+		Coros.Reserve(Count);
+		for (int i = 0; i < Count; ++i)
+			Coros.Add(AwaitEvent(Event));
+		Event.Trigger();
+	});
+	WARN("Suspend on event and resume: " << Ns << " ns/op");
+}
+
+TEST_CASE("UE5Coro::Benchmark::Semaphore", "[UE5Coro][.benchmark]")
+{
+	constexpr int Count = 100000;
+	double Ns = NsPerOp(Count, []
+	{
+		FAwaitableSemaphore Semaphore;
+		LockUnlock(Semaphore, Count);
+	});
+	WARN("Uncontended semaphore: " << Ns << " ns/op");
+}
@@ -0,0 +1,158 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "TestHarness.h"
+#include "UE5Coro/AsyncAwaiters.h"
+#include "UE5Coro/Generator.h"
+#include "UE5Coro/Threading.h"
+
+using namespace UE5Coro;
+
+namespace
+{
+TCoroutine<int> Identity(int Value)
+{
+	co_return Value;
+}
+
+TCoroutine<int> AwaitThenReturn(FAwaitableEvent& Event, int Value)
+{
+	co_await Event;
+	co_return Value;
+}
+
+TCoroutine<> Lock(FAwaitableSemaphore& Semaphore, int& Inside)
+{
+	co_await Semaphore;
+	++Inside;
+}
+
+TGenerator<int> CountUp(int Max)
+{
+	for (int i = 0; i <= Max; ++i)
+		co_yield i;
+}
+
+TCoroutine<double> Sleep(double Seconds)
+{
+	co_await Async::MoveToThread(ENamedThreads::AnyBackgroundThreadNormalTask);
+	double Start = FPlatformTime::Seconds();
+	co_await Async::PlatformSeconds(Seconds);
+	co_return FPlatformTime::Seconds() - Start;
+}
+}
+
+TEST_CASE("UE5Coro::TCoroutine", "[UE5Coro]")
+{
+	SECTION("Synchronous completion")
+	{
+		auto Coro = Identity(5);
+		CHECK(Coro.IsDone());
+		CHECK(Coro.WasSuccessful());
+		CHECK(Coro.GetResult() == 5);
+	}
+
+	SECTION("Suspension and continuation")
+	{
+		FAwaitableEvent Event;
+		int Result = 0;
+		auto Coro = AwaitThenReturn(Event, 3);
+		Coro.ContinueWith([&](int Value) { Result = Value; });
+		CHECK(!Coro.IsDone());
+		Event.Trigger();
+		CHECK(Coro.IsDone());
+		CHECK(Result == 3);
+	}
+
+	SECTION("Cancellation")
+	{
+		FAwaitableEvent Event;
+		auto Coro = AwaitThenReturn(Event, 3);
+		Coro.Cancel();
+		Event.Trigger();
+		CHECK(Coro.IsDone());
+		CHECK(!Coro.WasSuccessful());
+	}
+}
+
+TEST_CASE("UE5Coro::FAwaitableEvent", "[UE5Coro]")
+{
+	SECTION("Auto reset")
+	{
+		FAwaitableEvent Event(EEventMode::AutoReset);
+		auto A = AwaitThenReturn(Event, 1);
+		auto B = AwaitThenReturn(Event, 2);
+		Event.Trigger();
+		CHECK(A.IsDone() != B.IsDone());
+		Event.Trigger();
+		CHECK((A.IsDone() && B.IsDone()));
+	}
+
+	SECTION("Manual reset")
+	{
+		FAwaitableEvent Event(EEventMode::ManualReset);
+		auto A = AwaitThenReturn(Event, 1);
+		auto B = AwaitThenReturn(Event, 2);
+		Event.Trigger();
+		CHECK((A.IsDone() && B.IsDone()));
+		CHECK(AwaitThenReturn(Event, 3).IsDone());
+	}
+}
+
+TEST_CASE("UE5Coro::FAwaitableSemaphore", "[UE5Coro]")
+{
+	FAwaitableSemaphore Semaphore(2, 2);
+	int Inside = 0;
+	TArray<TCoroutine<>> Coros;
+	for (int i = 0; i < 4; ++i)
+		Coros.Add(Lock(Semaphore, Inside));
+	CHECK(Inside == 2);
+	Semaphore.Unlock(2);
+	CHECK(Inside == 4);
+	for (auto& Coro : Coros)
+		CHECK(Coro.IsDone());
+	Semaphore.Unlock(2);
+}
+
+TEST_CASE("UE5Coro::TGenerator", "[UE5Coro]")
+{
+	int Expected = 0;
+	for (int Value : CountUp(3))
+		CHECK(Value == Expected++);
+	CHECK(Expected == 4);
+}
+
+TEST_CASE("UE5Coro::FTimerThread", "[UE5Coro]")
+{
+	auto Coro = Sleep(0.05);
+	REQUIRE(Coro.Wait(5000));
+	CHECK(Coro.GetResult() >= 0.05);
+}
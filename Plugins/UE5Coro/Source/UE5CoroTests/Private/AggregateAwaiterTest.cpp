@@ -35,6 +35,8 @@
 #include "UE5Coro/AggregateAwaiters.h"
 #include "UE5Coro/CoroutineAwaiters.h"
 #include "UE5Coro/Threading.h"
+#include "UE5Coro/UE5CoroAggregateLibrary.h"
+#include "UE5CoroTestObject.h"
 
 using namespace UE5Coro;
 using namespace UE5Coro::Private::Test;
@@ -49,8 +51,42 @@ IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAggregateLatentTest, "UE5Coro.Aggregate.Latent
                                  EAutomationTestFlags::HighPriority |
                                  EAutomationTestFlags::ProductFilter)
 
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAggregateDirectTest, "UE5Coro.Aggregate.Direct",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAggregateResultsTest,
+                                 "UE5Coro.Aggregate.Results",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAggregateTimeoutTest,
+                                 "UE5Coro.Aggregate.Timeout",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAggregateBlueprintTest,
+                                 "UE5Coro.Aggregate.Blueprint",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
 namespace
 {
+TCoroutine<> WaitFor(FAwaitableEvent& Event)
+{
+	co_await Event;
+}
+
+TCoroutine<FString> Stringify(FAwaitableEvent& Event, int Value)
+{
+	co_await Event;
+	co_return FString::FromInt(Value);
+}
+
 template<typename... T>
 void DoTest(FAutomationTestBase& Test)
 {
@@ -298,3 +334,207 @@ bool FAggregateLatentTest::RunTest(const FString& Parameters)
 	DoTest<FLatentActionInfo>(*this);
 	return true;
 }
+
+bool FAggregateDirectTest::RunTest(const FString& Parameters)
+{
+	{
+		FAwaitableEvent Event(EEventMode::ManualReset);
+		TArray<TCoroutine<>> Coros;
+		for (int i = 0; i < 64; ++i)
+			Coros.Add(WaitFor(Event));
+
+#if UE5CORO_FRAME_POOL
+		// Aggregating coroutines doesn't need helper coroutines
+		auto Before = Private::FFrameAllocator::GetStats();
+#endif
+		auto All = WhenAll(Coros);
+		auto Any = WhenAny(Coros[0], Coros[1], Coros[2]);
+#if UE5CORO_FRAME_POOL
+		auto After = Private::FFrameAllocator::GetStats();
+		TestEqual(TEXT("No frames allocated"), After.Allocations,
+		          Before.Allocations);
+#endif
+
+		bool bAll = false;
+		int AnyIndex = -1;
+		auto AwaitAll = [&]() -> TCoroutine<>
+		{
+			co_await All;
+			bAll = true;
+		};
+		auto AwaitAny = [&]() -> TCoroutine<>
+		{
+			AnyIndex = co_await Any;
+		};
+		auto Coro1 = AwaitAll();
+		auto Coro2 = AwaitAny();
+		TestFalse(TEXT("WhenAll waiting"), bAll);
+		TestEqual(TEXT("WhenAny waiting"), AnyIndex, -1);
+		Event.Trigger();
+		TestTrue(TEXT("WhenAll done"), bAll);
+		TestTrue(TEXT("WhenAny done"), AnyIndex >= 0 && AnyIndex < 3);
+		TestTrue(TEXT("Coroutines done"), Coro1.IsDone() && Coro2.IsDone());
+	}
+
+	{
+		// Already complete coroutines report synchronously
+		FAwaitableEvent Event(EEventMode::ManualReset);
+		Event.Trigger();
+		auto Done = WaitFor(Event);
+		bool bResumed = false;
+		auto AwaitDone = [&]() -> TCoroutine<>
+		{
+			co_await WhenAll(Done, Done);
+			bResumed = true;
+		};
+		auto Coro = AwaitDone();
+		TestTrue(TEXT("Resumed"), bResumed);
+	}
+	return true;
+}
+
+bool FAggregateResultsTest::RunTest(const FString& Parameters)
+{
+	{
+		FAwaitableEvent Event;
+		TArray<TCoroutine<FString>> Coros;
+		for (int i = 0; i < 8; ++i)
+			Coros.Add(Stringify(Event, i));
+
+		TArray<FString> Results;
+		auto Coro = [&]() -> TCoroutine<>
+		{
+			Results = co_await WhenAllResults(std::move(Coros));
+		};
+		auto Handle = Coro();
+		// Auto-reset, every Trigger resumes one coroutine
+		for (int i = 0; i < 8; ++i)
+		{
+			TestFalse(TEXT("Waiting"), Handle.IsDone());
+			Event.Trigger();
+		}
+		TestTrue(TEXT("Done"), Handle.IsDone());
+		TestEqual(TEXT("Count"), Results.Num(), 8);
+		for (int i = 0; i < Results.Num(); ++i)
+			TestEqual(TEXT("Result in order"), Results[i], FString::FromInt(i));
+	}
+
+	{
+		FAwaitableEvent Event(EEventMode::ManualReset);
+		auto Ok = Stringify(Event, 1);
+		auto Canceled = Stringify(Event, 2);
+		Canceled.Cancel();
+		auto VoidOk = WaitFor(Event);
+		auto VoidCanceled = WaitFor(Event);
+		VoidCanceled.Cancel();
+
+		TArray<TOptional<FString>> Values;
+		TArray<bool> Flags;
+		auto Coro = [&]() -> TCoroutine<>
+		{
+			Values = co_await WhenAllSettled(
+				TArray<TCoroutine<FString>>{Ok, Canceled});
+			Flags = co_await WhenAllSettled(
+				TArray<TCoroutine<>>{VoidOk, VoidCanceled});
+		};
+		auto Handle = Coro();
+		Event.Trigger();
+		TestTrue(TEXT("Done"), Handle.IsDone());
+		if (TestEqual(TEXT("Values"), Values.Num(), 2) &&
+		    TestEqual(TEXT("Flags"), Flags.Num(), 2))
+		{
+			TestTrue(TEXT("Successful value"),
+			         Values[0].IsSet() && *Values[0] == TEXT("1"));
+			TestFalse(TEXT("Canceled value"), Values[1].IsSet());
+			TestTrue(TEXT("Successful flag"), Flags[0]);
+			TestFalse(TEXT("Canceled flag"), Flags[1]);
+		}
+	}
+
+	{
+		auto Coro = []() -> TCoroutine<int>
+		{
+			auto Results = co_await WhenAllResults(TArray<TCoroutine<int>>());
+			co_return Results.Num();
+		}();
+		TestTrue(TEXT("Empty array doesn't suspend"), Coro.IsDone());
+		TestEqual(TEXT("Empty result"), Coro.GetResult(), 0);
+	}
+	return true;
+}
+
+bool FAggregateTimeoutTest::RunTest(const FString& Parameters)
+{
+	{
+		auto Coro = []() -> TCoroutine<bool>
+		{
+			co_return co_await WithTimeout(TCoroutine<>::CompletedCoroutine, 0);
+		}();
+		TestTrue(TEXT("Already complete"), Coro.GetResult());
+	}
+
+	{
+		FAwaitableEvent Event;
+		auto Coro = [&]() -> TCoroutine<TOptional<FString>>
+		{
+			co_return co_await WithTimeout(Stringify(Event, 1), 100);
+		}();
+		TestFalse(TEXT("Waiting"), Coro.IsDone());
+		Event.Trigger();
+		TestTrue(TEXT("Resumed by completion"), Coro.IsDone());
+		TestEqual(TEXT("Result"), Coro.GetResult().Get(TEXT("")),
+		          FString(TEXT("1")));
+	}
+
+	{
+		FAwaitableEvent Event;
+		auto Inner = WaitFor(Event);
+		auto Coro = [&]() -> TCoroutine<bool>
+		{
+			co_await Async::MoveToThread(
+				ENamedThreads::AnyBackgroundThreadNormalTask);
+			co_return co_await WithTimeout(Inner, 0.01);
+		}();
+		TestTrue(TEXT("Resumed by the timer"), Coro.Wait(1000));
+		TestFalse(TEXT("Timed out"), Coro.GetResult());
+		TestFalse(TEXT("Inner still running"), Inner.IsDone());
+		Event.Trigger();
+		TestTrue(TEXT("Inner done"), Inner.IsDone());
+		TestFalse(TEXT("Inner canceled"), Inner.WasSuccessful());
+	}
+	return true;
+}
+
+bool FAggregateBlueprintTest::RunTest(const FString& Parameters)
+{
+	FTestWorld World;
+	auto* Object = NewObject<UUE5CoroTestObject>();
+	FAwaitableEvent Event1(EEventMode::ManualReset);
+	FAwaitableEvent Event2(EEventMode::ManualReset);
+	TArray<FAsyncCoroutine> Coros{WaitFor(Event1), WaitFor(Event2)};
+
+	auto All = UUE5CoroAggregateLibrary::WaitForAll(
+		Coros, {0, 0, TEXT("Core"), Object});
+	int32 Winner = -2;
+	auto Any = UUE5CoroAggregateLibrary::WaitForAny(
+		Coros, Winner, {1, 1, TEXT("Core"), Object});
+	Coros.Empty(); // The library functions have their own copies
+	TestFalse(TEXT("All waiting"), All.IsDone());
+	TestEqual(TEXT("Any waiting"), Winner, -1);
+
+	Event2.Trigger();
+	World.Tick();
+	TestTrue(TEXT("Any done"), Any.IsDone());
+	TestEqual(TEXT("Winner"), Winner, 1);
+	TestFalse(TEXT("All still waiting"), All.IsDone());
+	Event1.Trigger();
+	World.Tick();
+	TestTrue(TEXT("All done"), All.IsDone());
+
+	Winner = -2;
+	auto Empty = UUE5CoroAggregateLibrary::WaitForAny(
+		{}, Winner, {2, 2, TEXT("Core"), Object});
+	TestTrue(TEXT("Empty done"), Empty.IsDone());
+	TestEqual(TEXT("Empty winner"), Winner, -1);
+	return true;
+}
@@ -51,4 +51,8 @@ TCoroutine<> UE5CoroAnimationAwaiterCompileTest()
 		co_await PlayMontageNotifyEnd(nullptr, nullptr)};
 	[[maybe_unused]] const FBranchingPointNotifyPayload* val6{
 		co_await PlayMontageNotifyEnd(nullptr, nullptr, NAME_None)};
+	[[maybe_unused]] float val7{
+		co_await CurveRisesAbove(nullptr, NAME_None, 0.5f)};
+	[[maybe_unused]] float val8{
+		co_await CurveFallsBelow(nullptr, NAME_None, 0.5f)};
 }
@@ -0,0 +1,80 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "TestWorld.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Misc/AutomationTest.h"
+#include "UE5Coro/AssetAwaiters.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Private::Test;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAssetQueryTest, "UE5Coro.Assets.Query",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+bool FAssetQueryTest::RunTest(const FString& Parameters)
+{
+	FTestWorld World;
+	FARFilter Filter;
+	Filter.PackagePaths.Add(TEXT("/Engine/EngineMaterials"));
+	Filter.bRecursivePaths = true;
+	Filter.bIncludeOnlyOnDiskAssets = true;
+
+	std::atomic<bool> bDone = false;
+	World.Run(CORO
+	{
+		co_await Assets::WaitForRegistry();
+		TestFalse(TEXT("Registry loaded"),
+		          IAssetRegistry::GetChecked().IsLoadingAssets());
+
+		TArray<FAssetData> Expected;
+		IAssetRegistry::GetChecked().GetAssets(Filter, Expected);
+
+		auto Query = Assets::QueryAsync(Filter, 7);
+		int Num = 0;
+		bool bChunksFit = true;
+		while (auto Chunk = co_await Query.Next())
+		{
+			bChunksFit &= Chunk->Num() > 0 && Chunk->Num() <= 7;
+			for (auto& Asset : *Chunk)
+				Num += Expected.Contains(Asset);
+		}
+		TestTrue(TEXT("Chunk sizes"), bChunksFit);
+		TestEqual(TEXT("Results"), Num, Expected.Num());
+		bDone = true;
+	});
+	FTestHelper::PumpGameThread(World, [&] { return bDone.load(); });
+
+	return true;
+}
@@ -30,6 +30,8 @@
 // ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "TestWorld.h"
+#include "Algo/AllOf.h"
+#include "HAL/IConsoleManager.h"
 #include "Misc/AutomationTest.h"
 #include "UE5Coro/AggregateAwaiters.h"
 #include "UE5Coro/AsyncAwaiters.h"
@@ -53,6 +55,64 @@ IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAsyncStressTest, "UE5Coro.Async.Stress",
                                  EAutomationTestFlags::MediumPriority |
                                  EAutomationTestFlags::ProductFilter)
 
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAsyncYieldTest, "UE5Coro.Async.Yield",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAsyncLongTaskPoolTest,
+                                 "UE5Coro.Async.LongTaskPool",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAsyncParallelForTest,
+                                 "UE5Coro.Async.ParallelFor",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAsyncTimerCancelTest,
+                                 "UE5Coro.Async.TimerCancel",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::MediumPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAsyncPreciseTimerTest,
+                                 "UE5Coro.Async.PreciseTimer",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::MediumPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAsyncPeriodicTimerTest,
+                                 "UE5Coro.Async.PeriodicTimer",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAsyncTimerWaveTest, "UE5Coro.Async.TimerWave",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::MediumPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAsyncGameThreadInboxTest,
+                                 "UE5Coro.Async.GameThreadInbox",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAsyncTaskPriorityTest,
+                                 "UE5Coro.Async.TaskPriority",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAsyncFrameWorkTest,
+                                 "UE5Coro.Async.FrameWork",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
 namespace
 {
 template<typename... T>
@@ -227,3 +287,427 @@ bool FAsyncStressTest::RunTest(const FString& Parameters)
 
 	return true;
 }
+
+bool FAsyncYieldTest::RunTest(const FString& Parameters)
+{
+	{
+		// Many yielding coroutines on the same kind of thread all finish,
+		// regardless of how they're split between the ready queue and the
+		// task graph
+		std::atomic<int> Count = 0;
+		TArray<TCoroutine<>> Coros;
+		for (int i = 0; i < 64; ++i)
+			Coros.Add([](std::atomic<int>& Count) -> TCoroutine<>
+			{
+				co_await Async::MoveToThread(
+					ENamedThreads::AnyBackgroundThreadNormalTask);
+				for (int j = 0; j < 100; ++j)
+				{
+					co_await Async::Yield();
+					++Count;
+				}
+			}(Count));
+		for (auto& Coro : Coros)
+			TestTrue(TEXT("Completed"), Coro.Wait());
+		TestEqual(TEXT("Every yield resumed"), Count.load(), 6400);
+	}
+
+	{
+		// A generous budget never runs out
+		bool bDone = false;
+		auto Coro = [](bool& bDone) -> TCoroutine<>
+		{
+			auto Budget = Async::YieldIfBudgetExceeded(60'000'000);
+			for (int i = 0; i < 1000; ++i)
+				co_await Budget;
+			bDone = true;
+		}(bDone);
+		TestTrue(TEXT("Not suspended"), bDone);
+		TestTrue(TEXT("Done"), Coro.IsDone());
+	}
+
+	{
+		// A tiny budget always runs out eventually
+		std::atomic<bool> bDone = false;
+		auto Coro = [](std::atomic<bool>& bDone) -> TCoroutine<>
+		{
+			co_await Async::MoveToThread(
+				ENamedThreads::AnyBackgroundThreadNormalTask);
+			auto Budget = Async::YieldIfBudgetExceeded(1);
+			auto Start = FPlatformTime::Seconds();
+			while (FPlatformTime::Seconds() - Start < 0.001)
+				;
+			// The coroutine has been running for at least 1 ms
+			co_await Budget;
+			bDone = true;
+		}(bDone);
+		TestTrue(TEXT("Completed"), Coro.Wait());
+		TestTrue(TEXT("Resumed"), bDone.load());
+	}
+	return true;
+}
+
+bool FAsyncLongTaskPoolTest::RunTest(const FString& Parameters)
+{
+	auto RecordThread = [](uint32& ThreadId) -> TCoroutine<>
+	{
+		co_await Async::MoveToLongTaskPool(TPri_BelowNormal);
+		ThreadId = FPlatformTLS::GetCurrentThreadId();
+	};
+
+	{
+		uint32 First = 0, Second = 0;
+		auto Coro = RecordThread(First);
+		TestTrue(TEXT("First done"), Coro.Wait());
+		// Give the thread time to park itself
+		FPlatformProcess::Sleep(0.1f);
+		Coro = RecordThread(Second);
+		TestTrue(TEXT("Second done"), Coro.Wait());
+		TestNotEqual(TEXT("Moved off this thread"), First,
+		             FPlatformTLS::GetCurrentThreadId());
+		TestEqual(TEXT("Parked thread reused"), First, Second);
+	}
+
+	{
+		// Going over the limit makes coroutines wait for a thread
+		auto* CVar = IConsoleManager::Get().FindConsoleVariable(
+			TEXT("UE5Coro.LongTaskPool.MaxThreads"));
+		if (!TestNotNull(TEXT("CVar exists"), CVar))
+			return false;
+		int32 OldValue = CVar->GetInt();
+		CVar->Set(1);
+		ON_SCOPE_EXIT { CVar->Set(OldValue); };
+
+		std::atomic<int> Count = 0;
+		TArray<TCoroutine<>> Coros;
+		for (int i = 0; i < 8; ++i)
+			Coros.Add([](std::atomic<int>& Count) -> TCoroutine<>
+			{
+				co_await Async::MoveToLongTaskPool(TPri_Lowest);
+				FPlatformProcess::Sleep(0.005f);
+				++Count;
+			}(Count));
+		for (auto& Coro : Coros)
+			TestTrue(TEXT("Completed"), Coro.Wait());
+		TestEqual(TEXT("Every coroutine ran"), Count.load(), 8);
+	}
+	return true;
+}
+
+bool FAsyncParallelForTest::RunTest(const FString& Parameters)
+{
+	constexpr int Num = 10000;
+	auto Visits = MakeUnique<std::atomic<int>[]>(Num);
+	TArray<int> Input;
+	for (int i = 0; i < Num; ++i)
+		Input.Add(i);
+	TArray<int> Squares;
+	uint32 Before = 0, After = 0;
+
+	auto Fn = [&]() -> TCoroutine<>
+	{
+		co_await Async::MoveToThread(ENamedThreads::AnyBackgroundHiPriTask);
+		co_await Async::ParallelFor(0, [](int32) { check(!"Called"); });
+		Before = FPlatformTLS::GetCurrentThreadId();
+		co_await Async::ParallelFor(Num, [&](int32 i) { ++Visits[i]; }, 64);
+		After = FPlatformTLS::GetCurrentThreadId();
+		Squares = co_await Async::ParallelTransform(Input,
+		                                            [](int i) { return i * i; });
+	};
+	auto Coro = Fn();
+	TestTrue(TEXT("Done"), Coro.Wait(10000));
+	TestNotEqual(TEXT("Ran in the background"), Before,
+	             FPlatformTLS::GetCurrentThreadId());
+	TestNotEqual(TEXT("Resumed on a background thread"), After,
+	             FPlatformTLS::GetCurrentThreadId());
+	bool bAllOnce = true;
+	for (int i = 0; i < Num; ++i)
+		bAllOnce &= Visits[i] == 1;
+	TestTrue(TEXT("Every index visited once"), bAllOnce);
+	if (TestEqual(TEXT("Transformed size"), Squares.Num(), Num))
+		for (int i = 0; i < Num; ++i)
+			if (Squares[i] != i * i)
+			{
+				AddError(TEXT("Wrong transform result"));
+				break;
+			}
+	return true;
+}
+
+bool FAsyncTimerCancelTest::RunTest(const FString& Parameters)
+{
+	constexpr int Count = 100000;
+	TArray<TCoroutine<>> Coros;
+	Coros.Reserve(Count);
+	double Start;
+	{
+		FTestWorld World;
+		for (int i = 0; i < Count; ++i)
+			Coros.Add(World.Run([i](FLatentActionInfo) -> TCoroutine<>
+			{
+				co_await Async::PlatformSeconds(1000 + i % 100);
+			}));
+		Start = FPlatformTime::Seconds();
+		// Destroying the world destroys every latent coroutine, unregistering
+		// all of their timers
+	}
+	auto End = FPlatformTime::Seconds();
+	for (auto& Coro : Coros)
+		if (!Coro.IsDone() || Coro.WasSuccessful())
+		{
+			AddError(TEXT("Unexpected coroutine state"));
+			break;
+		}
+	AddInfo(FString::Printf(TEXT("Canceled %d timers in %.2f ms"), Count,
+	                        (End - Start) * 1000));
+	return true;
+}
+
+bool FAsyncPeriodicTimerTest::RunTest(const FString& Parameters)
+{
+	constexpr double Period = 0.01;
+	auto OnSchedule = [](const Async::FPeriodicTimer& Timer, double Start)
+	{
+		double Ticks = (Timer.GetNextTime() - Start) / Period;
+		return FMath::IsNearlyEqual(Ticks, FMath::RoundToDouble(Ticks), 1e-6);
+	};
+
+	{
+		Async::FPeriodicTimer Timer(Period, Async::EMissedTicks::Skip, true);
+		double Start = Timer.GetNextTime() - Period;
+		auto Coro = [&]() -> TCoroutine<int>
+		{
+			int Sum = 0;
+			for (int i = 0; i < 5; ++i)
+				Sum += co_await Timer;
+			co_return Sum;
+		}();
+		TestTrue(TEXT("Done"), Coro.Wait(1000));
+		TestEqual(TEXT("One per tick"), Coro.GetResult(), 5);
+		TestTrue(TEXT("No drift"), OnSchedule(Timer, Start));
+	}
+
+	{
+		Async::FPeriodicTimer Timer(Period, Async::EMissedTicks::Burst, true);
+		double First = Timer.GetNextTime();
+		FPlatformProcess::Sleep(5.5 * Period);
+		auto Coro = [&]() -> TCoroutine<int>
+		{
+			int Sum = 0;
+			for (int i = 0; i < 3; ++i)
+				Sum += co_await Timer;
+			co_return Sum;
+		}();
+		TestTrue(TEXT("Caught up without suspending"), Coro.IsDone());
+		TestEqual(TEXT("Burst"), Coro.GetResult(), 3);
+		TestTrue(TEXT("Every tick delivered"),
+		         FMath::IsNearlyEqual(Timer.GetNextTime(), First + 3 * Period));
+	}
+
+	for (auto Policy : {Async::EMissedTicks::Skip,
+	                    Async::EMissedTicks::Coalesce})
+	{
+		Async::FPeriodicTimer Timer(Period, Policy, true);
+		double Start = Timer.GetNextTime() - Period;
+		FPlatformProcess::Sleep(5.5 * Period);
+		auto Coro = [&]() -> TCoroutine<int> { co_return co_await Timer; }();
+		TestTrue(TEXT("Not suspended"), Coro.IsDone());
+		if (Policy == Async::EMissedTicks::Skip)
+			TestEqual(TEXT("Skipped"), Coro.GetResult(), 1);
+		else
+			TestTrue(TEXT("Coalesced"), Coro.GetResult() >= 5);
+		TestTrue(TEXT("Missed ticks dropped"),
+		         Timer.GetNextTime() > Start + 6.5 * Period);
+		TestTrue(TEXT("Kept the schedule"), OnSchedule(Timer, Start));
+	}
+
+	{
+		Async::FPeriodicTimer Timer(5 * Period, Async::EMissedTicks::Skip,
+		                            true);
+		double First = Timer.GetNextTime();
+		auto Canceled = [&]() -> TCoroutine<int> { co_return co_await Timer; }();
+		Canceled.Cancel();
+		TestTrue(TEXT("Canceled"), Canceled.Wait(1000));
+		TestFalse(TEXT("Not successful"), Canceled.WasSuccessful());
+		// The timer is free again, and the canceled tick is still scheduled
+		TestEqual(TEXT("Schedule unchanged"), Timer.GetNextTime(), First);
+		auto Coro = [&]() -> TCoroutine<int> { co_return co_await Timer; }();
+		TestTrue(TEXT("Done"), Coro.Wait(1000));
+		TestEqual(TEXT("Ticked"), Coro.GetResult(), 1);
+	}
+	return true;
+}
+
+bool FAsyncTimerWaveTest::RunTest(const FString& Parameters)
+{
+	// Every timer expires at the same time, on a mix of threads
+	constexpr int Count = 20000;
+	const ENamedThreads::Type Threads[] = {
+		ENamedThreads::AnyBackgroundThreadNormalTask,
+		ENamedThreads::AnyHiPriThreadNormalTask,
+		ENamedThreads::AnyNormalThreadNormalTask,
+	};
+	std::atomic<int> Resumed = 0;
+	std::atomic<int> WrongThread = 0;
+	TArray<TCoroutine<>> Coros;
+	Coros.Reserve(Count);
+	double Target = FPlatformTime::Seconds() + 0.5;
+	// The lambda object needs to outlive the coroutines
+	auto Wave = [&](ENamedThreads::Type Thread) -> TCoroutine<>
+	{
+		co_await Async::MoveToThread(Thread);
+		co_await Async::UntilPlatformTime(Target);
+		auto Current = FTaskGraphInterface::Get().GetCurrentThreadIfKnown();
+		if ((Current & ThreadTypeMask) != (Thread & ThreadTypeMask))
+			++WrongThread;
+		++Resumed;
+	};
+	for (int i = 0; i < Count; ++i)
+		Coros.Add(Wave(Threads[i % UE_ARRAY_COUNT(Threads)]));
+
+	for (auto& Coro : Coros)
+		Coro.Wait();
+	auto End = FPlatformTime::Seconds();
+	TestEqual(TEXT("Every timer resumed"), Resumed.load(), Count);
+	TestEqual(TEXT("Resumed on the original thread"), WrongThread.load(), 0);
+	TestTrue(TEXT("Not early"), End >= Target);
+	AddInfo(FString::Printf(TEXT("Resumed %d timers %.2f ms after expiry"),
+	                        Count, (End - Target) * 1000));
+	return true;
+}
+
+bool FAsyncGameThreadInboxTest::RunTest(const FString& Parameters)
+{
+	FTestWorld World;
+	constexpr int Count = 1000;
+	std::atomic<int> OffGameThread = 0;
+	int OnGameThread = 0;
+	auto Fn = [&]() -> TCoroutine<>
+	{
+		co_await Async::MoveToThread(ENamedThreads::AnyBackgroundThreadNormalTask);
+		if (!IsInGameThread())
+			++OffGameThread;
+		// Every worker returns to the game thread at roughly the same time
+		co_await Async::MoveToGameThread();
+		if (IsInGameThread())
+			++OnGameThread;
+		co_await Async::PlatformSeconds(0.001);
+		if (IsInGameThread())
+			++OnGameThread;
+	};
+	TArray<TCoroutine<>> Coros;
+	for (int i = 0; i < Count; ++i)
+		Coros.Add(Fn());
+	FTestHelper::PumpGameThread(World, [&]
+	{
+		return Algo::AllOf(Coros, [](auto& Coro) { return Coro.IsDone(); });
+	});
+	TestEqual(TEXT("Moved away"), OffGameThread.load(), Count);
+	TestEqual(TEXT("Resumed on the game thread"), OnGameThread, Count * 2);
+	return true;
+}
+
+bool FAsyncTaskPriorityTest::RunTest(const FString& Parameters)
+{
+	auto IsOn = [](ENamedThreads::Type Thread)
+	{
+		auto Current = FTaskGraphInterface::Get().GetCurrentThreadIfKnown();
+		return (Current & ThreadTypeMask) == (Thread & ThreadTypeMask);
+	};
+	auto Fn = [&]() -> TCoroutine<>
+	{
+		co_await Async::MoveToThread(ENamedThreads::AnyHiPriThreadNormalTask);
+		// AnyThread timers used to come back on normal priority workers
+		co_await Async::PlatformSecondsAnyThread(0.01);
+		TestTrue(TEXT("Timer kept the priority"),
+		         IsOn(ENamedThreads::AnyHiPriThreadNormalTask));
+		co_await Async::Yield();
+		TestTrue(TEXT("Yield kept the priority"),
+		         IsOn(ENamedThreads::AnyHiPriThreadNormalTask));
+
+		Async::SetTaskPriority(ENamedThreads::AnyBackgroundThreadNormalTask);
+		co_await Async::PlatformSecondsAnyThread(0.01);
+		TestTrue(TEXT("Explicit priority"),
+		         IsOn(ENamedThreads::AnyBackgroundThreadNormalTask));
+		co_await Async::MoveToThread(ENamedThreads::AnyHiPriThreadNormalTask);
+		TestTrue(TEXT("Explicit priority overrides MoveToThread"),
+		         IsOn(ENamedThreads::AnyBackgroundThreadNormalTask));
+	};
+	TestTrue(TEXT("Completed"), Fn().Wait(10000));
+	return true;
+}
+
+bool FAsyncPreciseTimerTest::RunTest(const FString& Parameters)
+{
+	constexpr int Count = 50;
+	auto Before = FTimerLateness::Get();
+	double MaxLateness = 0;
+	bool bEarly = false;
+	auto Fn = [&]() -> TCoroutine<>
+	{
+		co_await Async::MoveToThread(ENamedThreads::AnyBackgroundThreadNormalTask);
+		for (int i = 0; i < Count; ++i)
+		{
+			double Target = FPlatformTime::Seconds() + 0.002;
+			co_await Async::UntilPlatformTimePrecise(Target);
+			double Lateness = FPlatformTime::Seconds() - Target;
+			bEarly |= Lateness < 0;
+			MaxLateness = FMath::Max(MaxLateness, Lateness);
+		}
+	};
+	auto Coro = Fn();
+	TestTrue(TEXT("Completed"), Coro.Wait(10000));
+	auto After = FTimerLateness::Get();
+
+	TestFalse(TEXT("Not early"), bEarly);
+	uint64 Recorded = 0;
+	for (int i = 0; i < FTimerLateness::NumBuckets; ++i)
+		Recorded += After.Precise[i] - Before.Precise[i];
+	TestEqual(TEXT("Lateness recorded"), Recorded, static_cast<uint64>(Count));
+	AddInfo(FString::Printf(TEXT("Worst lateness including dispatch: %.3f ms"),
+	                        MaxLateness * 1000));
+	return true;
+}
+
+bool FAsyncFrameWorkTest::RunTest(const FString& Parameters)
+{
+	FTestWorld World;
+	std::atomic<int> NumWorked = 0;
+	int NumJoined = 0;
+	TArray<TCoroutine<>> Coros;
+	for (int i = 0; i < 32; ++i)
+		Coros.Add(World.Run([&]() -> TCoroutine<>
+		{
+			co_await Async::MoveToFrameWorker();
+			FPlatformProcess::Sleep(0.001f);
+			++NumWorked;
+			co_await Async::JoinAtFrameEnd();
+			TestTrue(TEXT("Joined on the game thread"), IsInGameThread());
+			++NumJoined;
+		}));
+	// Completing without joining counts too
+	Coros.Add(World.Run([&]() -> TCoroutine<>
+	{
+		co_await Async::MoveToFrameWorker();
+		++NumWorked;
+	}));
+
+	// Everything is joined within this one tick
+	World.Tick();
+	TestEqual(TEXT("Worked"), NumWorked.load(), 33);
+	TestEqual(TEXT("Joined"), NumJoined, 32);
+	for (auto& Coro : Coros)
+		TestTrue(TEXT("Done"), Coro.IsDone());
+
+	// Joining without frame work waits for the next tick
+	bool bDone = false;
+	World.Run([&]() -> TCoroutine<>
+	{
+		co_await Async::JoinAtFrameEnd();
+		bDone = true;
+	});
+	TestFalse(TEXT("Not joined yet"), bDone);
+	World.Tick();
+	TestTrue(TEXT("Joined"), bDone);
+	return true;
+}
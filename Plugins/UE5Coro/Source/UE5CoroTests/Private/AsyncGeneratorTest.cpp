@@ -0,0 +1,149 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "TestWorld.h"
+#include "Misc/AutomationTest.h"
+#include "UE5Coro/AsyncAwaiters.h"
+#include "UE5Coro/AsyncGenerator.h"
+#include "UE5Coro/Threading.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Private;
+using namespace UE5Coro::Private::Test;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAsyncGeneratorTest, "UE5Coro.AsyncGenerator",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+namespace
+{
+TCoroutine<> CountUp(TAsyncGeneratorSink<int> Sink, int Max)
+{
+	for (int i = 0; i <= Max; ++i)
+		co_await Sink.Yield(i);
+}
+
+TCoroutine<int> Sum(TAsyncGenerator<int> Generator)
+{
+	int Total = 0;
+	while (auto Value = co_await Generator.Next())
+		Total += *Value;
+	co_return Total;
+}
+}
+
+bool FAsyncGeneratorTest::RunTest(const FString& Parameters)
+{
+	{
+		auto Coro = Sum(TAsyncGenerator<int>([](auto Sink)
+		{
+			return CountUp(std::move(Sink), 10);
+		}, 2));
+		TestTrue(TEXT("Done"), Coro.IsDone());
+		TestEqual(TEXT("Synchronous values"), Coro.GetResult(), 55);
+	}
+
+	{
+		int Produced = 0;
+		auto Fn = [&](TAsyncGeneratorSink<int> Sink) -> TCoroutine<>
+		{
+			for (int i = 0; i < 10; ++i)
+			{
+				co_await Sink.Yield(i);
+				++Produced;
+			}
+		};
+		TAsyncGenerator<int> Generator(Fn, 3);
+		TestEqual(TEXT("Bounded prefetch"), Produced, 3);
+		auto Producer = Generator.GetProducer();
+		TestFalse(TEXT("Producer waiting"), Producer.IsDone());
+		auto Coro = Sum(std::move(Generator));
+		TestEqual(TEXT("Everything consumed"), Coro.GetResult(), 45);
+		TestTrue(TEXT("Producer finished"), Producer.WasSuccessful());
+	}
+
+	{
+		FAwaitableEvent Event;
+		auto Fn = [&](TAsyncGeneratorSink<int> Sink) -> TCoroutine<>
+		{
+			for (int i = 1; i <= 3; ++i)
+			{
+				co_await Event;
+				co_await Sink.Yield(i);
+			}
+		};
+		auto Coro = Sum(TAsyncGenerator<int>(Fn));
+		for (int i = 0; i < 3; ++i)
+		{
+			TestFalse(TEXT("Consumer waiting"), Coro.IsDone());
+			Event.Trigger();
+		}
+		TestTrue(TEXT("Consumer done"), Coro.IsDone());
+		TestEqual(TEXT("Awaiting producer"), Coro.GetResult(), 6);
+	}
+
+	{
+		FAwaitableEvent Event;
+		auto Fn = [&](TAsyncGeneratorSink<int> Sink) -> TCoroutine<>
+		{
+			co_await Sink.Yield(1);
+			co_await Event;
+			co_await Sink.Yield(2);
+		};
+		TOptional<TAsyncGenerator<int>> Generator(InPlace, Fn);
+		auto Producer = Generator->GetProducer();
+		Generator.Reset();
+		Event.Trigger();
+		TestTrue(TEXT("Producer done"), Producer.IsDone());
+		TestFalse(TEXT("Producer canceled"), Producer.WasSuccessful());
+	}
+
+	{
+		auto Fn = [](TAsyncGeneratorSink<int> Sink) -> TCoroutine<>
+		{
+			co_await Async::MoveToThread(
+				ENamedThreads::AnyBackgroundThreadNormalTask);
+			for (int i = 0; i < 1000; ++i)
+				co_await Sink.Yield(i);
+		};
+		auto Consumer = [](TAsyncGenerator<int> Generator) -> TCoroutine<int>
+		{
+			co_await Async::MoveToThread(
+				ENamedThreads::AnyBackgroundHiPriTask);
+			co_return co_await Sum(std::move(Generator));
+		};
+		auto Coro = Consumer(TAsyncGenerator<int>(Fn, 16));
+		TestTrue(TEXT("Threaded completion"), Coro.Wait(10000));
+		TestEqual(TEXT("Threaded values"), Coro.GetResult(), 999 * 1000 / 2);
+	}
+	return true;
+}
@@ -32,6 +32,7 @@
 #include "TestWorld.h"
 #include "Misc/AutomationTest.h"
 #include "UE5Coro/AggregateAwaiters.h"
+#include "UE5Coro/AsyncAwaiters.h"
 #include "UE5Coro/LatentAwaiters.h"
 #include "UE5CoroTestObject.h"
 
@@ -136,6 +137,77 @@ void DoTest(FAutomationTestBase& Test)
 		Test.TestEqual(TEXT("Loaded 2"), Result[1], AActor::StaticClass());
 	}
 
+	{
+		// These might or might not be loaded already, either way should work
+		TSoftObjectPtr<UObject> Soft(
+			FSoftObjectPath(TEXT("/Engine/BasicShapes/Cone.Cone")));
+		UObject* Result1 = nullptr;
+		UObject* Result2 = nullptr;
+		int State = 0;
+		World.Run(CORO
+		{
+			co_await Latent::NextTick();
+			Result1 = co_await Latent::AsyncLoadObject(Soft);
+			++State;
+		});
+		World.Run(CORO
+		{
+			co_await Latent::NextTick();
+			Result2 = co_await Latent::AsyncLoadObject(Soft);
+			++State;
+		});
+		FTestHelper::PumpGameThread(World, [&] { return State == 2; });
+		Test.TestNotNull(TEXT("Loaded"), Result1);
+		Test.TestEqual(TEXT("Same object"), Result1, Result2);
+	}
+
+	{
+		// Boosting a prefetch, or an object that's not loading, should work
+		TSoftObjectPtr<UObject> Soft(
+			FSoftObjectPath(TEXT("/Engine/BasicShapes/Cylinder.Cylinder")));
+		UObject* Result = nullptr;
+		bool bDone = false;
+		World.Run(CORO
+		{
+			co_await Latent::NextTick();
+			auto Prefetch = Latent::AsyncLoadObject(
+				Soft, FStreamableManager::DefaultAsyncLoadPriority);
+			Prefetch.Boost(FStreamableManager::AsyncLoadHighPriority);
+			Latent::BoostAsyncLoad(Soft.ToSoftObjectPath(),
+			                       FStreamableManager::AsyncLoadHighPriority);
+			Result = co_await Latent::AsyncLoadObject(
+				Soft, FStreamableManager::AsyncLoadHighPriority);
+			bDone = true;
+		});
+		FTestHelper::PumpGameThread(World, [&] { return bDone; });
+		Test.TestNotNull(TEXT("Loaded"), Result);
+		Test.TestFalse(TEXT("Nothing to boost"), Latent::BoostAsyncLoad(
+			FSoftObjectPath(TEXT("/UE5Coro/Nonexistent.Nonexistent")), 1));
+	}
+
+	{
+		TStrongObjectPtr<UObject> Object1(World.operator->());
+		TStrongObjectPtr<UObject> Object2(NewObject<UUE5CoroTestObject>());
+		TSet<UObject*> Result;
+		FEventRef CoroToTest;
+		World.Run(CORO
+		{
+			co_await Latent::NextTick();
+			TArray<TSoftObjectPtr<UObject>> Soft{
+				Object1.Get(), Object2.Get(),
+				FSoftObjectPath(TEXT("/Engine/BasicShapes/Cone.Cone"))};
+			auto Loads = Latent::AsyncLoadObjectsProgressive(Soft);
+			while (auto Object = co_await Loads.Next())
+				Result.Add(*Object);
+			CoroToTest->Trigger();
+		});
+		FTestHelper::PumpGameThread(World, [&] { return CoroToTest->Wait(0); });
+		Test.TestEqual(TEXT("Num"), Result.Num(), 3);
+		Test.TestTrue(TEXT("Loaded 1"), Result.Contains(Object1.Get()));
+		Test.TestTrue(TEXT("Loaded 2"), Result.Contains(Object2.Get()));
+		Test.TestFalse(TEXT("No nullptr"), Result.Contains(nullptr));
+	}
+
 	constexpr auto RawPath = TEXT("/Engine/BasicShapes/Cube");
 	FPackagePath PackagePath;
 	bool bSuccess = FPackagePath::TryFromPackageName(RawPath, PackagePath);
@@ -154,6 +226,26 @@ void DoTest(FAutomationTestBase& Test)
 		Test.TestEqual(TEXT("Package"), Package->GetName(), RawPath);
 	}
 
+	IF_NOT_CORO_LATENT
+	{
+		UPackage* Package = nullptr;
+		std::atomic<bool> bOnGameThread = true;
+		FEventRef CoroToTest;
+		World.Run(CORO
+		{
+			auto Load = Latent::AsyncLoadPackage(PackagePath);
+			co_await Async::MoveToThread(
+				ENamedThreads::AnyBackgroundThreadNormalTask);
+			Package = co_await Load;
+			bOnGameThread = IsInGameThread();
+			CoroToTest->Trigger();
+		});
+		FTestHelper::PumpGameThread(World, [&] { return CoroToTest->Wait(0); });
+		Test.TestFalse(TEXT("Resumed on the background thread"),
+		               bOnGameThread.load());
+		Test.TestEqual(TEXT("Package"), Package->GetName(), RawPath);
+	}
+
 	{
 		TStrongObjectPtr<UObject> Object1(World.operator->());
 		FEventRef CoroToTest;
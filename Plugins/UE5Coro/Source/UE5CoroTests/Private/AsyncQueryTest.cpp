@@ -31,6 +31,7 @@
 
 #include "TestWorld.h"
 #include "Misc/AutomationTest.h"
+#include "UE5Coro/AsyncAwaiters.h"
 #include "UE5Coro/LatentAwaiters.h"
 
 using namespace UE5Coro;
@@ -93,6 +94,108 @@ void DoTest(FAutomationTestBase& Test)
 		Test.TestEqual(TEXT("Results"), State, 0);
 	}
 
+	{
+		bool bHit = true;
+		World.Run(CORO
+		{
+			auto Hit = co_await Latent::AsyncLineTraceSingleByChannel(
+				World.operator->(), FVector::ZeroVector, FVector::UpVector,
+				ECC_WorldStatic);
+			bHit = Hit.IsSet();
+		});
+		World.Tick(); // This queries the async trace on the game thread
+		Test.TestTrue(TEXT("No results yet"), bHit);
+		World.Tick(); // This completes it
+		Test.TestFalse(TEXT("No hit"), bHit);
+	}
+
+	{
+		int State = -1;
+		TArray<FHitResult, TInlineAllocator<4>> Hits;
+		Hits.AddDefaulted(2);
+		World.Run(CORO
+		{
+			co_await Latent::AsyncLineTraceByChannel(
+				World.operator->(), EAsyncTraceType::Multi,
+				FVector::ZeroVector, FVector::UpVector, ECC_WorldStatic, Hits);
+			State = Hits.Num();
+		});
+		World.Tick(); // This queries the async trace on the game thread
+		Test.TestEqual(TEXT("No results yet"), State, -1);
+		Test.TestEqual(TEXT("Untouched"), Hits.Num(), 2);
+		World.Tick(); // This completes it
+		Test.TestEqual(TEXT("Results stored"), State, 0);
+	}
+
+	{
+		int State = -1;
+		FEventRef CoroToTest;
+		World.Run(CORO
+		{
+			auto Result = co_await Latent::AsyncLineTraceByChannelAnyThread(
+				World.operator->(), EAsyncTraceType::Multi,
+				FVector::ZeroVector, FVector::UpVector, ECC_WorldStatic);
+			State = Result.Num();
+			CoroToTest->Trigger();
+		});
+		FTestHelper::PumpGameThread(World, [&] { return CoroToTest->Wait(0); });
+		Test.TestEqual(TEXT("Results"), State, 0);
+	}
+
+	IF_NOT_CORO_LATENT
+	{
+		std::atomic<int> State = -1;
+		std::atomic<bool> bOnGameThread = true;
+		FEventRef CoroToTest;
+		World.Run(CORO
+		{
+			co_await Async::MoveToThread(
+				ENamedThreads::AnyBackgroundThreadNormalTask);
+			auto Result = co_await Latent::AsyncLineTraceByChannelAnyThread(
+				World.operator->(), EAsyncTraceType::Single,
+				FVector::ZeroVector, FVector::UpVector, ECC_WorldStatic);
+			State = Result.Num();
+			bOnGameThread = IsInGameThread();
+			CoroToTest->Trigger();
+		});
+		FTestHelper::PumpGameThread(World, [&] { return CoroToTest->Wait(0); });
+		Test.TestFalse(TEXT("Resumed on the background thread"),
+		               bOnGameThread.load());
+		Test.TestEqual(TEXT("Results"), State.load(), 0);
+	}
+
+	{
+		int State = -1;
+		World.Run(CORO
+		{
+			TArray<Latent::FTraceRequest> Requests;
+			for (int i = 0; i < 3; ++i)
+				Requests.Add({FVector(i, 0, 0), FVector(i, 0, 1),
+				              ECC_WorldStatic});
+			auto Result = co_await Latent::AsyncLineTraceBatch(
+				World.operator->(), EAsyncTraceType::Multi, Requests);
+			State = Result.Num();
+			for (int i = 0; i < Result.Num(); ++i)
+				Test.TestEqual(TEXT("No hits"), Result[i].Num(), 0);
+		});
+		World.Tick(); // This queries the async traces on the game thread
+		Test.TestEqual(TEXT("No results yet"), State, -1);
+		World.Tick(); // This completes them
+		Test.TestEqual(TEXT("Results"), State, 3);
+	}
+
+	{
+		int State = -1;
+		World.Run(CORO
+		{
+			auto Result = co_await Latent::AsyncLineTraceBatch(
+				World.operator->(), EAsyncTraceType::Single, {});
+			State = Result.Num();
+			co_await Latent::NextTick(); // Run() requires some co_await
+		});
+		Test.TestEqual(TEXT("Empty batch is instant"), State, 0);
+	}
+
 	{
 		int State = -1;
 		World.Run(CORO
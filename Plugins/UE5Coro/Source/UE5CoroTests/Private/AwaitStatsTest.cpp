@@ -0,0 +1,184 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "TestWorld.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/AutomationTest.h"
+#include "UE5Coro/Coroutine.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Private;
+using namespace UE5Coro::Private::Test;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAwaitStatsTestAsync,
+                                 "UE5Coro.AwaitStats.Async",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAwaitStatsTestLatent,
+                                 "UE5Coro.AwaitStats.Latent",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+namespace
+{
+// Its own type, so that its histograms only contain what this test did
+struct FAwaitStatsTestAwaiter : TAwaiter<FAwaitStatsTestAwaiter>
+{
+	FPromise*& Waiting;
+
+	explicit FAwaitStatsTestAwaiter(FPromise*& Waiting) : Waiting(Waiting) { }
+	void Suspend(FPromise& Promise) { Waiting = &Promise; }
+};
+
+#if UE5CORO_DEBUG
+struct FCapturingOutputDevice : FOutputDevice
+{
+	FString Text;
+
+	virtual void Serialize(const TCHAR* Value, ELogVerbosity::Type,
+	                       const FName&) override
+	{
+		Text += Value;
+		Text += TEXT('\n');
+	}
+};
+
+// One row of UE5Coro.AwaitStats.Dump
+struct FRow
+{
+	uint64 Resumes = 0;
+	double P99Ms = 0;
+	double DelayP99Ms = 0;
+};
+
+FRow DumpRow()
+{
+	FCapturingOutputDevice Output;
+	IConsoleManager::Get().ProcessUserConsoleInput(
+		TEXT("UE5Coro.AwaitStats.Dump"), Output, nullptr);
+	TArray<FString> Lines;
+	Output.Text.ParseIntoArrayLines(Lines);
+	FRow Row;
+	for (auto& Line : Lines)
+	{
+		if (!Line.Contains(TEXT("FAwaitStatsTestAwaiter")))
+			continue;
+		// Resumes, Avg ms, p50 ms, p99 ms, Delay p99, Awaiter type
+		TArray<FString> Columns;
+		Line.ParseIntoArrayWS(Columns);
+		if (Columns.Num() >= 6)
+		{
+			LexFromString(Row.Resumes, *Columns[0]);
+			LexFromString(Row.P99Ms, *Columns[3]);
+			LexFromString(Row.DelayP99Ms, *Columns[4]);
+		}
+	}
+	return Row;
+}
+#endif
+
+template<typename... T>
+void DoTest(FAutomationTestBase& Test)
+{
+	FTestWorld World;
+	auto* CVar = IConsoleManager::Get().FindConsoleVariable(
+		TEXT("UE5Coro.AwaitStats"));
+	if (!Test.TestNotNull(TEXT("AwaitStats cvar"), CVar))
+		return;
+	bool bWasEnabled = CVar->GetBool();
+	CVar->Set(true);
+
+#if UE5CORO_DEBUG
+	// Histograms are cumulative, only look at what changes
+	auto Before = DumpRow();
+#endif
+	FPromise* Waiting = nullptr;
+	int State = 0;
+	World.Run(CORO
+	{
+		for (int i = 0; i < 3; ++i)
+		{
+			co_await FAwaitStatsTestAwaiter(Waiting);
+			++State;
+		}
+	});
+	for (int i = 0; i < 3; ++i)
+	{
+		Test.TestNotNull(TEXT("Suspended"), Waiting);
+		if (!Waiting)
+			break;
+		FPlatformProcess::Sleep(0.002f);
+		// Everything after this counts as scheduling delay
+		Waiting->MarkAwaitReady();
+		FPlatformProcess::Sleep(0.005f);
+		std::exchange(Waiting, nullptr)->Resume();
+		Test.TestEqual(TEXT("Resumed"), State, i + 1);
+	}
+	Test.TestNull(TEXT("Done"), Waiting);
+
+#if UE5CORO_DEBUG
+	auto After = DumpRow();
+	Test.TestEqual(TEXT("Resumes counted"), After.Resumes - Before.Resumes,
+	               uint64(3));
+	// p99 is the upper bound of a log2 bucket, it's never below the sample
+	Test.TestTrue(TEXT("Suspension measured"), After.P99Ms >= 7);
+	Test.TestTrue(TEXT("Delay measured"), After.DelayP99Ms >= 5);
+
+	// Nothing is recorded while off
+	CVar->Set(false);
+	World.Run(CORO
+	{
+		co_await FAwaitStatsTestAwaiter(Waiting);
+	});
+	if (Test.TestNotNull(TEXT("Suspended"), Waiting))
+		std::exchange(Waiting, nullptr)->Resume();
+	Test.TestEqual(TEXT("Not counted when off"), DumpRow().Resumes,
+	               After.Resumes);
+#endif
+	CVar->Set(bWasEnabled);
+}
+}
+
+bool FAwaitStatsTestAsync::RunTest(const FString& Parameters)
+{
+	DoTest<>(*this);
+	return true;
+}
+
+bool FAwaitStatsTestLatent::RunTest(const FString& Parameters)
+{
+	DoTest<FLatentActionInfo>(*this);
+	return true;
+}
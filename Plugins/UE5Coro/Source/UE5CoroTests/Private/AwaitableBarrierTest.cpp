@@ -0,0 +1,106 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "TestWorld.h"
+#include "Misc/AutomationTest.h"
+#include "UE5Coro/Threading.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Private::Test;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBarrierAsyncTest,
+                                 "UE5Coro.Threading.Barrier.Async",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::CriticalPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FBarrierLatentTest,
+                                 "UE5Coro.Threading.Barrier.Latent",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::CriticalPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+namespace
+{
+template<typename... T>
+void DoTest(FAutomationTestBase& Test)
+{
+	FTestWorld World;
+
+	{
+		int Phases = 0;
+		int NextIndex = 0;
+		TArray<int> Order;
+		FAwaitableBarrier Barrier(3, [&] { ++Phases; Order.Add(-1); });
+		for (int i = 0; i < 3; ++i)
+			World.Run(CORO
+			{
+				int Index = NextIndex++;
+				for (int j = 0; j < 2; ++j)
+				{
+					co_await Barrier.ArriveAndWait();
+					Order.Add(Index);
+				}
+			});
+		Test.TestEqual(TEXT("Two phases"), Phases, 2);
+		// The last one to arrive is resumed after the others
+		Test.TestTrue(TEXT("Order"),
+		              Order == TArray{-1, 1, 0, 2, -1, 0, 1, 2});
+	}
+
+	{
+		int State = 0;
+		FAwaitableBarrier Barrier(2);
+		World.Run(CORO
+		{
+			co_await Barrier.ArriveAndWait();
+			++State;
+			co_await Barrier.ArriveAndWait();
+			++State;
+		});
+		Test.TestEqual(TEXT("Waiting"), State, 0);
+		Barrier.ArriveAndDrop();
+		Test.TestEqual(TEXT("Released by drop"), State, 2);
+	}
+}
+}
+
+bool FBarrierAsyncTest::RunTest(const FString& Parameters)
+{
+	DoTest<>(*this);
+	return true;
+}
+
+bool FBarrierLatentTest::RunTest(const FString& Parameters)
+{
+	DoTest<FLatentActionInfo>(*this);
+	return true;
+}
@@ -30,7 +30,9 @@
 // ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "TestWorld.h"
+#include "Async/Async.h"
 #include "Misc/AutomationTest.h"
+#include "UE5Coro/AsyncAwaiters.h"
 #include "UE5Coro/Threading.h"
 
 using namespace UE5Coro;
@@ -150,6 +152,53 @@ void DoTest(FAutomationTestBase& Test)
 		Event.Trigger();
 		Test.TestEqual(TEXT("Trigger 3"), State, 4);
 	}
+
+	{
+		int State = 0;
+		FAwaitableEvent Event(EEventMode::ManualReset);
+		for (int i = 0; i < 3; ++i)
+			World.Run(CORO
+			{
+				co_await Event;
+				++State;
+			});
+		Event.TriggerAsync();
+		Test.TestEqual(TEXT("Not resumed inline"), State, 0);
+		World.Tick();
+		Test.TestEqual(TEXT("Resumed on the game thread"), State, 3);
+
+		Event.Reset();
+		for (int i = 0; i < 3; ++i)
+			World.Run(CORO
+			{
+				co_await Event;
+				++State;
+			});
+		Event.TriggerParallel(2);
+		Test.TestEqual(TEXT("One batch inline"), State, 5);
+		World.Tick();
+		Test.TestEqual(TEXT("Rest on the game thread"), State, 6);
+	}
+
+	{
+		int State = 0;
+		FAwaitableEvent Event(EEventMode::ManualReset);
+		for (int i = 0; i < 2; ++i)
+			World.Run(CORO
+			{
+				bool bStay = i == 0; // i is gone after the co_await
+				if (bStay)
+					co_await Event.WaitOnThisThread();
+				else
+					co_await Event;
+				Test.TestEqual(TEXT("Game thread"), IsInGameThread(), bStay);
+				++State;
+			});
+		Async(EAsyncExecution::ThreadPool, [&] { Event.Trigger(); }).Wait();
+		Test.TestEqual(TEXT("Only the other one resumed"), State, 1);
+		World.Tick();
+		Test.TestEqual(TEXT("Resumed on the game thread"), State, 2);
+	}
 }
 }
 
@@ -157,6 +206,31 @@ bool FEventAsyncTest::RunTest(const FString& Parameters)
 {
 	DoTest<EEventMode::AutoReset>(*this);
 	DoTest<EEventMode::ManualReset>(*this);
+
+	{
+		// Background waiters are spread over multiple tasks
+		constexpr int Count = 100;
+		FAwaitableEvent Event(EEventMode::ManualReset);
+		std::atomic<int> Waiting = 0;
+		std::atomic<int> Resumed = 0;
+		TArray<TCoroutine<>> Coros;
+		for (int i = 0; i < Count; ++i)
+			Coros.Add([&]() -> TCoroutine<>
+			{
+				co_await Async::MoveToThread(
+					ENamedThreads::AnyBackgroundThreadNormalTask);
+				++Waiting;
+				co_await Event;
+				TestFalse(TEXT("Background"), IsInGameThread());
+				++Resumed;
+			}());
+		while (Waiting < Count)
+			FPlatformProcess::Sleep(0.001f);
+		Event.TriggerAsync(8);
+		for (auto& Coro : Coros)
+			TestTrue(TEXT("Done"), Coro.Wait(10000));
+		TestEqual(TEXT("All resumed"), Resumed.load(), Count);
+	}
 	return true;
 }
 
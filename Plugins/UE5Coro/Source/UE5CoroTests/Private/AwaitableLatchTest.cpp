@@ -0,0 +1,105 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "TestWorld.h"
+#include "Misc/AutomationTest.h"
+#include "UE5Coro/Threading.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Private::Test;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLatchAsyncTest, "UE5Coro.Threading.Latch.Async",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::CriticalPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLatchLatentTest, "UE5Coro.Threading.Latch.Latent",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::CriticalPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+namespace
+{
+template<typename... T>
+void DoTest(FAutomationTestBase& Test)
+{
+	FTestWorld World;
+
+	{
+		FAwaitableLatch Latch(0);
+		Test.TestTrue(TEXT("Zero is released"), Latch.IsReleased());
+		bool bDone = false;
+		World.Run(CORO
+		{
+			co_await Latch;
+			bDone = true;
+		});
+		Test.TestTrue(TEXT("Not suspended"), bDone);
+	}
+
+	{
+		int State = 0;
+		FAwaitableLatch Latch(3);
+		for (int i = 0; i < 4; ++i)
+			World.Run(CORO
+			{
+				co_await Latch;
+				++State;
+			});
+		Test.TestEqual(TEXT("All waiting"), State, 0);
+		Latch.CountDown();
+		Latch.CountDown(0);
+		Test.TestEqual(TEXT("Still waiting"), State, 0);
+		Test.TestFalse(TEXT("Not released"), Latch.IsReleased());
+		Latch.CountDown(2);
+		Test.TestEqual(TEXT("All released"), State, 4);
+		Test.TestTrue(TEXT("Released"), Latch.IsReleased());
+		World.Run(CORO
+		{
+			co_await Latch;
+			++State;
+		});
+		Test.TestEqual(TEXT("Stays released"), State, 5);
+	}
+}
+}
+
+bool FLatchAsyncTest::RunTest(const FString& Parameters)
+{
+	DoTest<>(*this);
+	return true;
+}
+
+bool FLatchLatentTest::RunTest(const FString& Parameters)
+{
+	DoTest<FLatentActionInfo>(*this);
+	return true;
+}
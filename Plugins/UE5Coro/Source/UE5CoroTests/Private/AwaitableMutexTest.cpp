@@ -0,0 +1,115 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "TestWorld.h"
+#include "Misc/AutomationTest.h"
+#include "UE5Coro/Threading.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Private::Test;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMutexAsyncTest, "UE5Coro.Threading.Mutex.Async",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::CriticalPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMutexLatentTest, "UE5Coro.Threading.Mutex.Latent",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::CriticalPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+namespace
+{
+template<typename... T>
+void DoTest(FAutomationTestBase& Test)
+{
+	FTestWorld World;
+
+	{
+		FAwaitableMutex Mutex;
+		Test.TestTrue(TEXT("TryLock"), Mutex.TryLock());
+		Test.TestFalse(TEXT("TryLock locked"), Mutex.TryLock());
+		Mutex.Unlock();
+		Test.TestTrue(TEXT("TryLock unlocked"), Mutex.TryLock());
+		Mutex.Unlock();
+	}
+
+	{
+		int State = 0;
+		FAwaitableMutex Mutex;
+		World.Run(CORO
+		{
+			auto Lock = co_await Mutex.Lock();
+			++State;
+		});
+		Test.TestEqual(TEXT("Uncontended"), State, 1);
+		Test.TestTrue(TEXT("Unlocked by scope"), Mutex.TryLock());
+		Mutex.Unlock();
+	}
+
+	{
+		int NextIndex = 0;
+		TArray<int> Order;
+		FAwaitableMutex Mutex;
+		Test.TestTrue(TEXT("Locked externally"), Mutex.TryLock());
+		for (int i = 0; i < 4; ++i)
+			World.Run(CORO
+			{
+				int Index = NextIndex++;
+				auto Lock = co_await Mutex.Lock();
+				Order.Add(Index);
+				if (Index == 1)
+				{
+					Lock.Unlock();
+					Order.Add(-1);
+				}
+			});
+		Test.TestEqual(TEXT("All waiting"), Order.Num(), 0);
+		Mutex.Unlock();
+		Test.TestTrue(TEXT("Handed off in FIFO order"),
+		              Order == TArray{0, 1, 2, 3, -1});
+		Test.TestTrue(TEXT("Unlocked at the end"), Mutex.TryLock());
+		Mutex.Unlock();
+	}
+}
+}
+
+bool FMutexAsyncTest::RunTest(const FString& Parameters)
+{
+	DoTest<>(*this);
+	return true;
+}
+
+bool FMutexLatentTest::RunTest(const FString& Parameters)
+{
+	DoTest<FLatentActionInfo>(*this);
+	return true;
+}
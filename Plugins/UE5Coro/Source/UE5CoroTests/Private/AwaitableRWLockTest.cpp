@@ -0,0 +1,130 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "TestWorld.h"
+#include "Misc/AutomationTest.h"
+#include "UE5Coro/Threading.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Private::Test;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRWLockAsyncTest, "UE5Coro.Threading.RWLock.Async",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::CriticalPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRWLockLatentTest, "UE5Coro.Threading.RWLock.Latent",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::CriticalPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+namespace
+{
+template<typename... T>
+void DoTest(FAutomationTestBase& Test)
+{
+	FTestWorld World;
+
+	{
+		FAwaitableRWLock RWLock;
+		Test.TestTrue(TEXT("Read 1"), RWLock.TryReadLock());
+		Test.TestTrue(TEXT("Read 2"), RWLock.TryReadLock());
+		Test.TestFalse(TEXT("Write while read"), RWLock.TryWriteLock());
+		RWLock.ReadUnlock();
+		RWLock.ReadUnlock();
+		Test.TestTrue(TEXT("Write"), RWLock.TryWriteLock());
+		Test.TestFalse(TEXT("Read while written"), RWLock.TryReadLock());
+		RWLock.WriteUnlock();
+	}
+
+	{
+		FAwaitableEvent Event;
+		int NumReading = 0;
+		int MaxReading = 0;
+		FAwaitableRWLock RWLock;
+		for (int i = 0; i < 3; ++i)
+			World.Run(CORO
+			{
+				auto Lock = co_await RWLock.ReadLock();
+				MaxReading = FMath::Max(MaxReading, ++NumReading);
+				co_await Event;
+				--NumReading;
+			});
+		Test.TestEqual(TEXT("Concurrent readers"), MaxReading, 3);
+
+		bool bWritten = false;
+		World.Run(CORO
+		{
+			auto Lock = co_await RWLock.WriteLock();
+			Test.TestEqual(TEXT("No readers while writing"), NumReading, 0);
+			bWritten = true;
+		});
+		Test.TestFalse(TEXT("Writer waits for readers"), bWritten);
+		Test.TestFalse(TEXT("Readers queue behind a waiting writer"),
+		               RWLock.TryReadLock());
+
+		Event.Trigger();
+		Event.Trigger();
+		Test.TestFalse(TEXT("Writer still waiting"), bWritten);
+		Event.Trigger();
+		Test.TestTrue(TEXT("Writer resumed by last reader"), bWritten);
+		Test.TestTrue(TEXT("Unlocked at the end"), RWLock.TryWriteLock());
+		RWLock.WriteUnlock();
+	}
+
+	{
+		int NumRead = 0;
+		FAwaitableRWLock RWLock;
+		Test.TestTrue(TEXT("Write locked"), RWLock.TryWriteLock());
+		for (int i = 0; i < 4; ++i)
+			World.Run(CORO
+			{
+				auto Lock = co_await RWLock.ReadLock();
+				++NumRead;
+			});
+		Test.TestEqual(TEXT("Readers waiting"), NumRead, 0);
+		RWLock.WriteUnlock();
+		Test.TestEqual(TEXT("All readers resumed"), NumRead, 4);
+	}
+}
+}
+
+bool FRWLockAsyncTest::RunTest(const FString& Parameters)
+{
+	DoTest<>(*this);
+	return true;
+}
+
+bool FRWLockLatentTest::RunTest(const FString& Parameters)
+{
+	DoTest<FLatentActionInfo>(*this);
+	return true;
+}
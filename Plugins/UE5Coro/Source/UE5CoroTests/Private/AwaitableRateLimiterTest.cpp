@@ -0,0 +1,112 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "TestWorld.h"
+#include "Algo/AllOf.h"
+#include "Misc/AutomationTest.h"
+#include "UE5Coro/AsyncAwaiters.h"
+#include "UE5Coro/Threading.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Private::Test;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRateLimiterTest, "UE5Coro.Threading.RateLimiter",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+bool FRateLimiterTest::RunTest(const FString& Parameters)
+{
+	{
+		FAwaitableRateLimiter Limiter(1, 3);
+		TestTrue(TEXT("Starts full"), Limiter.GetTokens() >= 3);
+		TestTrue(TEXT("Burst 1"), Limiter.TryAcquire(2));
+		TestTrue(TEXT("Burst 2"), Limiter.TryAcquire());
+		TestFalse(TEXT("Empty"), Limiter.TryAcquire());
+	}
+
+	{
+		// Synchronous when there are enough tokens
+		FAwaitableRateLimiter Limiter(1, 2);
+		bool bDone = false;
+		auto Coro = [&]() -> TCoroutine<>
+		{
+			co_await Limiter.Acquire(2);
+			bDone = true;
+		}();
+		TestTrue(TEXT("Not suspended"), bDone);
+	}
+
+	{
+		FTestWorld World;
+		constexpr double Rate = 100;
+		FAwaitableRateLimiter Limiter(Rate, 5);
+		std::atomic<int> NextIndex = 0;
+		TArray<int> Order;
+		Order.SetNum(10);
+		TArray<TCoroutine<>> Coros;
+		auto Start = FPlatformTime::Seconds();
+		for (int i = 0; i < 10; ++i)
+			Coros.Add([&, Index = i]() -> TCoroutine<>
+			{
+				co_await Limiter.Acquire();
+				Order[NextIndex++] = Index;
+			}());
+		TestTrue(TEXT("Tokens held back for waiters"), !Limiter.TryAcquire());
+		// These will resume on the game thread
+		FTestHelper::PumpGameThread(World, [&]
+		{
+			return Algo::AllOf(Coros, [](auto& Coro) { return Coro.IsDone(); });
+		});
+		auto Elapsed = FPlatformTime::Seconds() - Start;
+		// 5 tokens were available immediately, then 5 more at 100/s
+		TestTrue(TEXT("Rate respected"), Elapsed >= 4.5 / Rate);
+		for (int i = 0; i < 10; ++i)
+			TestEqual(TEXT("FIFO"), Order[i], i);
+	}
+
+	{
+		// Waiters resume on the kind of thread they suspended on
+		FAwaitableRateLimiter Limiter(50, 1);
+		auto Coro = [&]() -> TCoroutine<bool>
+		{
+			co_await Async::MoveToThread(
+				ENamedThreads::AnyBackgroundThreadNormalTask);
+			co_await Limiter.Acquire();
+			co_await Limiter.Acquire();
+			co_return !IsInGameThread();
+		}();
+		TestTrue(TEXT("Done"), Coro.Wait(1000));
+		TestTrue(TEXT("Background thread"), Coro.GetResult());
+	}
+	return true;
+}
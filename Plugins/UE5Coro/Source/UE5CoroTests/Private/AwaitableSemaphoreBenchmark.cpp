@@ -0,0 +1,98 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "TestWorld.h"
+#include "Misc/AutomationTest.h"
+#include "UE5Coro/AsyncAwaiters.h"
+#include "UE5Coro/Threading.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Private::Test;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSemaContentionTest,
+                                 "UE5Coro.Threading.Semaphore.Contention",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::MediumPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+namespace
+{
+struct FState
+{
+	std::atomic<int> Inside = 0;
+	std::atomic<int> MaxInside = 0;
+	std::atomic<int> Counter = 0;
+};
+
+TCoroutine<> Worker(FAwaitableSemaphore& Semaphore, FState& State, int Count)
+{
+	co_await Async::MoveToThread(ENamedThreads::AnyBackgroundThreadNormalTask);
+	for (int i = 0; i < Count; ++i)
+	{
+		co_await Semaphore;
+		int Inside = ++State.Inside;
+		for (int Max = State.MaxInside; Inside > Max &&
+		     !State.MaxInside.compare_exchange_weak(Max, Inside);)
+			;
+		++State.Counter;
+		--State.Inside;
+		// Move away before unlocking, otherwise resumptions would nest
+		co_await Async::Yield();
+		Semaphore.Unlock();
+	}
+}
+}
+
+bool FSemaContentionTest::RunTest(const FString& Parameters)
+{
+	constexpr int NumWorkers = 32;
+	constexpr int Count = 1000;
+	for (int Capacity : {1, 4})
+	{
+		FAwaitableSemaphore Semaphore(Capacity, Capacity);
+		FState State;
+		TArray<TCoroutine<>> Workers;
+		auto Start = FPlatformTime::Seconds();
+		for (int i = 0; i < NumWorkers; ++i)
+			Workers.Add(Worker(Semaphore, State, Count));
+		for (auto& Coro : Workers)
+			Coro.Wait();
+		auto End = FPlatformTime::Seconds();
+
+		TestTrue(TEXT("Capacity respected"), State.MaxInside <= Capacity);
+		TestEqual(TEXT("Every iteration ran"), State.Counter.load(),
+		          NumWorkers * Count);
+		AddInfo(FString::Printf(TEXT("Capacity %d, %d workers: %.1f ns per lock"),
+		                        Capacity, NumWorkers,
+		                        (End - Start) * 1e9 / (NumWorkers * Count)));
+	}
+	return true;
+}
@@ -30,6 +30,7 @@
 // ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "TestWorld.h"
+#include "Async/Async.h"
 #include "Misc/AutomationTest.h"
 #include "UE5Coro/Threading.h"
 
@@ -108,6 +109,65 @@ void DoTest(FAutomationTestBase& Test)
 		Semaphore.Unlock(100);
 		Test.TestEqual(TEXT("State 5"), State, 19);
 	}
+
+	{
+		int NextIndex = 0;
+		TArray<int> Order;
+		FAwaitableSemaphore Semaphore(10, 0, ESemaphoreOrder::FIFO);
+		for (int i = 0; i < 5; ++i)
+			World.Run(CORO
+			{
+				int Index = NextIndex++;
+				co_await Semaphore;
+				Order.Add(Index);
+			});
+		Semaphore.Unlock();
+		Test.TestTrue(TEXT("Oldest first"), Order == TArray{0});
+		Semaphore.Unlock(4);
+		Test.TestTrue(TEXT("FIFO order"), Order == TArray{0, 1, 2, 3, 4});
+	}
+
+	{
+		int State = 0;
+		FAwaitableSemaphore Semaphore(10, 0);
+		for (int i = 0; i < 3; ++i)
+			World.Run(CORO
+			{
+				co_await Semaphore;
+				++State;
+			});
+		Semaphore.UnlockBatch(3);
+		Test.TestEqual(TEXT("Not resumed inline"), State, 0);
+		World.Tick();
+		Test.TestEqual(TEXT("Resumed on the game thread"), State, 3);
+
+		auto Stats = Semaphore.GetStats();
+		Test.TestTrue(TEXT("Waits counted"), Stats.NumWaits == 3);
+		Test.TestTrue(TEXT("Percentiles ordered"),
+		              Stats.P50Seconds <= Stats.P99Seconds);
+		Test.TestTrue(TEXT("Max tracked"), Stats.MaxSeconds >= 0);
+	}
+
+	{
+		int State = 0;
+		FAwaitableSemaphore Semaphore(10, 0);
+		for (int i = 0; i < 2; ++i)
+			World.Run(CORO
+			{
+				bool bStay = i == 0; // i is gone after the co_await
+				if (bStay)
+					co_await Semaphore.LockOnThisThread();
+				else
+					co_await Semaphore;
+				Test.TestEqual(TEXT("Game thread"), IsInGameThread(), bStay);
+				++State;
+			});
+		Async(EAsyncExecution::ThreadPool, [&] { Semaphore.Unlock(2); })
+			.Wait();
+		Test.TestEqual(TEXT("Only the other one resumed"), State, 1);
+		World.Tick();
+		Test.TestEqual(TEXT("Resumed on the game thread"), State, 2);
+	}
 }
 }
 
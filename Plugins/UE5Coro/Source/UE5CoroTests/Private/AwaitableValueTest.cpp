@@ -0,0 +1,137 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "TestWorld.h"
+#include "Misc/AutomationTest.h"
+#include "UE5Coro/AsyncAwaiters.h"
+#include "UE5Coro/Threading.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Private::Test;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAwaitableValueAsyncTest,
+                                 "UE5Coro.Threading.Value.Async",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::CriticalPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAwaitableValueLatentTest,
+                                 "UE5Coro.Threading.Value.Latent",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::CriticalPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+namespace
+{
+template<typename... T>
+void DoTest(FAutomationTestBase& Test)
+{
+	FTestWorld World;
+
+	{
+		TAwaitableValue<int> Value(5);
+		Test.TestEqual(TEXT("Initial value"), Value.Get(), 5);
+		int Result = 0;
+		World.Run(CORO
+		{
+			Result = co_await Value.Until([](int i) { return i > 0; });
+		});
+		Test.TestEqual(TEXT("Already satisfied"), Result, 5);
+	}
+
+	{
+		TAwaitableValue<int> Value;
+		int Calls = 0;
+		int Result = 0;
+		World.Run(CORO
+		{
+			Result = co_await Value.Until([&](int i)
+			{
+				++Calls;
+				return i >= 3;
+			});
+		});
+		Test.TestEqual(TEXT("Checked before suspending"), Calls, 2);
+		World.EndTick();
+		World.Tick();
+		Test.TestEqual(TEXT("Not polled"), Calls, 2);
+		Value.Set(1);
+		Value.Set(2);
+		Test.TestEqual(TEXT("Checked on writes"), Calls, 4);
+		Test.TestEqual(TEXT("Still waiting"), Result, 0);
+		Value.Set(3);
+		Test.TestEqual(TEXT("Resumed"), Result, 3);
+		Value.Set(4);
+		Test.TestEqual(TEXT("Removed"), Calls, 5);
+	}
+
+	{
+		TAwaitableValue<FString> Value(TEXT("A"));
+		TArray<FString> Seen;
+		World.Run(CORO
+		{
+			for (int i = 0; i < 2; ++i)
+				Seen.Add(co_await Value.Changed());
+		});
+		Test.TestEqual(TEXT("Waiting for a change"), Seen.Num(), 0);
+		Value.Set(TEXT("B"));
+		Value.Set(TEXT("C"));
+		Test.TestTrue(TEXT("Every change"), Seen == TArray<FString>{
+			TEXT("B"), TEXT("C")});
+	}
+
+	{
+		TAwaitableValue<int> Value;
+		FEventRef Done;
+		World.Run(CORO
+		{
+			co_await Async::MoveToNewThread();
+			co_await Value.Until([](int i) { return i == 100; });
+			Done->Trigger();
+		});
+		for (int i = 1; i <= 100; ++i)
+			Value.Set(i);
+		Test.TestTrue(TEXT("Across threads"), Done->Wait(1000));
+	}
+}
+}
+
+bool FAwaitableValueAsyncTest::RunTest(const FString& Parameters)
+{
+	DoTest<>(*this);
+	return true;
+}
+
+bool FAwaitableValueLatentTest::RunTest(const FString& Parameters)
+{
+	DoTest<FLatentActionInfo>(*this);
+	return true;
+}
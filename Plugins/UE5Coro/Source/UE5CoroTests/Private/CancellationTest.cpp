@@ -31,10 +31,14 @@
 
 #include "TestWorld.h"
 #include "Misc/AutomationTest.h"
+#include "UE5Coro/AggregateAwaiters.h"
 #include "UE5Coro/AsyncAwaiters.h"
 #include "UE5Coro/Cancellation.h"
+#include "UE5Coro/CoroutineAwaiters.h"
+#include "UE5Coro/CoroutineScope.h"
 #include "UE5Coro/LatentAwaiters.h"
 #include "UE5Coro/LatentCallbacks.h"
+#include "UE5Coro/Threading.h"
 
 using namespace UE5Coro;
 using namespace UE5Coro::Private;
@@ -50,8 +54,46 @@ IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCancelTestLatent, "UE5Coro.Cancel.Latent",
                                  EAutomationTestFlags::HighPriority |
                                  EAutomationTestFlags::ProductFilter)
 
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCancelPropagationTest,
+                                 "UE5Coro.Cancel.Propagation",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCancelScopeTest, "UE5Coro.Cancel.Scope",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCancelTeardownBenchmark,
+                                 "UE5Coro.Cancel.Teardown",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::MediumPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
 namespace
 {
+TCoroutine<> Sleeper()
+{
+	co_await Async::PlatformSecondsAnyThread(60);
+}
+
+TCoroutine<> WaitFor(FAwaitableEvent& Event)
+{
+	co_await Event;
+}
+
+TCoroutine<> AwaitChild(TCoroutine<> Child)
+{
+	co_await Child;
+}
+
+TCoroutine<> AwaitChildGuarded(TCoroutine<> Child)
+{
+	FCancellationGuard _;
+	co_await Child;
+}
+
 template<typename... T>
 void DoTest(FAutomationTestBase& Test)
 {
@@ -309,3 +351,192 @@ bool FCancelTestLatent::RunTest(const FString& Parameters)
 	DoTest<FLatentActionInfo>(*this);
 	return true;
 }
+
+bool FCancelPropagationTest::RunTest(const FString& Parameters)
+{
+	{
+		FAwaitableEvent Event(EEventMode::ManualReset);
+		auto Child = WaitFor(Event);
+		auto Parent = AwaitChild(Child);
+		Parent.Cancel();
+		Event.Trigger();
+		TestTrue(TEXT("Child done"), Child.IsDone());
+		TestFalse(TEXT("Child canceled with its parent"), Child.WasSuccessful());
+		TestTrue(TEXT("Parent done"), Parent.IsDone());
+		TestFalse(TEXT("Parent canceled"), Parent.WasSuccessful());
+	}
+
+	{
+		FAwaitableEvent Event(EEventMode::ManualReset);
+		auto Child = WaitFor(Event);
+		auto Parent = AwaitChildGuarded(Child);
+		Parent.Cancel();
+		Event.Trigger();
+		TestTrue(TEXT("Guarded cancellations don't propagate"),
+		         Child.WasSuccessful());
+	}
+
+	{
+		FAwaitableEvent Event(EEventMode::ManualReset);
+		auto Child1 = WaitFor(Event);
+		auto Child2 = WaitFor(Event);
+		auto Parent = [](TCoroutine<> A, TCoroutine<> B) -> TCoroutine<>
+		{
+			co_await WhenAll(A, B);
+		}(Child1, Child2);
+		Parent.Cancel();
+		Event.Trigger();
+		TestFalse(TEXT("WhenAll child 1 canceled"), Child1.WasSuccessful());
+		TestFalse(TEXT("WhenAll child 2 canceled"), Child2.WasSuccessful());
+		TestTrue(TEXT("Parent done"), Parent.IsDone());
+	}
+
+	{
+		FAwaitableEvent Event(EEventMode::ManualReset);
+		auto Child1 = WaitFor(Event);
+		auto Child2 = WaitFor(Event);
+		auto Parent = [](TCoroutine<> A, TCoroutine<> B) -> TCoroutine<>
+		{
+			co_await Race(A, B);
+		}(Child1, Child2);
+		Parent.Cancel();
+		Event.Trigger();
+		TestFalse(TEXT("Race child 1 canceled"), Child1.WasSuccessful());
+		TestFalse(TEXT("Race child 2 canceled"), Child2.WasSuccessful());
+		TestTrue(TEXT("Parent done"), Parent.IsDone());
+	}
+
+	{
+		// The loser of WhenAny is not canceled if it was passed in directly
+		FAwaitableEvent Event1, Event2;
+		auto Child1 = WaitFor(Event1);
+		auto Child2 = WaitFor(Event2);
+		auto Parent = [](TCoroutine<> A, TCoroutine<> B) -> TCoroutine<>
+		{
+			co_await WhenAny(A, B);
+		}(Child1, Child2);
+		Event1.Trigger();
+		TestTrue(TEXT("Parent done"), Parent.IsDone());
+		Event2.Trigger();
+		TestTrue(TEXT("Loser still successful"), Child2.WasSuccessful());
+	}
+	return true;
+}
+
+bool FCancelTeardownBenchmark::RunTest(const FString& Parameters)
+{
+	constexpr int Count = 10000;
+	TArray<TCoroutine<>> Coros;
+	Coros.Reserve(Count);
+	for (int i = 0; i < Count; ++i)
+		Coros.Add(Sleeper());
+
+	// Canceled timers are handed back right away, not after 60 seconds
+	auto Start = FPlatformTime::Seconds();
+	for (auto& Coro : Coros)
+		Coro.Cancel();
+	bool bAllDone = false;
+	while (!bAllDone && FPlatformTime::Seconds() - Start < 10)
+	{
+		bAllDone = true;
+		for (auto& Coro : Coros)
+			if (!Coro.IsDone())
+			{
+				bAllDone = false;
+				FPlatformProcess::YieldThread();
+				break;
+			}
+	}
+	auto End = FPlatformTime::Seconds();
+
+	TestTrue(TEXT("All done"), bAllDone);
+	for (auto& Coro : Coros)
+		if (!Coro.IsDone() || Coro.WasSuccessful())
+		{
+			AddError(TEXT("Sleeper was not canceled"));
+			break;
+		}
+	AddInfo(FString::Printf(TEXT("Teardown of %d sleepers: %.3f ms"), Count,
+	                        (End - Start) * 1e3));
+	return true;
+}
+
+bool FCancelScopeTest::RunTest(const FString& Parameters)
+{
+	{
+		FCoroutineScope Scope;
+		bool bJoined = false;
+		auto Joiner = [&]() -> TCoroutine<>
+		{
+			co_await Scope.Join();
+			bJoined = true;
+		}();
+		TestTrue(TEXT("Empty scope joined"), bJoined);
+		TestTrue(TEXT("Joiner done"), Joiner.IsDone());
+
+		Scope.Add(TCoroutine<>::CompletedCoroutine);
+		TestEqual(TEXT("Completed coroutine ignored"), Scope.Num(), 0);
+	}
+
+	{
+		FCoroutineScope Scope;
+		FAwaitableEvent Event(EEventMode::ManualReset);
+		TArray<TCoroutine<>> Coros;
+		for (int i = 0; i < 3; ++i)
+			Coros.Add(WaitFor(Event));
+		Coros.Add(Sleeper());
+		for (auto& Coro : Coros)
+			Scope.Add(Coro);
+		Scope.Add(Coros[0]); // Adding twice to the same scope is allowed
+		TestEqual(TEXT("Num"), Scope.Num(), 4);
+
+		std::atomic<bool> bJoined = false;
+		auto Joiner = [&]() -> TCoroutine<>
+		{
+			co_await Scope.Join();
+			bJoined = true;
+		}();
+		TestFalse(TEXT("Not joined yet"), bJoined.load());
+
+		Scope.CancelAll();
+		TestTrue(TEXT("Canceled"), Scope.IsCanceled());
+		// The sleeper's timer is canceled right away
+		TestTrue(TEXT("Sleeper woken"), Coros[3].Wait(10000));
+		TestFalse(TEXT("Still waiting for the events"), bJoined.load());
+
+		// Events are not cancelable, these notice the flag when resumed
+		Event.Trigger();
+		for (auto& Coro : Coros)
+		{
+			TestTrue(TEXT("Done"), Coro.IsDone());
+			TestFalse(TEXT("Canceled"), Coro.WasSuccessful());
+		}
+		TestTrue(TEXT("Joiner done"), Joiner.Wait(1000));
+		TestTrue(TEXT("Joined"), bJoined.load());
+		TestTrue(TEXT("Joiner itself not canceled"), Joiner.WasSuccessful());
+		TestEqual(TEXT("Empty"), Scope.Num(), 0);
+
+		// Later additions are canceled, too
+		FAwaitableEvent Event2;
+		auto Late = WaitFor(Event2);
+		Scope.Add(Late);
+		Event2.Trigger();
+		TestTrue(TEXT("Late done"), Late.IsDone());
+		TestFalse(TEXT("Late canceled"), Late.WasSuccessful());
+	}
+
+	{
+		FAwaitableEvent Event;
+		TCoroutine<> Coro = TCoroutine<>::CompletedCoroutine;
+		{
+			FCoroutineScope Scope;
+			Coro = WaitFor(Event);
+			Scope.Add(Coro);
+		}
+		// Destroying the scope canceled the coroutine, and it can still finish
+		Event.Trigger();
+		TestTrue(TEXT("Done after scope"), Coro.IsDone());
+		TestFalse(TEXT("Canceled by the scope"), Coro.WasSuccessful());
+	}
+	return true;
+}
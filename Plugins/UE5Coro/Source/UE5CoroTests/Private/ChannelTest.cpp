@@ -0,0 +1,201 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "TestWorld.h"
+#include "Misc/AutomationTest.h"
+#include "UE5Coro/AggregateAwaiters.h"
+#include "UE5Coro/AsyncAwaiters.h"
+#include "UE5Coro/Threading.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Private::Test;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChannelAsyncTest, "UE5Coro.Threading.Channel.Async",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::CriticalPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChannelLatentTest, "UE5Coro.Threading.Channel.Latent",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::CriticalPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChannelThreadTest, "UE5Coro.Threading.Channel.Threads",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::MediumPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+namespace
+{
+template<typename... T>
+void DoTest(FAutomationTestBase& Test)
+{
+	FTestWorld World;
+
+	{
+		TChannel<int> Channel(2);
+		TArray<int> Sent;
+		World.Run(CORO
+		{
+			for (int i = 0; i < 5; ++i)
+			{
+				bool bSent = co_await Channel.Send(i);
+				if (bSent)
+					Sent.Add(i);
+			}
+		});
+		Test.TestEqual(TEXT("Backpressure"), Sent.Num(), 2);
+
+		TArray<int> Received;
+		World.Run(CORO
+		{
+			while (auto Value = co_await Channel.Receive())
+				Received.Add(*Value);
+		});
+		Test.TestTrue(TEXT("Received in order"),
+		              Received == TArray{0, 1, 2, 3, 4});
+		Test.TestEqual(TEXT("Sender resumed"), Sent.Num(), 5);
+		Test.TestTrue(TEXT("Try send"), Channel.TrySend(5));
+		Test.TestEqual(TEXT("Receiver resumed"), Received.Num(), 6);
+
+		Channel.Close();
+		Test.TestTrue(TEXT("Closed"), Channel.IsClosed());
+		Test.TestFalse(TEXT("Send after close"), Channel.TrySend(6));
+		Test.TestFalse(TEXT("Receive after close"),
+		               Channel.TryReceive().IsSet());
+	}
+
+	{
+		TChannel<FString> Channel;
+		for (int i = 0; i < 10; ++i)
+			Test.TestTrue(TEXT("Unbounded"),
+			              Channel.TrySend(FString::FromInt(i)));
+
+		TArray<FString> Batch;
+		bool bDrained = false;
+		World.Run(CORO
+		{
+			Batch = co_await Channel.ReceiveUpTo(4);
+			Test.TestEqual(TEXT("Batch size"), Batch.Num(), 4);
+			Batch = co_await Channel.ReceiveUpTo(100);
+			Test.TestEqual(TEXT("Up to what's there"), Batch.Num(), 6);
+			Batch = co_await Channel.ReceiveUpTo(100);
+			bDrained = Batch.Num() == 0;
+		});
+		Test.TestFalse(TEXT("Waiting for more"), bDrained);
+		Test.TestEqual(TEXT("Last batch"), Batch.Last(), FString(TEXT("9")));
+		Channel.Close();
+		Test.TestTrue(TEXT("Closed while waiting"), bDrained);
+	}
+
+	{
+		TChannel<int> A(1), B(1);
+		int Index = -1;
+		TOptional<int> Value;
+		World.Run(CORO
+		{
+			Index = co_await WhenAny(A.WhenReadable(), B.WhenReadable());
+			Value = (Index == 0 ? A : B).TryReceive();
+		});
+		Test.TestEqual(TEXT("Nothing readable"), Index, -1);
+		Test.TestTrue(TEXT("Send"), B.TrySend(42));
+		Test.TestEqual(TEXT("Readable index"), Index, 1);
+		Test.TestEqual(TEXT("Value"), Value.Get(0), 42);
+
+		// The other WhenReadable is still waiting, but it does not consume
+		Test.TestTrue(TEXT("Send"), A.TrySend(1));
+		Test.TestEqual(TEXT("Not lost"), A.TryReceive().Get(0), 1);
+	}
+}
+
+TCoroutine<> Produce(TChannel<int>& Channel, int Begin, int End)
+{
+	co_await Async::MoveToThread(ENamedThreads::AnyBackgroundThreadNormalTask);
+	for (int i = Begin; i < End; ++i)
+		co_await Channel.Send(i);
+}
+
+TCoroutine<int64> Consume(TChannel<int>& Channel)
+{
+	co_await Async::MoveToThread(ENamedThreads::AnyBackgroundThreadNormalTask);
+	int64 Sum = 0;
+	for (;;)
+	{
+		auto Values = co_await Channel.ReceiveUpTo(8);
+		if (Values.Num() == 0)
+			co_return Sum;
+		for (int Value : Values)
+			Sum += Value;
+	}
+}
+}
+
+bool FChannelAsyncTest::RunTest(const FString& Parameters)
+{
+	DoTest<>(*this);
+	return true;
+}
+
+bool FChannelLatentTest::RunTest(const FString& Parameters)
+{
+	DoTest<FLatentActionInfo>(*this);
+	return true;
+}
+
+bool FChannelThreadTest::RunTest(const FString& Parameters)
+{
+	constexpr int NumProducers = 4;
+	constexpr int NumConsumers = 4;
+	constexpr int NumPerProducer = 10000;
+	TChannel<int> Channel(16);
+
+	TArray<TCoroutine<>> Producers;
+	for (int i = 0; i < NumProducers; ++i)
+		Producers.Add(Produce(Channel, i * NumPerProducer,
+		                      (i + 1) * NumPerProducer));
+	TArray<TCoroutine<int64>> Consumers;
+	for (int i = 0; i < NumConsumers; ++i)
+		Consumers.Add(Consume(Channel));
+
+	for (auto& Producer : Producers)
+		TestTrue(TEXT("Producer done"), Producer.Wait());
+	Channel.Close();
+
+	int64 Sum = 0;
+	for (auto& Consumer : Consumers)
+	{
+		TestTrue(TEXT("Consumer done"), Consumer.Wait());
+		Sum += Consumer.GetResult();
+	}
+	constexpr int64 Total = NumProducers * NumPerProducer;
+	TestEqual(TEXT("Every value received once"), Sum, Total * (Total - 1) / 2);
+	return true;
+}
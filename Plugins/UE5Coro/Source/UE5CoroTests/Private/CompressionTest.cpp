@@ -0,0 +1,117 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "TestWorld.h"
+#include "Misc/AutomationTest.h"
+#include "UE5Coro/CompressionAwaiters.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Private::Test;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCompressionAsyncTest,
+                                 "UE5Coro.Compression.Async",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCompressionLatentTest,
+                                 "UE5Coro.Compression.Latent",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+namespace
+{
+template<typename... T>
+void DoTest(FAutomationTestBase& Test)
+{
+	FTestWorld World;
+	constexpr int NumChunks = 16;
+	constexpr int ChunkSize = 4096;
+
+	TArray<uint8> Original;
+	for (int i = 0; i < NumChunks * ChunkSize; ++i)
+		Original.Add(static_cast<uint8>(i / 64));
+
+	std::atomic<bool> bDone = false;
+	World.Run(CORO
+	{
+		int32 Bound = FCompression::CompressMemoryBound(NAME_Zlib, ChunkSize);
+		TArray<uint8> Compressed;
+		Compressed.SetNumZeroed(NumChunks * Bound);
+		TArray<Async::FCompressionChunk> Chunks;
+		for (int i = 0; i < NumChunks; ++i)
+			Chunks.Add({{&Original[i * ChunkSize], ChunkSize},
+			            {&Compressed[i * Bound], Bound}});
+		Test.TestTrue(TEXT("Compressed"),
+		              co_await Async::CompressChunks(NAME_Zlib, Chunks));
+		for (auto& Chunk : Chunks)
+		{
+			Test.TestTrue(TEXT("Chunk compressed"), Chunk.bSucceeded);
+			Test.TestTrue(TEXT("Chunk size"), Chunk.OutputSize > 0 &&
+			                                  Chunk.OutputSize <= Bound);
+		}
+
+		TArray<uint8> Decompressed;
+		Decompressed.SetNumZeroed(NumChunks * ChunkSize);
+		for (int i = 0; i < NumChunks; ++i)
+			Chunks[i] = {{&Compressed[i * Bound], Chunks[i].OutputSize},
+			             {&Decompressed[i * ChunkSize], ChunkSize}};
+		Test.TestTrue(TEXT("Decompressed"),
+		              co_await Async::DecompressChunks(NAME_Zlib, Chunks));
+		Test.TestTrue(TEXT("Round trip"), Decompressed == Original);
+
+		// Garbage fails, but only the chunk that was garbage
+		Chunks[3].Input = {Original.GetData(), 16};
+		Test.TestFalse(TEXT("Corrupt"),
+		               co_await Async::DecompressChunks(NAME_Zlib, Chunks));
+		Test.TestFalse(TEXT("Corrupt chunk"), Chunks[3].bSucceeded);
+		Test.TestTrue(TEXT("Other chunk"), Chunks[4].bSucceeded);
+
+		Test.TestTrue(TEXT("Nothing to do"),
+		              co_await Async::DecompressChunks(NAME_Zlib, {}));
+		bDone = true;
+	});
+	FTestHelper::PumpGameThread(World, [&] { return bDone.load(); });
+}
+}
+
+bool FCompressionAsyncTest::RunTest(const FString& Parameters)
+{
+	DoTest<>(*this);
+	return true;
+}
+
+bool FCompressionLatentTest::RunTest(const FString& Parameters)
+{
+	DoTest<FLatentActionInfo>(*this);
+	return true;
+}
@@ -0,0 +1,143 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "TestWorld.h"
+#include "Misc/AutomationTest.h"
+#include "UE5Coro/CoroutineAwaiters.h"
+#include "UE5Coro/Threading.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Private;
+using namespace UE5Coro::Private::Test;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FContinuationTest, "UE5Coro.Continuation",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FContinuationBenchmark,
+                                 "UE5Coro.Continuation.Benchmark",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::MediumPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+namespace
+{
+TCoroutine<int> Inner(FAwaitableEvent& Event, int Value)
+{
+	co_await Event;
+	co_return Value;
+}
+
+TCoroutine<int> Outer(FAwaitableEvent& Event, int Count)
+{
+	int Sum = 0;
+	for (int i = 0; i < Count; ++i)
+		Sum += co_await Inner(Event, i);
+	co_return Sum;
+}
+}
+
+bool FContinuationTest::RunTest(const FString& Parameters)
+{
+	{
+		int State = 0;
+		auto Ptr = std::make_shared<int>(1);
+		FContinuation Fn = [&State, Ptr](void*) { State += *Ptr; };
+		TestTrue(TEXT("Small functor inline"), Fn.IsStoredInline());
+		FContinuation Moved = std::move(Fn);
+		TestFalse(TEXT("Moved from"), static_cast<bool>(Fn));
+		Moved(nullptr);
+		TestEqual(TEXT("Called"), State, 1);
+		Moved.Reset();
+		TestEqual(TEXT("Capture released"), Ptr.use_count(), 1L);
+	}
+
+	{
+		int State = 0;
+		char Big[128] = {1};
+		FContinuation Fn = [&State, Big](void*) { State += Big[0]; };
+		TestFalse(TEXT("Large functor on the heap"), Fn.IsStoredInline());
+		FContinuation Moved = std::move(Fn);
+		Moved(nullptr);
+		TestEqual(TEXT("Called"), State, 1);
+	}
+
+	{
+		// Move-only captures are supported
+		auto Ptr = MakeUnique<int>(2);
+		int State = 0;
+		FContinuation Fn = [&State, Ptr = std::move(Ptr)](void*)
+		{
+			State = *Ptr;
+		};
+		Fn(nullptr);
+		TestEqual(TEXT("Move-only capture"), State, 2);
+	}
+
+	{
+		int Value = 0;
+		FContinuation Fn = [&Value](void* Ptr)
+		{
+			Value = *static_cast<int*>(Ptr);
+		};
+		int Result = 3;
+		Fn(&Result);
+		TestEqual(TEXT("Argument passed"), Value, 3);
+	}
+	return true;
+}
+
+bool FContinuationBenchmark::RunTest(const FString& Parameters)
+{
+	constexpr int Count = 10000;
+	FAwaitableEvent Event;
+	auto Coro = Outer(Event, Count);
+
+	// Every Trigger completes an Inner, which resumes Outer as a continuation
+	auto Before = FFrameAllocator::GetStats();
+	auto Start = FPlatformTime::Seconds();
+	for (int i = 0; i < Count; ++i)
+		Event.Trigger();
+	auto End = FPlatformTime::Seconds();
+	auto After = FFrameAllocator::GetStats();
+
+	TestTrue(TEXT("Done"), Coro.IsDone());
+	TestEqual(TEXT("Result"), Coro.GetResult(), Count * (Count - 1) / 2);
+#if UE5CORO_FRAME_POOL
+	// One frame (with co-allocated extras) per co_await, nothing else
+	TestTrue(TEXT("Frame allocations per co_await"),
+	         After.Allocations - Before.Allocations <= Count);
+#endif
+	AddInfo(FString::Printf(TEXT("co_await TCoroutine: %.1f ns/op"),
+	                        (End - Start) * 1e9 / Count));
+	return true;
+}
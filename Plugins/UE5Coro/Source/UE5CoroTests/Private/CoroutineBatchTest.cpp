@@ -0,0 +1,147 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "TestWorld.h"
+#include "Misc/AutomationTest.h"
+#include "UE5Coro/CoroutineBatch.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Private;
+using namespace UE5Coro::Private::Test;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCoroutineBatchTest, "UE5Coro.CoroutineBatch",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+namespace
+{
+TCoroutine<> WaitFrames(FCoroutineBatch& Batch, int32 Num, int& State)
+{
+	co_await Batch.Frames(Num);
+	++State;
+	co_await Batch.Frames(Num);
+	++State;
+}
+}
+
+bool FCoroutineBatchTest::RunTest(const FString& Parameters)
+{
+	{
+		FCoroutineBatch Batch;
+		int State1 = 0;
+		int State2 = 0;
+		TArray<TCoroutine<>> Coros;
+		for (int i = 0; i < 1000; ++i)
+			Coros.Add(WaitFrames(Batch, 1 + (i & 1), i & 1 ? State2 : State1));
+		TestEqual(TEXT("Waiting"), Batch.GetNumWaiting(), 1000);
+		Batch.Tick(0);
+		TestEqual(TEXT("1 frame"), State1, 500);
+		TestEqual(TEXT("2 frames not yet"), State2, 0);
+		Batch.Tick(0);
+		TestEqual(TEXT("1+1 frames"), State1, 1000);
+		TestEqual(TEXT("2 frames"), State2, 500);
+		Batch.Tick(0);
+		Batch.Tick(0);
+		TestEqual(TEXT("2+2 frames"), State2, 1000);
+		TestEqual(TEXT("Done"), Batch.GetNumWaiting(), 0);
+		TestEqual(TEXT("Frame counter"), Batch.GetFrameCounter(),
+		          static_cast<int64>(4));
+		for (auto& Coro : Coros)
+			TestTrue(TEXT("Successful"), Coro.WasSuccessful());
+	}
+
+	{
+		FCoroutineBatch Batch;
+		int State = 0;
+		auto Coro = [&]() -> TCoroutine<>
+		{
+			co_await Batch.Seconds(1);
+			State = 1;
+			co_await Batch.Seconds(0);
+			State = 2;
+		}();
+		Batch.Tick(0.5);
+		TestEqual(TEXT("Not yet"), State, 0);
+		Batch.Tick(0.5);
+		TestEqual(TEXT("1 second"), State, 1);
+		Batch.Tick(0);
+		TestEqual(TEXT("0 seconds"), State, 2);
+		TestEqual(TEXT("Time"), Batch.GetTime(), 1.0);
+		TestTrue(TEXT("Done"), Coro.IsDone());
+	}
+
+	{
+		FCoroutineBatch Batch;
+		bool bFlag = false;
+		bool bDone = false;
+		auto Coro = [&]() -> TCoroutine<>
+		{
+			co_await Batch.Until([&] { return bFlag; });
+			bDone = true;
+		}();
+		Batch.Tick(0);
+		TestFalse(TEXT("Predicate false"), bDone);
+		bFlag = true;
+		TestFalse(TEXT("Only checked by Tick"), bDone);
+		Batch.Tick(0);
+		TestTrue(TEXT("Predicate true"), bDone);
+	}
+
+	{
+		FCoroutineBatch Batch;
+		auto Coro = [&]() -> TCoroutine<>
+		{
+			co_await Batch.Frames(100);
+		}();
+		Coro.Cancel();
+		TestFalse(TEXT("Cancellation waits for Tick"), Coro.IsDone());
+		Batch.Tick(0);
+		TestTrue(TEXT("Canceled"), Coro.IsDone());
+		TestFalse(TEXT("Unsuccessful"), Coro.WasSuccessful());
+		TestEqual(TEXT("Removed"), Batch.GetNumWaiting(), 0);
+	}
+
+	{
+		TOptional<TCoroutine<>> Coro;
+		{
+			FCoroutineBatch Batch;
+			Coro = [&]() -> TCoroutine<>
+			{
+				co_await Batch.Seconds(100);
+			}();
+		}
+		TestTrue(TEXT("Canceled by the batch's destruction"), Coro->IsDone());
+		TestFalse(TEXT("Unsuccessful"), Coro->WasSuccessful());
+	}
+	return true;
+}
@@ -32,10 +32,13 @@
 #include <map>
 #include <unordered_map>
 #include "TestWorld.h"
+#include "HAL/IConsoleManager.h"
 #include "Misc/AutomationTest.h"
 #include "UE5CoroTestObject.h"
 #include "UE5Coro/Coroutine.h"
 #include "UE5Coro/AsyncAwaiters.h"
+#include "UE5Coro/CoroutineAwaiters.h"
+#include "UE5Coro/Threading.h"
 
 using namespace UE5Coro;
 using namespace UE5Coro::Private;
@@ -51,8 +54,43 @@ IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHandleTestLatent, "UE5Coro.Handle.Latent",
                                  EAutomationTestFlags::HighPriority |
                                  EAutomationTestFlags::ProductFilter)
 
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHandleLogicalStackTest,
+                                 "UE5Coro.Handle.LogicalStack",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FHandleDeepChainBenchmark,
+                                 "UE5Coro.Handle.DeepChain",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::MediumPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
 namespace
 {
+TCoroutine<int> Leaf(FAwaitableEvent& Event)
+{
+	co_await Event;
+	co_return 0;
+}
+
+struct FCapturingOutputDevice : FOutputDevice
+{
+	FString Text;
+
+	virtual void Serialize(const TCHAR* Value, ELogVerbosity::Type,
+	                       const FName&) override
+	{
+		Text += Value;
+		Text += TEXT('\n');
+	}
+};
+
+TCoroutine<int> Link(TCoroutine<int> Inner)
+{
+	co_return 1 + co_await Inner;
+}
+
 template<typename U>
 using TThreadSafeSharedPtr = TSharedPtr<U, ESPMode::ThreadSafe>;
 
@@ -303,6 +341,50 @@ void DoTest(FAutomationTestBase& Test)
 bool FHandleTestAsync::RunTest(const FString& Parameters)
 {
 	DoTest<>(*this);
+
+	{
+		// Plain Wait would deadlock here without pumping the game thread
+		auto Coro = []() -> TCoroutine<>
+		{
+			co_await Async::MoveToNewThread();
+			co_await Async::MoveToGameThread();
+		}();
+		Coro.WaitAndHelp();
+		TestTrue(TEXT("Helped to completion"), Coro.IsDone());
+		Coro.WaitAndHelp();
+		TestTrue(TEXT("Already done"), Coro.WasSuccessful());
+	}
+
+	{
+		FTestWorld World;
+		FAwaitableEvent Event;
+		auto Coro = [](FAwaitableEvent& Event) -> TCoroutine<int>
+		{
+			co_await Async::MoveToNewThread();
+			co_await Event;
+			co_return 1;
+		}(Event);
+		std::atomic<int> State = 0;
+		for (int i = 0; i < 10; ++i)
+			Coro.ContinueWithOn(ENamedThreads::GameThread, [&](int Value)
+			{
+				TestTrue(TEXT("On the game thread"), IsInGameThread());
+				State += Value;
+			});
+		Coro.ContinueWithOn(ENamedThreads::AnyBackgroundThreadNormalTask, [&]
+		{
+			TestFalse(TEXT("Not on the game thread"), IsInGameThread());
+			++State;
+		});
+		Event.Trigger();
+		FTestHelper::PumpGameThread(World, [&] { return State == 11; });
+		TestTrue(TEXT("Done"), Coro.IsDone());
+
+		// Queued even when the coroutine has already completed
+		Coro.ContinueWithOn(ENamedThreads::GameThread, [&] { ++State; });
+		TestEqual(TEXT("Not called inline"), State.load(), 11);
+		FTestHelper::PumpGameThread(World, [&] { return State == 12; });
+	}
 	return true;
 }
 
@@ -311,3 +393,75 @@ bool FHandleTestLatent::RunTest(const FString& Parameters)
 	DoTest<FLatentActionInfo>(*this);
 	return true;
 }
+
+bool FHandleLogicalStackTest::RunTest(const FString& Parameters)
+{
+	auto* Census = IConsoleManager::Get().FindConsoleVariable(
+		TEXT("UE5Coro.Census"));
+	if (!TestNotNull(TEXT("Census cvar"), Census))
+		return false;
+	bool bWasEnabled = Census->GetBool();
+	Census->Set(true);
+
+	FAwaitableEvent Event;
+	auto Inner = [](FAwaitableEvent& Event) -> TCoroutine<>
+	{
+		TCoroutine<>::SetDebugName(TEXT("LogicalStackInner"));
+		co_await Event;
+	};
+	auto Outer = [&]() -> TCoroutine<>
+	{
+		TCoroutine<>::SetDebugName(TEXT("LogicalStackOuter"));
+		co_await Inner(Event);
+	}();
+	Census->Set(bWasEnabled);
+
+	FCapturingOutputDevice Output;
+	IConsoleManager::Get().ProcessUserConsoleInput(TEXT("UE5Coro.DumpStacks"),
+	                                               Output, nullptr);
+#if UE5CORO_DEBUG
+	int32 InnerPos = Output.Text.Find(TEXT("LogicalStackInner"));
+	int32 OuterPos = Output.Text.Find(TEXT("LogicalStackOuter"));
+	TestTrue(TEXT("Inner listed"), InnerPos != INDEX_NONE);
+	TestTrue(TEXT("Outer listed after inner"), OuterPos > InnerPos);
+	// Outer is awaiting Inner, so it's not on a stack of its own
+	TestEqual(TEXT("Outer listed once"),
+	          Output.Text.Find(TEXT("LogicalStackOuter"),
+	                           ESearchCase::CaseSensitive, ESearchDir::FromEnd),
+	          OuterPos);
+#endif
+
+	Event.Trigger();
+	TestTrue(TEXT("Done"), Outer.IsDone());
+
+	Output.Text.Reset();
+	IConsoleManager::Get().ProcessUserConsoleInput(TEXT("UE5Coro.DumpStacks"),
+	                                               Output, nullptr);
+	TestFalse(TEXT("Gone after completion"),
+	          Output.Text.Contains(TEXT("LogicalStackOuter")));
+	return true;
+}
+
+bool FHandleDeepChainBenchmark::RunTest(const FString& Parameters)
+{
+	constexpr int Depth = 10000;
+	FAwaitableEvent Event;
+
+	// Built bottom-up, so that creating the chain doesn't recurse
+	auto Coro = Leaf(Event);
+	for (int i = 0; i < Depth; ++i)
+		Coro = Link(Coro);
+	TestFalse(TEXT("Waiting"), Coro.IsDone());
+
+	// Every level completes into the next one, this would overflow the stack
+	// without symmetric transfer
+	auto Start = FPlatformTime::Seconds();
+	Event.Trigger();
+	auto End = FPlatformTime::Seconds();
+
+	TestTrue(TEXT("Done"), Coro.IsDone());
+	TestEqual(TEXT("Result"), Coro.GetResult(), Depth);
+	AddInfo(FString::Printf(TEXT("Completing a %d deep chain: %.1f ns/level"),
+	                        Depth, (End - Start) * 1e9 / Depth));
+	return true;
+}
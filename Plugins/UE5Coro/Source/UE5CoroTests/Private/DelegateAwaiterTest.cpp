@@ -29,11 +29,14 @@
 // OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
 // ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
+#include "Async/Async.h"
+#include "HAL/IConsoleManager.h"
 #include "Misc/AutomationTest.h"
 #include "TestDelegates.h"
 #include "TestWorld.h"
 #include "UE5CoroTestObject.h"
 #include "UE5Coro/AsyncAwaiters.h"
+#include "UE5Coro/DelegateSubscription.h"
 #include "UE5Coro/LatentAwaiters.h"
 
 using namespace UE5Coro;
@@ -55,8 +58,66 @@ IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDelegateTestLatent, "UE5Coro.Delegate.Latent",
                                  EAutomationTestFlags::HighPriority |
                                  EAutomationTestFlags::ProductFilter)
 
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDelegateSubscriptionTest,
+                                 "UE5Coro.Delegate.Subscription",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FDelegateBenchmark,
+                                 "UE5Coro.Delegate.Benchmark",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::MediumPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
 namespace
 {
+struct FWidePayload
+{
+	int Values[64];
+};
+
+TCoroutine<int> AwaitNarrow(TMulticastDelegate<void(int)>& Delegate,
+                            int Count)
+{
+	int Sum = 0;
+	for (int i = 0; i < Count; ++i)
+	{
+		auto [Value] = co_await Delegate;
+		Sum += Value;
+	}
+	co_return Sum;
+}
+
+template<bool bView>
+TCoroutine<int> AwaitWide(TMulticastDelegate<void(FWidePayload)>& Delegate,
+                          int Count)
+{
+	int Sum = 0;
+	for (int i = 0; i < Count; ++i)
+	{
+		if constexpr (bView)
+		{
+			auto&& [Payload] = co_await Async::ViewPayload(Delegate);
+			static_assert(std::is_same_v<decltype(Payload), FWidePayload>);
+			Sum += Payload.Values[0] + Payload.Values[63];
+		}
+		else
+		{
+			auto [Payload] = co_await Delegate;
+			Sum += Payload.Values[0] + Payload.Values[63];
+		}
+	}
+	co_return Sum;
+}
+
+TCoroutine<> AwaitDynamic(FUE5CoroTestDynamicMulticastVoidDelegate& Delegate,
+                          int Count)
+{
+	for (int i = 0; i < Count; ++i)
+		co_await Delegate;
+}
+
 template<bool bDynamic, bool bMulticast>
 struct TSelect;
 
@@ -272,6 +333,14 @@ void DoTest(FAutomationTestBase& Test)
 	}
 }
 
+IConsoleVariable* PoolCVar()
+{
+	auto* CVar = IConsoleManager::Get().FindConsoleVariable(
+		TEXT("UE5Coro.PoolDelegateCallbackTargets"));
+	check(CVar);
+	return CVar;
+}
+
 template<int N, typename... T>
 void DoTests(FAutomationTestBase& Test)
 {
@@ -331,12 +400,156 @@ bool FDelegateTestCore::RunTest(const FString& Parameters)
 
 bool FDelegateTestAsync::RunTest(const FString& Parameters)
 {
-	DoTests<0>(*this);
+	auto* CVar = PoolCVar();
+	bool bOld = CVar->GetBool();
+	ON_SCOPE_EXIT { CVar->Set(bOld); };
+	for (bool bPooled : {false, true})
+	{
+		CVar->Set(bPooled);
+		DoTests<0>(*this);
+	}
+
+	{
+		// Execution on another thread is forwarded to the game thread
+		FTestWorld World;
+		bool bDone = false;
+		TMulticastDelegate<void()> Delegate;
+		World.Run(CORO
+		{
+			co_await Latent::UntilDelegate(Delegate);
+			bDone = IsInGameThread();
+		});
+		World.EndTick();
+		TestFalse(TEXT("Not done yet"), bDone);
+		AsyncTask(ENamedThreads::AnyBackgroundThreadNormalTask,
+		          [&] { Delegate.Broadcast(); });
+		FTestHelper::PumpGameThread(World, [&] { return bDone; });
+		TestTrue(TEXT("Done on the game thread"), bDone);
+	}
 	return true;
 }
 
 bool FDelegateTestLatent::RunTest(const FString& Parameters)
 {
-	DoTests<0, FLatentActionInfo>(*this);
+	auto* CVar = PoolCVar();
+	bool bOld = CVar->GetBool();
+	ON_SCOPE_EXIT { CVar->Set(bOld); };
+	for (bool bPooled : {false, true})
+	{
+		CVar->Set(bPooled);
+		DoTests<0, FLatentActionInfo>(*this);
+	}
+	return true;
+}
+
+bool FDelegateBenchmark::RunTest(const FString& Parameters)
+{
+	constexpr int Count = 10000;
+
+	{
+		TMulticastDelegate<void(int)> Delegate;
+		auto Coro = AwaitNarrow(Delegate, Count);
+		auto Start = FPlatformTime::Seconds();
+		for (int i = 0; i < Count; ++i)
+			Delegate.Broadcast(i);
+		auto End = FPlatformTime::Seconds();
+		TestTrue(TEXT("Done"), Coro.IsDone());
+		TestEqual(TEXT("Result"), Coro.GetResult(), Count * (Count - 1) / 2);
+		TestFalse(TEXT("Unbound"), Delegate.IsBound());
+		AddInfo(FString::Printf(TEXT("co_await int delegate: %.1f ns/op"),
+		                        (End - Start) * 1e9 / Count));
+	}
+
+	for (bool bView : {false, true})
+	{
+		TMulticastDelegate<void(FWidePayload)> Delegate;
+		FWidePayload Payload{};
+		auto Coro = bView ? AwaitWide<true>(Delegate, Count)
+		                  : AwaitWide<false>(Delegate, Count);
+		auto Start = FPlatformTime::Seconds();
+		for (int i = 0; i < Count; ++i)
+		{
+			Payload.Values[0] = i;
+			Payload.Values[63] = 1;
+			Delegate.Broadcast(Payload);
+		}
+		auto End = FPlatformTime::Seconds();
+		TestTrue(TEXT("Done"), Coro.IsDone());
+		TestEqual(TEXT("Result"), Coro.GetResult(),
+		          Count * (Count - 1) / 2 + Count);
+		AddInfo(FString::Printf(TEXT("co_await wide delegate%s: %.1f ns/op"),
+		                        bView ? TEXT(" view") : TEXT(""),
+		                        (End - Start) * 1e9 / Count));
+	}
+
+	auto* CVar = PoolCVar();
+	bool bOld = CVar->GetBool();
+	ON_SCOPE_EXIT { CVar->Set(bOld); };
+	for (bool bPooled : {false, true})
+	{
+		CVar->Set(bPooled);
+		FUE5CoroTestDynamicMulticastVoidDelegate Delegate;
+		auto Coro = AwaitDynamic(Delegate, Count);
+		auto Start = FPlatformTime::Seconds();
+		for (int i = 0; i < Count; ++i)
+			Delegate.Broadcast();
+		auto End = FPlatformTime::Seconds();
+		TestTrue(TEXT("Done"), Coro.IsDone());
+		if (bPooled) // Pooled targets unbind themselves
+			TestFalse(TEXT("Unbound"), Delegate.IsBound());
+		AddInfo(FString::Printf(
+			TEXT("co_await dynamic delegate, %s: %.1f ns/op"),
+			bPooled ? TEXT("pooled") : TEXT("new UObjects"),
+			(End - Start) * 1e9 / Count));
+	}
+	return true;
+}
+
+bool FDelegateSubscriptionTest::RunTest(const FString& Parameters)
+{
+	{
+		TMulticastDelegate<void(int, const FString&)> Delegate;
+		TArray<int> Values;
+		auto Subscription = Subscribe(Delegate);
+		TestTrue(TEXT("Bound"), Delegate.IsBound());
+		auto Coro = [&]() -> TCoroutine<>
+		{
+			while (auto Payload = co_await Subscription.Next())
+			{
+				auto& [Value, String] = *Payload;
+				Values.Add(Value);
+				TestEqual(TEXT("Payload copied"), String, FString(TEXT("A")));
+				// Broadcasts while this is not waiting are buffered
+				if (Value == 1)
+				{
+					Delegate.Broadcast(2, TEXT("A"));
+					Delegate.Broadcast(3, TEXT("A"));
+				}
+			}
+		}();
+		Delegate.Broadcast(1, TEXT("A"));
+		TestTrue(TEXT("Nothing missed"), Values == TArray{1, 2, 3});
+		TestFalse(TEXT("Still running"), Coro.IsDone());
+		Delegate.Broadcast(4, TEXT("A"));
+		Subscription.Unsubscribe();
+		TestFalse(TEXT("Unbound"), Delegate.IsBound());
+		TestTrue(TEXT("Done"), Coro.IsDone());
+		TestTrue(TEXT("All received"), Values == TArray{1, 2, 3, 4});
+	}
+
+	{
+		TMulticastDelegate<void(int)> Delegate;
+		auto Oldest = Subscribe(Delegate, 2);
+		auto Newest = Subscribe(Delegate, 2, ESubscriptionOverflow::DropNewest);
+		for (int i = 0; i < 5; ++i)
+			Delegate.Broadcast(i);
+		TestEqual(TEXT("Dropped oldest"), Oldest.GetNumDropped(), 3);
+		TestEqual(TEXT("Dropped newest"), Newest.GetNumDropped(), 3);
+		TestEqual(TEXT("Oldest 1"), Oldest.TryNext()->Get<0>(), 3);
+		TestEqual(TEXT("Oldest 2"), Oldest.TryNext()->Get<0>(), 4);
+		TestEqual(TEXT("Newest 1"), Newest.TryNext()->Get<0>(), 0);
+		TestEqual(TEXT("Newest 2"), Newest.TryNext()->Get<0>(), 1);
+		TestFalse(TEXT("Empty"), Oldest.TryNext().IsSet());
+	}
 	return true;
 }
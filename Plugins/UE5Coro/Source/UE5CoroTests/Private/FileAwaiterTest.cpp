@@ -0,0 +1,170 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "TestWorld.h"
+#include "HAL/FileManager.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "UE5Coro/FileAwaiters.h"
+#include "UE5Coro/LatentAwaiters.h"
+#include "UE5Coro/TaskAwaiters.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Private::Test;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFileAsyncTest, "UE5Coro.File.Async",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFileLatentTest, "UE5Coro.File.Latent",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+namespace
+{
+template<typename... T>
+void DoTest(FAutomationTestBase& Test)
+{
+	FTestWorld World;
+
+	TArray<uint8> Contents;
+	for (int i = 0; i < 10000; ++i)
+		Contents.Add(static_cast<uint8>(i * 7));
+	FString Path = FPaths::CreateTempFilename(*FPaths::ProjectSavedDir(),
+	                                          TEXT("UE5Coro"));
+	Test.TestTrue(TEXT("Saved"), FFileHelper::SaveArrayToFile(Contents, *Path));
+
+	std::atomic<bool> bDone = false;
+	World.Run(CORO
+	{
+		auto All = co_await Async::ReadFileAsync(Path);
+		Test.TestTrue(TEXT("Read"), All.IsSet());
+		Test.TestTrue(TEXT("Contents"),
+		              All && *All == TArray64<uint8>(Contents));
+
+		auto Part = co_await Async::ReadFileAsync(Path, 9990, 100);
+		Test.TestTrue(TEXT("Clamped read"), Part && Part->Num() == 10);
+		Test.TestTrue(TEXT("Clamped contents"),
+		              Part && FMemory::Memcmp(Part->GetData(),
+		                                      &Contents[9990], 10) == 0);
+
+		auto Past = co_await Async::ReadFileAsync(Path, 20000);
+		Test.TestTrue(TEXT("Past the end"), Past && Past->IsEmpty());
+
+		auto Missing = co_await Async::ReadFileAsync(Path + TEXT(".missing"));
+		Test.TestFalse(TEXT("Missing file"), Missing.IsSet());
+		bDone = true;
+	});
+	FTestHelper::PumpGameThread(World, [&] { return bDone.load(); });
+
+	bDone = false;
+	World.Run(CORO
+	{
+		co_await Tasks::MoveToTask();
+		auto Data = co_await Async::ReadFileAsync(Path, 1, 1);
+		Test.TestFalse(TEXT("Not in game thread"), IsInGameThread());
+		Test.TestTrue(TEXT("Single byte"), Data && (*Data)[0] == Contents[1]);
+		bDone = true;
+	});
+	FTestHelper::PumpGameThread(World, [&] { return bDone.load(); });
+
+	bDone = false;
+	World.Run(CORO
+	{
+		auto Chunks = Async::ReadFileChunks(Path, 3000, 2);
+		TArray64<uint8> Joined;
+		int Count = 0;
+		while (auto Chunk = co_await Chunks.Next())
+		{
+			Joined.Append(*Chunk);
+			++Count;
+		}
+		Test.TestEqual(TEXT("Chunks"), Count, 4);
+		Test.TestTrue(TEXT("Joined"), Joined == TArray64<uint8>(Contents));
+		bDone = true;
+	});
+	FTestHelper::PumpGameThread(World, [&] { return bDone.load(); });
+
+	bDone = false;
+	World.Run(CORO
+	{
+		auto Mapping = co_await Async::MapFileAsync(Path);
+		// Not every platform supports memory mapping
+		if (Mapping.IsValid())
+		{
+			auto View = Mapping.GetView();
+			Test.TestEqual(TEXT("Mapped size"), View.Num(), 10000LL);
+			Test.TestTrue(TEXT("Mapped contents"),
+			              FMemory::Memcmp(View.GetData(), Contents.GetData(),
+			                              10000) == 0);
+
+			auto Part = co_await Async::MapFileAsync(Path, 5000, 100, false);
+			Test.TestEqual(TEXT("Partial size"), Part.GetView().Num(), 100LL);
+			Test.TestEqual(TEXT("Partial contents"), Part.GetView()[0],
+			               Contents[5000]);
+			Mapping = std::move(Part);
+			Test.TestFalse(TEXT("Moved from"), Part.IsValid());
+			Mapping.Reset();
+			Test.TestTrue(TEXT("Released"), Mapping.GetView().IsEmpty());
+		}
+
+		auto Missing = co_await Async::MapFileAsync(Path + TEXT(".missing"));
+		Test.TestFalse(TEXT("Missing file"), Missing.IsValid());
+		bDone = true;
+	});
+	FTestHelper::PumpGameThread(World, [&] { return bDone.load(); });
+
+	World.Run(CORO
+	{
+		// Destroying the awaiter cancels the read
+		[[maybe_unused]] auto Unused = Async::ReadFileAsync(Path);
+		co_await Latent::NextTick();
+	});
+	World.Tick();
+
+	IFileManager::Get().Delete(*Path);
+}
+}
+
+bool FFileAsyncTest::RunTest(const FString& Parameters)
+{
+	DoTest<>(*this);
+	return true;
+}
+
+bool FFileLatentTest::RunTest(const FString& Parameters)
+{
+	DoTest<FLatentActionInfo>(*this);
+	return true;
+}
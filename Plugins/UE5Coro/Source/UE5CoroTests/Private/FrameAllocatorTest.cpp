@@ -0,0 +1,166 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "TestWorld.h"
+#include "Misc/AutomationTest.h"
+#include "UE5Coro/AsyncAwaiters.h"
+#include "UE5Coro/CoroutineArena.h"
+#include "UE5Coro/Threading.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Private;
+using namespace UE5Coro::Private::Test;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FFrameAllocatorTest, "UE5Coro.FrameAllocator",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FCoroutineArenaTest,
+                                 "UE5Coro.FrameAllocator.Arena",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+namespace
+{
+TCoroutine<int> Identity(int Value)
+{
+	co_return Value;
+}
+
+TCoroutine<> MoveAway(FAwaitableEvent& Event)
+{
+	co_await Async::MoveToThread(ENamedThreads::AnyBackgroundThreadNormalTask);
+	co_await Event;
+}
+}
+
+bool FFrameAllocatorTest::RunTest(const FString& Parameters)
+{
+#if UE5CORO_FRAME_POOL
+	// Warm up this thread's cache
+	for (int i = 0; i < 16; ++i)
+		Identity(i);
+
+	{
+		auto Before = FFrameAllocator::GetStats();
+		int Sum = 0;
+		for (int i = 0; i < 1000; ++i)
+			Sum += Identity(i).GetResult();
+		auto After = FFrameAllocator::GetStats();
+		TestEqual(TEXT("Results"), Sum, 999 * 1000 / 2);
+		TestTrue(TEXT("Allocations counted"),
+		         After.Allocations - Before.Allocations >= 1000);
+		// Every frame in the loop above is freed before the next is allocated
+		TestTrue(TEXT("Frames recycled"),
+		         After.PoolHits - Before.PoolHits >= 1000);
+		TestTrue(TEXT("Peak tracked"),
+		         After.PeakBytesReserved >= After.BytesReserved);
+	}
+
+	{
+		FAwaitableEvent Event(EEventMode::ManualReset);
+		TArray<TCoroutine<>> Coros;
+		for (int i = 0; i < 100; ++i)
+			Coros.Add(MoveAway(Event));
+		// Frames allocated on this thread will be freed on the worker threads
+		Event.Trigger();
+		for (auto& Coro : Coros)
+			TestTrue(TEXT("Completed on another thread"), Coro.Wait());
+
+		// The frames themselves are freed slightly after completion
+		FPlatformProcess::Sleep(0.1f);
+
+		// Cross-thread frees are eventually reclaimed by this thread
+		FAwaitableEvent Event2(EEventMode::ManualReset);
+		auto Before = FFrameAllocator::GetStats();
+		Coros.Reset();
+		for (int i = 0; i < 100; ++i)
+			Coros.Add(MoveAway(Event2));
+		auto After = FFrameAllocator::GetStats();
+		TestTrue(TEXT("Remote frames reused"),
+		         After.PoolHits - Before.PoolHits >= 100);
+		Event2.Trigger();
+		for (auto& Coro : Coros)
+			TestTrue(TEXT("Completed again"), Coro.Wait());
+	}
+
+	{
+		// Extras co-allocated with the frame outlive the frame itself
+		TOptional<TCoroutine<int>> Coro = Identity(42);
+		FFrameAllocator::Trim();
+		auto Before = FFrameAllocator::GetStats();
+		TestTrue(TEXT("Done"), Coro->IsDone());
+		TestEqual(TEXT("Result after frame destruction"), Coro->GetResult(), 42);
+		Coro.Reset();
+		FFrameAllocator::Trim();
+		auto After = FFrameAllocator::GetStats();
+		TestTrue(TEXT("Allocation released with the last handle"),
+		         After.BytesReserved < Before.BytesReserved);
+	}
+
+	FFrameAllocator::Trim();
+#endif
+	return true;
+}
+
+bool FCoroutineArenaTest::RunTest(const FString& Parameters)
+{
+	FAwaitableEvent Event;
+	auto Coro = [&]() -> TCoroutine<int>
+	{
+		auto& Arena = FCoroutineArena::Current();
+		void* First = Arena.Allocate(16);
+		void* Grown = Arena.Reallocate(First, 16, 64);
+		TestTrue(TEXT("Last allocation grows in place"), Grown == First);
+		void* Big = Arena.Allocate(100000);
+		TestNotNull(TEXT("Oversized allocation"), Big);
+		FMemory::Memzero(Big, 100000);
+
+		TArray<int, FCoroutineArenaAllocator> Values;
+		for (int i = 0; i < 1000; ++i)
+			Values.Add(i);
+		co_await Event;
+		TArray<int, FCoroutineArenaAllocator> Moved = std::move(Values);
+		for (int i = 1000; i < 2000; ++i)
+			Moved.Add(i);
+		int Sum = 0;
+		for (int i = 0; i < Moved.Num(); ++i)
+			Sum += Moved[i] == i;
+		co_return Sum;
+	}();
+	TestFalse(TEXT("Suspended"), Coro.IsDone());
+	Event.Trigger();
+	TestTrue(TEXT("Done"), Coro.IsDone());
+	TestEqual(TEXT("Values preserved"), Coro.GetResult(), 2000);
+	return true;
+}
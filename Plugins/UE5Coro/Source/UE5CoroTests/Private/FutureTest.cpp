@@ -59,6 +59,19 @@ struct stdcoro::coroutine_traits<void, FAutomationTestBase&>
 
 namespace
 {
+struct FCopyCounter
+{
+	int* Copies;
+	explicit FCopyCounter(int* Copies) : Copies(Copies) { }
+	FCopyCounter(const FCopyCounter& Other) : Copies(Other.Copies)
+	{
+		++*Copies;
+	}
+	FCopyCounter(FCopyCounter&&) = default;
+	FCopyCounter& operator=(const FCopyCounter&) = delete;
+	FCopyCounter& operator=(FCopyCounter&&) = default;
+};
+
 template<typename... T>
 void DoTest(FAutomationTestBase& Test)
 {
@@ -135,6 +148,55 @@ void DoTest(FAutomationTestBase& Test)
 		Test.TestEqual(TEXT("After"), State, 1);
 		Promise1.SetValue(One);
 	}
+
+	{
+		int Copies = 0;
+		for (bool bReady : {true, false})
+		{
+			TPromise<FCopyCounter> Promise;
+			if (bReady)
+				Promise.SetValue(FCopyCounter(&Copies));
+			World.Run(CORO
+			{
+				FCopyCounter Value = co_await Promise.GetFuture();
+			});
+			if (!bReady)
+				Promise.SetValue(FCopyCounter(&Copies));
+		}
+		Test.TestEqual(TEXT("Results moved out of the future"), Copies, 0);
+	}
+
+	{
+		TPromise<int> Promise;
+		Promise.SetValue(1);
+		TSharedFuture<int> Future = Promise.GetFuture().Share();
+		const int* Address = nullptr;
+		World.Run(CORO
+		{
+			const int& Value = co_await Future;
+			Address = &Value;
+		});
+		Test.TestEqual(TEXT("Shared future not copied"), Address,
+		               &Future.Get());
+	}
+
+	IF_NOT_CORO_LATENT
+	{
+		TPromise<int> Promise;
+		TSharedFuture<int> Future = Promise.GetFuture().Share();
+		bool bGameThread = false;
+		auto Coro = World.Run(CORO_R(int)
+		{
+			int Value = co_await Future;
+			bGameThread = IsInGameThread();
+			co_return Value;
+		});
+		Test.TestFalse(TEXT("Waiting"), Coro.IsDone());
+		Promise.SetValue(2);
+		FTestHelper::PumpGameThread(World, [&] { return Coro.IsDone(); });
+		Test.TestEqual(TEXT("Shared value"), Coro.GetResult(), 2);
+		Test.TestTrue(TEXT("Resumed on the original thread"), bGameThread);
+	}
 }
 } // namespace
 
@@ -39,12 +39,61 @@ IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGeneratorTest, "UE5Coro.Generator",
                                  EAutomationTestFlags::CriticalPriority |
                                  EAutomationTestFlags::ProductFilter)
 
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FChunkedGeneratorTest,
+                                 "UE5Coro.Generator.Chunked",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::CriticalPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
 TGenerator<int> CountUp(int Max)
 {
 	for (int i = 0; i <= Max; ++i)
 		co_yield i;
 }
 
+TChunkedGenerator<int, 4> CountUpChunked(int Max, int& Resumes)
+{
+	for (int i = 0; i <= Max; ++i)
+	{
+		if (i % 4 == 0)
+			++Resumes;
+		co_yield i;
+	}
+}
+
+template<typename T>
+struct TCountingAllocator
+{
+	using value_type = T;
+	int* Allocations;
+	int* Frees;
+
+	TCountingAllocator(int& Allocations, int& Frees)
+		: Allocations(&Allocations), Frees(&Frees) { }
+	template<typename U>
+	TCountingAllocator(const TCountingAllocator<U>& Other)
+		: Allocations(Other.Allocations), Frees(Other.Frees) { }
+
+	T* allocate(size_t Num)
+	{
+		++*Allocations;
+		return std::allocator<T>().allocate(Num);
+	}
+
+	void deallocate(T* Ptr, size_t Num)
+	{
+		++*Frees;
+		std::allocator<T>().deallocate(Ptr, Num);
+	}
+};
+
+TGenerator<int> CountUpWith(std::allocator_arg_t,
+                            const TCountingAllocator<int>&, int Max)
+{
+	for (int i = 0; i <= Max; ++i)
+		co_yield i;
+}
+
 bool FGeneratorTest::RunTest(const FString& Parameters)
 {
 	{
@@ -89,5 +138,129 @@ bool FGeneratorTest::RunTest(const FString& Parameters)
 		TestTrue("!i at end", !i);
 	}
 
+	{
+		int Allocations = 0, Frees = 0;
+		int Sum = 0;
+		{
+			TCountingAllocator<int> Allocator(Allocations, Frees);
+			for (int i : CountUpWith(std::allocator_arg, Allocator, 3))
+				Sum += i;
+			// The compiler is allowed to elide the allocation entirely
+			TestTrue("Allocated from the allocator", Allocations <= 1);
+		}
+		TestEqual("Sum", Sum, 6);
+		TestEqual("Freed through the allocator", Frees, Allocations);
+	}
+
+	{
+		int Calls = 0;
+		auto Values = CountUp(9)
+			.Map([&](int i) { ++Calls; return i * i; })
+			.Filter([](int i) { return i % 2 == 0; })
+			.ToArray(5);
+		TestEqual("Map+Filter Num", Values.Num(), 5);
+		for (int i = 0; i < Values.Num(); ++i)
+			TestEqual("Map+Filter", Values[i], 4 * i * i);
+		TestEqual("Map called once per value", Calls, 10);
+	}
+
+	{
+		int Resumes = 0;
+		auto Generator = [&]() -> TGenerator<int>
+		{
+			for (int i = 0;; ++i)
+			{
+				++Resumes;
+				co_yield i;
+			}
+		}();
+		int Sum = 0;
+		for (int i : Generator.Take(3))
+			Sum += i;
+		TestEqual("Take", Sum, 3);
+		TestEqual("Not resumed past Take", Resumes, 3);
+		// Lvalue views leave the generator on the last value that they read
+		TestEqual("Continued after Take", Generator.Take(1).ToArray()[0], 2);
+		TestTrue("Take(0)", Generator.Take(0).ToArray().IsEmpty());
+		TestEqual("Still not resumed", Resumes, 3);
+		TestEqual("Resumed by the next view", Generator.Take(2).ToArray()[1], 3);
+	}
+
+	{
+		TArray<int> Sums;
+		for (TArrayView<int> Chunk : CountUp(6).Chunk(3))
+		{
+			int Sum = 0;
+			for (int i : Chunk)
+				Sum += i;
+			Sums.Add(Sum);
+		}
+		TestEqual("Chunk Num", Sums.Num(), 3);
+		TestEqual("Chunk 0", Sums[0], 3);
+		TestEqual("Chunk 1", Sums[1], 12);
+		TestEqual("Partial chunk", Sums[2], 6);
+	}
+
+	{
+		int Count = 0;
+		auto Negate = [](int i) { return -i; };
+		for (auto [A, B] : CountUp(5).Zip(CountUp(2).Map(Negate)))
+		{
+			TestEqual("Zip", A, -B);
+			++Count;
+		}
+		TestEqual("Zip stops at the shorter one", Count, 3);
+	}
+
+	{
+		TGenerator<int> Empty = CountUp(-1);
+		TestTrue("Empty", Empty.Map([](int i) { return i; }).ToArray()
+		                       .IsEmpty());
+		auto View = CountUp(2).View();
+		TestNotEqual("View begin()", View.begin(), View.end());
+	}
+
+	return true;
+}
+
+bool FChunkedGeneratorTest::RunTest(const FString& Parameters)
+{
+	{
+		int Resumes = 0;
+		auto Generator = CountUpChunked(9, Resumes);
+		TestEqual("Runs until the first chunk is full", Resumes, 1);
+		TestEqual("First chunk", Generator.Current().Num(), 4);
+		TestEqual("First value", Generator.Current()[0], 0);
+		TestTrue("Second chunk", Generator.Resume());
+		TestEqual("Second chunk size", Generator.Current().Num(), 4);
+		TestEqual("Second chunk contents", Generator.Current()[3], 7);
+		TestTrue("Partial chunk at the end", Generator.Resume());
+		TestEqual("Last chunk size", Generator.Current().Num(), 2);
+		TestFalse("Done", Generator.Resume());
+		TestFalse("Invalid", static_cast<bool>(Generator));
+	}
+
+	{
+		int Resumes = 0;
+		auto Generator = CountUpChunked(7, Resumes);
+		TArray<int> Values;
+		for (int i : Generator)
+			Values.Add(i);
+		TestEqual("Flattened values", Values.Num(), 8);
+		for (int i = 0; i < Values.Num(); ++i)
+			TestEqual("Values[i]", Values[i], i);
+		TestEqual("Chunks filled", Resumes, 2);
+		TestEqual("begin()==end() at end", Generator.begin(), Generator.end());
+	}
+
+	{
+		auto Generator = []() -> TChunkedGenerator<int>
+		{
+			co_return;
+		}();
+		TestFalse("Empty generator", static_cast<bool>(Generator));
+		TestEqual("Empty iteration", Generator.begin(), Generator.end());
+	}
+
 	return true;
 }
@@ -30,6 +30,7 @@
 // ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "HttpModule.h"
+#include "TestDelegates.h"
 #include "TestWorld.h"
 #include "Misc/AutomationTest.h"
 #include "UE5Coro/AsyncAwaiters.h"
@@ -111,6 +112,162 @@ void DoTest(FAutomationTestBase& Test)
 	});
 	World.Tick(); // Nothing to test here besides not crashing
 
+	bDone = false;
+	World.Run(CORO
+	{
+		auto Request = FHttpModule::Get().CreateRequest();
+		Request->SetURL(TEXT(".invalid"));
+		Request->SetTimeout(0.01);
+		auto Stream = Http::StreamAsync(Request, 1024);
+		int64 Received = 0;
+		while (auto Chunk = co_await Stream.Next())
+			Received += Chunk->Num();
+		Test.TestFalse(TEXT("Stream success"),
+		               Stream.WasConnectedSuccessfully());
+		Test.TestEqual(TEXT("Stream response"), !!Stream.GetResponse(),
+		               bExpectResponse);
+		// Further co_awaits keep reporting the end of the stream
+		Test.TestFalse(TEXT("Stream ended"),
+		               (co_await Stream.Next()).IsSet());
+		bDone = true;
+	});
+	FTestHelper::PumpGameThread(World, [&] { return bDone.load(); });
+
+	World.Run(CORO
+	{
+		auto Request = FHttpModule::Get().CreateRequest();
+		Request->SetURL(TEXT(".invalid"));
+		Request->SetTimeout(0.01);
+		// Destroying the stream cancels the request
+		[[maybe_unused]] auto Unused = Http::StreamAsync(Request);
+		co_await Latent::NextTick();
+	});
+	World.Tick();
+
+	bDone = false;
+	World.Run(CORO
+	{
+		auto MakeRequest = []
+		{
+			auto Request = FHttpModule::Get().CreateRequest();
+			Request->SetURL(TEXT(".invalid"));
+			Request->SetTimeout(0.01);
+			return Request;
+		};
+		Http::FRequestQueue Queue(1);
+		auto First = Queue.Process(MakeRequest());
+		auto Second = Queue.Process(MakeRequest(), EQueuedWorkPriority::High);
+		Test.TestTrue(TEXT("Limited"), Queue.NumInFlight() <= 1);
+		Test.TestEqual(TEXT("Total"),
+		               Queue.NumInFlight() + Queue.NumQueued(), 2);
+		auto [Response1, bSuccess1] = co_await First;
+		auto [Response2, bSuccess2] = co_await Second;
+		Test.TestFalse(TEXT("Queued success 1"), bSuccess1);
+		Test.TestFalse(TEXT("Queued success 2"), bSuccess2);
+
+		auto Results = co_await Queue.ProcessAll({MakeRequest(),
+		                                          MakeRequest(),
+		                                          MakeRequest()});
+		Test.TestEqual(TEXT("All results"), Results.Num(), 3);
+		for (auto& [Response, bSuccess] : Results)
+			Test.TestFalse(TEXT("Batched success"), bSuccess);
+		Test.TestEqual(TEXT("Drained"),
+		               Queue.NumInFlight() + Queue.NumQueued(), 0);
+
+		Results = co_await Http::ProcessAllAsync({MakeRequest(),
+		                                          MakeRequest()});
+		Test.TestEqual(TEXT("All results"), Results.Num(), 2);
+		bDone = true;
+	});
+	FTestHelper::PumpGameThread(World, [&] { return bDone.load(); });
+
+	bDone = false;
+	World.Run(CORO
+	{
+		auto MakeRequest = []
+		{
+			auto Request = FHttpModule::Get().CreateRequest();
+			Request->SetURL(TEXT(".invalid"));
+			Request->SetTimeout(0.01);
+			return Request;
+		};
+		Http::FCachedClient Client;
+		auto Request1 = MakeRequest();
+		auto Request2 = MakeRequest();
+		auto First = Client.Process(Request1);
+		auto Second = Client.Process(Request2);
+		auto [Response1, bSuccess1] = co_await First;
+		auto [Response2, bSuccess2] = co_await Second;
+		Test.TestFalse(TEXT("Cached success 1"), bSuccess1);
+		Test.TestFalse(TEXT("Cached success 2"), bSuccess2);
+		Test.TestTrue(TEXT("Shared response"), Response1 == Response2);
+		Test.TestEqual(TEXT("Coalesced"), Request2->GetStatus(),
+		               EHttpRequestStatus::NotStarted);
+		Test.TestEqual(TEXT("Failures not cached"), Client.GetCachedBytes(),
+		               int64(0));
+
+		auto Post = MakeRequest();
+		Post->SetVerb(TEXT("POST"));
+		auto [Response3, bSuccess3] = co_await Client.Process(Post);
+		Test.TestFalse(TEXT("Bypassed success"), bSuccess3);
+		Test.TestNotEqual(TEXT("Bypassed"), Post->GetStatus(),
+		                  EHttpRequestStatus::NotStarted);
+		bDone = true;
+	});
+	FTestHelper::PumpGameThread(World, [&] { return bDone.load(); });
+
+	bDone = false;
+	World.Run(CORO
+	{
+		auto MakeRequest = []
+		{
+			auto Request = FHttpModule::Get().CreateRequest();
+			Request->SetURL(TEXT(".invalid"));
+			Request->SetTimeout(0.01);
+			return Request;
+		};
+		// Every attempt fails, the last failure is the result
+		auto [Response1, bSuccess1] = co_await Http::ProcessHedged(
+			MakeRequest(), 0.001, 3);
+		Test.TestFalse(TEXT("Hedged success"), bSuccess1);
+
+		auto Request = MakeRequest();
+		Request->SetTimeout(10);
+		auto [Response2, bSuccess2] = co_await Http::ProcessWithDeadline(
+			Request, 0);
+		Test.TestFalse(TEXT("Deadline success"), bSuccess2);
+		bDone = true;
+	});
+	FTestHelper::PumpGameThread(World, [&] { return bDone.load(); });
+
+	{
+		auto Parse = [](const char* Json)
+		{
+			FUE5CoroTestConstructionChecker Out;
+			return Private::DeserializeJson(
+				TConstArrayView<uint8>(reinterpret_cast<const uint8*>(Json),
+				                       FCStringAnsi::Strlen(Json)),
+				FUE5CoroTestConstructionChecker::StaticStruct(), &Out);
+		};
+		Test.TestTrue(TEXT("Object"), Parse("{}"));
+		Test.TestFalse(TEXT("Array"), Parse("[1]"));
+		Test.TestFalse(TEXT("Malformed"), Parse("{"));
+	}
+
+	bDone = false;
+	World.Run(CORO
+	{
+		auto Request = FHttpModule::Get().CreateRequest();
+		Request->SetURL(TEXT(".invalid"));
+		Request->SetTimeout(0.01);
+		auto Result = co_await Http::ProcessJsonAsync<
+			FUE5CoroTestConstructionChecker>(Request);
+		Test.TestFalse(TEXT("Failed request"), Result.IsSet());
+		Test.TestTrue(TEXT("Back on the game thread"), IsInGameThread());
+		bDone = true;
+	});
+	FTestHelper::PumpGameThread(World, [&] { return bDone.load(); });
+
 	// CompleteOnHttpThread is broken in 5.3.0.
 	// This test case passes if the HTTP thread is ticked properly.
 #if false && ENGINE_MINOR_VERSION >= 3
@@ -30,6 +30,7 @@
 // ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "TestWorld.h"
+#include "HAL/IConsoleManager.h"
 #include "Kismet/GameplayStatics.h"
 #include "Misc/AutomationTest.h"
 #include "UE5Coro/LatentAwaiters.h"
@@ -47,6 +48,30 @@ IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLatentInAsyncTest, "UE5Coro.Latent.Async",
                                  EAutomationTestFlags::HighPriority |
                                  EAutomationTestFlags::ProductFilter)
 
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLatentResumeBudgetTest,
+                                 "UE5Coro.Latent.ResumeBudget",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLatentPollIntervalTest,
+                                 "UE5Coro.Latent.PollInterval",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLatentHomeWorldTest,
+                                 "UE5Coro.Latent.HomeWorld",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLatentManyAsyncTest,
+                                 "UE5Coro.Latent.ManyAsync",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::MediumPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
 namespace
 {
 template<typename... T>
@@ -87,6 +112,64 @@ void DoTest(FAutomationTestBase& Test)
 		Test.TestEqual(TEXT("NextTick 2"), State, 2);
 	}
 
+	{
+		TArray<ETickingGroup> Groups;
+		World.Run(CORO
+		{
+			co_await Latent::NextTick(TG_PostPhysics);
+			Groups.Add(TG_PostPhysics);
+			// Later groups are still in the same frame, earlier ones are not
+			co_await Latent::NextTick(TG_PostUpdateWork);
+			Groups.Add(TG_PostUpdateWork);
+			co_await Latent::NextTick(TG_PrePhysics);
+			Groups.Add(TG_PrePhysics);
+		});
+		World.EndTick();
+		Test.TestEqual(TEXT("Tick group 1"), Groups.Num(), 0);
+		World.Tick();
+		Test.TestEqual(TEXT("Tick group 2"), Groups.Num(), 2);
+		World.Tick();
+		Test.TestEqual(TEXT("Tick group 3"), Groups.Num(), 3);
+	}
+
+	{
+		auto Ptr = std::make_shared<bool>(false);
+		World.Run(CORO
+		{
+			// State stored in the awaiter has to survive moves
+			auto Awaiter = Latent::Until([Ptr] { return *Ptr; });
+			auto Moved = std::move(Awaiter);
+			co_await Moved;
+		});
+		World.EndTick();
+		Test.TestEqual(TEXT("Inline state alive"), Ptr.use_count(), 2L);
+		*Ptr = true;
+		World.Tick();
+		Test.TestEqual(TEXT("Inline state destroyed"), Ptr.use_count(), 1L);
+	}
+
+	{
+		bool bReady = false;
+		TOptional<bool> Result1, Result2;
+		World.Run(CORO
+		{
+			Result1 = co_await Latent::UntilWithTimeout([&] { return bReady; },
+			                                            100);
+			Result2 = co_await Latent::UntilWithTimeout([] { return false; },
+			                                            0.5);
+		});
+		World.EndTick();
+		World.Tick(0.25);
+		Test.TestFalse(TEXT("Waiting for predicate"), Result1.IsSet());
+		bReady = true;
+		World.Tick(0.25);
+		Test.TestTrue(TEXT("Predicate succeeded"), Result1.Get(false));
+		World.Tick(0.25);
+		Test.TestFalse(TEXT("Waiting for timeout"), Result2.IsSet());
+		World.Tick(0.5);
+		Test.TestTrue(TEXT("Timed out"), Result2.IsSet() && !*Result2);
+	}
+
 	{
 		int State = 0;
 		World.Run(CORO
@@ -186,3 +269,187 @@ bool FLatentInAsyncTest::RunTest(const FString& Parameters)
 	DoTest<>(*this);
 	return true;
 }
+
+bool FLatentManyAsyncTest::RunTest(const FString& Parameters)
+{
+	constexpr int Count = 10000;
+	int Resumed = 0;
+	TArray<TCoroutine<>> Coros;
+	Coros.Reserve(Count);
+	{
+		FTestWorld World;
+		for (int i = 0; i < Count; ++i)
+			Coros.Add(World.Run([&Resumed, i]() -> TCoroutine<>
+			{
+				co_await Latent::Ticks(i % 4 + 1);
+				++Resumed;
+				co_await Latent::Seconds(1000); // Never completes in this world
+			}));
+
+		// The starting frame doesn't count for Latent::Ticks
+		constexpr int NumTicks = 5;
+		auto Start = FPlatformTime::Seconds();
+		for (int i = 0; i < NumTicks; ++i)
+			World.Tick();
+		auto End = FPlatformTime::Seconds();
+		TestEqual(TEXT("Every coroutine resumed"), Resumed, Count);
+		AddInfo(FString::Printf(TEXT("%.3f ms per tick with %d awaiters"),
+		                        (End - Start) * 1000 / NumTicks, Count));
+	}
+
+	{
+		// Deadlines resume in order regardless of the order of the co_awaits
+		FTestWorld World;
+		TArray<int> Order;
+		for (int i = 0; i < 100; ++i)
+			World.Run([&Order, i]() -> TCoroutine<>
+			{
+				int Delay = (i * 37) % 100;
+				co_await Latent::Seconds(Delay * 0.01 + 0.005);
+				Order.Add(Delay);
+			});
+		for (int i = 0; i < 110 && Order.Num() < 100; ++i)
+			World.Tick(0.01);
+		TestEqual(TEXT("Every deadline expired"), Order.Num(), 100);
+		for (int i = 1; i < Order.Num(); ++i)
+			TestTrue(TEXT("Ordered"), Order[i - 1] < Order[i]);
+	}
+
+	// Destroying the world cancels everything that's still waiting
+	for (auto& Coro : Coros)
+		if (!Coro.IsDone() || Coro.WasSuccessful())
+		{
+			AddError(TEXT("Unexpected coroutine state"));
+			break;
+		}
+	return true;
+}
+
+bool FLatentResumeBudgetTest::RunTest(const FString& Parameters)
+{
+	auto* CVar = IConsoleManager::Get().FindConsoleVariable(
+		TEXT("UE5Coro.LatentResumeBudget"));
+	if (!TestNotNull(TEXT("CVar exists"), CVar))
+		return false;
+	CVar->Set(1.0f); // 1 µs, every resumption exceeds this
+	ON_SCOPE_EXIT { CVar->Set(0.0f); };
+
+	FTestWorld World;
+	auto* Sys = World->GetSubsystem<UUE5CoroSubsystem>();
+	auto Before = Sys->GetResumeStats();
+	TArray<int> Order;
+	auto Work = []
+	{
+		for (double End = FPlatformTime::Seconds() + 0.0001;
+		     FPlatformTime::Seconds() < End;)
+			;
+	};
+	for (int i = 0; i < 3; ++i)
+		World.Run([&Order, &Work, i]() -> TCoroutine<>
+		{
+			co_await Latent::NextTick();
+			Work();
+			Order.Add(i);
+		});
+	World.Run([&Order, &Work]() -> TCoroutine<>
+	{
+		Latent::SetResumePriority(1);
+		co_await Latent::NextTick();
+		Work();
+		Order.Add(100);
+	});
+
+	World.EndTick();
+	World.Tick();
+	auto After = Sys->GetResumeStats();
+	// At most one regular coroutine fits, the high priority one ignores it
+	TestTrue(TEXT("Some resumptions deferred"), Order.Num() <= 2);
+	TestTrue(TEXT("High priority not deferred"), Order.Contains(100));
+	TestTrue(TEXT("Deferred counted"),
+	         After.NumDeferred - Before.NumDeferred >= 2);
+	// Deferred coroutines resume at least one per frame
+	for (int i = 0; i < 5 && Order.Num() < 4; ++i)
+		World.Tick();
+	TestEqual(TEXT("Deferred resumed later"), Order.Num(), 4);
+	auto Final = Sys->GetResumeStats();
+	TestTrue(TEXT("Latency recorded"), Final.MaxAddedLatency > 0);
+	return true;
+}
+
+bool FLatentPollIntervalTest::RunTest(const FString& Parameters)
+{
+	FTestWorld World;
+	int Polls = 0;
+	bool bDone = false;
+	auto Poll = [&] { ++Polls; return bDone; };
+
+	auto Coro = World.Run([&](FLatentActionInfo) -> TCoroutine<>
+	{
+		Latent::SetPollInterval(0.3); // Every third 0.125s tick
+		co_await Latent::Until(Poll);
+	});
+	World.EndTick();
+	int Initial = Polls;
+	for (int i = 0; i < 6; ++i)
+		World.Tick();
+	TestEqual(TEXT("Polled less often"), Polls - Initial, 2);
+	bDone = true;
+	for (int i = 0; i < 3 && !Coro.IsDone(); ++i)
+		World.Tick();
+	TestTrue(TEXT("Resumed on a poll"), Coro.IsDone());
+
+	// Latent coroutines on an object, FTestWorld uses the subsystem
+	auto* Sys = World->GetSubsystem<UUE5CoroSubsystem>();
+	Latent::SetPollInterval(Sys, 1.0);
+	Polls = 0;
+	bDone = false;
+	Coro = World.Run([&](FLatentActionInfo) -> TCoroutine<>
+	{
+		co_await Latent::Until(Poll);
+	});
+	World.EndTick();
+	Initial = Polls;
+	for (int i = 0; i < 6; ++i)
+		World.Tick();
+	TestEqual(TEXT("Object interval"), Polls - Initial, 0);
+	Latent::SetPollInterval(Sys, 0);
+	World.Tick();
+	TestTrue(TEXT("Polled again"), Polls - Initial > 0);
+	bDone = true;
+	World.Tick();
+	TestTrue(TEXT("Done"), Coro.IsDone());
+	return true;
+}
+
+bool FLatentHomeWorldTest::RunTest(const FString& Parameters)
+{
+	FTestWorld World1;
+	FTestWorld World2; // This one is GWorld now
+	bool bInner = false;
+
+	auto Inner = [&]() -> TCoroutine<>
+	{
+		co_await Latent::NextTick();
+		bInner = true;
+	};
+	auto Coro = World1.Run([&]() -> TCoroutine<>
+	{
+		Latent::SetHomeWorld(World1.operator->());
+		co_await Latent::Seconds(0.2);
+		co_await Inner(); // Inherits World1
+	});
+	auto Other = World2.Run([&]() -> TCoroutine<>
+	{
+		co_await Latent::Seconds(0.2); // Stays in GWorld
+	});
+
+	for (int i = 0; i < 4; ++i)
+		World2.Tick();
+	TestFalse(TEXT("Not resumed by another world"), Coro.IsDone());
+	TestTrue(TEXT("GWorld's coroutine resumed"), Other.IsDone());
+	for (int i = 0; i < 4; ++i)
+		World1.Tick();
+	TestTrue(TEXT("Inner coroutine in the home world"), bInner);
+	TestTrue(TEXT("Resumed by its home world"), Coro.IsDone());
+	return true;
+}
@@ -31,6 +31,7 @@
 
 #include "TestWorld.h"
 #include "UE5CoroTestObject.h"
+#include "HAL/IConsoleManager.h"
 #include "Kismet/KismetSystemLibrary.h"
 #include "Misc/AutomationTest.h"
 #include "UE5Coro/AggregateAwaiters.h"
@@ -50,8 +51,22 @@ IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLatentChainTest, "UE5Coro.Chain.Latent",
                                  EAutomationTestFlags::HighPriority |
                                  EAutomationTestFlags::ProductFilter)
 
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLatentChainBenchmark,
+                                 "UE5Coro.Chain.Benchmark",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::MediumPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
 namespace
 {
+IConsoleVariable* SharedTargetCVar()
+{
+	auto* CVar = IConsoleManager::Get().FindConsoleVariable(
+		TEXT("UE5Coro.SharedChainCallbackTarget"));
+	check(CVar);
+	return CVar;
+}
+
 template<typename... T>
 void DoTest(FAutomationTestBase& Test)
 {
@@ -143,6 +158,24 @@ void DoTest(FAutomationTestBase& Test)
 		DoubleTick(3, 0);
 	}
 
+#if UE5CORO_PRIVATE_LATENT_CHAIN_IS_OK
+	{
+		// Same signature as Delay, but it needs to be chained normally
+		State = 0;
+		World.Run(CORO
+		{
+			State = 1;
+			ExpectSuccess(co_await Latent::Chain(
+				&UKismetSystemLibrary::RetriggerableDelay, 1));
+			State = 2;
+		});
+		Test.TestEqual(TEXT("Initial state"), State, 1);
+		World.Tick(0.5);
+		Test.TestEqual(TEXT("Half state"), State, 1);
+		DoubleTick(2, 1);
+	}
+#endif
+
 	{
 		State = -1;
 		World.Run(CORO
@@ -172,12 +205,61 @@ void DoTest(FAutomationTestBase& Test)
 
 bool FAsyncChainTest::RunTest(const FString& Parameters)
 {
-	DoTest<>(*this);
+	auto* CVar = SharedTargetCVar();
+	bool bOld = CVar->GetBool();
+	ON_SCOPE_EXIT { CVar->Set(bOld); };
+	for (bool bShared : {false, true})
+	{
+		CVar->Set(bShared);
+		DoTest<>(*this);
+	}
 	return true;
 }
 
 bool FLatentChainTest::RunTest(const FString& Parameters)
 {
-	DoTest<FLatentActionInfo>(*this);
+	auto* CVar = SharedTargetCVar();
+	bool bOld = CVar->GetBool();
+	ON_SCOPE_EXIT { CVar->Set(bOld); };
+	for (bool bShared : {false, true})
+	{
+		CVar->Set(bShared);
+		DoTest<FLatentActionInfo>(*this);
+	}
+	return true;
+}
+
+bool FLatentChainBenchmark::RunTest(const FString& Parameters)
+{
+	constexpr int Count = 1000;
+	auto* CVar = SharedTargetCVar();
+	bool bOld = CVar->GetBool();
+	ON_SCOPE_EXIT { CVar->Set(bOld); };
+
+	for (bool bShared : {false, true})
+	{
+		CVar->Set(bShared);
+		FTestWorld World;
+		int Done = 0;
+
+		auto Start = FPlatformTime::Seconds();
+		for (int i = 0; i < Count; ++i)
+			World.Run([&](FLatentActionInfo) -> FAsyncCoroutine
+			{
+				TestTrue(TEXT("Chain not aborted"),
+				         co_await Latent::ChainEx(
+					         &UKismetSystemLibrary::DelayUntilNextTick,
+					         _1, _2));
+				++Done;
+			});
+		for (int i = 0; i < 10 && Done < Count; ++i)
+			World.Tick(0);
+		auto End = FPlatformTime::Seconds();
+
+		TestEqual(TEXT("All chains completed"), Done, Count);
+		AddInfo(FString::Printf(TEXT("%s callback targets: %.1f ns/chain"),
+		                        bShared ? TEXT("Shared") : TEXT("Per-chain"),
+		                        (End - Start) * 1e9 / Count));
+	}
 	return true;
 }
@@ -0,0 +1,181 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "TestWorld.h"
+#include "Kismet/KismetSystemLibrary.h"
+#include "Misc/AutomationTest.h"
+#include "UE5Coro/LatentAwaiters.h"
+#include "UObject/UObjectArray.h"
+
+using namespace std::placeholders;
+using namespace UE5Coro;
+using namespace UE5Coro::Private::Test;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLatentScalabilityBenchmark,
+                                 "UE5Coro.Latent.Scalability",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::MediumPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+namespace
+{
+constexpr int NumKinds = 5;
+constexpr int NumFrames = 32;
+constexpr float DeltaSeconds = 1.0f / 60;
+
+struct FScenario
+{
+	// Always loaded, kind 2 measures AsyncLoadObject's overhead, not loading
+	TSoftObjectPtr<UWorld> LoadedAsset;
+	bool bStop = false;
+	int Done = 0;
+};
+
+template<typename... T>
+void Start(FTestWorld& World, FScenario& Scenario, int Kind)
+{
+	World.Run([&Scenario, Kind](T...) -> FAsyncCoroutine
+	{
+		while (!Scenario.bStop)
+		{
+			switch (Kind)
+			{
+				case 0:
+					co_await Latent::NextTick();
+					break;
+				case 1:
+					co_await Latent::Seconds(0.25);
+					break;
+				case 2:
+					// This doesn't load anything and might not suspend
+					co_await Latent::AsyncLoadObject(Scenario.LoadedAsset);
+					co_await Latent::NextTick();
+					break;
+				case 3:
+				{
+					auto Frame = GFrameCounter + 2;
+					co_await Latent::Until([=]
+					{
+						return GFrameCounter >= Frame;
+					});
+					break;
+				}
+				default:
+					co_await Latent::ChainEx(
+						&UKismetSystemLibrary::DelayUntilNextTick, _1, _2);
+					break;
+			}
+		}
+		++Scenario.Done;
+	});
+}
+
+double GCSeconds()
+{
+	auto Start = FPlatformTime::Seconds();
+	CollectGarbage(RF_NoFlags);
+	return FPlatformTime::Seconds() - Start;
+}
+}
+
+bool FLatentScalabilityBenchmark::RunTest(const FString& Parameters)
+{
+	for (int Num : {1000, 10000, 50000})
+	{
+		FTestWorld World;
+		FScenario Scenario;
+		Scenario.LoadedAsset = World.operator->();
+		double BaseGC = GCSeconds();
+		auto MemoryBefore = FPlatformMemory::GetStats().UsedPhysical;
+		int ObjectsBefore = GUObjectArray.GetObjectArrayNumMinusAvailable();
+
+		// Half of them are latent, half async, with every kind in both
+		for (int i = 0; i < Num; ++i)
+			if (i % 2)
+				Start<FLatentActionInfo>(World, Scenario, i / 2 % NumKinds);
+			else
+				Start<>(World, Scenario, i / 2 % NumKinds);
+
+		auto MemoryAfter = FPlatformMemory::GetStats().UsedPhysical;
+		int ObjectsAfter = GUObjectArray.GetObjectArrayNumMinusAvailable();
+
+		// Real frames, with time advancing
+		auto FrameStart = FPlatformTime::Seconds();
+		for (int i = 0; i < NumFrames; ++i)
+			World.Tick(DeltaSeconds);
+		double FrameSeconds = FPlatformTime::Seconds() - FrameStart;
+
+		// The two halves of the scheduling cost in isolation, on frames that
+		// don't advance time
+		auto* Sys = World->GetSubsystem<UUE5CoroSubsystem>();
+		auto& Manager = World->GetLatentActionManager();
+		double SubsystemSeconds = 0;
+		double LatentSeconds = 0;
+		for (int i = 0; i < NumFrames; ++i)
+		{
+			Manager.BeginFrame();
+			auto Start = FPlatformTime::Seconds();
+			Sys->Tick(0);
+			auto Mid = FPlatformTime::Seconds();
+			Manager.ProcessLatentActions(nullptr, 0);
+			auto End = FPlatformTime::Seconds();
+			SubsystemSeconds += Mid - Start;
+			LatentSeconds += End - Mid;
+			World.EndTick();
+			FTaskGraphInterface::Get().ProcessThreadUntilIdle(
+				ENamedThreads::GameThread);
+		}
+
+		double GCDelta = GCSeconds() - BaseGC;
+
+		Scenario.bStop = true;
+		for (int i = 0; i < 1000 && Scenario.Done < Num; ++i)
+			World.Tick(DeltaSeconds);
+		TestEqual(TEXT("Every coroutine finished"), Scenario.Done, Num);
+
+		AddInfo(FString::Printf(
+			TEXT("%d coroutines: %.3f ms/frame, UUE5CoroSubsystem::Tick %.3f ")
+			TEXT("ms, ProcessLatentActions %.3f ms"), Num,
+			FrameSeconds * 1000 / NumFrames,
+			SubsystemSeconds * 1000 / NumFrames,
+			LatentSeconds * 1000 / NumFrames));
+		AddInfo(FString::Printf(
+			TEXT("%d coroutines: %.0f bytes and %.2f UObjects each, ")
+			TEXT("GC +%.3f ms"), Num,
+			// Memory use can go down, don't wrap around
+			static_cast<double>(static_cast<int64>(MemoryAfter) -
+			                    static_cast<int64>(MemoryBefore)) / Num,
+			static_cast<double>(ObjectsAfter - ObjectsBefore) / Num,
+			GCDelta * 1000));
+	}
+	return true;
+}
@@ -0,0 +1,161 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "TestWorld.h"
+#include "Misc/AutomationTest.h"
+#include "UE5CoroTestObject.h"
+#include "UE5Coro/LatentTimeline.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Private;
+using namespace UE5Coro::Private::Test;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLatentTimelineTest, "UE5Coro.Latent.Timeline",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+bool FLatentTimelineTest::RunTest(const FString& Parameters)
+{
+	FTestWorld World;
+
+	{
+		constexpr int Count = 100;
+		TArray<double> Values;
+		TArray<int> Calls;
+		Values.Init(-1, Count);
+		Calls.Init(0, Count);
+		TArray<TCoroutine<>> Coros;
+		for (int i = 0; i < Count; ++i)
+		{
+			auto Fn = [&, i](double Value)
+			{
+				TestTrue(TEXT("Monotonic"), Value >= Values[i]);
+				Values[i] = Value;
+				++Calls[i];
+			};
+			Coros.Add(Latent::Timeline(World.operator->(), 0, i,
+			                           0.25 + i * 0.01, Fn));
+		}
+		for (int i = 0; i < Count; ++i)
+		{
+			TestEqual(TEXT("First call"), Calls[i], 1);
+			TestEqual(TEXT("From"), Values[i], 0.0);
+		}
+
+		World.EndTick();
+		FTestHelper::PumpGameThread(World, [&]
+		{
+			for (auto& Coro : Coros)
+				if (!Coro.IsDone())
+					return false;
+			return true;
+		});
+		for (int i = 0; i < Count; ++i)
+		{
+			TestEqual(TEXT("Exactly To"), Values[i], static_cast<double>(i));
+			TestTrue(TEXT("Called every tick"), Calls[i] > 2);
+		}
+	}
+
+	{
+		int Calls = 0;
+		auto Coro = Latent::Timeline(World.operator->(), 0, 1, 100,
+		                             [&](double) { ++Calls; });
+		World.EndTick();
+		World.Tick();
+		TestEqual(TEXT("Running"), Calls, 2);
+		Coro.Cancel();
+		World.Tick();
+		int CallsAfterCancel = Calls;
+		World.Tick();
+		World.Tick();
+		TestTrue(TEXT("Canceled"), Coro.IsDone());
+		TestEqual(TEXT("Not called after cancel"), Calls, CallsAfterCancel);
+	}
+
+	{
+		// Timelines started from a callback join the batch being evaluated
+		int Outer = 0, Inner = 0;
+		TOptional<TCoroutine<>> InnerCoro;
+		auto OuterCoro = Latent::Timeline(World.operator->(), 0, 1, 0.5,
+		                                  [&](double)
+		{
+			if (++Outer == 2)
+				InnerCoro = Latent::Timeline(World.operator->(), 0, 1, 0.5,
+				                             [&](double) { ++Inner; });
+		});
+		World.EndTick();
+		World.Tick();
+		TestEqual(TEXT("Inner started"), Inner, 1);
+		World.Tick();
+		TestEqual(TEXT("Inner evaluated once per tick"), Inner, 2);
+		FTestHelper::PumpGameThread(World, [&]
+		{
+			return OuterCoro.IsDone() && InnerCoro->IsDone();
+		});
+	}
+
+	{
+		// Typed outputs and easing
+		FVector Vector(-1);
+		double Eased = -1;
+		auto* Object = NewObject<UUE5CoroTestObject>();
+		Object->AddToRoot();
+		auto Coro1 = Latent::Timeline(World.operator->(), Vector, FVector(0),
+		                              FVector(1, 2, 3), 1);
+		auto Coro2 = Latent::Timeline(World.operator->(), 0, 1, 1,
+		                              EEasingFunc::EaseIn,
+		                              [&](double Value) { Eased = Value; });
+		auto Coro3 = Latent::Timeline(World.operator->(), Object, TEXT("Color"),
+		                              FLinearColor::Black, FLinearColor::White,
+		                              1, EEasingFunc::SinusoidalInOut);
+		TestEqual(TEXT("Vector start"), Vector, FVector(0));
+		TestEqual(TEXT("Eased start"), Eased, 0.0);
+		TestEqual(TEXT("Color start"), Object->Color, FLinearColor::Black);
+		World.EndTick();
+		World.Tick(0.5);
+		TestTrue(TEXT("Vector linear"), Vector.Equals(FVector(0.5, 1, 1.5)));
+		TestTrue(TEXT("Eased in"), Eased > 0 && Eased < 0.5);
+		TestEqual(TEXT("Color symmetric"), Object->Color.R, 0.5f,
+		          KINDA_SMALL_NUMBER);
+		FTestHelper::PumpGameThread(World, [&]
+		{
+			return Coro1.IsDone() && Coro2.IsDone() && Coro3.IsDone();
+		});
+		TestEqual(TEXT("Vector end"), Vector, FVector(1, 2, 3));
+		TestEqual(TEXT("Eased end"), Eased, 1.0);
+		TestEqual(TEXT("Color end"), Object->Color, FLinearColor::White);
+		Object->RemoveFromRoot();
+	}
+
+	return true;
+}
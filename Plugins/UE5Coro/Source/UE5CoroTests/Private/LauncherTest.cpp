@@ -0,0 +1,115 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "TestWorld.h"
+#include "Misc/AutomationTest.h"
+#include "UE5Coro/AsyncAwaiters.h"
+#include "UE5Coro/Threading.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Private::Test;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLauncherTest, "UE5Coro.Threading.Launcher",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+namespace
+{
+TCoroutine<> Work(FAwaitableEvent& Event, int& Active, int& MaxActive)
+{
+	MaxActive = FMath::Max(MaxActive, ++Active);
+	co_await Event;
+	--Active;
+}
+}
+
+bool FLauncherTest::RunTest(const FString& Parameters)
+{
+	{
+		Async::FLauncher Launcher(3);
+		FAwaitableEvent Event;
+		int Active = 0, MaxActive = 0, Started = 0;
+		for (int i = 0; i < 10; ++i)
+			Launcher.Launch([&]
+			{
+				++Started;
+				return Work(Event, Active, MaxActive);
+			});
+		TestEqual(TEXT("Started"), Started, 3);
+		TestEqual(TEXT("Running"), Launcher.NumRunning(), 3);
+		TestEqual(TEXT("Queued"), Launcher.NumQueued(), 7);
+
+		bool bDrained = false;
+		auto Drain = [&]() -> TCoroutine<>
+		{
+			co_await Launcher.Drain();
+			bDrained = true;
+		}();
+		for (int i = 0; i < 9; ++i)
+		{
+			Event.Trigger(); // AutoReset, finishes one at a time
+			TestFalse(TEXT("Not drained yet"), bDrained);
+		}
+		Event.Trigger();
+		TestTrue(TEXT("Drained"), bDrained);
+		TestEqual(TEXT("All started"), Started, 10);
+		TestEqual(TEXT("Limit respected"), MaxActive, 3);
+		TestEqual(TEXT("Nothing running"), Launcher.NumRunning(), 0);
+		TestEqual(TEXT("Nothing queued"), Launcher.NumQueued(), 0);
+
+		// Synchronous coroutines don't hold on to their slots
+		int Sync = 0;
+		for (int i = 0; i < 1000; ++i)
+			Launcher.Launch([&]() -> TCoroutine<> { ++Sync; co_return; });
+		TestEqual(TEXT("Synchronous"), Sync, 1000);
+		TestTrue(TEXT("Empty drain"), Launcher.Drain().IsDone());
+	}
+
+	{
+		FAwaitableEvent Event;
+		int Active = 0, MaxActive = 0, Started = 0;
+		{
+			Async::FLauncher Launcher(1);
+			for (int i = 0; i < 3; ++i)
+				Launcher.Launch([&]
+				{
+					++Started;
+					return Work(Event, Active, MaxActive);
+				});
+		}
+		// Destroying the launcher discarded the factories that were queued
+		Event.Trigger();
+		TestEqual(TEXT("Only the first started"), Started, 1);
+		TestEqual(TEXT("Finished"), Active, 0);
+	}
+	return true;
+}
@@ -0,0 +1,165 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "TestWorld.h"
+#include "Misc/AutomationTest.h"
+#include "UE5Coro/LatentAwaiters.h"
+#include "UE5Coro/LazyCoroutine.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Private;
+using namespace UE5Coro::Private::Test;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLazyCoroutineTest, "UE5Coro.LazyCoroutine",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+namespace
+{
+TLazyCoroutine<int> Add(int A, int B, int& Runs)
+{
+	++Runs;
+	co_return A + B;
+}
+
+TLazyCoroutine<int> Sum(int Count, int& Runs)
+{
+	int Total = 0;
+	for (int i = 0; i < Count; ++i)
+		Total = co_await Add(Total, i, Runs);
+	co_return Total;
+}
+
+TLazyCoroutine<> Increment(int& Value)
+{
+	++Value;
+	co_return;
+}
+
+TLazyCoroutine<int> AddNextTick(int A, int B)
+{
+	co_await Latent::NextTick();
+	co_return A + B;
+}
+
+TLazyCoroutine<int> AddTwoTicks(int& State)
+{
+	State = 1;
+	int Result = co_await AddNextTick(1, 2);
+	State = 2;
+	co_await Latent::NextTick();
+	State = 3;
+	co_return Result;
+}
+
+template<typename... T>
+void DoTest(FAutomationTestBase& Test)
+{
+	FTestWorld World;
+
+	{
+		int Runs = 0;
+		{
+			auto Lazy = Add(1, 2, Runs);
+		}
+		Test.TestEqual(TEXT("Not started without co_await"), Runs, 0);
+	}
+
+	{
+		int Runs = 0;
+		int Result = 0;
+		auto Coro = World.Run(CORO
+		{
+			Result = co_await Sum(100, Runs);
+		});
+		Test.TestTrue(TEXT("Done synchronously"), Coro.IsDone());
+		Test.TestEqual(TEXT("Result"), Result, 99 * 100 / 2);
+		Test.TestEqual(TEXT("Every helper ran"), Runs, 100);
+	}
+
+	{
+		int Value = 0;
+		auto Coro = World.Run(CORO
+		{
+			co_await Increment(Value);
+			co_await Increment(Value);
+		});
+		Test.TestTrue(TEXT("Void done"), Coro.IsDone());
+		Test.TestEqual(TEXT("Void ran"), Value, 2);
+	}
+
+	{
+		int State = 0;
+		int Result = 0;
+		auto Coro = World.Run(CORO
+		{
+			Result = co_await AddTwoTicks(State);
+		});
+		World.EndTick();
+		Test.TestEqual(TEXT("Suspended in nested helper"), State, 1);
+		Test.TestFalse(TEXT("Suspended with it"), Coro.IsDone());
+		World.Tick();
+		Test.TestEqual(TEXT("Resumed nested helper"), State, 2);
+		Test.TestFalse(TEXT("Suspended again"), Coro.IsDone());
+		World.Tick();
+		Test.TestEqual(TEXT("Resumed outer helper"), State, 3);
+		Test.TestTrue(TEXT("Done with the helpers"), Coro.IsDone());
+		Test.TestEqual(TEXT("Result through suspensions"), Result, 3);
+	}
+
+	{
+		int State = 0;
+		auto Coro = World.Run(CORO
+		{
+			co_await AddTwoTicks(State);
+		});
+		Coro.Cancel();
+		World.Tick();
+		Test.TestEqual(TEXT("Canceled in the helper"), State, 1);
+		Test.TestTrue(TEXT("Canceled"), Coro.IsDone());
+	}
+}
+}
+
+bool FLazyCoroutineTest::RunTest(const FString& Parameters)
+{
+	DoTest<>(*this);
+	DoTest<FLatentActionInfo>(*this);
+
+	{
+		int Runs = 0;
+		TCoroutine<int> Coro = Sum(10, Runs).Start();
+		TestTrue(TEXT("Started"), Coro.IsDone());
+		TestEqual(TEXT("Escaped result"), Coro.GetResult(), 45);
+	}
+	return true;
+}
@@ -0,0 +1,119 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "TestWorld.h"
+#include "Misc/AutomationTest.h"
+#include "Engine/LevelStreamingDynamic.h"
+#include "UE5Coro/LatentAwaiters.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Private::Test;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLevelStreamingAsyncTest,
+                                 "UE5Coro.LevelStreaming.Async",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FLevelStreamingLatentTest,
+                                 "UE5Coro.LevelStreaming.Latent",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+namespace
+{
+template<typename... T>
+void DoTest(FAutomationTestBase& Test)
+{
+	FTestWorld World;
+
+	{
+		// Not part of any world, this level will never load
+		auto* Level = NewObject<ULevelStreamingDynamic>(World.operator->());
+		int State = 0;
+		World.Run(CORO
+		{
+			State = 1;
+			co_await Latent::UntilLevelUnloaded(Level);
+			State = 2;
+			co_await Latent::UntilLevelsVisible({});
+			State = 3;
+			co_await Latent::UntilLevelLoaded(Level);
+			State = 4;
+		});
+		Test.TestEqual(TEXT("Already unloaded"), State, 3);
+		Level->OnLevelLoaded.Broadcast();
+		for (int i = 0; i < 5; ++i)
+			World.Tick();
+		Test.TestEqual(TEXT("Spurious broadcast ignored"), State, 3);
+		Level->MarkAsGarbage();
+		CollectGarbage(RF_NoFlags);
+		World.Tick();
+		Test.TestEqual(TEXT("Destroyed level counts as loaded"), State, 4);
+	}
+
+	{
+		auto* Level1 = NewObject<ULevelStreamingDynamic>(World.operator->());
+		auto* Level2 = NewObject<ULevelStreamingDynamic>(World.operator->());
+		int State = 0;
+		World.Run(CORO
+		{
+			State = 1;
+			TArray<ULevelStreaming*> Levels{Level1, Level2};
+			co_await Latent::UntilLevelsVisible(Levels);
+			State = 2;
+		});
+		Test.TestEqual(TEXT("Waiting for levels"), State, 1);
+		World.Tick();
+		Level1->MarkAsGarbage();
+		CollectGarbage(RF_NoFlags);
+		World.Tick();
+		Test.TestEqual(TEXT("One level remaining"), State, 1);
+		Level2->MarkAsGarbage();
+		CollectGarbage(RF_NoFlags);
+		World.Tick();
+		Test.TestEqual(TEXT("Destroyed levels count as finished"), State, 2);
+	}
+}
+}
+
+bool FLevelStreamingAsyncTest::RunTest(const FString& Parameters)
+{
+	DoTest<>(*this);
+	return true;
+}
+
+bool FLevelStreamingLatentTest::RunTest(const FString& Parameters)
+{
+	DoTest<FLatentActionInfo>(*this);
+	return true;
+}
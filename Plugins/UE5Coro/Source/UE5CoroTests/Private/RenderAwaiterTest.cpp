@@ -0,0 +1,114 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "TestWorld.h"
+#include "Misc/AutomationTest.h"
+#include "RenderingThread.h"
+#include "UE5Coro/AsyncAwaiters.h"
+#include "UE5Coro/RenderAwaiters.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Private::Test;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRenderAsyncTest, "UE5Coro.Render.Async",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FRenderLatentTest, "UE5Coro.Render.Latent",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+namespace
+{
+template<typename... T>
+void DoTest(FAutomationTestBase& Test)
+{
+	FTestWorld World;
+
+	std::atomic<bool> bDone = false;
+	World.Run(CORO
+	{
+		co_await Async::MoveToRenderThread();
+		Test.TestTrue(TEXT("On the rendering thread"), IsInRenderingThread());
+		co_await Async::MoveToGameThread();
+		Test.TestTrue(TEXT("Back on the game thread"), IsInGameThread());
+		bDone = true;
+	});
+	FTestHelper::PumpGameThread(World, [&] { return bDone.load(); });
+
+	bDone = false;
+	World.Run(CORO
+	{
+		std::atomic<bool> bRendered = false;
+		ENQUEUE_RENDER_COMMAND(UE5CoroTest)([&](FRHICommandListImmediate&)
+		{
+			bRendered = true;
+		});
+		FRenderCommandFence Fence;
+		Fence.BeginFence();
+		co_await Fence;
+		Test.TestTrue(TEXT("On the game thread"), IsInGameThread());
+		Test.TestTrue(TEXT("Fence complete"), Fence.IsFenceComplete());
+		Test.TestTrue(TEXT("Earlier command done"), bRendered.load());
+		co_await Fence; // Already complete
+		bDone = true;
+	});
+	FTestHelper::PumpGameThread(World, [&] { return bDone.load(); });
+
+	bDone = false;
+	World.Run(CORO
+	{
+		// Nothing to precache, this completes without suspending
+		TArray<UPrimitiveComponent*> Components{nullptr};
+		bool bCompleted = co_await Render::PrecachePSOs(Components, 1);
+		Test.TestTrue(TEXT("Nothing to wait for"), bCompleted);
+		bCompleted = co_await Render::UntilTexturesResident(Components);
+		Test.TestTrue(TEXT("No textures to wait for"), bCompleted);
+		Test.TestTrue(TEXT("On the game thread"), IsInGameThread());
+		bDone = true;
+	});
+	FTestHelper::PumpGameThread(World, [&] { return bDone.load(); });
+}
+}
+
+bool FRenderAsyncTest::RunTest(const FString& Parameters)
+{
+	DoTest<>(*this);
+	return true;
+}
+
+bool FRenderLatentTest::RunTest(const FString& Parameters)
+{
+	DoTest<FLatentActionInfo>(*this);
+	return true;
+}
@@ -59,11 +59,37 @@ struct stdcoro::coroutine_traits<void, FAutomationTestBase&>
 
 namespace
 {
+struct FNoDefault
+{
+	static inline int Copies = 0;
+	static inline int Moves = 0;
+	int Value;
+
+	explicit FNoDefault(int Value) : Value(Value) { }
+	FNoDefault(const FNoDefault& Other) : Value(Other.Value) { ++Copies; }
+	FNoDefault(FNoDefault&& Other) : Value(Other.Value) { ++Moves; }
+};
+
 template<typename... T>
 void DoTest(FAutomationTestBase& Test)
 {
 	FTestWorld World;
 
+	{
+		FNoDefault::Copies = FNoDefault::Moves = 0;
+		auto Coro = World.Run(CORO_R(FNoDefault)
+		{
+			co_return FNoDefault(5);
+		});
+		Test.TestEqual(TEXT("No default constructor"),
+		               Coro.GetResult().Value, 5);
+		FNoDefault Moved = Coro.MoveResult();
+		Test.TestEqual(TEXT("Moved value"), Moved.Value, 5);
+		Test.TestEqual(TEXT("Never copied"), FNoDefault::Copies, 0);
+		Test.TestEqual(TEXT("Moved into place, then out"), FNoDefault::Moves,
+		               2);
+	}
+
 	{
 		auto A = World.Run(CORO_R(int) { co_return 1; });
 		auto B = World.Run(CORO_R(int) { co_return 1.0; });
@@ -0,0 +1,102 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "TestWorld.h"
+#include "GameFramework/SaveGame.h"
+#include "Kismet/GameplayStatics.h"
+#include "Misc/AutomationTest.h"
+#include "UE5Coro/SaveGameAwaiters.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Private::Test;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSaveGameAsyncTest, "UE5Coro.SaveGame.Async",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSaveGameLatentTest,
+                                 "UE5Coro.SaveGame.Latent",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+namespace
+{
+template<typename... T>
+void DoTest(FAutomationTestBase& Test)
+{
+	FTestWorld World;
+	const FString Slot = TEXT("UE5CoroSaveGameTest");
+	const FString Missing = TEXT("UE5CoroSaveGameTest.missing");
+
+	std::atomic<bool> bDone = false;
+	World.Run(CORO
+	{
+		auto* SaveGame = NewObject<USaveGame>();
+		bool bSaved = co_await Save::SaveGameAsync(SaveGame, Slot, 0);
+		Test.TestTrue(TEXT("Game thread"), IsInGameThread());
+		Test.TestTrue(TEXT("Saved"), bSaved);
+		USaveGame* Loaded = co_await Save::LoadGameAsync(Slot, 0);
+		Test.TestNotNull(TEXT("Loaded"), Loaded);
+
+		bSaved = co_await Save::SaveGameAsync(SaveGame, Slot, 0, NAME_Zlib);
+		Test.TestTrue(TEXT("Saved compressed"), bSaved);
+		Loaded = co_await Save::LoadGameAsync(Slot, 0);
+		Test.TestNotNull(TEXT("Loaded compressed"), Loaded);
+
+		Test.TestTrue(TEXT("Saved sync"),
+		              UGameplayStatics::SaveGameToSlot(SaveGame, Slot, 0));
+		Loaded = co_await Save::LoadGameAsync(Slot, 0);
+		Test.TestNotNull(TEXT("Loaded sync save"), Loaded);
+
+		Loaded = co_await Save::LoadGameAsync(Missing, 0);
+		Test.TestNull(TEXT("Missing slot"), Loaded);
+		bDone = true;
+	});
+	FTestHelper::PumpGameThread(World, [&] { return bDone.load(); });
+
+	UGameplayStatics::DeleteGameInSlot(Slot, 0);
+}
+}
+
+bool FSaveGameAsyncTest::RunTest(const FString& Parameters)
+{
+	DoTest<>(*this);
+	return true;
+}
+
+bool FSaveGameLatentTest::RunTest(const FString& Parameters)
+{
+	DoTest<FLatentActionInfo>(*this);
+	return true;
+}
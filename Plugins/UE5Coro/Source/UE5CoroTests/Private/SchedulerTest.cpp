@@ -0,0 +1,152 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "TestWorld.h"
+#include "Misc/AutomationTest.h"
+#include "UE5Coro/AsyncAwaiters.h"
+#include "UE5Coro/Scheduler.h"
+#include "UE5Coro/Threading.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Private::Test;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSchedulerTest, "UE5Coro.Scheduler",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSchedulerBenchmark, "UE5Coro.Scheduler.Benchmark",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::MediumPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+namespace
+{
+TCoroutine<> Hop(FScheduler& Scheduler, std::atomic<int>& NumOnScheduler,
+                 int NumYields)
+{
+	co_await Async::MoveToScheduler(Scheduler);
+	for (int i = 0; i < NumYields; ++i)
+		co_await Async::Yield();
+	if (Scheduler.IsInScheduler())
+		++NumOnScheduler;
+}
+
+TCoroutine<> Waiter(FScheduler& Scheduler, FAwaitableEvent& Event,
+                    std::atomic<int>& Step, int& Seen)
+{
+	co_await Async::MoveToScheduler(Scheduler);
+	co_await Event;
+	// Resumed from Trigger() on the same worker, get off its stack
+	co_await Async::MoveToScheduler(Scheduler);
+	Seen = Step.load();
+}
+
+TCoroutine<> Trigger(FScheduler& Scheduler, FAwaitableEvent& Event,
+                     std::atomic<int>& Step)
+{
+	co_await Async::MoveToScheduler(Scheduler);
+	Event.Trigger();
+	Step = 1;
+}
+
+TCoroutine<> PingPong(FScheduler& Scheduler, int Count)
+{
+	for (int i = 0; i < Count; ++i)
+		co_await Async::MoveToScheduler(Scheduler);
+}
+}
+
+bool FSchedulerTest::RunTest(const FString& Parameters)
+{
+	{
+		FScheduler Scheduler(4);
+		TestEqual(TEXT("Workers"), Scheduler.GetNumWorkers(), 4);
+		TestFalse(TEXT("Not in scheduler"), Scheduler.IsInScheduler());
+
+		std::atomic<int> NumOnScheduler = 0;
+		TArray<TCoroutine<>> Coros;
+		for (int i = 0; i < 1000; ++i)
+			Coros.Add(Hop(Scheduler, NumOnScheduler, 3));
+		for (auto& Coro : Coros)
+			TestTrue(TEXT("Completed"), Coro.Wait());
+		TestEqual(TEXT("Stayed on the scheduler"), NumOnScheduler.load(), 1000);
+		TestTrue(TEXT("Resumes counted"),
+		         Scheduler.GetStats().NumResumed >= 4000);
+	}
+
+	{
+		FScheduler Scheduler(1);
+		FAwaitableEvent Event;
+		std::atomic<int> Step = 0;
+		int Seen = -1;
+		auto A = Waiter(Scheduler, Event, Step, Seen);
+		// Let A reach the event on the only worker
+		while (Scheduler.GetStats().NumResumed < 1)
+			FPlatformProcess::Yield();
+		auto B = Trigger(Scheduler, Event, Step);
+		TestTrue(TEXT("Waiter done"), A.Wait());
+		TestTrue(TEXT("Trigger done"), B.Wait());
+		TestEqual(TEXT("Resumed after the triggering coroutine"), Seen, 1);
+		TestTrue(TEXT("LIFO slot used"),
+		         Scheduler.GetStats().NumFromLIFOSlot >= 1);
+	}
+
+	{
+		// Destroying the scheduler runs what's left
+		std::atomic<int> NumOnScheduler = 0;
+		TArray<TCoroutine<>> Coros;
+		{
+			FScheduler Scheduler(2);
+			for (int i = 0; i < 100; ++i)
+				Coros.Add(Hop(Scheduler, NumOnScheduler, 1));
+		}
+		for (auto& Coro : Coros)
+			TestTrue(TEXT("Drained"), Coro.IsDone());
+	}
+	return true;
+}
+
+bool FSchedulerBenchmark::RunTest(const FString& Parameters)
+{
+	constexpr int Count = 100000;
+	FScheduler Scheduler(1);
+	auto Coro = PingPong(Scheduler, 1);
+	Coro.Wait();
+
+	auto Start = FPlatformTime::Seconds();
+	Coro = PingPong(Scheduler, Count);
+	TestTrue(TEXT("Done"), Coro.Wait());
+	auto End = FPlatformTime::Seconds();
+	AddInfo(FString::Printf(TEXT("MoveToScheduler on the scheduler: %.1f ns/op"),
+	                        (End - Start) * 1e9 / Count));
+	return true;
+}
@@ -0,0 +1,141 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "TestWorld.h"
+#include "Misc/AutomationTest.h"
+#include "SocketSubsystem.h"
+#include "Sockets.h"
+#include "UE5Coro/AsyncAwaiters.h"
+#include "UE5Coro/SocketAwaiters.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Private::Test;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSocketAwaiterTest, "UE5Coro.Sockets",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+namespace
+{
+void Send(FSocket& Socket, const char* Data)
+{
+	int32 BytesSent = 0;
+	Socket.Send(reinterpret_cast<const uint8*>(Data),
+	            FCStringAnsi::Strlen(Data), BytesSent);
+}
+
+TCoroutine<bool> ReceiveInBackground(FSocket& Socket, TArray<uint8>& Buffer)
+{
+	co_await Async::MoveToThread(ENamedThreads::AnyBackgroundThreadNormalTask);
+	co_return co_await Sockets::ReceiveExactly(Socket, Buffer);
+}
+
+TCoroutine<> WaitInBackground(FSocket& Socket)
+{
+	co_await Async::MoveToThread(ENamedThreads::AnyBackgroundThreadNormalTask);
+	co_await Sockets::Readable(Socket);
+}
+
+TCoroutine<bool> IsWritable(FSocket& Socket)
+{
+	co_return co_await Sockets::Writable(Socket);
+}
+}
+
+bool FSocketAwaiterTest::RunTest(const FString& Parameters)
+{
+	auto* Subsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+	if (!TestNotNull(TEXT("Socket subsystem"), Subsystem))
+		return true;
+
+	// Connect two sockets to each other over loopback
+	FSocket* Listener = Subsystem->CreateSocket(NAME_Stream, TEXT("Listener"));
+	FSocket* Client = Subsystem->CreateSocket(NAME_Stream, TEXT("Client"));
+	FSocket* Server = nullptr;
+	ON_SCOPE_EXIT
+	{
+		for (auto* Socket : {Listener, Client, Server})
+			if (Socket)
+				Subsystem->DestroySocket(Socket);
+	};
+	auto Addr = Subsystem->CreateInternetAddr();
+	Addr->SetLoopbackAddress();
+	Addr->SetPort(0);
+	if (!TestTrue(TEXT("Listening"), Listener->Bind(*Addr) &&
+	                                 Listener->Listen(1)))
+		return true;
+	Listener->GetAddress(*Addr);
+	TestTrue(TEXT("Connected"), Client->Connect(*Addr));
+	Server = Listener->Accept(TEXT("Server"));
+	if (!TestNotNull(TEXT("Accepted"), Server))
+		return true;
+
+	{
+		auto Coro = IsWritable(*Client);
+		TestTrue(TEXT("Writable right away"), Coro.IsDone());
+		TestTrue(TEXT("Result"), Coro.GetResult());
+	}
+
+	{
+		TArray<uint8> Buffer;
+		Buffer.SetNumZeroed(4);
+		auto Coro = ReceiveInBackground(*Server, Buffer);
+		FPlatformProcess::Sleep(0.05f);
+		TestFalse(TEXT("Waiting for data"), Coro.IsDone());
+		Send(*Client, "ab");
+		FPlatformProcess::Sleep(0.05f);
+		TestFalse(TEXT("Waiting for the rest"), Coro.IsDone());
+		Send(*Client, "cd");
+		TestTrue(TEXT("Received"), Coro.Wait(5000));
+		TestTrue(TEXT("Buffer filled"), Coro.GetResult());
+		TestEqual(TEXT("Data"), FMemory::Memcmp(Buffer.GetData(), "abcd", 4),
+		          0);
+	}
+
+	{
+		auto Coro = WaitInBackground(*Server);
+		FPlatformProcess::Sleep(0.05f);
+		Coro.Cancel();
+		TestTrue(TEXT("Canceled"), Coro.Wait(5000));
+		TestFalse(TEXT("Not successful"), Coro.WasSuccessful());
+	}
+
+	{
+		TArray<uint8> Buffer;
+		Buffer.SetNumZeroed(4);
+		auto Coro = ReceiveInBackground(*Server, Buffer);
+		Subsystem->DestroySocket(std::exchange(Client, nullptr));
+		TestTrue(TEXT("Closed"), Coro.Wait(5000));
+		TestFalse(TEXT("Buffer not filled"), Coro.GetResult());
+	}
+	return true;
+}
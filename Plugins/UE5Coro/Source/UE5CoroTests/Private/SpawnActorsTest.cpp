@@ -0,0 +1,83 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "TestWorld.h"
+#include "Misc/AutomationTest.h"
+#include "GameFramework/Actor.h"
+#include "UE5Coro/LatentAwaiters.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Private::Test;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FSpawnActorsTest, "UE5Coro.SpawnActors",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+bool FSpawnActorsTest::RunTest(const FString& Parameters)
+{
+	FTestWorld World;
+	TArray<FTransform> Transforms;
+	for (int i = 0; i < 5; ++i)
+		Transforms.Emplace(FVector(i * 100, 0, 0));
+
+	{
+		// A zero budget still spawns one actor per frame
+		auto Coro = Latent::SpawnActorsAmortized(World.operator->(),
+		                                         AActor::StaticClass(),
+		                                         Transforms, 0);
+		TestFalse(TEXT("Not spawned immediately"), Coro.IsDone());
+		World.Tick();
+		TestFalse(TEXT("Spread over frames"), Coro.IsDone());
+		int Frames = 1;
+		FTestHelper::PumpGameThread(World, [&]
+		{
+			++Frames;
+			return Coro.IsDone();
+		});
+		TestTrue(TEXT("One actor per frame"), Frames >= Transforms.Num());
+		const auto& Actors = Coro.GetResult();
+		if (TestEqual(TEXT("Actors spawned"), Actors.Num(), Transforms.Num()))
+			for (auto* Actor : Actors)
+				TestNotNull(TEXT("Spawned"), Actor);
+	}
+
+	{
+		auto Coro = Latent::SpawnActorsAmortized(World.operator->(),
+		                                         AActor::StaticClass(),
+		                                         Transforms, 1000);
+		World.Tick();
+		TestTrue(TEXT("Everything fits in the budget"), Coro.IsDone());
+		TestEqual(TEXT("Actors spawned"), Coro.GetResult().Num(),
+		          Transforms.Num());
+	}
+	return true;
+}
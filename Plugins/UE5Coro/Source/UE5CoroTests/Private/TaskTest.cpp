@@ -117,6 +117,31 @@ void DoCreateTest(FAutomationTestBase& Test)
 		TestToCoro->Trigger();
 		Test.TestTrue(TEXT("Triggered"), CoroToTest->Wait());
 	}
+
+	{
+		constexpr int Num = 16;
+		UE::Tasks::FPipe Pipe(UE_SOURCE_LOCATION);
+		FEventRef CoroToTest;
+		int Counter = 0; // Not atomic, the pipe serializes access
+		std::atomic<int> Done = 0;
+		std::atomic<bool> bOutsidePipe = false;
+		for (int i = 0; i < Num; ++i)
+			World.Run(CORO
+			{
+				co_await Tasks::MoveToPipe(Pipe, TEXT("Piped"),
+				                           UE::Tasks::ETaskPriority::High);
+				if (!Pipe.IsInContext())
+					bOutsidePipe = true;
+				for (int j = 0; j < 1000; ++j)
+					++Counter;
+				if (++Done == Num)
+					CoroToTest->Trigger();
+			});
+		Test.TestTrue(TEXT("Triggered"), CoroToTest->Wait());
+		Test.TestFalse(TEXT("Resumed in the pipe"), bOutsidePipe.load());
+		Test.TestEqual(TEXT("Serialized"), Counter, Num * 1000);
+		Pipe.WaitUntilEmpty();
+	}
 }
 
 template<typename... T>
@@ -164,6 +189,29 @@ void DoConsumeTest(FAutomationTestBase& Test)
 		Test.TestEqual(TEXT("Final state"), State, 2);
 		Test.TestEqual(TEXT("Return value"), Retval, 3);
 	}
+
+	{
+		FEventRef TestToCoro(EEventMode::ManualReset);
+		FEventRef CoroToTest(EEventMode::AutoReset);
+		std::atomic<int> State = 0;
+		TArray<UE::Tasks::FTask> Work;
+		for (int i = 0; i < 4; ++i)
+			Work.Add(UE::Tasks::Launch(UE_SOURCE_LOCATION, [&]
+			{
+				TestToCoro->Wait();
+				++State;
+			}));
+		World.Run(CORO
+		{
+			co_await Tasks::WhenAll(Work);
+			State += 10;
+			CoroToTest->Trigger();
+		});
+		Test.TestEqual(TEXT("Initial state"), State.load(), 0);
+		TestToCoro->Trigger();
+		CoroToTest->Wait();
+		Test.TestEqual(TEXT("Final state"), State.load(), 14);
+	}
 }
 }
 
@@ -55,6 +55,8 @@ public:
 	FUE5CoroTestSparseDelegate SparseDelegate;
 	UPROPERTY(BlueprintAssignable)
 	FUE5CoroTestSparseParamsDelegate SparseParamsDelegate;
+	UPROPERTY()
+	FLinearColor Color;
 
 	std::function<void()> Callback;
 
@@ -39,6 +39,8 @@ public class UE5CoroTests : UE5CoroModuleRules
 		PublicDependencyModuleNames.AddRange(new[]
 		{
 			"HTTP",
+			"RenderCore",
+			"Sockets",
 			"UE5Coro",
 		});
 	}
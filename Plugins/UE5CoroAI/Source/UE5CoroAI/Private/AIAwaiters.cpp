@@ -31,8 +31,11 @@
 
 #include "UE5CoroAI/AIAwaiters.h"
 #include "AIController.h"
+#include "EnvironmentQuery/EnvQueryManager.h"
 #include "NavigationSystem.h"
+#include "Misc/TVariant.h"
 #include "UE5CoroAICallbackTarget.h"
+#include "UE5Coro/UE5CoroSubsystem.h"
 
 using namespace UE5Coro;
 using namespace UE5Coro::AI;
@@ -59,7 +62,8 @@ bool ShouldResumeFindPath(void* State, bool bCleanup)
 		if (auto* NS1 = (*This)->NS1.Get();
 		    NS1 && (*This)->QueryID != INVALID_NAVQUERYID)
 			NS1->AbortAsyncFindPathRequest((*This)->QueryID);
-		delete This;
+		FLatentAwaiter::DestroyState<FFindPathSharedPtr>(State);
+		return false;
 	}
 
 	return (*This)->QueryID == INVALID_NAVQUERYID;
@@ -70,13 +74,22 @@ bool ShouldResumeMoveTo(void* State, bool bCleanup)
 	auto* Target = static_cast<TStrongObjectPtr<UUE5CoroAICallbackTarget>*>(State);
 	if (UNLIKELY(bCleanup))
 	{
-		delete Target;
+		(*Target)->UnbindReady();
+		FLatentAwaiter::DestroyState<
+			TStrongObjectPtr<UUE5CoroAICallbackTarget>>(State);
 		return false;
 	}
 
 	return (*Target)->GetResult().has_value();
 }
 
+bool BindMoveTo(void* State, UUE5CoroSubsystem& Sys, FAsyncPromise& Promise)
+{
+	auto* Target = static_cast<TStrongObjectPtr<UUE5CoroAICallbackTarget>*>(State);
+	(*Target)->BindReady(Sys, Promise);
+	return true;
+}
+
 constexpr bool IsValid(const FVector&)
 {
 	return true;
@@ -113,8 +126,50 @@ FMoveToAwaiter AIMoveToCore(AAIController* Controller, TGoal auto Target,
 		bUseContinuousGoalTracking, ProjectGoalOnNavigation));
 }
 
-FSimpleMoveToAwaiter SimpleMoveToCore(AController* Controller, TGoal auto Target)
+/** Path following components of non-AI controllers, which would otherwise be
+ *  looked up every time. Stale entries are pruned as this grows. */
+TMap<TWeakObjectPtr<AController>, TWeakObjectPtr<UPathFollowingComponent>>
+	PathFollowCache; // Game thread only
+int32 PathFollowCachePruneAt = 64;
+
+UPathFollowingComponent* GetPathFollowing(AController* Controller)
 {
+	if (auto* AIC = Cast<AAIController>(Controller); IsValid(AIC))
+		return AIC->GetPathFollowingComponent();
+
+	if (auto* Cached = PathFollowCache.Find(Controller))
+		if (auto* PathFollow = Cached->Get())
+			return PathFollow;
+
+	// This recreates InitNavigationControl's component injection
+	auto* PathFollow =
+		Controller->FindComponentByClass<UPathFollowingComponent>();
+	if (!IsValid(PathFollow))
+	{
+		PathFollow = NewObject<UPathFollowingComponent>(Controller);
+		PathFollow->RegisterComponentWithWorld(Controller->GetWorld());
+		// The original does not call AddInstanceComponent
+		PathFollow->Initialize();
+	}
+
+	if (PathFollowCache.Num() >= PathFollowCachePruneAt)
+	{
+		for (auto It = PathFollowCache.CreateIterator(); It; ++It)
+			if (!It.Key().IsValid() || !It.Value().IsValid())
+				It.RemoveCurrent();
+		PathFollowCachePruneAt = FMath::Max(64, PathFollowCache.Num() * 2);
+	}
+	PathFollowCache.Add(Controller, PathFollow);
+	return PathFollow;
+}
+
+/** Everything in SimpleMoveTo before the path query.
+ *  @return The query to run, or an early result. */
+auto BeginSimpleMove(AController* Controller, TGoal auto Target,
+                     UPathFollowingComponent*& PathFollow, FVector& To)
+	-> TVariant<FPathFindingQuery, EPathFollowingResult::Type>
+{
+	using FReturn = TVariant<FPathFindingQuery, EPathFollowingResult::Type>;
 	checkf(IsInGameThread(),
 	       TEXT("This method may only be called from the game thread"));
 	checkf(IsValid(Controller), TEXT("Attempting to move invalid controller"));
@@ -126,28 +181,14 @@ FSimpleMoveToAwaiter SimpleMoveToCore(AController* Controller, TGoal auto Target
 	auto* NS1 = FNavigationSystem::GetCurrent<UNavigationSystemV1>(World);
 	checkf(IsValid(NS1), TEXT("Cannot perform move without navigation system"));
 
-	// This recreates InitNavigationControl's component injection
-	UPathFollowingComponent* PathFollow;
-	if (auto* AIC = Cast<AAIController>(Controller); IsValid(AIC))
-		PathFollow = AIC->GetPathFollowingComponent();
-	else
-	{
-		PathFollow = Controller->FindComponentByClass<UPathFollowingComponent>();
-		if (!IsValid(PathFollow))
-		{
-			PathFollow = NewObject<UPathFollowingComponent>(Controller);
-			PathFollow->RegisterComponentWithWorld(Controller->GetWorld());
-			// The original does not call AddInstanceComponent
-			PathFollow->Initialize();
-		}
-	}
+	PathFollow = GetPathFollowing(Controller);
 
 	// Fail instantly if the PFC can't be used
 	if (!IsValid(PathFollow) || !PathFollow->IsPathFollowingAllowed())
-		return FSimpleMoveToAwaiter(EPathFollowingResult::Invalid);
+		return FReturn(TInPlaceType<EPathFollowingResult::Type>(),
+		               EPathFollowingResult::Invalid);
 
 	FVector From = Controller->GetNavAgentLocation();
-	FVector To;
 	if constexpr (std::convertible_to<decltype(Target), AActor*>)
 		To = Target->GetActorLocation();
 	else
@@ -168,24 +209,32 @@ FSimpleMoveToAwaiter SimpleMoveToCore(AController* Controller, TGoal auto Target
 	ANavigationData* NavData = NS1->GetNavDataForProps(
 		Controller->GetNavAgentPropertiesRef(), From);
 	if (!IsValid(NavData))
-		return FSimpleMoveToAwaiter(EPathFollowingResult::Invalid);
+		return FReturn(TInPlaceType<EPathFollowingResult::Type>(),
+		               EPathFollowingResult::Invalid);
 
 	if (bAlreadyThere)
 	{
 		PathFollow->RequestMoveWithImmediateFinish(EPathFollowingResult::Success);
-		return FSimpleMoveToAwaiter(EPathFollowingResult::Success);
+		return FReturn(TInPlaceType<EPathFollowingResult::Type>(),
+		               EPathFollowingResult::Success);
 	}
 
-	FPathFindingQuery Query(Controller, *NavData, From, To);
-	// Not calling FindPathAsync to match the original
-	FPathFindingResult Result = NS1->FindPathSync(Query);
-	if (Result.IsSuccessful())
+	return FReturn(TInPlaceType<FPathFindingQuery>(), Controller, *NavData,
+	               From, To);
+}
+
+/** Everything in SimpleMoveTo after the path query. Path is null if the query
+ *  failed. */
+FSimpleMoveToAwaiter FinishSimpleMove(UPathFollowingComponent* PathFollow,
+                                      TGoal auto Target, const FVector& To,
+                                      FNavPathSharedPtr Path)
+{
+	if (Path)
 	{
 		if constexpr (std::convertible_to<decltype(Target), AActor*>)
 			// Matching the hardcoded constant from UAIBlueprintHelperLibrary
-			Result.Path->SetGoalActorObservation(*Target, 100);
-		FAIRequestID ID = PathFollow->RequestMove(FAIMoveRequest(To),
-		                                          Result.Path);
+			Path->SetGoalActorObservation(*Target, 100);
+		FAIRequestID ID = PathFollow->RequestMove(FAIMoveRequest(To), Path);
 
 		// The interesting case
 		return FSimpleMoveToAwaiter(PathFollow, ID);
@@ -199,10 +248,60 @@ FSimpleMoveToAwaiter SimpleMoveToCore(AController* Controller, TGoal auto Target
 
 	return FSimpleMoveToAwaiter(EPathFollowingResult::Invalid);
 }
+
+FSimpleMoveToAwaiter SimpleMoveToCore(AController* Controller, TGoal auto Target)
+{
+	UPathFollowingComponent* PathFollow;
+	FVector To;
+	auto Begin = BeginSimpleMove(Controller, Target, PathFollow, To);
+	if (auto* Early = Begin.TryGet<EPathFollowingResult::Type>())
+		return FSimpleMoveToAwaiter(*Early);
+
+	auto* NS1 = FNavigationSystem::GetCurrent<UNavigationSystemV1>(
+		Controller->GetWorld());
+	// Not calling FindPathAsync to match the original
+	FPathFindingResult Result =
+		NS1->FindPathSync(Begin.Get<FPathFindingQuery>());
+	return FinishSimpleMove(PathFollow, Target, To,
+	                        Result.IsSuccessful() ? Result.Path : nullptr);
+}
+
+template<TGoal T>
+TCoroutine<FPathFollowingResult> SimpleMoveToAsyncCore(AController* Controller,
+                                                       T Target)
+{
+	UPathFollowingComponent* PathFollow;
+	FVector To;
+	auto Begin = BeginSimpleMove(Controller, Target, PathFollow, To);
+	if (auto* Early = Begin.TryGet<EPathFollowingResult::Type>())
+		co_return co_await FSimpleMoveToAwaiter(*Early);
+
+	// Only the pathfinding is asynchronous, everything here is game thread
+	TWeakObjectPtr<UPathFollowingComponent> WeakPathFollow = PathFollow;
+	std::conditional_t<std::is_pointer_v<T>, TWeakObjectPtr<AActor>, FVector>
+		WeakTarget = Target;
+	auto [Result, Path] = (co_await FindPathsBatch(
+		Controller, {Begin.Get<FPathFindingQuery>()}))[0];
+
+	PathFollow = WeakPathFollow.Get();
+	if constexpr (std::is_pointer_v<T>)
+		Target = WeakTarget.Get();
+	else
+		Target = WeakTarget;
+	if (!PathFollow || !IsValid(Target))
+		co_return co_await FSimpleMoveToAwaiter(EPathFollowingResult::Invalid);
+	if (Result != ENavigationQueryResult::Success)
+		Path = nullptr;
+	co_return co_await FinishSimpleMove(PathFollow, Target, To,
+	                                    std::move(Path));
+}
 }
 
+// The state type is private to this file, the parameter is moved from
 FPathFindingAwaiter::FPathFindingAwaiter(void* State)
-	: FLatentAwaiter(State, &ShouldResumeFindPath)
+	: FLatentAwaiter(std::in_place_type<FFindPathSharedPtr>,
+	                 &ShouldResumeFindPath,
+	                 std::move(*static_cast<FFindPathSharedPtr*>(State)))
 {
 }
 
@@ -215,10 +314,156 @@ auto FPathFindingAwaiter::await_resume()
 	return (*This)->Result;
 }
 
+struct FPathFindingBatchAwaiter::FState
+{
+	TWeakObjectPtr<UNavigationSystemV1> NS1;
+	TArray<uint32> QueryIDs; // INVALID_NAVQUERYID if finished
+	TArray<FResult> Results;
+	int32 NumRemaining = 0; // Until the awaiter is ready
+	FPromise* Promise = nullptr;
+
+	~FState() { AbortRunning(); }
+
+	void AbortRunning()
+	{
+		auto* System = NS1.Get();
+		for (uint32& QueryID : QueryIDs)
+			if (std::exchange(QueryID, INVALID_NAVQUERYID) != INVALID_NAVQUERYID
+			    && System)
+				System->AbortAsyncFindPathRequest(QueryID);
+	}
+
+	void Finished(uint32 QueryID, ENavigationQueryResult::Type Result,
+	              FNavPathSharedPtr Path, int32 Index)
+	{
+		if (QueryIDs[Index] != QueryID) // Aborted while the result was queued
+			return;
+		QueryIDs[Index] = INVALID_NAVQUERYID;
+		Results[Index] = {Result, std::move(Path)};
+		if (--NumRemaining != 0)
+			return;
+
+		AbortRunning(); // Not interested in the rest
+		if (Promise)
+			std::exchange(Promise, nullptr)->Resume();
+	}
+};
+
+FPathFindingBatchAwaiter::FPathFindingBatchAwaiter(
+	TSharedPtr<FState, ESPMode::NotThreadSafe> State)
+	: State(std::move(State))
+{
+}
+
+bool FPathFindingBatchAwaiter::await_ready()
+{
+	checkf(IsInGameThread(),
+	       TEXT("Pathfinding may only be awaited on the game thread"));
+	checkf(State, TEXT("Attempting to use invalid awaiter"));
+	return State->NumRemaining <= 0;
+}
+
+void FPathFindingBatchAwaiter::Suspend(FPromise& Promise)
+{
+	checkf(!State->Promise, TEXT("Attempted second concurrent co_await"));
+	State->Promise = &Promise;
+}
+
+auto FPathFindingBatchAwaiter::await_resume() -> const TArray<FResult>&
+{
+	checkf(State->NumRemaining <= 0, TEXT("Internal error: spurious resume"));
+	return State->Results;
+}
+
+struct FEQSQueryAwaiterBase::FState
+{
+	TWeakObjectPtr<UEnvQueryManager> Manager;
+	TArray<int32> QueryIDs; // INDEX_NONE if finished or never started
+	TArray<AI::FEQSResult> Results;
+	int32 NumRemaining = 0; // Until the awaiter is ready
+	FPromise* Promise = nullptr;
+
+	~FState()
+	{
+		// The delegates can't reach this object anymore
+		auto* System = Manager.Get();
+		for (int32 QueryID : QueryIDs)
+			if (QueryID != INDEX_NONE && System)
+				System->AbortQuery(QueryID);
+	}
+
+	void Start(UEnvQueryManager* System, const FEnvQueryRequest& Request,
+	           EEnvQueryRunMode::Type RunMode, int32 Index,
+	           const TSharedRef<FState, ESPMode::NotThreadSafe>& Self)
+	{
+		int32 QueryID = System->RunQuery(
+			Request, RunMode,
+			FQueryFinishedSignature::CreateSP(Self, &FState::Finished, Index));
+		if (QueryID != INDEX_NONE)
+			QueryIDs[Index] = QueryID;
+		else
+			--NumRemaining; // Failed to start, it's never going to finish
+	}
+
+	void Finished(TSharedPtr<FEnvQueryResult> Query, int32 Index)
+	{
+		if (std::exchange(QueryIDs[Index], INDEX_NONE) == INDEX_NONE)
+			return;
+
+		// Copy everything out of the raw data while it's still there
+		auto& Result = Results[Index];
+		if (Query)
+		{
+			Result.Status = Query->GetRawStatus();
+			Result.Items.Reserve(Query->Items.Num());
+			for (int32 i = 0; i < Query->Items.Num(); ++i)
+				Result.Items.Add({.Location = Query->GetItemAsLocation(i),
+				                  .Actor = Query->GetItemAsActor(i),
+				                  .Score = Query->GetItemScore(i)});
+		}
+
+		if (--NumRemaining == 0 && Promise)
+			std::exchange(Promise, nullptr)->Resume();
+	}
+};
+
+FEQSQueryAwaiterBase::FEQSQueryAwaiterBase(
+	TSharedPtr<FState, ESPMode::NotThreadSafe> State)
+	: State(std::move(State))
+{
+}
+
+bool FEQSQueryAwaiterBase::await_ready()
+{
+	checkf(IsInGameThread(),
+	       TEXT("EQS queries may only be awaited on the game thread"));
+	checkf(State, TEXT("Attempting to use invalid awaiter"));
+	return State->NumRemaining <= 0;
+}
+
+void FEQSQueryAwaiterBase::Suspend(FPromise& Promise)
+{
+	checkf(!State->Promise, TEXT("Attempted second concurrent co_await"));
+	State->Promise = &Promise;
+}
+
+AI::FEQSResult FEQSQueryAwaiter::await_resume()
+{
+	checkf(State->NumRemaining <= 0, TEXT("Internal error: spurious resume"));
+	return std::move(State->Results[0]);
+}
+
+auto FEQSQueryBatchAwaiter::await_resume() -> const TArray<AI::FEQSResult>&
+{
+	checkf(State->NumRemaining <= 0, TEXT("Internal error: spurious resume"));
+	return State->Results;
+}
 
 FMoveToAwaiter::FMoveToAwaiter(UAITask_MoveTo* Task)
-	: FLatentAwaiter(new TStrongObjectPtr(NewObject<UUE5CoroAICallbackTarget>()
-	                                      ->SetTask(Task)), &ShouldResumeMoveTo)
+	: FLatentAwaiter(std::in_place_type<
+	                     TStrongObjectPtr<UUE5CoroAICallbackTarget>>,
+	                 &ShouldResumeMoveTo,
+	                 NewObject<UUE5CoroAICallbackTarget>()->SetTask(Task))
 {
 }
 
@@ -230,11 +475,51 @@ EPathFollowingResult::Type FMoveToAwaiter::await_resume() noexcept
 	return *(*Target)->GetResult();
 }
 
+namespace UE5Coro::Private
+{
+/** Lets the subsystem resume async coroutines from the AI callbacks. */
+struct FAIReadyCallbacks
+{
+	FAIReadyCallbacks()
+	{
+		FLatentReadyCallback::Register(&ShouldResumeMoveTo, &BindMoveTo);
+		FLatentReadyCallback::Register(&FSimpleMoveToAwaiter::ShouldResume,
+		                               &FSimpleMoveToAwaiter::BindReady);
+	}
+
+	~FAIReadyCallbacks()
+	{
+		FLatentReadyCallback::Unregister(&ShouldResumeMoveTo);
+		FLatentReadyCallback::Unregister(&FSimpleMoveToAwaiter::ShouldResume);
+	}
+};
+}
+
+namespace
+{
+FAIReadyCallbacks GAIReadyCallbacks;
+}
+
 void FSimpleMoveToAwaiter::FComplexData::RequestFinished(
 	FAIRequestID InID, const FPathFollowingResult& InResult)
 {
-	if (RequestID == InID)
-		Result = InResult;
+	if (RequestID != InID)
+		return;
+	Result = InResult;
+	if (auto* Sys = Subsystem.Get(); Sys && Promise)
+		Sys->ResumeReady(*std::exchange(Promise, nullptr));
+}
+
+bool FSimpleMoveToAwaiter::BindReady(void* State, UUE5CoroSubsystem& Sys,
+                                     FAsyncPromise& Promise)
+{
+	auto* Data = static_cast<FComplexData*>(State);
+	checkf(!Data->Result.has_value(),
+	       TEXT("Internal error: binding a finished move"));
+	checkf(!Data->Promise, TEXT("Attempted second concurrent co_await"));
+	Data->Subsystem = &Sys;
+	Data->Promise = &Promise;
+	return true;
 }
 
 bool FSimpleMoveToAwaiter::ShouldResume(void* State, bool bCleanup)
@@ -280,6 +565,7 @@ FPathFindingAwaiter AI::FindPath(UObject* WorldContextObject,
 	auto* World = WorldContextObject->GetWorld();
 	checkf(IsValid(World), TEXT("Invalid world from WCO"));
 	auto* NS1 = CastChecked<UNavigationSystemV1>(World->GetNavigationSystem());
+	LLM_SCOPE_BYTAG(UE5Coro_AwaiterState);
 	auto State = MakeShared<FFindPathState, ESPMode::NotThreadSafe>();
 	auto Delegate = FNavPathQueryDelegate::CreateLambda(
 		[State](uint32 QueryID, ENavigationQueryResult::Type Result,
@@ -293,7 +579,101 @@ FPathFindingAwaiter AI::FindPath(UObject* WorldContextObject,
 	State->NS1 = NS1;
 	State->QueryID = NS1->FindPathAsync(Query.NavAgentProperties, Query,
 	                                    Delegate, Mode);
-	return FPathFindingAwaiter(new FFindPathSharedPtr(std::move(State)));
+	return FPathFindingAwaiter(&State);
+}
+
+FPathFindingBatchAwaiter AI::FindPathsBatch(
+	UObject* WorldContextObject, TArrayView<const FPathFindingQuery> Queries,
+	EPathFindingMode::Type Mode, int32 NumRequired)
+{
+	checkf(IsInGameThread(),
+	       TEXT("This method may only be called from the game thread"));
+	checkf(IsValid(WorldContextObject), TEXT("Invalid WCO supplied"));
+	auto* World = WorldContextObject->GetWorld();
+	checkf(IsValid(World), TEXT("Invalid world from WCO"));
+	auto* NS1 = CastChecked<UNavigationSystemV1>(World->GetNavigationSystem());
+
+	using FState = FPathFindingBatchAwaiter::FState;
+	auto State = MakeShared<FState, ESPMode::NotThreadSafe>();
+	State->NS1 = NS1;
+	State->QueryIDs.Init(INVALID_NAVQUERYID, Queries.Num());
+	State->Results.Init({ENavigationQueryResult::Invalid, nullptr},
+	                    Queries.Num());
+	State->NumRemaining = NumRequired < 0
+		? Queries.Num() : FMath::Min(NumRequired, Queries.Num());
+	if (State->NumRemaining == 0)
+		return FPathFindingBatchAwaiter(std::move(State));
+
+	// The delegates don't keep the state alive, destroying the awaiter aborts
+	// every query that's still running
+	for (int32 i = 0; i < Queries.Num(); ++i)
+	{
+		uint32 QueryID = NS1->FindPathAsync(
+			Queries[i].NavAgentProperties, Queries[i],
+			FNavPathQueryDelegate::CreateSP(State, &FState::Finished, i),
+			Mode);
+		if (QueryID != INVALID_NAVQUERYID)
+			State->QueryIDs[i] = QueryID;
+		// The delegate will never fire, this counts as an Invalid result
+		else if (--State->NumRemaining == 0)
+		{
+			State->AbortRunning(); // Not interested in the rest
+			break;
+		}
+	}
+	return FPathFindingBatchAwaiter(std::move(State));
+}
+
+namespace
+{
+auto StartEQS(UObject* Querier, int32 Num)
+{
+	checkf(IsInGameThread(),
+	       TEXT("This method may only be called from the game thread"));
+	checkf(IsValid(Querier), TEXT("Invalid querier supplied"));
+	auto* System = UEnvQueryManager::GetCurrent(Querier);
+	checkf(IsValid(System), TEXT("Cannot run queries without EQS"));
+
+	using FState = FEQSQueryAwaiterBase::FState;
+	LLM_SCOPE_BYTAG(UE5Coro_AwaiterState);
+	auto State = MakeShared<FState, ESPMode::NotThreadSafe>();
+	State->Manager = System;
+	State->QueryIDs.Init(INDEX_NONE, Num);
+	State->Results.SetNum(Num);
+	State->NumRemaining = Num;
+	return TTuple<UEnvQueryManager*, TSharedRef<FState, ESPMode::NotThreadSafe>>(
+		System, std::move(State));
+}
+}
+
+FEQSQueryAwaiter AI::RunEQSQuery(const FEnvQueryRequest& Request,
+                                 UObject* Querier,
+                                 EEnvQueryRunMode::Type RunMode)
+{
+	auto [System, State] = StartEQS(Querier, 1);
+	State->Start(System, Request, RunMode, 0, State);
+	return FEQSQueryAwaiter(std::move(State));
+}
+
+FEQSQueryAwaiter AI::RunEQSQuery(UEnvQuery* Query, UObject* Querier,
+                                 EEnvQueryRunMode::Type RunMode)
+{
+	return RunEQSQuery(FEnvQueryRequest(Query, Querier), Querier, RunMode);
+}
+
+FEQSQueryBatchAwaiter AI::RunEQSQueriesBatch(
+	UEnvQuery* Query, TArrayView<UObject* const> Queriers,
+	EEnvQueryRunMode::Type RunMode)
+{
+	checkf(Queriers.Num() > 0, TEXT("Running a batch without queriers"));
+	auto [System, State] = StartEQS(Queriers[0], Queriers.Num());
+	for (int32 i = 0; i < Queriers.Num(); ++i)
+	{
+		checkf(IsValid(Queriers[i]), TEXT("Invalid querier supplied"));
+		State->Start(System, FEnvQueryRequest(Query, Queriers[i]), RunMode, i,
+		             State);
+	}
+	return FEQSQueryBatchAwaiter(std::move(State));
 }
 
 FMoveToAwaiter AI::AIMoveTo(AAIController* Controller, FVector Target,
@@ -331,3 +711,15 @@ FSimpleMoveToAwaiter AI::SimpleMoveTo(AController* Controller, AActor* Target)
 {
 	return SimpleMoveToCore(Controller, Target);
 }
+
+TCoroutine<FPathFollowingResult> AI::SimpleMoveToAsync(AController* Controller,
+                                                       FVector Target)
+{
+	return SimpleMoveToAsyncCore(Controller, Target);
+}
+
+TCoroutine<FPathFollowingResult> AI::SimpleMoveToAsync(AController* Controller,
+                                                       AActor* Target)
+{
+	return SimpleMoveToAsyncCore(Controller, Target);
+}
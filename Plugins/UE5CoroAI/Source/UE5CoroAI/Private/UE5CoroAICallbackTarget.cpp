@@ -31,6 +31,9 @@
 
 #include "UE5CoroAICallbackTarget.h"
 #include "Tasks/AITask_MoveTo.h"
+#include "UObject/UObjectGlobals.h"
+
+using namespace UE5Coro::Private;
 
 auto UUE5CoroAICallbackTarget::SetTask(UAITask_MoveTo* InTask) -> ThisClass*
 {
@@ -63,10 +66,48 @@ auto UUE5CoroAICallbackTarget::GetResult() const
 	return Result;
 }
 
+void UUE5CoroAICallbackTarget::BindReady(UUE5CoroSubsystem& Sys,
+                                         FAsyncPromise& InPromise)
+{
+	checkf(!GetResult().has_value(),
+	       TEXT("Internal error: binding a finished AI callback"));
+	checkf(!Promise, TEXT("Attempted second concurrent co_await"));
+	Subsystem = &Sys;
+	Promise = &InPromise;
+	// The task might end without broadcasting its delegates, this is detected
+	// by it going stale, which can only happen during GC
+	GCHandle = FCoreUObjectDelegates::GetPostGarbageCollect().AddUObject(
+		this, &ThisClass::PostGarbageCollect);
+}
+
+void UUE5CoroAICallbackTarget::UnbindReady()
+{
+	Promise = nullptr;
+	FCoreUObjectDelegates::GetPostGarbageCollect().Remove(GCHandle);
+	GCHandle.Reset();
+}
+
+void UUE5CoroAICallbackTarget::NotifyReady()
+{
+	if (!Promise)
+		return;
+	auto* Waiting = Promise;
+	UnbindReady();
+	if (auto* Sys = Subsystem.Get())
+		Sys->ResumeReady(*Waiting);
+}
+
+void UUE5CoroAICallbackTarget::PostGarbageCollect()
+{
+	if (GetResult().has_value())
+		NotifyReady();
+}
+
 void UUE5CoroAICallbackTarget::Core(
 	TEnumAsByte<EPathFollowingResult::Type> InResult, AAIController*)
 {
 	Result = InResult;
+	NotifyReady();
 }
 
 void UUE5CoroAICallbackTarget::Error()
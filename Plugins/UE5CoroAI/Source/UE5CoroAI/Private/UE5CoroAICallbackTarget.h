@@ -35,6 +35,7 @@
 #include "UE5Coro/Definitions.h"
 #include <optional>
 #include "Navigation/PathFollowingComponent.h"
+#include "UE5Coro/UE5CoroSubsystem.h"
 #include "UE5CoroAICallbackTarget.generated.h"
 
 UCLASS(Hidden)
@@ -44,12 +45,23 @@ class UUE5CoroAICallbackTarget : public UObject
 
 	TWeakObjectPtr<class UAITask_MoveTo> Task = nullptr;
 	std::optional<EPathFollowingResult::Type> Result;
+	TWeakObjectPtr<UUE5CoroSubsystem> Subsystem; // Set if not polled
+	UE5Coro::Private::FAsyncPromise* Promise = nullptr;
+	FDelegateHandle GCHandle;
 
 public:
 	ThisClass* SetTask(UAITask_MoveTo*);
 	std::optional<EPathFollowingResult::Type> GetResult() const;
 
+	/** Calls ResumeReady on the subsystem when a result becomes available,
+	 *  instead of waiting for GetResult() to be polled. */
+	void BindReady(UUE5CoroSubsystem&, UE5Coro::Private::FAsyncPromise&);
+	void UnbindReady();
+
 private:
+	void NotifyReady();
+	void PostGarbageCollect();
+
 	UFUNCTION()
 	void Core(TEnumAsByte<EPathFollowingResult::Type> Result,
 	          AAIController* AIController);
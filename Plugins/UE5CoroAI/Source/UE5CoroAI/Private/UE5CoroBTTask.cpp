@@ -0,0 +1,140 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "UE5CoroAI/UE5CoroBTTask.h"
+#include "BehaviorTree/BehaviorTreeComponent.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Private;
+
+namespace
+{
+struct FBTTaskMemory
+{
+	TOptional<TCoroutine<bool>> Coroutine;
+	/** Shared with the coroutine's continuation, cleared if this execution
+	 *  should no longer finish the task. */
+	TSharedPtr<bool> bActive;
+};
+
+// Node memory is not guaranteed to be aligned for shared pointers
+FBTTaskMemory& GetMemory(uint8* NodeMemory)
+{
+	return *static_cast<FBTTaskMemory*>(Align(NodeMemory,
+	                                          alignof(FBTTaskMemory)));
+}
+
+void Release(FBTTaskMemory& Memory)
+{
+	if (Memory.bActive)
+		*Memory.bActive = false;
+	Memory.bActive = nullptr;
+	if (Memory.Coroutine)
+		Memory.Coroutine->Cancel();
+	Memory.Coroutine.Reset();
+}
+}
+
+UUE5CoroBTTask::UUE5CoroBTTask()
+{
+	// Completion is driven by the coroutine, there's nothing to tick
+	bNotifyTick = false;
+	bCreateNodeInstance = false;
+}
+
+EBTNodeResult::Type UUE5CoroBTTask::ExecuteTask(
+	UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
+{
+	checkf(IsInGameThread(),
+	       TEXT("Behavior tree tasks may only execute on the game thread"));
+	auto& Memory = GetMemory(NodeMemory);
+	ensureMsgf(!Memory.Coroutine, TEXT("Multiple overlapping executions"));
+	Release(Memory);
+
+	auto Coroutine = Execute(OwnerComp, NodeMemory);
+	if (Coroutine.IsDone()) // Completed synchronously?
+		return Coroutine.WasSuccessful() && Coroutine.GetResult()
+		       ? EBTNodeResult::Succeeded : EBTNodeResult::Failed;
+
+	auto bActive = MakeShared<bool>(true);
+	Memory.Coroutine = Coroutine;
+	Memory.bActive = bActive;
+	// Cancellations complete with false
+	Coroutine.ContinueWithOn(ENamedThreads::GameThread,
+	                         [this, WeakThis = TWeakObjectPtr<ThisClass>(this),
+	                          Comp = TWeakObjectPtr<UBehaviorTreeComponent>(
+	                              &OwnerComp),
+	                          bActive = std::move(bActive),
+	                          NodeMemory](bool bResult)
+	{
+		// Aborted, or the memory was released: this execution is stale
+		if (!*bActive || !WeakThis.IsValid() || !Comp.IsValid())
+			return;
+		Release(GetMemory(NodeMemory));
+		FinishLatentTask(*Comp, bResult ? EBTNodeResult::Succeeded
+		                                : EBTNodeResult::Failed);
+	});
+	return EBTNodeResult::InProgress;
+}
+
+EBTNodeResult::Type UUE5CoroBTTask::AbortTask(UBehaviorTreeComponent&,
+                                              uint8* NodeMemory)
+{
+	// The coroutine might not finish its cancellation synchronously, it will
+	// no longer be able to finish this task
+	Release(GetMemory(NodeMemory));
+	return EBTNodeResult::Aborted;
+}
+
+uint16 UUE5CoroBTTask::GetInstanceMemorySize() const
+{
+	return sizeof(FBTTaskMemory) + alignof(FBTTaskMemory) - 1;
+}
+
+void UUE5CoroBTTask::InitializeMemory(UBehaviorTreeComponent& OwnerComp,
+                                      uint8* NodeMemory,
+                                      EBTMemoryInit::Type InitType) const
+{
+	Super::InitializeMemory(OwnerComp, NodeMemory, InitType);
+	new (&GetMemory(NodeMemory)) FBTTaskMemory;
+}
+
+void UUE5CoroBTTask::CleanupMemory(UBehaviorTreeComponent& OwnerComp,
+                                   uint8* NodeMemory,
+                                   EBTMemoryClear::Type CleanupType) const
+{
+	// Stored subtrees are initialized again when they're restored
+	auto& Memory = GetMemory(NodeMemory);
+	Release(Memory);
+	Memory.~FBTTaskMemory();
+	Super::CleanupMemory(OwnerComp, NodeMemory, CleanupType);
+}
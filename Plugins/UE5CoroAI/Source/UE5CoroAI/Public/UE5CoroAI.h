@@ -33,3 +33,4 @@
 
 #include "UE5Coro/Definitions.h"
 #include "UE5CoroAI/AIAwaiters.h"
+#include "UE5CoroAI/UE5CoroBTTask.h"
@@ -38,18 +38,70 @@
 #endif
 #include <optional>
 #include "AITypes.h"
+#include "EnvironmentQuery/EnvQueryTypes.h"
 #include "Tasks/AITask_MoveTo.h"
 #include "UE5Coro/LatentAwaiters.h"
 
+class UEnvQuery;
+class UUE5CoroSubsystem;
+
 namespace UE5Coro::Private
 {
+struct FAIReadyCallbacks;
 class FPathFindingAwaiter;
+class FPathFindingBatchAwaiter;
 class FMoveToAwaiter;
 class FSimpleMoveToAwaiter;
+class FEQSQueryAwaiter;
+class FEQSQueryBatchAwaiter;
 }
 
 namespace UE5Coro::AI
 {
+/** A single item of a finished EQS query. */
+struct FEQSItem
+{
+	FVector Location = FVector::ZeroVector;
+	/** Only set for actor-based item types. */
+	TWeakObjectPtr<AActor> Actor;
+	float Score = 0;
+};
+
+/** The outcome of an EQS query, with its items copied out of the query's raw
+ *  data, in the query's order. */
+struct FEQSResult
+{
+	EEnvQueryStatus::Type Status = EEnvQueryStatus::Failed;
+	TArray<FEQSItem> Items;
+
+	bool IsSuccessful() const { return Status == EEnvQueryStatus::Success; }
+};
+
+/** Starts running the EQS query, resumes the awaiting coroutine from the
+ *  query's finished delegate, without polling it.<br>
+ *  Querier must be the querier that Request was made with.<br>
+ *  The result of the co_await expression is FEQSResult.<br>
+ *  Destroying the awaiter before the query finishes aborts the query. */
+UE5COROAI_API Private::FEQSQueryAwaiter RunEQSQuery(
+	const FEnvQueryRequest& Request, UObject* Querier,
+	EEnvQueryRunMode::Type RunMode);
+
+/** Starts running the EQS query for Querier, resumes the awaiting coroutine
+ *  from the query's finished delegate, without polling it.<br>
+ *  The result of the co_await expression is FEQSResult.<br>
+ *  Destroying the awaiter before the query finishes aborts the query. */
+UE5COROAI_API Private::FEQSQueryAwaiter RunEQSQuery(
+	UEnvQuery* Query, UObject* Querier, EEnvQueryRunMode::Type RunMode);
+
+/** Starts running the EQS query for every querier at once, resumes the
+ *  awaiting coroutine when all of them finished.<br>
+ *  The result of the co_await expression is a const TArray<FEQSResult>&, with
+ *  one element for each querier, in order.<br>
+ *  Destroying the awaiter aborts every query that's still running. */
+UE5COROAI_API Private::FEQSQueryBatchAwaiter RunEQSQueriesBatch(
+	UEnvQuery* Query, TArrayView<UObject* const> Queriers,
+	EEnvQueryRunMode::Type RunMode);
+
 /** Starts an async pathfinding operation, resumes the awaiting coroutine once
  *  it finishes.<br>
  *  The result of the co_await expression is
@@ -58,8 +110,22 @@ UE5COROAI_API Private::FPathFindingAwaiter FindPath(
 	UObject* WorldContextObject, const FPathFindingQuery& Query,
 	EPathFindingMode::Type Mode = EPathFindingMode::Regular);
 
+/** Starts an async pathfinding operation for every query at once, resumes the
+ *  awaiting coroutine once NumRequired of them finished (all of them if it's
+ *  negative). Queries that are still running at that point are aborted.<br>
+ *  The result of the co_await expression is a
+ *  const TArray<TTuple<ENavigationQueryResult::Type, FNavPathSharedPtr>>&,
+ *  with one element for each query, in order. Aborted queries are reported as
+ *  ENavigationQueryResult::Invalid. */
+UE5COROAI_API Private::FPathFindingBatchAwaiter FindPathsBatch(
+	UObject* WorldContextObject, TArrayView<const FPathFindingQuery> Queries,
+	EPathFindingMode::Type Mode = EPathFindingMode::Regular,
+	int32 NumRequired = -1);
+
 /** Issues a "move to" command to the specified controller, resumes the awaiting
  *  coroutine once it finishes.<br>
+ *  Async coroutines are resumed by the move's completion, and don't poll it
+ *  every tick.<br>
  *  The result of the co_await expression is EPathFollowingResult. */
 UE5COROAI_API Private::FMoveToAwaiter AIMoveTo(
 	AAIController* Controller, FVector Target, float AcceptanceRadius = -1,
@@ -71,6 +137,8 @@ UE5COROAI_API Private::FMoveToAwaiter AIMoveTo(
 
 /** Issues a "move to" command to the specified controller, resumes the awaiting
  *  coroutine once it finishes.<br>
+ *  Async coroutines are resumed by the move's completion, and don't poll it
+ *  every tick.<br>
  *  The result of the co_await expression is EPathFollowingResult. */
 UE5COROAI_API Private::FMoveToAwaiter AIMoveTo(
 	AAIController* Controller, AActor* Target, float AcceptanceRadius = -1,
@@ -83,6 +151,8 @@ UE5COROAI_API Private::FMoveToAwaiter AIMoveTo(
 /** Performs similar behavior to UAIBlueprintHelperLibrary's SimpleMoveTo,
  *  such as injecting components into the controller, issues a "move to"
  *  command, and resumes the awaiting coroutine once it finishes.<br>
+ *  Async coroutines are resumed by the move's completion, and don't poll it
+ *  every tick.<br>
  *  The result of the co_await expression is FPathFollowingResult. */
 UE5COROAI_API auto SimpleMoveTo(AController* Controller, FVector Target)
 	-> Private::FSimpleMoveToAwaiter;
@@ -90,9 +160,27 @@ UE5COROAI_API auto SimpleMoveTo(AController* Controller, FVector Target)
 /** Performs similar behavior to UAIBlueprintHelperLibrary's SimpleMoveTo,
  *  such as injecting components into the controller, issues a "move to"
  *  command, and resumes the awaiting coroutine once it finishes.<br>
+ *  Async coroutines are resumed by the move's completion, and don't poll it
+ *  every tick.<br>
  *  The result of the co_await expression is FPathFollowingResult. */
 UE5COROAI_API auto SimpleMoveTo(AController* Controller, AActor* Target)
 	-> Private::FSimpleMoveToAwaiter;
+
+/** Like SimpleMoveTo, but the path is found with FindPathAsync instead of
+ *  stalling the game thread until it's done. The path following component is
+ *  cached for controllers that aren't AAIControllers.<br>
+ *  The move starts after the path is found, and the returned coroutine
+ *  completes with the move's result. */
+UE5COROAI_API TCoroutine<FPathFollowingResult> SimpleMoveToAsync(
+	AController* Controller, FVector Target);
+
+/** Like SimpleMoveTo, but the path is found with FindPathAsync instead of
+ *  stalling the game thread until it's done. The path following component is
+ *  cached for controllers that aren't AAIControllers.<br>
+ *  The move starts after the path is found, and the returned coroutine
+ *  completes with the move's result. */
+UE5COROAI_API TCoroutine<FPathFollowingResult> SimpleMoveToAsync(
+	AController* Controller, AActor* Target);
 }
 
 namespace UE5Coro::Private
@@ -104,6 +192,25 @@ public:
 	TTuple<ENavigationQueryResult::Type, FNavPathSharedPtr> await_resume();
 };
 
+class [[nodiscard]] UE5COROAI_API FPathFindingBatchAwaiter
+	: public TAwaiter<FPathFindingBatchAwaiter>
+{
+public:
+	using FResult = TTuple<ENavigationQueryResult::Type, FNavPathSharedPtr>;
+	struct FState;
+
+private:
+	TSharedPtr<FState, ESPMode::NotThreadSafe> State;
+
+public:
+	explicit FPathFindingBatchAwaiter(
+		TSharedPtr<FState, ESPMode::NotThreadSafe>);
+
+	bool await_ready();
+	void Suspend(FPromise&);
+	const TArray<FResult>& await_resume();
+};
+
 class [[nodiscard]] UE5COROAI_API FMoveToAwaiter : public FLatentAwaiter
 {
 public:
@@ -119,9 +226,13 @@ class [[nodiscard]] UE5COROAI_API FSimpleMoveToAwaiter : public FLatentAwaiter
 		TWeakObjectPtr<UPathFollowingComponent> PathFollow;
 		FDelegateHandle Handle;
 		std::optional<FPathFollowingResult> Result;
+		TWeakObjectPtr<UUE5CoroSubsystem> Subsystem; // Set if not polled
+		FAsyncPromise* Promise = nullptr;
 		void RequestFinished(FAIRequestID, const FPathFollowingResult&);
 	};
+	friend FAIReadyCallbacks;
 	static bool ShouldResume(void* State, bool bCleanup);
+	static bool BindReady(void* State, UUE5CoroSubsystem&, FAsyncPromise&);
 
 public:
 	explicit FSimpleMoveToAwaiter(EPathFollowingResult::Type);
@@ -129,6 +240,37 @@ public:
 	FPathFollowingResult await_resume() noexcept;
 };
 
+class [[nodiscard]] UE5COROAI_API FEQSQueryAwaiterBase
+	: public TAwaiter<FEQSQueryAwaiterBase>
+{
+public:
+	struct FState;
+
+protected:
+	TSharedPtr<FState, ESPMode::NotThreadSafe> State;
+
+public:
+	explicit FEQSQueryAwaiterBase(TSharedPtr<FState, ESPMode::NotThreadSafe>);
+
+	bool await_ready();
+	void Suspend(FPromise&);
+};
+
+class [[nodiscard]] UE5COROAI_API FEQSQueryAwaiter : public FEQSQueryAwaiterBase
+{
+public:
+	using FEQSQueryAwaiterBase::FEQSQueryAwaiterBase;
+	AI::FEQSResult await_resume();
+};
+
+class [[nodiscard]] UE5COROAI_API FEQSQueryBatchAwaiter
+	: public FEQSQueryAwaiterBase
+{
+public:
+	using FEQSQueryAwaiterBase::FEQSQueryAwaiterBase;
+	const TArray<AI::FEQSResult>& await_resume();
+};
+
 static_assert(sizeof(FPathFindingAwaiter) == sizeof(FLatentAwaiter));
 static_assert(sizeof(FMoveToAwaiter) == sizeof(FLatentAwaiter));
 static_assert(sizeof(FSimpleMoveToAwaiter) == sizeof(FLatentAwaiter));
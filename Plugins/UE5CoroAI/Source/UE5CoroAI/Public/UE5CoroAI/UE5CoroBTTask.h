@@ -0,0 +1,84 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UE5Coro/Definitions.h"
+#if !UE5CORO_CPP20
+#error UE5CoroAI does not support C++17.
+#endif
+#include "BehaviorTree/BTTaskNode.h"
+#include "UE5Coro/AsyncCoroutine.h"
+#include "UE5CoroBTTask.generated.h"
+
+/**
+ * Behavior tree task implemented by a coroutine.<br>
+ * Usage summary:
+ * - Override Execute with a coroutine instead of ExecuteTask
+ * - co_return true to succeed, false or cancel to fail
+ * - The task finishes when the coroutine completes, it does not tick while
+ *   the coroutine is suspended
+ * - Tasks are not instanced, the coroutine is kept in node memory. Do not
+ *   store per-execution state in members.
+ */
+UCLASS(Abstract)
+class UE5COROAI_API UUE5CoroBTTask : public UBTTaskNode
+{
+	GENERATED_BODY()
+
+public:
+	UUE5CoroBTTask();
+
+protected:
+	/** Override this with a coroutine instead of ExecuteTask.
+	 *  Do not call directly.<br>
+	 *  The coroutine runs in async mode, starting on the game thread.
+	 *  If it's still running when the task is aborted, it will be canceled. */
+	virtual UE5Coro::TCoroutine<bool> Execute(UBehaviorTreeComponent& OwnerComp,
+	                                          uint8* NodeMemory)
+		PURE_VIRTUAL(UUE5CoroBTTask::Execute, co_return false;);
+
+private:
+	/** Do not override, use Execute. */
+	virtual EBTNodeResult::Type ExecuteTask(UBehaviorTreeComponent& OwnerComp,
+	                                        uint8* NodeMemory) final override;
+	virtual EBTNodeResult::Type AbortTask(UBehaviorTreeComponent& OwnerComp,
+	                                      uint8* NodeMemory) final override;
+	virtual uint16 GetInstanceMemorySize() const final override;
+	virtual void InitializeMemory(UBehaviorTreeComponent& OwnerComp,
+	                              uint8* NodeMemory,
+	                              EBTMemoryInit::Type InitType) const override;
+	virtual void CleanupMemory(UBehaviorTreeComponent& OwnerComp,
+	                           uint8* NodeMemory,
+	                           EBTMemoryClear::Type CleanupType) const override;
+};
@@ -39,8 +39,16 @@ TCoroutine<> UE5CoroAICompileTest()
 {
 	FPathFindingQuery Query;
 	co_await FindPath(nullptr, Query);
+	co_await FindPathsBatch(nullptr, {Query});
 	co_await AIMoveTo(nullptr, FVector());
 	co_await AIMoveTo(nullptr, static_cast<AActor*>(nullptr));
 	co_await SimpleMoveTo(nullptr, FVector());
 	co_await SimpleMoveTo(nullptr, static_cast<AActor*>(nullptr));
+	co_await SimpleMoveToAsync(nullptr, FVector());
+	co_await SimpleMoveToAsync(nullptr, static_cast<AActor*>(nullptr));
+	co_await RunEQSQuery(static_cast<UEnvQuery*>(nullptr), nullptr,
+	                     EEnvQueryRunMode::AllMatching);
+	co_await RunEQSQuery(FEnvQueryRequest(), nullptr,
+	                     EEnvQueryRunMode::SingleResult);
+	co_await RunEQSQueriesBatch(nullptr, {}, EEnvQueryRunMode::SingleResult);
 }
@@ -0,0 +1,282 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "UE5CoroGAS/AbilitySystemAwaiters.h"
+#include "Async/Async.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Private;
+
+FGameplayEventAwaiter GAS::WaitGameplayEvent(UAbilitySystemComponent* ASC,
+                                             FGameplayTag EventTag,
+                                             bool bOnlyMatchExact)
+{
+	return FGameplayEventAwaiter(ASC, EventTag, bOnlyMatchExact);
+}
+
+FGameplayTagAwaiter GAS::WaitGameplayTagAdded(UAbilitySystemComponent* ASC,
+                                              FGameplayTag Tag)
+{
+	return FGameplayTagAwaiter(ASC, Tag, FGameplayTagAwaiter::Added);
+}
+
+FGameplayTagAwaiter GAS::WaitGameplayTagRemoved(UAbilitySystemComponent* ASC,
+                                                FGameplayTag Tag)
+{
+	return FGameplayTagAwaiter(ASC, Tag, FGameplayTagAwaiter::Removed);
+}
+
+FGameplayTagAwaiter GAS::WaitGameplayTagCountChanged(
+	UAbilitySystemComponent* ASC, FGameplayTag Tag)
+{
+	return FGameplayTagAwaiter(ASC, Tag, FGameplayTagAwaiter::Changed);
+}
+
+FAttributeChangeAwaiter GAS::WaitAttributeChanged(
+	UAbilitySystemComponent* ASC, FGameplayAttribute Attribute,
+	TFunction<bool(const FOnAttributeChangeData&)> Filter)
+{
+	return FAttributeChangeAwaiter(ASC, std::move(Attribute),
+	                               std::move(Filter));
+}
+
+FAbilitySystemAwaiter::FAbilitySystemAwaiter(
+	UAbilitySystemComponent* ASC, void (*BindFn)(FAbilitySystemAwaiter&),
+	void (*UnbindFn)(FAbilitySystemAwaiter&, UAbilitySystemComponent&))
+	: FCancellationHook(&OnCanceled), BindFn(BindFn), UnbindFn(UnbindFn),
+	  ASC(ASC)
+{
+	checkf(IsInGameThread(),
+	       TEXT("Ability system awaiters may only be used on the game thread"));
+}
+
+FAbilitySystemAwaiter::~FAbilitySystemAwaiter()
+{
+	// The hook goes first, it could be racing the delegate otherwise
+	if (Promise)
+		Promise->RemoveCancellationHook(*this);
+	Unhook();
+}
+
+void FAbilitySystemAwaiter::Suspend(FPromise& InPromise)
+{
+	checkf(IsInGameThread(),
+	       TEXT("Ability system awaiters may only be used on the game thread"));
+	checkf(!Promise, TEXT("Attempted second concurrent co_await"));
+	Promise = &InPromise;
+
+	// Nothing will ever call the delegate if the component is gone
+	if (!ASC.IsValid())
+	{
+		InPromise.Resume();
+		return;
+	}
+
+	// Fully armed before the hook, a cancellation may arrive as soon as it's
+	// added. The delegate can't be called until this returns.
+	State = Waiting;
+	BindFn(*this);
+	bBound = true;
+	if (!InPromise.AddCancellationHook(*this))
+	{
+		// Already canceled, let the coroutine process that right away
+		State = Canceled;
+		Unhook();
+		InPromise.Resume();
+	}
+}
+
+void FAbilitySystemAwaiter::TryResume()
+{
+	checkf(IsInGameThread(),
+	       TEXT("Internal error: ability system delegate off the game thread"));
+	uint8 Expected = Waiting;
+	if (!State.compare_exchange_strong(Expected, Resumed))
+		return;
+	Promise->RemoveCancellationHook(*this);
+	// Unbinding from within a broadcast is safe, the coroutine is resumed
+	// directly from the callback that matched
+	Unhook();
+	Promise->Resume();
+}
+
+void FAbilitySystemAwaiter::OnCanceled(FCancellationHook& Hook)
+{
+	auto& This = static_cast<FAbilitySystemAwaiter&>(Hook);
+	uint8 Expected = Waiting;
+	if (!This.State.compare_exchange_strong(Expected, Canceled))
+		return;
+	// Hooks may not resume directly, and the delegates belong to the game
+	// thread. The coroutine can't go anywhere until this resumes it.
+	AsyncTask(ENamedThreads::GameThread, [&This]
+	{
+		This.Unhook();
+		This.Promise->Resume();
+	});
+}
+
+void FAbilitySystemAwaiter::Unhook()
+{
+	if (!std::exchange(bBound, false))
+		return;
+	if (auto* Component = ASC.Get())
+		UnbindFn(*this, *Component);
+}
+
+FGameplayEventAwaiter::FGameplayEventAwaiter(UAbilitySystemComponent* ASC,
+                                             FGameplayTag Tag,
+                                             bool bOnlyMatchExact)
+	: FAbilitySystemAwaiter(ASC, &Bind, &Unbind), Tag(Tag),
+	  bOnlyMatchExact(bOnlyMatchExact)
+{
+}
+
+void FGameplayEventAwaiter::Bind(FAbilitySystemAwaiter& Base)
+{
+	auto& This = static_cast<FGameplayEventAwaiter&>(Base);
+	auto* Component = This.ASC.Get();
+	if (This.bOnlyMatchExact)
+		This.Handle = Component->GenericGameplayEventCallbacks
+		                       .FindOrAdd(This.Tag)
+		                       .AddRaw(&This, &FGameplayEventAwaiter::OnEvent);
+	else
+		This.Handle = Component->AddGameplayEventTagContainerDelegate(
+			FGameplayTagContainer(This.Tag),
+			FGameplayEventTagMulticastDelegate::FDelegate::CreateRaw(
+				&This, &FGameplayEventAwaiter::OnTagEvent));
+}
+
+void FGameplayEventAwaiter::Unbind(FAbilitySystemAwaiter& Base,
+                                   UAbilitySystemComponent& Component)
+{
+	auto& This = static_cast<FGameplayEventAwaiter&>(Base);
+	if (!This.bOnlyMatchExact)
+		Component.RemoveGameplayEventTagContainerDelegate(
+			FGameplayTagContainer(This.Tag), This.Handle);
+	// The map might have been reallocated since Bind, look it up again
+	else if (auto* Delegate =
+	         Component.GenericGameplayEventCallbacks.Find(This.Tag))
+		Delegate->Remove(This.Handle);
+}
+
+void FGameplayEventAwaiter::OnEvent(const FGameplayEventData* Payload)
+{
+	if (Payload)
+		Result = *Payload;
+	TryResume();
+}
+
+void FGameplayEventAwaiter::OnTagEvent(FGameplayTag,
+                                       const FGameplayEventData* Payload)
+{
+	OnEvent(Payload);
+}
+
+FGameplayTagAwaiter::FGameplayTagAwaiter(UAbilitySystemComponent* ASC,
+                                         FGameplayTag Tag, EMode Mode)
+	: FAbilitySystemAwaiter(ASC, &Bind, &Unbind), Tag(Tag), Mode(Mode)
+{
+	checkf(Mode == Added || Mode == Removed || Mode == Changed,
+	       TEXT("Invalid gameplay tag awaiter mode"));
+}
+
+EGameplayTagEventType::Type FGameplayTagAwaiter::GetEventType() const
+{
+	// NewOrRemoved is enough to see the count crossing zero
+	return Mode == Changed ? EGameplayTagEventType::AnyCountChange
+	                       : EGameplayTagEventType::NewOrRemoved;
+}
+
+bool FGameplayTagAwaiter::await_ready()
+{
+	auto* Component = ASC.Get();
+	if (!Component || Mode == Changed)
+		return false;
+	Count = Component->GetTagCount(Tag);
+	return Mode == Added ? Count > 0 : Count == 0;
+}
+
+void FGameplayTagAwaiter::Bind(FAbilitySystemAwaiter& Base)
+{
+	auto& This = static_cast<FGameplayTagAwaiter&>(Base);
+	This.Handle = This.ASC->RegisterGameplayTagEvent(This.Tag,
+	                                                 This.GetEventType())
+	                      .AddRaw(&This, &FGameplayTagAwaiter::OnTagChanged);
+}
+
+void FGameplayTagAwaiter::Unbind(FAbilitySystemAwaiter& Base,
+                                 UAbilitySystemComponent& Component)
+{
+	auto& This = static_cast<FGameplayTagAwaiter&>(Base);
+	Component.UnregisterGameplayTagEvent(This.Handle, This.Tag,
+	                                     This.GetEventType());
+}
+
+void FGameplayTagAwaiter::OnTagChanged(const FGameplayTag, int32 NewCount)
+{
+	// Filter before resuming, the coroutine only sees the change it wants
+	if ((Mode == Added && NewCount <= 0) || (Mode == Removed && NewCount > 0))
+		return;
+	Count = NewCount;
+	TryResume();
+}
+
+FAttributeChangeAwaiter::FAttributeChangeAwaiter(
+	UAbilitySystemComponent* ASC, FGameplayAttribute Attribute,
+	TFunction<bool(const FOnAttributeChangeData&)> Filter)
+	: FAbilitySystemAwaiter(ASC, &Bind, &Unbind),
+	  Attribute(std::move(Attribute)), Filter(std::move(Filter))
+{
+}
+
+void FAttributeChangeAwaiter::Bind(FAbilitySystemAwaiter& Base)
+{
+	auto& This = static_cast<FAttributeChangeAwaiter&>(Base);
+	This.Handle = This.ASC->GetGameplayAttributeValueChangeDelegate(
+		This.Attribute).AddRaw(&This, &FAttributeChangeAwaiter::OnChanged);
+}
+
+void FAttributeChangeAwaiter::Unbind(FAbilitySystemAwaiter& Base,
+                                     UAbilitySystemComponent& Component)
+{
+	auto& This = static_cast<FAttributeChangeAwaiter&>(Base);
+	Component.GetGameplayAttributeValueChangeDelegate(This.Attribute)
+	         .Remove(This.Handle);
+}
+
+void FAttributeChangeAwaiter::OnChanged(const FOnAttributeChangeData& Data)
+{
+	if (Filter && !Filter(Data))
+		return;
+	Result = Data;
+	TryResume();
+}
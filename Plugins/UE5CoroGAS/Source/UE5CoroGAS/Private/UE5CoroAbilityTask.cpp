@@ -30,9 +30,66 @@
 // ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "UE5CoroGAS/UE5CoroAbilityTask.h"
+#include "HAL/IConsoleManager.h"
+#include "UObject/GCObject.h"
 
 using namespace UE5Coro::Private;
 
+namespace
+{
+TAutoConsoleVariable<int32> CVarAbilityTaskPoolSize(
+	TEXT("UE5Coro.AbilityTaskPoolSize"), 64,
+	TEXT("Maximum number of ended ability tasks of each class that are kept for ")
+	TEXT("reuse by NewPooledAbilityTask."));
+
+/** Ended tasks kept alive for NewPooledAbilityTask. Game thread only. */
+class FAbilityTaskPool final : public FGCObject
+{
+	TMap<UClass*, TArray<UUE5CoroAbilityTask*>> Tasks;
+
+public:
+	static FAbilityTaskPool& Get()
+	{
+		// Deliberately never destroyed: static destruction would be too late
+		// for a FGCObject
+		static auto* Pool = new FAbilityTaskPool;
+		return *Pool;
+	}
+
+	UUE5CoroAbilityTask* Take(UClass* Class)
+	{
+		auto* Array = Tasks.Find(Class);
+		return Array && Array->Num() > 0 ? Array->Pop() : nullptr;
+	}
+
+	bool HasRoom(UClass* Class) const
+	{
+		auto* Array = Tasks.Find(Class);
+		int32 Num = Array ? Array->Num() : 0;
+		return Num < CVarAbilityTaskPoolSize.GetValueOnGameThread();
+	}
+
+	bool Return(UUE5CoroAbilityTask* Task)
+	{
+		if (!HasRoom(Task->GetClass()))
+			return false;
+		Tasks.FindOrAdd(Task->GetClass()).Push(Task);
+		return true;
+	}
+
+	virtual void AddReferencedObjects(FReferenceCollector& Collector) override
+	{
+		for (auto& [Class, Array] : Tasks)
+			Collector.AddReferencedObjects(Array);
+	}
+
+	virtual FString GetReferencerName() const override
+	{
+		return TEXT("UE5Coro ability task pool");
+	}
+};
+}
+
 void UUE5CoroAbilityTask::Activate()
 {
 	Super::Activate();
@@ -57,11 +114,16 @@ void UUE5CoroAbilityTask::Activate()
 		checkf(Promise,
 		       TEXT("Internal error: Expected to be the active coroutine"));
 		Promise = nullptr;
+		bCompleting = true; // Don't recycle this object during Succeeded/Failed
 		Super::EndTask();
 		if (Coroutine.WasSuccessful())
 			Succeeded();
 		else
 			Failed();
+		bCompleting = false;
+		// OnDestroy only keeps this valid if it's going back to the pool
+		if (bPooled && IsValid(this))
+			ReturnToPool();
 	});
 }
 
@@ -84,8 +146,51 @@ void UUE5CoroAbilityTask::OnDestroy(bool bInOwnerFinished)
 	if (Promise)
 		Promise->Cancel();
 
+	// Decide this now, while the MarkAsGarbage below can be undone right away.
+	// If the coroutine is still running, the task stays garbage and won't be
+	// reused. This lets the latent action manager clean up like usual.
+	bool bRecycle = bPooled && !Promise &&
+	                FAbilityTaskPool::Get().HasRoom(GetClass());
+
 	Super::OnDestroy(bInOwnerFinished);
 	checkf(!IsValid(this), TEXT("Internal error: expected MarkAsGarbage()"));
+
+	if (!bRecycle)
+		return;
+	ClearGarbage(); // The task will be initialized again
+	// Don't recycle this object during Succeeded/Failed, the continuation in
+	// Activate will return it when they're done
+	if (!bCompleting)
+		ReturnToPool();
+}
+
+void UUE5CoroAbilityTask::ReturnToPool()
+{
+	checkf(bPooled && !Promise && IsValid(this),
+	       TEXT("Internal error: returning a task that's still in use"));
+	ResetForReuse();
+	if (!FAbilityTaskPool::Get().Return(this))
+		MarkAsGarbage(); // The pool filled up, let GC have this one
+}
+
+UUE5CoroAbilityTask* UUE5CoroAbilityTask::NewPooledAbilityTaskCore(
+	UClass* Class, UGameplayAbility* ThisAbility, FName InstanceName)
+{
+	checkf(IsInGameThread(),
+	       TEXT("Ability tasks may only be created on the game thread"));
+	checkf(IsValid(ThisAbility), TEXT("Creating task for invalid ability"));
+	auto* Task = FAbilityTaskPool::Get().Take(Class);
+	if (!Task)
+	{
+		Task = NewObject<UUE5CoroAbilityTask>(GetTransientPackage(), Class);
+		Task->bPooled = true;
+	}
+	checkf(Task->bPooled && !Task->Promise,
+	       TEXT("Internal error: reusing a task that's still in use"));
+	// Same as NewAbilityTask
+	Task->InitTask(*ThisAbility, ThisAbility->GetGameplayTaskDefaultPriority());
+	Task->InstanceName = InstanceName;
+	return Task;
 }
 
 void UUE5CoroAbilityTask::CoroutineStarting(TAbilityPromise<ThisClass>* InPromise)
@@ -102,3 +207,10 @@ void UUE5CoroSimpleAbilityTask::Failed()
 {
 	OnFailed.Broadcast();
 }
+
+void UUE5CoroSimpleAbilityTask::ResetForReuse()
+{
+	Super::ResetForReuse();
+	OnSucceeded.Clear();
+	OnFailed.Clear();
+}
@@ -41,66 +41,54 @@ using namespace UE5Coro::Private;
 namespace
 {
 bool GCoroutineEnded = false;
+FGameplayAbilitySpecHandle GCurrentSpecHandle;
 FPredictionKey GCurrentPredictionKey;
 
-// Workaround for member IsTemplate being unreliable in destructors
-bool IsTemplate(UObject* Object)
+/** BlueprintAssignable properties found by Task(), resolved once per class. */
+TMap<TWeakObjectPtr<UClass>, FMulticastDelegateProperty*> GTaskDelegates;
+
+FMulticastDelegateProperty* FindTaskDelegate(UClass* Class)
 {
-	// Deliberately not using IsValid here
-	checkf(Object, TEXT("Internal error: corrupted object"));
-	// Outer is explicitly not checked, it might be destroyed already
-	return Object->HasAnyFlags(RF_ArchetypeObject | RF_ClassDefaultObject);
+	if (auto* Cached = GTaskDelegates.Find(Class))
+		return *Cached;
+
+	FProperty* Property = nullptr;
+	for (auto* i = Class->PropertyLink; i; i = i->NextRef)
+	{
+		if (!i->HasAnyPropertyFlags(CPF_BlueprintAssignable))
+			continue;
+		checkf(!Property,
+		       TEXT("Only one BlueprintAssignable UPROPERTY is supported."));
+		Property = i;
+	}
+	checkf(Property, TEXT("A BlueprintAssignable UPROPERTY is required."));
+	auto* DelegateProp = CastFieldChecked<FMulticastDelegateProperty>(Property);
+	GTaskDelegates.Add(Class, DelegateProp);
+	return DelegateProp;
 }
 }
 
 UUE5CoroGameplayAbility::UUE5CoroGameplayAbility()
 {
-	if (::IsTemplate(this))
-		Activations = new TMap<FPredictionKey, TAbilityPromise<ThisClass>*>;
-	else
-		Activations = GetDefault<ThisClass>(GetClass())->Activations;
-	checkf(Activations, TEXT("Internal error: non-template object before CDO"));
-
 	// For consistency.
 	// Super::ActivateAbility is not called, so these aren't really used.
 	bHasBlueprintActivate = false;
 	bHasBlueprintActivateFromEvent = false;
 }
 
-UUE5CoroGameplayAbility::~UUE5CoroGameplayAbility()
-{
-	if (::IsTemplate(this))
-		delete Activations;
-#if UE5CORO_DEBUG
-	Activations = nullptr;
-#endif
-}
-
 FLatentAwaiter UUE5CoroGameplayAbility::Task(UObject* Object)
 {
 	checkf(IsInGameThread(),
 	       TEXT("This method is only available on the game thread"));
 	checkf(IsValid(Object), TEXT("Attempting to await invalid object"));
-	// Find BlueprintAssignable properties
-	auto* Class = Object->GetClass();
-	FProperty* Property = nullptr;
-	for (auto* i = Class->PropertyLink; i; i = i->NextRef)
-	{
-		if (!i->HasAnyPropertyFlags(CPF_BlueprintAssignable))
-			continue;
-		checkf(!Property,
-		       TEXT("Only one BlueprintAssignable UPROPERTY is supported."));
-		Property = i;
-		if constexpr (!UE5CORO_DEBUG) // Keep looking for others in debug
-			break;
-	}
-	checkf(Property, TEXT("A BlueprintAssignable UPROPERTY is required."));
-	auto* DelegateProp = CastFieldChecked<FMulticastDelegateProperty>(Property);
+	auto* DelegateProp = FindTaskDelegate(Object->GetClass());
 
-	auto* Target = NewObject<UUE5CoroTaskCallbackTarget>(this);
-	FScriptDelegate Delegate;
-	Delegate.BindUFunction(Target, NAME_Core);
-	DelegateProp->AddDelegate(std::move(Delegate), Object);
+	UUE5CoroTaskCallbackTarget* Target;
+	if (TaskTargetPool.Num() > 0)
+		Target = TaskTargetPool.Pop();
+	else
+		Target = NewObject<UUE5CoroTaskCallbackTarget>(this);
+	Target->Bind(Object, DelegateProp);
 
 	// Activate some well-known base classes (IsValid was checked above)
 	if (auto* Task = Cast<UGameplayTask>(Object))
@@ -108,7 +96,8 @@ FLatentAwaiter UUE5CoroGameplayAbility::Task(UObject* Object)
 	else if (auto* Action = Cast<UBlueprintAsyncActionBase>(Object))
 		Action->Activate();
 
-	return FLatentAwaiter(new TStrongObjectPtr(Target), &ShouldResumeTask);
+	using FPtr = TStrongObjectPtr<UUE5CoroTaskCallbackTarget>;
+	return FLatentAwaiter(std::in_place_type<FPtr>, &ShouldResumeTask, Target);
 }
 
 void UUE5CoroGameplayAbility::ActivateAbility(
@@ -122,6 +111,7 @@ void UUE5CoroGameplayAbility::ActivateAbility(
 
 	checkf(IsInGameThread(),
 	       TEXT("Internal error: Expected GA activation on the game thread"));
+	GCurrentSpecHandle = Handle;
 	GCurrentPredictionKey = ActivationInfo.GetActivationPredictionKey();
 	checkf(!TAbilityPromise<ThisClass>::bCalledFromActivate,
 	       TEXT("Internal error: ActivateAbility recursion"));
@@ -166,8 +156,8 @@ void UUE5CoroGameplayAbility::EndAbility(
 	if (!PredictionKey.IsValidKey())
 		return;
 
-	TAbilityPromise<ThisClass>* Promise;
-	bool bFound = Activations->RemoveAndCopyValue(PredictionKey, Promise);
+	auto* Promise = RemoveActivation(FActivationKey(Handle, PredictionKey));
+	bool bFound = Promise != nullptr;
 
 	// Nothing to do if the coroutine has ended already
 	if (bCoroutineEnded)
@@ -190,10 +180,37 @@ void UUE5CoroGameplayAbility::CoroutineStarting(TAbilityPromise<ThisClass>* Prom
 	       TEXT("Internal error: expected coroutine on the game thread"));
 	checkf(GCurrentPredictionKey.IsValidKey(),
 	       TEXT("Attempting to start ability with invalid prediction key"));
-	checkf(!Activations->Contains(GCurrentPredictionKey),
+	FActivationKey Key(GCurrentSpecHandle, GCurrentPredictionKey);
+	checkf(!Activations.ContainsByPredicate([&](const FActivation& Activation)
+	       {
+		       return Activation.Get<0>() == Key;
+	       }) && !MoreActivations.Contains(Key),
 	       TEXT("Overlapping ability activations with the same prediction key"));
 	// Promise is not fully-constructed yet, but its address is known
-	Activations->Add(GCurrentPredictionKey, Promise);
+	if (Activations.Num() < Activations.Max())
+		Activations.Emplace(Key, Promise);
+	else
+		MoreActivations.Add(Key, Promise);
+}
+
+auto UUE5CoroGameplayAbility::RemoveActivation(const FActivationKey& Key)
+	-> TAbilityPromise<ThisClass>*
+{
+	for (int32 i = 0; i < Activations.Num(); ++i)
+	{
+		if (Activations[i].Get<0>() == Key)
+		{
+			auto* Promise = Activations[i].Get<1>();
+			Activations.RemoveAtSwap(i);
+			return Promise;
+		}
+	}
+
+	TAbilityPromise<ThisClass>* Promise = nullptr;
+	if (MoreActivations.RemoveAndCopyValue(Key, Promise) &&
+	    MoreActivations.Num() == 0)
+		MoreActivations.Reset(); // Don't let the holes accumulate
+	return Promise;
 }
 
 bool UUE5CoroGameplayAbility::ShouldResumeTask(void* State, bool bCleanup)
@@ -201,7 +218,14 @@ bool UUE5CoroGameplayAbility::ShouldResumeTask(void* State, bool bCleanup)
 	auto* Ptr = static_cast<TStrongObjectPtr<UUE5CoroTaskCallbackTarget>*>(State);
 	if (UNLIKELY(bCleanup))
 	{
-		delete Ptr;
+		// Return the target to its ability's pool if it's still around
+		auto* Target = Ptr->Get();
+		Target->Unbind();
+		if (auto* Ability = Cast<ThisClass>(Target->GetOuter());
+		    IsValid(Ability) && !Ability->IsUnreachable())
+			Ability->TaskTargetPool.Push(Target);
+		FLatentAwaiter::DestroyState<
+			TStrongObjectPtr<UUE5CoroTaskCallbackTarget>>(State);
 		return false;
 	}
 	return (*Ptr)->bExecuted;
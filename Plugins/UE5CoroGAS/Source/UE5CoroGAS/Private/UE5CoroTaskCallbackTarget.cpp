@@ -31,6 +31,31 @@
 
 #include "UE5CoroTaskCallbackTarget.h"
 
+void UUE5CoroTaskCallbackTarget::Bind(UObject* InSource,
+                                      FMulticastDelegateProperty* InProperty)
+{
+	checkf(!Property, TEXT("Internal error: callback target bound twice"));
+	Source = InSource;
+	Property = InProperty;
+	FScriptDelegate Delegate;
+	Delegate.BindUFunction(this, NAME_Core);
+	Property->AddDelegate(std::move(Delegate), InSource);
+}
+
+void UUE5CoroTaskCallbackTarget::Unbind()
+{
+	// If the source is gone, it can't broadcast anymore
+	if (auto* Object = Source.Get(); Object && Property)
+	{
+		FScriptDelegate Delegate;
+		Delegate.BindUFunction(this, NAME_Core);
+		Property->RemoveDelegate(Delegate, Object);
+	}
+	Source = nullptr;
+	Property = nullptr;
+	bExecuted = false;
+}
+
 void UUE5CoroTaskCallbackTarget::Core()
 {
 	bExecuted = true;
@@ -40,9 +40,18 @@ class UUE5CoroTaskCallbackTarget : public UObject
 {
     GENERATED_BODY()
 
+	TWeakObjectPtr<UObject> Source;
+	FMulticastDelegateProperty* Property = nullptr;
+
 public:
 	bool bExecuted = false;
 
+	/** Adds this object to Source's delegate. */
+	void Bind(UObject* Source, FMulticastDelegateProperty* Property);
+	/** Removes this object from its source's delegate, so that it may be
+	 *  reused for another Bind. */
+	void Unbind();
+
 	UFUNCTION()
 	void Core();
 };
@@ -32,5 +32,6 @@
 #pragma once
 
 #include "UE5Coro/Definitions.h"
+#include "UE5CoroGAS/AbilitySystemAwaiters.h"
 #include "UE5CoroGAS/UE5CoroAbilityTask.h"
 #include "UE5CoroGAS/UE5CoroGameplayAbility.h"
@@ -0,0 +1,195 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UE5Coro/Definitions.h"
+#include <atomic>
+#include "AbilitySystemComponent.h"
+#include "UE5Coro/AsyncCoroutine.h"
+
+namespace UE5Coro::Private
+{
+class FGameplayEventAwaiter;
+class FGameplayTagAwaiter;
+class FAttributeChangeAwaiter;
+}
+
+namespace UE5Coro::GAS
+{
+/** Waits for the ability system component to receive a gameplay event.<br>
+ *  If bOnlyMatchExact is false, events with tags that are children of EventTag
+ *  also resume the coroutine.<br>
+ *  The result of the co_await expression is a copy of the event's data.<br>
+ *  The coroutine is resumed directly from the event's callback. If the
+ *  component is already gone, it resumes immediately with an empty result.
+ *  @see UAbilitySystemComponent::GenericGameplayEventCallbacks */
+UE5COROGAS_API Private::FGameplayEventAwaiter WaitGameplayEvent(
+	UAbilitySystemComponent* ASC, FGameplayTag EventTag,
+	bool bOnlyMatchExact = true);
+
+/** Waits for Tag to be present on the ability system component, which
+ *  completes immediately if it already is.<br>
+ *  The result of the co_await expression is the tag's new count.
+ *  @see UAbilitySystemComponent::RegisterGameplayTagEvent */
+UE5COROGAS_API Private::FGameplayTagAwaiter WaitGameplayTagAdded(
+	UAbilitySystemComponent* ASC, FGameplayTag Tag);
+
+/** Waits for Tag to not be present on the ability system component, which
+ *  completes immediately if it already isn't.<br>
+ *  The result of the co_await expression is the tag's new count, 0.
+ *  @see UAbilitySystemComponent::RegisterGameplayTagEvent */
+UE5COROGAS_API Private::FGameplayTagAwaiter WaitGameplayTagRemoved(
+	UAbilitySystemComponent* ASC, FGameplayTag Tag);
+
+/** Waits for the next change of Tag's count on the ability system component.
+ *  <br>The result of the co_await expression is the tag's new count.
+ *  @see UAbilitySystemComponent::RegisterGameplayTagEvent */
+UE5COROGAS_API Private::FGameplayTagAwaiter WaitGameplayTagCountChanged(
+	UAbilitySystemComponent* ASC, FGameplayTag Tag);
+
+/** Waits for the attribute's value to change on the ability system component.
+ *  <br>If a filter is provided, changes that it returns false for are ignored
+ *  without resuming the coroutine.<br>
+ *  The result of the co_await expression is a copy of the change data, its
+ *  GEModData is only valid until the next co_await.
+ *  @see UAbilitySystemComponent::GetGameplayAttributeValueChangeDelegate */
+UE5COROGAS_API Private::FAttributeChangeAwaiter WaitAttributeChanged(
+	UAbilitySystemComponent* ASC, FGameplayAttribute Attribute,
+	TFunction<bool(const FOnAttributeChangeData&)> Filter = nullptr);
+}
+
+namespace UE5Coro::Private
+{
+/** Common logic for awaiters that bind directly to ability system component
+ *  delegates, on the game thread. */
+class [[nodiscard]] UE5COROGAS_API FAbilitySystemAwaiter
+	: public TAwaiter<FAbilitySystemAwaiter>, private FCancellationHook
+{
+	enum EState : uint8
+	{
+		Idle,
+		Waiting,
+		Resumed,
+		Canceled,
+	};
+
+	FPromise* Promise = nullptr;
+	void (*BindFn)(FAbilitySystemAwaiter&);
+	void (*UnbindFn)(FAbilitySystemAwaiter&, UAbilitySystemComponent&);
+	std::atomic<uint8> State = Idle; // Races cancellation against the delegate
+	bool bBound = false;
+
+	static void OnCanceled(FCancellationHook&);
+	void Unhook();
+
+protected:
+	TWeakObjectPtr<UAbilitySystemComponent> ASC;
+	FDelegateHandle Handle;
+
+	explicit FAbilitySystemAwaiter(
+		UAbilitySystemComponent*, void (*Bind)(FAbilitySystemAwaiter&),
+		void (*Unbind)(FAbilitySystemAwaiter&, UAbilitySystemComponent&));
+	/** Called by the derived class from its delegate, after it stored its
+	 *  result. Does nothing if a cancellation got there first. */
+	void TryResume();
+
+public:
+	UE_NONCOPYABLE(FAbilitySystemAwaiter);
+	~FAbilitySystemAwaiter();
+	void Suspend(FPromise&);
+};
+
+class [[nodiscard]] UE5COROGAS_API FGameplayEventAwaiter final
+	: public FAbilitySystemAwaiter
+{
+	FGameplayTag Tag;
+	bool bOnlyMatchExact;
+	FGameplayEventData Result;
+
+	static void Bind(FAbilitySystemAwaiter&);
+	static void Unbind(FAbilitySystemAwaiter&, UAbilitySystemComponent&);
+	void OnEvent(const FGameplayEventData*);
+	void OnTagEvent(FGameplayTag, const FGameplayEventData*);
+
+public:
+	explicit FGameplayEventAwaiter(UAbilitySystemComponent*, FGameplayTag,
+	                               bool bOnlyMatchExact);
+	FGameplayEventData await_resume() { return std::move(Result); }
+};
+
+class [[nodiscard]] UE5COROGAS_API FGameplayTagAwaiter final
+	: public FAbilitySystemAwaiter
+{
+public:
+	enum EMode : uint8
+	{
+		Added,
+		Removed,
+		Changed,
+	};
+
+private:
+	FGameplayTag Tag;
+	EMode Mode;
+	int32 Count = 0;
+
+	EGameplayTagEventType::Type GetEventType() const;
+	static void Bind(FAbilitySystemAwaiter&);
+	static void Unbind(FAbilitySystemAwaiter&, UAbilitySystemComponent&);
+	void OnTagChanged(const FGameplayTag, int32);
+
+public:
+	explicit FGameplayTagAwaiter(UAbilitySystemComponent*, FGameplayTag, EMode);
+	bool await_ready();
+	int32 await_resume() { return Count; }
+};
+
+class [[nodiscard]] UE5COROGAS_API FAttributeChangeAwaiter final
+	: public FAbilitySystemAwaiter
+{
+	FGameplayAttribute Attribute;
+	TFunction<bool(const FOnAttributeChangeData&)> Filter;
+	FOnAttributeChangeData Result;
+
+	static void Bind(FAbilitySystemAwaiter&);
+	static void Unbind(FAbilitySystemAwaiter&, UAbilitySystemComponent&);
+	void OnChanged(const FOnAttributeChangeData&);
+
+public:
+	explicit FAttributeChangeAwaiter(
+		UAbilitySystemComponent*, FGameplayAttribute,
+		TFunction<bool(const FOnAttributeChangeData&)> Filter);
+	FOnAttributeChangeData await_resume() { return Result; }
+};
+}
@@ -44,6 +44,8 @@
  * - Override Execute instead of Activate
  * - Run to completion to succeed, cancel to fail
  * - Invoke your delegates from Succeeded or Failed, not from Execute
+ * - Optionally, create tasks with NewPooledAbilityTask instead of
+ *   NewAbilityTask, and override ResetForReuse
  */
 UCLASS(Abstract, NotBlueprintable)
 class UE5COROGAS_API UUE5CoroAbilityTask : public UAbilityTask
@@ -52,8 +54,28 @@ class UE5COROGAS_API UUE5CoroAbilityTask : public UAbilityTask
 	friend UE5Coro::Private::TAbilityPromise<ThisClass>;
 
 	UE5Coro::Private::TAbilityPromise<ThisClass>* Promise = nullptr;
+	bool bPooled = false;
+	bool bCompleting = false;
 
 protected:
+	/** Like NewAbilityTask, but the task object is recycled after it ends,
+	 *  instead of becoming garbage. A reused task is passed through
+	 *  ResetForReuse, and must not be referenced after it ended.<br>
+	 *  The coroutine frames of Execute are pooled regardless of this. */
+	template<typename T>
+	static T* NewPooledAbilityTask(UGameplayAbility* ThisAbility,
+	                               FName InstanceName = NAME_None)
+	{
+		static_assert(std::is_base_of_v<UUE5CoroAbilityTask, T>);
+		return static_cast<T*>(NewPooledAbilityTaskCore(
+			T::StaticClass(), ThisAbility, InstanceName));
+	}
+
+	/** Called on pooled tasks after they ended, before they're put back in the
+	 *  pool. Overrides should reset every member that Execute, Succeeded, or
+	 *  Failed might have changed, and call Super. */
+	virtual void ResetForReuse() { }
+
 	/** Override this with a coroutine instead of Activate. Do not call directly.
 	 *  The returned coroutine's completion will call Succeeded or Failed.
 	 *  The coroutine will run in latent mode and can self-cancel to indicate
@@ -74,6 +96,10 @@ private:
 	void EndTask();
 	virtual void OnDestroy(bool bInOwnerFinished) final override;
 	void CoroutineStarting(UE5Coro::Private::TAbilityPromise<ThisClass>*);
+	void ReturnToPool();
+	static UUE5CoroAbilityTask* NewPooledAbilityTaskCore(UClass*,
+	                                                     UGameplayAbility*,
+	                                                     FName InstanceName);
 };
 
 UCLASS(Abstract)
@@ -91,4 +117,5 @@ public:
 protected:
 	virtual void Succeeded() override;
 	virtual void Failed() override;
+	virtual void ResetForReuse() override;
 };
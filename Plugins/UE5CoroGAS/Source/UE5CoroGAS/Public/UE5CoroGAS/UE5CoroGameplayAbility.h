@@ -50,13 +50,25 @@ class UE5COROGAS_API UUE5CoroGameplayAbility : public UGameplayAbility
 	GENERATED_BODY()
 	friend UE5Coro::Private::TAbilityPromise<ThisClass>;
 
-	// One shared per class to support every instancing policy including derived
-	// classes changing their minds at runtime. The real one is on the CDO.
-	TMap<FPredictionKey, UE5Coro::Private::TAbilityPromise<ThisClass>*>* Activations;
+	// Non-instanced abilities run every actor's activations on the CDO, where
+	// prediction keys alone might collide. Spec handles are globally unique.
+	using FActivationKey = TTuple<FGameplayAbilitySpecHandle, FPredictionKey>;
+	using FActivation = TTuple<FActivationKey,
+	                           UE5Coro::Private::TAbilityPromise<ThisClass>*>;
+	// Running coroutines of this object, keyed by their spec and prediction key.
+	// Instanced abilities rarely have more than a few, these are scanned.
+	TArray<FActivation, TInlineAllocator<4>> Activations;
+	// Overflow for objects with many concurrent activations, typically the CDO
+	// of a non-instanced ability.
+	TMap<FActivationKey, UE5Coro::Private::TAbilityPromise<ThisClass>*>
+		MoreActivations;
+
+	/** Callback targets for Task() that are not in use. */
+	UPROPERTY(Transient)
+	TArray<class UUE5CoroTaskCallbackTarget*> TaskTargetPool;
 
 public:
 	UUE5CoroGameplayAbility();
-	virtual ~UUE5CoroGameplayAbility() override;
 
 protected:
 	/** If true when ExecuteAbility co_returns, the ability's end will be
@@ -97,6 +109,8 @@ private:
 	                        bool) final override;
 
 	void CoroutineStarting(UE5Coro::Private::TAbilityPromise<ThisClass>*);
+	UE5Coro::Private::TAbilityPromise<ThisClass>* RemoveActivation(
+		const FActivationKey&);
 
 	static bool ShouldResumeTask(void*, bool);
 };
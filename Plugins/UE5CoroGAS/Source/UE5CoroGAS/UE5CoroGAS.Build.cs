@@ -39,6 +39,7 @@ public class UE5CoroGAS : UE5CoroModuleRules
 		PublicDependencyModuleNames.AddRange(new[]
 		{
 			"GameplayAbilities",
+			"GameplayTags",
 			"GameplayTasks",
 			"UE5Coro",
 		});
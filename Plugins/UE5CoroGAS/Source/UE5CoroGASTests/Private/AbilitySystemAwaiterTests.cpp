@@ -0,0 +1,144 @@
+// Copyright © Laura Andelare
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted (subject to the limitations in the disclaimer
+// below) provided that the following conditions are met:
+//
+// 1. Redistributions of source code must retain the above copyright notice,
+//    this list of conditions and the following disclaimer.
+//
+// 2. Redistributions in binary form must reproduce the above copyright notice,
+//    this list of conditions and the following disclaimer in the documentation
+//    and/or other materials provided with the distribution.
+//
+// 3. Neither the name of the copyright holder nor the names of its
+//    contributors may be used to endorse or promote products derived from
+//    this software without specific prior written permission.
+//
+// NO EXPRESS OR IMPLIED LICENSES TO ANY PARTY'S PATENT RIGHTS ARE GRANTED BY
+// THIS LICENSE. THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND
+// CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT
+// NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+// PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+// OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+// WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+// OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+// ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+
+#include "GASTestWorld.h"
+#include "AbilitySystemComponent.h"
+#include "Misc/AutomationTest.h"
+#include "NativeGameplayTags.h"
+#include "UE5CoroGAS/AbilitySystemAwaiters.h"
+#include "UE5CoroGASTestAvatar.h"
+
+using namespace UE5Coro;
+using namespace UE5Coro::Private::Test;
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FAbilitySystemAwaiterTest,
+                                 "UE5Coro.GAS.AbilitySystemAwaiters",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::HighPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
+namespace
+{
+UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_Parent, "UE5Coro.Test");
+UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_Child, "UE5Coro.Test.Child");
+UE_DEFINE_GAMEPLAY_TAG_STATIC(TAG_Other, "UE5Coro.Test.Other");
+}
+
+bool FAbilitySystemAwaiterTest::RunTest(const FString& Parameters)
+{
+	FGASTestWorld World;
+	auto* ASC = World.Avatar->GetAbilitySystemComponent();
+
+	{
+		float Magnitude = 0;
+		auto Coro = [&]() -> TCoroutine<>
+		{
+			auto Data = co_await GAS::WaitGameplayEvent(ASC, TAG_Child);
+			Magnitude = Data.EventMagnitude;
+		}();
+		FGameplayEventData Payload;
+		Payload.EventMagnitude = 1;
+		ASC->HandleGameplayEvent(TAG_Other, &Payload);
+		TestFalse(TEXT("Filtered"), Coro.IsDone());
+		Payload.EventMagnitude = 2;
+		ASC->HandleGameplayEvent(TAG_Child, &Payload);
+		TestTrue(TEXT("Resumed from the callback"), Coro.IsDone());
+		TestEqual(TEXT("Payload"), Magnitude, 2.0f);
+		Payload.EventMagnitude = 3;
+		ASC->HandleGameplayEvent(TAG_Child, &Payload);
+		TestEqual(TEXT("Unbound"), Magnitude, 2.0f);
+	}
+
+	{
+		FGameplayTag Received;
+		auto Coro = [&]() -> TCoroutine<>
+		{
+			auto Data = co_await GAS::WaitGameplayEvent(ASC, TAG_Parent,
+			                                            false);
+			Received = Data.EventTag;
+		}();
+		FGameplayEventData Payload;
+		Payload.EventTag = TAG_Child;
+		ASC->HandleGameplayEvent(TAG_Child, &Payload);
+		TestTrue(TEXT("Child tag matched"), Coro.IsDone());
+		TestEqual(TEXT("Event tag"), Received, FGameplayTag(TAG_Child));
+	}
+
+	{
+		int State = 0;
+		auto Coro = [&]() -> TCoroutine<>
+		{
+			State = co_await GAS::WaitGameplayTagAdded(ASC, TAG_Child);
+			co_await GAS::WaitGameplayTagAdded(ASC, TAG_Child);
+			State = -co_await GAS::WaitGameplayTagRemoved(ASC, TAG_Child);
+		}();
+		TestEqual(TEXT("Waiting for the tag"), State, 0);
+		ASC->AddLooseGameplayTag(TAG_Child);
+		TestEqual(TEXT("Added"), State, 1);
+		TestFalse(TEXT("Waiting for removal"), Coro.IsDone());
+		ASC->AddLooseGameplayTag(TAG_Child);
+		ASC->RemoveLooseGameplayTag(TAG_Child);
+		TestFalse(TEXT("Still present"), Coro.IsDone());
+		ASC->RemoveLooseGameplayTag(TAG_Child);
+		TestTrue(TEXT("Removed"), Coro.IsDone());
+		TestEqual(TEXT("Final count"), State, 0);
+	}
+
+	{
+		ASC->AddLooseGameplayTag(TAG_Other);
+		int Count = 0;
+		auto Coro = [&]() -> TCoroutine<>
+		{
+			Count = co_await GAS::WaitGameplayTagCountChanged(ASC, TAG_Other);
+		}();
+		TestFalse(TEXT("Not ready"), Coro.IsDone());
+		ASC->AddLooseGameplayTag(TAG_Other);
+		TestTrue(TEXT("Count changed"), Coro.IsDone());
+		TestEqual(TEXT("New count"), Count, 2);
+		ASC->RemoveLooseGameplayTag(TAG_Other, 2);
+	}
+
+	{
+		auto Coro = [&]() -> TCoroutine<>
+		{
+			co_await GAS::WaitGameplayEvent(ASC, TAG_Other);
+		}();
+		Coro.Cancel();
+		World.Tick();
+		TestTrue(TEXT("Canceled without the event"), Coro.IsDone());
+		TestFalse(TEXT("Canceled"), Coro.WasSuccessful());
+		// This must not touch the destroyed awaiter
+		FGameplayEventData Payload;
+		ASC->HandleGameplayEvent(TAG_Other, &Payload);
+	}
+	return true;
+}
@@ -92,5 +92,26 @@ bool FAbilityTaskTest::RunTest(const FString& Parameters)
 		TestFalse(TEXT("Garbage"), IsValid(Task));
 	}
 
+	{
+		auto* Task = UUE5CoroGASTestAbilityTask::RunPooled(Ability);
+		Task->ReadyForActivation();
+		World.EndTick();
+		World.Tick();
+		World.Tick();
+		Task->PerformLastStep.Execute();
+		TestEqual(TEXT("Reset for reuse"), Task->State, 0);
+		TestTrue(TEXT("Not garbage"), IsValid(Task));
+
+		auto* Task2 = UUE5CoroGASTestAbilityTask::RunPooled(Ability);
+		TestEqual(TEXT("Reused"), Task2, Task);
+		Task2->ReadyForActivation();
+		World.EndTick();
+		TestEqual(TEXT("Started again"), Task2->State, 1);
+		Task2->bSoftCancel = true;
+		World.Tick();
+		TestEqual(TEXT("Reset after failing"), Task2->State, 0);
+		TestTrue(TEXT("Not garbage"), IsValid(Task2));
+	}
+
 	return true;
 }
@@ -30,7 +30,10 @@
 // ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "GASTestWorld.h"
+#include "AbilitySystemComponent.h"
 #include "Misc/AutomationTest.h"
+#include "UE5CoroGASBenchmarkAbility.h"
+#include "UE5CoroGASTestAvatar.h"
 #include "UE5CoroGASTestGameplayAbility.h"
 
 using namespace UE5Coro::Private::Test;
@@ -53,6 +56,12 @@ IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGameplayAbilityTestPerExecution,
                                  EAutomationTestFlags::HighPriority |
                                  EAutomationTestFlags::ProductFilter)
 
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FGameplayAbilityBenchmark,
+                                 "UE5Coro.GAS.GameplayAbility.Benchmark",
+                                 EAutomationTestFlags::ApplicationContextMask |
+                                 EAutomationTestFlags::MediumPriority |
+                                 EAutomationTestFlags::ProductFilter)
+
 namespace
 {
 void DoTest(FAutomationTestBase& Test,
@@ -135,3 +144,30 @@ bool FGameplayAbilityTestPerExecution::RunTest(const FString& Parameters)
 	DoTest(*this, EGameplayAbilityInstancingPolicy::InstancedPerExecution);
 	return true;
 }
+
+bool FGameplayAbilityBenchmark::RunTest(const FString& Parameters)
+{
+	constexpr int Count = 10000;
+	FGASTestWorld World;
+	auto* ASC = World.Avatar->GetAbilitySystemComponent();
+	auto Handle = ASC->GiveAbility(
+		FGameplayAbilitySpec(UUE5CoroGASBenchmarkAbility::StaticClass()));
+	UUE5CoroGASBenchmarkAbility::NumFinished = 0;
+
+	// Every activation of this non-instanced ability runs on the CDO
+	auto Start = FPlatformTime::Seconds();
+	for (int i = 0; i < Count; ++i)
+		ASC->TryActivateAbility(Handle);
+	auto Activated = FPlatformTime::Seconds();
+	World.EndTick();
+	World.Tick();
+	auto End = FPlatformTime::Seconds();
+
+	TestEqual(TEXT("Every activation finished"),
+	          UUE5CoroGASBenchmarkAbility::NumFinished, Count);
+	AddInfo(FString::Printf(TEXT("Activation: %.1f ns/op"),
+	                        (Activated - Start) * 1e9 / Count));
+	AddInfo(FString::Printf(TEXT("Resume and end: %.1f ns/op"),
+	                        (End - Activated) * 1e9 / Count));
+	return true;
+}
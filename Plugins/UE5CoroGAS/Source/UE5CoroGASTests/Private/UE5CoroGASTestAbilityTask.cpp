@@ -41,6 +41,12 @@ auto UUE5CoroGASTestAbilityTask::Run(UGameplayAbility* InAbility) -> ThisClass*
 	return NewAbilityTask<ThisClass>(InAbility);
 }
 
+auto UUE5CoroGASTestAbilityTask::RunPooled(UGameplayAbility* InAbility)
+	-> ThisClass*
+{
+	return NewPooledAbilityTask<ThisClass>(InAbility);
+}
+
 UE5Coro::GAS::FAbilityCoroutine UUE5CoroGASTestAbilityTask::Execute()
 {
 	State = 1;
@@ -68,3 +74,11 @@ void UUE5CoroGASTestAbilityTask::Failed()
 {
 	State = 11;
 }
+
+void UUE5CoroGASTestAbilityTask::ResetForReuse()
+{
+	Super::ResetForReuse();
+	State = 0;
+	bSoftCancel = false;
+	PerformLastStep.Unbind();
+}
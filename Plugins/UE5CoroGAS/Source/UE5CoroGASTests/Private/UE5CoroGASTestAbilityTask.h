@@ -45,8 +45,10 @@ public:
 	TDelegate<void()> PerformLastStep;
 
 	static ThisClass* Run(UGameplayAbility*);
+	static ThisClass* RunPooled(UGameplayAbility*);
 
 	virtual UE5Coro::GAS::FAbilityCoroutine Execute() override;
 	virtual void Succeeded() override;
 	virtual void Failed() override;
+	virtual void ResetForReuse() override;
 };
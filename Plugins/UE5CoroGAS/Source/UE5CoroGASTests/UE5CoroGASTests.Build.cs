@@ -39,6 +39,7 @@ public class UE5CoroGASTests : UE5CoroModuleRules
 		PublicDependencyModuleNames.AddRange(new[]
 		{
 			"GameplayAbilities",
+			"GameplayTags",
 			"GameplayTasks",
 			"UE5Coro",
 			"UE5CoroGAS",